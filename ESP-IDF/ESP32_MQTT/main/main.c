@@ -1,6 +1,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 
 #include "esp_event.h"
 #include "esp_netif.h"
@@ -10,6 +11,9 @@
 
 #include "nvs_flash.h"
 #include "mqtt_client.h"
+#include "serializer.h"
+#include "telemetry.h"
+#include "loadgen.h"
 
 #include "main.h"
 #include "dht11.h"
@@ -18,6 +22,9 @@
 // Private Macros
 #define DHT11_PIN                           (GPIO_NUM_12)
 #define MAIN_TASK_PERIOD                    (8000)
+#define MQTT_SINK_DEPTH                     (1u)      // only latest sample is kept while disconnected
+#define MQTT_PUBLISH_TASK_STACK             (3072u)
+#define MQTT_PUBLISH_TASK_PRIORITY          (4u)
 
 // #define APP_WIFI_SSID                       "Enter WIFI SSID"
 // #define APP_WIFI_PSWD                       "Enter WiFI Password"
@@ -45,6 +52,10 @@ char * slider_topic = "SliderTopic";
 static bool led_state = false;
 static sensor_data_t sensor_data;
 static int32_t rgb_value = 0;
+// telemetry bus sink for the sensor data
+static telemetry_sink_t mqtt_sink;
+static telemetry_sample_t mqtt_sink_queue[MQTT_SINK_DEPTH];
+static SemaphoreHandle_t mqtt_publish_sem = NULL;
 
 // Private Function Declarations
 static void app_connect_wifi( void );
@@ -52,6 +63,8 @@ static void mqtt_app_start( void );
 static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t event_id, void * event_data );
 static void mqtt_event_handler(void *args, esp_event_base_t event_base, int32_t event_id, void *event_data);
 static void app_handle_mqtt_data(esp_mqtt_event_handle_t event);
+static void app_mqtt_sink_notify( void *ctx );
+static void app_mqtt_publish_task( void *pvParameters );
 
 void app_main(void)
 {
@@ -73,6 +86,15 @@ void app_main(void)
   // start the GUI manager
   gui_start();
 
+  // sensor data is received from telemetry bus, while MQTT is disconnected only
+  // the latest sample is kept, publish task sends it to the MQTT client
+  mqtt_publish_sem = xSemaphoreCreateBinary();
+  xTaskCreate(&app_mqtt_publish_task, "mqtt publish", MQTT_PUBLISH_TASK_STACK, NULL, \
+              MQTT_PUBLISH_TASK_PRIORITY, NULL);
+  telemetry_sink_init( &mqtt_sink, "mqtt", mqtt_sink_queue, MQTT_SINK_DEPTH, \
+                       TELEMETRY_COALESCE, app_mqtt_sink_notify, NULL );
+  telemetry_sink_register( &mqtt_sink );
+
   // initialize dht sensor library
   dht11_init(DHT11_PIN, false);
 
@@ -90,6 +112,16 @@ void app_main(void)
     mqtt_app_start();
   }
 
+#ifdef CONFIG_LOADGEN_ENABLE
+  // virtual devices publish on the telemetry bus along with the local sensor
+  loadgen_config_t loadgen_cfg = LOADGEN_CONFIG_DEFAULT();
+  loadgen_cfg.devices = CONFIG_LOADGEN_DEVICES;
+  loadgen_cfg.rate_hz = CONFIG_LOADGEN_RATE_HZ;
+  loadgen_cfg.duration_s = CONFIG_LOADGEN_DURATION_S;
+  loadgen_cfg.report_ms = CONFIG_LOADGEN_REPORT_MS;
+  ESP_ERROR_CHECK( loadgen_start( &loadgen_cfg ) );
+#endif
+
   while (true)
   {
     // Get DHT11 Temperature and Humidity Values
@@ -104,8 +136,9 @@ void app_main(void)
         sensor_data.temperature = temp;
         ESP_LOGI(TAG, "Temperature: %d C", sensor_data.temperature);
         ESP_LOGI(TAG, "Humidity: %d %%", sensor_data.humidity);
-        // Publish this data to mqtt server
-        app_publish_sensor_data();
+        // publish the sample to all the uplinks (MQTT), this never blocks
+        float sample[SENSOR_CH_MAX] = { sensor_data.temperature, sensor_data.humidity };
+        telemetry_publish( sample, SENSOR_CH_MAX );
         gui_send_event(GUI_MNG_EV_TEMP_HUMID, (uint8_t*)(&sensor_data) );
       }
       else
@@ -150,23 +183,62 @@ void app_publish_switch_led( bool led_status )
 }
 
 /**
- * @brief Publish message to MQTT broker with Sensor Data
+ * @brief Publish the Sensor Data samples waiting in telemetry sink to MQTT
+ *        broker, the messages are only queued in the MQTT client outbox, so
+ *        this doesn't wait for the network
  * @param  none 
  */
 void app_publish_sensor_data( void )
 {
-  char buffer[8] = { 0 };
-  int len = 0;
+  char buffer[24] = { 0 };
+  ser_writer_t writer;
+  telemetry_sample_t sample;
   int msg_id;
 
-  if( wifi_connect_status && mqtt_connect_status )
+  // samples stay in sink till MQTT is connected
+  while( wifi_connect_status && mqtt_connect_status && telemetry_receive( &mqtt_sink, &sample ) )
   {
-    snprintf( buffer, sizeof(buffer), "%d,%d", sensor_data.temperature, sensor_data.humidity);
-    msg_id = esp_mqtt_client_publish(mqtt_client, "SensorTopic", buffer, len, 0, 0);
+    // "temperature,humidity" same as earlier, but without the risk of cut data
+    ser_writer_init( &writer, buffer, sizeof(buffer) );
+    ser_csv_int( &writer, (int32_t)sample.value[SENSOR_CH_TEMPERATURE] );
+    ser_csv_int( &writer, (int32_t)sample.value[SENSOR_CH_HUMIDITY] );
+    if( ser_finish( &writer ) == false )
+    {
+      ESP_LOGE(TAG, "Sensor data doesn't fit in buffer");
+      continue;
+    }
+    msg_id = esp_mqtt_client_enqueue(mqtt_client, "SensorTopic", buffer, (int)ser_len(&writer), 0, 0, true);
     ESP_LOGI(TAG, "sent publish successful, msg_id=%d", msg_id);
   }
 }
 
+/**
+ * @brief Telemetry bus notify callback, called from the publishing task (sensor
+ *        loop or load generator), it only wakes up the MQTT publish task, as
+ *        esp_mqtt_client_enqueue waits for the client lock
+ * @param ctx not used
+ */
+static void app_mqtt_sink_notify( void *ctx )
+{
+  xSemaphoreGive( mqtt_publish_sem );
+}
+
+/**
+ * @brief MQTT Publish Task, sends the samples waiting in telemetry sink when
+ *        woken up by the sink notify callback
+ * @param pvParameters not used
+ */
+static void app_mqtt_publish_task( void *pvParameters )
+{
+  while( 1 )
+  {
+    if( xSemaphoreTake( mqtt_publish_sem, portMAX_DELAY ) == pdTRUE )
+    {
+      app_publish_sensor_data();
+    }
+  }
+}
+
 /**
  * @brief Connect with the WiFi Router
  * @note  in future this function can be moved to a commom place.
@@ -373,6 +445,9 @@ static void mqtt_event_handler(void *args, esp_event_base_t event_base, int32_t
       msg_id = esp_mqtt_client_subscribe(client, led_topic, 0);
       ESP_LOGI(TAG, "sent subscribe successful, msg_id=%d", msg_id);
 
+      // send the sensor data collected while disconnected
+      xSemaphoreGive( mqtt_publish_sem );
+
       // send an event to GUI manager that we are connected
       gui_send_event(GUI_MNG_EV_MQTT_CONNECTED, NULL);
       break;
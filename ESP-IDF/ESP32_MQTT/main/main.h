@@ -12,6 +12,13 @@
 #include <stdbool.h>
 #include <unistd.h>
 
+// channels of the telemetry sample
+typedef enum {
+  SENSOR_CH_TEMPERATURE = 0,
+  SENSOR_CH_HUMIDITY,
+  SENSOR_CH_MAX,
+} sensor_channel_t;
+
 // Sensor data structure
 typedef struct _sensor_data_t
 {
@@ -8,6 +8,7 @@
 #include "esp_http_server.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
+#include "web_assets.h"
 
 #include "wifi_app.h"
 #include "http_server.h"
@@ -38,17 +39,23 @@ static QueueHandle_t http_server_monitor_q_handle;
 // WiFi Connect Status
 static http_server_wifi_connect_status_e g_wifi_connect_status = HTTP_WIFI_STATUS_CONNECT_NONE;
 
-// Embedded Files: JQuery, index.html, app.css, app.js, and favicon.ico files
-extern const uint8_t jquery_3_3_1_min_js_start[]      asm("_binary_jquery_3_3_1_min_js_start");
-extern const uint8_t jquery_3_3_1_min_js_end[]        asm("_binary_jquery_3_3_1_min_js_end");
-extern const uint8_t index_html_start[]               asm("_binary_index_html_start");
-extern const uint8_t index_html_end[]                 asm("_binary_index_html_end");
-extern const uint8_t app_css_start[]                  asm("_binary_app_css_start");
-extern const uint8_t app_css_end[]                    asm("_binary_app_css_end");
-extern const uint8_t app_js_start[]                   asm("_binary_app_js_start");
-extern const uint8_t app_js_end[]                     asm("_binary_app_js_end");
-extern const uint8_t favicon_ico_start[]              asm("_binary_favicon_ico_start");
-extern const uint8_t favicon_ico_end[]                asm("_binary_favicon_ico_end");
+// Embedded Files (gzip compressed at build time): JQuery, index.html, app.css, app.js, and favicon.ico files
+extern const uint8_t jquery_3_3_1_min_js_gz_start[] asm("_binary_jquery_3_3_1_min_js_gz_start");
+extern const uint8_t jquery_3_3_1_min_js_gz_end[]   asm("_binary_jquery_3_3_1_min_js_gz_end");
+extern const uint8_t index_html_gz_start[]          asm("_binary_index_html_gz_start");
+extern const uint8_t index_html_gz_end[]            asm("_binary_index_html_gz_end");
+extern const uint8_t app_css_gz_start[]             asm("_binary_app_css_gz_start");
+extern const uint8_t app_css_gz_end[]               asm("_binary_app_css_gz_end");
+extern const uint8_t app_js_gz_start[]              asm("_binary_app_js_gz_start");
+extern const uint8_t app_js_gz_end[]                asm("_binary_app_js_gz_end");
+extern const uint8_t favicon_ico_gz_start[]         asm("_binary_favicon_ico_gz_start");
+extern const uint8_t favicon_ico_gz_end[]           asm("_binary_favicon_ico_gz_end");
+// jQuery file name has the version, it is cached by the browser without revalidation
+static const web_asset_t jquery_3_3_1_min_js_asset = WEB_ASSET( jquery_3_3_1_min_js_gz, "application/javascript", true );
+static const web_asset_t index_html_asset       = WEB_ASSET( index_html_gz, "text/html", false );
+static const web_asset_t app_css_asset          = WEB_ASSET( app_css_gz, "text/css", false );
+static const web_asset_t app_js_asset           = WEB_ASSET( app_js_gz, "application/javascript", false );
+static const web_asset_t favicon_ico_asset      = WEB_ASSET( favicon_ico_gz, "image/x-icon", false );
 
 // Private Function Prototypes
 static void http_server_monitor(void *pvParameter);
@@ -297,8 +304,7 @@ static esp_err_t http_server_j_query_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "JQuery Requested");
-  httpd_resp_set_type( req, "application/javascript");
-  error = httpd_resp_send(req, (const char*)jquery_3_3_1_min_js_start, jquery_3_3_1_min_js_end-jquery_3_3_1_min_js_start );
+  error = web_assets_send(req, &jquery_3_3_1_min_js_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_j_query_handler: Error %d while sending Response", error );
@@ -319,8 +325,7 @@ static esp_err_t http_server_index_html_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "Index HTML Requested");
-  httpd_resp_set_type( req, "text/html");
-  error = httpd_resp_send(req, (const char*)index_html_start, index_html_end-index_html_start );
+  error = web_assets_send(req, &index_html_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_index_html_handler: Error %d while sending Response", error );
@@ -341,8 +346,7 @@ static esp_err_t http_server_app_css_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "APP CSS Requested");
-  httpd_resp_set_type( req, "text/css");
-  error = httpd_resp_send(req, (const char*)app_css_start, app_css_end-app_css_start );
+  error = web_assets_send(req, &app_css_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_app_css_handler: Error %d while sending Response", error );
@@ -363,8 +367,7 @@ static esp_err_t http_server_app_js_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "APP JS Requested");
-  httpd_resp_set_type( req, "application/javascript");
-  error = httpd_resp_send(req, (const char*)app_js_start, app_js_end-app_js_start );
+  error = web_assets_send(req, &app_js_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_app_js_handler: Error %d while sending Response", error );
@@ -385,8 +388,7 @@ static esp_err_t http_server_favicon_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "Favicon.ico Requested");
-  httpd_resp_set_type( req, "image/x-icon");
-  error = httpd_resp_send(req, (const char*)favicon_ico_start, favicon_ico_end-favicon_ico_start );
+  error = web_assets_send(req, &favicon_ico_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_favicon_handler: Error %d while sending Response", error );
@@ -20,6 +20,8 @@
 
 #include "main.h"
 #include "influxDB.h"
+#include "telemetry.h"
+#include "loadgen.h"
 
 // macros
 #define MAIN_TASK_PERIOD                    (60000)
@@ -49,6 +51,7 @@ static void app_connect_wifi( void );
 static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t event_id, void * event_data );
 static void app_sntp_init( void );
 static bool app_sntp_get_time( void );
+static void app_sntp_sync_cb( struct timeval *tv );
 
 void app_main(void)
 {
@@ -69,23 +72,36 @@ void app_main(void)
   }
   ESP_ERROR_CHECK(ret);
 
+  // start the influxDB task, samples are spooled till WiFi and time are available
+  influxdb_start();
+
   // connect with WiFi (it will take some time)
   app_connect_wifi();
+  // SNTP keeps trying in background, if WiFi is not connected yet
+  app_sntp_init();
   if( wifi_connect_status )
   {
     ESP_LOGI( TAG, "WiFi Connected, now synchronizing with NTP server." );
-    app_sntp_init();
-    sntp_connect_status = app_sntp_get_time();
-    // if time fetched then only start the influxDB server
-    if( sntp_connect_status )
+    if( app_sntp_get_time() )
     {
-      // now start the influxDB task
-      influxdb_start();
+      sntp_connect_status = true;
     }
   }
 
+#ifdef CONFIG_LOADGEN_ENABLE
+  // virtual devices publish on the telemetry bus along with the local sensor
+  loadgen_config_t loadgen_cfg = LOADGEN_CONFIG_DEFAULT();
+  loadgen_cfg.devices = CONFIG_LOADGEN_DEVICES;
+  loadgen_cfg.rate_hz = CONFIG_LOADGEN_RATE_HZ;
+  loadgen_cfg.duration_s = CONFIG_LOADGEN_DURATION_S;
+  loadgen_cfg.report_ms = CONFIG_LOADGEN_REPORT_MS;
+  ESP_ERROR_CHECK( loadgen_start( &loadgen_cfg ) );
+#endif
+
   while(1)
   {
+    float sample[SENSOR_CH_MAX];
+
     // simulating temperature and humidity
     if( increasing )
     {
@@ -114,11 +130,11 @@ void app_main(void)
 
     ESP_LOGI( TAG, "Temperature: %d, Humidity: %d\n", temperature, humidity);
 
-    // if wifi is connected, trigger event to send data to InfluxDB cloud
-    if( wifi_connect_status && sntp_connect_status )
-    {
-      influxdb_send_event(INFLUXDB_EV_TEMP_HUMID, NULL);
-    }
+    // publish the sample to all the uplinks (InfluxDB), this never blocks,
+    // sample is spooled if WiFi or time is not available and sent later
+    sample[SENSOR_CH_TEMPERATURE] = temperature;
+    sample[SENSOR_CH_HUMIDITY] = humidity;
+    telemetry_publish( sample, SENSOR_CH_MAX );
     // Wait before next measurement
     vTaskDelay(MAIN_TASK_PERIOD / portTICK_PERIOD_MS);
   }
@@ -152,9 +168,40 @@ void get_mac_address( char *mac_str )
   snprintf( mac_str, MAC_ADDR_SIZE, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5] );
 }
 
+/**
+ * @brief Get the WiFi connection status
+ * @param  None
+ * @return true if connected with access point and IP is available
+ */
+bool get_wifi_status( void )
+{
+  return wifi_connect_status;
+}
+
+/**
+ * @brief Get the time synchronization status
+ * @param  None
+ * @return true if time is synchronized with SNTP server
+ */
+bool get_time_status( void )
+{
+  return sntp_connect_status;
+}
+
+/**
+ * @brief Get the UTC time in nanoseconds
+ * @param  None
+ * @return time in nanoseconds, 0 if time is not synchronized yet
+ */
 long long get_time_ns( void )
 {
   struct timeval now;
+
+  // before synchronization the time starts from 1970, that is not a valid time stamp
+  if( !sntp_connect_status )
+  {
+    return 0;
+  }
   gettimeofday( &now, NULL );
   long long time_ns = (long long)now.tv_sec * 1000000000LL + now.tv_usec * 1000LL;
 
@@ -235,7 +282,7 @@ static void app_connect_wifi( void )
   {
     ESP_LOGE(TAG, "Unexpected Event" );
   }
-  vEventGroupDelete(wifi_event_group);
+  // event group is not deleted, event handler uses it on every reconnect
 }
 
 /**
@@ -255,6 +302,8 @@ static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t
     }
     else if( WIFI_EVENT_STA_DISCONNECTED == event_id )
     {
+      // link is down now, uplinks keep the samples till it is back
+      wifi_connect_status = false;
       if( wifi_connect_retry < WIFI_MAX_RETRY )
       {
         uint32_t delay = (1 << wifi_connect_retry) * WIFI_CONNECT_DELAY;
@@ -267,9 +316,11 @@ static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t
       }
       else
       {
-        wifi_connect_status = false;
         xEventGroupSetBits(wifi_event_group, WIFI_FAIL_BIT);
-        ESP_LOGE(TAG, "Failed to connect to Access Point.");
+        ESP_LOGE(TAG, "Failed to connect to Access Point, retry in %d ms", WIFI_MAX_DELAY);
+        // keep trying at slow rate, samples are spooled meanwhile
+        vTaskDelay(WIFI_MAX_DELAY / portTICK_PERIOD_MS);
+        esp_wifi_connect();
       }
     }
   } // if( WIFI_EVENT = event_base )
@@ -290,11 +341,24 @@ static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t
 static void app_sntp_init( void )
 {
   ESP_LOGI( TAG, "Initializing SNTP" );
+  // set the time zone to India Standard Time (IST)
+  setenv( "TZ", "IST-5:30", 1);
+  tzset();
   esp_sntp_setoperatingmode( SNTP_OPMODE_POLL );
   esp_sntp_setservername( 0, "pool.ntp.org" );  // set the SNTP server
+  sntp_set_time_sync_notification_cb( app_sntp_sync_cb );
   esp_sntp_init();
 }
 
+/**
+ * @brief SNTP time synchronization callback, called from lwIP task
+ * @param tv synchronized time
+ */
+static void app_sntp_sync_cb( struct timeval *tv )
+{
+  sntp_connect_status = true;
+}
+
 /**
  * @brief Synchronize the time from the SNTP server
  * @param  None
@@ -306,10 +370,6 @@ static bool app_sntp_get_time( void )
   bool status = false;
   char time_buffer[50] = { 0 };   // temporary: only for printing/debugging
 
-  // set the time zone to India Standard Time (IST)
-  setenv( "TZ", "IST-5:30", 1);
-  tzset();
-
   // wait for the time to be set
   time_t now = 0;
   struct tm time_info = { 0 };
@@ -9,15 +9,25 @@
 #define MAIN_MAIN_H_
 
 #include <unistd.h>
+#include <stdbool.h>
 
 // macros
 #define SENSOR_BUFF_SIZE                        (100u)
 #define MAC_ADDR_SIZE                           (18u)
 
+// channels of the telemetry sample
+typedef enum {
+  SENSOR_CH_TEMPERATURE = 0,
+  SENSOR_CH_HUMIDITY,
+  SENSOR_CH_MAX,
+} sensor_channel_t;
+
 // Public Function Definition
 uint8_t get_temperature( void );
 uint8_t get_humidity( void );
 void get_mac_address( char *mac_str );
+bool get_wifi_status( void );
+bool get_time_status( void );
 long long get_time_ns( void );
 
 #endif /* MAIN_MAIN_H_ */
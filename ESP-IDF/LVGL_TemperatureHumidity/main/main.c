@@ -18,6 +18,7 @@
 #include "dht11.h"
 #include "gui_mng.h"
 #include "thingspeak.h"
+#include "telemetry.h"
 
 // macros
 #define DHT11_PIN                           (GPIO_NUM_12)
@@ -88,14 +89,13 @@ void app_main(void)
           sensor_data.temperature[sensor_data.sensor_idx] = temp;
           ESP_LOGI(TAG, "Temperature: %d", sensor_data.temperature[sensor_data.sensor_idx]);
           ESP_LOGI(TAG, "Humidity: %d", sensor_data.humidity[sensor_data.sensor_idx]);
+          // publish the sample to all the uplinks (ThingSpeak), this never blocks
+          float sample[SENSOR_CH_MAX] = { sensor_data.temperature[sensor_data.sensor_idx], \
+                                          sensor_data.humidity[sensor_data.sensor_idx] };
+          telemetry_publish( sample, SENSOR_CH_MAX );
           sensor_data.sensor_idx++;
           // trigger event to display temperature and humidity
           gui_send_event(GUI_MNG_EV_TEMP_HUMID, NULL );
-          // if wifi is connected, trigger event to send data to ThingSpeak
-          if( wifi_connect_status )
-          {
-            thingspeak_send_event(THING_SPEAK_EV_TEMP_HUMID, NULL);
-          }
           // reset the index
           if( sensor_data.sensor_idx >= SENSOR_BUFF_SIZE )
           {
@@ -5,6 +5,8 @@
  *      Author: xpress_embedo
  */
 
+#include <string.h>
+
 #include "display_mng.h"
 #include "bsp/esp-bsp.h"
 #include "openweathermap.h"
@@ -12,65 +14,66 @@
 
 // Macros
 #define DISPLAY_REFRESH_RATE          (5u)    // display_mng is called after 1 second, using x means x seconds
-#define NUM_OF_DATA                   (4u)    // This must be aligned with NUM_OF_CITIES in OpenWeatherMap module
-                                              // and also should be equal to total_num_of_cities
+#define DISPLAY_TEXT_COLOR            (0x000000)
+
+// Structures
+// image and text color of the cities having a picture, others use plain screen
+typedef struct _display_city_style_t
+{
+  const char *city_name;
+  const lv_img_dsc_t *image;
+  uint32_t text_color;
+} display_city_style_t;
 
 // Private Variables
-static uint8_t total_num_of_cities = 0u;
+static const display_city_style_t display_city_styles[] =
+{
+  { "Delhi",  &ui_img_delhi_png,  0x000000 },
+  { "Shimla", &ui_img_shimla_png, 0xCF1919 },
+  { "Jaipur", &ui_img_jaipur_png, 0x000000 },
+  { "Leh",    &ui_img_leh_png,    0xCF1919 },
+};
 static uint8_t city_idx = 0u;
 static uint8_t display_refresh = 0;
-lv_obj_t * ui_Screens[NUM_OF_DATA];
-lv_obj_t * ui_city_names[NUM_OF_DATA];
-lv_obj_t * ui_temperature_values[NUM_OF_DATA];
-lv_obj_t * ui_pressure_values[NUM_OF_DATA];
-lv_obj_t * ui_humidity_values[NUM_OF_DATA];
+static uint32_t display_generation = 0;
+
+// Private Function Prototypes
+static void display_show_city(uint8_t city);
 
 // Public Function Definitions
 void display_init(void)
 {
-  total_num_of_cities = openweathermap_get_numofcity();
   city_idx = 0u;
 
   // Start LVGL and LCD Driver
   bsp_display_start();
   bsp_display_lock(0);
   ui_init();
-  // Update Array of Screen Pointers
-  ui_Screens[0] = ui_Screen1;
-  ui_Screens[1] = ui_Screen2;
-  ui_Screens[2] = ui_Screen3;
-  ui_Screens[3] = ui_Screen4;
-  // Update Array of City Names with LVGL objects
-  ui_city_names[0] = ui_cityNameValue0;
-  ui_city_names[1] = ui_cityNameValue1;
-  ui_city_names[2] = ui_cityNameValue2;
-  ui_city_names[3] = ui_cityNameValue3;
-  // Update Array of Temperature LVGL objects
-  ui_temperature_values[0] = ui_tempValue0;
-  ui_temperature_values[1] = ui_tempValue1;
-  ui_temperature_values[2] = ui_tempValue2;
-  ui_temperature_values[3] = ui_tempValue3;
-  // Update Array of Pressure LVGL objects
-  ui_pressure_values[0] = ui_pressureValue0;
-  ui_pressure_values[1] = ui_pressureValue1;
-  ui_pressure_values[2] = ui_pressureValue2;
-  ui_pressure_values[3] = ui_pressureValue3;
-  // Update Array of Humidity LVGL objects
-  ui_humidity_values[0] = ui_humidityValue0;
-  ui_humidity_values[1] = ui_humidityValue1;
-  ui_humidity_values[2] = ui_humidityValue2;
-  ui_humidity_values[3] = ui_humidityValue3;
   bsp_display_unlock();
 }
 
 // this function is called every 1 seconds
-// and let's say we wanted to switch screen every 5 seconds
+// and let's say we wanted to switch city every 5 seconds
 void display_mng(void)
 {
-  int temperature = 0;
-  int humidity = 0;
-  int pressure = 0;
-  char temp[10] = {0};
+  uint8_t total_num_of_cities = openweathermap_get_numofcity();
+  uint32_t generation = openweathermap_get_generation();
+  bool show = false;
+
+  // city list can be changed at run time
+  if( city_idx >= total_num_of_cities )
+  {
+    city_idx = 0u;
+    show = true;
+  }
+
+  // new weather data, shown city is updated
+  if( generation != display_generation )
+  {
+    display_generation = generation;
+    show = true;
+  }
+
   display_refresh++;
   if( display_refresh >= DISPLAY_REFRESH_RATE )
   {
@@ -81,27 +84,68 @@ void display_mng(void)
     {
       city_idx = 0u;
     }
-    // get the values from OpenWeatherMap
-    temperature = openweathermap_get_temperature(city_idx);
-    pressure = openweathermap_get_pressure(city_idx);
-    humidity = openweathermap_get_humidity(city_idx);
+    show = true;
+  }
 
+  if( show && total_num_of_cities )
+  {
     bsp_display_lock(1000);
-    // load the screen
-    lv_disp_load_scr( ui_Screens[city_idx] );
-    // Update the Display
-    // snprintf(temp,10u, "%2d \xB0 C", temperature);
-    // _ui_label_set_property( ui_temperature_values[city_idx], _UI_LABEL_PROPERTY_TEXT, temp);
-    // Update Temperature
-    lv_label_set_text_fmt(ui_temperature_values[city_idx], "%2d °C", temperature );
-    // Update Pressure
-    snprintf(temp,10u, "%4d bar", pressure);
-    _ui_label_set_property( ui_pressure_values[city_idx], _UI_LABEL_PROPERTY_TEXT, temp);
-    // Update Humidity
-    snprintf(temp,10u, "%3d %%", humidity);
-    _ui_label_set_property( ui_humidity_values[city_idx], _UI_LABEL_PROPERTY_TEXT, temp);
-    // Update City Name
-    _ui_label_set_property(ui_city_names[city_idx], _UI_LABEL_PROPERTY_TEXT, openweathermap_get_city_name(city_idx));
+    display_show_city(city_idx);
     bsp_display_unlock();
   }
 }
+
+// Private Function Definitions
+// bind the city screen to the city, called with display lock taken
+static void display_show_city(uint8_t city)
+{
+  char city_name[OPENWEATHERMAP_CITY_NAME_LEN] = {0};
+  const display_city_style_t *style = NULL;
+  char temp[10] = {0};
+
+  if( openweathermap_get_city_name(city, city_name, sizeof(city_name)) == false )
+  {
+    // city list was changed and is shorter now, next update shows a valid city
+    return;
+  }
+  for( uint8_t idx = 0; idx < (sizeof(display_city_styles)/sizeof(display_city_styles[0])); idx++ )
+  {
+    if( strcmp(display_city_styles[idx].city_name, city_name) == 0 )
+    {
+      style = &display_city_styles[idx];
+      break;
+    }
+  }
+  if( style != NULL )
+  {
+    lv_img_set_src(ui_cityImage, style->image);
+    lv_obj_clear_flag(ui_cityImage, LV_OBJ_FLAG_HIDDEN);
+  }
+  else
+  {
+    lv_obj_add_flag(ui_cityImage, LV_OBJ_FLAG_HIDDEN);
+  }
+  lv_obj_set_style_text_color(ui_CityScreen, lv_color_hex(style ? style->text_color : DISPLAY_TEXT_COLOR), \
+                              LV_PART_MAIN | LV_STATE_DEFAULT);
+
+  // Update City Name
+  _ui_label_set_property(ui_cityNameValue, _UI_LABEL_PROPERTY_TEXT, city_name);
+  if( openweathermap_is_valid(city) == false )
+  {
+    // values of the city are not received yet
+    _ui_label_set_property(ui_tempValue, _UI_LABEL_PROPERTY_TEXT, "--");
+    _ui_label_set_property(ui_pressureValue, _UI_LABEL_PROPERTY_TEXT, "--");
+    _ui_label_set_property(ui_humidityValue, _UI_LABEL_PROPERTY_TEXT, "--");
+    return;
+  }
+
+  // Update the Display
+  // Update Temperature
+  lv_label_set_text_fmt(ui_tempValue, "%2d °C", openweathermap_get_temperature(city) );
+  // Update Pressure
+  snprintf(temp,10u, "%4d bar", openweathermap_get_pressure(city));
+  _ui_label_set_property( ui_pressureValue, _UI_LABEL_PROPERTY_TEXT, temp);
+  // Update Humidity
+  snprintf(temp,10u, "%3d %%", openweathermap_get_humidity(city));
+  _ui_label_set_property( ui_humidityValue, _UI_LABEL_PROPERTY_TEXT, temp);
+}
@@ -0,0 +1,247 @@
+/*
+ * http_server.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * City list of the OpenWeatherMap module over HTTP
+ *   GET  /cities  -> [{"id":1273294,"name":"Delhi"},...]
+ *   POST /cities  <- same format, replaces the list (saved in NVS)
+ * e.g. curl -X POST http://<ip>/cities -d '[{"id":1275339,"name":"Mumbai"}]'
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "cJSON.h"
+#include "serializer.h"
+
+#include "http_server.h"
+#include "openweathermap.h"
+
+// Macros
+#define HTTP_SERVER_CITY_JSON_LEN           (64u)   // {"id":1234567,"name":"..."}, with escaping
+#define HTTP_SERVER_CITIES_LEN              (OPENWEATHERMAP_CITY_MAX * HTTP_SERVER_CITY_JSON_LEN)
+
+// Private Variables
+static const char TAG[] = "http_server";
+// HTTP Server Task Handle
+static httpd_handle_t http_server_handle = NULL;
+
+// Private Function Prototypes
+static esp_err_t http_server_cities_get_handler(httpd_req_t *req);
+static esp_err_t http_server_cities_post_handler(httpd_req_t *req);
+static esp_err_t http_server_parse_cities(const char *json, openweathermap_city_t *cities, uint8_t *count);
+
+// Public Function Definition
+/*
+ * Starts the HTTP Server
+ */
+void http_server_start(void)
+{
+  httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+
+  if( http_server_handle != NULL )
+  {
+    return;
+  }
+
+  ESP_LOGI(TAG, "http_server_start: Starting Server on port: '%d'", config.server_port);
+  if( httpd_start(&http_server_handle, &config) == ESP_OK )
+  {
+    // Register cities handlers
+    httpd_uri_t cities_get =
+    {
+      .uri       = "/cities",
+      .method    = HTTP_GET,
+      .handler   = http_server_cities_get_handler,
+      .user_ctx  = NULL
+    };
+    httpd_uri_t cities_post =
+    {
+      .uri       = "/cities",
+      .method    = HTTP_POST,
+      .handler   = http_server_cities_post_handler,
+      .user_ctx  = NULL
+    };
+    httpd_register_uri_handler(http_server_handle, &cities_get);
+    httpd_register_uri_handler(http_server_handle, &cities_post);
+  }
+  else
+  {
+    ESP_LOGE(TAG, "http_server_start: Unable to start server");
+    http_server_handle = NULL;
+  }
+}
+
+/*
+ * Stops the HTTP Server
+ */
+void http_server_stop(void)
+{
+  if( http_server_handle )
+  {
+    httpd_stop(http_server_handle);
+    ESP_LOGI(TAG, "http_server_stop: stopping HTTP Server");
+    http_server_handle = NULL;
+  }
+}
+
+// Private Function Definitions
+/*
+ * Sends the city list as JSON array
+ * @param req HTTP request for which the URI needs to be handled
+ * @return ESP_OK
+ */
+static esp_err_t http_server_cities_get_handler(httpd_req_t *req)
+{
+  openweathermap_city_t *cities = malloc(OPENWEATHERMAP_CITY_MAX * sizeof(openweathermap_city_t));
+  char *cities_JSON = malloc(HTTP_SERVER_CITIES_LEN);
+  esp_err_t err = ESP_OK;
+  ser_writer_t writer;
+  uint8_t count = 0;
+
+  if( (cities == NULL) || (cities_JSON == NULL) )
+  {
+    free(cities);
+    free(cities_JSON);
+    return httpd_resp_send_500(req);
+  }
+
+  count = openweathermap_get_cities(cities, OPENWEATHERMAP_CITY_MAX);
+  ser_writer_init( &writer, cities_JSON, HTTP_SERVER_CITIES_LEN );
+  ser_json_arr_begin( &writer );
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    ser_json_obj_begin( &writer );
+    ser_json_key( &writer, "id" );
+    ser_json_int( &writer, cities[idx].id );
+    ser_json_key( &writer, "name" );
+    ser_json_str( &writer, cities[idx].name );
+    ser_json_obj_end( &writer );
+  }
+  ser_json_arr_end( &writer );
+
+  if( ser_finish( &writer ) )
+  {
+    httpd_resp_set_type(req, "application/json");
+    err = httpd_resp_send(req, cities_JSON, ser_len(&writer));
+  }
+  else
+  {
+    err = httpd_resp_send_500(req);
+  }
+  free(cities);
+  free(cities_JSON);
+  return err;
+}
+
+/*
+ * Replaces the city list, body is a JSON array like the GET response
+ * @param req HTTP request for which the URI needs to be handled
+ * @return ESP_OK, or ESP_FAIL if the connection is to be closed
+ */
+static esp_err_t http_server_cities_post_handler(httpd_req_t *req)
+{
+  openweathermap_city_t *cities = NULL;
+  char *cities_JSON = NULL;
+  uint8_t count = 0;
+  int received = 0;
+  int ret = 0;
+  esp_err_t err = ESP_OK;
+
+  if( (req->content_len == 0) || (req->content_len >= HTTP_SERVER_CITIES_LEN) )
+  {
+    return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid city list size");
+  }
+  cities_JSON = malloc(req->content_len + 1);
+  cities = malloc(OPENWEATHERMAP_CITY_MAX * sizeof(openweathermap_city_t));
+  if( (cities_JSON == NULL) || (cities == NULL) )
+  {
+    free(cities_JSON);
+    free(cities);
+    return httpd_resp_send_500(req);
+  }
+
+  while( received < req->content_len )
+  {
+    ret = httpd_req_recv(req, cities_JSON + received, req->content_len - received);
+    if( ret == HTTPD_SOCK_ERR_TIMEOUT )
+    {
+      continue;
+    }
+    if( ret <= 0 )
+    {
+      free(cities_JSON);
+      free(cities);
+      return ESP_FAIL;
+    }
+    received += ret;
+  }
+  cities_JSON[received] = '\0';
+
+  err = http_server_parse_cities(cities_JSON, cities, &count);
+  if( err == ESP_OK )
+  {
+    err = openweathermap_set_cities(cities, count);
+  }
+  if( err == ESP_OK )
+  {
+    httpd_resp_set_type(req, "application/json");
+    err = httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
+  }
+  else
+  {
+    ESP_LOGW(TAG, "Invalid city list (%s)", esp_err_to_name(err));
+    err = httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid city list");
+  }
+  free(cities_JSON);
+  free(cities);
+  return err;
+}
+
+/*
+ * Parses the city list
+ * @param json JSON array of {"id":<int>,"name":<string>} objects
+ * @param cities list output, OPENWEATHERMAP_CITY_MAX entries
+ * @param count number of cities output
+ * @return ESP_OK if successful
+ */
+static esp_err_t http_server_parse_cities(const char *json, openweathermap_city_t *cities, uint8_t *count)
+{
+  cJSON *root = cJSON_Parse(json);
+  cJSON *city = NULL;
+  const cJSON *id = NULL;
+  const cJSON *name = NULL;
+  esp_err_t err = ESP_OK;
+
+  *count = 0;
+  if( cJSON_IsArray(root) == false )
+  {
+    cJSON_Delete(root);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  cJSON_ArrayForEach(city, root)
+  {
+    id = cJSON_GetObjectItemCaseSensitive(city, "id");
+    name = cJSON_GetObjectItemCaseSensitive(city, "name");
+    if( *count >= OPENWEATHERMAP_CITY_MAX )
+    {
+      err = ESP_ERR_INVALID_SIZE;
+      break;
+    }
+    if( (cJSON_IsNumber(id) == false) || (cJSON_IsString(name) == false) || \
+        (strlen(name->valuestring) >= OPENWEATHERMAP_CITY_NAME_LEN) )
+    {
+      err = ESP_ERR_INVALID_ARG;
+      break;
+    }
+    cities[*count].id = (int32_t)id->valueint;
+    strcpy(cities[*count].name, name->valuestring);
+    (*count)++;
+  }
+  cJSON_Delete(root);
+  return err;
+}
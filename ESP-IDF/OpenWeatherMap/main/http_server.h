@@ -0,0 +1,17 @@
+/*
+ * http_server.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+
+#ifndef MAIN_HTTP_SERVER_H_
+#define MAIN_HTTP_SERVER_H_
+
+#include "main.h"
+
+// Public Function Declaration
+void http_server_start(void);
+void http_server_stop(void);
+
+#endif /* MAIN_HTTP_SERVER_H_ */
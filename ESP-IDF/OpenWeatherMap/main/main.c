@@ -2,6 +2,7 @@
 #include "main.h"
 #include "display_mng.h"
 #include "openweathermap.h"
+#include "http_server.h"
 
 // Macros
 #define WIFI_SUCCESS        						(0x01<<0u)
@@ -13,7 +14,7 @@
 
 #define ESP_TIME_RATE_MSEC              (1000)
 
-#define OPENWEATHERMAP_MNG_RATE_MSEC    (10000)   // 10seconds
+#define OPENWEATHERMAP_MNG_RATE_MSEC    (1000)    // 1seconds, request time is decided by the module
 #define OPENWEATHERMAP_MNG_EXEC_RATE    (OPENWEATHERMAP_MNG_RATE_MSEC*ESP_TIME_RATE_MSEC)
 
 #define DISPLAY_MNG_RATE_MSEC           (1000)    // 1seconds
@@ -50,36 +51,41 @@ void app_main(void)
   }
   ESP_ERROR_CHECK(ret);
 
+  // Initialize the OpenWeatherMap module, loads the last saved weather data
+  openweathermap_init();
+  // Initialize the Display Manager and show the saved data before connecting
+  display_init();
+  display_mng();
+
   // Connect to Wireless Access Point
   ret = connect_wifi();
   if( ret == WIFI_SUCCESS )
   {
-    // Initialize the OpenWeatherMap module
-    openweathermap_init();
-    // Initialize the Display Manager
-    display_init();
-    openweathermap_timestamp = esp_timer_get_time();
-    display_timestamp = esp_timer_get_time();
-
-    while( true )
-    {
-      current_time = esp_timer_get_time();
+    // city list can be changed over HTTP
+    http_server_start();
+  }
+  // without WiFi only the display runs, it shows the saved data
+  openweathermap_timestamp = esp_timer_get_time();
+  display_timestamp = esp_timer_get_time();
 
-      // OpenWeatherMap Management
-      if( (current_time - openweathermap_timestamp) > OPENWEATHERMAP_MNG_EXEC_RATE )
-      {
-        openweathermap_timestamp = current_time;
-        openweathermap_mng();
-      }
+  while( true )
+  {
+    current_time = esp_timer_get_time();
 
-      // Display Management
-      if( (current_time - display_timestamp) > DISPLAY_MNG_EXEC_RATE )
-      {
-       display_timestamp = current_time;
-       display_mng();
-      }
-      vTaskDelay(MAIN_TASK_EXEC_RATE / portTICK_PERIOD_MS);
+    // OpenWeatherMap Management
+    if( (ret == WIFI_SUCCESS) && ((current_time - openweathermap_timestamp) > OPENWEATHERMAP_MNG_EXEC_RATE) )
+    {
+      openweathermap_timestamp = current_time;
+      openweathermap_mng();
+    }
+
+    // Display Management
+    if( (current_time - display_timestamp) > DISPLAY_MNG_EXEC_RATE )
+    {
+     display_timestamp = current_time;
+     display_mng();
     }
+    vTaskDelay(MAIN_TASK_EXEC_RATE / portTICK_PERIOD_MS);
   }
 }
 
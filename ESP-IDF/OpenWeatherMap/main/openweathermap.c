@@ -5,60 +5,187 @@
  *      Author: xpress_embedo
  */
 
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
 #include "openweathermap.h"
-#include <cJSON.h>
+#include "http_pool.h"
+#include "http_cache.h"
+#include "json_stream.h"
 
 // Macros
-#define HTTP_RESP_LEN               (1024u)
-#define HTTP_REQ_EXEC_RATE          (10000u)    // 10 seconds
-#define CITY_NAME_LEN               (10u)
-#define NUM_OF_CITIES               (4u)
+#define HTTP_REQ_EXEC_RATE          (10000u)    // 10 seconds, one city per request mode
+#define OPENWEATHERMAP_POLL_MS      (1000u)     // openweathermap_task checks the schedule
+#define OPENWEATHERMAP_UPDATE_S     CONFIG_OPENWEATHERMAP_UPDATE_S
+#define OPENWEATHERMAP_RETRY_S      CONFIG_OPENWEATHERMAP_RETRY_S
+#define NUM_OF_CITIES_MAX           OPENWEATHERMAP_CITY_MAX
+#define GROUP_CITY_FIELDS           (5u)        // fields extracted per city from group response
+#define GROUP_BATCH                 (6u)        // cities per group request, limited by JSON_STREAM_FIELDS_MAX
+#define GROUP_BATCH_MAX             ((NUM_OF_CITIES_MAX + GROUP_BATCH - 1u) / GROUP_BATCH)
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+#define OPENWEATHERMAP_CACHE_SLOTS  GROUP_BATCH_MAX     // one per group request
+#define OPENWEATHERMAP_STORE_VERSION  (0x0102u)
+#else
+#define OPENWEATHERMAP_CACHE_SLOTS  NUM_OF_CITIES_MAX   // one per city request
+#define OPENWEATHERMAP_STORE_VERSION  (0x0002u)
+#endif
+#define OPENWEATHERMAP_NVS_NAMESPACE  "owm"
+#define OPENWEATHERMAP_NVS_VERSION    "version"
+#define OPENWEATHERMAP_NVS_CITIES     "cities"
+#define OPENWEATHERMAP_NVS_CACHE      "cache"
 
 // Structures
+// city table entry, kept compact as the table can have dozens of cities
 typedef struct _weather_data_t
 {
-  char city_name[CITY_NAME_LEN];   // assuming city name will not be more than CITY_NAME_LEN bytes
+  int32_t city_id;                          // OpenWeatherMap city id
+  char city_name[OPENWEATHERMAP_CITY_NAME_LEN];
+  int16_t temperature;
+  uint16_t pressure;
+  uint8_t humidity;
+  bool valid;                               // values are received
+} weather_data_t;
+
+// values extracted from the weather response
+typedef struct _weather_resp_t
+{
   int temperature;
   int pressure;
   int humidity;
-} weather_data_t;
+} weather_resp_t;
+
+// one entry of the group response "list" array
+typedef struct _group_city_t
+{
+  int id;
+  int dt;                          // time of data calculation, unix UTC
+  int temperature;
+  int pressure;
+  int humidity;
+} group_city_t;
+
+typedef struct _group_resp_t
+{
+  group_city_t city[GROUP_BATCH];
+} group_resp_t;
+
+#define GROUP_CITY_FIELD_LIST(n)                                                                \
+  JSON_STREAM_FIELD( "list." #n ".id",            JSON_STREAM_INT, group_resp_t, city[n].id ),          \
+  JSON_STREAM_FIELD( "list." #n ".dt",            JSON_STREAM_INT, group_resp_t, city[n].dt ),          \
+  JSON_STREAM_FIELD( "list." #n ".main.temp",     JSON_STREAM_INT, group_resp_t, city[n].temperature ), \
+  JSON_STREAM_FIELD( "list." #n ".main.pressure", JSON_STREAM_INT, group_resp_t, city[n].pressure ),    \
+  JSON_STREAM_FIELD( "list." #n ".main.humidity", JSON_STREAM_INT, group_resp_t, city[n].humidity )
 
 // Private Variables
 static const char *TAG = "OpenWeatherMap";
 static const char *CLIENT_KEY = "Content-Type";
 static const char *CLIENT_VALUE = "application/x-www-form-urlencoded";
-static const char *CLIENT_REQ_PRE = "https://api.openweathermap.org/data/2.5/weather?q=";
+static const char *CLIENT_REQ_PRE = "https://api.openweathermap.org/data/2.5/weather?id=";
+static const char *CLIENT_REQ_GROUP = "https://api.openweathermap.org/data/2.5/group?id=";
 // static const char *CLIENT_REQ_POST = "&APPID=ENTER_YOUR_KEY_HERE&units=metric";
 static const char *CLIENT_REQ_POST = "&APPID=fbd756d6387c660e650b533ff585c70e&units=metric";
-static weather_data_t city_weather[NUM_OF_CITIES];
-static uint8_t city_weather_index = 0;
-char response_data[HTTP_RESP_LEN] = {0};
-uint16_t response_data_idx = 0u;
+// used on first boot, later the list is loaded from NVS and can be changed over HTTP
+// city ids are from http://bulk.openweathermap.org/sample/city.list.json.gz
+static const openweathermap_city_t default_cities[] =
+{
+  { 1273294, "Delhi"  },
+  { 1256237, "Shimla" },
+  { 1269515, "Jaipur" },
+  { 1264976, "Leh"    },
+};
+static weather_data_t city_weather[NUM_OF_CITIES_MAX];
+static uint8_t num_of_cities = 0;
+static uint8_t city_weather_index = 0;      // city of the request, first city of the batch in group mode
 bool request_in_process = false;
+// response is parsed while it is received, only these values are extracted
+static const json_stream_field_t weather_fields[] =
+{
+  JSON_STREAM_FIELD( "main.temp",     JSON_STREAM_INT, weather_resp_t, temperature ),
+  JSON_STREAM_FIELD( "main.pressure", JSON_STREAM_INT, weather_resp_t, pressure ),
+  JSON_STREAM_FIELD( "main.humidity", JSON_STREAM_INT, weather_resp_t, humidity ),
+};
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+static const json_stream_field_t group_fields[] =
+{
+  GROUP_CITY_FIELD_LIST(0),
+  GROUP_CITY_FIELD_LIST(1),
+  GROUP_CITY_FIELD_LIST(2),
+  GROUP_CITY_FIELD_LIST(3),
+  GROUP_CITY_FIELD_LIST(4),
+  GROUP_CITY_FIELD_LIST(5),
+};
+_Static_assert( (sizeof(group_fields)/sizeof(group_fields[0])) == (GROUP_BATCH*GROUP_CITY_FIELDS), \
+                "group_fields must have an entry for every city of the batch" );
+_Static_assert( (GROUP_BATCH*GROUP_CITY_FIELDS) <= JSON_STREAM_FIELDS_MAX, "group batch is too big" );
+static uint8_t group_count = 0;             // cities in the group request
+static int group_oldest_dt[GROUP_BATCH_MAX];
+#endif
+static json_stream_t weather_json;
+static weather_resp_t weather_parsed;
+static group_resp_t group_parsed;
+// city values are replaced together, readers see old or new set, never a mix
+static portMUX_TYPE city_weather_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t city_weather_generation = 0;
+static int64_t next_request_us = 0;         // esp_timer time of next request
+static int64_t server_time = 0;             // from Date header of last response, unix UTC
+// group requests use one entry per batch, else there is one per city
+static http_cache_t weather_cache[OPENWEATHERMAP_CACHE_SLOTS];
+static http_cache_t *weather_cache_active = &weather_cache[0];
+static bool weather_store_dirty = false;    // values or validators are not saved in NVS
+// new city list from HTTP server, applied by openweathermap_mng between requests
+static openweathermap_city_t city_list_new[NUM_OF_CITIES_MAX];
+static uint8_t city_list_new_count = 0;
 
 // Private Function Prototypes
 static void openweathermap_send_request(void);
 static esp_err_t openweathermap_event_handler(esp_http_client_event_t *event);
-static void openweathermap_reset_buffer(void);
-static void openweathermap_get_weather(const char *json_string, weather_data_t *weather_data);
+static bool openweathermap_get_weather(weather_data_t *weather_data);
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+static bool openweathermap_get_group(void);
+static void openweathermap_schedule(int oldest_dt);
+#endif
+static void openweathermap_next_request(bool done);
+static bool openweathermap_not_modified(void);
+static void openweathermap_cache_update(int status);
+static void openweathermap_apply_cities(const openweathermap_city_t *cities, uint8_t count);
+static bool openweathermap_load(void);
+static void openweathermap_save(void);
+static int64_t openweathermap_parse_date(const char *date);
 
 // Public Function Definitions
 void openweathermap_init(void)
 {
-  // Initialize the City Names
-  strcpy(city_weather[0].city_name, "Delhi");
-  strcpy(city_weather[1].city_name, "Shimla");
-  strcpy(city_weather[2].city_name, "Jaipur");
-  strcpy(city_weather[3].city_name, "Leh");
+  next_request_us = 0;
+  // city list and the last good values are saved in NVS
+  if( openweathermap_load() == false )
+  {
+    openweathermap_apply_cities(default_cities, sizeof(default_cities)/sizeof(default_cities[0]));
+  }
 }
 
-// OpenWeatherMap Manager
+// OpenWeatherMap Manager, can be called often, request is sent only when due
 void openweathermap_mng(void)
 {
+  uint8_t count = 0;
+
   if( request_in_process == false )
   {
-    request_in_process = true;
-    openweathermap_send_request();
+    // city list is changed only between the requests
+    taskENTER_CRITICAL(&city_weather_lock);
+    count = city_list_new_count;
+    city_list_new_count = 0;
+    taskEXIT_CRITICAL(&city_weather_lock);
+    if( count )
+    {
+      openweathermap_apply_cities(city_list_new, count);
+    }
+
+    if( esp_timer_get_time() >= next_request_us )
+    {
+      request_in_process = true;
+      openweathermap_send_request();
+    }
   }
 }
 
@@ -69,31 +196,97 @@ void openweathermap_task(void *pvParameters)
   for(;;)
   {
     openweathermap_mng();
-    vTaskDelay(HTTP_REQ_EXEC_RATE/portTICK_PERIOD_MS);
+    vTaskDelay(OPENWEATHERMAP_POLL_MS/portTICK_PERIOD_MS);
 
   }
   vTaskDelete(NULL);
 }
 
+// incremented every time the city values are updated, display uses it to
+// refresh the city screen
+uint32_t openweathermap_get_generation(void)
+{
+  return city_weather_generation;
+}
+
 uint8_t openweathermap_get_numofcity(void)
 {
-  return NUM_OF_CITIES;
+  return num_of_cities;
+}
+
+// copy of the city list, for the HTTP server
+uint8_t openweathermap_get_cities(openweathermap_city_t *cities, uint8_t max_cities)
+{
+  uint8_t count = 0;
+  taskENTER_CRITICAL(&city_weather_lock);
+  for( count = 0; (count < num_of_cities) && (count < max_cities); count++ )
+  {
+    cities[count].id = city_weather[count].city_id;
+    memcpy(cities[count].name, city_weather[count].city_name, OPENWEATHERMAP_CITY_NAME_LEN);
+  }
+  taskEXIT_CRITICAL(&city_weather_lock);
+  return count;
+}
+
+// change the city list, can be called from any task, the new list is used
+// from the next request and saved in NVS
+esp_err_t openweathermap_set_cities(const openweathermap_city_t *cities, uint8_t count)
+{
+  if( (count == 0) || (count > NUM_OF_CITIES_MAX) )
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    if( (cities[idx].id <= 0) || (cities[idx].name[0] == '\0') || \
+        (strnlen(cities[idx].name, OPENWEATHERMAP_CITY_NAME_LEN) == OPENWEATHERMAP_CITY_NAME_LEN) )
+    {
+      return ESP_ERR_INVALID_ARG;
+    }
+  }
+
+  taskENTER_CRITICAL(&city_weather_lock);
+  memcpy(city_list_new, cities, count * sizeof(openweathermap_city_t));
+  city_list_new_count = count;
+  taskEXIT_CRITICAL(&city_weather_lock);
+  ESP_LOGI(TAG, "New list of %u cities", count);
+  return ESP_OK;
 }
 
-char* openweathermap_get_city_name(uint8_t city_idx)
+// copy of the city name, the list can be changed by the HTTP server meanwhile
+bool openweathermap_get_city_name(uint8_t city_idx, char *name, size_t size)
 {
-  char *city_ptr = NULL;
-  if( city_idx < NUM_OF_CITIES )
+  bool status = false;
+  if( size == 0 )
+  {
+    return false;
+  }
+  name[0] = '\0';
+  taskENTER_CRITICAL(&city_weather_lock);
+  if( city_idx < num_of_cities )
   {
-    city_ptr = city_weather[city_idx].city_name;
+    strlcpy(name, city_weather[city_idx].city_name, size);
+    status = true;
   }
-  return city_ptr;
+  taskEXIT_CRITICAL(&city_weather_lock);
+  return status;
+}
+
+// values are not received yet for a new city
+bool openweathermap_is_valid(uint8_t city_idx)
+{
+  bool valid = false;
+  if( city_idx < num_of_cities )
+  {
+    valid = city_weather[city_idx].valid;
+  }
+  return valid;
 }
 
 int openweathermap_get_temperature(uint8_t city_idx)
 {
   int temperature = 0;
-  if( city_idx < NUM_OF_CITIES )
+  if( city_idx < num_of_cities )
   {
     temperature = city_weather[city_idx].temperature;
   }
@@ -103,7 +296,7 @@ int openweathermap_get_temperature(uint8_t city_idx)
 int openweathermap_get_pressure(uint8_t city_idx)
 {
   int pressure = 0;
-  if( city_idx < NUM_OF_CITIES )
+  if( city_idx < num_of_cities )
   {
     pressure = city_weather[city_idx].pressure;
   }
@@ -113,7 +306,7 @@ int openweathermap_get_pressure(uint8_t city_idx)
 int openweathermap_get_humidity(uint8_t city_idx)
 {
   int humidity = 0;
-  if( city_idx < NUM_OF_CITIES )
+  if( city_idx < num_of_cities )
   {
     humidity = city_weather[city_idx].humidity;
   }
@@ -125,8 +318,43 @@ int openweathermap_get_humidity(uint8_t city_idx)
 static void openweathermap_send_request(void)
 {
   char openweathermap_url[200];
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+  weather_cache_active = &weather_cache[city_weather_index / GROUP_BATCH];
+#else
+  weather_cache_active = &weather_cache[city_weather_index];
+#endif
+  // max-age of the last response is not over, server will not have new data
+  if( http_cache_is_fresh(weather_cache_active) )
+  {
+    openweathermap_next_request(true);
+    request_in_process = false;
+    return;
+  }
+
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+  // group request of the next batch of cities
+  group_count = num_of_cities - city_weather_index;
+  if( group_count > GROUP_BATCH )
+  {
+    group_count = GROUP_BATCH;
+  }
+  int len = snprintf( openweathermap_url, sizeof(openweathermap_url), "%s", CLIENT_REQ_GROUP);
+  for( uint8_t idx = 0; idx < group_count; idx++ )
+  {
+    len += snprintf( openweathermap_url + len, sizeof(openweathermap_url) - len, \
+                     "%s%ld", (idx ? "," : ""), (long)city_weather[city_weather_index + idx].city_id );
+  }
+  snprintf( openweathermap_url + len, sizeof(openweathermap_url) - len, "%s", CLIENT_REQ_POST);
+  // if it fails try again after retry interval
+  json_stream_init(&weather_json, group_fields, group_count * GROUP_CITY_FIELDS, &group_parsed);
+  next_request_us = esp_timer_get_time() + (int64_t)OPENWEATHERMAP_RETRY_S * 1000000;
+#else
   snprintf( openweathermap_url, sizeof(openweathermap_url), \
-            "%s%s%s", CLIENT_REQ_PRE, city_weather[city_weather_index].city_name, CLIENT_REQ_POST);
+            "%s%ld%s", CLIENT_REQ_PRE, (long)city_weather[city_weather_index].city_id, CLIENT_REQ_POST);
+  json_stream_init(&weather_json, weather_fields, sizeof(weather_fields)/sizeof(weather_fields[0]), &weather_parsed);
+  next_request_us = esp_timer_get_time() + (int64_t)HTTP_REQ_EXEC_RATE * 1000;
+#endif
+  server_time = 0;
 
   esp_http_client_config_t config =
   {
@@ -138,8 +366,17 @@ static void openweathermap_send_request(void)
   // ESP_LOGI(TAG, "URL:%s", openweathermap_url);
   ESP_LOGI(TAG, "Free Heap: %lu, Minimum Heap: %lu", esp_get_free_heap_size(), esp_get_minimum_free_heap_size() );
 
-  esp_http_client_handle_t client = esp_http_client_init(&config);
+  // client comes from the shared pool, all the cities are fetched over the
+  // same keep-alive connection, so there is no TLS handshake for every request
+  esp_http_client_handle_t client = http_pool_acquire(&config);
+  if( client == NULL )
+  {
+    request_in_process = false;
+    return;
+  }
   esp_http_client_set_header(client, CLIENT_KEY, CLIENT_VALUE);
+  // conditional request, server responds 304 without body if nothing changed
+  http_cache_request(weather_cache_active, client);
   esp_err_t err = esp_http_client_perform(client);
   if( err == ESP_OK )
   {
@@ -148,6 +385,10 @@ static void openweathermap_send_request(void)
     {
       ESP_LOGI(TAG, "Message Sent Successfully");
     }
+    else if(status == 304)
+    {
+      ESP_LOGI(TAG, "Not Modified");
+    }
     else
     {
       ESP_LOGI(TAG, "Message Sent Failed");
@@ -156,42 +397,56 @@ static void openweathermap_send_request(void)
   else
   {
     ESP_LOGI(TAG, "Message Sent Failed");
+    // connection is in unknown state, next request will reconnect
+    esp_http_client_close(client);
+    request_in_process = false;
   }
-  esp_http_client_cleanup(client);
+  http_pool_release(client);
+  http_pool_log_stats();
 }
 
 static esp_err_t openweathermap_event_handler(esp_http_client_event_t *event)
 {
+  int status = 0;
+  bool done = false;
   switch(event->event_id)
   {
+    case HTTP_EVENT_ON_HEADER:
+      http_cache_header(weather_cache_active, event->header_key, event->header_value);
+      // server time, used to schedule the next request on server data cadence
+      if( strcasecmp(event->header_key, "Date") == 0 )
+      {
+        server_time = openweathermap_parse_date(event->header_value);
+      }
+      break;
     case HTTP_EVENT_ON_DATA:
-      // Copy the Data to response_data buffer
-      memcpy(response_data+response_data_idx, event->data, event->data_len);
-      // Update the Length
-      response_data_idx += event->data_len;
+      // parse the chunk, nothing is buffered so response size doesn't matter
+      json_stream_feed(&weather_json, event->data, event->data_len);
       break;
     case HTTP_EVENT_ON_FINISH:
+      status = esp_http_client_get_status_code(event->client);
+      if( status == 304 )
+      {
+        // cached values are still valid, there is no body to parse
+        done = openweathermap_not_modified();
+      }
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+      // Decode/Parse the weather data of the cities of this batch
+      else if( (status == 200) && openweathermap_get_group() )
+#else
       // Decode/Parse the weather data from the response data
-      openweathermap_get_weather(response_data, &city_weather[city_weather_index]);
-      // reset the response buffer and also the length to initial state
-      openweathermap_reset_buffer();
-      ESP_LOGI( TAG, "City=%s, Temp=%d, Pressure=%d, Humidity=%d", \
-                city_weather[city_weather_index].city_name,   \
-                city_weather[city_weather_index].temperature, \
-                city_weather[city_weather_index].pressure,    \
-                city_weather[city_weather_index].humidity);
-      city_weather_index++;
-      // Reset back to Initial Position
-      if( city_weather_index >= NUM_OF_CITIES )
+      else if( (status == 200) && openweathermap_get_weather(&city_weather[city_weather_index]) )
+#endif
       {
-        city_weather_index = 0;
+        openweathermap_cache_update(status);
+        done = true;
       }
+      openweathermap_next_request(done);
       // Free the system for next requests
       request_in_process = false;
       break;
     case HTTP_EVENT_ERROR:
       // In case of Error, exit
-      openweathermap_reset_buffer();
       // Free the system for next requests
       request_in_process = false;
       break;
@@ -201,20 +456,352 @@ static esp_err_t openweathermap_event_handler(esp_http_client_event_t *event)
   return ESP_OK;
 }
 
-static void openweathermap_get_weather(const char *json_string, weather_data_t *weather_data)
+static bool openweathermap_get_weather(weather_data_t *weather_data)
 {
-  cJSON *root = cJSON_Parse(json_string);
-  cJSON *obj = cJSON_GetObjectItemCaseSensitive(root, "main");
-  weather_data->temperature = cJSON_GetObjectItemCaseSensitive(obj, "temp")->valueint;
-  weather_data->pressure = cJSON_GetObjectItemCaseSensitive(obj, "pressure")->valueint;
-  weather_data->humidity = cJSON_GetObjectItemCaseSensitive(obj, "humidity")->valueint;
-  cJSON_Delete(root);
+  esp_err_t err = json_stream_finish(&weather_json);
+  weather_data_t updated = *weather_data;
+  bool status = false;
+
+  // city keeps the last good values if response is not complete
+  if( (err == ESP_OK) && json_stream_found_all(&weather_json) )
+  {
+    updated.temperature = (int16_t)weather_parsed.temperature;
+    updated.pressure = (uint16_t)weather_parsed.pressure;
+    updated.humidity = (uint8_t)weather_parsed.humidity;
+    updated.valid = true;
+    if( memcmp(&updated, weather_data, sizeof(updated)) != 0 )
+    {
+      weather_store_dirty = true;
+    }
+    taskENTER_CRITICAL(&city_weather_lock);
+    *weather_data = updated;
+    city_weather_generation++;
+    taskEXIT_CRITICAL(&city_weather_lock);
+    status = true;
+  }
+  else
+  {
+    ESP_LOGE(TAG, "Invalid response for %s (%s at %lu), values not updated", \
+             weather_data->city_name, esp_err_to_name(err), weather_json.offset);
+  }
+  return status;
 }
 
-static void openweathermap_reset_buffer(void)
+
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+// all the cities of the batch are updated together only if the response has all of them
+static bool openweathermap_get_group(void)
 {
-  // reset the response buffer and also the length to initial state
-  memset(response_data, 0x00, sizeof(response_data));
-  response_data_idx = 0;
+  esp_err_t err = json_stream_finish(&weather_json);
+  weather_data_t *batch = &city_weather[city_weather_index];
+  weather_data_t updated[GROUP_BATCH];
+  int oldest_dt = 0;
+  uint8_t found = 0;
+
+  if( (err != ESP_OK) || (json_stream_found_all(&weather_json) == false) )
+  {
+    ESP_LOGE(TAG, "Invalid group response (%s at %lu), values not updated", \
+             esp_err_to_name(err), weather_json.offset);
+    return false;
+  }
+
+  // response order is not guaranteed, match the entries with city id
+  memcpy(updated, batch, group_count * sizeof(weather_data_t));
+  for( uint8_t entry = 0; entry < group_count; entry++ )
+  {
+    const group_city_t *city = &group_parsed.city[entry];
+    for( uint8_t idx = 0; idx < group_count; idx++ )
+    {
+      if( updated[idx].city_id == city->id )
+      {
+        updated[idx].temperature = (int16_t)city->temperature;
+        updated[idx].pressure = (uint16_t)city->pressure;
+        updated[idx].humidity = (uint8_t)city->humidity;
+        updated[idx].valid = true;
+        found++;
+        break;
+      }
+    }
+    if( (oldest_dt == 0) || (city->dt < oldest_dt) )
+    {
+      oldest_dt = city->dt;
+    }
+  }
+  if( found != group_count )
+  {
+    ESP_LOGE(TAG, "Group response has unknown cities, values not updated");
+    return false;
+  }
+
+  if( memcmp(updated, batch, group_count * sizeof(weather_data_t)) != 0 )
+  {
+    weather_store_dirty = true;
+  }
+  taskENTER_CRITICAL(&city_weather_lock);
+  memcpy(batch, updated, group_count * sizeof(weather_data_t));
+  city_weather_generation++;
+  taskEXIT_CRITICAL(&city_weather_lock);
+  group_oldest_dt[city_weather_index / GROUP_BATCH] = oldest_dt;
+
+  for( uint8_t idx = 0; idx < group_count; idx++ )
+  {
+    ESP_LOGI( TAG, "City=%s, Temp=%d, Pressure=%d, Humidity=%d", \
+              batch[idx].city_name, batch[idx].temperature, \
+              batch[idx].pressure, batch[idx].humidity);
+  }
+  return true;
 }
 
+// OpenWeatherMap calculates the weather of a city every OPENWEATHERMAP_UPDATE_S,
+// the next request is sent when the oldest city gets new data, requests in
+// between would only get the same values again
+static void openweathermap_schedule(int oldest_dt)
+{
+  int64_t wait_s = OPENWEATHERMAP_UPDATE_S;
+
+  if( server_time > 0 )
+  {
+    wait_s = (int64_t)oldest_dt + OPENWEATHERMAP_UPDATE_S - server_time;
+  }
+  // new data is late, or time is wrong, check again after retry interval
+  if( wait_s < OPENWEATHERMAP_RETRY_S )
+  {
+    wait_s = OPENWEATHERMAP_RETRY_S;
+  }
+  if( wait_s > OPENWEATHERMAP_UPDATE_S )
+  {
+    wait_s = OPENWEATHERMAP_UPDATE_S;
+  }
+  next_request_us = esp_timer_get_time() + wait_s * 1000000;
+  ESP_LOGI(TAG, "Next request in %ld seconds", (long)wait_s);
+}
+#endif
+
+// move to the next request, values are saved when all the cities are done
+static void openweathermap_next_request(bool done)
+{
+#ifdef CONFIG_OPENWEATHERMAP_GROUP_FETCH
+  int oldest_dt = 0;
+
+  // failed batch is requested again after the retry interval
+  if( done == false )
+  {
+    return;
+  }
+  // next batch right away, all the cities should have data of the same time
+  city_weather_index += GROUP_BATCH;
+  if( city_weather_index < num_of_cities )
+  {
+    next_request_us = 0;
+    return;
+  }
+  city_weather_index = 0;
+  for( uint8_t batch = 0; batch < ((num_of_cities + GROUP_BATCH - 1u) / GROUP_BATCH); batch++ )
+  {
+    if( (batch == 0) || (group_oldest_dt[batch] < oldest_dt) )
+    {
+      oldest_dt = group_oldest_dt[batch];
+    }
+  }
+  openweathermap_schedule(oldest_dt);
+#else
+  if( done )
+  {
+    ESP_LOGI( TAG, "City=%s, Temp=%d, Pressure=%d, Humidity=%d", \
+              city_weather[city_weather_index].city_name,   \
+              city_weather[city_weather_index].temperature, \
+              city_weather[city_weather_index].pressure,    \
+              city_weather[city_weather_index].humidity);
+  }
+  city_weather_index++;
+  // Reset back to Initial Position
+  if( city_weather_index < num_of_cities )
+  {
+    return;
+  }
+  city_weather_index = 0;
+#endif
+  openweathermap_save();
+}
+
+// server has no newer data than the cached response, values are not changed
+static bool openweathermap_not_modified(void)
+{
+  if( http_cache_response(weather_cache_active, 304, false) == HTTP_CACHE_NOT_MODIFIED )
+  {
+    ESP_LOGI(TAG, "Weather data not modified, cached values are used");
+    return true;
+  }
+  return false;
+}
+
+// keep the validators of the decoded response for the next conditional request
+static void openweathermap_cache_update(int status)
+{
+  http_cache_validator_t validator = weather_cache_active->valid;
+
+  http_cache_response(weather_cache_active, status, true);
+  if( memcmp(&validator, &weather_cache_active->valid, sizeof(validator)) != 0 )
+  {
+    weather_store_dirty = true;
+  }
+}
+
+// replace the city table, values of the new cities are not known yet
+static void openweathermap_apply_cities(const openweathermap_city_t *cities, uint8_t count)
+{
+  taskENTER_CRITICAL(&city_weather_lock);
+  memset(city_weather, 0x00, sizeof(city_weather));
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    city_weather[idx].city_id = cities[idx].id;
+    memcpy(city_weather[idx].city_name, cities[idx].name, OPENWEATHERMAP_CITY_NAME_LEN);
+    city_weather[idx].city_name[OPENWEATHERMAP_CITY_NAME_LEN - 1] = '\0';
+  }
+  num_of_cities = count;
+  city_weather_generation++;
+  taskEXIT_CRITICAL(&city_weather_lock);
+
+  // validators are of the old requests
+  for( uint8_t idx = 0; idx < OPENWEATHERMAP_CACHE_SLOTS; idx++ )
+  {
+    http_cache_init(&weather_cache[idx]);
+  }
+  city_weather_index = 0;
+  next_request_us = 0;
+  weather_store_dirty = true;
+  openweathermap_save();
+}
+
+// load the city table saved by openweathermap_save, the display shows the
+// values right after boot and the first requests are conditional ones
+static bool openweathermap_load(void)
+{
+  nvs_handle_t nvs;
+  uint16_t version = 0;
+  size_t size = sizeof(city_weather);
+  http_cache_validator_t *validators = NULL;
+  esp_err_t err = nvs_open(OPENWEATHERMAP_NVS_NAMESPACE, NVS_READONLY, &nvs);
+
+  if( err != ESP_OK )
+  {
+    ESP_LOGI(TAG, "No saved city list (%s)", esp_err_to_name(err));
+    return false;
+  }
+  err = nvs_get_u16(nvs, OPENWEATHERMAP_NVS_VERSION, &version);
+  if( (err == ESP_OK) && (version == OPENWEATHERMAP_STORE_VERSION) )
+  {
+    err = nvs_get_blob(nvs, OPENWEATHERMAP_NVS_CITIES, city_weather, &size);
+  }
+  if( (err != ESP_OK) || (version != OPENWEATHERMAP_STORE_VERSION) || \
+      (size == 0) || ((size % sizeof(weather_data_t)) != 0) )
+  {
+    ESP_LOGI(TAG, "No saved city list (%s)", esp_err_to_name(err));
+    nvs_close(nvs);
+    memset(city_weather, 0x00, sizeof(city_weather));
+    return false;
+  }
+
+  taskENTER_CRITICAL(&city_weather_lock);
+  num_of_cities = (uint8_t)(size / sizeof(weather_data_t));
+  for( uint8_t idx = 0; idx < num_of_cities; idx++ )
+  {
+    city_weather[idx].city_name[OPENWEATHERMAP_CITY_NAME_LEN - 1] = '\0';
+  }
+  city_weather_generation++;
+  taskEXIT_CRITICAL(&city_weather_lock);
+
+  // validators are optional, without them the first requests are not conditional
+  size = OPENWEATHERMAP_CACHE_SLOTS * sizeof(http_cache_validator_t);
+  validators = malloc(size);
+  if( (validators != NULL) && \
+      (nvs_get_blob(nvs, OPENWEATHERMAP_NVS_CACHE, validators, &size) == ESP_OK) && \
+      (size == (OPENWEATHERMAP_CACHE_SLOTS * sizeof(http_cache_validator_t))) )
+  {
+    for( uint8_t idx = 0; idx < OPENWEATHERMAP_CACHE_SLOTS; idx++ )
+    {
+      http_cache_restore(&weather_cache[idx], &validators[idx]);
+    }
+  }
+  else
+  {
+    for( uint8_t idx = 0; idx < OPENWEATHERMAP_CACHE_SLOTS; idx++ )
+    {
+      http_cache_init(&weather_cache[idx]);
+    }
+  }
+  free(validators);
+  nvs_close(nvs);
+  ESP_LOGI(TAG, "Saved list of %u cities loaded", num_of_cities);
+  return true;
+}
+
+// save the city table and the validators, flash is written only if something
+// changed, at most once per update of all the cities
+static void openweathermap_save(void)
+{
+  nvs_handle_t nvs;
+  size_t size = OPENWEATHERMAP_CACHE_SLOTS * sizeof(http_cache_validator_t);
+  http_cache_validator_t *validators = NULL;
+  esp_err_t err = ESP_OK;
+
+  if( weather_store_dirty == false )
+  {
+    return;
+  }
+  weather_store_dirty = false;
+
+  err = nvs_open(OPENWEATHERMAP_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+  if( err == ESP_OK )
+  {
+    err = nvs_set_u16(nvs, OPENWEATHERMAP_NVS_VERSION, OPENWEATHERMAP_STORE_VERSION);
+    if( err == ESP_OK )
+    {
+      err = nvs_set_blob(nvs, OPENWEATHERMAP_NVS_CITIES, city_weather, num_of_cities * sizeof(weather_data_t));
+    }
+    validators = malloc(size);
+    if( (err == ESP_OK) && (validators != NULL) )
+    {
+      for( uint8_t idx = 0; idx < OPENWEATHERMAP_CACHE_SLOTS; idx++ )
+      {
+        validators[idx] = weather_cache[idx].valid;
+      }
+      err = nvs_set_blob(nvs, OPENWEATHERMAP_NVS_CACHE, validators, size);
+    }
+    free(validators);
+    if( err == ESP_OK )
+    {
+      err = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+  }
+  if( err != ESP_OK )
+  {
+    ESP_LOGE(TAG, "Unable to save weather data (%s)", esp_err_to_name(err));
+  }
+}
+
+// convert HTTP date "Sun, 06 Nov 1994 08:49:37 GMT" to unix time, 0 if invalid
+static int64_t openweathermap_parse_date(const char *date)
+{
+  static const char *months = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  char month[4] = { 0 };
+  const char *month_pos = NULL;
+  int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+  int mon = 0, era = 0, yoe = 0, doy = 0, doe = 0;
+
+  if( (sscanf(date, "%*[^,], %d %3s %d %d:%d:%d", &day, month, &year, &hour, &minute, &second) != 6) || \
+      ((month_pos = strstr(months, month)) == NULL) || (strlen(month) != 3) )
+  {
+    return 0;
+  }
+  mon = (int)((month_pos - months) / 3) + 1;
+
+  // days since 1970-01-01 of the civil date (proleptic Gregorian calendar)
+  year -= (mon <= 2);
+  era = year / 400;
+  yoe = year - (era * 400);
+  doy = ((153 * (mon + ((mon > 2) ? -3 : 9)) + 2) / 5) + day - 1;
+  doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+  return ((int64_t)((era * 146097) + doe - 719468) * 86400) + (hour * 3600) + (minute * 60) + second;
+}
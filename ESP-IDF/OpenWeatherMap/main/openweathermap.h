@@ -14,6 +14,15 @@
 #define OPENWEATHERMAP_TASK_NAME              "OpenWeatherMap"
 #define OPENWEATHERMAP_TASK_STACK_SIZE        (1024u*10)
 #define OPENWEATHERMAP_TASK_PRIORITY          (5u)
+#define OPENWEATHERMAP_CITY_MAX               CONFIG_OPENWEATHERMAP_CITY_MAX
+#define OPENWEATHERMAP_CITY_NAME_LEN          (20u)
+
+// Structures
+typedef struct _openweathermap_city_t
+{
+  int32_t id;                                 // OpenWeatherMap city id
+  char name[OPENWEATHERMAP_CITY_NAME_LEN];    // name shown on display
+} openweathermap_city_t;
 
 // Public Function Prototypes
 void openweathermap_init(void);
@@ -22,8 +31,12 @@ void openweathermap_task(void *pvParameters);
 int openweathermap_get_temperature(uint8_t city_idx);
 int openweathermap_get_pressure(uint8_t city_idx);
 int openweathermap_get_humidity(uint8_t city_idx);
-char* openweathermap_get_city_name(uint8_t city_idx);
+bool openweathermap_get_city_name(uint8_t city_idx, char *name, size_t size);
 uint8_t openweathermap_get_numofcity(void);
+bool openweathermap_is_valid(uint8_t city_idx);
+uint32_t openweathermap_get_generation(void);
+uint8_t openweathermap_get_cities(openweathermap_city_t *cities, uint8_t max_cities);
+esp_err_t openweathermap_set_cities(const openweathermap_city_t *cities, uint8_t num_of_cities);
 
 /*
 To Create Task use the following code
@@ -0,0 +1,112 @@
+// Based on the screens generated by SquareLine Studio
+// SquareLine Studio version: SquareLine Studio 1.3.0
+// LVGL version: 8.3.6
+// Project name: OpenWeatherMap
+// One screen for all the cities, display_mng binds it to the city to show
+
+#include "../ui.h"
+
+void ui_CityScreen_screen_init(void)
+{
+    ui_CityScreen = lv_obj_create(NULL);
+    lv_obj_clear_flag(ui_CityScreen, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    // labels inherit the text color, display_mng sets it for every city
+    lv_obj_set_style_text_color(ui_CityScreen, lv_color_hex(0x000000), LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_cityImage = lv_img_create(ui_CityScreen);
+    lv_obj_set_width(ui_cityImage, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_cityImage, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_align(ui_cityImage, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_cityImage, LV_OBJ_FLAG_ADV_HITTEST);     /// Flags
+    lv_obj_clear_flag(ui_cityImage, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+    lv_obj_add_flag(ui_cityImage, LV_OBJ_FLAG_HIDDEN);     /// Flags, shown if the city has an image
+
+    ui_Temperature = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_Temperature, 20);
+    lv_obj_set_width(ui_Temperature, lv_pct(45));
+    lv_obj_set_x(ui_Temperature, -70);
+    lv_obj_set_y(ui_Temperature, -100);
+    lv_obj_set_align(ui_Temperature, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_Temperature, "Temperature: ");
+    lv_obj_set_style_text_opa(ui_Temperature, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_Temperature, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_Temperature, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_Pressure = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_Pressure, 20);
+    lv_obj_set_width(ui_Pressure, lv_pct(45));
+    lv_obj_set_x(ui_Pressure, -70);
+    lv_obj_set_y(ui_Pressure, -80);
+    lv_obj_set_align(ui_Pressure, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_Pressure, "Pressure:");
+    lv_obj_set_style_text_opa(ui_Pressure, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_Pressure, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_Pressure, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_tempValue = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_tempValue, 20);
+    lv_obj_set_width(ui_tempValue, lv_pct(45));
+    lv_obj_set_x(ui_tempValue, 80);
+    lv_obj_set_y(ui_tempValue, -100);
+    lv_obj_set_align(ui_tempValue, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_tempValue, "--");
+    lv_obj_set_style_text_opa(ui_tempValue, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_tempValue, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_tempValue, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_pressureValue = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_pressureValue, 20);
+    lv_obj_set_width(ui_pressureValue, lv_pct(45));
+    lv_obj_set_x(ui_pressureValue, 80);
+    lv_obj_set_y(ui_pressureValue, -80);
+    lv_obj_set_align(ui_pressureValue, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_pressureValue, "--");
+    lv_obj_set_style_text_opa(ui_pressureValue, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_pressureValue, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_pressureValue, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_Humidity = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_Humidity, 20);
+    lv_obj_set_width(ui_Humidity, lv_pct(45));
+    lv_obj_set_x(ui_Humidity, -70);
+    lv_obj_set_y(ui_Humidity, -60);
+    lv_obj_set_align(ui_Humidity, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_Humidity, "Humidity:");
+    lv_obj_set_style_text_opa(ui_Humidity, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_Humidity, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_Humidity, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_humidityValue = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_humidityValue, 20);
+    lv_obj_set_width(ui_humidityValue, lv_pct(45));
+    lv_obj_set_x(ui_humidityValue, 80);
+    lv_obj_set_y(ui_humidityValue, -60);
+    lv_obj_set_align(ui_humidityValue, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_humidityValue, "--");
+    lv_obj_set_style_text_opa(ui_humidityValue, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_humidityValue, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_humidityValue, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_CityName = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_CityName, 20);
+    lv_obj_set_width(ui_CityName, lv_pct(45));
+    lv_obj_set_x(ui_CityName, -70);
+    lv_obj_set_y(ui_CityName, -40);
+    lv_obj_set_align(ui_CityName, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_CityName, "City Name:");
+    lv_obj_set_style_text_opa(ui_CityName, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_CityName, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_CityName, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+    ui_cityNameValue = lv_label_create(ui_CityScreen);
+    lv_obj_set_height(ui_cityNameValue, 20);
+    lv_obj_set_width(ui_cityNameValue, lv_pct(45));
+    lv_obj_set_x(ui_cityNameValue, 80);
+    lv_obj_set_y(ui_cityNameValue, -40);
+    lv_obj_set_align(ui_cityNameValue, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_cityNameValue, "");
+    lv_obj_set_style_text_opa(ui_cityNameValue, 255, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_align(ui_cityNameValue, LV_TEXT_ALIGN_LEFT, LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_set_style_text_font(ui_cityNameValue, &lv_font_montserrat_20, LV_PART_MAIN | LV_STATE_DEFAULT);
+
+}
@@ -12,6 +12,7 @@
 #include <freertos/event_groups.h>
 #include "esp_ota_ops.h"
 #include "sys/param.h"
+#include "web_assets.h"
 
 #include "http_server.h"
 #include "tasks_common.h"
@@ -105,17 +106,23 @@ static const httpd_uri_t OTA_status =
   .user_ctx  = NULL
 };
 
-// Embedded Files: JQuery, index.html, app.css, app.js, and favicon.ico files
-extern const uint8_t jquery_3_3_1_min_js_start[]      asm("_binary_jquery_3_3_1_min_js_start");
-extern const uint8_t jquery_3_3_1_min_js_end[]        asm("_binary_jquery_3_3_1_min_js_end");
-extern const uint8_t index_html_start[]               asm("_binary_index_html_start");
-extern const uint8_t index_html_end[]                 asm("_binary_index_html_end");
-extern const uint8_t app_css_start[]                  asm("_binary_app_css_start");
-extern const uint8_t app_css_end[]                    asm("_binary_app_css_end");
-extern const uint8_t app_js_start[]                   asm("_binary_app_js_start");
-extern const uint8_t app_js_end[]                     asm("_binary_app_js_end");
-extern const uint8_t favicon_ico_start[]              asm("_binary_favicon_ico_start");
-extern const uint8_t favicon_ico_end[]                asm("_binary_favicon_ico_end");
+// Embedded Files (gzip compressed at build time): JQuery, index.html, app.css, app.js, and favicon.ico files
+extern const uint8_t jquery_3_3_1_min_js_gz_start[] asm("_binary_jquery_3_3_1_min_js_gz_start");
+extern const uint8_t jquery_3_3_1_min_js_gz_end[]   asm("_binary_jquery_3_3_1_min_js_gz_end");
+extern const uint8_t index_html_gz_start[]          asm("_binary_index_html_gz_start");
+extern const uint8_t index_html_gz_end[]            asm("_binary_index_html_gz_end");
+extern const uint8_t app_css_gz_start[]             asm("_binary_app_css_gz_start");
+extern const uint8_t app_css_gz_end[]               asm("_binary_app_css_gz_end");
+extern const uint8_t app_js_gz_start[]              asm("_binary_app_js_gz_start");
+extern const uint8_t app_js_gz_end[]                asm("_binary_app_js_gz_end");
+extern const uint8_t favicon_ico_gz_start[]         asm("_binary_favicon_ico_gz_start");
+extern const uint8_t favicon_ico_gz_end[]           asm("_binary_favicon_ico_gz_end");
+// jQuery file name has the version, it is cached by the browser without revalidation
+static const web_asset_t jquery_3_3_1_min_js_asset = WEB_ASSET( jquery_3_3_1_min_js_gz, "application/javascript", true );
+static const web_asset_t index_html_asset       = WEB_ASSET( index_html_gz, "text/html", false );
+static const web_asset_t app_css_asset          = WEB_ASSET( app_css_gz, "text/css", false );
+static const web_asset_t app_js_asset           = WEB_ASSET( app_js_gz, "application/javascript", false );
+static const web_asset_t favicon_ico_asset      = WEB_ASSET( favicon_ico_gz, "image/x-icon", false );
 
 /*
  * Send a message to the Queue
@@ -273,8 +280,7 @@ static esp_err_t HTTP_Server_jQueryHandler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "JQuery Requested");
-  httpd_resp_set_type( req, "application/javascript");
-  error = httpd_resp_send(req, (const char*)jquery_3_3_1_min_js_start, jquery_3_3_1_min_js_end-jquery_3_3_1_min_js_start );
+  error = web_assets_send(req, &jquery_3_3_1_min_js_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "HTTP_Server_jQueryHandler: Error %d while sending Response", error );
@@ -295,8 +301,7 @@ static esp_err_t HTTP_Server_IndexHTMLHandler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "Index HTML Requested");
-  httpd_resp_set_type( req, "text/html");
-  error = httpd_resp_send(req, (const char*)index_html_start, index_html_end-index_html_start );
+  error = web_assets_send(req, &index_html_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "HTTP_Server_IndexHTMLHandler: Error %d while sending Response", error );
@@ -317,8 +322,7 @@ static esp_err_t HTTP_Server_AppCSSHandler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "APP CSS Requested");
-  httpd_resp_set_type( req, "text/css");
-  error = httpd_resp_send(req, (const char*)app_css_start, app_css_end-app_css_start );
+  error = web_assets_send(req, &app_css_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "HTTP_Server_AppCSSHandler: Error %d while sending Response", error );
@@ -339,8 +343,7 @@ static esp_err_t HTTP_Server_AppJSHandler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "APP JS Requested");
-  httpd_resp_set_type( req, "application/javascript");
-  error = httpd_resp_send(req, (const char*)app_js_start, app_js_end-app_js_start );
+  error = web_assets_send(req, &app_js_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "HTTP_Server_AppJSHandler: Error %d while sending Response", error );
@@ -361,8 +364,7 @@ static esp_err_t HTTP_Server_FaviconIcoHandler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "Favicon.ico Requested");
-  httpd_resp_set_type( req, "image/x-icon");
-  error = httpd_resp_send(req, (const char*)favicon_ico_start, favicon_ico_end-favicon_ico_start );
+  error = web_assets_send(req, &favicon_ico_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "HTTP_Server_FaviconIcoHandler: Error %d while sending Response", error );
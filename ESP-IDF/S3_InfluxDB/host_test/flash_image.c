@@ -0,0 +1,190 @@
+/*
+ * flash_image.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * The image is a file of the partition size, erased bytes are 0xFF and a write
+ * can only clear bits, like esp_partition_write on NOR flash. A write which
+ * would have to set a bit is counted in program_errors, the log must never
+ * depend on it. flash_image_poke bypasses this to simulate torn writes.
+ */
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "flash_image.h"
+
+// Private Macros
+#define FLASH_IMAGE_CHUNK                 (FLASH_LOG_SECTOR_SIZE)
+
+// Private Function Declaration
+static bool flash_image_read( void *ctx, uint32_t offset, void *data, size_t len );
+static bool flash_image_write( void *ctx, uint32_t offset, const void *data, size_t len );
+static bool flash_image_erase( void *ctx, uint32_t offset, size_t len );
+
+const flash_log_ops_t flash_image_ops =
+{
+  .read = flash_image_read,
+  .write = flash_image_write,
+  .erase = flash_image_erase,
+};
+
+// Public Function Definition
+
+/**
+ * @brief Open the image file
+ * @param image image object
+ * @param path file path
+ * @param size partition size, multiple of FLASH_LOG_SECTOR_SIZE
+ * @param blank true to create an erased image, false to use the existing file
+ * @return true if successful else false
+ */
+bool flash_image_open( flash_image_t *image, const char *path, uint32_t size, bool blank )
+{
+  memset( image, 0x00, sizeof(flash_image_t) );
+  if( (size % FLASH_LOG_SECTOR_SIZE) || ((size / FLASH_LOG_SECTOR_SIZE) > FLASH_IMAGE_MAX_SECTORS) )
+  {
+    return false;
+  }
+  image->fd = open( path, blank ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644 );
+  if( image->fd < 0 )
+  {
+    return false;
+  }
+  image->size = size;
+  if( blank && !flash_image_erase( image, 0, size ) )
+  {
+    flash_image_close( image );
+    return false;
+  }
+  // the initial erase is the factory state, it is not wear
+  memset( image->erase_count, 0x00, sizeof(image->erase_count) );
+  flash_image_reset_stats( image );
+  return true;
+}
+
+/**
+ * @brief Close the image file, the content stays for the next open
+ * @param image image object
+ */
+void flash_image_close( flash_image_t *image )
+{
+  if( image->fd >= 0 )
+  {
+    close( image->fd );
+  }
+  image->fd = -1;
+}
+
+/**
+ * @brief Clear the access counters, the erase count per sector is kept
+ * @param image image object
+ */
+void flash_image_reset_stats( flash_image_t *image )
+{
+  image->bytes_read = 0;
+  image->bytes_written = 0;
+  image->reads = 0;
+  image->writes = 0;
+  image->erases = 0;
+  image->program_errors = 0;
+}
+
+/**
+ * @brief Read the image without counting it as flash traffic
+ * @param image image object
+ * @param offset offset in image
+ * @param data output buffer
+ * @param len number of bytes
+ * @return true if successful else false
+ */
+bool flash_image_peek( flash_image_t *image, uint32_t offset, void *data, size_t len )
+{
+  return ( ((offset + len) <= image->size) && \
+           (pread( image->fd, data, len, offset ) == (ssize_t)len) );
+}
+
+/**
+ * @brief Overwrite the image, bits can be set, this simulates a torn write
+ * @param image image object
+ * @param offset offset in image
+ * @param data new content
+ * @param len number of bytes
+ * @return true if successful else false
+ */
+bool flash_image_poke( flash_image_t *image, uint32_t offset, const void *data, size_t len )
+{
+  return ( ((offset + len) <= image->size) && \
+           (pwrite( image->fd, data, len, offset ) == (ssize_t)len) );
+}
+
+// Private Function Definition
+
+static bool flash_image_read( void *ctx, uint32_t offset, void *data, size_t len )
+{
+  flash_image_t *image = (flash_image_t *)ctx;
+
+  image->reads++;
+  image->bytes_read += len;
+  return flash_image_peek( image, offset, data, len );
+}
+
+static bool flash_image_write( void *ctx, uint32_t offset, const void *data, size_t len )
+{
+  flash_image_t *image = (flash_image_t *)ctx;
+  const uint8_t *src = (const uint8_t *)data;
+  uint8_t cell[FLASH_IMAGE_CHUNK];
+  size_t chunk = 0;
+  size_t idx = 0;
+
+  image->writes++;
+  image->bytes_written += len;
+  while( len )
+  {
+    chunk = (len < sizeof(cell)) ? len : sizeof(cell);
+    if( !flash_image_peek( image, offset, cell, chunk ) )
+    {
+      return false;
+    }
+    // NOR flash, programming can only clear bits
+    for( idx = 0; idx < chunk; idx++ )
+    {
+      if( (uint8_t)(src[idx] & ~cell[idx]) )
+      {
+        image->program_errors++;
+      }
+      cell[idx] &= src[idx];
+    }
+    if( !flash_image_poke( image, offset, cell, chunk ) )
+    {
+      return false;
+    }
+    offset += (uint32_t)chunk;
+    src += chunk;
+    len -= chunk;
+  }
+  return true;
+}
+
+static bool flash_image_erase( void *ctx, uint32_t offset, size_t len )
+{
+  flash_image_t *image = (flash_image_t *)ctx;
+  uint8_t blank[FLASH_LOG_SECTOR_SIZE];
+
+  if( (offset % FLASH_LOG_SECTOR_SIZE) || (len % FLASH_LOG_SECTOR_SIZE) || ((offset + len) > image->size) )
+  {
+    return false;
+  }
+  memset( blank, 0xFF, sizeof(blank) );
+  for( ; len; len -= FLASH_LOG_SECTOR_SIZE, offset += FLASH_LOG_SECTOR_SIZE )
+  {
+    if( !flash_image_poke( image, offset, blank, sizeof(blank) ) )
+    {
+      return false;
+    }
+    image->erase_count[offset / FLASH_LOG_SECTOR_SIZE]++;
+    image->erases++;
+  }
+  return true;
+}
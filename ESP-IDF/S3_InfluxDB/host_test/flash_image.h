@@ -0,0 +1,45 @@
+/*
+ * flash_image.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Partition image file with NOR flash semantics for the host test and
+ * benchmark of flash_log, the access counters give the flash traffic.
+ */
+
+#ifndef FLASH_IMAGE_H_
+#define FLASH_IMAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "flash_log.h"
+
+// macros
+#define FLASH_IMAGE_MAX_SECTORS                 (256u)
+
+typedef struct _flash_image_t
+{
+  int       fd;
+  uint32_t  size;
+  uint32_t  erase_count[FLASH_IMAGE_MAX_SECTORS];
+  uint64_t  bytes_read;
+  uint64_t  bytes_written;
+  uint32_t  reads;
+  uint32_t  writes;
+  uint32_t  erases;
+  uint32_t  program_errors;                 // writes which had to set a bit
+} flash_image_t;
+
+extern const flash_log_ops_t flash_image_ops;
+
+// Public Function Prototypes
+bool flash_image_open( flash_image_t *image, const char *path, uint32_t size, bool blank );
+void flash_image_close( flash_image_t *image );
+void flash_image_reset_stats( flash_image_t *image );
+bool flash_image_peek( flash_image_t *image, uint32_t offset, void *data, size_t len );
+bool flash_image_poke( flash_image_t *image, uint32_t offset, const void *data, size_t len );
+
+#endif /* FLASH_IMAGE_H_ */
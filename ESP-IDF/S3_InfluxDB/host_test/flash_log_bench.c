@@ -0,0 +1,191 @@
+/*
+ * flash_log_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host benchmark of flash_log on a 1 MB partition image file, the size of the
+ * sensorlog partition. The host time is bound by the file access, the flash
+ * traffic (operations and bytes) is what translates to the target:
+ *  append  the log is written twice over, flushed every few samples like the
+ *          sensor task and flushed only when the write buffer is full
+ *  mount   sector headers and the head sector only
+ *  replay  the boot replay in the RAM history, the complete log against the
+ *          newest sectors which can fill the history (flash_log_seek_tail)
+ *
+ *  make -C S3_InfluxDB/host_test bench
+ *  build/flash_log_bench [history blocks]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "flash_log.h"
+#include "flash_image.h"
+#include "ts_store.h"
+
+// Private Macros
+#define BENCH_IMAGE                         "build/flash_log_bench.bin"
+#define BENCH_SIZE                          (FLASH_IMAGE_MAX_SECTORS * FLASH_LOG_SECTOR_SIZE)
+#define BENCH_T0                            (1790000000u)
+#define BENCH_PERIOD                        (60u)
+#define BENCH_FLUSH_SAMPLES                 (5u)      // CONFIG_SENSOR_LOG_FLUSH_SAMPLES
+#define BENCH_HISTORY_BLOCKS                (64u)     // CONFIG_SENSOR_HISTORY_BLOCKS
+#define BENCH_MAX_BLOCKS                    (4096u)
+
+typedef struct _bench_record_t
+{
+  uint8_t temperature;
+  uint8_t humidity;
+} bench_record_t;
+
+// Private Variables
+static flash_image_t bench_image;
+static flash_log_index_t bench_index[FLASH_IMAGE_MAX_SECTORS];
+static ts_block_t bench_blocks[BENCH_MAX_BLOCKS];
+
+// Private Function Declaration
+static double bench_time_s( void );
+static bool bench_append( flash_log_t *log, uint32_t flush_samples, uint32_t *count );
+static void bench_replay( flash_log_t *log, uint16_t num_blocks, bool tail );
+
+int main( int argc, char **argv )
+{
+  uint32_t blocks = (argc > 1) ? (uint32_t)strtoul( argv[1], NULL, 0 ) : BENCH_HISTORY_BLOCKS;
+  flash_log_t log;
+  uint32_t count = 0;
+  double start = 0.0;
+
+  if( (blocks == 0) || (blocks > BENCH_MAX_BLOCKS) )
+  {
+    printf( "history blocks 1..%u\n", (unsigned)BENCH_MAX_BLOCKS );
+    return EXIT_FAILURE;
+  }
+
+  if( !bench_append( &log, BENCH_FLUSH_SAMPLES, &count ) || \
+      !bench_append( &log, 0, &count ) )
+  {
+    printf( "append failed\n" );
+    return EXIT_FAILURE;
+  }
+
+  flash_image_close( &bench_image );
+  if( !flash_image_open( &bench_image, BENCH_IMAGE, BENCH_SIZE, false ) )
+  {
+    return EXIT_FAILURE;
+  }
+  start = bench_time_s();
+  if( !flash_log_mount( &log, &flash_image_ops, &bench_image, bench_index, BENCH_SIZE ) )
+  {
+    printf( "mount failed\n" );
+    return EXIT_FAILURE;
+  }
+  printf( "mount:  %.3f ms, %u reads, %llu bytes read, %u sectors in use\n", \
+          (bench_time_s() - start) * 1e3, (unsigned)bench_image.reads, \
+          (unsigned long long)bench_image.bytes_read, (unsigned)log.used );
+
+  bench_replay( &log, (uint16_t)blocks, false );
+  bench_replay( &log, (uint16_t)blocks, true );
+  flash_image_close( &bench_image );
+  return EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+static double bench_time_s( void )
+{
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Write the log twice over on a blank image
+ * @param log log object
+ * @param flush_samples flush after these many samples, 0 for buffer full only
+ * @param count number of records written
+ * @return true if successful else false
+ */
+static bool bench_append( flash_log_t *log, uint32_t flush_samples, uint32_t *count )
+{
+  bench_record_t record;
+  uint32_t records = 2u * (BENCH_SIZE / 16u);
+  uint32_t idx = 0;
+  double start = 0.0;
+  double elapsed = 0.0;
+
+  flash_image_close( &bench_image );
+  if( !flash_image_open( &bench_image, BENCH_IMAGE, BENCH_SIZE, true ) || \
+      !flash_log_mount( log, &flash_image_ops, &bench_image, bench_index, BENCH_SIZE ) )
+  {
+    return false;
+  }
+  flash_image_reset_stats( &bench_image );
+  start = bench_time_s();
+  for( idx = 0; idx < records; idx++ )
+  {
+    record.temperature = (uint8_t)(20 + (idx / 30u) % 7u);
+    record.humidity = (uint8_t)(40 + (idx / 20u) % 11u);
+    if( !flash_log_append( log, BENCH_T0 + idx * BENCH_PERIOD, &record, sizeof(record) ) )
+    {
+      return false;
+    }
+    if( flush_samples && ((idx % flush_samples) == (flush_samples - 1u)) && !flash_log_flush( log ) )
+    {
+      return false;
+    }
+  }
+  if( !flash_log_flush( log ) )
+  {
+    return false;
+  }
+  elapsed = bench_time_s() - start;
+  *count = records;
+  printf( "append: flush every %-3u %u records, %.2f s, %.0f records/s, %.3f writes/record, %.1f bytes/record, %u erases\n", \
+          (unsigned)(flush_samples ? flush_samples : FLASH_LOG_WRITE_BUF_SIZE / 16u), (unsigned)records, elapsed, \
+          (double)records / elapsed, (double)bench_image.writes / records, \
+          (double)bench_image.bytes_written / records, (unsigned)bench_image.erases );
+  return ( bench_image.program_errors == 0 );
+}
+
+/**
+ * @brief Replay the log in the RAM history, like sensor_history_restore
+ * @param log mounted log
+ * @param num_blocks history blocks
+ * @param tail true for the newest sectors only, false for the complete log
+ */
+static void bench_replay( flash_log_t *log, uint16_t num_blocks, bool tail )
+{
+  flash_log_cursor_t cursor;
+  ts_store_t history;
+  bench_record_t record;
+  int32_t values[2];
+  uint32_t timestamp = 0;
+  uint32_t count = 0;
+  size_t len = sizeof(record);
+  double start = 0.0;
+
+  ts_store_init( &history, bench_blocks, num_blocks, 2 );
+  flash_image_reset_stats( &bench_image );
+  start = bench_time_s();
+  if( tail )
+  {
+    flash_log_seek_tail( log, ts_store_capacity( &history ), sizeof(record), &cursor );
+  }
+  else
+  {
+    flash_log_seek( log, 0, &cursor );
+  }
+  while( flash_log_next( &cursor, &timestamp, &record, &len ) )
+  {
+    values[0] = record.temperature;
+    values[1] = record.humidity;
+    ts_store_append( &history, timestamp, values );
+    count++;
+    len = sizeof(record);
+  }
+  printf( "replay: %-4s %u blocks, %.2f ms, %u records read, %u reads, %llu bytes read, history %u records\n", \
+          tail ? "tail" : "full", (unsigned)num_blocks, (bench_time_s() - start) * 1e3, (unsigned)count, \
+          (unsigned)bench_image.reads, (unsigned long long)bench_image.bytes_read, (unsigned)history.records );
+}
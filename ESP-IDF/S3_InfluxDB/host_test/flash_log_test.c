@@ -0,0 +1,521 @@
+/*
+ * flash_log_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of flash_log on a partition image file (flash_image.c) which
+ * behaves like NOR flash, a reboot is simulated by closing the file and
+ * mounting it again. The cases are:
+ *  - crash recovery, the power loss is simulated by corrupting or truncating
+ *    the last record in the image
+ *  - wrap-around, the log is written many times over with reboots in between,
+ *    the oldest sector is dropped, the erases are spread evenly over the
+ *    sectors and the newest records survive
+ *  - timestamp seek, on a wrapped log with gaps in time
+ *  - tail seek, the replay of only the newest sectors restores the same
+ *    history as the replay of the complete log
+ * The replay in the RAM history is the same as sensor_history_restore in
+ * main.c. The throughput is measured by flash_log_bench.c.
+ *
+ *  make -C S3_InfluxDB/host_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "flash_log.h"
+#include "flash_image.h"
+#include "ts_store.h"
+
+// Private Macros
+#define TEST_IMAGE                          "build/flash_log_test.bin"
+#define TEST_SECTORS                        (8u)
+#define TEST_AREA_SIZE                      (TEST_SECTORS * FLASH_LOG_SECTOR_SIZE)
+#define TEST_WRAP_SECTORS                   (16u)
+#define TEST_WRAP_SIZE                      (TEST_WRAP_SECTORS * FLASH_LOG_SECTOR_SIZE)
+#define TEST_RECORD_SIZE                    (16u)     // header 12 bytes, payload 2, aligned
+#define TEST_PER_SECTOR                     ((FLASH_LOG_SECTOR_SIZE - 16u) / TEST_RECORD_SIZE)
+#define TEST_T0                             (1790000000u)
+#define TEST_PERIOD                         (60u)
+#define TEST_GAP_EVERY                      (100u)
+#define TEST_GAP                            (3600u)
+#define TEST_FLUSH_SAMPLES                  (5u)      // CONFIG_SENSOR_LOG_FLUSH_SAMPLES
+#define TEST_HISTORY_BLOCKS                 (64u)
+#define TEST_TAIL_BLOCKS                    (4u)
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond );   \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+typedef struct _test_record_t
+{
+  uint8_t temperature;
+  uint8_t humidity;
+} test_record_t;
+
+// Private Variables
+static flash_image_t test_image;
+static flash_log_index_t test_index[FLASH_IMAGE_MAX_SECTORS];
+static ts_block_t test_blocks[TEST_HISTORY_BLOCKS];
+static ts_block_t test_full_blocks[TEST_TAIL_BLOCKS];
+static ts_block_t test_tail_blocks[TEST_TAIL_BLOCKS];
+static uint32_t test_times[TEST_WRAP_SECTORS * TEST_PER_SECTOR];
+static int test_failed = 0;
+
+// Private Function Declaration
+static bool test_mount( flash_log_t *log, uint32_t size, bool blank );
+static uint32_t test_time( uint32_t idx, bool gaps );
+static void test_fill( flash_log_t *log, uint32_t first, uint32_t count, bool gaps );
+static uint32_t test_replay( flash_log_t *log, ts_store_t *history, ts_block_t *blocks, uint16_t num_blocks, \
+                             uint32_t tail, uint32_t *first, uint32_t *last );
+static bool test_compare( const ts_store_t *a, const ts_store_t *b );
+static void test_torn_byte( uint32_t offset, uint8_t set, uint8_t toggle );
+static void test_torn_crc( void );
+static void test_torn_truncated( void );
+static void test_append_after_recovery( void );
+static void test_wrap_around( void );
+static void test_seek_timestamp( void );
+static void test_seek_tail( void );
+
+int main( void )
+{
+  test_torn_crc();
+  test_torn_truncated();
+  test_append_after_recovery();
+  test_wrap_around();
+  test_seek_timestamp();
+  test_seek_tail();
+  flash_image_close( &test_image );
+  printf( "flash_log_test: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief The last record fails the CRC (payload partially programmed), the
+ *        replay must end with the record before it
+ */
+static void test_torn_crc( void )
+{
+  flash_log_t log;
+  ts_store_t history;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  uint32_t offset = 0;
+
+  CHECK( test_mount( &log, TEST_AREA_SIZE, true ) );
+  // more than one sector, the torn record is in the head sector
+  test_fill( &log, 0, 300, false );
+  CHECK( flash_log_flush( &log ) );
+  offset = (uint32_t)log.head * FLASH_LOG_SECTOR_SIZE + log.write_offset - TEST_RECORD_SIZE;
+  // a bit of the humidity byte which should be 0 was not programmed
+  test_torn_byte( offset + 13, 0x80, 0x00 );
+
+  CHECK( test_mount( &log, TEST_AREA_SIZE, false ) );
+  CHECK( test_replay( &log, &history, test_blocks, TEST_HISTORY_BLOCKS, 0, &first, &last ) == 299 );
+  CHECK( last == TEST_T0 + 298 * TEST_PERIOD );
+  CHECK( history.records == 299 );
+  CHECK( test_image.program_errors == 0 );
+}
+
+/**
+ * @brief Power was lost while the last record was written, only its first
+ *        bytes are in flash and the rest is still erased
+ */
+static void test_torn_truncated( void )
+{
+  flash_log_t log;
+  ts_store_t history;
+  uint8_t blank[TEST_RECORD_SIZE];
+  uint32_t first = 0;
+  uint32_t last = 0;
+  uint32_t offset = 0;
+
+  CHECK( test_mount( &log, TEST_AREA_SIZE, true ) );
+  test_fill( &log, 0, 120, false );
+  CHECK( flash_log_flush( &log ) );
+  offset = (uint32_t)log.head * FLASH_LOG_SECTOR_SIZE + log.write_offset - TEST_RECORD_SIZE;
+  memset( blank, 0xFF, sizeof(blank) );
+  CHECK( flash_image_poke( &test_image, offset + 6, blank, TEST_RECORD_SIZE - 6 ) );
+
+  CHECK( test_mount( &log, TEST_AREA_SIZE, false ) );
+  CHECK( test_replay( &log, &history, test_blocks, TEST_HISTORY_BLOCKS, 0, &first, &last ) == 119 );
+  CHECK( last == TEST_T0 + 118 * TEST_PERIOD );
+}
+
+/**
+ * @brief After the recovery new records go to the next sector, the replay
+ *        skips the torn record and continues with them
+ */
+static void test_append_after_recovery( void )
+{
+  flash_log_t log;
+  ts_store_t history;
+  ts_reader_t reader;
+  int32_t values[2];
+  uint32_t first = 0;
+  uint32_t last = 0;
+  uint32_t offset = 0;
+  uint32_t t = 0;
+  uint16_t torn_sector = 0;
+
+  CHECK( test_mount( &log, TEST_AREA_SIZE, true ) );
+  test_fill( &log, 0, 50, false );
+  CHECK( flash_log_flush( &log ) );
+  offset = (uint32_t)log.head * FLASH_LOG_SECTOR_SIZE + log.write_offset - TEST_RECORD_SIZE;
+  test_torn_byte( offset, 0x00, 0x01 );
+  torn_sector = log.head;
+
+  CHECK( test_mount( &log, TEST_AREA_SIZE, false ) );
+  CHECK( log.head == torn_sector );
+  CHECK( log.write_offset == FLASH_LOG_SECTOR_SIZE );
+  test_fill( &log, 50, 10, false );
+  CHECK( flash_log_flush( &log ) );
+  CHECK( log.head != torn_sector );
+
+  CHECK( test_mount( &log, TEST_AREA_SIZE, false ) );
+  CHECK( test_replay( &log, &history, test_blocks, TEST_HISTORY_BLOCKS, 0, &first, &last ) == 59 );
+  CHECK( last == TEST_T0 + 59 * TEST_PERIOD );
+
+  // values survive the round trip through flash and the compressed history
+  ts_store_seek( &history, TEST_T0 + 50 * TEST_PERIOD, &reader );
+  CHECK( ts_reader_next( &reader, &t, values ) );
+  CHECK( t == TEST_T0 + 50 * TEST_PERIOD );
+  CHECK( (values[0] == (20 + 50 % 7)) && (values[1] == (40 + 50 % 11)) );
+}
+
+/**
+ * @brief Write the log ten times over with a reboot every 1000 samples, the
+ *        ring must keep the newest records and wear all the sectors evenly
+ */
+static void test_wrap_around( void )
+{
+  flash_log_t log;
+  flash_log_cursor_t cursor;
+  test_record_t record;
+  uint32_t total = 10u * TEST_WRAP_SECTORS * TEST_PER_SECTOR;
+  uint32_t done = 0;
+  uint32_t chunk = 0;
+  uint32_t seq = 0;
+  uint32_t timestamp = 0;
+  uint32_t expected = 0;
+  uint32_t count = 0;
+  uint32_t min_erase = UINT32_MAX;
+  uint32_t max_erase = 0;
+  uint16_t sector = 0;
+  size_t len = sizeof(record);
+  bool order = true;
+
+  CHECK( test_mount( &log, TEST_WRAP_SIZE, true ) );
+  while( done < total )
+  {
+    chunk = ((total - done) < 1000u) ? (total - done) : 1000u;
+    test_fill( &log, done, chunk, false );
+    done += chunk;
+    CHECK( flash_log_flush( &log ) );
+    seq = log.seq;
+    CHECK( test_mount( &log, TEST_WRAP_SIZE, false ) );
+    // the reboot continues the sequence, it doesn't restart the ring
+    CHECK( log.seq == seq );
+  }
+  CHECK( log.used == TEST_WRAP_SECTORS );
+  CHECK( test_image.program_errors == 0 );
+
+  for( sector = 0; sector < TEST_WRAP_SECTORS; sector++ )
+  {
+    min_erase = (test_image.erase_count[sector] < min_erase) ? test_image.erase_count[sector] : min_erase;
+    max_erase = (test_image.erase_count[sector] > max_erase) ? test_image.erase_count[sector] : max_erase;
+  }
+  CHECK( min_erase >= 9u );
+  CHECK( (max_erase - min_erase) <= 1u );
+
+  // the records left are the newest ones, in order and without holes
+  flash_log_seek( &log, 0, &cursor );
+  while( flash_log_next( &cursor, &timestamp, &record, &len ) )
+  {
+    if( count == 0 )
+    {
+      expected = (timestamp - TEST_T0) / TEST_PERIOD;
+    }
+    order = order && (timestamp == test_time( expected, false )) && \
+            (record.temperature == (uint8_t)(20 + expected % 7)) && \
+            (record.humidity == (uint8_t)(40 + expected % 11));
+    expected++;
+    count++;
+    len = sizeof(record);
+  }
+  CHECK( order );
+  CHECK( expected == total );
+  CHECK( count > (TEST_WRAP_SECTORS - 1u) * TEST_PER_SECTOR );
+  CHECK( count <= TEST_WRAP_SECTORS * TEST_PER_SECTOR );
+}
+
+/**
+ * @brief Seek on a wrapped log whose timestamps have gaps, every probe must
+ *        return the first record which is not older than it
+ */
+static void test_seek_timestamp( void )
+{
+  flash_log_t log;
+  flash_log_cursor_t cursor;
+  test_record_t record;
+  uint32_t timestamp = 0;
+  uint32_t count = 0;
+  uint32_t idx = 0;
+  uint32_t probe = 0;
+  int delta = 0;
+  size_t len = sizeof(record);
+
+  CHECK( test_mount( &log, TEST_WRAP_SIZE, true ) );
+  test_fill( &log, 0, 3u * TEST_WRAP_SECTORS * TEST_PER_SECTOR / 2u, true );
+  CHECK( flash_log_flush( &log ) );
+  CHECK( test_mount( &log, TEST_WRAP_SIZE, false ) );
+
+  flash_log_seek( &log, 0, &cursor );
+  while( (count < (sizeof(test_times) / sizeof(test_times[0]))) && \
+         flash_log_next( &cursor, &test_times[count], &record, &len ) )
+  {
+    count++;
+    len = sizeof(record);
+  }
+  CHECK( count > (TEST_WRAP_SECTORS - 2u) * TEST_PER_SECTOR );
+
+  // before the oldest record
+  flash_log_seek( &log, TEST_T0, &cursor );
+  CHECK( flash_log_next( &cursor, &timestamp, &record, &len ) && (timestamp == test_times[0]) );
+  // after the newest record
+  len = sizeof(record);
+  flash_log_seek( &log, test_times[count - 1] + 1u, &cursor );
+  CHECK( flash_log_next( &cursor, &timestamp, &record, &len ) == false );
+
+  // on, just before and just after records, also at sector borders and gaps
+  for( idx = 1; idx < count; idx += 7 )
+  {
+    for( delta = -1; delta <= 1; delta++ )
+    {
+      probe = test_times[idx] + (uint32_t)delta;
+      len = sizeof(record);
+      flash_log_seek( &log, probe, &cursor );
+      if( !flash_log_next( &cursor, &timestamp, &record, &len ) )
+      {
+        timestamp = 0;
+      }
+      CHECK( timestamp == test_times[(delta > 0) ? (idx + 1) : idx] || \
+             ((delta > 0) && (idx + 1 == count)) );
+    }
+  }
+}
+
+/**
+ * @brief Replay only the newest sectors which can fill a small history, the
+ *        result must be the same newest records as with the replay of the full
+ *        log, only the number of records in the oldest block can differ
+ */
+static void test_seek_tail( void )
+{
+  flash_log_t log;
+  ts_store_t full;
+  ts_store_t tail;
+  ts_reader_t reader;
+  int32_t values[2];
+  uint32_t full_read = 0;
+  uint32_t tail_read = 0;
+  uint32_t full_first = 0;
+  uint32_t tail_first = 0;
+  uint32_t full_last = 0;
+  uint32_t tail_last = 0;
+  uint32_t oldest = 0;
+  uint64_t full_bytes = 0;
+
+  CHECK( test_mount( &log, TEST_WRAP_SIZE, true ) );
+  test_fill( &log, 0, 2u * TEST_WRAP_SECTORS * TEST_PER_SECTOR, false );
+  CHECK( flash_log_flush( &log ) );
+  CHECK( test_mount( &log, TEST_WRAP_SIZE, false ) );
+
+  flash_image_reset_stats( &test_image );
+  full_read = test_replay( &log, &full, test_full_blocks, TEST_TAIL_BLOCKS, 0, &full_first, &full_last );
+  full_bytes = test_image.bytes_read;
+  ts_store_seek( &full, 0, &reader );
+  CHECK( ts_reader_next( &reader, &oldest, values ) );
+
+  flash_image_reset_stats( &test_image );
+  tail_read = test_replay( &log, &tail, test_tail_blocks, TEST_TAIL_BLOCKS, 1, &tail_first, &tail_last );
+  // the tail holds at least what fits in the history, and less than the log
+  CHECK( tail_read >= ts_store_capacity( &tail ) );
+  CHECK( tail_read < full_read );
+  CHECK( test_image.bytes_read < full_bytes );
+  CHECK( tail_first <= oldest );
+  CHECK( tail_last == full_last );
+  // both are full, the block borders differ, hence compare where both have data
+  CHECK( (tail.used == TEST_TAIL_BLOCKS) && (full.used == TEST_TAIL_BLOCKS) );
+  CHECK( test_compare( &full, &tail ) );
+}
+
+/**
+ * @brief Mount the log on the image file, the file is closed and opened again
+ *        first, that is the reboot
+ * @param log log object
+ * @param size size of the log area
+ * @param blank true to start with an erased image
+ * @return true if successful else false
+ */
+static bool test_mount( flash_log_t *log, uint32_t size, bool blank )
+{
+  uint32_t erase_count[FLASH_IMAGE_MAX_SECTORS];
+
+  memcpy( erase_count, test_image.erase_count, sizeof(erase_count) );
+  flash_image_close( &test_image );
+  if( !flash_image_open( &test_image, TEST_IMAGE, size, blank ) )
+  {
+    return false;
+  }
+  if( !blank )
+  {
+    memcpy( test_image.erase_count, erase_count, sizeof(erase_count) );
+  }
+  return flash_log_mount( log, &flash_image_ops, &test_image, test_index, size );
+}
+
+/**
+ * @brief Timestamp of a record, one minute period with optional gaps of an
+ *        hour which make the sectors cover different time spans
+ * @param idx record number
+ * @param gaps true to add the gaps
+ * @return timestamp
+ */
+static uint32_t test_time( uint32_t idx, bool gaps )
+{
+  return TEST_T0 + idx * TEST_PERIOD + (gaps ? (idx / TEST_GAP_EVERY) * TEST_GAP : 0u);
+}
+
+/**
+ * @brief Append records, flushed every few samples like the sensor task
+ * @param log log object
+ * @param first number of the first record
+ * @param count number of records
+ * @param gaps true to add gaps in time
+ */
+static void test_fill( flash_log_t *log, uint32_t first, uint32_t count, bool gaps )
+{
+  test_record_t record;
+  uint32_t idx = 0;
+
+  for( idx = first; idx < (first + count); idx++ )
+  {
+    record.temperature = (uint8_t)(20 + idx % 7);
+    record.humidity = (uint8_t)(40 + idx % 11);
+    CHECK( flash_log_append( log, test_time( idx, gaps ), &record, sizeof(record) ) );
+    if( (idx % TEST_FLUSH_SAMPLES) == (TEST_FLUSH_SAMPLES - 1u) )
+    {
+      CHECK( flash_log_flush( log ) );
+    }
+  }
+}
+
+/**
+ * @brief Replay the log in a new history, like sensor_history_restore
+ * @param log mounted log
+ * @param history history to initialize and fill
+ * @param blocks block storage of history
+ * @param num_blocks number of blocks
+ * @param tail 0 to replay the complete log, else only the newest sectors
+ *        which can fill the history
+ * @param first timestamp of first replayed record
+ * @param last timestamp of last replayed record
+ * @return number of records read from the log
+ */
+static uint32_t test_replay( flash_log_t *log, ts_store_t *history, ts_block_t *blocks, uint16_t num_blocks, \
+                             uint32_t tail, uint32_t *first, uint32_t *last )
+{
+  flash_log_cursor_t cursor;
+  test_record_t record;
+  int32_t values[2];
+  uint32_t timestamp = 0;
+  uint32_t count = 0;
+  size_t len = sizeof(record);
+
+  ts_store_init( history, blocks, num_blocks, 2 );
+  if( tail )
+  {
+    flash_log_seek_tail( log, ts_store_capacity( history ), sizeof(record), &cursor );
+  }
+  else
+  {
+    flash_log_seek( log, 0, &cursor );
+  }
+  while( flash_log_next( &cursor, &timestamp, &record, &len ) )
+  {
+    if( len == sizeof(record) )
+    {
+      values[0] = record.temperature;
+      values[1] = record.humidity;
+      if( ts_store_append( history, timestamp, values ) )
+      {
+        *first = (count == 0) ? timestamp : *first;
+        *last = timestamp;
+        count++;
+      }
+    }
+    len = sizeof(record);
+  }
+  return count;
+}
+
+/**
+ * @brief Compare two histories from the newer of their oldest records
+ * @param a history
+ * @param b history
+ * @return true if the records are the same else false
+ */
+static bool test_compare( const ts_store_t *a, const ts_store_t *b )
+{
+  ts_reader_t reader_a;
+  ts_reader_t reader_b;
+  int32_t values_a[2];
+  int32_t values_b[2];
+  uint32_t t_a = 0;
+  uint32_t t_b = 0;
+  uint32_t start = 0;
+  uint32_t count = 0;
+  bool more_a = false;
+  bool more_b = false;
+
+  start = (a->blocks[a->head].t_start > b->blocks[b->head].t_start) ? \
+          a->blocks[a->head].t_start : b->blocks[b->head].t_start;
+  ts_store_seek( a, start, &reader_a );
+  ts_store_seek( b, start, &reader_b );
+  do
+  {
+    more_a = ts_reader_next( &reader_a, &t_a, values_a );
+    more_b = ts_reader_next( &reader_b, &t_b, values_b );
+    if( (more_a != more_b) || \
+        (more_a && ((t_a != t_b) || (values_a[0] != values_b[0]) || (values_a[1] != values_b[1]))) )
+    {
+      return false;
+    }
+    count++;
+  } while( more_a );
+  return ( count > 1u );
+}
+
+/**
+ * @brief Change a byte of the image behind the back of the log
+ * @param offset offset in image
+ * @param set bits to set (not programmed)
+ * @param toggle bits to toggle
+ */
+static void test_torn_byte( uint32_t offset, uint8_t set, uint8_t toggle )
+{
+  uint8_t value = 0;
+
+  CHECK( flash_image_peek( &test_image, offset, &value, 1 ) );
+  value = (uint8_t)((value | set) ^ toggle);
+  CHECK( flash_image_poke( &test_image, offset, &value, 1 ) );
+}
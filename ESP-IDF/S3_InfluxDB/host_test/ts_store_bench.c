@@ -0,0 +1,220 @@
+/*
+ * ts_store_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host benchmark of the compressed time series store. Every data set is
+ * encoded in a store big enough to keep all of it, decoded again and compared
+ * with the input (round trip), then the compression ratio against raw records
+ * (uint32_t timestamp + int32_t per channel) and the encode, decode and seek
+ * times are reported. The data sets are:
+ *  dht11   one minute period, temperature and humidity change every few
+ *          samples by one, what the sensor task stores
+ *  jitter  one second period, one in ten timestamps is late by a second
+ *  noisy   one second period, both values change on every sample by up to 40
+ *  random  random timestamps steps and 32 bit values, the worst case
+ *
+ *  make -C S3_InfluxDB/host_test bench
+ *  build/ts_store_bench [records]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ts_store.h"
+
+// Private Macros
+#define BENCH_CHANNELS                      (2u)
+#define BENCH_MAX_BLOCKS                    (65535u)
+#define BENCH_SEEKS                         (100000u)
+#define BENCH_T0                            (1790000000u)
+
+typedef enum _bench_set_e
+{
+  BENCH_SET_DHT11 = 0,
+  BENCH_SET_JITTER,
+  BENCH_SET_NOISY,
+  BENCH_SET_RANDOM,
+  BENCH_SET_MAX,
+} bench_set_e;
+
+// Private Variables
+static const char * const bench_set_names[BENCH_SET_MAX] = { "dht11", "jitter", "noisy", "random" };
+static uint32_t bench_rand_state = 1u;
+
+// Private Function Declaration
+static double bench_time_s( void );
+static uint32_t bench_rand( void );
+static void bench_generate( bench_set_e set, uint32_t *times, int32_t *values, uint32_t count );
+static bool bench_run( bench_set_e set, ts_block_t *blocks, uint32_t *times, int32_t *values, uint32_t count );
+
+int main( int argc, char **argv )
+{
+  uint32_t count = (argc > 1) ? (uint32_t)strtoul( argv[1], NULL, 0 ) : 1000000u;
+  ts_block_t *blocks = malloc( BENCH_MAX_BLOCKS * sizeof(ts_block_t) );
+  uint32_t *times = malloc( (size_t)count * sizeof(uint32_t) );
+  int32_t *values = malloc( (size_t)count * BENCH_CHANNELS * sizeof(int32_t) );
+  bench_set_e set = BENCH_SET_DHT11;
+  bool status = true;
+
+  if( (count == 0) || (blocks == NULL) || (times == NULL) || (values == NULL) )
+  {
+    printf( "out of memory\n" );
+    return EXIT_FAILURE;
+  }
+  printf( "%u records, %u channels, raw record %u bytes, block %u bytes\n", (unsigned)count, \
+          (unsigned)BENCH_CHANNELS, (unsigned)(4u + 4u * BENCH_CHANNELS), (unsigned)sizeof(ts_block_t) );
+  for( set = BENCH_SET_DHT11; set < BENCH_SET_MAX; set++ )
+  {
+    bench_generate( set, times, values, count );
+    status = bench_run( set, blocks, times, values, count ) && status;
+  }
+  free( blocks );
+  free( times );
+  free( values );
+  return status ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Private Function Definition
+
+static double bench_time_s( void )
+{
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief xorshift32, the same data on every run
+ * @return random number
+ */
+static uint32_t bench_rand( void )
+{
+  bench_rand_state ^= bench_rand_state << 13;
+  bench_rand_state ^= bench_rand_state >> 17;
+  bench_rand_state ^= bench_rand_state << 5;
+  return bench_rand_state;
+}
+
+/**
+ * @brief Generate a data set
+ * @param set data set
+ * @param times timestamps output
+ * @param values values output, BENCH_CHANNELS per record
+ * @param count number of records
+ */
+static void bench_generate( bench_set_e set, uint32_t *times, int32_t *values, uint32_t count )
+{
+  uint32_t t = BENCH_T0;
+  int32_t temperature = 25;
+  int32_t humidity = 50;
+  uint32_t idx = 0;
+
+  bench_rand_state = 0x2545F491u;
+  for( idx = 0; idx < count; idx++ )
+  {
+    switch( set )
+    {
+      case BENCH_SET_DHT11:
+        t += 60u;
+        temperature += ((bench_rand() % 8u) == 0) ? ((bench_rand() & 1u) ? 1 : -1) : 0;
+        humidity += ((bench_rand() % 5u) == 0) ? ((bench_rand() & 1u) ? 1 : -1) : 0;
+        break;
+      case BENCH_SET_JITTER:
+        t += ((bench_rand() % 10u) == 0) ? 2u : 1u;
+        temperature += ((bench_rand() % 30u) == 0) ? ((bench_rand() & 1u) ? 1 : -1) : 0;
+        humidity += ((bench_rand() % 20u) == 0) ? ((bench_rand() & 1u) ? 1 : -1) : 0;
+        break;
+      case BENCH_SET_NOISY:
+        t += 1u;
+        temperature = 2500 + (int32_t)(bench_rand() % 81u) - 40;
+        humidity = 5000 + (int32_t)(bench_rand() % 81u) - 40;
+        break;
+      default:
+        t += 1u + bench_rand() % 2000u;
+        temperature = (int32_t)bench_rand();
+        humidity = (int32_t)bench_rand();
+        break;
+    }
+    times[idx] = t;
+    values[idx * BENCH_CHANNELS + 0] = temperature;
+    values[idx * BENCH_CHANNELS + 1] = humidity;
+  }
+}
+
+/**
+ * @brief Encode, decode and seek one data set and print the figures
+ * @param set data set
+ * @param blocks block storage, BENCH_MAX_BLOCKS
+ * @param times timestamps
+ * @param values values
+ * @param count number of records
+ * @return true if the round trip is exact else false
+ */
+static bool bench_run( bench_set_e set, ts_block_t *blocks, uint32_t *times, int32_t *values, uint32_t count )
+{
+  ts_store_t store;
+  ts_reader_t reader;
+  int32_t out[BENCH_CHANNELS];
+  uint32_t t = 0;
+  uint32_t idx = 0;
+  uint32_t pos = 0;
+  uint32_t decoded = 0;
+  uint32_t errors = 0;
+  double raw = (double)count * (4.0 + 4.0 * BENCH_CHANNELS);
+  double encode_s = 0.0;
+  double decode_s = 0.0;
+  double seek_s = 0.0;
+  double start = 0.0;
+
+  ts_store_init( &store, blocks, BENCH_MAX_BLOCKS, BENCH_CHANNELS );
+  start = bench_time_s();
+  for( idx = 0; idx < count; idx++ )
+  {
+    if( !ts_store_append( &store, times[idx], &values[idx * BENCH_CHANNELS] ) )
+    {
+      errors++;
+    }
+  }
+  encode_s = bench_time_s() - start;
+
+  start = bench_time_s();
+  ts_store_seek( &store, 0, &reader );
+  while( ts_reader_next( &reader, &t, out ) )
+  {
+    if( (decoded >= count) || (t != times[decoded]) || \
+        (memcmp( out, &values[decoded * BENCH_CHANNELS], sizeof(out) ) != 0) )
+    {
+      errors++;
+    }
+    decoded++;
+  }
+  decode_s = bench_time_s() - start;
+
+  // seek to a random record and read it
+  start = bench_time_s();
+  for( idx = 0; idx < BENCH_SEEKS; idx++ )
+  {
+    pos = bench_rand() % count;
+    ts_store_seek( &store, times[pos], &reader );
+    if( !ts_reader_next( &reader, &t, out ) || (t != times[pos]) )
+    {
+      errors++;
+    }
+  }
+  seek_s = bench_time_s() - start;
+
+  if( (errors != 0) || (decoded != count) || (store.dropped != 0) )
+  {
+    printf( "%-6s round trip FAILED, %u errors, %u of %u decoded, %u dropped\n", bench_set_names[set], \
+            (unsigned)errors, (unsigned)decoded, (unsigned)count, (unsigned)store.dropped );
+    return false;
+  }
+  printf( "%-6s %6.2f bits/record, ratio %5.1fx data %5.1fx RAM, encode %5.1f ns, decode %5.1f ns (%.0f Mrecords/s), seek %.2f us\n", \
+          bench_set_names[set], 8.0 * (double)ts_store_bytes_used( &store ) / count, \
+          raw / (double)ts_store_bytes_used( &store ), raw / ((double)store.used * sizeof(ts_block_t)), \
+          encode_s * 1e9 / count, decode_s * 1e9 / count, count / decode_s / 1e6, seek_s * 1e6 / BENCH_SEEKS );
+  return true;
+}
@@ -0,0 +1,548 @@
+/*
+ * flash_log.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Append only log on a raw flash area (partition). The area is divided in
+ * sectors which are used as a ring, every sector starts with a header with a
+ * sequence number, followed by CRC protected records. Records are collected in
+ * a RAM buffer and written in batches, the oldest sector is erased when the log
+ * wraps around, which spreads the wear over all the sectors.
+ * At mount only the sector headers are read to build a sparse index (first
+ * timestamp of every sector), and only the last sector is scanned to find the
+ * write position. A record which was partially written when power was lost
+ * fails the CRC check and the writing continues from the next sector.
+ * All the storage access is through flash_log_ops_t, so the same code runs on
+ * a partition image file on the host.
+ */
+#include <string.h>
+#include <stddef.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+#endif
+
+#include "flash_log.h"
+
+// Private Macros
+#define FLASH_LOG_MAGIC                   (0x474F4C46u)   // "FLOG"
+#define FLASH_LOG_ALIGN(x)                (((x) + 3u) & ~3u)
+#define FLASH_LOG_LEN_BLANK               (0xFFFFu)
+
+typedef struct _flash_log_sector_hdr_t
+{
+  uint32_t magic;
+  uint32_t seq;
+  uint32_t crc;                             // crc of magic and seq
+  uint32_t reserved;
+} flash_log_sector_hdr_t;
+
+typedef struct _flash_log_rec_hdr_t
+{
+  uint32_t timestamp;
+  uint16_t length;                          // payload length
+  uint16_t reserved;
+  uint32_t crc;                             // crc of timestamp, length and payload
+} flash_log_rec_hdr_t;
+
+#define FLASH_LOG_SECTOR_HDR_SIZE         (sizeof(flash_log_sector_hdr_t))
+#define FLASH_LOG_REC_HDR_SIZE            (sizeof(flash_log_rec_hdr_t))
+
+// Private Variables
+static const uint32_t crc32_nibble_table[16] =
+{
+  0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+  0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+// Private Function Declaration
+static uint32_t flash_log_crc32( uint32_t crc, const void *data, size_t len );
+static uint32_t flash_log_rec_crc( const flash_log_rec_hdr_t *hdr, const void *data );
+static uint16_t flash_log_sector( const flash_log_t *log, uint16_t logical );
+static bool flash_log_open_sector( flash_log_t *log, uint16_t sector );
+static bool flash_log_read_record( const flash_log_t *log, uint16_t sector, uint32_t offset, \
+                                   flash_log_rec_hdr_t *hdr, uint8_t *payload );
+
+// Public Function Definition
+
+/**
+ * @brief Mount the log, this builds the sparse index from sector headers and
+ *        finds the write position by scanning only the last written sector
+ * @param log log object
+ * @param ops storage access functions
+ * @param ctx context passed to storage access functions
+ * @param index sparse index storage, size / FLASH_LOG_SECTOR_SIZE entries
+ * @param size size of log area in bytes
+ * @return true if mount is successful else false
+ */
+bool flash_log_mount( flash_log_t *log, const flash_log_ops_t *ops, void *ctx, \
+                      flash_log_index_t *index, uint32_t size )
+{
+  flash_log_sector_hdr_t sector_hdr;
+  flash_log_rec_hdr_t rec_hdr;
+  uint8_t payload[FLASH_LOG_MAX_RECORD];
+  uint32_t offset = 0;
+  uint16_t sector = 0;
+  uint16_t prev = 0;
+  bool found = false;
+
+  memset( log, 0x00, sizeof(flash_log_t) );
+  log->ops = ops;
+  log->ctx = ctx;
+  log->index = index;
+  log->num_sectors = (uint16_t)(size / FLASH_LOG_SECTOR_SIZE);
+  if( log->num_sectors < 2 )
+  {
+    return false;
+  }
+
+  // read all the sector headers and first record timestamp
+  for( sector = 0; sector < log->num_sectors; sector++ )
+  {
+    index[sector].seq = 0;
+    index[sector].t_first = FLASH_LOG_TIME_NONE;
+    offset = (uint32_t)sector * FLASH_LOG_SECTOR_SIZE;
+    if( !ops->read( ctx, offset, &sector_hdr, sizeof(sector_hdr) ) )
+    {
+      return false;
+    }
+    if( (sector_hdr.magic != FLASH_LOG_MAGIC) || \
+        (sector_hdr.crc != flash_log_crc32( 0, &sector_hdr, 2*sizeof(uint32_t) )) )
+    {
+      continue;
+    }
+    index[sector].seq = sector_hdr.seq;
+    if( ops->read( ctx, offset + FLASH_LOG_SECTOR_HDR_SIZE, &rec_hdr, sizeof(rec_hdr) ) && \
+        (rec_hdr.length != FLASH_LOG_LEN_BLANK) )
+    {
+      index[sector].t_first = rec_hdr.timestamp;
+    }
+    // latest sector is the one with highest sequence number
+    if( (found == false) || (sector_hdr.seq > log->seq) )
+    {
+      log->seq = sector_hdr.seq;
+      log->head = sector;
+      found = true;
+    }
+  }
+
+  if( found == false )
+  {
+    // blank or foreign data, start from first sector
+    log->used = 0;
+    log->head = log->num_sectors - 1;
+    return flash_log_open_sector( log, 0 );
+  }
+
+  // the sectors before head with continuous sequence numbers are in the log
+  log->used = 1;
+  prev = log->head;
+  while( log->used < log->num_sectors )
+  {
+    prev = (prev + log->num_sectors - 1) % log->num_sectors;
+    if( (index[prev].seq == 0) || (index[prev].seq != (log->seq - log->used)) )
+    {
+      break;
+    }
+    log->used++;
+  }
+
+  // scan only the head sector to find the end of valid records
+  offset = FLASH_LOG_SECTOR_HDR_SIZE;
+  while( (offset + FLASH_LOG_REC_HDR_SIZE) <= FLASH_LOG_SECTOR_SIZE )
+  {
+    if( !ops->read( ctx, (uint32_t)log->head * FLASH_LOG_SECTOR_SIZE + offset, &rec_hdr, sizeof(rec_hdr) ) )
+    {
+      return false;
+    }
+    if( (rec_hdr.length == FLASH_LOG_LEN_BLANK) && (rec_hdr.timestamp == FLASH_LOG_TIME_NONE) )
+    {
+      break;
+    }
+    if( !flash_log_read_record( log, log->head, offset, &rec_hdr, payload ) )
+    {
+      // torn write, don't append after it, continue with next sector
+      offset = FLASH_LOG_SECTOR_SIZE;
+      break;
+    }
+    offset += FLASH_LOG_ALIGN( FLASH_LOG_REC_HDR_SIZE + rec_hdr.length );
+  }
+  log->write_offset = offset;
+  return true;
+}
+
+/**
+ * @brief Append a record to the log, the record is buffered in RAM and written
+ *        to flash when the buffer is full or flash_log_flush is called
+ * @param log log object
+ * @param timestamp record timestamp, should not be older than previous record
+ * @param data record payload
+ * @param len payload length, maximum FLASH_LOG_MAX_RECORD bytes
+ * @return true if successful else false
+ */
+bool flash_log_append( flash_log_t *log, uint32_t timestamp, const void *data, size_t len )
+{
+  flash_log_rec_hdr_t hdr;
+  uint32_t rec_size = FLASH_LOG_ALIGN( FLASH_LOG_REC_HDR_SIZE + len );
+
+  if( (len > FLASH_LOG_MAX_RECORD) || (timestamp == FLASH_LOG_TIME_NONE) )
+  {
+    return false;
+  }
+
+  if( (log->write_offset + log->buf_len + rec_size) > FLASH_LOG_SECTOR_SIZE )
+  {
+    // record doesn't fit in this sector
+    if( !flash_log_flush( log ) || \
+        !flash_log_open_sector( log, (log->head + 1) % log->num_sectors ) )
+    {
+      return false;
+    }
+  }
+  if( (log->buf_len + rec_size) > FLASH_LOG_WRITE_BUF_SIZE )
+  {
+    if( !flash_log_flush( log ) )
+    {
+      return false;
+    }
+  }
+
+  hdr.timestamp = timestamp;
+  hdr.length = (uint16_t)len;
+  hdr.reserved = 0;
+  hdr.crc = flash_log_rec_crc( &hdr, data );
+  memset( &log->buffer[log->buf_len], 0xFF, rec_size );
+  memcpy( &log->buffer[log->buf_len], &hdr, sizeof(hdr) );
+  memcpy( &log->buffer[log->buf_len + FLASH_LOG_REC_HDR_SIZE], data, len );
+  log->buf_len += (uint16_t)rec_size;
+
+  if( log->index[log->head].t_first == FLASH_LOG_TIME_NONE )
+  {
+    log->index[log->head].t_first = timestamp;
+  }
+  log->stats.records++;
+  return true;
+}
+
+/**
+ * @brief Write the buffered records to flash
+ * @param log log object
+ * @return true if successful else false
+ */
+bool flash_log_flush( flash_log_t *log )
+{
+  uint32_t offset = 0;
+
+  if( log->buf_len == 0 )
+  {
+    return true;
+  }
+  offset = (uint32_t)log->head * FLASH_LOG_SECTOR_SIZE + log->write_offset;
+  if( !log->ops->write( log->ctx, offset, log->buffer, log->buf_len ) )
+  {
+    return false;
+  }
+  log->write_offset += log->buf_len;
+  log->stats.bytes_written += log->buf_len;
+  log->stats.flushes++;
+  log->buf_len = 0;
+  return true;
+}
+
+/**
+ * @brief Erase the complete log
+ * @param log log object
+ * @return true if successful else false
+ */
+bool flash_log_erase_all( flash_log_t *log )
+{
+  uint16_t sector = 0;
+
+  if( !log->ops->erase( log->ctx, 0, (size_t)log->num_sectors * FLASH_LOG_SECTOR_SIZE ) )
+  {
+    return false;
+  }
+  for( sector = 0; sector < log->num_sectors; sector++ )
+  {
+    log->index[sector].seq = 0;
+    log->index[sector].t_first = FLASH_LOG_TIME_NONE;
+  }
+  log->buf_len = 0;
+  log->used = 0;
+  log->head = log->num_sectors - 1;
+  return flash_log_open_sector( log, 0 );
+}
+
+/**
+ * @brief Position the cursor at the first record not older than timestamp, the
+ *        sector is found with binary search on the sparse index
+ * @param log log object
+ * @param timestamp records older than this are skipped, use 0 to read all
+ * @param cursor cursor to initialize
+ * @note  records still in the write buffer are not visible to the cursor
+ */
+void flash_log_seek( const flash_log_t *log, uint32_t timestamp, flash_log_cursor_t *cursor )
+{
+  uint16_t low = 0;
+  uint16_t high = log->used;
+  uint16_t mid = 0;
+  uint32_t t = 0;
+  uint8_t payload[FLASH_LOG_MAX_RECORD];
+  size_t len = 0;
+  flash_log_cursor_t probe;
+
+  // first sector which starts after the timestamp, the previous one is needed
+  while( low < high )
+  {
+    mid = low + (high - low) / 2;
+    if( log->index[flash_log_sector( log, mid )].t_first <= timestamp )
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  cursor->log = log;
+  cursor->sector = (low > 0) ? (low - 1) : 0;
+  cursor->offset = FLASH_LOG_SECTOR_HDR_SIZE;
+
+  // skip the older records
+  probe = *cursor;
+  len = sizeof(payload);
+  while( flash_log_next( &probe, &t, payload, &len ) && (t < timestamp) )
+  {
+    *cursor = probe;
+    len = sizeof(payload);
+  }
+}
+
+/**
+ * @brief Position the cursor at the start of the newest sectors which hold at
+ *        least the given number of records, this is used to replay only the
+ *        part of the log that fits in a smaller RAM copy
+ * @param log log object
+ * @param records number of records needed
+ * @param len payload length of the records, the log doesn't store the count
+ *        per sector, it is calculated from the record size
+ * @param cursor cursor to initialize
+ */
+void flash_log_seek_tail( const flash_log_t *log, uint32_t records, size_t len, flash_log_cursor_t *cursor )
+{
+  uint32_t per_sector = (FLASH_LOG_SECTOR_SIZE - FLASH_LOG_SECTOR_HDR_SIZE) / \
+                        FLASH_LOG_ALIGN( FLASH_LOG_REC_HDR_SIZE + len );
+  uint32_t sectors = 0;
+
+  // one more for the head sector, which is only partially written
+  sectors = (records + per_sector - 1) / per_sector + 1;
+  cursor->log = log;
+  cursor->sector = (sectors < log->used) ? (uint16_t)(log->used - sectors) : 0;
+  cursor->offset = FLASH_LOG_SECTOR_HDR_SIZE;
+}
+
+/**
+ * @brief Read the next record
+ * @param cursor cursor initialized with flash_log_seek
+ * @param timestamp record timestamp
+ * @param data buffer for payload
+ * @param len in: size of data buffer, out: payload length, if the payload is
+ *        bigger than data buffer it is truncated
+ * @return true if a record is read else false (no more records)
+ */
+bool flash_log_next( flash_log_cursor_t *cursor, uint32_t *timestamp, void *data, size_t *len )
+{
+  const flash_log_t *log = cursor->log;
+  flash_log_rec_hdr_t hdr;
+  uint8_t payload[FLASH_LOG_MAX_RECORD];
+  uint16_t sector = 0;
+  uint32_t limit = 0;
+  bool status = false;
+
+  while( (status == false) && (cursor->sector < log->used) )
+  {
+    sector = flash_log_sector( log, cursor->sector );
+    limit = (sector == log->head) ? log->write_offset : FLASH_LOG_SECTOR_SIZE;
+    if( ((cursor->offset + FLASH_LOG_REC_HDR_SIZE) <= limit) && \
+        flash_log_read_record( log, sector, cursor->offset, &hdr, payload ) && \
+        ((cursor->offset + FLASH_LOG_REC_HDR_SIZE + hdr.length) <= limit) )
+    {
+      cursor->offset += FLASH_LOG_ALIGN( FLASH_LOG_REC_HDR_SIZE + hdr.length );
+      *timestamp = hdr.timestamp;
+      *len = (hdr.length < *len) ? hdr.length : *len;
+      memcpy( data, payload, *len );
+      status = true;
+    }
+    else
+    {
+      // end of sector or invalid record, nothing after it can be trusted
+      cursor->sector++;
+      cursor->offset = FLASH_LOG_SECTOR_HDR_SIZE;
+    }
+  }
+  return status;
+}
+
+#ifdef ESP_PLATFORM
+static bool flash_log_partition_read( void *ctx, uint32_t offset, void *data, size_t len )
+{
+  return ( ESP_OK == esp_partition_read( (const esp_partition_t *)ctx, offset, data, len ) );
+}
+
+static bool flash_log_partition_write( void *ctx, uint32_t offset, const void *data, size_t len )
+{
+  return ( ESP_OK == esp_partition_write( (const esp_partition_t *)ctx, offset, data, len ) );
+}
+
+static bool flash_log_partition_erase( void *ctx, uint32_t offset, size_t len )
+{
+  return ( ESP_OK == esp_partition_erase_range( (const esp_partition_t *)ctx, offset, len ) );
+}
+
+static const flash_log_ops_t flash_log_partition_ops =
+{
+  .read = flash_log_partition_read,
+  .write = flash_log_partition_write,
+  .erase = flash_log_partition_erase,
+};
+
+/**
+ * @brief Mount the log on a data partition
+ * @param log log object
+ * @param label partition label from partitions.csv
+ * @param index sparse index storage
+ * @param max_sectors number of entries in index, log is limited to this
+ * @return true if mount is successful else false
+ */
+bool flash_log_mount_partition( flash_log_t *log, const char *label, flash_log_index_t *index, uint16_t max_sectors )
+{
+  uint32_t size = 0;
+  const esp_partition_t *partition = NULL;
+
+  partition = esp_partition_find_first( ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label );
+  if( partition == NULL )
+  {
+    return false;
+  }
+  size = partition->size;
+  if( size > ((uint32_t)max_sectors * FLASH_LOG_SECTOR_SIZE) )
+  {
+    size = (uint32_t)max_sectors * FLASH_LOG_SECTOR_SIZE;
+  }
+  return flash_log_mount( log, &flash_log_partition_ops, (void *)partition, index, size );
+}
+#endif
+
+// Private Function Definition
+
+/**
+ * @brief Calculate CRC32 (IEEE 802.3), nibble table is used to save flash
+ * @param crc initial crc value
+ * @param data data pointer
+ * @param len data length
+ * @return crc value
+ */
+static uint32_t flash_log_crc32( uint32_t crc, const void *data, size_t len )
+{
+  const uint8_t *ptr = (const uint8_t *)data;
+  crc = ~crc;
+  while( len-- )
+  {
+    crc ^= *ptr++;
+    crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+    crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+/**
+ * @brief Calculate CRC of record
+ * @param hdr record header (crc field is not used)
+ * @param data record payload
+ * @return crc value
+ */
+static uint32_t flash_log_rec_crc( const flash_log_rec_hdr_t *hdr, const void *data )
+{
+  uint32_t crc = flash_log_crc32( 0, hdr, offsetof(flash_log_rec_hdr_t, crc) );
+  return flash_log_crc32( crc, data, hdr->length );
+}
+
+/**
+ * @brief Convert the logical sector number (0 is oldest) to physical sector
+ * @param log log object
+ * @param logical logical sector number
+ * @return physical sector number
+ */
+static uint16_t flash_log_sector( const flash_log_t *log, uint16_t logical )
+{
+  uint16_t oldest = (log->head + log->num_sectors + 1 - log->used) % log->num_sectors;
+  return (oldest + logical) % log->num_sectors;
+}
+
+/**
+ * @brief Erase a sector and make it the head sector, if the log is full the
+ *        oldest sector is dropped
+ * @param log log object
+ * @param sector physical sector number, must be next to head sector
+ * @return true if successful else false
+ */
+static bool flash_log_open_sector( flash_log_t *log, uint16_t sector )
+{
+  flash_log_sector_hdr_t hdr;
+  uint32_t offset = (uint32_t)sector * FLASH_LOG_SECTOR_SIZE;
+
+  if( log->used >= log->num_sectors )
+  {
+    log->used--;
+  }
+  if( !log->ops->erase( log->ctx, offset, FLASH_LOG_SECTOR_SIZE ) )
+  {
+    return false;
+  }
+  log->stats.sectors_erased++;
+
+  hdr.magic = FLASH_LOG_MAGIC;
+  hdr.seq = log->seq + 1;
+  hdr.crc = flash_log_crc32( 0, &hdr, 2*sizeof(uint32_t) );
+  hdr.reserved = 0;
+  if( !log->ops->write( log->ctx, offset, &hdr, sizeof(hdr) ) )
+  {
+    return false;
+  }
+  log->seq = hdr.seq;
+  log->index[sector].seq = hdr.seq;
+  log->index[sector].t_first = FLASH_LOG_TIME_NONE;
+  log->head = sector;
+  log->used++;
+  log->write_offset = FLASH_LOG_SECTOR_HDR_SIZE;
+  return true;
+}
+
+/**
+ * @brief Read a record and verify it
+ * @param log log object
+ * @param sector physical sector number
+ * @param offset record offset inside sector
+ * @param hdr record header output
+ * @param payload payload output, FLASH_LOG_MAX_RECORD bytes
+ * @return true if record is valid else false
+ */
+static bool flash_log_read_record( const flash_log_t *log, uint16_t sector, uint32_t offset, \
+                                   flash_log_rec_hdr_t *hdr, uint8_t *payload )
+{
+  uint32_t base = (uint32_t)sector * FLASH_LOG_SECTOR_SIZE + offset;
+
+  if( !log->ops->read( log->ctx, base, hdr, sizeof(flash_log_rec_hdr_t) ) || \
+      (hdr->length > FLASH_LOG_MAX_RECORD) || \
+      ((offset + FLASH_LOG_REC_HDR_SIZE + hdr->length) > FLASH_LOG_SECTOR_SIZE) )
+  {
+    return false;
+  }
+  if( !log->ops->read( log->ctx, base + FLASH_LOG_REC_HDR_SIZE, payload, hdr->length ) )
+  {
+    return false;
+  }
+  return ( hdr->crc == flash_log_rec_crc( hdr, payload ) );
+}
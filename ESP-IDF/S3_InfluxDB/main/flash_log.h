@@ -0,0 +1,79 @@
+/*
+ * flash_log.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+
+#ifndef MAIN_FLASH_LOG_H_
+#define MAIN_FLASH_LOG_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// macros
+#define FLASH_LOG_SECTOR_SIZE                   (4096u)
+#define FLASH_LOG_WRITE_BUF_SIZE                (512u)
+#define FLASH_LOG_MAX_RECORD                    (256u)
+#define FLASH_LOG_TIME_NONE                     (0xFFFFFFFFu)
+
+// storage access functions, offsets are relative to the start of log area
+typedef struct _flash_log_ops_t
+{
+  bool (*read)( void *ctx, uint32_t offset, void *data, size_t len );
+  bool (*write)( void *ctx, uint32_t offset, const void *data, size_t len );
+  bool (*erase)( void *ctx, uint32_t offset, size_t len );
+} flash_log_ops_t;
+
+// sparse index, one entry per sector
+typedef struct _flash_log_index_t
+{
+  uint32_t seq;                             // sector sequence number, 0 if not used
+  uint32_t t_first;                         // timestamp of the first record in sector
+} flash_log_index_t;
+
+typedef struct _flash_log_stats_t
+{
+  uint32_t records;                         // records appended since mount
+  uint32_t bytes_written;                   // bytes written to flash since mount
+  uint32_t flushes;
+  uint32_t sectors_erased;
+} flash_log_stats_t;
+
+typedef struct _flash_log_t
+{
+  const flash_log_ops_t *ops;
+  void              *ctx;
+  flash_log_index_t *index;                 // caller supplied, num_sectors entries
+  uint16_t          num_sectors;
+  uint16_t          head;                   // sector being written
+  uint16_t          used;                   // number of sectors with data
+  uint32_t          seq;                    // sequence number of head sector
+  uint32_t          write_offset;           // flash write position in head sector
+  uint16_t          buf_len;                // pending bytes in write buffer
+  uint8_t           buffer[FLASH_LOG_WRITE_BUF_SIZE];
+  flash_log_stats_t stats;
+} flash_log_t;
+
+typedef struct _flash_log_cursor_t
+{
+  const flash_log_t *log;
+  uint16_t          sector;                 // sector number relative to the oldest
+  uint32_t          offset;                 // offset inside sector
+} flash_log_cursor_t;
+
+// Public Function Prototypes
+bool flash_log_mount( flash_log_t *log, const flash_log_ops_t *ops, void *ctx, \
+                      flash_log_index_t *index, uint32_t size );
+bool flash_log_append( flash_log_t *log, uint32_t timestamp, const void *data, size_t len );
+bool flash_log_flush( flash_log_t *log );
+bool flash_log_erase_all( flash_log_t *log );
+void flash_log_seek( const flash_log_t *log, uint32_t timestamp, flash_log_cursor_t *cursor );
+void flash_log_seek_tail( const flash_log_t *log, uint32_t records, size_t len, flash_log_cursor_t *cursor );
+bool flash_log_next( flash_log_cursor_t *cursor, uint32_t *timestamp, void *data, size_t *len );
+#ifdef ESP_PLATFORM
+bool flash_log_mount_partition( flash_log_t *log, const char *label, flash_log_index_t *index, uint16_t max_sectors );
+#endif
+
+#endif /* MAIN_FLASH_LOG_H_ */
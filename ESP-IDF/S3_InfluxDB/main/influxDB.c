@@ -3,153 +3,180 @@
  *
  *  Created on: Jun 21, 2024
  *      Author: xpress_embedo
+ *
+ * The samples are written to InfluxDB Cloud with the influx_writer component:
+ * batches over one keep-alive connection, gzip, retries with backoff and a
+ * spool for the time before the SNTP synchronization and for WiFi outages,
+ * see influx_writer.h. This file only configures it from Kconfig.
+ * Local samples which never reached the server, because the spool was full
+ * during a long outage or they were lost with a reset, are read back from the
+ * compressed sensor history before the spool is drained.
+ * Optionally the samples are also streamed over UDP (line protocol or StatsD)
+ * with the udp_uplink component, for high rate data without TCP overhead.
  */
 #include "esp_log.h"
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
-#include "freertos/task.h"
-
-#include "esp_http_client.h"
+#include "influx_writer.h"
+#include "udp_uplink.h"
 
 #include "main.h"
 #include "influxDB.h"
 
 // Private Macros
-#define INFLUXDB_EVENT_QUEUE_LEN            (5)
 #define INFLUXDB_URL                        CONFIG_INFLUXDB_URL
 #define INFLUXDB_ORG                        CONFIG_INFLUXDB_ORG
 #define INFLUXDB_BUCKET                     CONFIG_INFLUXDB_BUCKET
 #define INFLUXDB_TOKEN                      CONFIG_INFLUXDB_TOKEN
+#define INFLUXDB_BATCH_POINTS               CONFIG_INFLUXDB_BATCH_POINTS
+#define INFLUXDB_BATCH_BYTES                CONFIG_INFLUXDB_BATCH_BYTES
+#define INFLUXDB_BATCH_AGE_MS               CONFIG_INFLUXDB_BATCH_AGE_MS
+#ifdef CONFIG_INFLUXDB_GZIP
+#define INFLUXDB_GZIP                       (true)
+#else
+#define INFLUXDB_GZIP                       (false)
+#endif
+#define INFLUXDB_SPOOL_RECORDS              CONFIG_INFLUXDB_SPOOL_RECORDS
+#define INFLUXDB_DRAIN_BATCH                CONFIG_INFLUXDB_DRAIN_BATCH
+#define INFLUXDB_DRAIN_INTERVAL_MS          CONFIG_INFLUXDB_DRAIN_INTERVAL_MS
+#if defined(CONFIG_INFLUXDB_SPOOL_DROP_NEWEST)
+#define INFLUXDB_SPOOL_DROP                 SPOOL_DROP_NEWEST
+#elif defined(CONFIG_INFLUXDB_SPOOL_DROP_THIN)
+#define INFLUXDB_SPOOL_DROP                 SPOOL_DROP_THIN
+#else
+#define INFLUXDB_SPOOL_DROP                 SPOOL_DROP_OLDEST
+#endif
+#ifdef CONFIG_INFLUXDB_UDP
+#define INFLUXDB_UDP_HOST                   CONFIG_INFLUXDB_UDP_HOST
+#define INFLUXDB_UDP_PORT                   CONFIG_INFLUXDB_UDP_PORT
+#define INFLUXDB_UDP_FLUSH_MS               CONFIG_INFLUXDB_UDP_FLUSH_MS
+#define INFLUXDB_UDP_QUEUE_DEPTH            (32u)
+#ifdef CONFIG_INFLUXDB_UDP_STATSD
+#define INFLUXDB_UDP_FORMAT                 UDP_UPLINK_STATSD
+#else
+#define INFLUXDB_UDP_FORMAT                 UDP_UPLINK_LINE_PROTOCOL
+#endif
+#ifdef CONFIG_INFLUXDB_UDP_SEQUENCE
+#define INFLUXDB_UDP_SEQUENCE               (true)
+#else
+#define INFLUXDB_UDP_SEQUENCE               (false)
+#endif
+#endif
 
 // Private Variables
 static const char *TAG = "InfluxDB";
-static const char *influxdb_url = INFLUXDB_URL;
-static const char *influxdb_org = INFLUXDB_ORG;
-static const char *influxdb_bucket = INFLUXDB_BUCKET;
-static QueueHandle_t influxdb_event = NULL;
+static char influxdb_mac_addr[MAC_ADDR_SIZE] = { 0 };
+static const char * const influxdb_fields[SENSOR_CH_MAX] =
+{
+  [SENSOR_CH_TEMPERATURE] = "temperature",
+  [SENSOR_CH_HUMIDITY] = "humidity",
+};
 
 // Private Function Declaration
-static void influxdb_task( void *pvParameters );
-static void influxdb_send_temp_humidity( void );
+static void influxdb_history( void *ctx, uint32_t after_s, uint32_t before_s, influx_writer_add_t add );
+#ifdef CONFIG_INFLUXDB_UDP
+static void influxdb_udp_start( void );
+#endif
 
 // Public Function Definition
-void influxdb_start( void )
-{
-  // create message queue with the length THINGSPEAK_EVENT_QUEUE_LEN
-  influxdb_event = xQueueCreate( INFLUXDB_EVENT_QUEUE_LEN, sizeof(influxdb_q_msg_t) );
-  if( influxdb_event == NULL )
-  {
-    ESP_LOGE(TAG, "Unable to Create Queue");
-  }
-  xTaskCreate(&influxdb_task, "InfluxDB Task", 4096*2, NULL, 6, NULL);
-}
 
 /**
- * @brief Send an event to influxdb queue
- * @param event event code
- * @param pData pointer to data if any (not used for future use)
- * @return pdTRUE if successful else pdFALSE
+ * @brief Start the InfluxDB writer (and the UDP uplink if enabled), samples
+ *        are taken from the telemetry bus
+ * @param  none
  */
-BaseType_t influxdb_send_event( influxdb_event_t event, uint8_t *pData )
+void influxdb_start( void )
 {
-  BaseType_t status = pdFALSE;
-  influxdb_q_msg_t msg;
+  influx_writer_config_t config =
+  {
+    .url = INFLUXDB_URL,
+    .org = INFLUXDB_ORG,
+    .bucket = INFLUXDB_BUCKET,
+    .token = INFLUXDB_TOKEN,
+    .measurement = "weather",
+    .device_id = influxdb_mac_addr,
+    .fields = influxdb_fields,
+    .field_count = SENSOR_CH_MAX,
+    .batch_points = INFLUXDB_BATCH_POINTS,
+    .batch_bytes = INFLUXDB_BATCH_BYTES,
+    .batch_age_ms = INFLUXDB_BATCH_AGE_MS,
+    .gzip = INFLUXDB_GZIP,
+    .spool_records = INFLUXDB_SPOOL_RECORDS,
+    .spool_drop = INFLUXDB_SPOOL_DROP,
+    .drain_batch = INFLUXDB_DRAIN_BATCH,
+    .drain_interval_ms = INFLUXDB_DRAIN_INTERVAL_MS,
+    .link_up = get_wifi_status,
+    .time_synced = get_time_status,
+    .time_ns = get_time_ns,
+    .history = influxdb_history,
+    .history_ctx = NULL,
+  };
 
-  if( event < INFLUXDB_EV_MAX )
+  get_mac_address( influxdb_mac_addr );
+  if( influx_writer_start( &config ) != ESP_OK )
   {
-    msg.event_id  = event;
-    msg.data      = pData;
-    status = xQueueSend( influxdb_event, &msg, portMAX_DELAY );
+    ESP_LOGE(TAG, "Unable to start InfluxDB writer");
   }
-  return status;
+#ifdef CONFIG_INFLUXDB_UDP
+  influxdb_udp_start();
+#endif
 }
 
 // Private Function Definition
 
 /**
- * @brief InfluxDB Task
- * The task waits if there is some event posted in queue, and then based on the
- * event it calls the appropriate function
- * @param pvParameters 
+ * @brief Read the local samples back from the compressed sensor history, for
+ *        the points which are not in the spool anymore
+ * @param ctx not used
+ * @param after_s newest local point already written
+ * @param before_s oldest sample in spool
+ * @param add writer function, called for every record
  */
-static void influxdb_task( void *pvParameters )
+static void influxdb_history( void *ctx, uint32_t after_s, uint32_t before_s, influx_writer_add_t add )
 {
-  influxdb_q_msg_t msg;
+  sensor_data_t *sensor = get_temperature_humidity();
+  int32_t values[SENSOR_CH_MAX];
+  ts_reader_t reader;
+  uint32_t t = 0;
 
-  while( 1 )
+  (void)ctx;
+  if( sensor_history_lock() == false )
+  {
+    return;
+  }
+  ts_store_seek( &sensor->history, after_s + 1, &reader );
+  while( ts_reader_next( &reader, &t, values ) && (t < before_s) && add( t, values, SENSOR_CH_MAX ) )
   {
-    // Wait for events posted in Queue
-    if( xQueueReceive(influxdb_event, &msg, portMAX_DELAY) )
-    {
-      // the below is the code to handle the state machine
-      if( INFLUXDB_EV_NONE != msg.event_id )
-      {
-        switch( msg.event_id )
-        {
-          case INFLUXDB_EV_TEMP_HUMID:
-            influxdb_send_temp_humidity();
-            break;
-          default:
-            break;
-        } // switch case end
-      }   // if event received in limit end
-    }     // xQueueReceive end
   }
+  sensor_history_unlock();
 }
 
+#ifdef CONFIG_INFLUXDB_UDP
 /**
- * @brief Send Temperature and Humidity data to InfluxDB Cloud
+ * @brief Start the UDP uplink, it gets the same samples from telemetry bus as
+ *        the HTTP writer
  * @param  none
  */
-static void influxdb_send_temp_humidity( void )
+static void influxdb_udp_start( void )
 {
-  uint8_t temperature = 0;
-  uint8_t humidity = 0;
-  char data[150];
-  char influxdb_full_url[200];
-  char mac_addr[MAC_ADDR_SIZE] = { 0 };
-
-  sensor_data_t *sensor_data = get_temperature_humidity();
-  temperature = sensor_data->temperature_current;
-  humidity = sensor_data->humidity_current;
-  get_mac_address( mac_addr );
-
-  snprintf( data, sizeof(data), \
-            "weather,device_id=%s temperature=%d,humidity=%d %lld", \
-            mac_addr, temperature, humidity, get_time_ns() );
-  // ESP_LOGI( TAG, "Data: %s", data );
-  snprintf( influxdb_full_url, sizeof(influxdb_full_url),   \
-            "%s/api/v2/write?org=%s&bucket=%s&precision=ns",\
-            influxdb_url, influxdb_org, influxdb_bucket );
-
-  esp_http_client_config_t config =
+  udp_uplink_config_t config =
   {
-    .url = influxdb_full_url,
-    .method = HTTP_METHOD_POST,
-    .timeout_ms = 5000,
-    // todo: maybe for future
-    // .transport_type = HTTP_TRANSPORT_OVER_SSL,   // Specify transport type
-    // .crt_bundle_attach = esp_crt_bundle_attach,  // Attach the certificate bundle
+    .host = INFLUXDB_UDP_HOST,
+    .port = INFLUXDB_UDP_PORT,
+    .format = INFLUXDB_UDP_FORMAT,
+    .measurement = "weather",
+    .device_id = influxdb_mac_addr,
+    .fields = influxdb_fields,
+    .field_count = SENSOR_CH_MAX,
+    .decimals = 1,
+    .mtu = UDP_UPLINK_MTU_DEFAULT,
+    .flush_ms = INFLUXDB_UDP_FLUSH_MS,
+    .queue_depth = INFLUXDB_UDP_QUEUE_DEPTH,
+    .sequence = INFLUXDB_UDP_SEQUENCE,
   };
 
-  esp_http_client_handle_t client = esp_http_client_init( &config );
-  // set header
-  esp_http_client_set_header( client, "Authorization", "Token " INFLUXDB_TOKEN );
-  esp_http_client_set_header( client, "Content-Type", "text/plain" );
-  esp_http_client_set_post_field( client, data, strlen(data) );
-
-  esp_err_t err = esp_http_client_perform(client);
-
-  if (err == ESP_OK)
+  if( udp_uplink_start( &config ) != ESP_OK )
   {
-    ESP_LOGI( TAG, "HTTP POST Status = %d", esp_http_client_get_status_code(client) );
-    // ESP_LOGI( TAG, "content_length = %d", esp_http_client_get_content_length(client));
+    ESP_LOGE(TAG, "Unable to start UDP uplink");
   }
-  else
-  {
-    ESP_LOGE(TAG, "HTTP POST request failed: %s", esp_err_to_name(err));
-  }
-
-  esp_http_client_cleanup(client);
 }
+#endif
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include <unistd.h>
 #include "driver/gpio.h"
 #include <time.h>
@@ -8,6 +9,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 
 #include "nvs_flash.h"
 #include "esp_event.h"
@@ -21,10 +23,16 @@
 #include "main.h"
 #include "dht11.h"
 #include "influxDB.h"
+#include "telemetry.h"
+#include "loadgen.h"
 
 // macros
 #define DHT11_PIN                           (GPIO_NUM_17)
 #define MAIN_TASK_PERIOD                    (60000)
+#define SENSOR_HISTORY_BLOCKS               CONFIG_SENSOR_HISTORY_BLOCKS
+#define SENSOR_LOG_PARTITION                "sensorlog"
+#define SENSOR_LOG_MAX_SECTORS              (256u)
+#define SENSOR_LOG_FLUSH_SAMPLES            CONFIG_SENSOR_LOG_FLUSH_SAMPLES
 #define APP_WIFI_SSID                       CONFIG_ESP_WIFI_SSID
 #define APP_WIFI_PSWD                       CONFIG_ESP_WIFI_PASSWORD
 #define WIFI_MAX_RETRY                      (5)
@@ -37,7 +45,13 @@
 // Private Variables
 static const char *TAG = "APP";
 /* Sensor Related Variables */
-static sensor_data_t sensor_data = { .sensor_idx = 0 };
+static sensor_data_t sensor_data;
+static ts_block_t sensor_history_blocks[SENSOR_HISTORY_BLOCKS];
+static SemaphoreHandle_t sensor_history_mutex = NULL;
+static flash_log_t sensor_log;
+static flash_log_index_t sensor_log_index[SENSOR_LOG_MAX_SECTORS];
+static bool sensor_log_status = false;
+static uint16_t sensor_log_pending = 0;
 /* WiFi Connection Related Variables */
 static EventGroupHandle_t wifi_event_group;           // FreeRTOS event group to signal when we are connected
 static uint8_t wifi_connect_retry = 0;
@@ -45,10 +59,12 @@ static bool wifi_connect_status = false;
 static bool sntp_connect_status = false;
 
 // Private Function Declarations
+static void sensor_history_restore( void );
 static void app_connect_wifi( void );
 static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t event_id, void * event_data );
 static void app_sntp_init( void );
 static bool app_sntp_get_time( void );
+static void app_sntp_sync_cb( struct timeval *tv );
 
 void app_main(void)
 {
@@ -69,21 +85,50 @@ void app_main(void)
   }
   ESP_ERROR_CHECK(ret);
 
+  // compressed history of temperature and humidity values
+  sensor_history_mutex = xSemaphoreCreateMutex();
+  ts_store_init( &sensor_data.history, sensor_history_blocks, SENSOR_HISTORY_BLOCKS, SENSOR_CH_MAX );
+  // history stored in flash survives the reset
+  sensor_log_status = flash_log_mount_partition( &sensor_log, SENSOR_LOG_PARTITION, \
+                                                 sensor_log_index, SENSOR_LOG_MAX_SECTORS );
+  if( sensor_log_status )
+  {
+    ESP_LOGI(TAG, "Sensor Log Mounted, %u sectors in use", sensor_log.used);
+    // the RAM history is rebuilt from flash, InfluxDB task uploads from it
+    // what was not written before the reset
+    sensor_history_restore();
+  }
+  else
+  {
+    ESP_LOGE(TAG, "Unable to Mount Sensor Log Partition");
+  }
+
+  // start the influxDB task, samples are spooled till WiFi and time are available
+  influxdb_start();
+
   // connect with WiFi (it will take some time)
   app_connect_wifi();
+  // SNTP keeps trying in background, if WiFi is not connected yet
+  app_sntp_init();
   if( wifi_connect_status )
   {
     ESP_LOGI( TAG, "WiFi Connected, now synchronizing with NTP server." );
-    app_sntp_init();
-    sntp_connect_status = app_sntp_get_time();
-    // if time fetched then only start the influxDB server
-    if( sntp_connect_status )
+    if( app_sntp_get_time() )
     {
-      // now start the influxDB task
-      influxdb_start();
+      sntp_connect_status = true;
     }
   }
 
+#ifdef CONFIG_LOADGEN_ENABLE
+  // virtual devices publish on the telemetry bus along with the local sensor
+  loadgen_config_t loadgen_cfg = LOADGEN_CONFIG_DEFAULT();
+  loadgen_cfg.devices = CONFIG_LOADGEN_DEVICES;
+  loadgen_cfg.rate_hz = CONFIG_LOADGEN_RATE_HZ;
+  loadgen_cfg.duration_s = CONFIG_LOADGEN_DURATION_S;
+  loadgen_cfg.report_ms = CONFIG_LOADGEN_REPORT_MS;
+  ESP_ERROR_CHECK( loadgen_start( &loadgen_cfg ) );
+#endif
+
   // initialize dht sensor library
   dht11_init(DHT11_PIN, true);
 
@@ -99,29 +144,48 @@ void app_main(void)
       // humidity can't be greater than 100%, that means invalid data
       if( temp < 100 )
       {
-        if( sensor_data.sensor_idx < SENSOR_BUFF_SIZE )
+        int32_t values[SENSOR_CH_MAX];
+        float sample[SENSOR_CH_MAX];
+        sensor_data.humidity_current = temp;
+        temp = (uint8_t)dht11_read().temperature;
+        sensor_data.temperature_current = temp;
+        ESP_LOGI(TAG, "Temperature: %d", sensor_data.temperature_current);
+        ESP_LOGI(TAG, "Humidity: %d", sensor_data.humidity_current);
+        // store the values in history
+        values[SENSOR_CH_TEMPERATURE] = sensor_data.temperature_current;
+        values[SENSOR_CH_HUMIDITY] = sensor_data.humidity_current;
+        // history and flash log are sorted by time, hence only synchronized
+        // time is stored, before that the clock starts from 1970
+        if( sntp_connect_status && sensor_history_lock() )
         {
-          sensor_data.humidity[sensor_data.sensor_idx] = temp;
-          sensor_data.humidity_current = temp;
-          temp = (uint8_t)dht11_read().temperature;
-          sensor_data.temperature[sensor_data.sensor_idx] = temp;
-          sensor_data.temperature_current = temp;
-          ESP_LOGI(TAG, "Temperature: %d", sensor_data.temperature_current);
-          ESP_LOGI(TAG, "Humidity: %d", sensor_data.humidity_current);
-          sensor_data.sensor_idx++;
-          // trigger event to display temperature and humidity
-          // gui_send_event(GUI_MNG_EV_TEMP_HUMID, (uint8_t*)(&sensor_data) );
-          // if wifi is connected, trigger event to send data to ThingSpeak
-          if( wifi_connect_status && sntp_connect_status )
+          uint32_t now = (uint32_t)time(NULL);
+          if( ts_store_append( &sensor_data.history, now, values ) == false )
           {
-            influxdb_send_event(INFLUXDB_EV_TEMP_HUMID, NULL);
+            // clock was set back by SNTP, the sample is still sent to the uplinks
+            ESP_LOGW(TAG, "History sample at %lu not stored, older than last record", now);
           }
-          // reset the index
-          if( sensor_data.sensor_idx >= SENSOR_BUFF_SIZE )
+          else if( sensor_log_status )
           {
-            sensor_data.sensor_idx = 0;
+            sensor_log_record_t record = { .temperature = sensor_data.temperature_current, \
+                                           .humidity = sensor_data.humidity_current };
+            flash_log_append( &sensor_log, now, &record, sizeof(record) );
+            sensor_log_pending++;
+            // records are written in batches to save flash write cycles
+            if( sensor_log_pending >= SENSOR_LOG_FLUSH_SAMPLES )
+            {
+              flash_log_flush( &sensor_log );
+              sensor_log_pending = 0;
+            }
           }
+          sensor_history_unlock();
         }
+        // trigger event to display temperature and humidity
+        // gui_send_event(GUI_MNG_EV_TEMP_HUMID, (uint8_t*)(&sensor_data) );
+        // publish the sample to all the uplinks (InfluxDB), this never blocks,
+        // sample is spooled if WiFi or time is not available and sent later
+        sample[SENSOR_CH_TEMPERATURE] = sensor_data.temperature_current;
+        sample[SENSOR_CH_HUMIDITY] = sensor_data.humidity_current;
+        telemetry_publish( sample, SENSOR_CH_MAX );
       }
       else
       {
@@ -149,6 +213,26 @@ sensor_data_t * get_temperature_humidity( void )
   return &sensor_data;
 }
 
+/**
+ * @brief Lock the sensor history, this must be taken before reading or writing
+ *        the compressed history from any task
+ * @param  None
+ * @return true if locking is successful else false
+ */
+bool sensor_history_lock( void )
+{
+  return ( pdTRUE == xSemaphoreTake(sensor_history_mutex, portMAX_DELAY) );
+}
+
+/**
+ * @brief Unlock the sensor history
+ * @param  None
+ */
+void sensor_history_unlock( void )
+{
+  xSemaphoreGive(sensor_history_mutex);
+}
+
 /**
  * @brief Get the MAC Address of the device
  * @param mac_str used to return the mac address as string
@@ -160,9 +244,40 @@ void get_mac_address( char *mac_str )
   snprintf( mac_str, MAC_ADDR_SIZE, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5] );
 }
 
+/**
+ * @brief Get the WiFi connection status
+ * @param  None
+ * @return true if connected with access point and IP is available
+ */
+bool get_wifi_status( void )
+{
+  return wifi_connect_status;
+}
+
+/**
+ * @brief Get the time synchronization status
+ * @param  None
+ * @return true if time is synchronized with SNTP server
+ */
+bool get_time_status( void )
+{
+  return sntp_connect_status;
+}
+
+/**
+ * @brief Get the UTC time in nanoseconds
+ * @param  None
+ * @return time in nanoseconds, 0 if time is not synchronized yet
+ */
 long long get_time_ns( void )
 {
   struct timeval now;
+
+  // before synchronization the time starts from 1970, that is not a valid time stamp
+  if( !sntp_connect_status )
+  {
+    return 0;
+  }
   gettimeofday( &now, NULL );
   long long time_ns = (long long)now.tv_sec * 1000000000LL + now.tv_usec * 1000LL;
 
@@ -170,6 +285,41 @@ long long get_time_ns( void )
 }
 
 // Private Function Definitions
+/**
+ * @brief Replay the sensor log from flash in the RAM history, this is done once
+ *        at boot before the tasks using the history are started. The replay
+ *        stops at the first record which fails the CRC check (torn write). The
+ *        log is bigger than the history, so only the newest sectors which can
+ *        fill the history are read, instead of the complete partition.
+ * @param  None
+ */
+static void sensor_history_restore( void )
+{
+  flash_log_cursor_t cursor;
+  sensor_log_record_t record;
+  int32_t values[SENSOR_CH_MAX];
+  uint32_t timestamp = 0;
+  uint32_t restored = 0;
+  size_t len = sizeof(record);
+
+  flash_log_seek_tail( &sensor_log, ts_store_capacity( &sensor_data.history ), sizeof(record), &cursor );
+  while( flash_log_next( &cursor, &timestamp, &record, &len ) )
+  {
+    if( len == sizeof(record) )
+    {
+      values[SENSOR_CH_TEMPERATURE] = record.temperature;
+      values[SENSOR_CH_HUMIDITY] = record.humidity;
+      if( ts_store_append( &sensor_data.history, timestamp, values ) )
+      {
+        restored++;
+      }
+    }
+    len = sizeof(record);
+  }
+  ESP_LOGI(TAG, "Sensor History Restored, %" PRIu32 " samples, %u bytes", restored, \
+           (unsigned)ts_store_bytes_used( &sensor_data.history ));
+}
+
 /**
  * @brief Connect with the WiFi Router
  * @note  in future this function can be moved to a commom place.
@@ -243,7 +393,7 @@ static void app_connect_wifi( void )
   {
     ESP_LOGE(TAG, "Unexpected Event" );
   }
-  vEventGroupDelete(wifi_event_group);
+  // event group is not deleted, event handler uses it on every reconnect
 }
 
 /**
@@ -263,6 +413,8 @@ static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t
     }
     else if( WIFI_EVENT_STA_DISCONNECTED == event_id )
     {
+      // link is down now, uplinks keep the samples till it is back
+      wifi_connect_status = false;
       if( wifi_connect_retry < WIFI_MAX_RETRY )
       {
         uint32_t delay = (1 << wifi_connect_retry) * WIFI_CONNECT_DELAY;
@@ -275,9 +427,11 @@ static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t
       }
       else
       {
-        wifi_connect_status = false;
         xEventGroupSetBits(wifi_event_group, WIFI_FAIL_BIT);
-        ESP_LOGE(TAG, "Failed to connect to Access Point.");
+        ESP_LOGE(TAG, "Failed to connect to Access Point, retry in %d ms", WIFI_MAX_DELAY);
+        // keep trying at slow rate, samples are spooled meanwhile
+        vTaskDelay(WIFI_MAX_DELAY / portTICK_PERIOD_MS);
+        esp_wifi_connect();
       }
     }
   } // if( WIFI_EVENT = event_base )
@@ -298,11 +452,24 @@ static void wifi_event_handler( void *arg, esp_event_base_t event_base, int32_t
 static void app_sntp_init( void )
 {
   ESP_LOGI( TAG, "Initializing SNTP" );
+  // set the time zone to India Standard Time (IST)
+  setenv( "TZ", "IST-5:30", 1);
+  tzset();
   esp_sntp_setoperatingmode( SNTP_OPMODE_POLL );
   esp_sntp_setservername( 0, "pool.ntp.org" );  // set the SNTP server
+  sntp_set_time_sync_notification_cb( app_sntp_sync_cb );
   esp_sntp_init();
 }
 
+/**
+ * @brief SNTP time synchronization callback, called from lwIP task
+ * @param tv synchronized time
+ */
+static void app_sntp_sync_cb( struct timeval *tv )
+{
+  sntp_connect_status = true;
+}
+
 /**
  * @brief Synchronize the time from the SNTP server
  * @param  None
@@ -314,10 +481,6 @@ static bool app_sntp_get_time( void )
   bool status = false;
   char time_buffer[50] = { 0 };   // temporary: only for printing/debugging
 
-  // set the time zone to India Standard Time (IST)
-  setenv( "TZ", "IST-5:30", 1);
-  tzset();
-
   // wait for the time to be set
   time_t now = 0;
   struct tm time_info = { 0 };
@@ -9,23 +9,42 @@
 #define MAIN_MAIN_H_
 
 #include <unistd.h>
+#include <stdbool.h>
+
+#include "ts_store.h"
+#include "flash_log.h"
 
 // macros
-#define SENSOR_BUFF_SIZE                        (100u)
 #define MAC_ADDR_SIZE                           (18u)
 
+// channels of the sensor history store
+typedef enum {
+  SENSOR_CH_TEMPERATURE = 0,
+  SENSOR_CH_HUMIDITY,
+  SENSOR_CH_MAX,
+} sensor_channel_t;
+
 typedef struct _sensor_data_t
 {
-  uint8_t temperature_current;
-  uint8_t humidity_current;
-  uint8_t temperature[SENSOR_BUFF_SIZE];
-  uint8_t humidity[SENSOR_BUFF_SIZE];
-  size_t  sensor_idx;
+  uint8_t     temperature_current;
+  uint8_t     humidity_current;
+  ts_store_t  history;                // compressed temperature & humidity history
 } sensor_data_t;
 
+// record stored in the flash log
+typedef struct _sensor_log_record_t
+{
+  uint8_t temperature;
+  uint8_t humidity;
+} sensor_log_record_t;
+
 // Public Function Definition
 sensor_data_t * get_temperature_humidity( void );
+bool sensor_history_lock( void );
+void sensor_history_unlock( void );
 void get_mac_address( char *mac_str );
+bool get_wifi_status( void );
+bool get_time_status( void );
 long long get_time_ns( void );
 
 #endif /* MAIN_MAIN_H_ */
@@ -0,0 +1,472 @@
+/*
+ * ts_store.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Compressed time series store (Gorilla style). Every record is a timestamp
+ * and a set of integer values (one per channel). Timestamps are stored as
+ * delta-of-delta and values as delta from the previous record, both zig-zag
+ * encoded in variable length bit fields. For a sensor sampled at a fixed rate
+ * whose value changes slowly, a record costs a few bits instead of bytes.
+ * The blocks are kept in a ring, when the ring is full the oldest block is
+ * dropped, and every block can be decoded independently which allows seeking.
+ */
+#include <string.h>
+
+#include "ts_store.h"
+
+// Private Macros
+#define TS_BLOCK_BITS                     (TS_BLOCK_DATA_SIZE*8u)
+#define TS_ZIGZAG(x)                      (((uint32_t)(x) << 1) ^ (uint32_t)((x) >> 31))
+
+// variable length field, prefix '0' means zero, '10' + width[0] bits,
+// '110' + width[1] bits and '111' + width[2] bits
+typedef struct _ts_field_t
+{
+  uint8_t width[3];
+} ts_field_t;
+
+// Private Variables
+static const ts_field_t ts_time_field  = { { 7, 12, 32 } };
+static const ts_field_t ts_value_field = { { 6, 12, 32 } };
+
+// Private Function Declaration
+static uint8_t ts_field_bits( const ts_field_t *field, uint32_t zz );
+static void ts_put_bits( ts_block_t *block, uint32_t value, uint8_t bits );
+static uint32_t ts_get_bits( const ts_block_t *block, uint16_t *bit_pos, uint8_t bits );
+static void ts_put_field( ts_block_t *block, const ts_field_t *field, uint32_t zz );
+static uint32_t ts_get_field( const ts_block_t *block, uint16_t *bit_pos, const ts_field_t *field );
+static int32_t ts_unzigzag( uint32_t zz );
+static void ts_codec_reset( ts_codec_t *codec, uint32_t timestamp );
+static ts_block_t * ts_store_block( const ts_store_t *store, uint16_t idx );
+static ts_block_t * ts_store_new_block( ts_store_t *store, uint32_t timestamp );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the time series store
+ * @param store pointer to store object
+ * @param blocks block storage, this decides the history length
+ * @param num_blocks number of blocks in block storage
+ * @param channels number of values in every record
+ */
+void ts_store_init( ts_store_t *store, ts_block_t *blocks, uint16_t num_blocks, uint8_t channels )
+{
+  store->blocks = blocks;
+  store->num_blocks = num_blocks;
+  store->channels = (channels > TS_STORE_MAX_CHANNELS) ? TS_STORE_MAX_CHANNELS : channels;
+  ts_store_clear( store );
+}
+
+/**
+ * @brief Remove all the records from the store
+ * @param store pointer to store object
+ */
+void ts_store_clear( ts_store_t *store )
+{
+  store->head = 0;
+  store->used = 0;
+  store->records = 0;
+  store->dropped = 0;
+  ts_codec_reset( &store->encoder, 0 );
+}
+
+/**
+ * @brief Append a new record to the store
+ * @param store pointer to store object
+ * @param timestamp record timestamp, must not be older than the last record
+ * @param values array of store->channels values
+ * @return true if record is stored else false
+ */
+bool ts_store_append( ts_store_t *store, uint32_t timestamp, const int32_t *values )
+{
+  ts_block_t *block = NULL;
+  ts_codec_t *enc = &store->encoder;
+  int64_t dod = 0;
+  int32_t delta = 0;
+  uint32_t zz_time = 0;
+  uint32_t zz_values[TS_STORE_MAX_CHANNELS];
+  uint16_t bits = 0;
+  uint8_t ch = 0;
+
+  if( store->num_blocks == 0 )
+  {
+    return false;
+  }
+
+  if( store->used )
+  {
+    block = ts_store_block( store, store->used - 1 );
+    if( timestamp < enc->prev_time )
+    {
+      // time can't go backwards, else seeking will not work
+      return false;
+    }
+    delta = (int32_t)(timestamp - enc->prev_time);
+    dod = (int64_t)delta - (int64_t)enc->prev_delta;
+    if( (dod > INT32_MAX) || (dod < INT32_MIN) )
+    {
+      // too large gap to encode, start a new block
+      block = NULL;
+    }
+  }
+
+  if( block != NULL )
+  {
+    // calculate the exact size of the record
+    zz_time = TS_ZIGZAG( (int32_t)dod );
+    bits = ts_field_bits( &ts_time_field, zz_time );
+    for( ch = 0; ch < store->channels; ch++ )
+    {
+      zz_values[ch] = TS_ZIGZAG( (int32_t)((uint32_t)values[ch] - (uint32_t)enc->prev_values[ch]) );
+      bits += ts_field_bits( &ts_value_field, zz_values[ch] );
+    }
+    if( ((uint32_t)block->bit_len + bits) > TS_BLOCK_BITS )
+    {
+      block = NULL;
+    }
+  }
+
+  if( block == NULL )
+  {
+    // first record of a block is encoded relative to block start and zero
+    block = ts_store_new_block( store, timestamp );
+    delta = 0;
+    zz_time = 0;
+    for( ch = 0; ch < store->channels; ch++ )
+    {
+      zz_values[ch] = TS_ZIGZAG( values[ch] );
+    }
+  }
+
+  ts_put_field( block, &ts_time_field, zz_time );
+  for( ch = 0; ch < store->channels; ch++ )
+  {
+    ts_put_field( block, &ts_value_field, zz_values[ch] );
+    enc->prev_values[ch] = values[ch];
+  }
+  enc->prev_delta = delta;
+  enc->prev_time = timestamp;
+  block->t_end = timestamp;
+  block->count++;
+  store->records++;
+  return true;
+}
+
+/**
+ * @brief Get the number of compressed bytes used by the records
+ * @param store pointer to store object
+ * @return number of bytes used
+ */
+size_t ts_store_bytes_used( const ts_store_t *store )
+{
+  size_t bytes = 0;
+  uint16_t idx = 0;
+  for( idx = 0; idx < store->used; idx++ )
+  {
+    bytes += (ts_store_block( store, idx )->bit_len + 7u) / 8u;
+  }
+  return bytes;
+}
+
+/**
+ * @brief Get the maximum number of records the store can hold, this is the
+ *        best case where every field of a record is encoded in one bit
+ * @param store pointer to store object
+ * @return number of records
+ */
+uint32_t ts_store_capacity( const ts_store_t *store )
+{
+  return (uint32_t)store->num_blocks * (TS_BLOCK_BITS / (1u + store->channels));
+}
+
+/**
+ * @brief Position the reader at the first record not older than timestamp,
+ *        the block is found with binary search and only that block is decoded
+ * @param store pointer to store object
+ * @param timestamp records older than this are skipped, use 0 to read all
+ * @param reader reader object to initialize
+ */
+void ts_store_seek( const ts_store_t *store, uint32_t timestamp, ts_reader_t *reader )
+{
+  uint16_t low = 0;
+  uint16_t high = store->used;
+  uint16_t mid = 0;
+  uint32_t t = 0;
+  int32_t values[TS_STORE_MAX_CHANNELS];
+  ts_reader_t probe;
+
+  // first block whose last record is not older than timestamp
+  while( low < high )
+  {
+    mid = low + (high - low) / 2;
+    if( ts_store_block( store, mid )->t_end < timestamp )
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+
+  memset( reader, 0x00, sizeof(ts_reader_t) );
+  reader->store = store;
+  reader->block = low;
+  if( low < store->used )
+  {
+    ts_codec_reset( &reader->decoder, ts_store_block( store, low )->t_start );
+  }
+
+  // skip the older records of this block
+  probe = *reader;
+  while( ts_reader_next( &probe, &t, values ) && (t < timestamp) )
+  {
+    *reader = probe;
+  }
+}
+
+/**
+ * @brief Read the next record
+ * @param reader reader object, initialized with ts_store_seek
+ * @param timestamp record timestamp
+ * @param values array of store->channels values
+ * @return true if a record is read else false (no more records)
+ */
+bool ts_reader_next( ts_reader_t *reader, uint32_t *timestamp, int32_t *values )
+{
+  const ts_store_t *store = reader->store;
+  const ts_block_t *block = NULL;
+  ts_codec_t *dec = &reader->decoder;
+  uint8_t ch = 0;
+
+  while( reader->block < store->used )
+  {
+    block = ts_store_block( store, reader->block );
+    if( reader->record < block->count )
+    {
+      break;
+    }
+    // move to next block
+    reader->block++;
+    reader->record = 0;
+    reader->bit_pos = 0;
+    if( reader->block < store->used )
+    {
+      ts_codec_reset( dec, ts_store_block( store, reader->block )->t_start );
+    }
+  }
+
+  if( reader->block >= store->used )
+  {
+    return false;
+  }
+
+  dec->prev_delta += ts_unzigzag( ts_get_field( block, &reader->bit_pos, &ts_time_field ) );
+  dec->prev_time += (uint32_t)dec->prev_delta;
+  *timestamp = dec->prev_time;
+  for( ch = 0; ch < store->channels; ch++ )
+  {
+    dec->prev_values[ch] += ts_unzigzag( ts_get_field( block, &reader->bit_pos, &ts_value_field ) );
+    values[ch] = dec->prev_values[ch];
+  }
+  reader->record++;
+  return true;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Get the number of bits required to encode a value in a field
+ * @param field field description
+ * @param zz zig-zag encoded value
+ * @return number of bits
+ */
+static uint8_t ts_field_bits( const ts_field_t *field, uint32_t zz )
+{
+  uint8_t bits = 0;
+  if( zz == 0 )
+  {
+    bits = 1;
+  }
+  else if( zz < (1u << field->width[0]) )
+  {
+    bits = 2 + field->width[0];
+  }
+  else if( zz < (1u << field->width[1]) )
+  {
+    bits = 3 + field->width[1];
+  }
+  else
+  {
+    bits = 3 + field->width[2];
+  }
+  return bits;
+}
+
+/**
+ * @brief Write bits in the block data, most significant bit first
+ * @param block block pointer
+ * @param value value to write
+ * @param bits number of bits to write (max 32)
+ */
+static void ts_put_bits( ts_block_t *block, uint32_t value, uint8_t bits )
+{
+  uint8_t bit = 0;
+  uint16_t pos = 0;
+  while( bits )
+  {
+    bits--;
+    bit = (uint8_t)((value >> bits) & 1u);
+    pos = block->bit_len;
+    if( bit )
+    {
+      block->data[pos >> 3] |= (uint8_t)(0x80u >> (pos & 7u));
+    }
+    else
+    {
+      block->data[pos >> 3] &= (uint8_t)~(0x80u >> (pos & 7u));
+    }
+    block->bit_len++;
+  }
+}
+
+/**
+ * @brief Read bits from the block data, most significant bit first
+ * @param block block pointer
+ * @param bit_pos current bit position, updated after reading
+ * @param bits number of bits to read (max 32)
+ * @return value read
+ */
+static uint32_t ts_get_bits( const ts_block_t *block, uint16_t *bit_pos, uint8_t bits )
+{
+  uint32_t value = 0;
+  uint16_t pos = 0;
+  while( bits )
+  {
+    bits--;
+    pos = *bit_pos;
+    value = (value << 1) | ((block->data[pos >> 3] >> (7u - (pos & 7u))) & 1u);
+    (*bit_pos)++;
+  }
+  return value;
+}
+
+/**
+ * @brief Write a variable length field
+ * @param block block pointer
+ * @param field field description
+ * @param zz zig-zag encoded value
+ */
+static void ts_put_field( ts_block_t *block, const ts_field_t *field, uint32_t zz )
+{
+  if( zz == 0 )
+  {
+    ts_put_bits( block, 0x00, 1 );
+  }
+  else if( zz < (1u << field->width[0]) )
+  {
+    ts_put_bits( block, 0x02, 2 );
+    ts_put_bits( block, zz, field->width[0] );
+  }
+  else if( zz < (1u << field->width[1]) )
+  {
+    ts_put_bits( block, 0x06, 3 );
+    ts_put_bits( block, zz, field->width[1] );
+  }
+  else
+  {
+    ts_put_bits( block, 0x07, 3 );
+    ts_put_bits( block, zz, field->width[2] );
+  }
+}
+
+/**
+ * @brief Read a variable length field
+ * @param block block pointer
+ * @param bit_pos current bit position, updated after reading
+ * @param field field description
+ * @return zig-zag encoded value
+ */
+static uint32_t ts_get_field( const ts_block_t *block, uint16_t *bit_pos, const ts_field_t *field )
+{
+  uint32_t zz = 0;
+  if( ts_get_bits( block, bit_pos, 1 ) == 0 )
+  {
+    zz = 0;
+  }
+  else if( ts_get_bits( block, bit_pos, 1 ) == 0 )
+  {
+    zz = ts_get_bits( block, bit_pos, field->width[0] );
+  }
+  else if( ts_get_bits( block, bit_pos, 1 ) == 0 )
+  {
+    zz = ts_get_bits( block, bit_pos, field->width[1] );
+  }
+  else
+  {
+    zz = ts_get_bits( block, bit_pos, field->width[2] );
+  }
+  return zz;
+}
+
+/**
+ * @brief Decode the zig-zag encoded value
+ * @param zz zig-zag encoded value
+ * @return signed value
+ */
+static int32_t ts_unzigzag( uint32_t zz )
+{
+  return (int32_t)((zz >> 1) ^ (~(zz & 1u) + 1u));
+}
+
+/**
+ * @brief Reset the encoder/decoder state at the start of block
+ * @param codec codec state
+ * @param timestamp block start timestamp
+ */
+static void ts_codec_reset( ts_codec_t *codec, uint32_t timestamp )
+{
+  memset( codec, 0x00, sizeof(ts_codec_t) );
+  codec->prev_time = timestamp;
+}
+
+/**
+ * @brief Get the block pointer
+ * @param store pointer to store object
+ * @param idx block index relative to the oldest block
+ * @return block pointer
+ */
+static ts_block_t * ts_store_block( const ts_store_t *store, uint16_t idx )
+{
+  return &store->blocks[(store->head + idx) % store->num_blocks];
+}
+
+/**
+ * @brief Open a new block, if all blocks are used the oldest one is dropped
+ * @param store pointer to store object
+ * @param timestamp timestamp of the first record in block
+ * @return new block pointer
+ */
+static ts_block_t * ts_store_new_block( ts_store_t *store, uint32_t timestamp )
+{
+  ts_block_t *block = NULL;
+
+  if( store->used >= store->num_blocks )
+  {
+    block = ts_store_block( store, 0 );
+    store->dropped += block->count;
+    store->records -= block->count;
+    store->head = (store->head + 1) % store->num_blocks;
+    store->used--;
+  }
+  block = ts_store_block( store, store->used );
+  store->used++;
+  block->t_start = timestamp;
+  block->t_end = timestamp;
+  block->count = 0;
+  block->bit_len = 0;
+  ts_codec_reset( &store->encoder, timestamp );
+  return block;
+}
@@ -0,0 +1,68 @@
+/*
+ * ts_store.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+
+#ifndef MAIN_TS_STORE_H_
+#define MAIN_TS_STORE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// macros
+#define TS_STORE_MAX_CHANNELS                   (4u)
+#define TS_BLOCK_DATA_SIZE                      (256u)
+
+// One compressed block, the records inside a block are encoded relative to the
+// previous record of the same block, hence every block can be decoded alone
+typedef struct _ts_block_t
+{
+  uint32_t  t_start;                        // timestamp of first record
+  uint32_t  t_end;                          // timestamp of last record
+  uint16_t  count;                          // number of records in block
+  uint16_t  bit_len;                        // number of bits used in data
+  uint8_t   data[TS_BLOCK_DATA_SIZE];
+} ts_block_t;
+
+// Encoder/Decoder state, it is same for writing and reading
+typedef struct _ts_codec_t
+{
+  uint32_t  prev_time;
+  int32_t   prev_delta;
+  int32_t   prev_values[TS_STORE_MAX_CHANNELS];
+} ts_codec_t;
+
+typedef struct _ts_store_t
+{
+  ts_block_t  *blocks;                      // caller supplied block storage (ring)
+  uint16_t    num_blocks;
+  uint16_t    head;                         // index of the oldest block
+  uint16_t    used;                         // number of blocks in use
+  uint8_t     channels;                     // number of values per record
+  ts_codec_t  encoder;                      // state of the last (open) block
+  uint32_t    records;                      // number of records stored
+  uint32_t    dropped;                      // number of records dropped with old blocks
+} ts_store_t;
+
+typedef struct _ts_reader_t
+{
+  const ts_store_t  *store;
+  uint16_t          block;                  // block number relative to head
+  uint16_t          record;                 // record index inside block
+  uint16_t          bit_pos;
+  ts_codec_t        decoder;
+} ts_reader_t;
+
+// Public Function Prototypes
+void ts_store_init( ts_store_t *store, ts_block_t *blocks, uint16_t num_blocks, uint8_t channels );
+void ts_store_clear( ts_store_t *store );
+bool ts_store_append( ts_store_t *store, uint32_t timestamp, const int32_t *values );
+size_t ts_store_bytes_used( const ts_store_t *store );
+uint32_t ts_store_capacity( const ts_store_t *store );
+void ts_store_seek( const ts_store_t *store, uint32_t timestamp, ts_reader_t *reader );
+bool ts_reader_next( ts_reader_t *reader, uint32_t *timestamp, int32_t *values );
+
+#endif /* MAIN_TS_STORE_H_ */
@@ -0,0 +1,1146 @@
+/*
+ * fat_image.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Minimal FAT16 on an image file, for the host test of sd_logger without a
+ * FAT driver on the build host. The image is a normal FAT16 volume with 4 KB
+ * clusters and 8.3 names (FATFS is built without long file names). The code
+ * behaves like FATFS where it matters for the logger:
+ *  - the data and the FAT are written to the image right away, but the size
+ *    and the first cluster of a file are only written to its directory entry
+ *    by fsync and close, a process which ends without them (power loss) leaves
+ *    the entry of before, like on the card
+ *  - ftruncate to a bigger size allocates the clusters (pre-allocation)
+ *  - at most FAT_IMAGE_MAX_FILES files are open at the same time
+ *  - stat reads the directory entry, so it shows the size of the last sync
+ * The sector buffer of FATFS is not modeled, a partial sector is written to
+ * the image as well.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "fat_image.h"
+
+// Private Macros
+#define FAT_SECTOR_SIZE                   (512u)
+#define FAT_SECTORS_PER_CLUSTER           (FAT_IMAGE_CLUSTER_SIZE / FAT_SECTOR_SIZE)
+#define FAT_RESERVED_SECTORS              (1u)
+#define FAT_NUM_FATS                      (2u)
+#define FAT_ROOT_ENTRIES                  (512u)
+#define FAT_ROOT_SECTORS                  (FAT_ROOT_ENTRIES * 32u / FAT_SECTOR_SIZE)
+#define FAT_MIN_CLUSTERS                  (4085u)
+#define FAT_MAX_CLUSTERS                  (65524u)
+#define FAT_EOC                           (0xFFFFu)
+#define FAT_ENTRY_SIZE                    (32u)
+#define FAT_ENTRIES_PER_CLUSTER           (FAT_IMAGE_CLUSTER_SIZE / FAT_ENTRY_SIZE)
+#define FAT_ATTR_DIR                      (0x10u)
+#define FAT_ATTR_ARCHIVE                  (0x20u)
+#define FAT_ATTR_LFN                      (0x0Fu)
+#define FAT_ATTR_VOLUME                   (0x08u)
+#define FAT_DELETED                       (0xE5u)
+#define FAT_FD_BASE                       (0x100)
+#define FAT_MOUNT_LEN                     (32u)
+
+typedef struct _fat_file_t
+{
+  bool      used;
+  off_t     entry;                          // image offset of the directory entry
+  uint16_t  first;                          // first cluster, 0 if empty
+  uint32_t  size;
+  uint32_t  pos;
+  int       flags;
+  bool      dirty;                          // directory entry is not up to date
+} fat_file_t;
+
+typedef struct _fat_volume_t
+{
+  int       fd;
+  uint32_t  fat_sectors;
+  uint32_t  root_start;                     // sector
+  uint32_t  data_start;                     // sector
+  uint32_t  clusters;
+  uint16_t  *fat;                           // clusters + 2 entries
+  uint16_t  last_alloc;
+  char      mount[FAT_MOUNT_LEN];
+  fat_file_t files[FAT_IMAGE_MAX_FILES];
+  fat_image_stats_t stats;
+} fat_volume_t;
+
+// Private Variables
+static fat_volume_t fat_vol = { .fd = -1 };
+static pthread_mutex_t fat_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Private Function Declaration
+static uint32_t fat_geometry( uint32_t total_sectors, uint32_t *fat_sectors );
+static void fat_put16( uint8_t *ptr, uint16_t value );
+static void fat_put32( uint8_t *ptr, uint32_t value );
+static uint16_t fat_get16( const uint8_t *ptr );
+static uint32_t fat_get32( const uint8_t *ptr );
+static off_t fat_cluster_offset( uint16_t cluster );
+static void fat_set( uint16_t cluster, uint16_t value );
+static uint16_t fat_alloc( uint16_t prev );
+static void fat_free_chain( uint16_t cluster );
+static uint32_t fat_chain_length( uint16_t first );
+static uint16_t fat_cluster_at( uint16_t first, uint32_t index );
+static int fat_reserve( fat_file_t *file, uint32_t length );
+static bool fat_name83( const char *name, size_t len, uint8_t *out );
+static bool fat_dir_slot( uint16_t dir, uint32_t idx, off_t *offset );
+static bool fat_dir_find( uint16_t dir, const uint8_t *name, off_t *offset, uint8_t *entry );
+static int fat_dir_alloc( uint16_t dir, off_t *offset );
+static int fat_resolve( const char *path, uint16_t *dir, uint8_t *name );
+static void fat_write_entry( fat_file_t *file );
+static fat_file_t * fat_file( int fd, bool write );
+static void fat_check_chain( uint16_t first, uint8_t *refs, uint32_t *length, fat_image_check_t *check );
+static void fat_check_dir( uint16_t dir, uint8_t *refs, fat_image_check_t *check );
+static int fat_error( int error );
+
+// the image itself is accessed with the functions of the C library
+int __real_open( const char *path, int flags, ... );
+int __real_close( int fd );
+int __real_ftruncate( int fd, off_t length );
+
+// Public Function Definition
+
+/**
+ * @brief Create an empty FAT16 image
+ * @param path image file
+ * @param size image size in bytes, 16 MB to 256 MB
+ * @return true if successful else false
+ */
+bool fat_image_format( const char *path, uint32_t size )
+{
+  uint8_t sector[FAT_SECTOR_SIZE];
+  uint32_t total = size / FAT_SECTOR_SIZE;
+  uint32_t fat_sectors = 0;
+  uint32_t clusters = fat_geometry( total, &fat_sectors );
+  uint32_t idx = 0;
+  int fd = -1;
+  bool status = true;
+
+  if( (clusters < FAT_MIN_CLUSTERS) || (clusters > FAT_MAX_CLUSTERS) )
+  {
+    return false;
+  }
+  fd = __real_open( path, O_RDWR | O_CREAT | O_TRUNC, 0644 );
+  if( fd < 0 )
+  {
+    return false;
+  }
+  // the file is sparse, the FATs and the root directory read as zero
+  status = (__real_ftruncate( fd, (off_t)total * FAT_SECTOR_SIZE ) == 0);
+
+  memset( sector, 0x00, sizeof(sector) );
+  memcpy( &sector[0], "\xEB\x3C\x90" "MSDOS5.0", 11 );
+  fat_put16( &sector[11], FAT_SECTOR_SIZE );
+  sector[13] = FAT_SECTORS_PER_CLUSTER;
+  fat_put16( &sector[14], FAT_RESERVED_SECTORS );
+  sector[16] = FAT_NUM_FATS;
+  fat_put16( &sector[17], FAT_ROOT_ENTRIES );
+  fat_put16( &sector[19], (total < 0x10000u) ? (uint16_t)total : 0u );
+  sector[21] = 0xF8;
+  fat_put16( &sector[22], (uint16_t)fat_sectors );
+  fat_put16( &sector[24], 63 );
+  fat_put16( &sector[26], 255 );
+  fat_put32( &sector[32], (total < 0x10000u) ? 0u : total );
+  sector[36] = 0x80;
+  sector[38] = 0x29;
+  fat_put32( &sector[39], 0x20261019u );
+  memcpy( &sector[43], "NO NAME    FAT16   ", 19 );
+  sector[510] = 0x55;
+  sector[511] = 0xAA;
+  status = status && (pwrite( fd, sector, sizeof(sector), 0 ) == (ssize_t)sizeof(sector));
+
+  // media type and end of chain in the first two entries of both FATs
+  memset( sector, 0x00, sizeof(sector) );
+  fat_put16( &sector[0], 0xFFF8 );
+  fat_put16( &sector[2], FAT_EOC );
+  for( idx = 0; idx < FAT_NUM_FATS; idx++ )
+  {
+    status = status && (pwrite( fd, sector, 4, (off_t)(FAT_RESERVED_SECTORS + idx * fat_sectors) * FAT_SECTOR_SIZE ) == 4);
+  }
+  __real_close( fd );
+  return status;
+}
+
+/**
+ * @brief Mount the image, paths below mount_point are on the image
+ * @param path image file
+ * @param mount_point mount point, like MOUNT_POINT of sd_mng.h
+ * @return true if successful else false
+ */
+bool fat_image_mount( const char *path, const char *mount_point )
+{
+  uint8_t sector[FAT_SECTOR_SIZE];
+  uint32_t total = 0;
+  uint32_t fat_sectors = 0;
+  size_t fat_bytes = 0;
+
+  fat_image_unmount();
+  memset( &fat_vol, 0x00, sizeof(fat_vol) );
+  fat_vol.fd = __real_open( path, O_RDWR );
+  if( fat_vol.fd < 0 )
+  {
+    return false;
+  }
+  if( (pread( fat_vol.fd, sector, sizeof(sector), 0 ) != (ssize_t)sizeof(sector)) || \
+      (fat_get16( &sector[11] ) != FAT_SECTOR_SIZE) || (sector[13] != FAT_SECTORS_PER_CLUSTER) || \
+      (sector[510] != 0x55) || (sector[511] != 0xAA) )
+  {
+    fat_image_unmount();
+    return false;
+  }
+  total = fat_get16( &sector[19] ) ? fat_get16( &sector[19] ) : fat_get32( &sector[32] );
+  fat_vol.clusters = fat_geometry( total, &fat_sectors );
+  fat_vol.fat_sectors = fat_get16( &sector[22] );
+  fat_vol.root_start = FAT_RESERVED_SECTORS + FAT_NUM_FATS * fat_vol.fat_sectors;
+  fat_vol.data_start = fat_vol.root_start + FAT_ROOT_SECTORS;
+
+  fat_bytes = ((size_t)fat_vol.clusters + 2u) * sizeof(uint16_t);
+  fat_vol.fat = malloc( fat_bytes );
+  if( (fat_vol.fat == NULL) || (fat_sectors != fat_vol.fat_sectors) || \
+      (pread( fat_vol.fd, fat_vol.fat, fat_bytes, FAT_RESERVED_SECTORS * FAT_SECTOR_SIZE ) != (ssize_t)fat_bytes) )
+  {
+    fat_image_unmount();
+    return false;
+  }
+  fat_vol.last_alloc = 1;
+  snprintf( fat_vol.mount, sizeof(fat_vol.mount), "%s", mount_point );
+  return true;
+}
+
+/**
+ * @brief Unmount the image, the open files are closed first
+ * @param  none
+ */
+void fat_image_unmount( void )
+{
+  uint32_t idx = 0;
+
+  if( fat_vol.fd >= 0 )
+  {
+    for( idx = 0; idx < FAT_IMAGE_MAX_FILES; idx++ )
+    {
+      if( fat_vol.files[idx].used )
+      {
+        fat_close( FAT_FD_BASE + (int)idx );
+      }
+    }
+    __real_close( fat_vol.fd );
+  }
+  free( fat_vol.fat );
+  fat_vol.fat = NULL;
+  fat_vol.fd = -1;
+}
+
+/**
+ * @brief Get the access counters since mount
+ * @param stats statistics output
+ */
+void fat_image_get_stats( fat_image_stats_t *stats )
+{
+  pthread_mutex_lock( &fat_lock );
+  *stats = fat_vol.stats;
+  pthread_mutex_unlock( &fat_lock );
+}
+
+/**
+ * @brief Check the volume like chkdsk, every cluster must belong to exactly
+ *        one chain and every chain must match its file size
+ * @param check result
+ * @return true if the volume is consistent else false
+ */
+bool fat_image_check( fat_image_check_t *check )
+{
+  uint8_t *refs = NULL;
+  uint32_t cluster = 0;
+
+  memset( check, 0x00, sizeof(fat_image_check_t) );
+  pthread_mutex_lock( &fat_lock );
+  refs = calloc( (size_t)fat_vol.clusters + 2u, 1 );
+  if( refs != NULL )
+  {
+    fat_check_dir( 0, refs, check );
+    for( cluster = 2; cluster < (fat_vol.clusters + 2u); cluster++ )
+    {
+      check->used_clusters += refs[cluster] ? 1u : 0u;
+      check->lost_clusters += ((fat_vol.fat[cluster] != 0) && !refs[cluster]) ? 1u : 0u;
+    }
+    free( refs );
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return ( (refs != NULL) && (check->lost_clusters == 0) && (check->bad_chains == 0) && (check->cross_links == 0) );
+}
+
+/**
+ * @brief Get the number of free clusters
+ * @param  none
+ * @return free clusters
+ */
+uint32_t fat_image_free_clusters( void )
+{
+  uint32_t cluster = 0;
+  uint32_t count = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  for( cluster = 2; cluster < (fat_vol.clusters + 2u); cluster++ )
+  {
+    count += (fat_vol.fat[cluster] == 0) ? 1u : 0u;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return count;
+}
+
+int fat_open( const char *path, int flags )
+{
+  uint8_t name[11];
+  uint8_t entry[FAT_ENTRY_SIZE];
+  uint16_t dir = 0;
+  off_t offset = 0;
+  fat_file_t *file = NULL;
+  uint32_t idx = 0;
+  uint32_t open_count = 0;
+  int status = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  status = fat_resolve( path, &dir, name );
+  for( idx = 0; (status == 0) && (idx < FAT_IMAGE_MAX_FILES); idx++ )
+  {
+    if( !fat_vol.files[idx].used )
+    {
+      file = (file == NULL) ? &fat_vol.files[idx] : file;
+    }
+    else
+    {
+      open_count++;
+    }
+  }
+  if( (status == 0) && (file == NULL) )
+  {
+    status = fat_error( EMFILE );
+  }
+  if( status == 0 )
+  {
+    memset( file, 0x00, sizeof(fat_file_t) );
+    if( fat_dir_find( dir, name, &offset, entry ) )
+    {
+      if( entry[11] & FAT_ATTR_DIR )
+      {
+        status = fat_error( EISDIR );
+      }
+      else if( (flags & O_CREAT) && (flags & O_EXCL) )
+      {
+        status = fat_error( EEXIST );
+      }
+      file->first = fat_get16( &entry[26] );
+      file->size = fat_get32( &entry[28] );
+    }
+    else if( flags & O_CREAT )
+    {
+      status = fat_dir_alloc( dir, &offset );
+      if( status == 0 )
+      {
+        memset( entry, 0x00, sizeof(entry) );
+        memcpy( entry, name, sizeof(name) );
+        entry[11] = FAT_ATTR_ARCHIVE;
+        pwrite( fat_vol.fd, entry, sizeof(entry), offset );
+      }
+    }
+    else
+    {
+      status = fat_error( ENOENT );
+    }
+  }
+  if( status == 0 )
+  {
+    file->used = true;
+    file->entry = offset;
+    file->flags = flags;
+    if( (flags & O_TRUNC) && ((flags & O_ACCMODE) != O_RDONLY) && file->first )
+    {
+      fat_free_chain( file->first );
+      file->first = 0;
+      file->size = 0;
+      fat_write_entry( file );
+    }
+    file->pos = (flags & O_APPEND) ? file->size : 0u;
+    status = FAT_FD_BASE + (int)(file - fat_vol.files);
+    fat_vol.stats.max_open = ((open_count + 1u) > fat_vol.stats.max_open) ? (open_count + 1u) : fat_vol.stats.max_open;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return status;
+}
+
+int fat_close( int fd )
+{
+  fat_file_t *file = NULL;
+  int status = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  file = fat_file( fd, false );
+  if( file == NULL )
+  {
+    status = fat_error( EBADF );
+  }
+  else
+  {
+    fat_write_entry( file );
+    file->used = false;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return status;
+}
+
+ssize_t fat_read( int fd, void *data, size_t len )
+{
+  uint8_t *ptr = (uint8_t *)data;
+  fat_file_t *file = NULL;
+  ssize_t done = 0;
+  uint32_t chunk = 0;
+  uint32_t in_cluster = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  file = fat_file( fd, false );
+  if( file == NULL )
+  {
+    done = fat_error( EBADF );
+  }
+  while( (file != NULL) && len && (file->pos < file->size) )
+  {
+    in_cluster = file->pos % FAT_IMAGE_CLUSTER_SIZE;
+    chunk = FAT_IMAGE_CLUSTER_SIZE - in_cluster;
+    chunk = (chunk < len) ? chunk : (uint32_t)len;
+    chunk = (chunk < (file->size - file->pos)) ? chunk : (file->size - file->pos);
+    pread( fat_vol.fd, ptr, chunk, \
+           fat_cluster_offset( fat_cluster_at( file->first, file->pos / FAT_IMAGE_CLUSTER_SIZE ) ) + in_cluster );
+    ptr += chunk;
+    len -= chunk;
+    done += chunk;
+    file->pos += chunk;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return done;
+}
+
+ssize_t fat_write( int fd, const void *data, size_t len )
+{
+  const uint8_t *ptr = (const uint8_t *)data;
+  fat_file_t *file = NULL;
+  ssize_t done = 0;
+  uint32_t chunk = 0;
+  uint32_t in_cluster = 0;
+  uint32_t end = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  file = fat_file( fd, true );
+  if( file == NULL )
+  {
+    done = fat_error( EBADF );
+  }
+  else
+  {
+    fat_vol.stats.writes++;
+    // the part which fits on the volume is written, like FATFS
+    end = file->pos + (uint32_t)len;
+    while( (end > file->pos) && (fat_reserve( file, end ) != 0) )
+    {
+      end = ((end - 1u) / FAT_IMAGE_CLUSTER_SIZE) * FAT_IMAGE_CLUSTER_SIZE;
+      end = (end > file->pos) ? end : file->pos;
+    }
+    len = end - file->pos;
+    if( len == 0 )
+    {
+      done = fat_error( ENOSPC );
+    }
+  }
+  while( (file != NULL) && len )
+  {
+    in_cluster = file->pos % FAT_IMAGE_CLUSTER_SIZE;
+    chunk = FAT_IMAGE_CLUSTER_SIZE - in_cluster;
+    chunk = (chunk < len) ? chunk : (uint32_t)len;
+    pwrite( fat_vol.fd, ptr, chunk, \
+            fat_cluster_offset( fat_cluster_at( file->first, file->pos / FAT_IMAGE_CLUSTER_SIZE ) ) + in_cluster );
+    ptr += chunk;
+    len -= chunk;
+    done += chunk;
+    file->pos += chunk;
+    file->size = (file->pos > file->size) ? file->pos : file->size;
+    file->dirty = true;
+    fat_vol.stats.bytes_written += chunk;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return done;
+}
+
+off_t fat_lseek( int fd, off_t offset, int whence )
+{
+  fat_file_t *file = NULL;
+  off_t pos = -1;
+
+  pthread_mutex_lock( &fat_lock );
+  file = fat_file( fd, false );
+  if( file != NULL )
+  {
+    pos = offset + ((whence == SEEK_CUR) ? (off_t)file->pos : ((whence == SEEK_END) ? (off_t)file->size : 0));
+  }
+  if( (file == NULL) || (pos < 0) || (pos > UINT32_MAX) )
+  {
+    pos = fat_error( (file == NULL) ? EBADF : EINVAL );
+  }
+  else
+  {
+    file->pos = (uint32_t)pos;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return pos;
+}
+
+int fat_ftruncate( int fd, off_t length )
+{
+  fat_file_t *file = NULL;
+  uint32_t keep = 0;
+  uint16_t last = 0;
+  uint16_t next = 0;
+  int status = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  file = fat_file( fd, true );
+  if( (file == NULL) || (length < 0) || (length > UINT32_MAX) )
+  {
+    status = fat_error( (file == NULL) ? EBADF : EINVAL );
+  }
+  else if( (uint32_t)length > file->size )
+  {
+    // allocate the clusters in one go, the content is what was on the card
+    status = fat_reserve( file, (uint32_t)length );
+    if( status != 0 )
+    {
+      // give back what was allocated for the failed part
+      keep = (file->size + FAT_IMAGE_CLUSTER_SIZE - 1u) / FAT_IMAGE_CLUSTER_SIZE;
+      last = keep ? fat_cluster_at( file->first, keep - 1u ) : 0u;
+      next = keep ? fat_vol.fat[last] : file->first;
+      if( keep )
+      {
+        fat_set( last, FAT_EOC );
+      }
+      else
+      {
+        file->first = 0;
+      }
+      fat_free_chain( next );
+      status = fat_error( ENOSPC );
+    }
+  }
+  else
+  {
+    keep = ((uint32_t)length + FAT_IMAGE_CLUSTER_SIZE - 1u) / FAT_IMAGE_CLUSTER_SIZE;
+    if( keep == 0 )
+    {
+      fat_free_chain( file->first );
+      file->first = 0;
+    }
+    else
+    {
+      last = fat_cluster_at( file->first, keep - 1u );
+      next = fat_vol.fat[last];
+      fat_set( last, FAT_EOC );
+      fat_free_chain( next );
+    }
+  }
+  if( status == 0 )
+  {
+    file->size = (uint32_t)length;
+    file->dirty = true;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return status;
+}
+
+int fat_fsync( int fd )
+{
+  fat_file_t *file = NULL;
+  int status = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  file = fat_file( fd, false );
+  if( file == NULL )
+  {
+    status = fat_error( EBADF );
+  }
+  else
+  {
+    fat_vol.stats.syncs++;
+    fat_write_entry( file );
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return status;
+}
+
+int fat_mkdir( const char *path )
+{
+  uint8_t name[11];
+  uint8_t entry[FAT_ENTRY_SIZE];
+  uint8_t cluster_data[FAT_IMAGE_CLUSTER_SIZE];
+  uint16_t dir = 0;
+  uint16_t cluster = 0;
+  off_t offset = 0;
+  int status = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  status = fat_resolve( path, &dir, name );
+  if( (status == 0) && fat_dir_find( dir, name, &offset, entry ) )
+  {
+    status = fat_error( EEXIST );
+  }
+  if( status == 0 )
+  {
+    cluster = fat_alloc( 0 );
+    status = cluster ? fat_dir_alloc( dir, &offset ) : fat_error( ENOSPC );
+  }
+  if( status == 0 )
+  {
+    // "." and ".." entries
+    memset( cluster_data, 0x00, sizeof(cluster_data) );
+    memset( &cluster_data[0], ' ', 11 );
+    cluster_data[0] = '.';
+    cluster_data[11] = FAT_ATTR_DIR;
+    fat_put16( &cluster_data[26], cluster );
+    memset( &cluster_data[FAT_ENTRY_SIZE], ' ', 11 );
+    memset( &cluster_data[FAT_ENTRY_SIZE], '.', 2 );
+    cluster_data[FAT_ENTRY_SIZE + 11] = FAT_ATTR_DIR;
+    fat_put16( &cluster_data[FAT_ENTRY_SIZE + 26], dir );
+    pwrite( fat_vol.fd, cluster_data, sizeof(cluster_data), fat_cluster_offset( cluster ) );
+
+    memset( entry, 0x00, sizeof(entry) );
+    memcpy( entry, name, sizeof(name) );
+    entry[11] = FAT_ATTR_DIR;
+    fat_put16( &entry[26], cluster );
+    pwrite( fat_vol.fd, entry, sizeof(entry), offset );
+  }
+  else if( cluster )
+  {
+    fat_free_chain( cluster );
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return status;
+}
+
+int fat_stat( const char *path, struct stat *st )
+{
+  uint8_t name[11];
+  uint8_t entry[FAT_ENTRY_SIZE];
+  uint16_t dir = 0;
+  off_t offset = 0;
+  int status = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  status = fat_resolve( path, &dir, name );
+  if( (status == 0) && !fat_dir_find( dir, name, &offset, entry ) )
+  {
+    status = fat_error( ENOENT );
+  }
+  if( status == 0 )
+  {
+    memset( st, 0x00, sizeof(struct stat) );
+    st->st_mode = (entry[11] & FAT_ATTR_DIR) ? (S_IFDIR | 0777) : (S_IFREG | 0666);
+    st->st_size = (off_t)fat_get32( &entry[28] );
+    st->st_blksize = FAT_IMAGE_CLUSTER_SIZE;
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return status;
+}
+
+int fat_unlink( const char *path )
+{
+  uint8_t name[11];
+  uint8_t entry[FAT_ENTRY_SIZE];
+  uint16_t dir = 0;
+  off_t offset = 0;
+  int status = 0;
+
+  pthread_mutex_lock( &fat_lock );
+  status = fat_resolve( path, &dir, name );
+  if( (status == 0) && !fat_dir_find( dir, name, &offset, entry ) )
+  {
+    status = fat_error( ENOENT );
+  }
+  if( (status == 0) && (entry[11] & FAT_ATTR_DIR) )
+  {
+    status = fat_error( EISDIR );
+  }
+  if( status == 0 )
+  {
+    fat_free_chain( fat_get16( &entry[26] ) );
+    entry[0] = FAT_DELETED;
+    pwrite( fat_vol.fd, entry, 1, offset );
+  }
+  pthread_mutex_unlock( &fat_lock );
+  return status;
+}
+
+// the file functions of the code under test, linked with -Wl,--wrap=<name>
+int __wrap_open( const char *path, int flags, ... )
+{
+  return fat_open( path, flags );
+}
+
+int __wrap_close( int fd )
+{
+  return fat_close( fd );
+}
+
+ssize_t __wrap_read( int fd, void *data, size_t len )
+{
+  return fat_read( fd, data, len );
+}
+
+ssize_t __wrap_write( int fd, const void *data, size_t len )
+{
+  return fat_write( fd, data, len );
+}
+
+off_t __wrap_lseek( int fd, off_t offset, int whence )
+{
+  return fat_lseek( fd, offset, whence );
+}
+
+int __wrap_ftruncate( int fd, off_t length )
+{
+  return fat_ftruncate( fd, length );
+}
+
+int __wrap_fsync( int fd )
+{
+  return fat_fsync( fd );
+}
+
+int __wrap_mkdir( const char *path, mode_t mode )
+{
+  (void)mode;
+  return fat_mkdir( path );
+}
+
+int __wrap_stat( const char *path, struct stat *st )
+{
+  return fat_stat( path, st );
+}
+
+int __wrap_unlink( const char *path )
+{
+  return fat_unlink( path );
+}
+
+// Private Function Definition
+
+/**
+ * @brief Calculate the FAT size and the number of clusters of a volume
+ * @param total_sectors volume size in sectors
+ * @param fat_sectors sectors of one FAT output
+ * @return number of clusters
+ */
+static uint32_t fat_geometry( uint32_t total_sectors, uint32_t *fat_sectors )
+{
+  uint32_t fixed = FAT_RESERVED_SECTORS + FAT_ROOT_SECTORS;
+  uint32_t clusters = 0;
+  uint32_t size = 1;
+
+  if( total_sectors <= fixed )
+  {
+    *fat_sectors = 0;
+    return 0;
+  }
+  // the FAT covers the clusters, which get less when the FAT grows
+  do
+  {
+    *fat_sectors = size;
+    clusters = (total_sectors - fixed - FAT_NUM_FATS * size) / FAT_SECTORS_PER_CLUSTER;
+    size = ((clusters + 2u) * 2u + FAT_SECTOR_SIZE - 1u) / FAT_SECTOR_SIZE;
+  } while( size > *fat_sectors );
+  return clusters;
+}
+
+static void fat_put16( uint8_t *ptr, uint16_t value )
+{
+  ptr[0] = (uint8_t)value;
+  ptr[1] = (uint8_t)(value >> 8);
+}
+
+static void fat_put32( uint8_t *ptr, uint32_t value )
+{
+  fat_put16( ptr, (uint16_t)value );
+  fat_put16( ptr + 2, (uint16_t)(value >> 16) );
+}
+
+static uint16_t fat_get16( const uint8_t *ptr )
+{
+  return (uint16_t)(ptr[0] | (ptr[1] << 8));
+}
+
+static uint32_t fat_get32( const uint8_t *ptr )
+{
+  return (uint32_t)fat_get16( ptr ) | ((uint32_t)fat_get16( ptr + 2 ) << 16);
+}
+
+static off_t fat_cluster_offset( uint16_t cluster )
+{
+  return ((off_t)fat_vol.data_start + (off_t)(cluster - 2u) * FAT_SECTORS_PER_CLUSTER) * FAT_SECTOR_SIZE;
+}
+
+/**
+ * @brief Change a FAT entry, both FATs in the image are written
+ * @param cluster cluster number
+ * @param value next cluster, 0 for free or FAT_EOC
+ */
+static void fat_set( uint16_t cluster, uint16_t value )
+{
+  uint8_t data[2];
+  uint32_t idx = 0;
+
+  fat_vol.fat[cluster] = value;
+  fat_put16( data, value );
+  for( idx = 0; idx < FAT_NUM_FATS; idx++ )
+  {
+    pwrite( fat_vol.fd, data, sizeof(data), \
+            (off_t)(FAT_RESERVED_SECTORS + idx * fat_vol.fat_sectors) * FAT_SECTOR_SIZE + cluster * 2u );
+  }
+}
+
+/**
+ * @brief Allocate a cluster, the search continues after the last allocated
+ *        one like FATFS
+ * @param prev cluster to link the new one to, 0 for a new chain
+ * @return cluster number, 0 if the volume is full
+ */
+static uint16_t fat_alloc( uint16_t prev )
+{
+  uint32_t count = 0;
+  uint32_t cluster = fat_vol.last_alloc;
+
+  for( count = 0; count < fat_vol.clusters; count++ )
+  {
+    cluster = (cluster + 1u < fat_vol.clusters + 2u) ? (cluster + 1u) : 2u;
+    if( fat_vol.fat[cluster] == 0 )
+    {
+      fat_set( (uint16_t)cluster, FAT_EOC );
+      if( prev )
+      {
+        fat_set( prev, (uint16_t)cluster );
+      }
+      fat_vol.last_alloc = (uint16_t)cluster;
+      return (uint16_t)cluster;
+    }
+  }
+  return 0;
+}
+
+static void fat_free_chain( uint16_t cluster )
+{
+  uint16_t next = 0;
+
+  while( (cluster >= 2u) && (cluster < (fat_vol.clusters + 2u)) )
+  {
+    next = fat_vol.fat[cluster];
+    fat_set( cluster, 0 );
+    cluster = next;
+  }
+}
+
+static uint32_t fat_chain_length( uint16_t first )
+{
+  uint32_t length = 0;
+
+  while( (first >= 2u) && (first < (fat_vol.clusters + 2u)) && (length <= fat_vol.clusters) )
+  {
+    length++;
+    first = fat_vol.fat[first];
+  }
+  return length;
+}
+
+static uint16_t fat_cluster_at( uint16_t first, uint32_t index )
+{
+  while( index-- && (first >= 2u) && (first < (fat_vol.clusters + 2u)) )
+  {
+    first = fat_vol.fat[first];
+  }
+  return first;
+}
+
+/**
+ * @brief Make the chain of a file long enough for a length
+ * @param file file object
+ * @param length bytes
+ * @return 0 if successful else -1, the clusters allocated so far stay
+ */
+static int fat_reserve( fat_file_t *file, uint32_t length )
+{
+  uint32_t need = (length + FAT_IMAGE_CLUSTER_SIZE - 1u) / FAT_IMAGE_CLUSTER_SIZE;
+  uint32_t have = fat_chain_length( file->first );
+  uint16_t last = have ? fat_cluster_at( file->first, have - 1u ) : 0u;
+
+  while( have < need )
+  {
+    last = fat_alloc( last );
+    if( last == 0 )
+    {
+      return -1;
+    }
+    file->first = have ? file->first : last;
+    have++;
+  }
+  return 0;
+}
+
+/**
+ * @brief Convert a path component to the 8.3 directory entry name, FATFS
+ *        without long file names converts lower case to upper case
+ * @param name component
+ * @param len component length
+ * @param out 11 bytes, name and extension padded with spaces
+ * @return true if the name is valid 8.3 else false
+ */
+static bool fat_name83( const char *name, size_t len, uint8_t *out )
+{
+  size_t idx = 0;
+  size_t pos = 0;
+  size_t limit = 8;
+  char ch = 0;
+
+  memset( out, ' ', 11 );
+  if( (len == 0) || (name[0] == '.') )
+  {
+    return false;
+  }
+  for( idx = 0; idx < len; idx++ )
+  {
+    ch = name[idx];
+    if( (ch == '.') && (limit == 8) )
+    {
+      pos = 8;
+      limit = 11;
+      continue;
+    }
+    if( (pos >= limit) || (ch <= ' ') || strchr( "\"*+,./:;<=>?[\\]|", ch ) )
+    {
+      return false;
+    }
+    out[pos++] = (uint8_t)(((ch >= 'a') && (ch <= 'z')) ? (ch - 'a' + 'A') : ch);
+  }
+  return true;
+}
+
+/**
+ * @brief Get the image offset of a directory entry slot
+ * @param dir first cluster of the directory, 0 for root
+ * @param idx entry index
+ * @param offset image offset output
+ * @return true if the slot exists else false
+ */
+static bool fat_dir_slot( uint16_t dir, uint32_t idx, off_t *offset )
+{
+  uint16_t cluster = 0;
+
+  if( dir == 0 )
+  {
+    *offset = (off_t)fat_vol.root_start * FAT_SECTOR_SIZE + (off_t)idx * FAT_ENTRY_SIZE;
+    return ( idx < FAT_ROOT_ENTRIES );
+  }
+  cluster = fat_cluster_at( dir, idx / FAT_ENTRIES_PER_CLUSTER );
+  *offset = fat_cluster_offset( cluster ) + (off_t)(idx % FAT_ENTRIES_PER_CLUSTER) * FAT_ENTRY_SIZE;
+  return ( (cluster >= 2u) && (cluster < (fat_vol.clusters + 2u)) );
+}
+
+static bool fat_dir_find( uint16_t dir, const uint8_t *name, off_t *offset, uint8_t *entry )
+{
+  uint32_t idx = 0;
+
+  for( idx = 0; fat_dir_slot( dir, idx, offset ); idx++ )
+  {
+    pread( fat_vol.fd, entry, FAT_ENTRY_SIZE, *offset );
+    if( entry[0] == 0x00 )
+    {
+      break;
+    }
+    if( (entry[0] != FAT_DELETED) && (entry[11] != FAT_ATTR_LFN) && !(entry[11] & FAT_ATTR_VOLUME) && \
+        (memcmp( entry, name, 11 ) == 0) )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Find a free directory entry, a sub directory grows by a cluster
+ * @param dir first cluster of the directory, 0 for root
+ * @param offset image offset of the free entry output
+ * @return 0 if successful else -1
+ */
+static int fat_dir_alloc( uint16_t dir, off_t *offset )
+{
+  uint8_t entry[FAT_ENTRY_SIZE];
+  uint8_t blank[FAT_IMAGE_CLUSTER_SIZE];
+  uint32_t idx = 0;
+  uint16_t cluster = 0;
+
+  for( idx = 0; fat_dir_slot( dir, idx, offset ); idx++ )
+  {
+    pread( fat_vol.fd, entry, FAT_ENTRY_SIZE, *offset );
+    if( (entry[0] == 0x00) || (entry[0] == FAT_DELETED) )
+    {
+      return 0;
+    }
+  }
+  if( dir == 0 )
+  {
+    return fat_error( ENOSPC );
+  }
+  cluster = fat_alloc( fat_cluster_at( dir, idx / FAT_ENTRIES_PER_CLUSTER - 1u ) );
+  if( cluster == 0 )
+  {
+    return fat_error( ENOSPC );
+  }
+  memset( blank, 0x00, sizeof(blank) );
+  pwrite( fat_vol.fd, blank, sizeof(blank), fat_cluster_offset( cluster ) );
+  *offset = fat_cluster_offset( cluster );
+  return 0;
+}
+
+/**
+ * @brief Find the directory of a path and convert the last component
+ * @param path absolute path below the mount point
+ * @param dir first cluster of the directory output, 0 for root
+ * @param name 8.3 name of the last component output
+ * @return 0 if successful else -1
+ */
+static int fat_resolve( const char *path, uint16_t *dir, uint8_t *name )
+{
+  uint8_t entry[FAT_ENTRY_SIZE];
+  size_t mount_len = strlen( fat_vol.mount );
+  const char *end = NULL;
+  off_t offset = 0;
+
+  if( (fat_vol.fd < 0) || (strncmp( path, fat_vol.mount, mount_len ) != 0) || (path[mount_len] != '/') )
+  {
+    return fat_error( ENOENT );
+  }
+  path += mount_len + 1u;
+  *dir = 0;
+  for( end = strchr( path, '/' ); end != NULL; end = strchr( path, '/' ) )
+  {
+    if( !fat_name83( path, (size_t)(end - path), name ) )
+    {
+      return fat_error( EINVAL );
+    }
+    if( !fat_dir_find( *dir, name, &offset, entry ) || !(entry[11] & FAT_ATTR_DIR) )
+    {
+      return fat_error( ENOENT );
+    }
+    *dir = fat_get16( &entry[26] );
+    path = end + 1;
+  }
+  if( !fat_name83( path, strlen( path ), name ) )
+  {
+    return fat_error( EINVAL );
+  }
+  return 0;
+}
+
+/**
+ * @brief Write the size and first cluster of a file to its directory entry
+ * @param file file object
+ */
+static void fat_write_entry( fat_file_t *file )
+{
+  uint8_t data[6];
+
+  if( file->dirty )
+  {
+    fat_put16( &data[0], file->first );
+    fat_put32( &data[2], file->size );
+    pwrite( fat_vol.fd, data, sizeof(data), file->entry + 26 );
+    file->dirty = false;
+    fat_vol.stats.entry_updates++;
+  }
+}
+
+static fat_file_t * fat_file( int fd, bool write )
+{
+  fat_file_t *file = NULL;
+
+  if( (fd >= FAT_FD_BASE) && (fd < (FAT_FD_BASE + (int)FAT_IMAGE_MAX_FILES)) && \
+      fat_vol.files[fd - FAT_FD_BASE].used )
+  {
+    file = &fat_vol.files[fd - FAT_FD_BASE];
+    if( write && ((file->flags & O_ACCMODE) == O_RDONLY) )
+    {
+      file = NULL;
+    }
+  }
+  return file;
+}
+
+static void fat_check_chain( uint16_t first, uint8_t *refs, uint32_t *length, fat_image_check_t *check )
+{
+  *length = 0;
+  while( (first >= 2u) && (first < (fat_vol.clusters + 2u)) )
+  {
+    if( refs[first] )
+    {
+      // cross link, or a loop in the chain
+      check->cross_links++;
+      break;
+    }
+    refs[first] = 1;
+    (*length)++;
+    first = fat_vol.fat[first];
+  }
+}
+
+static void fat_check_dir( uint16_t dir, uint8_t *refs, fat_image_check_t *check )
+{
+  uint8_t entry[FAT_ENTRY_SIZE];
+  uint32_t idx = 0;
+  uint32_t length = 0;
+  off_t offset = 0;
+
+  for( idx = 0; fat_dir_slot( dir, idx, &offset ); idx++ )
+  {
+    pread( fat_vol.fd, entry, FAT_ENTRY_SIZE, offset );
+    if( entry[0] == 0x00 )
+    {
+      break;
+    }
+    if( (entry[0] == FAT_DELETED) || (entry[0] == '.') || (entry[11] == FAT_ATTR_LFN) || (entry[11] & FAT_ATTR_VOLUME) )
+    {
+      continue;
+    }
+    fat_check_chain( fat_get16( &entry[26] ), refs, &length, check );
+    if( entry[11] & FAT_ATTR_DIR )
+    {
+      check->dirs++;
+      fat_check_dir( fat_get16( &entry[26] ), refs, check );
+    }
+    else
+    {
+      check->files++;
+      if( length != ((fat_get32( &entry[28] ) + FAT_IMAGE_CLUSTER_SIZE - 1u) / FAT_IMAGE_CLUSTER_SIZE) )
+      {
+        check->bad_chains++;
+      }
+    }
+  }
+}
+
+static int fat_error( int error )
+{
+  errno = error;
+  return -1;
+}
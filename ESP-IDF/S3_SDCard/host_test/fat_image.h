@@ -0,0 +1,63 @@
+/*
+ * fat_image.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * FAT16 partition image for the host test of sd_logger, see fat_image.c
+ */
+
+#ifndef FAT_IMAGE_H_
+#define FAT_IMAGE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// macros
+#define FAT_IMAGE_CLUSTER_SIZE                  (4096u)
+#define FAT_IMAGE_MAX_FILES                     (3u)      // max_files of sd_mng_mount_card
+
+typedef struct _fat_image_stats_t
+{
+  uint32_t writes;                          // write calls
+  uint64_t bytes_written;
+  uint32_t syncs;                           // fsync calls
+  uint32_t entry_updates;                   // directory entries written by sync and close
+  uint32_t max_open;                        // most files open at the same time
+} fat_image_stats_t;
+
+typedef struct _fat_image_check_t
+{
+  uint32_t files;
+  uint32_t dirs;
+  uint32_t used_clusters;                   // clusters referenced by files and directories
+  uint32_t lost_clusters;                   // allocated in the FAT, but not referenced
+  uint32_t bad_chains;                      // chain length doesn't match the file size
+  uint32_t cross_links;                     // clusters in more than one chain
+} fat_image_check_t;
+
+// Public Function Prototypes
+bool fat_image_format( const char *path, uint32_t size );
+bool fat_image_mount( const char *path, const char *mount_point );
+void fat_image_unmount( void );
+void fat_image_get_stats( fat_image_stats_t *stats );
+bool fat_image_check( fat_image_check_t *check );
+uint32_t fat_image_free_clusters( void );
+
+// POSIX functions on the image, the code under test reaches them through
+// -Wl,--wrap, see the Makefile
+int fat_open( const char *path, int flags );
+int fat_close( int fd );
+ssize_t fat_read( int fd, void *data, size_t len );
+ssize_t fat_write( int fd, const void *data, size_t len );
+off_t fat_lseek( int fd, off_t offset, int whence );
+int fat_ftruncate( int fd, off_t length );
+int fat_fsync( int fd );
+int fat_mkdir( const char *path );
+int fat_stat( const char *path, struct stat *st );
+int fat_unlink( const char *path );
+
+#endif /* FAT_IMAGE_H_ */
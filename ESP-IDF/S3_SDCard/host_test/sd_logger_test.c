@@ -0,0 +1,538 @@
+/*
+ * sd_logger_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of sd_logger against a FAT16 image file (fat_image.c), the file
+ * functions of sd_logger.c are linked to the image and time() to a test clock.
+ * A power loss is a child process which ends with _exit() while the logger is
+ * running, the parent mounts the image again like the next boot. The cases:
+ *  - rotation by size and by date, names, sizes and content of the files
+ *  - pre-allocation recovery, the file left at its allocated size by the
+ *    power loss is truncated to the data written before it
+ *  - flush policies, the buffer thresholds, the periodic flush of the task,
+ *    and what each fsync policy leaves on the card after a power loss
+ *  - card full, the logger drops data instead of blocking
+ * Every case ends with a check of the FAT (no lost clusters, chains match the
+ * file sizes).
+ *
+ *  make -C S3_SDCard/host_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "sd_mng.h"
+#include "sd_logger.h"
+#include "fat_image.h"
+
+// Private Macros
+#define TEST_IMAGE                          "build/sd_logger_test.img"
+#define TEST_IMAGE_SIZE                     (64u * 1024u * 1024u)
+#define TEST_SMALL_IMAGE_SIZE               (17u * 1024u * 1024u)
+#define TEST_LINE_SIZE                      (8u)
+#define TEST_DAY1                           (1792404000)    // 2026-10-19 10:00:00 UTC
+#define TEST_MIDNIGHT                       (1792454400)    // 2026-10-20 00:00:00 UTC
+#define TEST_FILE_MAX                       (1024u * 1024u)
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond );   \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+// Private Variables
+static volatile time_t test_now = TEST_DAY1;
+static uint8_t test_data[TEST_FILE_MAX];
+static int test_failed = 0;
+
+// Private Function Declaration
+static void test_rotation_size( void );
+static void test_rotation_daily( void );
+static void test_prealloc_recovery( void );
+static void test_flush_thresholds( void );
+static void test_flush_periodic( void );
+static void test_fsync_power_loss( void );
+static void test_fsync_count( void );
+static void test_card_full( void );
+static bool test_volume( uint32_t size );
+static sd_logger_config_t test_config( void );
+static void test_write_lines( uint32_t first, uint32_t count );
+static long test_file_size( const char *name );
+static bool test_file_lines( const char *name, uint32_t first, uint32_t count );
+static void test_check_volume( uint32_t lost );
+static int test_run_child( void (*child)( const void * ), const void *arg );
+static void test_child_prealloc( const void *arg );
+static void test_child_fsync( const void *arg );
+
+time_t __wrap_time( time_t *t );
+
+int main( void )
+{
+  setenv( "TZ", "UTC0", 1 );
+  tzset();
+
+  test_rotation_size();
+  test_rotation_daily();
+  test_prealloc_recovery();
+  test_flush_thresholds();
+  test_flush_periodic();
+  test_fsync_power_loss();
+  test_fsync_count();
+  test_card_full();
+  fat_image_unmount();
+  printf( "sd_logger_test: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/**
+ * @brief time() of sd_logger.c, linked with -Wl,--wrap=time
+ */
+time_t __wrap_time( time_t *t )
+{
+  if( t != NULL )
+  {
+    *t = test_now;
+  }
+  return test_now;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Files are closed when they reach rotate_bytes, the flushes are full
+ *        sectors so every file but the last one has exactly this size
+ */
+static void test_rotation_size( void )
+{
+  sd_logger_config_t config = test_config();
+  sd_logger_stats_t stats;
+  fat_image_stats_t fat_stats;
+  uint32_t lines = 40000u;                  // 320000 bytes, 4 files of 64 KB and the rest
+  uint32_t per_file = 65536u / TEST_LINE_SIZE;
+  char name[16];
+  uint32_t idx = 0;
+
+  CHECK( test_volume( TEST_IMAGE_SIZE ) );
+  config.rotate_bytes = 65536u;
+  CHECK( sd_logger_start( &config ) == ESP_OK );
+  CHECK( strcmp( sd_logger_get_file_name(), SD_LOGGER_DIR"/26101900.CSV" ) == 0 );
+  test_write_lines( 0, lines );
+  CHECK( sd_logger_stop() == ESP_OK );
+  sd_logger_get_stats( &stats );
+  fat_image_get_stats( &fat_stats );
+
+  CHECK( stats.files == 5u );
+  CHECK( stats.bytes_written == (uint64_t)lines * TEST_LINE_SIZE );
+  // 39 buffers of 8 KB and the rest at stop
+  CHECK( stats.writes == 40u );
+  CHECK( stats.dropped == 0u );
+  CHECK( fat_stats.max_open == 1u );
+  for( idx = 0; idx < 5u; idx++ )
+  {
+    snprintf( name, sizeof(name), "26101900.CSV" );
+    name[7] = (char)('0' + idx);
+    CHECK( test_file_size( name ) == (long)((idx < 4u) ? 65536u : (lines - 4u * per_file) * TEST_LINE_SIZE) );
+    CHECK( test_file_lines( name, idx * per_file, (idx < 4u) ? per_file : (lines - 4u * per_file) ) );
+  }
+  CHECK( test_file_size( "26101905.CSV" ) < 0 );
+  test_check_volume( 0 );
+}
+
+/**
+ * @brief A new file is started at the first flush after midnight, and a new
+ *        start on the same day takes the next sequence number
+ */
+static void test_rotation_daily( void )
+{
+  sd_logger_config_t config = test_config();
+
+  CHECK( test_volume( TEST_IMAGE_SIZE ) );
+  config.rotate_bytes = 0;
+  config.rotate_daily = true;
+  test_now = TEST_MIDNIGHT - 60;
+  CHECK( sd_logger_start( &config ) == ESP_OK );
+  test_write_lines( 0, 1000 );
+  CHECK( sd_logger_flush() == ESP_OK );
+  test_now = TEST_MIDNIGHT + 5;
+  test_write_lines( 1000, 1500 );
+  CHECK( strcmp( sd_logger_get_file_name(), SD_LOGGER_DIR"/26102000.CSV" ) == 0 );
+  CHECK( sd_logger_stop() == ESP_OK );
+
+  CHECK( test_file_size( "26101900.CSV" ) == 1000 * TEST_LINE_SIZE );
+  CHECK( test_file_lines( "26101900.CSV", 0, 1000 ) );
+  CHECK( test_file_size( "26102000.CSV" ) == 1500 * TEST_LINE_SIZE );
+  CHECK( test_file_lines( "26102000.CSV", 1000, 1500 ) );
+
+  // the files of today are kept, the next start uses a new name
+  CHECK( sd_logger_start( &config ) == ESP_OK );
+  CHECK( strcmp( sd_logger_get_file_name(), SD_LOGGER_DIR"/26102001.CSV" ) == 0 );
+  CHECK( sd_logger_stop() == ESP_OK );
+  CHECK( test_file_size( "26102000.CSV" ) == 1500 * TEST_LINE_SIZE );
+  CHECK( test_file_size( "26102001.CSV" ) == 0 );
+  test_now = TEST_DAY1;
+  test_check_volume( 0 );
+}
+
+/**
+ * @brief Power loss with a pre-allocated file, on the card the file has the
+ *        allocated size and garbage after the data, the next start cuts it
+ *        to the length recorded after the last flush
+ */
+static void test_prealloc_recovery( void )
+{
+  sd_logger_config_t config = test_config();
+  fat_image_check_t check;
+
+  CHECK( test_volume( TEST_IMAGE_SIZE ) );
+  config.prealloc_bytes = TEST_FILE_MAX;
+  CHECK( test_run_child( test_child_prealloc, &config ) == 0 );
+
+  CHECK( fat_image_mount( TEST_IMAGE, MOUNT_POINT ) );
+  CHECK( test_file_size( "26101900.CSV" ) == TEST_FILE_MAX );
+  CHECK( test_file_size( "OPEN.TXT" ) > 0 );
+  // the allocated clusters belong to the file, the volume is consistent
+  CHECK( fat_image_check( &check ) );
+
+  CHECK( sd_logger_start( &config ) == ESP_OK );
+  CHECK( strcmp( sd_logger_get_file_name(), SD_LOGGER_DIR"/26101901.CSV" ) == 0 );
+  CHECK( sd_logger_stop() == ESP_OK );
+  CHECK( test_file_size( "26101900.CSV" ) == 3000 * TEST_LINE_SIZE );
+  CHECK( test_file_lines( "26101900.CSV", 0, 3000 ) );
+  CHECK( test_file_size( "26101901.CSV" ) == 0 );
+  CHECK( test_file_size( "OPEN.TXT" ) < 0 );
+  test_check_volume( 0 );
+  // LOG directory and the 24000 bytes, the pre-allocation is given back
+  CHECK( fat_image_check( &check ) && (check.used_clusters == 1u + 6u) );
+}
+
+/**
+ * @brief Only full sectors are written when flush_bytes is reached, the rest
+ *        stays in the buffer till an explicit flush
+ */
+static void test_flush_thresholds( void )
+{
+  sd_logger_config_t config = test_config();
+  sd_logger_stats_t stats;
+
+  CHECK( test_volume( TEST_IMAGE_SIZE ) );
+  config.buffer_size = 16384;
+  config.flush_bytes = 8192;
+  CHECK( sd_logger_start( &config ) == ESP_OK );
+
+  test_write_lines( 0, 1023 );
+  sd_logger_get_stats( &stats );
+  CHECK( stats.writes == 0u );
+  test_write_lines( 1023, 2 );
+  sd_logger_get_stats( &stats );
+  CHECK( (stats.writes == 1u) && (stats.bytes_written == 8192u) );
+  CHECK( sd_logger_flush() == ESP_OK );
+  sd_logger_get_stats( &stats );
+  CHECK( (stats.writes == 2u) && (stats.bytes_written == 1025u * TEST_LINE_SIZE) );
+  CHECK( sd_logger_stop() == ESP_OK );
+  CHECK( test_file_lines( "26101900.CSV", 0, 1025 ) );
+  test_check_volume( 0 );
+}
+
+/**
+ * @brief With a low rate the task flushes the buffer every flush_ms
+ */
+static void test_flush_periodic( void )
+{
+  sd_logger_config_t config = test_config();
+  sd_logger_stats_t stats;
+  struct timespec wait = { .tv_sec = 0, .tv_nsec = 350000000L };
+
+  CHECK( test_volume( TEST_IMAGE_SIZE ) );
+  config.flush_ms = 100;
+  CHECK( sd_logger_start( &config ) == ESP_OK );
+  test_write_lines( 0, 10 );
+  nanosleep( &wait, NULL );
+  sd_logger_get_stats( &stats );
+  CHECK( (stats.writes == 1u) && (stats.bytes_written == 10u * TEST_LINE_SIZE) );
+  test_write_lines( 10, 10 );
+  nanosleep( &wait, NULL );
+  sd_logger_get_stats( &stats );
+  CHECK( (stats.writes == 2u) && (stats.bytes_written == 20u * TEST_LINE_SIZE) );
+  // stop deletes the task, it must not be left holding the logger mutex
+  CHECK( sd_logger_stop() == ESP_OK );
+  CHECK( test_file_lines( "26101900.CSV", 0, 20 ) );
+  test_check_volume( 0 );
+}
+
+/**
+ * @brief Power loss after a flush, the rotated file is complete with every
+ *        policy, the open file only with SD_LOGGER_FSYNC_ON_FLUSH, else its
+ *        directory entry is still empty and its clusters are lost
+ */
+static void test_fsync_power_loss( void )
+{
+  sd_logger_config_t config = test_config();
+  sd_logger_fsync_t policy = SD_LOGGER_FSYNC_NONE;
+  fat_image_check_t check;
+
+  for( policy = SD_LOGGER_FSYNC_NONE; policy <= SD_LOGGER_FSYNC_ON_ROTATE; policy++ )
+  {
+    CHECK( test_volume( TEST_IMAGE_SIZE ) );
+    config.fsync_policy = policy;
+    config.rotate_bytes = 16384;
+    CHECK( test_run_child( test_child_fsync, &config ) == 0 );
+
+    CHECK( fat_image_mount( TEST_IMAGE, MOUNT_POINT ) );
+    CHECK( test_file_size( "26101900.CSV" ) == 16384 );
+    CHECK( test_file_lines( "26101900.CSV", 0, 2048 ) );
+    if( policy == SD_LOGGER_FSYNC_ON_FLUSH )
+    {
+      CHECK( test_file_size( "26101901.CSV" ) == (3000 - 2048) * TEST_LINE_SIZE );
+      CHECK( test_file_lines( "26101901.CSV", 2048, 3000 - 2048 ) );
+      test_check_volume( 0 );
+    }
+    else
+    {
+      CHECK( test_file_size( "26101901.CSV" ) == 0 );
+      CHECK( !fat_image_check( &check ) && (check.lost_clusters == 2u) );
+    }
+  }
+}
+
+/**
+ * @brief Number of directory entry syncs of every policy, this is the cost
+ *        of the policies on the card
+ */
+static void test_fsync_count( void )
+{
+  sd_logger_config_t config = test_config();
+  sd_logger_stats_t stats;
+  fat_image_stats_t fat_stats;
+  sd_logger_fsync_t policy = SD_LOGGER_FSYNC_NONE;
+
+  for( policy = SD_LOGGER_FSYNC_NONE; policy <= SD_LOGGER_FSYNC_ON_ROTATE; policy++ )
+  {
+    CHECK( test_volume( TEST_IMAGE_SIZE ) );
+    config.fsync_policy = policy;
+    config.rotate_bytes = 65536;
+    CHECK( sd_logger_start( &config ) == ESP_OK );
+    test_write_lines( 0, 40000 );
+    CHECK( sd_logger_stop() == ESP_OK );
+    sd_logger_get_stats( &stats );
+    fat_image_get_stats( &fat_stats );
+    printf( "  fsync policy %d: %u writes, %u files, %u fsync\n", (int)policy, (unsigned)stats.writes, \
+            (unsigned)stats.files, (unsigned)fat_stats.syncs );
+    if( policy == SD_LOGGER_FSYNC_NONE )
+    {
+      CHECK( fat_stats.syncs == 0u );
+    }
+    else if( policy == SD_LOGGER_FSYNC_ON_FLUSH )
+    {
+      // every flush, and once more when the file is closed
+      CHECK( fat_stats.syncs == (stats.writes + stats.files) );
+    }
+    else
+    {
+      CHECK( fat_stats.syncs == stats.files );
+    }
+    test_check_volume( 0 );
+  }
+}
+
+/**
+ * @brief The card gets full, the logger keeps accepting data and drops what
+ *        doesn't fit, what was written is intact
+ */
+static void test_card_full( void )
+{
+  sd_logger_config_t config = test_config();
+  sd_logger_stats_t stats;
+  uint32_t free_bytes = 0;
+  uint32_t lines = 0;
+
+  CHECK( test_volume( TEST_SMALL_IMAGE_SIZE ) );
+  config.rotate_bytes = 0;
+  free_bytes = (fat_image_free_clusters() - 1u) * FAT_IMAGE_CLUSTER_SIZE;    // LOG directory
+  lines = (free_bytes + 256u * 1024u) / TEST_LINE_SIZE;
+  CHECK( sd_logger_start( &config ) == ESP_OK );
+  test_write_lines( 0, lines );
+  // the last buffer may have been dropped already, then stop has nothing to write
+  sd_logger_stop();
+  sd_logger_get_stats( &stats );
+  CHECK( stats.bytes_written == free_bytes );
+  CHECK( stats.dropped >= (lines * TEST_LINE_SIZE - free_bytes - config.buffer_size) );
+  CHECK( test_file_size( "26101900.CSV" ) == (long)free_bytes );
+  CHECK( fat_image_free_clusters() == 0u );
+  test_check_volume( 0 );
+}
+
+/**
+ * @brief Format and mount a new image
+ * @param size image size
+ * @return true if successful else false
+ */
+static bool test_volume( uint32_t size )
+{
+  fat_image_unmount();
+  return ( fat_image_format( TEST_IMAGE, size ) && fat_image_mount( TEST_IMAGE, MOUNT_POINT ) );
+}
+
+/**
+ * @brief Logger configuration of the cases, they change what they test
+ * @return configuration
+ */
+static sd_logger_config_t test_config( void )
+{
+  sd_logger_config_t config = SD_LOGGER_CONFIG_DEFAULT();
+
+  config.buffer_size = 8192;
+  config.flush_bytes = 8192;
+  config.flush_ms = 0;
+  config.fsync_policy = SD_LOGGER_FSYNC_ON_ROTATE;
+  config.rotate_daily = false;
+  return config;
+}
+
+/**
+ * @brief Log numbered lines of TEST_LINE_SIZE bytes, one write per line
+ * @param first number of the first line
+ * @param count number of lines
+ */
+static void test_write_lines( uint32_t first, uint32_t count )
+{
+  char line[TEST_LINE_SIZE + 1];
+  uint32_t idx = 0;
+
+  for( idx = first; idx < (first + count); idx++ )
+  {
+    // 7 digits and the line break, the line number wraps at 10 million
+    snprintf( line, sizeof(line), "%07u\n", (unsigned)(idx % 10000000u) );
+    sd_logger_write( line, TEST_LINE_SIZE );
+  }
+}
+
+/**
+ * @brief Size of a file in the log directory, from its directory entry
+ * @param name 8.3 file name
+ * @return size, -1 if the file doesn't exist
+ */
+static long test_file_size( const char *name )
+{
+  char path[SD_LOGGER_PATH_LEN];
+  struct stat st;
+
+  snprintf( path, sizeof(path), SD_LOGGER_DIR"/%s", name );
+  return ( fat_stat( path, &st ) == 0 ) ? (long)st.st_size : -1;
+}
+
+/**
+ * @brief Check that a file holds exactly the given lines
+ * @param name 8.3 file name in the log directory
+ * @param first number of the first line
+ * @param count number of lines
+ * @return true if the content matches else false
+ */
+static bool test_file_lines( const char *name, uint32_t first, uint32_t count )
+{
+  char path[SD_LOGGER_PATH_LEN];
+  char line[TEST_LINE_SIZE + 1];
+  ssize_t len = 0;
+  uint32_t idx = 0;
+  int fd = -1;
+
+  snprintf( path, sizeof(path), SD_LOGGER_DIR"/%s", name );
+  fd = fat_open( path, O_RDONLY );
+  if( fd < 0 )
+  {
+    return false;
+  }
+  len = fat_read( fd, test_data, sizeof(test_data) );
+  fat_close( fd );
+  if( len != (ssize_t)(count * TEST_LINE_SIZE) )
+  {
+    return false;
+  }
+  for( idx = 0; idx < count; idx++ )
+  {
+    snprintf( line, sizeof(line), "%07u\n", (unsigned)(first + idx) );
+    if( memcmp( &test_data[idx * TEST_LINE_SIZE], line, TEST_LINE_SIZE ) != 0 )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Check the FAT of the mounted image
+ * @param lost expected lost clusters
+ */
+static void test_check_volume( uint32_t lost )
+{
+  fat_image_check_t check;
+
+  CHECK( fat_image_check( &check ) == (lost == 0) );
+  CHECK( (check.lost_clusters == lost) && (check.bad_chains == 0) && (check.cross_links == 0) );
+}
+
+/**
+ * @brief Run a logger session in a child process, which ends without stopping
+ *        the logger, that is the power loss
+ * @param child session
+ * @param arg argument of session
+ * @return exit status of the child
+ */
+static int test_run_child( void (*child)( const void * ), const void *arg )
+{
+  pid_t pid = 0;
+  int status = -1;
+
+  fflush( stdout );
+  fat_image_unmount();
+  pid = fork();
+  if( pid == 0 )
+  {
+    // the exit status tells the failures of the child only
+    test_failed = 0;
+    if( !fat_image_mount( TEST_IMAGE, MOUNT_POINT ) )
+    {
+      _exit( 2 );
+    }
+    child( arg );
+    fflush( stdout );
+    _exit( test_failed ? 1 : 0 );
+  }
+  if( (pid < 0) || (waitpid( pid, &status, 0 ) != pid) )
+  {
+    return -1;
+  }
+  return WIFEXITED( status ) ? WEXITSTATUS( status ) : -1;
+}
+
+/**
+ * @brief 3000 lines are flushed, 500 more are in the buffer at power loss
+ * @param arg logger configuration
+ */
+static void test_child_prealloc( const void *arg )
+{
+  CHECK( sd_logger_start( (const sd_logger_config_t *)arg ) == ESP_OK );
+  test_write_lines( 0, 3000 );
+  CHECK( sd_logger_flush() == ESP_OK );
+  test_write_lines( 3000, 500 );
+}
+
+/**
+ * @brief 2048 lines go to the first file which is rotated, 952 lines are
+ *        flushed to the second one before the power loss
+ * @param arg logger configuration
+ */
+static void test_child_fsync( const void *arg )
+{
+  CHECK( sd_logger_start( (const sd_logger_config_t *)arg ) == ESP_OK );
+  test_write_lines( 0, 3000 );
+  CHECK( sd_logger_flush() == ESP_OK );
+}
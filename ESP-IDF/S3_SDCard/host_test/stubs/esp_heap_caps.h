@@ -0,0 +1,16 @@
+/*
+ * esp_heap_caps.h
+ *
+ * Host build stub, every allocation is DMA capable
+ */
+#ifndef ESP_HEAP_CAPS_H_
+#define ESP_HEAP_CAPS_H_
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_DMA                      (1u << 3)
+
+#define heap_caps_aligned_alloc( align, size, caps )  aligned_alloc( (align), (size) )
+#define heap_caps_free( ptr )                         free( ptr )
+
+#endif /* ESP_HEAP_CAPS_H_ */
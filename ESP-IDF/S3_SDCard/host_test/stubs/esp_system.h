@@ -0,0 +1,12 @@
+/*
+ * esp_system.h
+ *
+ * Host build stub, sd_logger.h only needs esp_err_t from it
+ */
+#ifndef ESP_SYSTEM_H_
+#define ESP_SYSTEM_H_
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#endif /* ESP_SYSTEM_H_ */
@@ -0,0 +1,11 @@
+/*
+ * sdmmc_cmd.h
+ *
+ * Host build stub, the card is a FAT image file, see fat_image.c
+ */
+#ifndef SDMMC_CMD_H_
+#define SDMMC_CMD_H_
+
+typedef struct _sdmmc_card_t sdmmc_card_t;
+
+#endif /* SDMMC_CMD_H_ */
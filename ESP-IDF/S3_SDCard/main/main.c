@@ -6,6 +6,7 @@
 
 #include "esp_log.h"
 #include "sd_mng.h"
+#include "sd_logger.h"
 
 // macros
 
@@ -19,6 +20,21 @@ void app_main( void )
   char file_data[SD_MAX_CHAR_SIZE] = { 0 };
 
   sd_mng_init();    // initialize the sd card and mount fat file system
+
+#ifdef CONFIG_SD_RUN_BENCHMARK
+  const size_t bench_block_sizes[] = { 4*1024, 16*1024, 64*1024 };
+  sd_mng_bench_config_t bench_config = SD_MNG_BENCH_CONFIG_DEFAULT();
+  sd_mng_bench_report_t bench_report;
+  for( uint8_t idx = 0; idx < sizeof(bench_block_sizes)/sizeof(bench_block_sizes[0]); idx++ )
+  {
+    bench_config.block_size = bench_block_sizes[idx];
+    if( sd_mng_bench( &bench_config, &bench_report ) == ESP_OK )
+    {
+      sd_mng_bench_print( &bench_config, &bench_report );
+    }
+  }
+#endif
+
   const char *filename = MOUNT_POINT"/parties.txt";
   FILE *write_file = fopen( filename, "w" );
   if( write_file == NULL )
@@ -51,6 +67,24 @@ void app_main( void )
       idx++;
       ESP_LOGI( TAG, "%d -> %s", idx, file_data );
     }
+    fclose( read_file );
+  }
+
+  // streaming logger, file is kept open and data is written in large blocks
+  sd_logger_config_t logger_config = SD_LOGGER_CONFIG_DEFAULT();
+  if( sd_logger_start( &logger_config ) == ESP_OK )
+  {
+    char line[SD_MAX_CHAR_SIZE];
+    sd_logger_stats_t stats;
+    for( uint32_t count = 0; count < 10000; count++ )
+    {
+      int len = snprintf( line, sizeof(line), "%lu,%d,%d\n", count, (int)(count % 50), (int)(count % 100) );
+      sd_logger_write( line, len );
+    }
+    sd_logger_stop();
+    sd_logger_get_stats( &stats );
+    ESP_LOGI( TAG, "Logged %llu bytes to %s, %.2f MB/s, max latency %lu us", \
+              stats.bytes_written, sd_logger_get_file_name(), sd_logger_get_throughput(), stats.max_latency_us );
   }
   sd_mng_unmount_card();
 }
@@ -0,0 +1,506 @@
+/*
+ * sd_logger.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Streaming data logger on top of sd_mng. The file is kept open and the data
+ * is collected in a large DMA capable buffer, which is written to the card in
+ * multiples of the FATFS sector size, this way FATFS writes directly to the
+ * card instead of copying every byte through its sector window. The buffer is
+ * flushed when it has flush_bytes, or periodically by the logger task. Files
+ * are rotated by size and/or by date, FATFS is configured without long file
+ * names, hence the names are 8.3 i.e. YYMMDDnn.CSV inside SD_LOGGER_DIR.
+ * Only POSIX file functions are used, hence it can run on the host against a
+ * mounted FATFS image.
+ * With pre-allocation the file size is the allocated size until the file is
+ * closed, so the valid length is recorded in SD_LOGGER_MARK_FILE after every
+ * flush. If the logger was not stopped (reset, power loss) the next start
+ * truncates that file to the recorded length and the unwritten tail is gone.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+#include "sd_mng.h"
+#include "sd_logger.h"
+
+// macros
+#define SD_LOGGER_SECTOR_SIZE             (4096u)   // CONFIG_FATFS_SECTOR_4096
+#define SD_LOGGER_BUF_ALIGN               (32u)
+#define SD_LOGGER_MAX_FILES_PER_DAY       (100u)
+#define SD_LOGGER_TASK_STACK              (4096u)
+#define SD_LOGGER_TASK_PRIORITY           (4u)
+#define SD_LOGGER_MARK_FILE               SD_LOGGER_DIR"/OPEN.TXT"
+
+// Private Variables
+static const char *TAG = "SD_LOGGER";
+static sd_logger_config_t logger_config;
+static sd_logger_stats_t logger_stats;
+static SemaphoreHandle_t logger_mutex = NULL;
+static TaskHandle_t logger_task_handle = NULL;
+static uint8_t *logger_buffer = NULL;
+static size_t logger_buf_len = 0;
+static int logger_fd = -1;
+static size_t logger_file_size = 0;
+static int logger_file_day = -1;
+static char logger_path[SD_LOGGER_PATH_LEN] = { 0 };
+
+// Private Function Prototypes
+static void sd_logger_task( void *pvParameters );
+static esp_err_t sd_logger_flush_locked( bool force );
+static esp_err_t sd_logger_open_file( void );
+static void sd_logger_close_file( void );
+static void sd_logger_mark( void );
+static void sd_logger_recover( void );
+static int sd_logger_today( struct tm *time_info );
+
+// Public Function Definition
+
+/**
+ * @brief Start the SD card logger, card must be mounted before this
+ * @param config logger configuration, use SD_LOGGER_CONFIG_DEFAULT()
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t sd_logger_start( const sd_logger_config_t *config )
+{
+  esp_err_t ret = ESP_OK;
+
+  if( logger_buffer != NULL )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  logger_config = *config;
+  // buffer is a multiple of sector size, so that full sectors are written
+  logger_config.buffer_size = ((logger_config.buffer_size + SD_LOGGER_SECTOR_SIZE - 1) / SD_LOGGER_SECTOR_SIZE) * SD_LOGGER_SECTOR_SIZE;
+  if( logger_config.buffer_size == 0 )
+  {
+    logger_config.buffer_size = SD_LOGGER_SECTOR_SIZE;
+  }
+  if( (logger_config.flush_bytes == 0) || (logger_config.flush_bytes > logger_config.buffer_size) )
+  {
+    logger_config.flush_bytes = logger_config.buffer_size;
+  }
+  memset( &logger_stats, 0x00, sizeof(logger_stats) );
+
+  logger_buffer = heap_caps_aligned_alloc( SD_LOGGER_BUF_ALIGN, logger_config.buffer_size, MALLOC_CAP_DMA );
+  if( logger_buffer == NULL )
+  {
+    ESP_LOGE(TAG, "Unable to allocate %u bytes write buffer", (unsigned)logger_config.buffer_size);
+    return ESP_ERR_NO_MEM;
+  }
+  logger_buf_len = 0;
+
+  logger_mutex = xSemaphoreCreateMutex();
+  sd_logger_recover();
+  ret = sd_logger_open_file();
+  if( ret != ESP_OK )
+  {
+    vSemaphoreDelete( logger_mutex );
+    logger_mutex = NULL;
+    heap_caps_free( logger_buffer );
+    logger_buffer = NULL;
+    return ret;
+  }
+
+  if( logger_config.flush_ms )
+  {
+    xTaskCreate(&sd_logger_task, "SD Logger Task", SD_LOGGER_TASK_STACK, NULL, SD_LOGGER_TASK_PRIORITY, &logger_task_handle);
+  }
+  return ret;
+}
+
+/**
+ * @brief Write data to the log, data is buffered and written later
+ * @param data data pointer
+ * @param len data length
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t sd_logger_write( const void *data, size_t len )
+{
+  esp_err_t ret = ESP_OK;
+  const uint8_t *ptr = (const uint8_t *)data;
+  size_t chunk = 0;
+
+  if( logger_buffer == NULL )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  xSemaphoreTake( logger_mutex, portMAX_DELAY );
+  while( len )
+  {
+    chunk = logger_config.buffer_size - logger_buf_len;
+    chunk = (chunk < len) ? chunk : len;
+    memcpy( &logger_buffer[logger_buf_len], ptr, chunk );
+    logger_buf_len += chunk;
+    ptr += chunk;
+    len -= chunk;
+    if( logger_buf_len >= logger_config.flush_bytes )
+    {
+      ret = sd_logger_flush_locked( false );
+      if( (ret != ESP_OK) && (logger_buf_len >= logger_config.buffer_size) )
+      {
+        // card is not accepting data, drop the buffer instead of blocking
+        logger_stats.dropped += logger_buf_len;
+        logger_buf_len = 0;
+      }
+    }
+  }
+  xSemaphoreGive( logger_mutex );
+  return ret;
+}
+
+/**
+ * @brief Write all the buffered data to the card
+ * @param  none
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t sd_logger_flush( void )
+{
+  esp_err_t ret = ESP_ERR_INVALID_STATE;
+  if( logger_buffer != NULL )
+  {
+    xSemaphoreTake( logger_mutex, portMAX_DELAY );
+    ret = sd_logger_flush_locked( true );
+    xSemaphoreGive( logger_mutex );
+  }
+  return ret;
+}
+
+/**
+ * @brief Flush the data, close the file and stop the logger
+ * @param  none
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t sd_logger_stop( void )
+{
+  esp_err_t ret = ESP_ERR_INVALID_STATE;
+  if( logger_buffer != NULL )
+  {
+    // task is deleted with mutex taken, so that it is not in middle of flush
+    xSemaphoreTake( logger_mutex, portMAX_DELAY );
+    if( logger_task_handle != NULL )
+    {
+      vTaskDelete( logger_task_handle );
+      logger_task_handle = NULL;
+    }
+    ret = sd_logger_flush_locked( true );
+    sd_logger_close_file();
+    heap_caps_free( logger_buffer );
+    logger_buffer = NULL;
+    xSemaphoreGive( logger_mutex );
+    vSemaphoreDelete( logger_mutex );
+    logger_mutex = NULL;
+  }
+  return ret;
+}
+
+/**
+ * @brief Get the logger statistics
+ * @param stats statistics output
+ */
+void sd_logger_get_stats( sd_logger_stats_t *stats )
+{
+  *stats = logger_stats;
+}
+
+/**
+ * @brief Get the write throughput, this is the time spent in writing to card
+ *        and not the rate at which data is logged
+ * @param  none
+ * @return throughput in MB/s
+ */
+float sd_logger_get_throughput( void )
+{
+  float throughput = 0.0f;
+  if( logger_stats.write_time_us )
+  {
+    // bytes per microsecond is same as mega bytes per second
+    throughput = (float)logger_stats.bytes_written / (float)logger_stats.write_time_us;
+  }
+  return throughput;
+}
+
+/**
+ * @brief Get the name of the file in use
+ * @param  none
+ * @return file path
+ */
+const char * sd_logger_get_file_name( void )
+{
+  return logger_path;
+}
+
+// Private Function Definitions
+
+/**
+ * @brief SD Logger task, flushes the buffer periodically so that the data
+ *        doesn't stay in RAM for long when logging rate is low
+ * @param pvParameters
+ */
+static void sd_logger_task( void *pvParameters )
+{
+  (void)pvParameters;
+  while( 1 )
+  {
+    vTaskDelay( logger_config.flush_ms / portTICK_PERIOD_MS );
+    // logger_buf_len is changed by the writer, check it under the mutex
+    xSemaphoreTake( logger_mutex, portMAX_DELAY );
+    if( logger_buf_len )
+    {
+      sd_logger_flush_locked( true );
+    }
+    xSemaphoreGive( logger_mutex );
+  }
+}
+
+/**
+ * @brief Write the buffered data to the card, mutex must be taken
+ * @param force if true all data is written, else only full sectors
+ * @return ESP_OK if successful else the error code
+ */
+static esp_err_t sd_logger_flush_locked( bool force )
+{
+  esp_err_t ret = ESP_OK;
+  size_t write_len = 0;
+  size_t done = 0;
+  ssize_t written = 0;
+  int64_t start_time = 0;
+  uint32_t latency = 0;
+  struct tm time_info;
+
+  // start a new file on date change
+  if( logger_config.rotate_daily && (logger_file_day >= 0) && \
+      (sd_logger_today( &time_info ) != logger_file_day) )
+  {
+    sd_logger_close_file();
+  }
+  if( logger_fd < 0 )
+  {
+    ret = sd_logger_open_file();
+    if( ret != ESP_OK )
+    {
+      return ret;
+    }
+  }
+
+  write_len = force ? logger_buf_len : ((logger_buf_len / SD_LOGGER_SECTOR_SIZE) * SD_LOGGER_SECTOR_SIZE);
+  if( write_len == 0 )
+  {
+    return ESP_OK;
+  }
+
+  start_time = esp_timer_get_time();
+  while( done < write_len )
+  {
+    written = write( logger_fd, &logger_buffer[done], write_len - done );
+    if( written <= 0 )
+    {
+      ESP_LOGE(TAG, "Write failed (%d)", errno);
+      ret = ESP_FAIL;
+      break;
+    }
+    done += (size_t)written;
+  }
+  if( (ret == ESP_OK) && (logger_config.fsync_policy == SD_LOGGER_FSYNC_ON_FLUSH) )
+  {
+    fsync( logger_fd );
+  }
+  latency = (uint32_t)(esp_timer_get_time() - start_time);
+
+  logger_stats.writes++;
+  logger_stats.bytes_written += done;
+  logger_stats.write_time_us += latency;
+  logger_stats.last_latency_us = latency;
+  if( latency > logger_stats.max_latency_us )
+  {
+    logger_stats.max_latency_us = latency;
+  }
+
+  // move the remaining data to start of buffer
+  memmove( logger_buffer, &logger_buffer[done], logger_buf_len - done );
+  logger_buf_len -= done;
+  logger_file_size += done;
+  if( done )
+  {
+    sd_logger_mark();
+  }
+
+  if( logger_config.rotate_bytes && (logger_file_size >= logger_config.rotate_bytes) )
+  {
+    sd_logger_close_file();
+  }
+  return ret;
+}
+
+/**
+ * @brief Open a new log file, the name is based on date and a sequence number
+ * @param  none
+ * @return ESP_OK if successful else the error code
+ */
+static esp_err_t sd_logger_open_file( void )
+{
+  struct tm time_info;
+  struct stat st;
+  uint8_t seq = 0;
+
+  if( (mkdir( SD_LOGGER_DIR, 0775 ) != 0) && (errno != EEXIST) )
+  {
+    ESP_LOGE(TAG, "Unable to create %s", SD_LOGGER_DIR);
+    return ESP_FAIL;
+  }
+
+  logger_file_day = sd_logger_today( &time_info );
+  for( seq = 0; seq < SD_LOGGER_MAX_FILES_PER_DAY; seq++ )
+  {
+    snprintf( logger_path, sizeof(logger_path), SD_LOGGER_DIR"/%02d%02d%02d%02u.CSV", \
+              time_info.tm_year % 100, time_info.tm_mon + 1, time_info.tm_mday, seq );
+    if( stat( logger_path, &st ) != 0 )
+    {
+      break;
+    }
+  }
+  if( seq >= SD_LOGGER_MAX_FILES_PER_DAY )
+  {
+    ESP_LOGE(TAG, "No free file name for today");
+    return ESP_FAIL;
+  }
+
+  logger_fd = open( logger_path, O_WRONLY | O_CREAT | O_TRUNC, 0664 );
+  if( logger_fd < 0 )
+  {
+    ESP_LOGE(TAG, "Failed to open %s", logger_path);
+    return ESP_FAIL;
+  }
+  // allocate the clusters in one go, file is truncated to actual size on close
+  if( logger_config.prealloc_bytes )
+  {
+    if( ftruncate( logger_fd, logger_config.prealloc_bytes ) != 0 )
+    {
+      ESP_LOGW(TAG, "Pre-allocation of %u bytes failed", (unsigned)logger_config.prealloc_bytes);
+    }
+    lseek( logger_fd, 0, SEEK_SET );
+  }
+  logger_file_size = 0;
+  sd_logger_mark();
+  logger_stats.files++;
+  ESP_LOGI(TAG, "Logging to %s", logger_path);
+  return ESP_OK;
+}
+
+/**
+ * @brief Close the log file in use
+ * @param  none
+ */
+static void sd_logger_close_file( void )
+{
+  if( logger_fd >= 0 )
+  {
+    if( logger_config.prealloc_bytes )
+    {
+      ftruncate( logger_fd, logger_file_size );
+    }
+    if( logger_config.fsync_policy != SD_LOGGER_FSYNC_NONE )
+    {
+      fsync( logger_fd );
+    }
+    close( logger_fd );
+    logger_fd = -1;
+    if( logger_config.prealloc_bytes )
+    {
+      // file has its real size now, nothing to recover
+      unlink( SD_LOGGER_MARK_FILE );
+    }
+  }
+}
+
+/**
+ * @brief Record the path and the valid length of the pre-allocated file in
+ *        use, this is the length restored by sd_logger_recover
+ * @param  none
+ */
+static void sd_logger_mark( void )
+{
+  char mark[SD_LOGGER_PATH_LEN + 16];
+  int fd = -1;
+  int len = 0;
+
+  if( logger_config.prealloc_bytes == 0 )
+  {
+    return;
+  }
+  // the mark must not cover data which is still in the FATFS sector buffer
+  fsync( logger_fd );
+  len = snprintf( mark, sizeof(mark), "%s %u\n", logger_path, (unsigned)logger_file_size );
+  fd = open( SD_LOGGER_MARK_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0664 );
+  if( fd < 0 )
+  {
+    ESP_LOGW(TAG, "Unable to write %s", SD_LOGGER_MARK_FILE);
+    return;
+  }
+  write( fd, mark, (size_t)len );
+  // close writes the directory entry, the mark is on the card after this
+  close( fd );
+}
+
+/**
+ * @brief Truncate the file left open by a reset or power loss to the length
+ *        recorded by sd_logger_mark, the tail after it was never written
+ * @param  none
+ */
+static void sd_logger_recover( void )
+{
+  char path[SD_LOGGER_PATH_LEN];
+  char mark[SD_LOGGER_PATH_LEN + 16];
+  unsigned valid_len = 0;
+  ssize_t len = 0;
+  int fd = open( SD_LOGGER_MARK_FILE, O_RDONLY );
+
+  if( fd < 0 )
+  {
+    // last logger was stopped, or pre-allocation is not used
+    return;
+  }
+  len = read( fd, mark, sizeof(mark) - 1 );
+  close( fd );
+  mark[(len > 0) ? len : 0] = '\0';
+  if( sscanf( mark, "%31s %u", path, &valid_len ) == 2 )
+  {
+    fd = open( path, O_WRONLY );
+    if( (fd >= 0) && (ftruncate( fd, valid_len ) == 0) )
+    {
+      ESP_LOGW(TAG, "%s was not closed, truncated to %u bytes", path, valid_len);
+    }
+    if( fd >= 0 )
+    {
+      close( fd );
+    }
+  }
+  unlink( SD_LOGGER_MARK_FILE );
+}
+
+/**
+ * @brief Get the current date
+ * @param time_info broken down local time output
+ * @return day of the year
+ */
+static int sd_logger_today( struct tm *time_info )
+{
+  time_t now = 0;
+  time( &now );
+  localtime_r( &now, time_info );
+  return time_info->tm_yday;
+}
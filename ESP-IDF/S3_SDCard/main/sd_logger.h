@@ -0,0 +1,67 @@
+/*
+ * sd_logger.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+
+#ifndef MAIN_SD_LOGGER_H_
+#define MAIN_SD_LOGGER_H_
+
+#include <unistd.h>
+#include <stdbool.h>
+#include "esp_system.h"
+
+// macros
+#define SD_LOGGER_DIR                   MOUNT_POINT"/LOG"
+#define SD_LOGGER_PATH_LEN              (32u)
+
+typedef enum {
+  SD_LOGGER_FSYNC_NONE = 0,             // leave it to FATFS, data is safe after file close
+  SD_LOGGER_FSYNC_ON_FLUSH,             // fsync after every buffer flush (safest, slowest)
+  SD_LOGGER_FSYNC_ON_ROTATE,            // fsync only when the file is rotated
+} sd_logger_fsync_t;
+
+typedef struct _sd_logger_config_t
+{
+  size_t            buffer_size;        // write buffer size, rounded to FATFS sector size
+  size_t            flush_bytes;        // flush when these many bytes are buffered
+  uint32_t          flush_ms;           // flush at least this often, 0 to disable
+  sd_logger_fsync_t fsync_policy;
+  size_t            rotate_bytes;       // start a new file after this size, 0 to disable
+  bool              rotate_daily;       // start a new file when date changes
+  size_t            prealloc_bytes;     // space allocated on file creation, 0 to disable
+} sd_logger_config_t;
+
+typedef struct _sd_logger_stats_t
+{
+  uint64_t bytes_written;
+  uint32_t writes;                      // number of flushes to the card
+  uint32_t files;                       // number of files created
+  uint32_t dropped;                     // bytes dropped because of write errors
+  uint64_t write_time_us;               // total time spent in write & fsync
+  uint32_t max_latency_us;              // worst single flush time
+  uint32_t last_latency_us;
+} sd_logger_stats_t;
+
+#define SD_LOGGER_CONFIG_DEFAULT()                    \
+{                                                     \
+  .buffer_size = 32 * 1024,                           \
+  .flush_bytes = 16 * 1024,                           \
+  .flush_ms = 5000,                                   \
+  .fsync_policy = SD_LOGGER_FSYNC_ON_ROTATE,          \
+  .rotate_bytes = 8 * 1024 * 1024,                    \
+  .rotate_daily = true,                               \
+  .prealloc_bytes = 0,                                \
+}
+
+// Public Function Definition
+esp_err_t sd_logger_start( const sd_logger_config_t *config );
+esp_err_t sd_logger_write( const void *data, size_t len );
+esp_err_t sd_logger_flush( void );
+esp_err_t sd_logger_stop( void );
+void sd_logger_get_stats( sd_logger_stats_t *stats );
+float sd_logger_get_throughput( void );
+const char * sd_logger_get_file_name( void );
+
+#endif /* MAIN_SD_LOGGER_H_ */
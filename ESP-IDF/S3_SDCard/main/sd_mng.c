@@ -8,15 +8,39 @@
 #include <sys/stat.h>
 #include "esp_vfs_fat.h"
 #include "sdmmc_cmd.h"
+#ifdef CONFIG_SD_BUS_SDMMC
+#include "driver/sdmmc_host.h"
+#endif
 #include "sd_mng.h"
 
 // macros
-// Pin assignments can be set in menuconfig, see "SD SPI Example Configuration" menu.
-// You can also change the pin assignments here by changing the following 4 lines.
+// Pin assignments can be set in menuconfig, see "SD Card Configuration" menu.
+// You can also change the pin assignments here by changing the following lines.
+#ifdef CONFIG_SD_BUS_SDMMC
+#define PIN_NUM_CMD             CONFIG_SD_PIN_CMD
+#define PIN_NUM_CLK             CONFIG_SD_PIN_SDMMC_CLK
+#define PIN_NUM_D0              CONFIG_SD_PIN_D0
+#ifdef CONFIG_SD_BUS_WIDTH_4
+#define SD_BUS_WIDTH            (4)
+#define PIN_NUM_D1              CONFIG_SD_PIN_D1
+#define PIN_NUM_D2              CONFIG_SD_PIN_D2
+#define PIN_NUM_D3              CONFIG_SD_PIN_D3
+#else
+#define SD_BUS_WIDTH            (1)
+#endif
+#else
 #define PIN_NUM_MISO            CONFIG_SD_PIN_MISO
 #define PIN_NUM_MOSI            CONFIG_SD_PIN_MOSI
 #define PIN_NUM_CLK             CONFIG_SD_PIN_CLK
 #define PIN_NUM_CS              CONFIG_SD_PIN_CS
+#endif
+// every file which can be open has a FIL object with a sector buffer, i.e.
+// 4 KB each with CONFIG_FATFS_SECTOR_4096, allocated at mount. The logger
+// uses two (log file and its OPEN.TXT mark), one more for the other files
+#define SD_MAX_OPEN_FILES       (3)
+// largest SPI DMA transaction, sized for a full FATFS sector plus the token
+// and CRC bytes, a larger value only costs more DMA descriptors
+#define SD_SPI_MAX_TRANSFER     (4096 + 64)
 
 // Private Variables
 static const char *TAG = "SD_MNG";
@@ -26,7 +50,12 @@ static esp_vfs_fat_sdmmc_mount_config_t mount_config;
 // By default, SD card frequency is initialized to SDMMC_FREQ_DEFAULT (20MHz)
 // For setting a specific frequency, use host.max_freq_khz (range 400kHz - 20MHz for SDSPI)
 // Example: for fixed frequency of 10MHz, use host.max_freq_khz = 10000;
+#ifdef CONFIG_SD_BUS_SDMMC
+// SDMMC host transfers multiple blocks per command (CMD18/CMD25) using DMA
+static sdmmc_host_t host = SDMMC_HOST_DEFAULT();
+#else
 static sdmmc_host_t host = SDSPI_HOST_DEFAULT();
+#endif
 
 // Private Function Prototypes
 // todo
@@ -50,7 +79,7 @@ esp_err_t sd_mng_init( void )
 #else
   mount_config.format_if_mount_failed = false;
 #endif
-  mount_config.max_files = 5;
+  mount_config.max_files = SD_MAX_OPEN_FILES;
   mount_config.allocation_unit_size = 16 * 1024;
   
   ESP_LOGI(TAG, "Initializing SD card");
@@ -59,6 +88,13 @@ esp_err_t sd_mng_init( void )
   // Note: esp_vfs_fat_sdmmc/sdspi_mount is all-in-one convenience functions.
   // Please check its source code and implement error recovery when developing
   // production applications.
+#ifdef CONFIG_SD_BUS_SDMMC
+  ESP_LOGI(TAG, "Using SDMMC peripheral, %d-bit bus", SD_BUS_WIDTH);
+#ifdef CONFIG_SD_HIGH_SPEED
+  // card is switched to high speed only if it supports it, else default speed
+  host.max_freq_khz = SDMMC_FREQ_HIGHSPEED;
+#endif
+#else
   ESP_LOGI(TAG, "Using SPI peripheral");
 
   spi_bus_config_t bus_cfg = 
@@ -68,7 +104,7 @@ esp_err_t sd_mng_init( void )
     .sclk_io_num = PIN_NUM_CLK,
     .quadwp_io_num = -1,
     .quadhd_io_num = -1,
-    .max_transfer_sz = 4000,
+    .max_transfer_sz = SD_SPI_MAX_TRANSFER,
   };
 
   ret = spi_bus_initialize(host.slot, &bus_cfg, SDSPI_DEFAULT_DMA);
@@ -77,12 +113,16 @@ esp_err_t sd_mng_init( void )
     ESP_LOGE(TAG, "Failed to initialize bus.");
     return ret;
   }
+#endif
 
   // mount the sd card
   ret = sd_mng_mount_card();
 
   // Card has been initialized, print its properties
-  sdmmc_card_print_info(stdout, card);
+  if( ret == ESP_OK )
+  {
+    sdmmc_card_print_info(stdout, card);
+  }
 
   return ret;
 }
@@ -94,12 +134,30 @@ esp_err_t sd_mng_mount_card( void )
 
   // This initializes the slot without card detect (CD) and write protect (WP) signals.
   // Modify slot_config.gpio_cd and slot_config.gpio_wp if your board has these signals.
+#ifdef CONFIG_SD_BUS_SDMMC
+  sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
+  slot_config.width = SD_BUS_WIDTH;
+  slot_config.clk = PIN_NUM_CLK;
+  slot_config.cmd = PIN_NUM_CMD;
+  slot_config.d0 = PIN_NUM_D0;
+#ifdef CONFIG_SD_BUS_WIDTH_4
+  slot_config.d1 = PIN_NUM_D1;
+  slot_config.d2 = PIN_NUM_D2;
+  slot_config.d3 = PIN_NUM_D3;
+#endif
+  // external pull-ups are still recommended, internal ones are weak
+  slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+
+  ESP_LOGI(TAG, "Mounting filesystem");
+  ret = esp_vfs_fat_sdmmc_mount(mount_point, &host, &slot_config, &mount_config, &card);
+#else
   sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT();
   slot_config.gpio_cs = PIN_NUM_CS;
   slot_config.host_id = host.slot;
 
   ESP_LOGI(TAG, "Mounting filesystem");
   ret = esp_vfs_fat_sdspi_mount(mount_point, &host, &slot_config, &mount_config, &card);
+#endif
 
   if (ret != ESP_OK) 
   {
@@ -127,12 +185,24 @@ esp_err_t sd_mng_unmount_card( void )
   esp_vfs_fat_sdcard_unmount(mount_point, card);
   ESP_LOGI(TAG, "Card unmounted");
 
+#ifndef CONFIG_SD_BUS_SDMMC
   //deinitialize the bus after all devices are removed
   spi_bus_free(host.slot);
+#endif
 
   return ESP_OK;
 }
 
+/**
+ * @brief Get the card information, valid only after mounting
+ * @param  None
+ * @return card pointer
+ */
+sdmmc_card_t * sd_mng_get_card( void )
+{
+  return card;
+}
+
 esp_err_t sd_mng_format_card( void )
 {
   esp_err_t ret;
@@ -160,7 +230,8 @@ esp_err_t sd_mng_write_file( const char *path, char *data )
     ESP_LOGE(TAG, "Failed to open file for writing");
     return ESP_FAIL;
   }
-  fprintf(f, data);
+  // data is not a format string, it may contain '%'
+  fputs(data, f);
   fclose(f);
   ESP_LOGI(TAG, "File written");
   return ESP_OK;
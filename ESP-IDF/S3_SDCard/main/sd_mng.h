@@ -10,16 +10,55 @@
 
 #include <unistd.h>
 #include "esp_system.h"
+#include "sdmmc_cmd.h"
 
 // macros
 #define SD_MAX_CHAR_SIZE            64
 #define MOUNT_POINT                 "/sdcard"
 
+// benchmark configuration and results
+typedef struct _sd_mng_bench_config_t
+{
+  const char  *path;                  // file used for benchmark, it is deleted at end
+  size_t      block_size;             // bytes per read/write call
+  size_t      file_size;              // bytes written/read in sequential test
+  uint16_t    random_ops;             // number of random reads/writes
+} sd_mng_bench_config_t;
+
+typedef struct _sd_mng_bench_result_t
+{
+  float     mb_per_s;
+  uint32_t  ops;
+  uint32_t  p50_us;                   // latency percentiles of one read/write call
+  uint32_t  p90_us;
+  uint32_t  p99_us;
+  uint32_t  max_us;
+} sd_mng_bench_result_t;
+
+typedef struct _sd_mng_bench_report_t
+{
+  sd_mng_bench_result_t seq_write;
+  sd_mng_bench_result_t seq_read;
+  sd_mng_bench_result_t rand_write;
+  sd_mng_bench_result_t rand_read;
+} sd_mng_bench_report_t;
+
+#define SD_MNG_BENCH_CONFIG_DEFAULT()         \
+{                                             \
+  .path = MOUNT_POINT"/BENCH.BIN",            \
+  .block_size = 16 * 1024,                    \
+  .file_size = 4 * 1024 * 1024,               \
+  .random_ops = 200,                          \
+}
+
 // Public Function Definition
 esp_err_t sd_mng_init( void );
 esp_err_t sd_mng_mount_card( void );
 esp_err_t sd_mng_unmount_card( void );
 esp_err_t sd_mng_format_card( void );
+sdmmc_card_t * sd_mng_get_card( void );
+esp_err_t sd_mng_bench( const sd_mng_bench_config_t *config, sd_mng_bench_report_t *report );
+void sd_mng_bench_print( const sd_mng_bench_config_t *config, const sd_mng_bench_report_t *report );
 esp_err_t sd_mng_write_file( const char *path, char *data );
 esp_err_t sd_mng_read_file( const char *path, char *data, uint8_t max_length );
 
@@ -0,0 +1,242 @@
+/*
+ * sd_mng_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * SD card throughput benchmark, this measures the sequential and random read/
+ * write speed through the file system (same path as the application uses) and
+ * the latency percentiles of every read/write call. Run it with different
+ * block sizes, cards and bus modes (SPI, SDMMC 1/4-bit) to select the best
+ * option for a deployment.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_heap_caps.h"
+
+#include "sd_mng.h"
+
+// macros
+#define SD_BENCH_BUF_ALIGN              (32u)
+#define SD_BENCH_MAX_SAMPLES            (1024u)
+
+typedef enum {
+  SD_BENCH_WRITE = 0,
+  SD_BENCH_READ,
+} sd_bench_dir_t;
+
+// Private Variables
+static const char *TAG = "SD_BENCH";
+
+// Private Function Prototypes
+static esp_err_t sd_mng_bench_run( int fd, sd_bench_dir_t dir, bool random, uint32_t ops, \
+                                   const sd_mng_bench_config_t *config, uint8_t *buffer, \
+                                   uint32_t *samples, sd_mng_bench_result_t *result );
+static int sd_mng_bench_compare( const void *a, const void *b );
+static uint32_t sd_mng_bench_percentile( const uint32_t *samples, uint32_t count, uint8_t percent );
+
+// Public Function Definition
+
+/**
+ * @brief Run the SD card benchmark, the card must be mounted
+ * @param config benchmark configuration, use SD_MNG_BENCH_CONFIG_DEFAULT()
+ * @param report benchmark results
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t sd_mng_bench( const sd_mng_bench_config_t *config, sd_mng_bench_report_t *report )
+{
+  esp_err_t ret = ESP_OK;
+  uint8_t *buffer = NULL;
+  uint32_t *samples = NULL;
+  uint32_t seq_ops = 0;
+  int fd = -1;
+
+  memset( report, 0x00, sizeof(sd_mng_bench_report_t) );
+  if( (config->block_size == 0) || (config->file_size < config->block_size) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  seq_ops = config->file_size / config->block_size;
+
+  // DMA capable buffer, so that the driver doesn't need a bounce buffer
+  buffer = heap_caps_aligned_alloc( SD_BENCH_BUF_ALIGN, config->block_size, MALLOC_CAP_DMA );
+  samples = malloc( SD_BENCH_MAX_SAMPLES * sizeof(uint32_t) );
+  if( (buffer == NULL) || (samples == NULL) )
+  {
+    ESP_LOGE(TAG, "Unable to allocate benchmark buffers");
+    ret = ESP_ERR_NO_MEM;
+    goto exit;
+  }
+  for( size_t idx = 0; idx < config->block_size; idx++ )
+  {
+    buffer[idx] = (uint8_t)idx;
+  }
+
+  fd = open( config->path, O_RDWR | O_CREAT | O_TRUNC, 0664 );
+  if( fd < 0 )
+  {
+    ESP_LOGE(TAG, "Unable to open %s", config->path);
+    ret = ESP_FAIL;
+    goto exit;
+  }
+
+  ret = sd_mng_bench_run( fd, SD_BENCH_WRITE, false, seq_ops, config, buffer, samples, &report->seq_write );
+  if( ret == ESP_OK )
+  {
+    ret = sd_mng_bench_run( fd, SD_BENCH_READ, false, seq_ops, config, buffer, samples, &report->seq_read );
+  }
+  if( ret == ESP_OK )
+  {
+    ret = sd_mng_bench_run( fd, SD_BENCH_WRITE, true, config->random_ops, config, buffer, samples, &report->rand_write );
+  }
+  if( ret == ESP_OK )
+  {
+    ret = sd_mng_bench_run( fd, SD_BENCH_READ, true, config->random_ops, config, buffer, samples, &report->rand_read );
+  }
+
+  close( fd );
+  unlink( config->path );
+
+exit:
+  heap_caps_free( buffer );
+  free( samples );
+  return ret;
+}
+
+/**
+ * @brief Print the benchmark results
+ * @param config benchmark configuration
+ * @param report benchmark results
+ */
+void sd_mng_bench_print( const sd_mng_bench_config_t *config, const sd_mng_bench_report_t *report )
+{
+  const char *names[] = { "seq write", "seq read", "rand write", "rand read" };
+  const sd_mng_bench_result_t *results[] = { &report->seq_write, &report->seq_read, \
+                                             &report->rand_write, &report->rand_read };
+
+  ESP_LOGI(TAG, "Block %u bytes, File %u bytes", (unsigned)config->block_size, (unsigned)config->file_size);
+  for( uint8_t idx = 0; idx < 4; idx++ )
+  {
+    ESP_LOGI(TAG, "%-10s: %6.2f MB/s, %4lu ops, p50 %6lu us, p90 %6lu us, p99 %6lu us, max %6lu us", \
+             names[idx], results[idx]->mb_per_s, results[idx]->ops, results[idx]->p50_us, \
+             results[idx]->p90_us, results[idx]->p99_us, results[idx]->max_us );
+  }
+}
+
+// Private Function Definitions
+
+/**
+ * @brief Run one benchmark pass
+ * @param fd benchmark file descriptor
+ * @param dir read or write
+ * @param random true for random block offsets else sequential
+ * @param ops number of read/write calls
+ * @param config benchmark configuration
+ * @param buffer data buffer of block size
+ * @param samples latency sample buffer (SD_BENCH_MAX_SAMPLES)
+ * @param result benchmark result output
+ * @return ESP_OK if successful else the error code
+ */
+static esp_err_t sd_mng_bench_run( int fd, sd_bench_dir_t dir, bool random, uint32_t ops, \
+                                   const sd_mng_bench_config_t *config, uint8_t *buffer, \
+                                   uint32_t *samples, sd_mng_bench_result_t *result )
+{
+  uint32_t blocks = config->file_size / config->block_size;
+  uint32_t stride = (ops + SD_BENCH_MAX_SAMPLES - 1) / SD_BENCH_MAX_SAMPLES;
+  uint32_t count = 0;
+  uint32_t latency = 0;
+  int64_t start_time = 0;
+  int64_t op_start = 0;
+  int64_t total_time = 0;
+  ssize_t len = 0;
+
+  if( ops == 0 )
+  {
+    return ESP_OK;
+  }
+  if( stride == 0 )
+  {
+    stride = 1;
+  }
+
+  lseek( fd, 0, SEEK_SET );
+  start_time = esp_timer_get_time();
+  for( uint32_t op = 0; op < ops; op++ )
+  {
+    op_start = esp_timer_get_time();
+    if( random )
+    {
+      lseek( fd, (off_t)(esp_random() % blocks) * config->block_size, SEEK_SET );
+    }
+    if( dir == SD_BENCH_WRITE )
+    {
+      len = write( fd, buffer, config->block_size );
+    }
+    else
+    {
+      len = read( fd, buffer, config->block_size );
+    }
+    if( len != (ssize_t)config->block_size )
+    {
+      ESP_LOGE(TAG, "%s failed at block %lu", (dir == SD_BENCH_WRITE) ? "Write" : "Read", op);
+      return ESP_FAIL;
+    }
+    latency = (uint32_t)(esp_timer_get_time() - op_start);
+    if( ((op % stride) == 0) && (count < SD_BENCH_MAX_SAMPLES) )
+    {
+      samples[count++] = latency;
+    }
+    if( latency > result->max_us )
+    {
+      result->max_us = latency;
+    }
+  }
+  // data must be on the card, else only the FATFS cache is measured
+  if( dir == SD_BENCH_WRITE )
+  {
+    fsync( fd );
+  }
+  total_time = esp_timer_get_time() - start_time;
+
+  qsort( samples, count, sizeof(uint32_t), sd_mng_bench_compare );
+  result->ops = ops;
+  result->mb_per_s = (float)((uint64_t)ops * config->block_size) / (float)total_time;
+  result->p50_us = sd_mng_bench_percentile( samples, count, 50 );
+  result->p90_us = sd_mng_bench_percentile( samples, count, 90 );
+  result->p99_us = sd_mng_bench_percentile( samples, count, 99 );
+  return ESP_OK;
+}
+
+/**
+ * @brief Compare function for qsort
+ */
+static int sd_mng_bench_compare( const void *a, const void *b )
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * @brief Get the percentile from sorted samples
+ * @param samples sorted samples
+ * @param count number of samples
+ * @param percent percentile
+ * @return sample value
+ */
+static uint32_t sd_mng_bench_percentile( const uint32_t *samples, uint32_t count, uint8_t percent )
+{
+  uint32_t idx = 0;
+  if( count == 0 )
+  {
+    return 0;
+  }
+  idx = ((count - 1) * percent + 50) / 100;
+  return samples[idx];
+}
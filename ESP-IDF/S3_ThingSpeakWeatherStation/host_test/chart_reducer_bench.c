@@ -0,0 +1,104 @@
+/*
+ * chart_reducer_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host benchmark of the chart reducer. Series of 100 points (the old RAM
+ * buffer), one day and seven days at the 60 s period and 1M points are
+ * appended one by one, like the GUI does for every new sample, and then
+ * rendered for the 800 pixel wide chart. The append cost per sample and the
+ * render cost must not grow with the history length.
+ *
+ *  make -C S3_ThingSpeakWeatherStation/host_test bench
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "chart_reducer.h"
+
+// Private Macros
+#define BENCH_CHART_POINTS                  (800u)
+#define BENCH_BUCKETS                       (BENCH_CHART_POINTS/CHART_REDUCER_POINTS_PER_BUCKET)
+#define BENCH_RENDER_ROUNDS                 (10000u)
+
+// Private Variables
+static chart_reducer_bucket_t bench_buckets[BENCH_BUCKETS];
+static int16_t bench_points[BENCH_CHART_POINTS];
+static volatile int32_t bench_sink = 0;
+
+static const struct
+{
+  const char  *name;
+  uint32_t    samples;
+} bench_series[] =
+{
+  { "100 samples",    100u      },
+  { "1 day, 60 s",    1440u     },
+  { "7 days, 60 s",   10080u    },
+  { "1M samples",     1000000u  },
+};
+
+// Private Function Declaration
+static double bench_now( void );
+static int16_t bench_sample( uint32_t idx );
+
+int main( void )
+{
+  chart_reducer_t reducer;
+  double start = 0.0;
+  double append_s = 0.0;
+  double render_s = 0.0;
+  size_t count = 0;
+
+  for( size_t series = 0; series < (sizeof(bench_series)/sizeof(bench_series[0])); series++ )
+  {
+    chart_reducer_init( &reducer, bench_buckets, BENCH_BUCKETS );
+    start = bench_now();
+    for( uint32_t idx = 0; idx < bench_series[series].samples; idx++ )
+    {
+      chart_reducer_append( &reducer, bench_sample( idx ) );
+    }
+    append_s = bench_now() - start;
+
+    start = bench_now();
+    for( uint32_t round = 0; round < BENCH_RENDER_ROUNDS; round++ )
+    {
+      count = chart_reducer_render( &reducer, bench_points, BENCH_CHART_POINTS );
+      bench_sink += bench_points[count - 1];
+    }
+    render_s = bench_now() - start;
+
+    printf( "%-14s append %6.2f ns/sample, render %4u points %7.2f us, span %6u samples/bucket, state %u bytes\n", \
+            bench_series[series].name, append_s * 1e9 / bench_series[series].samples, (unsigned)count, \
+            render_s * 1e6 / BENCH_RENDER_ROUNDS, (unsigned)reducer.bucket_span, \
+            (unsigned)(sizeof(chart_reducer_t) + sizeof(bench_buckets)) );
+  }
+  return EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Monotonic time in seconds
+ */
+static double bench_now( void )
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Temperature like sample, a daily triangle wave with some noise
+ * @param idx sample number, one per minute
+ * @return sample value
+ */
+static int16_t bench_sample( uint32_t idx )
+{
+  uint32_t minute = idx % 1440u;
+  int32_t day = (minute < 720u) ? (int32_t)minute : (int32_t)(1440u - minute);
+
+  return (int16_t)(15 + day / 60 + (int32_t)((idx * 2654435761u) >> 30));
+}
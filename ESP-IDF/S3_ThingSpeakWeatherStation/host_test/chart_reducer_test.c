@@ -0,0 +1,168 @@
+/*
+ * chart_reducer_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of the chart reducer, the rendered points are checked against a
+ * brute force min/max of the same series: the number of points never exceeds
+ * the chart width, the extremes of the whole history are always drawn and
+ * every bucket keeps the order in which its extremes occurred.
+ *
+ *  make -C S3_ThingSpeakWeatherStation/host_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chart_reducer.h"
+
+// Private Macros
+#define TEST_CHART_POINTS                   (800u)
+#define TEST_BUCKETS                        (TEST_CHART_POINTS/CHART_REDUCER_POINTS_PER_BUCKET)
+#define TEST_SERIES_MAX                     (100000u)
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond );   \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+// Private Variables
+static chart_reducer_bucket_t test_buckets[TEST_BUCKETS];
+static int16_t test_points[TEST_CHART_POINTS];
+static int16_t test_series[TEST_SERIES_MAX];
+static int test_failed = 0;
+
+// Private Function Declaration
+static void test_short_history( void );
+static void test_long_history( void );
+static void test_order( void );
+static void test_load( void );
+
+int main( void )
+{
+  test_short_history();
+  test_long_history();
+  test_order();
+  test_load();
+  printf( "chart_reducer_test: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Less samples than buckets, every sample is drawn as it is
+ */
+static void test_short_history( void )
+{
+  chart_reducer_t reducer;
+  size_t count = 0;
+
+  chart_reducer_init( &reducer, test_buckets, TEST_BUCKETS );
+  for( int16_t idx = 0; idx < 100; idx++ )
+  {
+    chart_reducer_append( &reducer, idx );
+  }
+  count = chart_reducer_render( &reducer, test_points, TEST_CHART_POINTS );
+  CHECK( count == 200 );
+  CHECK( reducer.bucket_span == 1 );
+  for( size_t idx = 0; idx < count; idx++ )
+  {
+    CHECK( test_points[idx] == (int16_t)(idx / 2) );
+  }
+}
+
+/**
+ * @brief Every series length up to TEST_SERIES_MAX, the extremes of the
+ *        whole history must be in the chart and the chart never gets wider
+ */
+static void test_long_history( void )
+{
+  chart_reducer_t reducer;
+  uint32_t seed = 12345u;
+  int16_t min = INT16_MAX;
+  int16_t max = INT16_MIN;
+  int16_t drawn_min = INT16_MAX;
+  int16_t drawn_max = INT16_MIN;
+  size_t count = 0;
+
+  chart_reducer_init( &reducer, test_buckets, TEST_BUCKETS );
+  for( uint32_t idx = 0; idx < TEST_SERIES_MAX; idx++ )
+  {
+    seed = seed * 1103515245u + 12345u;
+    test_series[idx] = (int16_t)(20 + (int32_t)((seed >> 16) % 31u) - 15);
+    chart_reducer_append( &reducer, test_series[idx] );
+    min = (test_series[idx] < min) ? test_series[idx] : min;
+    max = (test_series[idx] > max) ? test_series[idx] : max;
+    if( (idx % 997u) == 0 )
+    {
+      count = chart_reducer_render( &reducer, test_points, TEST_CHART_POINTS );
+      CHECK( count <= TEST_CHART_POINTS );
+      CHECK( reducer.count <= TEST_BUCKETS );
+    }
+  }
+  CHECK( reducer.total == TEST_SERIES_MAX );
+  CHECK( ((uint64_t)reducer.count * reducer.bucket_span) >= TEST_SERIES_MAX );
+  count = chart_reducer_render( &reducer, test_points, TEST_CHART_POINTS );
+  for( size_t idx = 0; idx < count; idx++ )
+  {
+    drawn_min = (test_points[idx] < drawn_min) ? test_points[idx] : drawn_min;
+    drawn_max = (test_points[idx] > drawn_max) ? test_points[idx] : drawn_max;
+  }
+  CHECK( (drawn_min == min) && (drawn_max == max) );
+}
+
+/**
+ * @brief A rising and then falling series, after folding the maximum of the
+ *        middle bucket must still be drawn before the minimum after it
+ */
+static void test_order( void )
+{
+  chart_reducer_t reducer;
+  chart_reducer_bucket_t buckets[4];
+  int16_t points[8];
+  size_t count = 0;
+
+  chart_reducer_init( &reducer, buckets, 4 );
+  // 5 samples in 4 buckets, the first 4 are merged in pairs
+  chart_reducer_append( &reducer, 1 );
+  chart_reducer_append( &reducer, 9 );
+  chart_reducer_append( &reducer, 8 );
+  chart_reducer_append( &reducer, 0 );
+  chart_reducer_append( &reducer, 5 );
+  count = chart_reducer_render( &reducer, points, 8 );
+  CHECK( count == 6 );
+  CHECK( (points[0] == 1) && (points[1] == 9) );
+  CHECK( (points[2] == 8) && (points[3] == 0) );
+  CHECK( (points[4] == 5) && (points[5] == 5) );
+}
+
+/**
+ * @brief Loading a buffer gives the same chart as appending it
+ */
+static void test_load( void )
+{
+  chart_reducer_t appended;
+  chart_reducer_t loaded;
+  chart_reducer_bucket_t other[TEST_BUCKETS];
+  static uint8_t history[5000];
+  static int16_t points[TEST_CHART_POINTS];
+  size_t count = 0;
+
+  chart_reducer_init( &appended, test_buckets, TEST_BUCKETS );
+  chart_reducer_init( &loaded, other, TEST_BUCKETS );
+  for( size_t idx = 0; idx < sizeof(history); idx++ )
+  {
+    history[idx] = (uint8_t)((idx * 7u) % 60u);
+    chart_reducer_append( &appended, (int16_t)history[idx] );
+  }
+  chart_reducer_load( &loaded, history, sizeof(history) );
+  count = chart_reducer_render( &appended, test_points, TEST_CHART_POINTS );
+  CHECK( count == chart_reducer_render( &loaded, points, TEST_CHART_POINTS ) );
+  CHECK( memcmp( test_points, points, count * sizeof(int16_t) ) == 0 );
+}
@@ -0,0 +1,178 @@
+/*
+ * chart_reducer.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * The chart can only show one value per horizontal pixel, hence a long history
+ * is folded into a fixed number of min/max buckets. When all the buckets are
+ * used, neighbouring buckets are merged in pairs and the bucket span is doubled,
+ * so appending a sample is O(1) (amortized) and rendering depends only on the
+ * chart width and not on the length of the history.
+ */
+#include "chart_reducer.h"
+
+// Private Function Declaration
+static void chart_reducer_compact( chart_reducer_t *reducer );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the chart reducer
+ * @param reducer pointer to reducer object
+ * @param buckets bucket storage, it's size decides the maximum number of points
+ * @param capacity number of buckets in bucket storage, odd values are rounded
+ *        down, because buckets are merged in pairs
+ */
+void chart_reducer_init( chart_reducer_t *reducer, chart_reducer_bucket_t *buckets, uint16_t capacity )
+{
+  reducer->buckets = buckets;
+  reducer->capacity = capacity & ~((uint16_t)1u);
+  chart_reducer_reset( reducer );
+}
+
+/**
+ * @brief Remove all the samples from the reducer
+ * @param reducer pointer to reducer object
+ */
+void chart_reducer_reset( chart_reducer_t *reducer )
+{
+  reducer->count = 0;
+  reducer->bucket_span = 1;
+  reducer->bucket_fill = 0;
+  reducer->total = 0;
+}
+
+/**
+ * @brief Append a new sample to the reducer
+ * @param reducer pointer to reducer object
+ * @param value sample value
+ */
+void chart_reducer_append( chart_reducer_t *reducer, int16_t value )
+{
+  chart_reducer_bucket_t *bucket;
+
+  if( reducer->capacity == 0 )
+  {
+    return;
+  }
+
+  if( (reducer->count == 0) || (reducer->bucket_fill >= reducer->bucket_span) )
+  {
+    // last bucket is full, start a new one
+    if( reducer->count >= reducer->capacity )
+    {
+      chart_reducer_compact( reducer );
+    }
+    bucket = &reducer->buckets[reducer->count];
+    bucket->min = value;
+    bucket->max = value;
+    bucket->max_first = false;
+    reducer->count++;
+    reducer->bucket_fill = 1;
+  }
+  else
+  {
+    bucket = &reducer->buckets[reducer->count - 1];
+    if( value > bucket->max )
+    {
+      bucket->max = value;
+      bucket->max_first = false;
+    }
+    else if( value < bucket->min )
+    {
+      bucket->min = value;
+      bucket->max_first = true;
+    }
+    reducer->bucket_fill++;
+  }
+  reducer->total++;
+}
+
+/**
+ * @brief Load the complete history buffer in the reducer, previous samples are
+ *        discarded
+ * @param reducer pointer to reducer object
+ * @param history history buffer, oldest value first
+ * @param length number of samples in history buffer
+ */
+void chart_reducer_load( chart_reducer_t *reducer, const uint8_t *history, size_t length )
+{
+  size_t idx = 0;
+  chart_reducer_reset( reducer );
+  for( idx = 0; idx < length; idx++ )
+  {
+    chart_reducer_append( reducer, (int16_t)history[idx] );
+  }
+}
+
+/**
+ * @brief Render the buckets as chart points, every bucket generates two points
+ *        the extremes in the order they occurred
+ * @param reducer pointer to reducer object
+ * @param points output buffer for chart points
+ * @param max_points size of the output buffer
+ * @return number of points written to output buffer
+ */
+size_t chart_reducer_render( const chart_reducer_t *reducer, int16_t *points, size_t max_points )
+{
+  size_t idx = 0;
+  size_t out = 0;
+  const chart_reducer_bucket_t *bucket;
+
+  for( idx = 0; (idx < reducer->count) && ((out + CHART_REDUCER_POINTS_PER_BUCKET) <= max_points); idx++ )
+  {
+    bucket = &reducer->buckets[idx];
+    if( bucket->max_first )
+    {
+      points[out++] = bucket->max;
+      points[out++] = bucket->min;
+    }
+    else
+    {
+      points[out++] = bucket->min;
+      points[out++] = bucket->max;
+    }
+  }
+  return out;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Merge the neighbouring buckets in pairs, this halves the number of
+ *        buckets in use and doubles the bucket span
+ * @param reducer pointer to reducer object
+ */
+static void chart_reducer_compact( chart_reducer_t *reducer )
+{
+  uint16_t idx = 0;
+  chart_reducer_bucket_t *first;
+  chart_reducer_bucket_t *second;
+  chart_reducer_bucket_t merged;
+  bool max_in_first, min_in_first;
+
+  for( idx = 0; idx < (reducer->count / 2); idx++ )
+  {
+    first = &reducer->buckets[2*idx];
+    second = &reducer->buckets[2*idx + 1];
+    max_in_first = (first->max >= second->max);
+    min_in_first = (first->min <= second->min);
+
+    merged.max = max_in_first ? first->max : second->max;
+    merged.min = min_in_first ? first->min : second->min;
+    if( max_in_first == min_in_first )
+    {
+      // both extremes are from same bucket, keep it's order
+      merged.max_first = max_in_first ? first->max_first : second->max_first;
+    }
+    else
+    {
+      merged.max_first = max_in_first;
+    }
+    reducer->buckets[idx] = merged;
+  }
+  reducer->count = reducer->count / 2;
+  reducer->bucket_span = reducer->bucket_span * 2;
+  reducer->bucket_fill = reducer->bucket_span;
+}
@@ -0,0 +1,42 @@
+/*
+ * chart_reducer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+
+#ifndef MAIN_CHART_REDUCER_H_
+#define MAIN_CHART_REDUCER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Each bucket is drawn with two points (first extreme and then the second one)
+#define CHART_REDUCER_POINTS_PER_BUCKET     (2u)
+
+typedef struct _chart_reducer_bucket_t
+{
+  int16_t min;
+  int16_t max;
+  bool    max_first;          // true if maximum value occurred before the minimum
+} chart_reducer_bucket_t;
+
+typedef struct _chart_reducer_t
+{
+  chart_reducer_bucket_t *buckets;  // caller supplied bucket storage
+  uint16_t capacity;                // number of buckets in storage (must be even)
+  uint16_t count;                   // number of buckets in use
+  uint32_t bucket_span;             // number of samples folded in one bucket
+  uint32_t bucket_fill;             // number of samples in the last bucket
+  uint32_t total;                   // total number of samples appended
+} chart_reducer_t;
+
+// Public Function Prototypes
+void chart_reducer_init( chart_reducer_t *reducer, chart_reducer_bucket_t *buckets, uint16_t capacity );
+void chart_reducer_reset( chart_reducer_t *reducer );
+void chart_reducer_append( chart_reducer_t *reducer, int16_t value );
+void chart_reducer_load( chart_reducer_t *reducer, const uint8_t *history, size_t length );
+size_t chart_reducer_render( const chart_reducer_t *reducer, int16_t *points, size_t max_points );
+
+#endif /* MAIN_CHART_REDUCER_H_ */
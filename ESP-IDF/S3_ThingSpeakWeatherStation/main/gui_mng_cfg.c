@@ -9,9 +9,14 @@
 #include "lvgl.h"
 #include "gui_mng.h"
 #include "gui_mng_cfg.h"
+#include "chart_reducer.h"
+#include "lcd.h"
 
 // Private Macros
 #define NUM_ELEMENTS(x)                 (sizeof(x)/sizeof(x[0]))
+// chart can't show more than one point per horizontal pixel
+#define CHART_MAX_POINTS                (LCD_H_RES)
+#define CHART_MAX_BUCKETS               (CHART_MAX_POINTS/CHART_REDUCER_POINTS_PER_BUCKET)
 
 // function template for callback function
 typedef void (*gui_mng_callback)(uint8_t * data);
@@ -24,6 +29,7 @@ typedef struct _gui_mng_event_cb_t
 
 // Private Function Prototypes
 static void gui_update_sensor_data( uint8_t *data );
+static void gui_update_chart( void );
 
 // Private Variables
 static lv_obj_t * ui_lblHeadLine;
@@ -34,6 +40,13 @@ static lv_obj_t * ui_lblHumidityValue;
 static lv_obj_t * ui_chart;
 static lv_chart_series_t * temp_series;
 static lv_chart_series_t * humid_series;
+static uint16_t chart_points = 0;
+// temperature and humidity history is folded into chart_points points
+static chart_reducer_t temp_reducer;
+static chart_reducer_t humid_reducer;
+static chart_reducer_bucket_t temp_buckets[CHART_MAX_BUCKETS];
+static chart_reducer_bucket_t humid_buckets[CHART_MAX_BUCKETS];
+static int16_t chart_buffer[CHART_MAX_POINTS];
 
 static const gui_mng_event_cb_t gui_mng_event_cb[] =
 {
@@ -49,8 +62,6 @@ static const gui_mng_event_cb_t gui_mng_event_cb[] =
 void gui_cfg_init( void )
 {
   sensor_data_t *sensor_data = get_temperature_humidity();
-  uint8_t *temp_data = sensor_data->temperature;
-  uint8_t *humid_data = sensor_data->humidity;
 
   // uint16_t disp_width = lv_disp_get_hor_res(NULL);
   // uint16_t disp_height = lv_disp_get_ver_res(NULL);
@@ -166,11 +177,18 @@ void gui_cfg_init( void )
   lv_chart_set_axis_tick(ui_chart, LV_CHART_AXIS_PRIMARY_Y, 10, 5, 6, 2, true, 50);
   lv_chart_set_axis_tick(ui_chart, LV_CHART_AXIS_SECONDARY_Y, 10, 5, 5, 2, true, 25);
 
-  // this should match with the temperature & humidity buffer length
-  // NOTE: if generating using the Square Line Studio, make sure it matches the same value
-  uint16_t chart_hor_res = SENSOR_BUFF_SIZE;
+  // the history length is independent of the chart, it is downsampled to one
+  // point per horizontal pixel of the chart drawing area
+  lv_obj_update_layout( ui_chart );
+  chart_points = (uint16_t)lv_obj_get_content_width( ui_chart );
+  if( (chart_points == 0) || (chart_points > CHART_MAX_POINTS) )
+  {
+    chart_points = CHART_MAX_POINTS;
+  }
+  chart_reducer_init( &temp_reducer, temp_buckets, chart_points/CHART_REDUCER_POINTS_PER_BUCKET );
+  chart_reducer_init( &humid_reducer, humid_buckets, chart_points/CHART_REDUCER_POINTS_PER_BUCKET );
   // By default the number of points are 10, update it to chart width
-  lv_chart_set_point_count( ui_chart, chart_hor_res );
+  lv_chart_set_point_count( ui_chart, chart_points );
   // Do not display points on the data
   lv_obj_set_style_size( ui_chart, 0, LV_PART_INDICATOR);
   // Update mode shift or circular, here shift is selected
@@ -181,11 +199,10 @@ void gui_cfg_init( void )
   // Add data series for humidity on secondary y-axis
   humid_series = lv_chart_add_series(ui_chart, lv_palette_main(LV_PALETTE_GREEN), LV_CHART_AXIS_SECONDARY_Y);
 
-  for( size_t idx=0; idx<chart_hor_res; idx++ )
-  {
-    temp_series->y_points[idx] = (lv_coord_t)*(temp_data+idx);
-    humid_series->y_points[idx] = (lv_coord_t)*(humid_data+idx);
-  }
+  // load the samples already available in history
+  chart_reducer_load( &temp_reducer, sensor_data->temperature, sensor_data->sensor_idx );
+  chart_reducer_load( &humid_reducer, sensor_data->humidity, sensor_data->sensor_idx );
+  gui_update_chart();
 }
 
 /**
@@ -224,14 +241,31 @@ static void gui_update_sensor_data( uint8_t *data )
   lv_label_set_text_fmt(ui_lblTemperatureValue, "%d °C", sensor_data->temperature_current );
   lv_label_set_text_fmt(ui_lblHumidityValue, "%d %%", sensor_data->humidity_current );
 
-  // this should match the temperature buffer length
-  uint16_t chart_hor_res = SENSOR_BUFF_SIZE;
+  chart_reducer_append( &temp_reducer, (int16_t)sensor_data->temperature_current );
+  chart_reducer_append( &humid_reducer, (int16_t)sensor_data->humidity_current );
+  gui_update_chart();
+}
+
+/**
+ * @brief Render the downsampled temperature and humidity history on the chart
+ *        the cost of this depends only on the chart width
+ * @param  None
+ */
+static void gui_update_chart( void )
+{
+  size_t count = 0;
   size_t idx = 0;
 
-  for( idx=0; idx<chart_hor_res; idx++ )
+  count = chart_reducer_render( &temp_reducer, chart_buffer, chart_points );
+  for( idx=0; idx<chart_points; idx++ )
+  {
+    temp_series->y_points[idx] = (idx < count) ? (lv_coord_t)chart_buffer[idx] : LV_CHART_POINT_NONE;
+  }
+
+  count = chart_reducer_render( &humid_reducer, chart_buffer, chart_points );
+  for( idx=0; idx<chart_points; idx++ )
   {
-    temp_series->y_points[idx] = (sensor_data->temperature[idx]);
-    humid_series->y_points[idx] = (sensor_data->humidity[idx]);
+    humid_series->y_points[idx] = (idx < count) ? (lv_coord_t)chart_buffer[idx] : LV_CHART_POINT_NONE;
   }
   lv_chart_refresh(ui_chart);
 }
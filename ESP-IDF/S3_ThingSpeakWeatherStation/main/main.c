@@ -18,6 +18,8 @@
 #include "dht11.h"
 #include "thingspeak.h"
 #include "gui_mng.h"
+#include "telemetry.h"
+#include "loadgen.h"
 
 // macros
 #define DHT11_PIN                           (GPIO_NUM_17)
@@ -66,6 +68,16 @@ void app_main(void)
     thingspeak_start();
   }
 
+#ifdef CONFIG_LOADGEN_ENABLE
+  // virtual devices publish on the telemetry bus along with the local sensor
+  loadgen_config_t loadgen_cfg = LOADGEN_CONFIG_DEFAULT();
+  loadgen_cfg.devices = CONFIG_LOADGEN_DEVICES;
+  loadgen_cfg.rate_hz = CONFIG_LOADGEN_RATE_HZ;
+  loadgen_cfg.duration_s = CONFIG_LOADGEN_DURATION_S;
+  loadgen_cfg.report_ms = CONFIG_LOADGEN_REPORT_MS;
+  ESP_ERROR_CHECK( loadgen_start( &loadgen_cfg ) );
+#endif
+
   // initialize dht sensor library
   dht11_init(DHT11_PIN, true);
 
@@ -93,11 +105,9 @@ void app_main(void)
           sensor_data.sensor_idx++;
           // trigger event to display temperature and humidity
           gui_send_event(GUI_MNG_EV_TEMP_HUMID, (uint8_t*)(&sensor_data) );
-          // if wifi is connected, trigger event to send data to ThingSpeak
-          if( wifi_connect_status )
-          {
-            thingspeak_send_event(THING_SPEAK_EV_TEMP_HUMID, NULL);
-          }
+          // publish the sample to all the uplinks (ThingSpeak), this never blocks
+          float sample[SENSOR_CH_MAX] = { sensor_data.temperature_current, sensor_data.humidity_current };
+          telemetry_publish( sample, SENSOR_CH_MAX );
           // reset the index
           if( sensor_data.sensor_idx >= SENSOR_BUFF_SIZE )
           {
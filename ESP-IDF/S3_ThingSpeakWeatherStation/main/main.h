@@ -13,6 +13,13 @@
 // macros
 #define SENSOR_BUFF_SIZE                        (100u)
 
+// channels of the telemetry sample
+typedef enum {
+  SENSOR_CH_TEMPERATURE = 0,
+  SENSOR_CH_HUMIDITY,
+  SENSOR_CH_MAX,
+} sensor_channel_t;
+
 typedef struct _sensor_data_t
 {
   uint8_t temperature_current;
@@ -3,30 +3,91 @@
  *
  *  Created on: Feb 5, 2024
  *      Author: xpress_embedo
+ *
+ * Samples are not sent one by one, they are queued with the time stamp and sent
+ * with the bulk_update.json API. ThingSpeak drops the updates which are sent
+ * faster than the channel rate limit (15 seconds for free accounts), so the
+ * requests are limited with a token bucket and all the samples collected in
+ * the meantime are sent with the next request. The client is taken from the
+ * shared HTTP pool, so the keep-alive connection (or at least the TLS session)
+ * is reused and the TLS handshake is not repeated for every request.
+ * Samples are received from the telemetry bus with the time when they were
+ * taken, the bus only wakes up this task and never blocks the sensor loop.
+ * The bulk update URL needs the channel ID, if it is not configured only the
+ * newest sample is sent with the update API instead (the same rate limit), it
+ * has no time stamp so the samples in between are not queued.
  */
+#include <string.h>
+
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 #include "esp_http_client.h"
+#include "http_pool.h"
+#include "serializer.h"
+#include "telemetry.h"
 
 #include "main.h"
 #include "thingspeak.h"
 
 // Private Macros
 #define THINGSPEAK_EVENT_QUEUE_LEN          (5)
+#define THINGSPEAK_URL_MAX                  (200)
+#define THINGSPEAK_CHANNEL_ID               CONFIG_THINGSPEAK_CHANNEL_ID
+#define THINGSPEAK_RATE_INTERVAL_MS         CONFIG_THINGSPEAK_RATE_INTERVAL_MS
+#define THINGSPEAK_RATE_BURST               CONFIG_THINGSPEAK_RATE_BURST
+#define THINGSPEAK_SAMPLES_MAX              CONFIG_THINGSPEAK_SAMPLES_MAX
+#define THINGSPEAK_BULK_MAX                 CONFIG_THINGSPEAK_BULK_MAX
+#define THINGSPEAK_SAMPLE_JSON_MAX          (48u)     // {"delta_t":65535,"field1":255,"field2":255},
+#define THINGSPEAK_BODY_MAX                 (64u + (THINGSPEAK_BULK_MAX * THINGSPEAK_SAMPLE_JSON_MAX))
+#define THINGSPEAK_HTTP_TIMEOUT_MS          (10000)
+#define THINGSPEAK_SINK_DEPTH               (4u)      // samples waiting for the task
+#define THINGSPEAK_BULK_ENABLED             (THINGSPEAK_CHANNEL_ID[0] != '\0')
+
+typedef struct _thingspeak_sample_t
+{
+  int64_t time_ms;                          // time since boot
+  uint8_t temperature;
+  uint8_t humidity;
+} thingspeak_sample_t;
+
+typedef struct _thingspeak_bucket_t
+{
+  int64_t   last_ms;                        // last refill time
+  uint32_t  tokens_ms;                      // tokens in milliseconds (1 token = interval)
+} thingspeak_bucket_t;
 
 // Private Variables
 static const char *TAG = "ThingSpeak";
 static const char *THINGSPEAK_KEY = "4MTE3BNV84DE6FEU";
 static const char *CLIENT_KEY = "Content-Type";
-static const char *CLIENT_VALUE = "application/x-www-form-urlencoded";
+static const char *CLIENT_VALUE = "application/json";
 static QueueHandle_t thingspeak_event = NULL;
+// samples waiting to be sent (ring buffer)
+static thingspeak_sample_t thingspeak_samples[THINGSPEAK_SAMPLES_MAX];
+static size_t thingspeak_samples_head = 0;
+static size_t thingspeak_samples_count = 0;
+static int64_t thingspeak_last_sent_ms = -1;    // time of last sample sent, for delta_t
+static thingspeak_bucket_t thingspeak_bucket = { 0 };
+static char thingspeak_body[THINGSPEAK_BODY_MAX];
+static telemetry_sink_t thingspeak_sink = { 0 };
+static telemetry_sample_t thingspeak_sink_queue[THINGSPEAK_SINK_DEPTH];
 
 // Private Function Declaration
 static void thingspeak_task( void *pvParameters );
-static void thingspeak_send_temp_humidity(void);
+static void thingspeak_sink_notify( void *ctx );
+static void thingspeak_queue_samples( void );
+static void thingspeak_send( void );
+static size_t thingspeak_build_body( ser_writer_t *writer );
+static size_t thingspeak_build_update( ser_writer_t *writer );
+static void thingspeak_samples_remove( size_t samples );
+static esp_http_client_handle_t thingspeak_client_get( void );
+static void thingspeak_bucket_refill( int64_t now_ms );
+static TickType_t thingspeak_next_wait( int64_t now_ms );
+static int64_t thingspeak_now_ms( void );
 
 
 // Public Function Prototypes
@@ -43,11 +104,18 @@ void thingspeak_start( void )
   {
     ESP_LOGE(TAG, "Unable to Create Queue");
   }
+  // bucket starts full, so the first sample is sent immediately
+  thingspeak_bucket.last_ms = thingspeak_now_ms();
+  thingspeak_bucket.tokens_ms = THINGSPEAK_RATE_BURST * THINGSPEAK_RATE_INTERVAL_MS;
   xTaskCreate(&thingspeak_task, "ThingSpeak Task", 4096*2, NULL, 6, NULL);
+  telemetry_sink_init( &thingspeak_sink, "thingspeak", thingspeak_sink_queue, THINGSPEAK_SINK_DEPTH, \
+                       TELEMETRY_DROP_OLDEST, thingspeak_sink_notify, NULL );
+  telemetry_sink_register( &thingspeak_sink );
 }
 
 /**
- * @brief Send an event to thingspeak queue
+ * @brief Send an event to thingspeak queue, this never blocks, if the queue is
+ *        full the event is dropped (the task reads all pending samples anyway)
  * @param event event code
  * @param pData pointer to data if any (not used for future use)
  * @return pdTRUE if successful else pdFALSE
@@ -61,7 +129,7 @@ BaseType_t thingspeak_send_event( thingspeak_event_t event, uint8_t *pData )
   {
     msg.event_id  = event;
     msg.data      = pData;
-    status = xQueueSend( thingspeak_event, &msg, portMAX_DELAY );
+    status = xQueueSend( thingspeak_event, &msg, 0 );
   }
   return status;
 }
@@ -69,7 +137,9 @@ BaseType_t thingspeak_send_event( thingspeak_event_t event, uint8_t *pData )
 
 /**
  * @brief ThingSpeak Task
- * @param pvParameters 
+ * The queue wait timeout is the time when next request is allowed, so that the
+ * pending samples are sent as soon as the rate limit allows it
+ * @param pvParameters
  */
 static void thingspeak_task( void *pvParameters )
 {
@@ -78,7 +148,7 @@ static void thingspeak_task( void *pvParameters )
   while( 1 )
   {
     // Wait for events posted in Queue
-    if( xQueueReceive(thingspeak_event, &msg, portMAX_DELAY) )
+    if( xQueueReceive(thingspeak_event, &msg, thingspeak_next_wait(thingspeak_now_ms())) )
     {
       // the below is the code to handle the state machine
       if( THING_SPEAK_EV_NONE != msg.event_id )
@@ -86,62 +156,313 @@ static void thingspeak_task( void *pvParameters )
         switch( msg.event_id )
         {
           case THING_SPEAK_EV_TEMP_HUMID:
-            thingspeak_send_temp_humidity();
+            thingspeak_queue_samples();
             break;
           default:
             break;
         } // switch case end
       }   // if event received in limit end
     }     // xQueueReceive end
+
+    thingspeak_bucket_refill( thingspeak_now_ms() );
+    if( thingspeak_samples_count && (thingspeak_bucket.tokens_ms >= THINGSPEAK_RATE_INTERVAL_MS) )
+    {
+      thingspeak_bucket.tokens_ms -= THINGSPEAK_RATE_INTERVAL_MS;
+      thingspeak_send();
+    }
+  }
+}
+
+/**
+ * @brief Telemetry bus notify callback, called from the sensor loop, it only
+ *        wakes up the ThingSpeak task
+ * @param ctx not used
+ */
+static void thingspeak_sink_notify( void *ctx )
+{
+  thingspeak_q_msg_t msg = { .event_id = THING_SPEAK_EV_TEMP_HUMID, .data = NULL };
+
+  // if queue is full, an event is pending already and it reads all the samples
+  xQueueSend( thingspeak_event, &msg, 0 );
+}
+
+/**
+ * @brief Queue the Temperature and Humidity samples received from telemetry
+ *        bus, they are sent to ThingSpeak cloud with the next bulk update,
+ *        without channel ID only the newest sample is kept
+ * @param  none
+ */
+static void thingspeak_queue_samples( void )
+{
+  thingspeak_sample_t *sample = NULL;
+  telemetry_sample_t bus_sample;
+
+  while( telemetry_receive( &thingspeak_sink, &bus_sample ) )
+  {
+    if( !THINGSPEAK_BULK_ENABLED )
+    {
+      // update API has no time stamp, ThingSpeak stamps the sample when it is
+      // received, so only the newest sample is kept and sent
+      thingspeak_samples_remove( thingspeak_samples_count );
+    }
+    else if( thingspeak_samples_count == THINGSPEAK_SAMPLES_MAX )
+    {
+      // ThingSpeak not reachable since long time, drop the oldest sample
+      thingspeak_samples_remove( 1 );
+      ESP_LOGW(TAG, "Sample queue full, oldest sample dropped");
+    }
+
+    sample = &thingspeak_samples[(thingspeak_samples_head + thingspeak_samples_count) % THINGSPEAK_SAMPLES_MAX];
+    sample->temperature = telemetry_value_u8( &bus_sample, SENSOR_CH_TEMPERATURE );
+    sample->humidity = telemetry_value_u8( &bus_sample, SENSOR_CH_HUMIDITY );
+    sample->time_ms = bus_sample.time_us / 1000;
+    thingspeak_samples_count++;
   }
 }
 
 /**
- * @brief Send Temperature and Humidity data to ThingSpeak cloud
+ * @brief Send the queued samples with bulk update, or the newest sample with
+ *        the update API if the channel ID is not configured. Samples are
+ *        removed from queue only if ThingSpeak accepted them
  * @param  none
  */
-static void thingspeak_send_temp_humidity(void)
+static void thingspeak_send( void )
 {
   esp_err_t err;
-  uint8_t temperature = 0;
-  uint8_t humidity = 0;
-  char thingspeak_url[200];
+  ser_writer_t writer;
+  size_t samples = 0;
+  esp_http_client_handle_t client = thingspeak_client_get();
 
-  sensor_data_t *sensor_data = get_temperature_humidity();
-  temperature = sensor_data->temperature_current;
-  humidity = sensor_data->humidity_current;
+  if( client == NULL )
+  {
+    return;
+  }
 
-  snprintf( thingspeak_url, sizeof(thingspeak_url), "https://api.thingspeak.com/update?api_key=%s&field1=%u&field2=%u", THINGSPEAK_KEY, temperature, humidity);
-  esp_http_client_config_t config =
+  ser_writer_init( &writer, thingspeak_body, sizeof(thingspeak_body) );
+  samples = THINGSPEAK_BULK_ENABLED ? thingspeak_build_body( &writer ) : thingspeak_build_update( &writer );
+  if( samples == 0 )
   {
-    .url = thingspeak_url,
-    .method = HTTP_METHOD_GET,
-    // todo: maybe for future
-    // .transport_type = HTTP_TRANSPORT_OVER_SSL,   // Specify transport type
-    // .crt_bundle_attach = esp_crt_bundle_attach,  // Attach the certificate bundle
-  };
+    ESP_LOGE(TAG, "Unable to create update message");
+    http_pool_release( client );
+    return;
+  }
 
-  esp_http_client_handle_t client = esp_http_client_init( &config );
-  // set header
-  esp_http_client_set_header( client, CLIENT_KEY, CLIENT_VALUE );
-  ESP_LOGI(TAG, "ThingSpeak URL = %s", thingspeak_url);
-  // note: we can also use these two functions, but I never tried
-  // esp_http_client_set_post_field(client, post_data, strlen(post_data));
-  // esp_http_client_set_url(client, post_data);
-  
+  esp_http_client_set_post_field( client, thingspeak_body, ser_len(&writer) );
   // perform the request
   err = esp_http_client_perform(client);
   if (err == ESP_OK)
   {
     int status_code = esp_http_client_get_status_code(client);
-    if( status_code == 200 )
+    if( (status_code == 200) || (status_code == 202) )
+    {
+      ESP_LOGI(TAG, "%u Samples Sent Successfully.", (unsigned)samples);
+      thingspeak_last_sent_ms = thingspeak_samples[(thingspeak_samples_head + samples - 1) % THINGSPEAK_SAMPLES_MAX].time_ms;
+      thingspeak_samples_remove( samples );
+    }
+    else
+    {
+      // samples are kept and the next attempt is after the next token, also
+      // for 4xx (wrong key or channel), the samples are sent once the
+      // configuration is fixed, till then the queue drops the oldest ones
+      ESP_LOGE(TAG, "Message Sending Failed (%d), %u samples kept.", status_code, (unsigned)samples);
+    }
+  }
+  else
+  {
+    ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+    // connection is in unknown state, next perform will reconnect
+    esp_http_client_close( client );
+  }
+  http_pool_release( client );
+}
+
+/**
+ * @brief Create the bulk update JSON message from the queued samples
+ * {"write_api_key":"KEY","updates":[{"delta_t":0,"field1":25,"field2":60},..]}
+ * delta_t is the time in seconds from the previous update
+ * @param writer JSON writer
+ * @return number of samples in message
+ */
+static size_t thingspeak_build_body( ser_writer_t *writer )
+{
+  size_t samples = 0;
+  int64_t prev_ms = thingspeak_last_sent_ms;
+  int64_t delta_ms = 0;
+  ser_mark_t start;
+  ser_mark_t end;
+
+  ser_json_obj_begin( writer );
+  ser_json_key( writer, "write_api_key" );
+  ser_json_str( writer, THINGSPEAK_KEY );
+  ser_json_key( writer, "updates" );
+  ser_json_arr_begin( writer );
+  while( (samples < thingspeak_samples_count) && (samples < THINGSPEAK_BULK_MAX) )
+  {
+    thingspeak_sample_t *sample = &thingspeak_samples[(thingspeak_samples_head + samples) % THINGSPEAK_SAMPLES_MAX];
+    delta_ms = (prev_ms < 0) ? 0 : (sample->time_ms - prev_ms);
+
+    start = ser_mark( writer );
+    ser_json_obj_begin( writer );
+    ser_json_key( writer, "delta_t" );
+    ser_json_int( writer, (delta_ms + 500) / 1000 );
+    ser_json_key( writer, "field1" );
+    ser_json_uint( writer, sample->temperature );
+    ser_json_key( writer, "field2" );
+    ser_json_uint( writer, sample->humidity );
+    ser_json_obj_end( writer );
+    // the closing brackets must also fit
+    end = ser_mark( writer );
+    ser_raw( writer, "]}", 2 );
+    if( ser_truncated( writer ) )
+    {
+      ser_rollback( writer, &start );
+      break;
+    }
+    ser_rollback( writer, &end );
+    prev_ms = sample->time_ms;
+    samples++;
+  }
+  ser_json_arr_end( writer );
+  ser_json_obj_end( writer );
+  if( !ser_finish( writer ) )
+  {
+    return 0;
+  }
+  return samples;
+}
+
+/**
+ * @brief Create the update API JSON message from the queued sample, without
+ *        channel ID only the newest one is queued
+ * {"api_key":"KEY","field1":25,"field2":60}
+ * @param writer JSON writer
+ * @return number of samples in message, 1 or 0 if it doesn't fit
+ */
+static size_t thingspeak_build_update( ser_writer_t *writer )
+{
+  thingspeak_sample_t *sample = &thingspeak_samples[thingspeak_samples_head];
+
+  ser_json_obj_begin( writer );
+  ser_json_key( writer, "api_key" );
+  ser_json_str( writer, THINGSPEAK_KEY );
+  ser_json_key( writer, "field1" );
+  ser_json_uint( writer, sample->temperature );
+  ser_json_key( writer, "field2" );
+  ser_json_uint( writer, sample->humidity );
+  ser_json_obj_end( writer );
+  if( !ser_finish( writer ) )
+  {
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * @brief Remove the oldest samples from queue
+ * @param samples number of samples to remove
+ */
+static void thingspeak_samples_remove( size_t samples )
+{
+  thingspeak_samples_head = (thingspeak_samples_head + samples) % THINGSPEAK_SAMPLES_MAX;
+  thingspeak_samples_count -= samples;
+}
+
+/**
+ * @brief Get the keep-alive HTTP client from the pool, it must be given back
+ *        with http_pool_release after the request
+ * @param  none
+ * @return client handle or NULL
+ */
+static esp_http_client_handle_t thingspeak_client_get( void )
+{
+  static char thingspeak_url[THINGSPEAK_URL_MAX] = { 0 };
+  esp_http_client_handle_t client = NULL;
+  ser_writer_t writer;
+
+  if( thingspeak_url[0] == '\0' )
+  {
+    ser_writer_init( &writer, thingspeak_url, sizeof(thingspeak_url) );
+    if( THINGSPEAK_BULK_ENABLED )
     {
-      ESP_LOGI(TAG, "Message Sent Successfully.");
+      ser_str( &writer, "https://api.thingspeak.com/channels/" );
+      ser_str( &writer, THINGSPEAK_CHANNEL_ID );
+      ser_str( &writer, "/bulk_update.json" );
     }
     else
     {
-      ESP_LOGE(TAG, "Message Sending Failed.");
+      ser_str( &writer, "https://api.thingspeak.com/update.json" );
     }
+    if( ser_finish( &writer ) == false )
+    {
+      ESP_LOGE(TAG, "ThingSpeak URL is too long");
+      thingspeak_url[0] = '\0';
+      return NULL;
+    }
+    ESP_LOGI(TAG, "ThingSpeak URL = %s", thingspeak_url);
   }
-  esp_http_client_cleanup(client);
+
+  esp_http_client_config_t config =
+  {
+    .url = thingspeak_url,
+    .method = HTTP_METHOD_POST,
+    .timeout_ms = THINGSPEAK_HTTP_TIMEOUT_MS,
+    .keep_alive_enable = true,
+    // certificate bundle is attached by the pool
+  };
+
+  client = http_pool_acquire( &config );
+  if( client == NULL )
+  {
+    ESP_LOGE(TAG, "Unable to get HTTP client");
+    return NULL;
+  }
+  // set header
+  esp_http_client_set_header( client, CLIENT_KEY, CLIENT_VALUE );
+  return client;
+}
+
+/**
+ * @brief Add the tokens for the elapsed time, bucket can have at most
+ *        THINGSPEAK_RATE_BURST tokens
+ * @param now_ms current time in milliseconds
+ */
+static void thingspeak_bucket_refill( int64_t now_ms )
+{
+  int64_t tokens_ms = thingspeak_bucket.tokens_ms + (now_ms - thingspeak_bucket.last_ms);
+
+  if( tokens_ms > (THINGSPEAK_RATE_BURST * THINGSPEAK_RATE_INTERVAL_MS) )
+  {
+    tokens_ms = THINGSPEAK_RATE_BURST * THINGSPEAK_RATE_INTERVAL_MS;
+  }
+  thingspeak_bucket.tokens_ms = (uint32_t)tokens_ms;
+  thingspeak_bucket.last_ms = now_ms;
+}
+
+/**
+ * @brief Get the time till next request is allowed
+ * @param now_ms current time in milliseconds
+ * @return ticks to wait for next event
+ */
+static TickType_t thingspeak_next_wait( int64_t now_ms )
+{
+  if( thingspeak_samples_count == 0 )
+  {
+    return portMAX_DELAY;
+  }
+  thingspeak_bucket_refill( now_ms );
+  if( thingspeak_bucket.tokens_ms >= THINGSPEAK_RATE_INTERVAL_MS )
+  {
+    return 0;
+  }
+  return pdMS_TO_TICKS( THINGSPEAK_RATE_INTERVAL_MS - thingspeak_bucket.tokens_ms );
+}
+
+/**
+ * @brief Get the time since boot in milliseconds
+ * @param  none
+ * @return time in milliseconds
+ */
+static int64_t thingspeak_now_ms( void )
+{
+  return esp_timer_get_time() / 1000;
 }
@@ -11,6 +11,7 @@
 #include "freertos/task.h"
 
 #include "main.h"
+#include "ota_mng.h"
 #include "ui.h"
 #include "lvgl.h"
 #include "gui_mng.h"
@@ -18,6 +19,7 @@
 
 // Private Macros
 #define NUM_ELEMENTS(x)                 (sizeof(x)/sizeof(x[0]))
+#define OTA_RESULT_SHOW_TIME_MS         (4000)      // a failed update is shown this long
 
 typedef struct _party_logo_t
 {
@@ -39,6 +41,15 @@ typedef struct _widgets_t
 // function template for callback function
 typedef void (*gui_mng_callback)(uint8_t * data);
 
+// firmware update overlay, on the top layer above all screens
+typedef struct _ota_widgets_t
+{
+  lv_obj_t * panel;
+  lv_obj_t * bar;
+  lv_obj_t * status;
+  lv_timer_t * hide_timer;
+} ota_widgets_t;
+
 typedef struct _gui_mng_event_cb_t
 {
   gui_mng_event_t   event;
@@ -52,13 +63,19 @@ static void gui_reset_button_event( lv_event_t *e );
 static void gui_main_screen_event( lv_event_t *e );
 static void gui_election_result_screen_event( lv_event_t *e );
 static void winning_timer_anim_cb( lv_timer_t *timer );
+static void gui_title_event( lv_event_t *e );
+static void gui_ota_start( uint8_t *data );
+static void gui_ota_progress( uint8_t *data );
+static void gui_ota_done( uint8_t *data );
+static void gui_ota_hide_timer_cb( lv_timer_t *timer );
 
 // Private Variables
-/* todo: will be used if new features will be added
 static const gui_mng_event_cb_t gui_mng_event_cb[] =
 {
+  { GUI_MNG_EV_OTA_START,       gui_ota_start     },
+  { GUI_MNG_EV_OTA_PROGRESS,    gui_ota_progress  },
+  { GUI_MNG_EV_OTA_DONE,        gui_ota_done      },
 };
-*/
 // this is party logo database table (this consist of all the party names and logos mapped)
 static party_logo_t party_logo_db_table[] =
 {
@@ -80,6 +97,7 @@ static lv_coord_t           chart_series_array[MAX_NUM_OF_PARTY] = { 0 };
 static lv_chart_series_t *  ui_chartResults_series = { NULL };
 static uint16_t             votes[MAX_NUM_OF_PARTY] = { 0 };
 static widgets_t            widgets_table = { NULL };
+static ota_widgets_t        ota_widgets = { NULL };
 
 // Public Function Definitions
 /**
@@ -196,6 +214,9 @@ void gui_cfg_init( void )
   // register callback for left and right swipe gesture (swipe events will be handled in the callback functions)
   lv_obj_add_event_cb( ui_MainScreen, gui_main_screen_event, LV_EVENT_ALL, NULL );
   lv_obj_add_event_cb( ui_ResultsBarScreen, gui_election_result_screen_event, LV_EVENT_ALL, NULL );
+  // long press on the title installs the firmware update from the SD card
+  lv_obj_add_flag( ui_lblTitle, LV_OBJ_FLAG_CLICKABLE );
+  lv_obj_add_event_cb( ui_lblTitle, gui_title_event, LV_EVENT_LONG_PRESSED, NULL );
 }
 
 /**
@@ -207,19 +228,19 @@ void gui_cfg_init( void )
  */
 void gui_cfg_mng_process( gui_mng_event_t event, uint8_t *data )
 {
-//  uint8_t idx = 0;
-//  for( idx=0; idx < NUM_ELEMENTS(gui_mng_event_cb); idx++ )
-//  {
-//    // check if event matches the table
-//    if( event == gui_mng_event_cb[idx].event )
-//    {
-//      // call the callback function with arguments, if not NULL
-//      if( gui_mng_event_cb[idx].callback != NULL )
-//      {
-//        gui_mng_event_cb[idx].callback(data);
-//      }
-//    }
-//  }
+  uint8_t idx = 0;
+  for( idx=0; idx < NUM_ELEMENTS(gui_mng_event_cb); idx++ )
+  {
+    // check if event matches the table
+    if( event == gui_mng_event_cb[idx].event )
+    {
+      // call the callback function with arguments, if not NULL
+      if( gui_mng_event_cb[idx].callback != NULL )
+      {
+        gui_mng_event_cb[idx].callback(data);
+      }
+    }
+  }
 }
 
 // Private Function Definitions
@@ -383,3 +404,98 @@ static void winning_timer_anim_cb( lv_timer_t *timer )
     lv_obj_set_style_bg_opa( widgets_table.panel_table[winner_idx], 255, LV_PART_MAIN | LV_STATE_DEFAULT);
   }
 }
+
+/**
+ * @brief Callback Function for the long press on the title, requests the
+ *        firmware update from the SD card
+ * @param e
+ */
+static void gui_title_event( lv_event_t *e )
+{
+  if( lv_event_get_code(e) == LV_EVENT_LONG_PRESSED )
+  {
+    ota_mng_request();
+  }
+}
+
+/**
+ * @brief Show the firmware update overlay, it is created on first use and
+ *        covers the screens, so no votes are casted during the update
+ * @param data not used
+ */
+static void gui_ota_start( uint8_t *data )
+{
+  lv_obj_t * title;
+
+  if( ota_widgets.panel == NULL )
+  {
+    ota_widgets.panel = lv_obj_create( lv_layer_top() );
+    lv_obj_set_size( ota_widgets.panel, 500, 200 );
+    lv_obj_set_align( ota_widgets.panel, LV_ALIGN_CENTER );
+    lv_obj_clear_flag( ota_widgets.panel, LV_OBJ_FLAG_SCROLLABLE );
+
+    title = lv_label_create( ota_widgets.panel );
+    lv_obj_set_align( title, LV_ALIGN_TOP_MID );
+    lv_label_set_text( title, "Firmware Update" );
+    lv_obj_set_style_text_font( title, &lv_font_montserrat_24, LV_PART_MAIN | LV_STATE_DEFAULT );
+
+    ota_widgets.bar = lv_bar_create( ota_widgets.panel );
+    lv_obj_set_size( ota_widgets.bar, 400, 24 );
+    lv_obj_set_align( ota_widgets.bar, LV_ALIGN_CENTER );
+
+    ota_widgets.status = lv_label_create( ota_widgets.panel );
+    lv_obj_set_align( ota_widgets.status, LV_ALIGN_BOTTOM_MID );
+    lv_obj_set_style_text_font( ota_widgets.status, &lv_font_montserrat_16, LV_PART_MAIN | LV_STATE_DEFAULT );
+  }
+  // result of the last update may still be shown
+  if( ota_widgets.hide_timer != NULL )
+  {
+    lv_timer_del( ota_widgets.hide_timer );
+    ota_widgets.hide_timer = NULL;
+  }
+  // top layer takes the touch input while the overlay is shown
+  lv_obj_add_flag( lv_layer_top(), LV_OBJ_FLAG_CLICKABLE );
+  lv_obj_clear_flag( ota_widgets.panel, LV_OBJ_FLAG_HIDDEN );
+  lv_bar_set_value( ota_widgets.bar, 0, LV_ANIM_OFF );
+  lv_label_set_text( ota_widgets.status, "Reading " OTA_MNG_IMAGE_PATH );
+}
+
+/**
+ * @brief Update the progress bar of the firmware update
+ * @param data pointer to the percent
+ */
+static void gui_ota_progress( uint8_t *data )
+{
+  if( ota_widgets.panel != NULL )
+  {
+    lv_bar_set_value( ota_widgets.bar, *data, LV_ANIM_OFF );
+    lv_label_set_text_fmt( ota_widgets.status, "Writing flash %d %%", *data );
+  }
+}
+
+/**
+ * @brief Show the result of the firmware update, after a successful update
+ *        the device restarts, else the overlay is hidden after a while
+ * @param data result text
+ */
+static void gui_ota_done( uint8_t *data )
+{
+  if( ota_widgets.panel != NULL )
+  {
+    lv_label_set_text( ota_widgets.status, (const char *)data );
+    ota_widgets.hide_timer = lv_timer_create( gui_ota_hide_timer_cb, OTA_RESULT_SHOW_TIME_MS, NULL );
+    // timer is deleted after it has run once
+    lv_timer_set_repeat_count( ota_widgets.hide_timer, 1 );
+  }
+}
+
+/**
+ * @brief Hide the firmware update overlay
+ * @param timer
+ */
+static void gui_ota_hide_timer_cb( lv_timer_t *timer )
+{
+  ota_widgets.hide_timer = NULL;
+  lv_obj_add_flag( ota_widgets.panel, LV_OBJ_FLAG_HIDDEN );
+  lv_obj_clear_flag( lv_layer_top(), LV_OBJ_FLAG_CLICKABLE );
+}
@@ -10,6 +10,9 @@
 
 typedef enum {
   GUI_MNG_EV_NONE = 0,
+  GUI_MNG_EV_OTA_START,           // firmware update from SD card started, no data
+  GUI_MNG_EV_OTA_PROGRESS,        // data is the percent (uint8_t)
+  GUI_MNG_EV_OTA_DONE,            // data is the result text (const char *)
   GUI_MNG_EV_MAX,
 } gui_mng_event_t;
 
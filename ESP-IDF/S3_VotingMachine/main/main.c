@@ -10,6 +10,7 @@
 
 #include "main.h"
 #include "gui_mng.h"
+#include "ota_mng.h"
 #include "sd_mng.h"
 
 // macros
@@ -87,6 +88,9 @@ void app_main(void)
   // start the gui task, this will handle all the display related stuff
   gui_start();
 
+  // firmware update from SD card, started with the button or from the gui
+  ota_mng_start();
+
   while (true)
   {
     vTaskDelay(MAIN_TASK_PERIOD / portTICK_PERIOD_MS);
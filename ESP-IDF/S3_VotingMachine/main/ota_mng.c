@@ -0,0 +1,209 @@
+/*
+ * ota_mng.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_system.h"
+
+#include "ota_file.h"
+#include "gui_mng.h"
+#include "sd_mng.h"
+#include "ota_mng.h"
+
+// macros
+#define OTA_MNG_TASK_STACK_SIZE         (4096u)
+#define OTA_MNG_TASK_PRIORITY           (4u)      // below the gui and the ota writer task
+#define OTA_MNG_WRITER_STACK_SIZE       (4096u)
+#define OTA_MNG_WRITER_PRIORITY         (5u)
+#define OTA_MNG_RESTART_DELAY_MS        (2000u)   // the result is shown before restart
+
+// Private Variables
+static const char *TAG = "OTA_MNG";
+static TaskHandle_t ota_mng_task_handle = NULL;
+static uint8_t ota_mng_percent = 0;
+
+// Private Function Prototype
+static void ota_mng_task( void *pvParameter );
+static void ota_mng_progress( void *ctx, size_t written, size_t total );
+static const char * ota_mng_result( esp_err_t err );
+#if CONFIG_OTA_BUTTON_GPIO >= 0
+static void ota_mng_button_config( void );
+static void IRAM_ATTR ota_mng_button_isr( void *arg );
+#endif
+
+// Public Function Definitions
+
+/**
+ * @brief Start the firmware update task, it waits for a request from the
+ *        update button or the user interface
+ * @param  None
+ */
+void ota_mng_start( void )
+{
+  if( ota_mng_task_handle == NULL )
+  {
+    xTaskCreate(&ota_mng_task, "ota task", OTA_MNG_TASK_STACK_SIZE, NULL, OTA_MNG_TASK_PRIORITY, &ota_mng_task_handle);
+#if CONFIG_OTA_BUTTON_GPIO >= 0
+    ota_mng_button_config();
+#endif
+  }
+}
+
+/**
+ * @brief Request the firmware update from the SD card, requests during a
+ *        running update are ignored
+ * @param  None
+ */
+void ota_mng_request( void )
+{
+  if( ota_mng_task_handle != NULL )
+  {
+    xTaskNotifyGive( ota_mng_task_handle );
+  }
+}
+
+// Private Function Definition
+
+/**
+ * @brief Firmware update task, on every request the SD card is mounted and
+ *        update.bin is installed if it is a new firmware, the progress and
+ *        the result are shown on the display. The device restarts with the
+ *        new firmware.
+ * @param pvParameter task parameter
+ */
+static void ota_mng_task( void *pvParameter )
+{
+  ota_file_config_t config = OTA_FILE_CONFIG_DEFAULT();
+  const char *result;
+  esp_err_t err;
+
+  config.path = OTA_MNG_IMAGE_PATH;
+  config.sha256_path = OTA_MNG_SHA256_PATH;
+  config.progress_cb = ota_mng_progress;
+  config.task_stack = OTA_MNG_WRITER_STACK_SIZE;
+  config.task_priority = OTA_MNG_WRITER_PRIORITY;
+
+  while( true )
+  {
+    ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    ESP_LOGI( TAG, "Firmware update from SD card requested" );
+    ota_mng_percent = 0;
+    gui_send_event( GUI_MNG_EV_OTA_START, NULL );
+
+    // card was unmounted after reading the parties, it may have been changed
+    err = sd_mng_init();
+    if( err == ESP_OK )
+    {
+      err = ota_file_update( &config );
+      sd_mng_unmount_card();
+      result = ota_mng_result( err );
+    }
+    else
+    {
+      result = "No SD card";
+    }
+    gui_send_event( GUI_MNG_EV_OTA_DONE, (uint8_t*)result );
+
+    if( err == ESP_OK )
+    {
+      vTaskDelay( OTA_MNG_RESTART_DELAY_MS / portTICK_PERIOD_MS );
+      esp_restart();
+    }
+    // button bounces and presses during the update are dropped
+    ulTaskNotifyTake( pdTRUE, 0 );
+  }
+}
+
+/**
+ * @brief Progress of the update, called in the OTA writer task, the display
+ *        is updated on every new percent
+ * @param ctx not used
+ * @param written image bytes in flash
+ * @param total image size
+ */
+static void ota_mng_progress( void *ctx, size_t written, size_t total )
+{
+  uint8_t percent = total ? (uint8_t)(((uint64_t)written * 100u) / total) : 0u;
+
+  if( percent != ota_mng_percent )
+  {
+    ota_mng_percent = percent;
+    gui_send_event( GUI_MNG_EV_OTA_PROGRESS, &ota_mng_percent );
+  }
+}
+
+/**
+ * @brief Text for the result of the update, shown on the display
+ * @param err result of the update
+ * @return constant string
+ */
+static const char * ota_mng_result( esp_err_t err )
+{
+  const char *text;
+
+  switch( err )
+  {
+    case ESP_OK:
+      text = "Update installed, restarting";
+      break;
+    case ESP_ERR_NOT_FOUND:
+      text = "No update.bin on the SD card";
+      break;
+    case ESP_ERR_INVALID_VERSION:
+      text = "Firmware is up to date";
+      break;
+    case ESP_ERR_INVALID_ARG:
+      text = "update.sha is missing or invalid";
+      break;
+    case ESP_ERR_INVALID_CRC:
+      text = "SHA-256 mismatch, update rejected";
+      break;
+    case ESP_ERR_NOT_SUPPORTED:
+      text = "update.bin is not a firmware image";
+      break;
+    default:
+      text = "Update failed";
+      break;
+  }
+  return text;
+}
+
+#if CONFIG_OTA_BUTTON_GPIO >= 0
+/**
+ * @brief Configure the update button, a press (falling edge) requests the
+ *        update
+ * @param  None
+ */
+static void ota_mng_button_config( void )
+{
+  gpio_config_t button_config = {
+    .pin_bit_mask = 1ull << CONFIG_OTA_BUTTON_GPIO,
+    .mode         = GPIO_MODE_INPUT,
+    .pull_up_en   = GPIO_PULLUP_ENABLE,
+    .pull_down_en = GPIO_PULLDOWN_DISABLE,
+    .intr_type    = GPIO_INTR_NEGEDGE,
+  };
+
+  gpio_config( &button_config );
+  gpio_install_isr_service( 0 );
+  gpio_isr_handler_add( CONFIG_OTA_BUTTON_GPIO, ota_mng_button_isr, NULL );
+}
+
+/**
+ * @brief ISR of the update button, notifies the update task
+ * @param arg not used
+ */
+static void IRAM_ATTR ota_mng_button_isr( void *arg )
+{
+  BaseType_t woken = pdFALSE;
+
+  vTaskNotifyGiveFromISR( ota_mng_task_handle, &woken );
+  portYIELD_FROM_ISR( woken );
+}
+#endif
@@ -0,0 +1,22 @@
+/*
+ * ota_mng.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+
+#ifndef MAIN_OTA_MNG_H_
+#define MAIN_OTA_MNG_H_
+
+#include "esp_err.h"
+#include "sd_mng.h"
+
+// macros
+#define OTA_MNG_IMAGE_PATH              MOUNT_POINT"/update.bin"
+#define OTA_MNG_SHA256_PATH             MOUNT_POINT"/update.sha"
+
+// Public Function Prototypes
+void ota_mng_start( void );
+void ota_mng_request( void );
+
+#endif /* MAIN_OTA_MNG_H_ */
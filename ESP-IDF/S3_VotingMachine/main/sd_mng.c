@@ -71,8 +71,9 @@ esp_err_t sd_mng_init( void )
     .max_transfer_sz = 4000,
   };
 
+  // bus is still initialized if a previous mount has failed (no unmount)
   ret = spi_bus_initialize(host.slot, &bus_cfg, SDSPI_DEFAULT_DMA);
-  if (ret != ESP_OK) 
+  if ((ret != ESP_OK) && (ret != ESP_ERR_INVALID_STATE))
   {
     ESP_LOGE(TAG, "Failed to initialize bus.");
     return ret;
@@ -82,7 +83,10 @@ esp_err_t sd_mng_init( void )
   ret = sd_mng_mount_card();
 
   // Card has been initialized, print its properties
-  sdmmc_card_print_info(stdout, card);
+  if( ret == ESP_OK )
+  {
+    sdmmc_card_print_info(stdout, card);
+  }
 
   return ret;
 }
@@ -4,12 +4,20 @@
  *  Created on: 17-Jul-2023
  *      Author: xpress_embedo
  */
+#include <unistd.h>
 #include "esp_http_server.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_ota_ops.h"
 #include "sys/param.h"
+#include "lwip/sockets.h"
+#include "serializer.h"
+#include "web_assets.h"
+#include "multipart_stream.h"
+#include "httpd_async.h"
+#include "ota_writer.h"
+#include "ota_client.h"
 
 #include "main.h"
 #include "http_server.h"
@@ -22,6 +30,57 @@
 #define HTTP_SERVER_RECEIVE_WAIT_TIMEOUT                (10u)   // in seconds
 #define HTTP_SERVER_SEND_WAIT_TIMEOUT                   (10u)   // in seconds
 #define HTTP_SERVER_MONITOR_QUEUE_LEN                   (3u)
+#define HTTP_SERVER_PUSH_PERIOD                         (1000u) // in ms, values are checked for changes
+#define HTTP_SERVER_PUSH_TIME_PERIOD                    (10000u)// in ms, local time is read again
+#define HTTP_SERVER_PUSH_CLIENTS_MAX                    (CONFIG_HTTP_SERVER_PUSH_CLIENTS_MAX)
+#define HTTP_SERVER_PUSH_QUEUE_LEN                      (CONFIG_HTTP_SERVER_PUSH_QUEUE_LEN)
+#define HTTP_SERVER_PUSH_MSG_MAX                        (128u)
+#define HTTP_SERVER_PUSH_SEND_TIMEOUT_MS                (CONFIG_HTTP_SERVER_PUSH_SEND_TIMEOUT_MS)
+#define HTTP_SERVER_OTA_RECV_SIZE                       (2048u)
+#define HTTP_SERVER_OTA_RECV_RETRIES                    (5u)    // receive timeouts in a row
+#define HTTP_SERVER_OTA_HDR_MAX                         (128u)
+#define HTTP_SERVER_STATS_ROUTES_MAX                    (HTTP_SERVER_MAX_URI_HANDLERS)
+#define HTTP_SERVER_STATS_JSON_MAX                      (4096u)
+
+// Structures
+// values pushed to the web page, only the changed ones are sent
+typedef struct _http_server_live_t
+{
+  int temperature;
+  int humidity;
+  int wifi_connect_status;
+  int ota_update_status;
+  int ota_progress;
+  char time[32];
+} http_server_live_t;
+
+// firmware upload, the image is written by the ota_writer task
+typedef struct _http_server_ota_t
+{
+  ota_writer_t writer;
+  size_t content_len;
+  size_t image_len;                     // bytes of the firmware part
+  char sha256[(OTA_WRITER_SHA256_LEN * 2u) + 1u];  // expected hash in hex, optional
+  uint8_t sha256_len;
+} http_server_ota_t;
+
+// JSON text frame shared by all the clients it is queued for
+typedef struct _http_server_push_msg_t
+{
+  uint8_t refs;
+  size_t len;
+  char data[];
+} http_server_push_msg_t;
+
+// WebSocket client with its send queue
+typedef struct _http_server_push_client_t
+{
+  int fd;                               // -1 if the slot is free
+  bool resync;                          // next message must be a full snapshot
+  uint8_t head;
+  uint8_t count;
+  http_server_push_msg_t *queue[HTTP_SERVER_PUSH_QUEUE_LEN];
+} http_server_push_client_t;
 
 // Private Variables
 static const char TAG[] = "http_server";
@@ -33,6 +92,8 @@ static TaskHandle_t task_http_server_monitor = NULL;
 static QueueHandle_t http_server_monitor_q_handle;
 // Firmware Update Status
 static int fw_update_status = OTA_UPDATE_PENDING;
+// Firmware Update Progress in percent, written by the ota_writer task
+static volatile int fw_update_progress = 0;
 // Local Time Status
 static bool g_is_local_time_set = false;
 
@@ -49,17 +110,29 @@ esp_timer_handle_t fw_update_reset;
 // WiFi Connect Status
 static http_server_wifi_connect_status_e g_wifi_connect_status = HTTP_WIFI_STATUS_CONNECT_NONE;
 
-// Embedded Files: JQuery, index.html, app.css, app.js, and favicon.ico files
-extern const uint8_t jquery_3_3_1_min_js_start[]      asm("_binary_jquery_3_3_1_min_js_start");
-extern const uint8_t jquery_3_3_1_min_js_end[]        asm("_binary_jquery_3_3_1_min_js_end");
-extern const uint8_t index_html_start[]               asm("_binary_index_html_start");
-extern const uint8_t index_html_end[]                 asm("_binary_index_html_end");
-extern const uint8_t app_css_start[]                  asm("_binary_app_css_start");
-extern const uint8_t app_css_end[]                    asm("_binary_app_css_end");
-extern const uint8_t app_js_start[]                   asm("_binary_app_js_start");
-extern const uint8_t app_js_end[]                     asm("_binary_app_js_end");
-extern const uint8_t favicon_ico_start[]              asm("_binary_favicon_ico_start");
-extern const uint8_t favicon_ico_end[]                asm("_binary_favicon_ico_end");
+// Live Updates, clients and the send queues are shared by the monitor and httpd tasks
+static portMUX_TYPE push_lock = portMUX_INITIALIZER_UNLOCKED;
+static http_server_push_client_t push_clients[HTTP_SERVER_PUSH_CLIENTS_MAX];
+static http_server_live_t push_last;
+static TickType_t push_time_tick = 0;
+
+// Embedded Files (gzip compressed at build time): JQuery, index.html, app.css, app.js, and favicon.ico files
+extern const uint8_t jquery_3_3_1_min_js_gz_start[] asm("_binary_jquery_3_3_1_min_js_gz_start");
+extern const uint8_t jquery_3_3_1_min_js_gz_end[]   asm("_binary_jquery_3_3_1_min_js_gz_end");
+extern const uint8_t index_html_gz_start[]          asm("_binary_index_html_gz_start");
+extern const uint8_t index_html_gz_end[]            asm("_binary_index_html_gz_end");
+extern const uint8_t app_css_gz_start[]             asm("_binary_app_css_gz_start");
+extern const uint8_t app_css_gz_end[]               asm("_binary_app_css_gz_end");
+extern const uint8_t app_js_gz_start[]              asm("_binary_app_js_gz_start");
+extern const uint8_t app_js_gz_end[]                asm("_binary_app_js_gz_end");
+extern const uint8_t favicon_ico_gz_start[]         asm("_binary_favicon_ico_gz_start");
+extern const uint8_t favicon_ico_gz_end[]           asm("_binary_favicon_ico_gz_end");
+// jQuery file name has the version, it is cached by the browser without revalidation
+static const web_asset_t jquery_3_3_1_min_js_asset = WEB_ASSET( jquery_3_3_1_min_js_gz, "application/javascript", true );
+static const web_asset_t index_html_asset       = WEB_ASSET( index_html_gz, "text/html", false );
+static const web_asset_t app_css_asset          = WEB_ASSET( app_css_gz, "text/css", false );
+static const web_asset_t app_js_asset           = WEB_ASSET( app_js_gz, "application/javascript", false );
+static const web_asset_t favicon_ico_asset      = WEB_ASSET( favicon_ico_gz, "image/x-icon", false );
 
 // Private Function Prototypes
 static void http_server_monitor(void *pvParameter);
@@ -78,7 +151,18 @@ static esp_err_t http_server_get_wifi_connect_info_handler(httpd_req_t *req);
 static esp_err_t http_server_wifi_disconnect_json_handler(httpd_req_t *req);
 static esp_err_t http_server_get_local_time_handler(httpd_req_t *req);
 static esp_err_t http_server_get_ap_ssid_handler(httpd_req_t *req);
+static esp_err_t http_server_ws_handler(httpd_req_t *req);
+static esp_err_t http_server_get_http_stats_handler(httpd_req_t *req);
+static void http_server_close_session(httpd_handle_t hd, int sockfd);
+static esp_err_t http_server_ota_part(void *ctx, multipart_event_t event, const char *name, const uint8_t *data, size_t len);
+static void http_server_ota_progress(void *ctx, size_t processed, size_t written);
 static void http_server_fw_update_reset_timer(void);
+static void http_server_push_update(void);
+static http_server_push_msg_t *http_server_push_msg_create(const http_server_live_t *live, const http_server_live_t *last);
+static void http_server_push_msg_release(http_server_push_msg_t *msg);
+static void http_server_push_enqueue(http_server_push_msg_t *delta, http_server_push_msg_t *snapshot);
+static void http_server_push_drop(uint8_t slot);
+static void http_server_push_work(void *arg);
 
 // Public Function Definition
 /*
@@ -146,7 +230,8 @@ static void http_server_monitor( void *pvParameter )
   http_server_q_msg_t msg;
   for( ;; )
   {
-    if( xQueueReceive(http_server_monitor_q_handle, &msg, portMAX_DELAY) )
+    // wake up periodically to push the changed values to the web pages
+    if( xQueueReceive(http_server_monitor_q_handle, &msg, pdMS_TO_TICKS(HTTP_SERVER_PUSH_PERIOD)) )
     {
       switch (msg.msg_id)
       {
@@ -179,10 +264,14 @@ static void http_server_monitor( void *pvParameter )
         ESP_LOGI( TAG, "HTTP_MSG_TIME_SERVICE_INITIALIZED");
         g_is_local_time_set = true;
         break;
+      case HTTP_MSG_PUSH_CLIENT_CONNECTED:
+        ESP_LOGI( TAG, "HTTP_MSG_PUSH_CLIENT_CONNECTED");
+        break;
       default:
         break;
       }
     }
+    http_server_push_update();
   }
 }
 
@@ -194,6 +283,7 @@ static httpd_handle_t http_server_configure(void)
 {
   // Generate the default configuration
   httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+  httpd_async_config_t async_config = HTTPD_ASYNC_CONFIG_DEFAULT();
 
   // create HTTP Server Monitor Task
   xTaskCreate(&http_server_monitor, "http_server_monitor", \
@@ -219,6 +309,22 @@ static httpd_handle_t http_server_configure(void)
   config.recv_wait_timeout = HTTP_SERVER_RECEIVE_WAIT_TIMEOUT;
   config.send_wait_timeout = HTTP_SERVER_SEND_WAIT_TIMEOUT;
 
+  // WebSocket clients are removed from the live updates when the socket closes
+  config.close_fn = http_server_close_session;
+  for( uint8_t slot = 0; slot < HTTP_SERVER_PUSH_CLIENTS_MAX; slot++ )
+  {
+    push_clients[slot].fd = -1;
+  }
+
+  // slow handlers run in the workers, the httpd task keeps serving the others
+  async_config.task_stack = HTTP_SERVER_WORKER_STACK_SIZE;
+  async_config.task_priority = HTTP_SERVER_WORKER_PRIORITY;
+  if( httpd_async_start(&async_config) != ESP_OK )
+  {
+    ESP_LOGI(TAG, "http_server_configure: Error starting the request workers!");
+    return NULL;
+  }
+
   ESP_LOGI(TAG,
            "http_server_configure: Starting Server on port: '%d' with task priority: '%d'",
            config.server_port, config.task_priority);
@@ -348,21 +454,43 @@ static httpd_handle_t http_server_configure(void)
       .user_ctx  = NULL
     };
 
-    // Register Query Handler
-    httpd_register_uri_handler(http_server_handle, &jquery_js);
-    httpd_register_uri_handler(http_server_handle, &index_html);
-    httpd_register_uri_handler(http_server_handle, &app_css);
-    httpd_register_uri_handler(http_server_handle, &app_js);
-    httpd_register_uri_handler(http_server_handle, &favicon_ico);
-    httpd_register_uri_handler(http_server_handle, &ota_update);
-    httpd_register_uri_handler(http_server_handle, &ota_status);
-    httpd_register_uri_handler(http_server_handle, &sensor_json);
-    httpd_register_uri_handler(http_server_handle, &wifi_connect_json);
-    httpd_register_uri_handler(http_server_handle, &wifi_connect_status_json);
-    httpd_register_uri_handler(http_server_handle, &wifi_connect_info_json);
-    httpd_register_uri_handler(http_server_handle, &wifi_disconnect_json);
-    httpd_register_uri_handler(http_server_handle, &local_time_json);
-    httpd_register_uri_handler(http_server_handle, &ap_ssid_json);
+    // Register WebSocket handler for the live updates
+    httpd_uri_t live_ws =
+    {
+      .uri = "/ws",
+      .method    = HTTP_GET,
+      .handler   = http_server_ws_handler,
+      .user_ctx  = NULL,
+      .is_websocket = true
+    };
+
+    // Register httpStats.json handler, request statistics per route
+    httpd_uri_t http_stats_json =
+    {
+      .uri = "/httpStats",
+      .method    = HTTP_GET,
+      .handler   = http_server_get_http_stats_handler,
+      .user_ctx  = NULL
+    };
+
+    // Register Query Handler, the firmware upload and the local time (slow
+    // SNTP time call) run in a worker, only one upload at a time
+    httpd_async_register_uri_handler(http_server_handle, &jquery_js, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &index_html, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &app_css, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &app_js, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &favicon_ico, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &ota_update, HTTPD_ASYNC_EXCLUSIVE);
+    httpd_async_register_uri_handler(http_server_handle, &ota_status, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &sensor_json, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &wifi_connect_json, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &wifi_connect_status_json, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &wifi_connect_info_json, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &wifi_disconnect_json, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &local_time_json, HTTPD_ASYNC_WORKER);
+    httpd_async_register_uri_handler(http_server_handle, &ap_ssid_json, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &live_ws, HTTPD_ASYNC_INLINE);
+    httpd_async_register_uri_handler(http_server_handle, &http_stats_json, HTTPD_ASYNC_INLINE);
 
     return http_server_handle;
   }
@@ -380,8 +508,7 @@ static esp_err_t http_server_j_query_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "JQuery Requested");
-  httpd_resp_set_type( req, "application/javascript");
-  error = httpd_resp_send(req, (const char*)jquery_3_3_1_min_js_start, jquery_3_3_1_min_js_end-jquery_3_3_1_min_js_start );
+  error = web_assets_send(req, &jquery_3_3_1_min_js_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_j_query_handler: Error %d while sending Response", error );
@@ -402,8 +529,7 @@ static esp_err_t http_server_index_html_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "Index HTML Requested");
-  httpd_resp_set_type( req, "text/html");
-  error = httpd_resp_send(req, (const char*)index_html_start, index_html_end-index_html_start );
+  error = web_assets_send(req, &index_html_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_index_html_handler: Error %d while sending Response", error );
@@ -424,8 +550,7 @@ static esp_err_t http_server_app_css_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "APP CSS Requested");
-  httpd_resp_set_type( req, "text/css");
-  error = httpd_resp_send(req, (const char*)app_css_start, app_css_end-app_css_start );
+  error = web_assets_send(req, &app_css_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_app_css_handler: Error %d while sending Response", error );
@@ -446,8 +571,7 @@ static esp_err_t http_server_app_js_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "APP JS Requested");
-  httpd_resp_set_type( req, "application/javascript");
-  error = httpd_resp_send(req, (const char*)app_js_start, app_js_end-app_js_start );
+  error = web_assets_send(req, &app_js_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_app_js_handler: Error %d while sending Response", error );
@@ -468,8 +592,7 @@ static esp_err_t http_server_favicon_handler(httpd_req_t *req)
 {
   esp_err_t error;
   ESP_LOGI(TAG, "Favicon.ico Requested");
-  httpd_resp_set_type( req, "image/x-icon");
-  error = httpd_resp_send(req, (const char*)favicon_ico_start, favicon_ico_end-favicon_ico_start );
+  error = web_assets_send(req, &favicon_ico_asset);
   if( error != ESP_OK )
   {
     ESP_LOGI( TAG, "http_server_favicon_handler: Error %d while sending Response", error );
@@ -482,153 +605,191 @@ static esp_err_t http_server_favicon_handler(httpd_req_t *req)
 }
 
 /**
- * @brief Receives the *.bin file via the web page and handles the firmware update
+ * @brief Receives the *.bin file via the web page and handles the firmware update.
+ * The multipart/form-data body is parsed as it is received and the "file" part
+ * is given to the ota_writer, which writes it to flash in its own task, so the
+ * socket is read while the flash is erased and written. A raw image body
+ * (application/octet-stream) is accepted too. The expected SHA-256 of the image
+ * can be given in the X-Firmware-SHA256 header or the "sha256" form field.
  * @param req HTTP request for which the uri needs to be handled
- * @return ESP_OK, other ESP_FAIL if timeout occurs and the update canot be started
+ * @return ESP_OK, ESP_FAIL if the update failed, this closes the connection
  */
 static esp_err_t http_server_ota_update_handler(httpd_req_t *req)
 {
+  http_server_ota_t ota = { 0 };
+  ota_writer_config_t config = OTA_WRITER_CONFIG_DEFAULT();
+  multipart_stream_t multipart;
+  char content_type[HTTP_SERVER_OTA_HDR_MAX] = { 0 };
+  uint8_t sha256[OTA_WRITER_SHA256_LEN];
+  bool is_multipart;
+  char *recv_buffer;
+  size_t remaining = req->content_len;
+  uint8_t retries = 0;
+  int recv_len;
   esp_err_t error;
-  esp_ota_handle_t ota_handle;
-  char ota_buffer[1024];
-  int content_len = req->content_len;   // total content length
-  int content_received = 0;
-  int recv_len = 0;
-  bool is_req_body_started = false;
-  bool flash_successful = false;
-
-  // get the next OTA app partition which should be written with a new firmware
-  const esp_partition_t *update_partition = esp_ota_get_next_update_partition(NULL);
-
-  // our ota_buffer is not sufficient to receive all data in a one go
-  // hence we will read the data in chunks and write in chunks, read the below
-  // mentioned comments for more information
-  do
-  {
-    // The following is the API to read content of data from the HTTP request
-    /* This API will read HTTP content data from the HTTP request into the
-     * provided buffer. Use content_len provided in the httpd_req_t structure to
-     *  know the length of the data to be fetched.
-     *  If the content_len is to large for the buffer then the user may have to
-     *  make multiple calls to this functions (as done here), each time fetching
-     *  buf_len num of bytes (which is ota_buffer length here), while the pointer
-     *  to content data is incremented internally by the same number
-     *  This function returns
-     *  Bytes: Number of bytes read into the buffer successfully
-     *  0: Buffer length parameter is zero/connection closed by peer.
-     *  HTTPD_SOCK_ERR_INVALID: Invalid Arguments
-     *  HTTPD_SOCK_ERR_TIMEOUT: Timeout/Interrupted while calling socket recv()
-     *  HTTPD_SOCK_ERR_FAIL: Unrecoverable error while calling socket recv()
-     *  Parameters to this function are:
-     *  req: The request being responded to
-     *  ota_buffer: Pointer to a buffer that the data will be read into
-     *  length: length of the buffer which ever is minimum (as we don't want to
-     *          read more data which buffer can't handle)
-     */
-    recv_len = httpd_req_recv(req, ota_buffer, MIN(content_len, sizeof(ota_buffer)));
-    // if recv_len is less than zero, it means some problem (but if timeout error, then try again)
-    if( recv_len < 0 )
-    {
-      // Check if timeout occur, then we will retry again
-      if( recv_len == HTTPD_SOCK_ERR_TIMEOUT )
-      {
-        ESP_LOGI(TAG, "http_server_ota_update_handler: Socket Timeout");
-        continue;     // Retry Receiving if Timeout Occurred
-      }
-      // If there is some other error apart from Timeout, then exit with fail
-      ESP_LOGI(TAG, "http_server_ota_update_handler: OTA Other Error, %d", recv_len);
-      return ESP_FAIL;
-    }
-    ESP_LOGI(TAG, "http_server_ota_update_handler: OTA RX: %d of %d", content_received, content_len);
-
-    // We are here which means that "recv_len" is positive, now we have to check
-    // if this is the first data we are receiving or not, If so, it will have
-    // the information in the header that we need
-    if( !is_req_body_started )
-    {
-      is_req_body_started = true;
-      // Now we have to identify from where the binary file content is starting
-      // this can be done by actually checking the escape characters i.e. \r\n\r\n
-      // Get the location of the *.bin file content (remove the web form data)
-      // the strstr will return the pointer to the \r\n\r\n in the ota_buffer
-      // and then by adding 4 we reach to the start of the binary content/start
-      char *body_start_p = strstr(ota_buffer, "\r\n\r\n") + 4u;
-      int body_part_len = recv_len - (body_start_p - ota_buffer);
-      ESP_LOGI(TAG, "http_server_ota_update_handler: OTA File Size: %d", content_len);
-      /*
-       * esp_ota_begin function commence an OTA update writing to the specified
-       * partition. The specified partition is erased to the specified image
-       * size. If the image size is not yet known, OTA_SIZE_UNKNOWN is passed
-       * which will cause the entire partition to be erased.
-       * On Success this function allocates memory that remains in use until
-       * esp_ota_end is called with the return handle.
-       */
-      error = esp_ota_begin(update_partition, OTA_SIZE_UNKNOWN, &ota_handle);
-      if( error != ESP_OK )
-      {
-        ESP_LOGI(TAG, "http_server_ota_update_handler: Error with OTA Begin, Canceling OTA");
-        return ESP_FAIL;
-      }
-      else
-      {
-        ESP_LOGI(TAG, "http_server_ota_update_handler: Writing to partition subtype %d at offset 0x%lx", update_partition->subtype, update_partition->address);
-      }
-      /*
-       * esp_ota_write function, writes the OTA update to the partition.
-       * This function can be called multiple times as data is received during
-       * the OTA operation. Data is written sequentially to the partition.
-       * Here we are writing the body start for the first time.
-       */
-      esp_ota_write(ota_handle, body_start_p, body_part_len);
-      content_received += body_part_len;
-    }
-    else
-    {
-      /* Continue to receive data above using httpd_req_recv function, and write
-       * using esp_ota_write (below), until all the content is received. */
-      esp_ota_write(ota_handle, ota_buffer, recv_len);
-      content_received += recv_len;
-    }
 
-  } while ( (recv_len>0) && (content_received < content_len) );
-  // till complete data is received and written or some error is there we will
-  // remain in the above mentioned do-while loop
+  fw_update_progress = 0;
+  ota.content_len = req->content_len;
+  httpd_req_get_hdr_value_str(req, "Content-Type", content_type, sizeof(content_type));
+  is_multipart = (multipart_stream_init(&multipart, content_type, http_server_ota_part, &ota) == ESP_OK);
+  if( httpd_req_get_hdr_value_str(req, "X-Firmware-SHA256", ota.sha256, sizeof(ota.sha256)) == ESP_OK )
+  {
+    ota.sha256_len = strlen(ota.sha256);
+  }
+  ESP_LOGI(TAG, "http_server_ota_update_handler: OTA File Size: %d", req->content_len);
+
+  // image is a bit smaller than the multipart body, only this size is erased
+  config.partition = esp_ota_get_next_update_partition(NULL);
+  if( (config.partition != NULL) && (req->content_len <= config.partition->size) )
+  {
+    config.image_size = req->content_len;
+  }
+  config.progress_cb = http_server_ota_progress;
+  config.ctx = &ota;
+  config.task_stack = OTA_WRITER_TASK_STACK_SIZE;
+  config.task_priority = OTA_WRITER_TASK_PRIORITY;
+
+  recv_buffer = malloc(HTTP_SERVER_OTA_RECV_SIZE);
+  if( recv_buffer == NULL )
+  {
+    error = ESP_ERR_NO_MEM;
+  }
+  else
+  {
+    error = ota_writer_begin(&ota.writer, &config);
+  }
+  if( error != ESP_OK )
+  {
+    free(recv_buffer);
+    ESP_LOGI(TAG, "http_server_ota_update_handler: Error with OTA Begin, Canceling OTA");
+    http_server_monitor_send_msg(HTTP_MSG_WIFI_OTA_UPDATE_FAILED);
+    httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Firmware Update Failed");
+    return ESP_FAIL;
+  }
+  // a pulled download saved in the update partition is overwritten
+  ota_client_clear();
 
-  /* Finish the OTA update and validate newly written app image.
-   * After calling esp_ota_end, the handle is no longer valid and memory associated
-   * with it is freed (regardless of the results).
-   */
-  if( esp_ota_end(ota_handle) == ESP_OK )
+  while( (error == ESP_OK) && (remaining > 0) )
   {
-    // let's update the partition i.e. configure OTA data for new boot partition
-    if( esp_ota_set_boot_partition(update_partition) == ESP_OK )
+    recv_len = httpd_req_recv(req, recv_buffer, MIN(remaining, HTTP_SERVER_OTA_RECV_SIZE));
+    if( (recv_len == HTTPD_SOCK_ERR_TIMEOUT) && (++retries < HTTP_SERVER_OTA_RECV_RETRIES) )
+    {
+      ESP_LOGI(TAG, "http_server_ota_update_handler: Socket Timeout");
+      continue;     // Retry Receiving if Timeout Occurred
+    }
+    if( recv_len <= 0 )
     {
-      const esp_partition_t *boot_partition = esp_ota_get_boot_partition();
-      ESP_LOGI(TAG, "http_server_ota_update_handler: Next boot partition subtype %d at offset 0x%lx", boot_partition->subtype, boot_partition->address);
-      flash_successful = true;
+      ESP_LOGI(TAG, "http_server_ota_update_handler: OTA Receive Error, %d", recv_len);
+      error = ESP_FAIL;
+      break;
+    }
+    retries = 0;
+    remaining -= recv_len;
+    if( is_multipart )
+    {
+      error = multipart_stream_feed(&multipart, recv_buffer, recv_len);
     }
     else
     {
-      ESP_LOGI(TAG, "http_server_ota_update_handler: Flash Error");
+      ota.image_len += recv_len;
+      error = ota_writer_write(&ota.writer, recv_buffer, recv_len);
     }
   }
+  free(recv_buffer);
+
+  if( (error == ESP_OK) && is_multipart )
+  {
+    error = multipart_stream_finish(&multipart);
+  }
+  if( (error == ESP_OK) && (ota.image_len == 0) )
+  {
+    ESP_LOGI(TAG, "http_server_ota_update_handler: No firmware in request");
+    error = ESP_ERR_NOT_FOUND;
+  }
+  if( (error == ESP_OK) && ota.sha256_len )
+  {
+    error = ota_writer_sha256_parse(ota.sha256, sha256);
+  }
+
+  // finish waits for the writer task, checks the image and sets the boot partition
+  if( error == ESP_OK )
+  {
+    error = ota_writer_finish(&ota.writer, ota.sha256_len ? sha256 : NULL);
+  }
   else
   {
-    ESP_LOGI(TAG, "http_server_ota_update_handler: esp_ota_end Error");
+    ota_writer_abort(&ota.writer);
   }
 
   // We won't update the global variables throughout the file, so send the message about the status
-  if( flash_successful )
+  if( error == ESP_OK )
   {
     http_server_monitor_send_msg(HTTP_MSG_WIFI_OTA_UPDATE_SUCCESSFUL);
+    httpd_resp_sendstr(req, "Firmware Update Successful");
+    return ESP_OK;
   }
-  else
+  ESP_LOGI(TAG, "http_server_ota_update_handler: OTA Failed, %s", esp_err_to_name(error));
+  http_server_monitor_send_msg(HTTP_MSG_WIFI_OTA_UPDATE_FAILED);
+  httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Firmware Update Failed");
+  return ESP_FAIL;
+}
+
+/*
+ * Multipart callback of the firmware upload, the "file" part is the image
+ * @param ctx firmware upload
+ * @param event part event
+ * @param name form field name
+ * @param data part content
+ * @param len content length
+ * @return ESP_OK, else the error of the ota_writer
+ */
+static esp_err_t http_server_ota_part(void *ctx, multipart_event_t event, const char *name, const uint8_t *data, size_t len)
+{
+  http_server_ota_t *ota = (http_server_ota_t*)ctx;
+  size_t size;
+
+  if( strcmp(name, "sha256") == 0 )
   {
-    http_server_monitor_send_msg(HTTP_MSG_WIFI_OTA_UPDATE_FAILED);
+    // form field overrides the header
+    if( event == MULTIPART_PART_BEGIN )
+    {
+      ota->sha256_len = 0u;
+    }
+    else if( event == MULTIPART_PART_DATA )
+    {
+      size = MIN(len, (sizeof(ota->sha256) - 1u) - ota->sha256_len);
+      memcpy(&ota->sha256[ota->sha256_len], data, size);
+      ota->sha256_len += size;
+    }
+    ota->sha256[ota->sha256_len] = '\0';
+    return ESP_OK;
+  }
+
+  if( (event == MULTIPART_PART_DATA) && (strcmp(name, "file") == 0) )
+  {
+    ota->image_len += len;
+    return ota_writer_write(&ota->writer, data, len);
   }
   return ESP_OK;
 }
 
+/*
+ * Progress of the firmware update, called by the ota_writer task once a second
+ * @param ctx firmware upload
+ * @param processed image bytes handled, compressed size for a compressed image
+ * @param written bytes written to flash
+ */
+static void http_server_ota_progress(void *ctx, size_t processed, size_t written)
+{
+  http_server_ota_t *ota = (http_server_ota_t*)ctx;
+
+  if( ota->content_len )
+  {
+    fw_update_progress = MIN(100u, (processed * 100u) / ota->content_len);
+  }
+  ESP_LOGI(TAG, "http_server_ota_progress: %u of %u bytes processed, %u bytes written", processed, ota->content_len, written);
+}
+
 /*
  * OTA status handler responds with the firmware update status after the OTA
  * update is started and responds with the compile time & date when the page is
@@ -656,11 +817,23 @@ static esp_err_t http_server_ota_status_handler(httpd_req_t *req)
 static esp_err_t http_server_sensor_value_handler(httpd_req_t *req)
 {
   char sensor_JSON[100];
+  ser_writer_t writer;
   ESP_LOGI(TAG, "Sensor Readings Requested");
-  sprintf(sensor_JSON, "{\"temp\":%d,\"humidity\":\"%d\"}", get_temperature(), get_humidity() );
+
+  ser_writer_init( &writer, sensor_JSON, sizeof(sensor_JSON) );
+  ser_json_obj_begin( &writer );
+  ser_json_key( &writer, "temp" );
+  ser_json_int( &writer, get_temperature() );
+  ser_json_key( &writer, "humidity" );
+  ser_json_int( &writer, get_humidity() );
+  ser_json_obj_end( &writer );
+  if( ser_finish( &writer ) == false )
+  {
+    return httpd_resp_send_500(req);
+  }
 
   httpd_resp_set_type(req, "application/json");
-  httpd_resp_send(req, sensor_JSON, strlen(sensor_JSON));
+  httpd_resp_send(req, sensor_JSON, ser_len(&writer));
 
   return ESP_OK;
 }
@@ -844,6 +1017,162 @@ static esp_err_t http_server_get_ap_ssid_handler(httpd_req_t *req)
   return ESP_OK;
 }
 
+/*
+ * WebSocket handler, the page opens it to get the sensor values, WiFi, OTA
+ * status and local time pushed instead of polling them
+ * @param req HTTP request for which the URI needs to be handled
+ * @return ESP_OK, ESP_FAIL closes the socket if the client limit is reached
+ */
+static esp_err_t http_server_ws_handler(httpd_req_t *req)
+{
+  httpd_ws_frame_t frame = { 0 };
+  uint8_t data[16];
+  esp_err_t error;
+  int fd;
+  bool added = false;
+
+  if( req->method == HTTP_GET )
+  {
+    // handshake is done, register the socket for the live updates
+    fd = httpd_req_to_sockfd(req);
+    taskENTER_CRITICAL(&push_lock);
+    for( uint8_t slot = 0; slot < HTTP_SERVER_PUSH_CLIENTS_MAX; slot++ )
+    {
+      if( push_clients[slot].fd < 0 )
+      {
+        push_clients[slot].fd = fd;
+        push_clients[slot].resync = true;
+        push_clients[slot].head = 0u;
+        push_clients[slot].count = 0u;
+        added = true;
+        break;
+      }
+    }
+    taskEXIT_CRITICAL(&push_lock);
+
+    if( added == false )
+    {
+      // the page falls back to polling
+      ESP_LOGI(TAG, "http_server_ws_handler: client limit reached, closing socket %d", fd);
+      return ESP_FAIL;
+    }
+    // the updates are sent from the httpd task, a client which doesn't read
+    // must not hold it for the normal send_wait_timeout
+    struct timeval timeout =
+    {
+      .tv_sec = HTTP_SERVER_PUSH_SEND_TIMEOUT_MS / 1000,
+      .tv_usec = (HTTP_SERVER_PUSH_SEND_TIMEOUT_MS % 1000) * 1000,
+    };
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    ESP_LOGI(TAG, "http_server_ws_handler: live updates on socket %d", fd);
+    // send the snapshot now instead of waiting for the next period
+    http_server_monitor_send_msg(HTTP_MSG_PUSH_CLIENT_CONNECTED);
+    return ESP_OK;
+  }
+
+  // the page doesn't send anything, frames are read and discarded
+  error = httpd_ws_recv_frame(req, &frame, 0);
+  if( (error == ESP_OK) && frame.len )
+  {
+    if( frame.len > sizeof(data) )
+    {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    frame.payload = data;
+    error = httpd_ws_recv_frame(req, &frame, sizeof(data));
+  }
+  return error;
+}
+
+/*
+ * httpStats handler responds with the request statistics of all the routes,
+ * queue wait and service time in microseconds
+ * @param req HTTP request for which the URI needs to be handled
+ * @return ESP_OK
+ */
+static esp_err_t http_server_get_http_stats_handler(httpd_req_t *req)
+{
+  httpd_async_stats_t stats[HTTP_SERVER_STATS_ROUTES_MAX];
+  char *stats_JSON = malloc(HTTP_SERVER_STATS_JSON_MAX);
+  ser_writer_t writer;
+  uint8_t count;
+  esp_err_t err;
+
+  ESP_LOGI(TAG, "httpStats.json requested");
+  if( stats_JSON == NULL )
+  {
+    return httpd_resp_send_500(req);
+  }
+
+  count = httpd_async_get_stats(stats, HTTP_SERVER_STATS_ROUTES_MAX);
+  ser_writer_init( &writer, stats_JSON, HTTP_SERVER_STATS_JSON_MAX );
+  ser_json_arr_begin( &writer );
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    ser_json_obj_begin( &writer );
+    ser_json_key( &writer, "uri" );
+    ser_json_str( &writer, stats[idx].uri );
+    ser_json_key( &writer, "method" );
+    ser_json_str( &writer, http_method_str(stats[idx].method) );
+    ser_json_key( &writer, "async" );
+    ser_json_bool( &writer, stats[idx].mode != HTTPD_ASYNC_INLINE );
+    ser_json_key( &writer, "requests" );
+    ser_json_uint( &writer, stats[idx].requests );
+    ser_json_key( &writer, "failed" );
+    ser_json_uint( &writer, stats[idx].failed );
+    ser_json_key( &writer, "rejected" );
+    ser_json_uint( &writer, stats[idx].rejected );
+    ser_json_key( &writer, "wait_avg" );
+    ser_json_uint( &writer, stats[idx].wait_us_avg );
+    ser_json_key( &writer, "wait_max" );
+    ser_json_uint( &writer, stats[idx].wait_us_max );
+    ser_json_key( &writer, "service_avg" );
+    ser_json_uint( &writer, stats[idx].service_us_avg );
+    ser_json_key( &writer, "service_max" );
+    ser_json_uint( &writer, stats[idx].service_us_max );
+    ser_json_key( &writer, "active" );
+    ser_json_uint( &writer, stats[idx].active );
+    ser_json_obj_end( &writer );
+  }
+  ser_json_arr_end( &writer );
+
+  if( ser_finish( &writer ) )
+  {
+    httpd_resp_set_type(req, "application/json");
+    err = httpd_resp_send(req, stats_JSON, ser_len(&writer));
+  }
+  else
+  {
+    err = httpd_resp_send_500(req);
+  }
+  free(stats_JSON);
+  return err;
+}
+
+/*
+ * Called by httpd when a socket is closed, removes the WebSocket client and
+ * releases the updates still waiting in its queue
+ * @param hd http server instance handle
+ * @param sockfd socket which is closed
+ */
+static void http_server_close_session(httpd_handle_t hd, int sockfd)
+{
+  for( uint8_t slot = 0; slot < HTTP_SERVER_PUSH_CLIENTS_MAX; slot++ )
+  {
+    // only httpd task changes the fd of a used slot, it can be read without lock
+    if( push_clients[slot].fd == sockfd )
+    {
+      http_server_push_drop(slot);
+      taskENTER_CRITICAL(&push_lock);
+      push_clients[slot].fd = -1;
+      taskEXIT_CRITICAL(&push_lock);
+      ESP_LOGI(TAG, "http_server_close_session: live updates stopped on socket %d", sockfd);
+    }
+  }
+  // with close_fn set httpd leaves closing the socket to us
+  close(sockfd);
+}
+
 /*
  * Check the fw_update_status and creates the fw_update_reset time if the
  * fw_update_status is true
@@ -862,3 +1191,280 @@ static void http_server_fw_update_reset_timer(void)
     ESP_LOGI(TAG, "http_server_fw_update_reset_timer: FW Update unsuccessful");
   }
 }
+
+/*
+ * Collects the values shown on the web page and queues the changed ones for
+ * all the WebSocket clients, called by the monitor task every push period and
+ * after every monitor message
+ */
+static void http_server_push_update(void)
+{
+  http_server_live_t live = { 0 };
+  http_server_push_msg_t *delta = NULL;
+  http_server_push_msg_t *snapshot = NULL;
+  bool connected = false;
+  bool resync = false;
+
+  if( http_server_handle == NULL )
+  {
+    return;
+  }
+
+  live.temperature = get_temperature();
+  live.humidity = get_humidity();
+  live.wifi_connect_status = g_wifi_connect_status;
+  live.ota_update_status = fw_update_status;
+  live.ota_progress = fw_update_progress;
+  // time has second resolution, but reading it is logged, so it is read slower
+  if( g_is_local_time_set && \
+      ((push_last.time[0] == '\0') || ((xTaskGetTickCount() - push_time_tick) >= pdMS_TO_TICKS(HTTP_SERVER_PUSH_TIME_PERIOD))) )
+  {
+    push_time_tick = xTaskGetTickCount();
+    strlcpy(live.time, sntp_time_sync_get_time(), sizeof(live.time));
+  }
+  else
+  {
+    memcpy(live.time, push_last.time, sizeof(live.time));
+  }
+
+  taskENTER_CRITICAL(&push_lock);
+  for( uint8_t slot = 0; slot < HTTP_SERVER_PUSH_CLIENTS_MAX; slot++ )
+  {
+    if( push_clients[slot].fd >= 0 )
+    {
+      connected = true;
+      resync |= push_clients[slot].resync;
+    }
+  }
+  taskEXIT_CRITICAL(&push_lock);
+
+  // one message of each kind is built and shared by all the clients
+  if( connected )
+  {
+    delta = http_server_push_msg_create(&live, &push_last);
+    if( resync )
+    {
+      snapshot = http_server_push_msg_create(&live, NULL);
+    }
+    http_server_push_enqueue(delta, snapshot);
+    http_server_push_msg_release(delta);
+    http_server_push_msg_release(snapshot);
+  }
+  push_last = live;
+}
+
+/*
+ * Builds the JSON text frame with the values changed since last
+ * @param live values to be sent
+ * @param last values sent before, NULL for a full snapshot
+ * @return message with one reference, NULL if nothing has changed
+ */
+static http_server_push_msg_t *http_server_push_msg_create(const http_server_live_t *live, const http_server_live_t *last)
+{
+  char buffer[HTTP_SERVER_PUSH_MSG_MAX];
+  ser_writer_t writer;
+  http_server_push_msg_t *msg;
+  bool changed = false;
+
+  ser_writer_init( &writer, buffer, sizeof(buffer) );
+  ser_json_obj_begin( &writer );
+  if( (last == NULL) || (live->temperature != last->temperature) )
+  {
+    ser_json_key( &writer, "temp" );
+    ser_json_int( &writer, live->temperature );
+    changed = true;
+  }
+  if( (last == NULL) || (live->humidity != last->humidity) )
+  {
+    ser_json_key( &writer, "humidity" );
+    ser_json_int( &writer, live->humidity );
+    changed = true;
+  }
+  if( (last == NULL) || (live->wifi_connect_status != last->wifi_connect_status) )
+  {
+    ser_json_key( &writer, "wifi_connect_status" );
+    ser_json_int( &writer, live->wifi_connect_status );
+    changed = true;
+  }
+  if( (last == NULL) || (live->ota_update_status != last->ota_update_status) )
+  {
+    ser_json_key( &writer, "ota_update_status" );
+    ser_json_int( &writer, live->ota_update_status );
+    changed = true;
+  }
+  if( (last == NULL) || (live->ota_progress != last->ota_progress) )
+  {
+    ser_json_key( &writer, "ota_progress" );
+    ser_json_int( &writer, live->ota_progress );
+    changed = true;
+  }
+  if( live->time[0] && ((last == NULL) || strcmp(live->time, last->time)) )
+  {
+    ser_json_key( &writer, "time" );
+    ser_json_str( &writer, live->time );
+    changed = true;
+  }
+  ser_json_obj_end( &writer );
+
+  if( changed == false )
+  {
+    return NULL;
+  }
+  if( ser_finish( &writer ) == false )
+  {
+    ESP_LOGI(TAG, "http_server_push_msg_create: message truncated");
+    return NULL;
+  }
+
+  msg = malloc(sizeof(http_server_push_msg_t) + ser_len(&writer));
+  if( msg == NULL )
+  {
+    return NULL;
+  }
+  msg->refs = 1u;
+  msg->len = ser_len(&writer);
+  memcpy(msg->data, buffer, msg->len);
+  return msg;
+}
+
+/*
+ * Releases one reference of the message, it is freed with the last one
+ * @param msg message to be released, NULL is ignored
+ */
+static void http_server_push_msg_release(http_server_push_msg_t *msg)
+{
+  bool last;
+
+  if( msg == NULL )
+  {
+    return;
+  }
+  taskENTER_CRITICAL(&push_lock);
+  last = (--msg->refs == 0u);
+  taskEXIT_CRITICAL(&push_lock);
+  if( last )
+  {
+    free(msg);
+  }
+}
+
+/*
+ * Queues the message for every client, a client whose queue is full doesn't
+ * get the delta and is marked for a full snapshot once it has caught up,
+ * this way a slow page never holds more than the queue length of messages
+ * @param delta changed values, for the clients which are in sync
+ * @param snapshot all values, for the new and the lagging clients
+ */
+static void http_server_push_enqueue(http_server_push_msg_t *delta, http_server_push_msg_t *snapshot)
+{
+  http_server_push_client_t *client;
+  http_server_push_msg_t *msg;
+  bool start[HTTP_SERVER_PUSH_CLIENTS_MAX] = { false };
+
+  taskENTER_CRITICAL(&push_lock);
+  for( uint8_t slot = 0; slot < HTTP_SERVER_PUSH_CLIENTS_MAX; slot++ )
+  {
+    client = &push_clients[slot];
+    msg = client->resync ? snapshot : delta;
+    if( (client->fd < 0) || (msg == NULL) )
+    {
+      continue;
+    }
+    if( client->count >= HTTP_SERVER_PUSH_QUEUE_LEN )
+    {
+      client->resync = true;
+      continue;
+    }
+    client->queue[(client->head + client->count) % HTTP_SERVER_PUSH_QUEUE_LEN] = msg;
+    msg->refs++;
+    client->resync = false;
+    // empty queue has no send work pending, start one
+    start[slot] = (client->count++ == 0u);
+  }
+  taskEXIT_CRITICAL(&push_lock);
+
+  for( uint8_t slot = 0; slot < HTTP_SERVER_PUSH_CLIENTS_MAX; slot++ )
+  {
+    if( start[slot] && \
+        (httpd_queue_work(http_server_handle, http_server_push_work, (void*)(uintptr_t)slot) != ESP_OK) )
+    {
+      http_server_push_drop(slot);
+    }
+  }
+}
+
+/*
+ * Releases the queued messages of the client, the client gets a full
+ * snapshot with the next update
+ * @param slot index of the client
+ */
+static void http_server_push_drop(uint8_t slot)
+{
+  http_server_push_client_t *client = &push_clients[slot];
+  http_server_push_msg_t *queued[HTTP_SERVER_PUSH_QUEUE_LEN];
+  uint8_t count;
+
+  taskENTER_CRITICAL(&push_lock);
+  count = client->count;
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    queued[idx] = client->queue[(client->head + idx) % HTTP_SERVER_PUSH_QUEUE_LEN];
+  }
+  client->head = 0u;
+  client->count = 0u;
+  client->resync = true;
+  taskEXIT_CRITICAL(&push_lock);
+
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    http_server_push_msg_release(queued[idx]);
+  }
+}
+
+/*
+ * Send work running in the httpd task, sends the queue of one client until
+ * it is empty, if sending fails the socket is closed. While it runs no other
+ * request is served, a send is limited by the socket send timeout set in
+ * http_server_ws_handler (HTTP_SERVER_PUSH_SEND_TIMEOUT_MS)
+ * @param arg index of the client
+ */
+static void http_server_push_work(void *arg)
+{
+  http_server_push_client_t *client = &push_clients[(uintptr_t)arg];
+  http_server_push_msg_t *msg;
+  httpd_ws_frame_t frame = { 0 };
+  int fd;
+  bool more = true;
+
+  frame.type = HTTPD_WS_TYPE_TEXT;
+  frame.final = true;
+  while( more )
+  {
+    taskENTER_CRITICAL(&push_lock);
+    msg = client->count ? client->queue[client->head] : NULL;
+    fd = client->fd;
+    taskEXIT_CRITICAL(&push_lock);
+    // client closed since the work is queued
+    if( msg == NULL )
+    {
+      break;
+    }
+
+    frame.payload = (uint8_t*)msg->data;
+    frame.len = msg->len;
+    if( httpd_ws_send_frame_async(http_server_handle, fd, &frame) != ESP_OK )
+    {
+      // queue is released by http_server_close_session
+      ESP_LOGI(TAG, "http_server_push_work: send failed, closing socket %d", fd);
+      httpd_sess_trigger_close(http_server_handle, fd);
+      break;
+    }
+
+    taskENTER_CRITICAL(&push_lock);
+    client->head = (client->head + 1u) % HTTP_SERVER_PUSH_QUEUE_LEN;
+    client->count--;
+    more = (client->count != 0u);
+    taskEXIT_CRITICAL(&push_lock);
+    http_server_push_msg_release(msg);
+  }
+}
@@ -26,6 +26,7 @@ typedef enum http_server_msg
   HTTP_MSG_WIFI_OTA_UPDATE_SUCCESSFUL,
   HTTP_MSG_WIFI_OTA_UPDATE_FAILED,
   HTTP_MSG_TIME_SERVICE_INITIALIZED,
+  HTTP_MSG_PUSH_CLIENT_CONNECTED,
 } http_server_msg_e;
 
 /*
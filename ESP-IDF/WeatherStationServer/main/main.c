@@ -10,6 +10,7 @@
 #include "dht11.h"
 #include "wifi_reset_button.h"
 #include "sntp_time_sync.h"
+#include "ota_pull.h"
 
 // Macros
 #define MAIN_TASK_PERIOD            (5000)
@@ -92,4 +93,5 @@ static void wifi_application_connected_events( void )
 {
   ESP_LOGI(TAG, "WiFi Application Connected!");
   sntp_time_sync_task_start();
+  ota_pull_task_start();
 }
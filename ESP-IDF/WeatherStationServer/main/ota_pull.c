@@ -0,0 +1,99 @@
+/*
+ * ota_pull.c
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: xpress_embedo
+ */
+
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+
+#include "ota_client.h"
+#include "tasks_common.h"
+#include "http_server.h"
+#include "ota_pull.h"
+
+// Macros
+#define OTA_PULL_INTERVAL_MS            ((uint32_t)CONFIG_OTA_PULL_INTERVAL_MIN * 60u * 1000u)
+#define OTA_PULL_RESUME_MS              (60u * 1000u)   // interrupted download is continued after
+
+// Private Variables
+static const char TAG[] = "OTA Pull";
+static TaskHandle_t ota_pull_task_handle = NULL;
+
+// Private Function Prototypes
+static void ota_pull_task( void *pvParam );
+static void ota_pull_progress( void *ctx, size_t processed, size_t written );
+
+// Public Function Definitions
+/*
+ * Starts the firmware pull task, called on every WiFi connection, the task is
+ * started only once and only if an update URL is configured
+ */
+void ota_pull_task_start( void )
+{
+  if( (ota_pull_task_handle == NULL) && (strlen(CONFIG_OTA_PULL_URL) > 0) )
+  {
+    xTaskCreate(&ota_pull_task, "OTA Pull", OTA_PULL_TASK_STACK_SIZE, NULL, OTA_PULL_TASK_PRIORITY, &ota_pull_task_handle);
+  }
+}
+
+// Private Function Definition
+/*
+ * The firmware pull task, checks the update URL at start and then every
+ * CONFIG_OTA_PULL_INTERVAL_MIN minutes. A new image is downloaded and the
+ * device restarts with it, an interrupted download is resumed.
+ * @param pvParam parameter which can be passed to the task
+ */
+static void ota_pull_task( void *pvParam )
+{
+  ota_client_config_t config = OTA_CLIENT_CONFIG_DEFAULT();
+  ota_client_stats_t stats;
+  esp_err_t err;
+
+  config.url = CONFIG_OTA_PULL_URL;
+  config.progress_cb = ota_pull_progress;
+  config.task_stack = OTA_WRITER_TASK_STACK_SIZE;
+  config.task_priority = OTA_WRITER_TASK_PRIORITY;
+
+  for(;;)
+  {
+    err = ota_client_update(&config);
+    ota_client_get_stats(&stats);
+    ESP_LOGI(TAG, "%lu requests, %lu retries, %lu restarts, resumed at %u, %u bytes downloaded", \
+             stats.requests, stats.retries, stats.restarts, stats.resumed_at, stats.downloaded);
+    if( err == ESP_OK )
+    {
+      // same as an upload from the web page, the device restarts after a few seconds
+      http_server_monitor_send_msg(HTTP_MSG_WIFI_OTA_UPDATE_SUCCESSFUL);
+      break;
+    }
+    if( ota_client_is_pending() )
+    {
+      vTaskDelay(OTA_PULL_RESUME_MS / portTICK_PERIOD_MS);
+    }
+    else if( OTA_PULL_INTERVAL_MS )
+    {
+      vTaskDelay(OTA_PULL_INTERVAL_MS / portTICK_PERIOD_MS);
+    }
+    else
+    {
+      break;
+    }
+  }
+  vTaskDelete(NULL);
+}
+
+/*
+ * Progress of the download, called by the ota_writer task once a second
+ * @param ctx not used
+ * @param processed bytes downloaded by this update
+ * @param written image bytes in flash, including the resumed part
+ */
+static void ota_pull_progress( void *ctx, size_t processed, size_t written )
+{
+  ESP_LOGI(TAG, "ota_pull_progress: %u bytes downloaded, %u bytes of the image written", processed, written);
+}
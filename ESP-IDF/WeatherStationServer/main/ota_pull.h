@@ -0,0 +1,14 @@
+/*
+ * ota_pull.h
+ *
+ *  Created on: 19-Oct-2026
+ *      Author: xpress_embedo
+ */
+
+#ifndef MAIN_OTA_PULL_H_
+#define MAIN_OTA_PULL_H_
+
+// Public Function Prototypes
+void ota_pull_task_start( void );
+
+#endif /* MAIN_OTA_PULL_H_ */
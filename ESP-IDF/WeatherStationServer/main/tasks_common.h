@@ -16,6 +16,10 @@
 #define HTTP_SERVER_TASK_STACK_SIZE             (8*1024u)
 #define HTTP_SERVER_TASK_PRIORITY               (4u)
 
+// HTTP Server Workers, slow requests (firmware upload, local time) below the HTTP Server Task
+#define HTTP_SERVER_WORKER_STACK_SIZE           (6*1024u)
+#define HTTP_SERVER_WORKER_PRIORITY             (3u)
+
 // HTTP Server Monitor
 #define HTTP_SERVER_MONITOR_STACK_SIZE          (4*1024u)
 #define HTTP_SERVER_MONITOR_PRIORITY            (3u)
@@ -28,4 +32,12 @@
 #define SNTP_TIME_SYNC_TASK_STACK_SIZE          (4*1024u)
 #define SNTP_TIME_SYNC_TASK_PRIORIY             (4u)
 
+// OTA Writer Task, above the HTTP Server Worker which receives the image
+#define OTA_WRITER_TASK_STACK_SIZE              (4*1024u)
+#define OTA_WRITER_TASK_PRIORITY                (5u)
+
+// OTA Pull Task, TLS handshake needs the stack, downloads in the background
+#define OTA_PULL_TASK_STACK_SIZE                (6*1024u)
+#define OTA_PULL_TASK_PRIORITY                  (2u)
+
 #endif /* MAIN_TASKS_COMMON_H_ */
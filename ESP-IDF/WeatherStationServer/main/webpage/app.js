@@ -4,6 +4,10 @@
 var seconds = null;
 var otaTimerVar = null;
 var wifiConnectInterval = null;
+var sensorInterval = null;
+var localTimeInterval = null;
+var liveSocket = null;
+var liveConnectPending = false;
 
 /**
  * Initialize functions here.
@@ -12,8 +16,8 @@ $(document).ready(function()
 {
   getSSID();
   getUpdateStatus();
-  startSensorInterval();
-  startLocalTimeInterval();
+  // values are pushed over WebSocket, polling is only used without it
+  startLiveUpdates();
   // earlier I commented out this function, but this is also important
   // for the scenarios when the user has refreshed the web page
   getConnectInfo();
@@ -38,37 +42,82 @@ function getFileInfo()
   var file = x.files[0];
 
   document.getElementById("file_info").innerHTML = "<h4>File: " + file.name + "<br>" + "Size: " + file.size + " bytes</h4>";
+  // hash of the previous file must not be sent with this one
+  document.getElementById("firmware_sha256").value = "";
 }
 
 /**
  * Handles the firmware update.
+ * The SHA-256 of the image is sent in the "sha256" field, the device checks the
+ * written image against it before booting it. It is taken from the SHA-256
+ * input, or computed here for a .bin file when the browser allows it (WebCrypto
+ * needs https or localhost). A .zz file is compressed, its hash is the one of
+ * the uncompressed image printed by ota_compress.py, so it has to be entered.
  */
 function updateFirmware() 
 {
-  // Form Data
-  var formData = new FormData();
   var fileSelect = document.getElementById("selected_file");
+  var sha256 = document.getElementById("firmware_sha256").value.trim().toLowerCase();
   
-  if (fileSelect.files && fileSelect.files.length == 1) 
+  if (!fileSelect.files || fileSelect.files.length != 1) 
   {
-    var file = fileSelect.files[0];
-    formData.set("file", file, file.name);
-    document.getElementById("ota_update_status").innerHTML = "Uploading " + file.name + ", Firmware Update in Progress...";
-
-    // Http Request
-    var request = new XMLHttpRequest();
+    window.alert('Select A File First')
+    return;
+  }
 
-    request.upload.addEventListener("progress", updateProgress);
-    request.open('POST', "/OTAupdate");
-    request.responseType = "blob";
-    request.send(formData);
+  var file = fileSelect.files[0];
+  if (sha256.length > 0)
+  {
+    if (!/^[0-9a-f]{64}$/.test(sha256))
+    {
+      window.alert('SHA-256 must be 64 hex digits');
+      return;
+    }
+    uploadFirmware(file, sha256);
   }
-  else 
+  else if (!file.name.endsWith(".zz") && window.crypto && window.crypto.subtle)
   {
-    window.alert('Select A File First')
+    document.getElementById("ota_update_status").innerHTML = "Computing SHA-256 of " + file.name + "...";
+    file.arrayBuffer().then(function(data) {
+      return window.crypto.subtle.digest("SHA-256", data);
+    }).then(function(digest) {
+      var hex = Array.from(new Uint8Array(digest), function(b) {
+        return b.toString(16).padStart(2, "0");
+      }).join("");
+      document.getElementById("firmware_sha256").value = hex;
+      uploadFirmware(file, hex);
+    }).catch(function() {
+      document.getElementById("ota_update_status").innerHTML = "!!! Unable to read " + file.name + " !!!";
+    });
+  }
+  else
+  {
+    window.alert('Enter the SHA-256 of the firmware image (sha256sum of the .bin file)');
   }
 }
 
+/**
+ * Uploads the firmware image with its SHA-256.
+ */
+function uploadFirmware(file, sha256)
+{
+  // Form Data
+  var formData = new FormData();
+  formData.set("sha256", sha256);
+  formData.set("file", file, file.name);
+  document.getElementById("ota_update_status").innerHTML = "Uploading " + file.name + ", Firmware Update in Progress...";
+
+  // Http Request
+  var request = new XMLHttpRequest();
+
+  request.upload.addEventListener("progress", updateProgress);
+  // server answers once the image is written and checked
+  request.addEventListener("load", getUpdateStatus);
+  request.open('POST', "/OTAupdate");
+  request.responseType = "blob";
+  request.send(formData);
+}
+
 /**
  * Progress on transfers from the server to the client (downloads).
  */
@@ -76,7 +125,11 @@ function updateProgress(oEvent)
 {
   if (oEvent.lengthComputable) 
   {
-    getUpdateStatus();
+    // with live updates the written bytes are shown instead
+    if (!isLive())
+    {
+      document.getElementById("ota_update_status").innerHTML = "Firmware Update in Progress... " + Math.round((oEvent.loaded * 100) / oEvent.total) + "%";
+    }
   } 
   else 
   {
@@ -100,19 +153,32 @@ function getUpdateStatus()
 
     document.getElementById("latest_firmware").innerHTML = response.compile_date + " - " + response.compile_time
 
-    // If flashing was complete it will return a 1, else -1
-    // A return of 0 is just for information on the Latest Firmware request
-    if (response.ota_update_status == 1)
-    {
-      // Set the countdown timer time
-      seconds = 10;
-      // Start the countdown timer
-      otaRebootTimer();
-      } 
-    else if (response.ota_update_status == -1)
+    showUpdateStatus(response.ota_update_status);
+  }
+}
+
+/**
+ * Shows the firmware update status, from the request or the live updates.
+ */
+function showUpdateStatus(status)
+{
+  // If flashing was complete it will return a 1, else -1
+  // A return of 0 is just for information on the Latest Firmware request
+  if (status == 1)
+  {
+    // countdown is already running
+    if (seconds != null)
     {
-      document.getElementById("ota_update_status").innerHTML = "!!! Upload Error !!!";
+      return;
     }
+    // Set the countdown timer time
+    seconds = 10;
+    // Start the countdown timer
+    otaRebootTimer();
+  }
+  else if (status == -1)
+  {
+    document.getElementById("ota_update_status").innerHTML = "!!! Upload Error !!!";
   }
 }
 
@@ -147,7 +213,92 @@ function getSensorValues()
 function startSensorInterval()
 {
   // Call this function every 5 seconds
-  setInterval(getSensorValues, 5000);
+  if( sensorInterval == null )
+  {
+    sensorInterval = setInterval(getSensorValues, 5000);
+  }
+}
+
+// Opens the WebSocket, the server pushes the changed values only
+function startLiveUpdates()
+{
+  if( !("WebSocket" in window) )
+  {
+    startSensorInterval();
+    startLocalTimeInterval();
+    return;
+  }
+
+  liveSocket = new WebSocket("ws://" + window.location.host + "/ws");
+  liveSocket.onopen = function() {
+    stopPolling();
+  };
+  liveSocket.onmessage = function(event) {
+    updateLiveValues(JSON.parse(event.data));
+  };
+  // server closes the socket if too many pages are open, then poll and retry later
+  liveSocket.onclose = function() {
+    liveSocket = null;
+    startSensorInterval();
+    startLocalTimeInterval();
+    if( liveConnectPending )
+    {
+      liveConnectPending = false;
+      startWiFiConnectStatusInterval();
+    }
+    setTimeout(startLiveUpdates, 10000);
+  };
+}
+
+// Checks if the values are pushed by the server
+function isLive()
+{
+  return (liveSocket != null) && (liveSocket.readyState == WebSocket.OPEN);
+}
+
+// Stops the intervals replaced by the live updates
+function stopPolling()
+{
+  if( sensorInterval != null )
+  {
+    clearInterval(sensorInterval);
+    sensorInterval = null;
+  }
+  if( localTimeInterval != null )
+  {
+    clearInterval(localTimeInterval);
+    localTimeInterval = null;
+  }
+}
+
+// Updates the web page with the values pushed by the server
+function updateLiveValues(data)
+{
+  if( "temp" in data )
+  {
+    $("#temperature_value").text(data["temp"]);
+  }
+  if( "humidity" in data )
+  {
+    $("#humidity_value").text(data["humidity"]);
+  }
+  if( "time" in data )
+  {
+    $("#local_time").text(data["time"]);
+  }
+  if( ("ota_progress" in data) && (data["ota_progress"] > 0) && (seconds == null) )
+  {
+    document.getElementById("ota_update_status").innerHTML = "Firmware Update in Progress... " + data["ota_progress"] + "%";
+  }
+  if( "ota_update_status" in data )
+  {
+    showUpdateStatus(data["ota_update_status"]);
+  }
+  // connection status is only shown after the connect button is pressed
+  if( ("wifi_connect_status" in data) && liveConnectPending )
+  {
+    liveConnectPending = !showWiFiConnectStatus(data["wifi_connect_status"]);
+  }
 }
 
 // Clear the Connection Status Interval
@@ -171,22 +322,32 @@ function getWiFiConnectStatus()
   if( (xhr.readyState == 4) && (xhr.status == 200) )
   {
     var response = JSON.parse(xhr.responseText);
-    document.getElementById("wifi_connect_status").innerHTML = "Connecting.....";
-
-    if( response.wifi_connect_status == 2 )
+    if( showWiFiConnectStatus(response.wifi_connect_status) )
     {
-      document.getElementById("wifi_connect_status").innerHTML = "<h4 class='rd'>Failed to Connect. Please check AP credentials and compatibility</h4>";
       stopWiFiConnectStatusInterval();
     }
-    else if( response.wifi_connect_status == 3 )
-    {
-      document.getElementById("wifi_connect_status").innerHTML = "<h4 class='gr'>Connection Success!</h4>";
-      stopWiFiConnectStatusInterval();
-      getConnectInfo();
-    }
   }
 }
 
+// Shows the WiFi Connection Status, returns true when connecting is finished
+function showWiFiConnectStatus(status)
+{
+  document.getElementById("wifi_connect_status").innerHTML = "Connecting.....";
+
+  if( status == 2 )
+  {
+    document.getElementById("wifi_connect_status").innerHTML = "<h4 class='rd'>Failed to Connect. Please check AP credentials and compatibility</h4>";
+    return true;
+  }
+  else if( status == 3 )
+  {
+    document.getElementById("wifi_connect_status").innerHTML = "<h4 class='gr'>Connection Success!</h4>";
+    getConnectInfo();
+    return true;
+  }
+  return false;
+}
+
 // Starts the interval for checking the connection status
 function startWiFiConnectStatusInterval()
 {
@@ -210,7 +371,15 @@ function connectWiFi()
     data: { 'timestamp': Date.now() }
   });
 
-  startWiFiConnectStatusInterval();
+  // with live updates the status is pushed when it changes
+  if( isLive() )
+  {
+    liveConnectPending = true;
+  }
+  else
+  {
+    startWiFiConnectStatusInterval();
+  }
 }
 
 // Check the Entered Connection when "Connect" button is pressed
@@ -308,7 +477,10 @@ function disconnectWiFi()
 function startLocalTimeInterval()
 {
   // call function getLocalTime every 10 seconds
-  setInterval(getLocalTime, 10000);
+  if( localTimeInterval == null )
+  {
+    localTimeInterval = setInterval(getLocalTime, 10000);
+  }
 }
 
 // Gets the Local Time
@@ -0,0 +1,320 @@
+#!/usr/bin/env python3
+"""
+ws_load_test.py
+
+ Created on: Oct 19, 2026
+     Author: xpress_embedo
+
+Host side load test of the WebSocket live updates (/ws) of WeatherStationServer.
+It opens many WebSocket clients at the same time, a few of them never read
+(slow clients), and polls a normal HTTP route meanwhile. Checked are:
+  - the server accepts at most --max-clients clients and closes the others,
+    so the page falls back to polling
+  - fan-out: every accepted client starts with a full snapshot and all the
+    reading clients get the same updates
+  - the HTTP route stays responsive, the pushes run on the httpd task and a
+    slow socket must not stall it (each send is limited by
+    CONFIG_HTTP_SERVER_PUSH_SEND_TIMEOUT_MS)
+  - slow clients are dropped by the server once their socket buffers are
+    full; the updates are small (about 40 bytes every 10 s), so this takes
+    long, use a long --duration with --require-drop to check it
+  - with --upload, a firmware image is sent to /OTAupdate at --upload-rate
+    meanwhile: the polled route must stay responsive during the upload (it
+    runs in an httpd_async worker) and a second upload must get 503 with
+    Retry-After. The last KB isn't sent, the device aborts the update and
+    keeps running, unless --upload-complete is given
+Only the standard library is used.
+
+  python ws_load_test.py 192.168.0.1
+  python ws_load_test.py 192.168.0.1 --clients 50 --slow 2 --duration 60
+  python ws_load_test.py 192.168.0.1 --slow 1 --duration 1800 --require-drop
+  python ws_load_test.py 192.168.0.1 --clients 0 --slow 0 --upload build/WeatherStationServer.bin --duration 30
+"""
+import argparse
+import asyncio
+import base64
+import hashlib
+import json
+import os
+import socket
+import struct
+import sys
+import time
+
+WS_GUID = '258EAFA5-E914-47DA-95CA-C5AB0DC85B11'
+SNAPSHOT_KEYS = {'temp', 'humidity', 'wifi_connect_status', 'ota_update_status', 'ota_progress'}
+OP_TEXT, OP_CLOSE, OP_PING, OP_PONG = 0x1, 0x8, 0x9, 0xA
+UPLOAD_SEGMENT = 1436               # TCP payload of one segment
+
+
+class Client:
+    def __init__(self, idx, slow):
+        self.idx = idx
+        self.slow = slow
+        self.accepted = False       # handshake done and first update received
+        self.closed = False         # closed by the server
+        self.messages = []          # (time, dict)
+        self.invalid = 0            # frames which are not JSON objects
+        self.error = None
+
+
+def ws_frame(opcode, payload=b''):
+    """Client frames must be masked."""
+    mask = os.urandom(4)
+    header = bytes([0x80 | opcode])
+    if len(payload) < 126:
+        header += bytes([0x80 | len(payload)])
+    else:
+        header += bytes([0x80 | 126]) + struct.pack('!H', len(payload))
+    return header + mask + bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+
+
+async def ws_read_frame(reader):
+    hdr = await reader.readexactly(2)
+    opcode = hdr[0] & 0x0F
+    length = hdr[1] & 0x7F
+    if length == 126:
+        length = struct.unpack('!H', await reader.readexactly(2))[0]
+    elif length == 127:
+        length = struct.unpack('!Q', await reader.readexactly(8))[0]
+    mask = await reader.readexactly(4) if hdr[1] & 0x80 else None
+    payload = await reader.readexactly(length)
+    if mask:
+        payload = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+    return opcode, payload
+
+
+async def ws_connect(args, slow):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    if slow:
+        # small receive window, the server send buffer fills up sooner
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, args.rcvbuf)
+    sock.setblocking(False)
+    await asyncio.wait_for(asyncio.get_running_loop().sock_connect(sock, (args.host, args.port)), args.timeout)
+    reader, writer = await asyncio.open_connection(sock=sock)
+    key = base64.b64encode(os.urandom(16)).decode()
+    writer.write((f'GET /ws HTTP/1.1\r\nHost: {args.host}\r\nUpgrade: websocket\r\n'
+                  f'Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\n'
+                  f'Sec-WebSocket-Version: 13\r\n\r\n').encode())
+    await writer.drain()
+    response = await asyncio.wait_for(reader.readuntil(b'\r\n\r\n'), args.timeout)
+    expected = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+    if b' 101 ' not in response.split(b'\r\n')[0] or expected.encode() not in response:
+        writer.close()
+        raise ConnectionError('handshake failed: ' + response.split(b'\r\n')[0].decode(errors='replace'))
+    return reader, writer
+
+
+async def run_client(args, client, end_time):
+    try:
+        reader, writer = await ws_connect(args, client.slow)
+    except (OSError, asyncio.TimeoutError, asyncio.IncompleteReadError, ConnectionError) as err:
+        client.error = str(err) or type(err).__name__
+        client.closed = True
+        return
+    try:
+        if client.slow:
+            # connected, but the updates are never read till the end, then the
+            # backlog is read to see if the server has closed the socket
+            await asyncio.sleep(max(0.0, end_time - time.monotonic()))
+            end_time = time.monotonic() + args.drain
+        while time.monotonic() < end_time:
+            opcode, payload = await asyncio.wait_for(ws_read_frame(reader), end_time - time.monotonic())
+            if opcode == OP_CLOSE:
+                client.closed = True
+                break
+            if opcode == OP_PING:
+                writer.write(ws_frame(OP_PONG, payload))
+                continue
+            if opcode == OP_TEXT:
+                client.accepted = True
+                try:
+                    client.messages.append((time.monotonic(), dict(json.loads(payload))))
+                except (ValueError, TypeError):
+                    client.invalid += 1
+    except asyncio.TimeoutError:
+        pass
+    except (asyncio.IncompleteReadError, ConnectionError, OSError):
+        client.closed = True
+    finally:
+        writer.close()
+
+
+async def poll_http(args, end_time, latencies):
+    while time.monotonic() < end_time:
+        start = time.monotonic()
+        try:
+            reader, writer = await asyncio.wait_for(asyncio.open_connection(args.host, args.port), args.timeout)
+            writer.write(f'GET {args.http_path} HTTP/1.1\r\nHost: {args.host}\r\nConnection: close\r\n\r\n'.encode())
+            await writer.drain()
+            await asyncio.wait_for(reader.read(), args.timeout)
+            writer.close()
+            latencies.append((start, time.monotonic() - start))
+        except (OSError, asyncio.TimeoutError):
+            latencies.append((start, None))
+        await asyncio.sleep(args.http_period)
+
+
+async def post_upload(args, image, send_len, rate, progress, answer):
+    """POST the image as raw body, send_len bytes of it paced at rate bytes/s,
+    returns the status line and headers if an answer is expected."""
+    reader, writer = await asyncio.wait_for(asyncio.open_connection(args.host, args.port), args.timeout)
+    try:
+        writer.write((f'POST /OTAupdate HTTP/1.1\r\nHost: {args.host}\r\n'
+                      f'Content-Type: application/octet-stream\r\nContent-Length: {len(image)}\r\n'
+                      f'Connection: close\r\n\r\n').encode())
+        start = time.monotonic()
+        for offset in range(0, send_len, UPLOAD_SEGMENT):
+            writer.write(image[offset:min(offset + UPLOAD_SEGMENT, send_len)])
+            await writer.drain()
+            progress['sent'] = min(offset + UPLOAD_SEGMENT, send_len)
+            await asyncio.sleep(max(0.0, start + progress['sent'] / rate - time.monotonic()))
+        if not answer:
+            return b''
+        return await asyncio.wait_for(reader.readuntil(b'\r\n\r\n'), args.timeout)
+    finally:
+        writer.close()
+
+
+async def upload_firmware(args, upload):
+    """The upload, and a second one while it runs, which must be rejected."""
+    with open(args.upload, 'rb') as f:
+        image = f.read()
+    send_len = len(image) if args.upload_complete else max(0, len(image) - 1024)
+
+    async def second_upload():
+        # only the headers, the handler is called (or the request rejected) after them
+        await asyncio.sleep(1.0)
+        try:
+            upload['second'] = await post_upload(args, image, 0, 1.0, {}, True)
+        except (OSError, asyncio.TimeoutError, asyncio.IncompleteReadError) as err:
+            upload['second'] = str(err).encode() or type(err).__name__.encode()
+
+    upload['start'] = time.monotonic()
+    task = asyncio.create_task(second_upload())
+    try:
+        upload['response'] = await post_upload(args, image, send_len, args.upload_rate * 1024, upload,
+                                               args.upload_complete)
+    except (OSError, asyncio.TimeoutError, asyncio.IncompleteReadError) as err:
+        upload['error'] = str(err) or type(err).__name__
+    upload['end'] = time.monotonic()
+    upload['size'] = len(image)
+    await task
+
+
+async def main(args):
+    clients = [Client(idx, idx < args.slow) for idx in range(args.clients)]
+    latencies = []
+    upload = {}
+    end_time = time.monotonic() + args.duration
+
+    # slow clients first, so they get a slot for sure
+    slow_tasks = [asyncio.create_task(run_client(args, c, end_time)) for c in clients if c.slow]
+    await asyncio.sleep(1.0)
+    tasks = slow_tasks + [asyncio.create_task(run_client(args, c, end_time)) for c in clients if not c.slow]
+    tasks.append(asyncio.create_task(poll_http(args, end_time, latencies)))
+    if args.upload:
+        tasks.append(asyncio.create_task(upload_firmware(args, upload)))
+    await asyncio.gather(*tasks)
+
+    failures = []
+    fast = [c for c in clients if not c.slow and c.accepted]
+    slow = [c for c in clients if c.slow]
+    accepted = [c for c in clients if c.accepted or (c.slow and not c.error)]
+    print(f'clients: {len(clients)}, accepted: {len(accepted)}, reading: {len(fast)}, slow: {len(slow)}')
+    if len(accepted) > args.max_clients:
+        failures.append(f'{len(accepted)} clients accepted, limit is {args.max_clients}')
+    if args.clients and not fast:
+        failures.append('no reading client received an update')
+
+    # fan-out, every reading client starts with a snapshot and gets the same updates
+    for c in clients:
+        if c.invalid:
+            failures.append(f'client {c.idx}: {c.invalid} frames are not JSON objects')
+    for c in fast:
+        if not c.messages or not SNAPSHOT_KEYS.issubset(c.messages[0][1]):
+            failures.append(f'client {c.idx}: first message is not a snapshot')
+    if fast:
+        counts = [sum(1 for _, m in c.messages if 'time' in m) for c in fast]
+        print(f'time updates per reading client: min {min(counts)}, max {max(counts)}')
+        if max(counts) - min(counts) > 1:
+            failures.append(f'fan-out is uneven, time updates per client {counts}')
+    rejected = [c for c in clients if not c.accepted and not c.slow]
+    still_open = [c.idx for c in rejected if not c.closed]
+    if still_open:
+        failures.append(f'clients over the limit are not closed: {still_open}')
+
+    dropped = [c.idx for c in slow if c.closed]
+    print(f'slow clients dropped by server: {len(dropped)} of {len(slow)}')
+    if args.require_drop and len(dropped) != len(slow):
+        failures.append('slow clients are still connected')
+
+    ok = sorted(lat for _, lat in latencies if lat is not None)
+    if ok:
+        print(f'HTTP {args.http_path}: {len(ok)} requests, p50 {ok[len(ok) // 2] * 1000:.0f} ms, '
+              f'max {ok[-1] * 1000:.0f} ms, failed {len(latencies) - len(ok)}')
+        if ok[-1] * 1000 > args.http_max_ms:
+            failures.append(f'HTTP latency {ok[-1] * 1000:.0f} ms above {args.http_max_ms} ms')
+    if len(ok) != len(latencies):
+        failures.append(f'{len(latencies) - len(ok)} HTTP requests failed')
+
+    if args.upload:
+        failures += check_upload(args, upload, latencies)
+
+    for failure in failures:
+        print('FAIL:', failure)
+    print('OK' if not failures else 'FAILED')
+    return 0 if not failures else 1
+
+
+def check_upload(args, upload, latencies):
+    failures = []
+    if 'error' in upload:
+        failures.append(f'upload failed after {upload.get("sent", 0)} bytes: {upload["error"]}')
+    elapsed = upload['end'] - upload['start']
+    print(f'upload: {upload.get("sent", 0)} of {upload["size"]} bytes in {elapsed:.1f} s '
+          f'({upload.get("sent", 0) / 1024 / max(elapsed, 1e-3):.0f} KB/s)')
+    if args.upload_complete and b' 200 ' not in upload.get('response', b'').split(b'\r\n')[0]:
+        failures.append('upload not answered with 200: ' + upload.get('response', b'').decode(errors='replace'))
+
+    # only the requests started and answered while the upload was running
+    during = sorted(lat for start, lat in latencies
+                    if upload['start'] <= start and (lat is None or start + lat <= upload['end']))
+    ok = [lat for lat in during if lat is not None]
+    if ok:
+        print(f'HTTP {args.http_path} during upload: {len(ok)} requests, p50 {ok[len(ok) // 2] * 1000:.0f} ms, '
+              f'max {ok[-1] * 1000:.0f} ms, failed {len(during) - len(ok)}')
+    if len(during) < 2:
+        failures.append(f'{len(during)} HTTP requests during the upload, make it longer (--upload-rate)')
+    elif ok and ok[-1] * 1000 > args.http_max_ms:
+        failures.append(f'HTTP latency during upload {ok[-1] * 1000:.0f} ms above {args.http_max_ms} ms')
+    if len(ok) != len(during):
+        failures.append(f'{len(during) - len(ok)} HTTP requests failed during the upload')
+
+    head = upload.get('second', b'').decode(errors='replace')
+    print('second upload:', head.split('\r\n')[0] or 'no answer')
+    if ' 503 ' not in head.split('\r\n')[0] or 'retry-after:' not in head.lower():
+        failures.append('second upload not rejected with 503 and Retry-After')
+    return failures
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('host', help='IP address of the device')
+    parser.add_argument('--port', type=int, default=80)
+    parser.add_argument('--clients', type=int, default=50, help='WebSocket clients opened at the same time')
+    parser.add_argument('--slow', type=int, default=2, help='clients which never read')
+    parser.add_argument('--max-clients', type=int, default=4, help='CONFIG_HTTP_SERVER_PUSH_CLIENTS_MAX')
+    parser.add_argument('--duration', type=float, default=60.0, help='seconds')
+    parser.add_argument('--rcvbuf', type=int, default=1024, help='receive buffer of the slow clients')
+    parser.add_argument('--timeout', type=float, default=10.0, help='connect and handshake timeout')
+    parser.add_argument('--drain', type=float, default=3.0, help='seconds to read the backlog of slow clients')
+    parser.add_argument('--http-path', default='/Sensor', help='route polled during the test')
+    parser.add_argument('--http-period', type=float, default=0.5)
+    parser.add_argument('--http-max-ms', type=float, default=1000.0, help='allowed HTTP latency')
+    parser.add_argument('--require-drop', action='store_true', help='fail if a slow client is not dropped')
+    parser.add_argument('--upload', help='firmware image sent to /OTAupdate during the test')
+    parser.add_argument('--upload-rate', type=float, default=50.0, help='upload rate in KB/s')
+    parser.add_argument('--upload-complete', action='store_true',
+                        help='send the whole image, the device updates and restarts')
+    sys.exit(asyncio.run(main(parser.parse_args())))
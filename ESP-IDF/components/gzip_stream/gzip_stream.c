@@ -0,0 +1,178 @@
+/*
+ * gzip_stream.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <stdlib.h>
+
+#include "gzip_stream.h"
+
+// Private Macros
+#define GZIP_STREAM_WINDOW_MIN          (9u)
+#define GZIP_STREAM_WINDOW_MAX          (15u)
+#define GZIP_STREAM_GZIP_HEADER         (16)    // added to window bits for gzip wrapper
+
+// Private Function Declaration
+static esp_err_t gzip_stream_deflate( gzip_stream_t *gz, int flush );
+
+// Public Function Definition
+
+/**
+ * @brief Allocate the compressor, this is done only once and the compressor is
+ *        reused for all the streams
+ * @param gz gzip stream
+ * @param config configuration, use GZIP_STREAM_CONFIG_DEFAULT()
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t gzip_stream_init( gzip_stream_t *gz, const gzip_stream_config_t *config )
+{
+  int ret = Z_OK;
+
+  memset( gz, 0x00, sizeof(gzip_stream_t) );
+  if( (config->window_bits < GZIP_STREAM_WINDOW_MIN) || (config->window_bits > GZIP_STREAM_WINDOW_MAX) || \
+      (config->mem_level < 1) || (config->mem_level > 9) || (config->out_size == 0) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  gz->out = malloc( config->out_size );
+  if( gz->out == NULL )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  gz->out_size = config->out_size;
+
+  ret = deflateInit2( &gz->zs, config->level, Z_DEFLATED, GZIP_STREAM_GZIP_HEADER + config->window_bits, \
+                      config->mem_level, Z_DEFAULT_STRATEGY );
+  if( ret != Z_OK )
+  {
+    free( gz->out );
+    gz->out = NULL;
+    return (ret == Z_MEM_ERROR) ? ESP_ERR_NO_MEM : ESP_ERR_INVALID_ARG;
+  }
+  gz->ready = true;
+  return ESP_OK;
+}
+
+/**
+ * @brief Start a new gzip stream (one HTTP body)
+ * @param gz gzip stream
+ * @param out_cb output callback
+ * @param ctx user context for the callback
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t gzip_stream_begin( gzip_stream_t *gz, gzip_stream_out_t out_cb, void *ctx )
+{
+  if( !gz->ready )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+  deflateReset( &gz->zs );
+  gz->out_cb = out_cb;
+  gz->ctx = ctx;
+  gz->in_bytes = 0;
+  gz->out_bytes = 0;
+  gz->error = false;
+  gz->zs.next_out = gz->out;
+  gz->zs.avail_out = gz->out_size;
+  return ESP_OK;
+}
+
+/**
+ * @brief Compress the data, the callback is called whenever the output buffer
+ *        is full
+ * @param gz gzip stream
+ * @param data data to compress
+ * @param len data length
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t gzip_stream_write( gzip_stream_t *gz, const void *data, size_t len )
+{
+  if( !gz->ready || gz->error )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if( len == 0 )
+  {
+    return ESP_OK;
+  }
+  gz->zs.next_in = (Bytef *)data;
+  gz->zs.avail_in = len;
+  gz->in_bytes += len;
+  return gzip_stream_deflate( gz, Z_NO_FLUSH );
+}
+
+/**
+ * @brief Finish the stream, the remaining data and gzip trailer are given to
+ *        the callback
+ * @param gz gzip stream
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t gzip_stream_finish( gzip_stream_t *gz )
+{
+  if( !gz->ready || gz->error )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+  gz->zs.next_in = NULL;
+  gz->zs.avail_in = 0;
+  return gzip_stream_deflate( gz, Z_FINISH );
+}
+
+/**
+ * @brief Free the compressor
+ * @param gz gzip stream
+ */
+void gzip_stream_deinit( gzip_stream_t *gz )
+{
+  if( gz->ready )
+  {
+    deflateEnd( &gz->zs );
+  }
+  free( gz->out );
+  memset( gz, 0x00, sizeof(gzip_stream_t) );
+}
+
+// Private Function Definition
+
+/**
+ * @brief Run deflate till the input is consumed (or stream is finished) and
+ *        give the full output buffers to the callback
+ * @param gz gzip stream
+ * @param flush zlib flush mode
+ * @return ESP_OK if successful else the error code
+ */
+static esp_err_t gzip_stream_deflate( gzip_stream_t *gz, int flush )
+{
+  int ret = Z_OK;
+  size_t have = 0;
+  esp_err_t err = ESP_OK;
+
+  do
+  {
+    ret = deflate( &gz->zs, flush );
+    if( (ret == Z_STREAM_ERROR) || ((ret == Z_BUF_ERROR) && (gz->zs.avail_out != 0)) )
+    {
+      gz->error = true;
+      return ESP_FAIL;
+    }
+    have = gz->out_size - gz->zs.avail_out;
+    // on finish everything is given, else only full buffers (less callbacks)
+    if( (have == gz->out_size) || ((flush == Z_FINISH) && (have > 0)) )
+    {
+      err = gz->out_cb( gz->ctx, gz->out, have );
+      gz->out_bytes += have;
+      gz->zs.next_out = gz->out;
+      gz->zs.avail_out = gz->out_size;
+      if( err != ESP_OK )
+      {
+        gz->error = true;
+        return err;
+      }
+    }
+  } while( (gz->zs.avail_in > 0) || ((flush == Z_FINISH) && (ret != Z_STREAM_END)) );
+
+  return ESP_OK;
+}
@@ -0,0 +1,70 @@
+/*
+ * gzip_stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Streaming gzip compressor for HTTP uploads (Content-Encoding: gzip). Data is
+ * compressed as it is written and the output is given to a callback in small
+ * pieces, so the complete compressed body is never kept in RAM. Memory usage
+ * is fixed at init: (1 << (window_bits + 2)) + (1 << (mem_level + 9)) bytes
+ * plus ~6 KB zlib state plus the output buffer, about 14 KB with defaults.
+ */
+
+#ifndef GZIP_STREAM_H_
+#define GZIP_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "zlib.h"
+
+/**
+ * @brief Output callback, called with the compressed data
+ * @param ctx user context given in gzip_stream_begin
+ * @param data compressed data
+ * @param len data length
+ * @return ESP_OK to continue, else the compression is aborted
+ */
+typedef esp_err_t (*gzip_stream_out_t)( void *ctx, const uint8_t *data, size_t len );
+
+typedef struct _gzip_stream_config_t
+{
+  uint8_t   window_bits;                // 9..15, history window is 2^window_bits
+  uint8_t   mem_level;                  // 1..9, memory for the match finder
+  int8_t    level;                      // 1 (fast) .. 9 (best)
+  size_t    out_size;                   // output buffer, data is given to callback in this size
+} gzip_stream_config_t;
+
+typedef struct _gzip_stream_t
+{
+  z_stream          zs;
+  uint8_t           *out;
+  size_t            out_size;
+  gzip_stream_out_t out_cb;
+  void              *ctx;
+  size_t            in_bytes;           // uncompressed bytes of current stream
+  size_t            out_bytes;          // compressed bytes of current stream
+  bool              ready;              // zlib is initialized
+  bool              error;              // current stream failed
+} gzip_stream_t;
+
+// batch data from sensors is very repetitive, a small window is enough
+#define GZIP_STREAM_CONFIG_DEFAULT()    \
+{                                       \
+  .window_bits = 10,                    \
+  .mem_level = 3,                       \
+  .level = 6,                           \
+  .out_size = 1024,                     \
+}
+
+// Public Function Prototypes
+esp_err_t gzip_stream_init( gzip_stream_t *gz, const gzip_stream_config_t *config );
+esp_err_t gzip_stream_begin( gzip_stream_t *gz, gzip_stream_out_t out_cb, void *ctx );
+esp_err_t gzip_stream_write( gzip_stream_t *gz, const void *data, size_t len );
+esp_err_t gzip_stream_finish( gzip_stream_t *gz );
+void gzip_stream_deinit( gzip_stream_t *gz );
+
+#endif /* GZIP_STREAM_H_ */
@@ -0,0 +1,223 @@
+/*
+ * http_cache.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "http_cache.h"
+
+// Private Macros
+#define HTTP_CACHE_MAX_AGE_MAX          (86400)   // limit of the honoured max-age, 1 day
+
+// Private Variables
+static const char *TAG = "HTTP Cache";
+
+// Private Function Declaration
+static int32_t http_cache_max_age( const char *cache_control );
+static void http_cache_copy( char *dst, size_t size, const char *src );
+static bool http_cache_has_validator( const http_cache_validator_t *validator );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the cache, there is no cached data
+ * @param cache cache of one resource
+ */
+void http_cache_init( http_cache_t *cache )
+{
+  memset( cache, 0x00, sizeof(http_cache_t) );
+  cache->max_age_s = -1;
+}
+
+/**
+ * @brief Restore the validators of the data loaded from flash, the data is
+ *        not fresh, so the next request is sent, but a conditional one
+ * @param cache cache of one resource
+ * @param validator validators saved together with the data
+ */
+void http_cache_restore( http_cache_t *cache, const http_cache_validator_t *validator )
+{
+  http_cache_init( cache );
+  http_cache_copy( cache->valid.etag, sizeof(cache->valid.etag), validator->etag );
+  http_cache_copy( cache->valid.last_modified, sizeof(cache->valid.last_modified), validator->last_modified );
+}
+
+/**
+ * @brief Check if the cached data is still fresh (max-age of the last response
+ *        not expired), then no request is needed
+ * @param cache cache of one resource
+ * @return true if fresh
+ */
+bool http_cache_is_fresh( const http_cache_t *cache )
+{
+  return (cache->expires_us != 0) && (esp_timer_get_time() < cache->expires_us);
+}
+
+/**
+ * @brief Prepare the request, adds If-None-Match/If-Modified-Since if there is
+ *        cached data, else removes them (a pooled client keeps its headers)
+ * @param cache cache of one resource
+ * @param client client of the request, before esp_http_client_perform
+ */
+void http_cache_request( http_cache_t *cache, esp_http_client_handle_t client )
+{
+  memset( &cache->pending, 0x00, sizeof(cache->pending) );
+  cache->max_age_s = -1;
+
+  if( cache->valid.etag[0] != '\0' )
+  {
+    esp_http_client_set_header( client, "If-None-Match", cache->valid.etag );
+  }
+  else
+  {
+    esp_http_client_delete_header( client, "If-None-Match" );
+  }
+
+  if( cache->valid.last_modified[0] != '\0' )
+  {
+    esp_http_client_set_header( client, "If-Modified-Since", cache->valid.last_modified );
+  }
+  else
+  {
+    esp_http_client_delete_header( client, "If-Modified-Since" );
+  }
+}
+
+/**
+ * @brief Take the cache headers of the response, called from the event handler
+ *        on HTTP_EVENT_ON_HEADER
+ * @param cache cache of one resource
+ * @param key header name
+ * @param value header value
+ */
+void http_cache_header( http_cache_t *cache, const char *key, const char *value )
+{
+  if( (key == NULL) || (value == NULL) )
+  {
+    return;
+  }
+
+  if( strcasecmp(key, "ETag") == 0 )
+  {
+    // a truncated tag never matches, so it is better not to store it
+    if( strlen(value) < sizeof(cache->pending.etag) )
+    {
+      strcpy( cache->pending.etag, value );
+    }
+  }
+  else if( strcasecmp(key, "Last-Modified") == 0 )
+  {
+    http_cache_copy( cache->pending.last_modified, sizeof(cache->pending.last_modified), value );
+  }
+  else if( strcasecmp(key, "Cache-Control") == 0 )
+  {
+    cache->max_age_s = http_cache_max_age( value );
+  }
+}
+
+/**
+ * @brief Complete the request, on 304 the cached data is still valid and the
+ *        body must not be parsed, on 2xx the validators of the new body are
+ *        kept if the user could decode it
+ * @param cache cache of one resource
+ * @param status HTTP status code of the response
+ * @param body_ok body is decoded and stored by the user (ignored for 304)
+ * @return HTTP_CACHE_MODIFIED, HTTP_CACHE_NOT_MODIFIED or HTTP_CACHE_ERROR
+ */
+http_cache_result_t http_cache_response( http_cache_t *cache, int status, bool body_ok )
+{
+  http_cache_result_t result = HTTP_CACHE_ERROR;
+
+  if( status == 304 )
+  {
+    if( http_cache_has_validator(&cache->valid) )
+    {
+      result = HTTP_CACHE_NOT_MODIFIED;
+    }
+    else
+    {
+      ESP_LOGW(TAG, "Not Modified without conditional request");
+    }
+  }
+  else if( (status >= 200) && (status < 300) && body_ok )
+  {
+    cache->valid = cache->pending;
+    result = HTTP_CACHE_MODIFIED;
+  }
+
+  if( result != HTTP_CACHE_ERROR )
+  {
+    cache->expires_us = 0;
+    if( cache->max_age_s > 0 )
+    {
+      cache->expires_us = esp_timer_get_time() + ((int64_t)cache->max_age_s * 1000000);
+    }
+  }
+  return result;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Get max-age of the Cache-Control header, no-cache and no-store are
+ *        handled as max-age=0
+ * @param cache_control header value e.g. "public, max-age=600"
+ * @return max-age in seconds or -1 if not given
+ */
+static int32_t http_cache_max_age( const char *cache_control )
+{
+  const char *directive = cache_control;
+  int32_t max_age = -1;
+  long value = 0;
+
+  while( *directive != '\0' )
+  {
+    while( (*directive == ' ') || (*directive == ',') )
+    {
+      directive++;
+    }
+    if( (strncasecmp(directive, "no-cache", 8) == 0) || (strncasecmp(directive, "no-store", 8) == 0) )
+    {
+      return 0;
+    }
+    if( (strncasecmp(directive, "max-age=", 8) == 0) && isdigit((unsigned char)directive[8]) )
+    {
+      value = strtol( &directive[8], NULL, 10 );
+      max_age = (value > HTTP_CACHE_MAX_AGE_MAX) ? HTTP_CACHE_MAX_AGE_MAX : (int32_t)value;
+    }
+    directive += strcspn( directive, "," );
+  }
+  return max_age;
+}
+
+/**
+ * @brief Copy the string, truncated to the buffer size
+ * @param dst destination
+ * @param size destination size
+ * @param src source
+ */
+static void http_cache_copy( char *dst, size_t size, const char *src )
+{
+  size_t len = strnlen( src, size - 1 );
+
+  memcpy( dst, src, len );
+  dst[len] = '\0';
+}
+
+/**
+ * @brief Check if there is any validator for a conditional request
+ * @param validator validators
+ * @return true if ETag or Last-Modified is present
+ */
+static bool http_cache_has_validator( const http_cache_validator_t *validator )
+{
+  return (validator->etag[0] != '\0') || (validator->last_modified[0] != '\0');
+}
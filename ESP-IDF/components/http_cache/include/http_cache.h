@@ -0,0 +1,60 @@
+/*
+ * http_cache.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Small HTTP cache for one resource, it doesn't store the body (the user keeps
+ * the decoded data) but the validators of it. Requests are sent as
+ * conditional GET (If-None-Match/If-Modified-Since), the server responds with
+ * 304 and no body if nothing changed. Cache-Control max-age is honoured,
+ * http_cache_is_fresh tells if the request can be skipped. The validators are
+ * plain strings, so they can be persisted together with the decoded data.
+ *
+ * Usage:
+ *   if( http_cache_is_fresh(&cache) ) skip the request
+ *   http_cache_request( &cache, client );               before perform
+ *   http_cache_header( &cache, key, value );            HTTP_EVENT_ON_HEADER
+ *   result = http_cache_response( &cache, status, ok ); ok = body decoded
+ */
+
+#ifndef HTTP_CACHE_H_
+#define HTTP_CACHE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_http_client.h"
+
+#define HTTP_CACHE_ETAG_MAX             (64u)
+#define HTTP_CACHE_DATE_MAX             (32u)     // "Sun, 06 Nov 1994 08:49:37 GMT"
+
+typedef enum {
+  HTTP_CACHE_MODIFIED = 0,              // new body, validators are updated
+  HTTP_CACHE_NOT_MODIFIED,              // 304, cached data is still valid
+  HTTP_CACHE_ERROR,                     // error or body not usable, cache unchanged
+} http_cache_result_t;
+
+typedef struct _http_cache_validator_t
+{
+  char      etag[HTTP_CACHE_ETAG_MAX];
+  char      last_modified[HTTP_CACHE_DATE_MAX];
+} http_cache_validator_t;
+
+typedef struct _http_cache_t
+{
+  http_cache_validator_t  valid;        // validators of the data kept by user
+  http_cache_validator_t  pending;      // validators of the response being received
+  int64_t   expires_us;                 // esp_timer time till data is fresh, 0 if unknown
+  int32_t   max_age_s;                  // max-age of the response, -1 if not given
+} http_cache_t;
+
+// Public Function Prototypes
+void http_cache_init( http_cache_t *cache );
+void http_cache_restore( http_cache_t *cache, const http_cache_validator_t *validator );
+bool http_cache_is_fresh( const http_cache_t *cache );
+void http_cache_request( http_cache_t *cache, esp_http_client_handle_t client );
+void http_cache_header( http_cache_t *cache, const char *key, const char *value );
+http_cache_result_t http_cache_response( http_cache_t *cache, int status, bool body_ok );
+
+#endif /* HTTP_CACHE_H_ */
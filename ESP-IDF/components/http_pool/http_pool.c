@@ -0,0 +1,380 @@
+/*
+ * http_pool.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <inttypes.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#ifdef CONFIG_HTTP_POOL_CRT_BUNDLE
+#include "esp_crt_bundle.h"
+#endif
+
+#include "http_pool.h"
+
+// Private Macros
+#define HTTP_POOL_SIZE                  CONFIG_HTTP_POOL_SIZE
+#define HTTP_POOL_IDLE_US               ((int64_t)CONFIG_HTTP_POOL_IDLE_MS * 1000)
+#define HTTP_POOL_ORIGIN_MAX            (64u)     // scheme://host:port
+
+typedef struct _http_pool_client_t
+{
+  esp_http_client_handle_t  client;
+  char                      origin[HTTP_POOL_ORIGIN_MAX];
+  http_event_handle_cb      handler;          // event handler of the user
+  void                      *user_data;       // user data of the user
+  int64_t                   used_us;          // acquire time if busy, else release time
+  bool                      busy;             // owned by a user (or by the sweep)
+  bool                      open;             // connection is open
+  bool                      connected;        // connection opened in this request
+  bool                      closing;          // closed by sweep, events are not for the user
+} http_pool_client_t;
+
+// Private Variables
+static const char *TAG = "HTTP Pool";
+static portMUX_TYPE http_pool_lock = portMUX_INITIALIZER_UNLOCKED;
+static http_pool_client_t http_pool_clients[HTTP_POOL_SIZE] = { 0 };
+static http_pool_stats_t http_pool_stats = { 0 };
+static uint64_t http_pool_connect_ms_total = 0;
+
+// Private Function Declaration
+static esp_http_client_handle_t http_pool_client_init( http_pool_client_t *entry, const esp_http_client_config_t *config );
+static esp_err_t http_pool_event_handler( esp_http_client_event_t *evt );
+static bool http_pool_origin( const char *url, char *origin, size_t size );
+
+// Public Function Definition
+
+/**
+ * @brief Get a client for the request, an idle client of the same server and
+ *        event handler is reused with its open connection, else a new client
+ *        is created (the least recently used idle client is removed if pool is
+ *        full). The event handler gets the user_data of this config, but
+ *        esp_http_client_get_user_data must not be used with pooled clients.
+ * @param config client configuration, url is mandatory, keep_alive_enable is
+ *               always set. For a reused client only url and method are applied
+ * @return client handle or NULL if all the clients are in use
+ */
+esp_http_client_handle_t http_pool_acquire( const esp_http_client_config_t *config )
+{
+  char origin[HTTP_POOL_ORIGIN_MAX];
+  http_pool_client_t *entry = NULL;
+  http_pool_client_t *victim = NULL;
+  http_pool_client_t *pool_client = NULL;
+  esp_http_client_handle_t evict = NULL;
+
+  if( (config->url == NULL) || (http_pool_origin(config->url, origin, sizeof(origin)) == false) )
+  {
+    ESP_LOGE(TAG, "URL is missing or too long");
+    return NULL;
+  }
+  // close the connections not used since long, this also frees heap for a new one
+  http_pool_sweep();
+
+  taskENTER_CRITICAL( &http_pool_lock );
+  for( uint8_t idx = 0; idx < HTTP_POOL_SIZE; idx++ )
+  {
+    pool_client = &http_pool_clients[idx];
+    if( pool_client->busy )
+    {
+      continue;
+    }
+    if( pool_client->client == NULL )
+    {
+      // free slot is preferred over removing a client
+      if( (victim == NULL) || (victim->client != NULL) )
+      {
+        victim = pool_client;
+      }
+      continue;
+    }
+    if( (pool_client->handler == config->event_handler) && (strcmp(pool_client->origin, origin) == 0) )
+    {
+      entry = pool_client;
+      break;
+    }
+    if( (victim == NULL) || ((victim->client != NULL) && (pool_client->used_us < victim->used_us)) )
+    {
+      victim = pool_client;
+    }
+  }
+
+  if( (entry == NULL) && (victim != NULL) )
+  {
+    entry = victim;
+    evict = entry->client;
+    if( evict != NULL )
+    {
+      http_pool_stats.evicted++;
+    }
+    entry->client = NULL;
+    entry->open = false;
+    entry->handler = config->event_handler;
+    strcpy( entry->origin, origin );
+  }
+  if( entry != NULL )
+  {
+    entry->busy = true;
+    entry->connected = false;
+    entry->used_us = esp_timer_get_time();
+    entry->user_data = config->user_data;
+    http_pool_stats.requests++;
+  }
+  else
+  {
+    http_pool_stats.exhausted++;
+  }
+  taskEXIT_CRITICAL( &http_pool_lock );
+
+  if( entry == NULL )
+  {
+    ESP_LOGW(TAG, "All %u clients are in use", HTTP_POOL_SIZE);
+    return NULL;
+  }
+  if( evict != NULL )
+  {
+    esp_http_client_cleanup( evict );
+  }
+
+  if( entry->client == NULL )
+  {
+    return http_pool_client_init( entry, config );
+  }
+  // same host and port, so the open connection is kept
+  esp_http_client_set_url( entry->client, config->url );
+  esp_http_client_set_method( entry->client, config->method );
+  return entry->client;
+}
+
+/**
+ * @brief Give the client back to the pool, the connection is kept open
+ * @param client client from http_pool_acquire
+ */
+void http_pool_release( esp_http_client_handle_t client )
+{
+  http_pool_client_t *entry = NULL;
+
+  taskENTER_CRITICAL( &http_pool_lock );
+  for( uint8_t idx = 0; idx < HTTP_POOL_SIZE; idx++ )
+  {
+    if( http_pool_clients[idx].busy && (http_pool_clients[idx].client == client) )
+    {
+      entry = &http_pool_clients[idx];
+      if( entry->connected == false )
+      {
+        http_pool_stats.reused++;
+      }
+      entry->busy = false;
+      entry->user_data = NULL;
+      entry->used_us = esp_timer_get_time();
+      break;
+    }
+  }
+  taskEXIT_CRITICAL( &http_pool_lock );
+
+  if( entry == NULL )
+  {
+    ESP_LOGW(TAG, "Client is not from pool");
+  }
+}
+
+/**
+ * @brief Close the connections idle for more than CONFIG_HTTP_POOL_IDLE_MS,
+ *        called by acquire, users waiting long between requests can call it
+ *        periodically to free the TLS memory earlier
+ * @param  none
+ */
+void http_pool_sweep( void )
+{
+  http_pool_client_t *entry = NULL;
+  int64_t now_us = esp_timer_get_time();
+
+  for( uint8_t idx = 0; idx < HTTP_POOL_SIZE; idx++ )
+  {
+    entry = &http_pool_clients[idx];
+    taskENTER_CRITICAL( &http_pool_lock );
+    if( entry->busy || (entry->client == NULL) || (entry->open == false) || \
+        ((now_us - entry->used_us) < HTTP_POOL_IDLE_US) )
+    {
+      entry = NULL;
+    }
+    else
+    {
+      // sweep owns the client while closing, so nobody else can acquire it
+      entry->busy = true;
+      entry->closing = true;
+    }
+    taskEXIT_CRITICAL( &http_pool_lock );
+
+    if( entry != NULL )
+    {
+      // client and its TLS session are kept, only the connection is closed
+      esp_http_client_close( entry->client );
+      taskENTER_CRITICAL( &http_pool_lock );
+      entry->open = false;
+      entry->closing = false;
+      entry->busy = false;
+      http_pool_stats.idle_closed++;
+      taskEXIT_CRITICAL( &http_pool_lock );
+    }
+  }
+}
+
+/**
+ * @brief Get the pool statistics
+ * @param stats statistics output
+ */
+void http_pool_get_stats( http_pool_stats_t *stats )
+{
+  taskENTER_CRITICAL( &http_pool_lock );
+  *stats = http_pool_stats;
+  if( stats->connects )
+  {
+    stats->connect_ms_avg = (uint32_t)(http_pool_connect_ms_total / stats->connects);
+  }
+  for( uint8_t idx = 0; idx < HTTP_POOL_SIZE; idx++ )
+  {
+    if( http_pool_clients[idx].client != NULL )
+    {
+      stats->clients++;
+    }
+    if( http_pool_clients[idx].busy )
+    {
+      stats->busy++;
+    }
+  }
+  taskEXIT_CRITICAL( &http_pool_lock );
+}
+
+/**
+ * @brief Log the pool statistics
+ * @param  none
+ */
+void http_pool_log_stats( void )
+{
+  http_pool_stats_t stats;
+
+  http_pool_get_stats( &stats );
+  ESP_LOGI(TAG, "%" PRIu32 " requests, %" PRIu32 " reused, %" PRIu32 " connects (last %" PRIu32 " ms, avg %" PRIu32 " ms, max %" PRIu32 " ms)", \
+           stats.requests, stats.reused, stats.connects, stats.connect_ms_last, \
+           stats.connect_ms_avg, stats.connect_ms_max);
+  ESP_LOGI(TAG, "%u clients (%u busy), %" PRIu32 " idle closed, %" PRIu32 " evicted, %" PRIu32 " exhausted", \
+           stats.clients, stats.busy, stats.idle_closed, stats.evicted, stats.exhausted);
+}
+
+// Private Function Definition
+
+/**
+ * @brief Create the client of the pool entry, entry is owned by the caller
+ * @param entry pool entry
+ * @param config user configuration
+ * @return client handle or NULL
+ */
+static esp_http_client_handle_t http_pool_client_init( http_pool_client_t *entry, const esp_http_client_config_t *config )
+{
+  esp_http_client_config_t pool_config = *config;
+  esp_http_client_handle_t client = NULL;
+
+  pool_config.keep_alive_enable = true;
+  pool_config.event_handler = http_pool_event_handler;
+  pool_config.user_data = entry;
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+  // reconnects of this client resume the TLS session instead of a full handshake
+  pool_config.save_client_session = true;
+#endif
+#ifdef CONFIG_HTTP_POOL_CRT_BUNDLE
+  if( (strncmp(entry->origin, "https://", 8) == 0) && \
+      (pool_config.cert_pem == NULL) && (pool_config.crt_bundle_attach == NULL) )
+  {
+    pool_config.crt_bundle_attach = esp_crt_bundle_attach;
+  }
+#endif
+
+  client = esp_http_client_init( &pool_config );
+  taskENTER_CRITICAL( &http_pool_lock );
+  entry->client = client;
+  if( client == NULL )
+  {
+    entry->busy = false;
+    entry->origin[0] = '\0';
+  }
+  taskEXIT_CRITICAL( &http_pool_lock );
+
+  if( client == NULL )
+  {
+    ESP_LOGE(TAG, "Unable to create HTTP client for %s", entry->origin);
+  }
+  return client;
+}
+
+/**
+ * @brief HTTP Client Event Handler of all pooled clients, counts the new
+ *        connections and forwards the events to the user event handler
+ * @param evt event data
+ * @return result of the user event handler
+ */
+static esp_err_t http_pool_event_handler( esp_http_client_event_t *evt )
+{
+  http_pool_client_t *entry = (http_pool_client_t *)evt->user_data;
+  uint32_t connect_ms = 0;
+
+  if( evt->event_id == HTTP_EVENT_ON_CONNECTED )
+  {
+    // time since acquire, this is DNS lookup, TCP connect and TLS handshake
+    connect_ms = (uint32_t)((esp_timer_get_time() - entry->used_us) / 1000);
+    taskENTER_CRITICAL( &http_pool_lock );
+    entry->open = true;
+    entry->connected = true;
+    http_pool_stats.connects++;
+    http_pool_stats.connect_ms_last = connect_ms;
+    if( connect_ms > http_pool_stats.connect_ms_max )
+    {
+      http_pool_stats.connect_ms_max = connect_ms;
+    }
+    http_pool_connect_ms_total += connect_ms;
+    taskEXIT_CRITICAL( &http_pool_lock );
+  }
+  else if( evt->event_id == HTTP_EVENT_DISCONNECTED )
+  {
+    entry->open = false;
+  }
+
+  if( (entry->handler != NULL) && (entry->closing == false) )
+  {
+    evt->user_data = entry->user_data;
+    return entry->handler( evt );
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Get the origin (scheme://host:port) of the URL, clients are pooled
+ *        per origin
+ * @param url request URL
+ * @param origin origin output
+ * @param size origin buffer size
+ * @return true if successful
+ */
+static bool http_pool_origin( const char *url, char *origin, size_t size )
+{
+  const char *host = strstr( url, "://" );
+  size_t len = 0;
+
+  if( host == NULL )
+  {
+    return false;
+  }
+  host += 3;
+  len = (size_t)(host - url) + strcspn( host, "/?#" );
+  if( len >= size )
+  {
+    return false;
+  }
+  memcpy( origin, url, len );
+  origin[len] = '\0';
+  return true;
+}
@@ -0,0 +1,55 @@
+/*
+ * http_pool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * HTTP client pool shared by all the HTTP users of a firmware (InfluxDB,
+ * ThingSpeak, OpenWeatherMap...). A client is kept per server and event
+ * handler with a keep-alive connection, so repeated requests don't pay the
+ * DNS lookup, TCP connect and TLS handshake again. Connections idle for
+ * CONFIG_HTTP_POOL_IDLE_MS are closed to free the TLS memory, the client
+ * keeps its TLS session ticket, so the next connect resumes the session
+ * (needs CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS). New connections and their
+ * connect time (DNS + TCP + TLS) are counted in the pool statistics.
+ *
+ * Usage, instead of esp_http_client_init/esp_http_client_cleanup:
+ *   client = http_pool_acquire( &config );
+ *   ... set headers, perform the request ...
+ *   http_pool_release( client );
+ * On a transport error close the connection with esp_http_client_close
+ * before releasing, the next request then connects again.
+ */
+
+#ifndef HTTP_POOL_H_
+#define HTTP_POOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "esp_http_client.h"
+
+typedef struct _http_pool_stats_t
+{
+  uint32_t  requests;                   // clients acquired
+  uint32_t  reused;                     // requests on an already open connection
+  uint32_t  connects;                   // new connections (TLS handshakes for https)
+  uint32_t  connect_ms_last;            // DNS + TCP + TLS time of the last connect
+  uint32_t  connect_ms_max;
+  uint32_t  connect_ms_avg;
+  uint32_t  idle_closed;                // connections closed after idle timeout
+  uint32_t  evicted;                    // clients removed to make room for another server
+  uint32_t  exhausted;                  // acquire failed, all clients in use
+  uint8_t   clients;                    // clients in pool now
+  uint8_t   busy;                       // clients in use now
+} http_pool_stats_t;
+
+// Public Function Prototypes
+esp_http_client_handle_t http_pool_acquire( const esp_http_client_config_t *config );
+void http_pool_release( esp_http_client_handle_t client );
+void http_pool_sweep( void );
+void http_pool_get_stats( http_pool_stats_t *stats );
+void http_pool_log_stats( void );
+
+#endif /* HTTP_POOL_H_ */
@@ -0,0 +1,419 @@
+/*
+ * httpd_async_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of the request dispatch of httpd_async, with the esp_http_server
+ * stub playing the httpd task and the workers as threads. The slow handlers
+ * wait at a gate, which the test opens, so the state while a request runs is
+ * known. The cases:
+ *  start      worker route before the start, invalid config, second start
+ *  inline     the handler runs in the httpd task with its user_ctx, an error
+ *             is returned to httpd and counted
+ *  worker     the handler runs in a worker, httpd returns at once, the copy
+ *             of the request is completed, queue wait and service time
+ *  exclusive  a second request of a running exclusive route gets 503 with
+ *             Retry-After, a request with body closes the connection
+ *  queue      with the workers busy and the queue full the next request gets
+ *             503, active counts the queued and running requests
+ *  begin      a failing httpd_req_async_handler_begin gives 503
+ *  error      a failing worker handler closes the session
+ *  routes     a restarted server keeps the statistics, the route table limit
+ *
+ *  make -C components/httpd_async/host_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "httpd_async.h"
+
+// Private Macros
+#define TEST_TIMEOUT_MS                     (2000u)
+#define TEST_HOLD_US                        (20000u)  // time a gate is kept closed
+#define TEST_WORKERS                        (2u)
+#define TEST_QUEUE_LEN                      (2u)
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: %s\n", __FILE__, __LINE__, #cond );                 \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+// handlers wait here until the test opens it
+typedef struct _test_gate_t
+{
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  uint32_t  entered;
+  bool      open;
+  pthread_t thread;                     // of the last handler run
+  esp_err_t result;                     // returned by the handler
+} test_gate_t;
+
+// Private Variables
+static int test_failed = 0;
+static int test_case_failed = 0;
+static httpd_handle_t test_server = (httpd_handle_t)0x1000;
+
+// Private Function Declaration
+static void test_start( void );
+static void test_inline( void );
+static void test_worker( void );
+static void test_exclusive( void );
+static void test_queue( void );
+static void test_begin( void );
+static void test_error( void );
+static void test_routes( void );
+static void test_result( const char *name );
+static void test_gate_init( test_gate_t *gate, esp_err_t result );
+static void test_gate_open( test_gate_t *gate );
+static bool test_gate_wait( test_gate_t *gate, uint32_t entered );
+static esp_err_t test_gate_handler( httpd_req_t *req );
+static esp_err_t test_register( const char *uri, httpd_method_t method, test_gate_t *gate, httpd_async_mode_t mode );
+static bool test_stats( const char *uri, httpd_method_t method, httpd_async_stats_t *stats );
+static bool test_wait_idle( const char *uri, httpd_method_t method, httpd_async_stats_t *stats );
+
+int main( void )
+{
+  test_start();
+  test_inline();
+  test_worker();
+  test_exclusive();
+  test_queue();
+  test_begin();
+  test_error();
+  test_routes();
+  httpd_async_log_stats();
+  printf( "httpd_async_test: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+static void test_start( void )
+{
+  httpd_async_config_t config = HTTPD_ASYNC_CONFIG_DEFAULT();
+  test_gate_t gate;
+
+  test_gate_init( &gate, ESP_OK );
+  CHECK( test_register("/early", HTTP_GET, &gate, HTTPD_ASYNC_WORKER) == ESP_ERR_INVALID_STATE );
+  config.workers = 0;
+  CHECK( httpd_async_start(&config) == ESP_ERR_INVALID_ARG );
+  config.workers = TEST_WORKERS;
+  config.queue_len = 0;
+  CHECK( httpd_async_start(&config) == ESP_ERR_INVALID_ARG );
+  config.queue_len = TEST_QUEUE_LEN;
+  CHECK( httpd_async_start(&config) == ESP_OK );
+  CHECK( httpd_async_start(&config) == ESP_OK );
+  test_result( "start" );
+}
+
+static void test_inline( void )
+{
+  static test_gate_t gate, failing;
+  httpd_async_stats_t stats;
+  httpd_host_resp_t resp;
+
+  test_gate_init( &gate, ESP_OK );
+  test_gate_init( &failing, ESP_FAIL );
+  gate.open = true;
+  failing.open = true;
+  CHECK( test_register("/sensor", HTTP_GET, &gate, HTTPD_ASYNC_INLINE) == ESP_OK );
+  CHECK( test_register("/sensor", HTTP_POST, &failing, HTTPD_ASYNC_INLINE) == ESP_OK );
+
+  CHECK( httpd_host_request(test_server, HTTP_GET, "/sensor", 0, 10, &resp) == ESP_OK );
+  // handler got its own user_ctx and ran in the calling (httpd) task
+  CHECK( gate.entered == 1u );
+  CHECK( pthread_equal(gate.thread, pthread_self()) );
+  CHECK( resp.sent && (strcmp(resp.status, "200 OK") == 0) );
+  CHECK( httpd_host_request(test_server, HTTP_POST, "/sensor", 4, 10, &resp) == ESP_FAIL );
+
+  CHECK( test_stats("/sensor", HTTP_GET, &stats) );
+  CHECK( (stats.mode == HTTPD_ASYNC_INLINE) && (stats.requests == 1u) && (stats.failed == 0u) );
+  CHECK( (stats.wait_us_max == 0u) && (stats.active == 0u) );
+  CHECK( test_stats("/sensor", HTTP_POST, &stats) );
+  CHECK( (stats.requests == 1u) && (stats.failed == 1u) );
+  test_result( "inline" );
+}
+
+static void test_worker( void )
+{
+  static test_gate_t gate;
+  httpd_async_stats_t stats;
+  httpd_host_stats_t host_before, host_after;
+  httpd_host_resp_t resp;
+
+  test_gate_init( &gate, ESP_OK );
+  CHECK( test_register("/localTime", HTTP_GET, &gate, HTTPD_ASYNC_WORKER) == ESP_OK );
+  httpd_host_get_stats( &host_before );
+
+  // httpd returns before the handler has answered
+  CHECK( httpd_host_request(test_server, HTTP_GET, "/localTime", 0, 11, &resp) == ESP_OK );
+  CHECK( test_gate_wait(&gate, 1) );
+  CHECK( resp.sent == false );
+  CHECK( pthread_equal(gate.thread, pthread_self()) == 0 );
+  CHECK( test_stats("/localTime", HTTP_GET, &stats) && (stats.active == 1u) );
+  usleep( TEST_HOLD_US );
+  test_gate_open( &gate );
+
+  CHECK( test_wait_idle("/localTime", HTTP_GET, &stats) );
+  CHECK( resp.sent && (strcmp(resp.status, "200 OK") == 0) );
+  CHECK( (stats.mode == HTTPD_ASYNC_WORKER) && (stats.requests == 1u) && (stats.failed == 0u) );
+  CHECK( stats.service_us_max >= TEST_HOLD_US );
+  CHECK( stats.wait_us_max < stats.service_us_max );
+  httpd_host_get_stats( &host_after );
+  CHECK( host_after.async_begins == host_before.async_begins + 1u );
+  CHECK( host_after.async_completes == host_before.async_completes + 1u );
+  CHECK( host_after.closes == host_before.closes );
+  test_result( "worker" );
+}
+
+static void test_exclusive( void )
+{
+  static test_gate_t gate;
+  httpd_async_stats_t stats;
+  httpd_host_resp_t resp_first, resp;
+
+  test_gate_init( &gate, ESP_OK );
+  CHECK( test_register("/OTAupdate", HTTP_POST, &gate, HTTPD_ASYNC_EXCLUSIVE) == ESP_OK );
+
+  CHECK( httpd_host_request(test_server, HTTP_POST, "/OTAupdate", 100000, 12, &resp_first) == ESP_OK );
+  CHECK( test_gate_wait(&gate, 1) );
+
+  // with a body the connection is closed, else httpd would read the image
+  CHECK( httpd_host_request(test_server, HTTP_POST, "/OTAupdate", 100000, 13, &resp) == ESP_FAIL );
+  CHECK( strcmp(resp.status, "503 Service Unavailable") == 0 );
+  CHECK( strcmp(resp.retry_after, "1") == 0 );
+  CHECK( httpd_host_request(test_server, HTTP_POST, "/OTAupdate", 0, 13, &resp) == ESP_OK );
+  CHECK( strcmp(resp.status, "503 Service Unavailable") == 0 );
+  CHECK( test_stats("/OTAupdate", HTTP_POST, &stats) );
+  CHECK( (stats.active == 1u) && (stats.rejected == 2u) );
+  test_gate_open( &gate );
+  CHECK( test_wait_idle("/OTAupdate", HTTP_POST, &stats) );
+  CHECK( resp_first.sent && (strcmp(resp_first.status, "200 OK") == 0) );
+
+  // free again
+  CHECK( httpd_host_request(test_server, HTTP_POST, "/OTAupdate", 100000, 12, &resp) == ESP_OK );
+  CHECK( test_wait_idle("/OTAupdate", HTTP_POST, &stats) );
+  CHECK( resp.sent && (strcmp(resp.status, "200 OK") == 0) );
+  CHECK( (stats.requests == 2u) && (stats.rejected == 2u) );
+  test_result( "exclusive" );
+}
+
+static void test_queue( void )
+{
+  static test_gate_t gate;
+  httpd_async_stats_t stats;
+  httpd_host_resp_t resp[TEST_WORKERS + TEST_QUEUE_LEN + 1u];
+  const uint32_t accepted = TEST_WORKERS + TEST_QUEUE_LEN;
+
+  test_gate_init( &gate, ESP_OK );
+  CHECK( test_register("/slow", HTTP_GET, &gate, HTTPD_ASYNC_WORKER) == ESP_OK );
+
+  // all workers busy first, then the queue is filled
+  for( uint32_t idx = 0; idx < accepted; idx++ )
+  {
+    CHECK( httpd_host_request(test_server, HTTP_GET, "/slow", 0, 20 + (int)idx, &resp[idx]) == ESP_OK );
+    if( idx < TEST_WORKERS )
+    {
+      CHECK( test_gate_wait(&gate, idx + 1u) );
+    }
+  }
+  CHECK( test_stats("/slow", HTTP_GET, &stats) && (stats.active == accepted) );
+  CHECK( httpd_host_request(test_server, HTTP_GET, "/slow", 0, 30, &resp[accepted]) == ESP_OK );
+  CHECK( strcmp(resp[accepted].status, "503 Service Unavailable") == 0 );
+  CHECK( test_stats("/slow", HTTP_GET, &stats) && (stats.active == accepted) && (stats.rejected == 1u) );
+  usleep( TEST_HOLD_US );
+  test_gate_open( &gate );
+
+  CHECK( test_wait_idle("/slow", HTTP_GET, &stats) );
+  CHECK( (stats.requests == accepted) && (stats.rejected == 1u) );
+  // the queued requests waited for the gate
+  CHECK( stats.wait_us_max >= TEST_HOLD_US );
+  for( uint32_t idx = 0; idx < accepted; idx++ )
+  {
+    CHECK( resp[idx].sent && (strcmp(resp[idx].status, "200 OK") == 0) );
+  }
+  test_result( "queue" );
+}
+
+static void test_begin( void )
+{
+  httpd_async_stats_t stats, before;
+  httpd_host_resp_t resp;
+
+  CHECK( test_stats("/slow", HTTP_GET, &before) );
+  httpd_host_async_begin_fail = 1;
+  CHECK( httpd_host_request(test_server, HTTP_GET, "/slow", 0, 31, &resp) == ESP_OK );
+  CHECK( strcmp(resp.status, "503 Service Unavailable") == 0 );
+  CHECK( test_stats("/slow", HTTP_GET, &stats) );
+  CHECK( (stats.active == 0u) && (stats.rejected == before.rejected + 1u) && (stats.requests == before.requests) );
+  test_result( "begin" );
+}
+
+static void test_error( void )
+{
+  static test_gate_t gate;
+  httpd_async_stats_t stats;
+  httpd_host_stats_t host_before, host_after;
+  httpd_host_resp_t resp;
+
+  test_gate_init( &gate, ESP_FAIL );
+  gate.open = true;
+  CHECK( test_register("/broken", HTTP_POST, &gate, HTTPD_ASYNC_WORKER) == ESP_OK );
+  httpd_host_get_stats( &host_before );
+  CHECK( httpd_host_request(test_server, HTTP_POST, "/broken", 10, 42, &resp) == ESP_OK );
+  CHECK( test_wait_idle("/broken", HTTP_POST, &stats) );
+  CHECK( (stats.requests == 1u) && (stats.failed == 1u) );
+  httpd_host_get_stats( &host_after );
+  CHECK( (host_after.closes == host_before.closes + 1u) && (host_after.closed_sockfd == 42) );
+  CHECK( host_after.async_completes == host_after.async_begins );
+  test_result( "error" );
+}
+
+static void test_routes( void )
+{
+  static test_gate_t gate;
+  static char uris[CONFIG_HTTPD_ASYNC_ROUTES_MAX][16];
+  httpd_async_stats_t stats[CONFIG_HTTPD_ASYNC_ROUTES_MAX];
+  httpd_async_stats_t route;
+  uint8_t count;
+  esp_err_t err = ESP_OK;
+
+  test_gate_init( &gate, ESP_OK );
+  gate.open = true;
+  // the restarted server registers the routes again
+  test_server = (httpd_handle_t)0x2000;
+  CHECK( test_register("/localTime", HTTP_GET, &gate, HTTPD_ASYNC_WORKER) == ESP_OK );
+  CHECK( test_stats("/localTime", HTTP_GET, &route) && (route.requests == 1u) );
+  count = httpd_async_get_stats( stats, CONFIG_HTTPD_ASYNC_ROUTES_MAX );
+  CHECK( count == 6u );
+
+  for( uint8_t idx = count; (idx <= CONFIG_HTTPD_ASYNC_ROUTES_MAX) && (err == ESP_OK); idx++ )
+  {
+    snprintf( uris[idx % CONFIG_HTTPD_ASYNC_ROUTES_MAX], sizeof(uris[0]), "/route%u", idx );
+    err = test_register( uris[idx % CONFIG_HTTPD_ASYNC_ROUTES_MAX], HTTP_GET, &gate, HTTPD_ASYNC_INLINE );
+    CHECK( (err == ESP_OK) || (idx == CONFIG_HTTPD_ASYNC_ROUTES_MAX) );
+  }
+  CHECK( err == ESP_ERR_NO_MEM );
+  CHECK( httpd_async_get_stats(stats, CONFIG_HTTPD_ASYNC_ROUTES_MAX) == CONFIG_HTTPD_ASYNC_ROUTES_MAX );
+  test_result( "routes" );
+}
+
+static void test_result( const char *name )
+{
+  printf( "%s: %s\n", name, (test_failed > test_case_failed) ? "FAILED" : "OK" );
+  test_case_failed = test_failed;
+}
+
+static void test_gate_init( test_gate_t *gate, esp_err_t result )
+{
+  memset( gate, 0x00, sizeof(test_gate_t) );
+  pthread_mutex_init( &gate->lock, NULL );
+  pthread_cond_init( &gate->cond, NULL );
+  gate->result = result;
+}
+
+static void test_gate_open( test_gate_t *gate )
+{
+  pthread_mutex_lock( &gate->lock );
+  gate->open = true;
+  pthread_cond_broadcast( &gate->cond );
+  pthread_mutex_unlock( &gate->lock );
+}
+
+/**
+ * @brief Wait until the handlers entered the gate the given times
+ * @return false on timeout
+ */
+static bool test_gate_wait( test_gate_t *gate, uint32_t entered )
+{
+  bool reached = false;
+
+  for( uint32_t ms = 0; (ms < TEST_TIMEOUT_MS) && !reached; ms++ )
+  {
+    pthread_mutex_lock( &gate->lock );
+    reached = gate->entered >= entered;
+    pthread_mutex_unlock( &gate->lock );
+    if( !reached )
+    {
+      usleep( 1000 );
+    }
+  }
+  return reached;
+}
+
+/**
+ * @brief Handler of all routes, user_ctx is the gate
+ */
+static esp_err_t test_gate_handler( httpd_req_t *req )
+{
+  test_gate_t *gate = (test_gate_t*)req->user_ctx;
+
+  pthread_mutex_lock( &gate->lock );
+  gate->entered++;
+  gate->thread = pthread_self();
+  while( gate->open == false )
+  {
+    pthread_cond_wait( &gate->cond, &gate->lock );
+  }
+  pthread_mutex_unlock( &gate->lock );
+  if( gate->result == ESP_OK )
+  {
+    httpd_resp_sendstr( req, "done" );
+  }
+  return gate->result;
+}
+
+static esp_err_t test_register( const char *uri, httpd_method_t method, test_gate_t *gate, httpd_async_mode_t mode )
+{
+  httpd_uri_t handler =
+  {
+    .uri = uri,
+    .method = method,
+    .handler = test_gate_handler,
+    .user_ctx = gate,
+  };
+  return httpd_async_register_uri_handler( test_server, &handler, mode );
+}
+
+static bool test_stats( const char *uri, httpd_method_t method, httpd_async_stats_t *stats )
+{
+  httpd_async_stats_t all[CONFIG_HTTPD_ASYNC_ROUTES_MAX];
+  uint8_t count = httpd_async_get_stats( all, CONFIG_HTTPD_ASYNC_ROUTES_MAX );
+
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    if( (all[idx].method == method) && (strcmp(all[idx].uri, uri) == 0) )
+    {
+      *stats = all[idx];
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Wait until no request of the route is queued or running, the
+ *        worker has then completed the request copy
+ * @return false on timeout
+ */
+static bool test_wait_idle( const char *uri, httpd_method_t method, httpd_async_stats_t *stats )
+{
+  for( uint32_t ms = 0; ms < TEST_TIMEOUT_MS; ms++ )
+  {
+    if( test_stats(uri, method, stats) && (stats->active == 0u) )
+    {
+      return true;
+    }
+    usleep( 1000 );
+  }
+  return false;
+}
@@ -0,0 +1,21 @@
+/*
+ * esp_err.h
+ *
+ * Host build stub, only the error codes used by the component and the
+ * esp_http_server stub
+ */
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+
+typedef int esp_err_t;
+
+#define ESP_OK                              (0)
+#define ESP_FAIL                            (-1)
+#define ESP_ERR_NO_MEM                      (0x101)
+#define ESP_ERR_INVALID_ARG                 (0x102)
+#define ESP_ERR_INVALID_STATE               (0x103)
+#define ESP_ERR_NOT_FOUND                   (0x105)
+#define ESP_ERR_HTTPD_HANDLERS_FULL         (0xb001)
+#define ESP_ERR_HTTPD_HANDLER_EXISTS        (0xb002)
+
+#endif /* ESP_ERR_H_ */
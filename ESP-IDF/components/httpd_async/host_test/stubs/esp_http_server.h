@@ -0,0 +1,86 @@
+/*
+ * esp_http_server.h
+ *
+ * Host build stub, a server without sockets, see esp_http_server_host.c. The
+ * test plays the httpd task with httpd_host_request, the responses, the
+ * async request copies and the closed sessions are recorded.
+ */
+#ifndef ESP_HTTP_SERVER_H_
+#define ESP_HTTP_SERVER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#define HTTPD_HOST_URIS_MAX                 (32u)
+#define HTTPD_HOST_STATUS_LEN               (32u)
+#define HTTPD_HOST_HDR_LEN                  (32u)
+#define HTTPD_HOST_BODY_LEN                 (64u)
+
+typedef void *httpd_handle_t;
+
+typedef enum {
+  HTTP_DELETE = 0,
+  HTTP_GET,
+  HTTP_HEAD,
+  HTTP_POST,
+  HTTP_PUT,
+} httpd_method_t;
+
+typedef struct httpd_req
+{
+  httpd_handle_t handle;
+  int       method;
+  const char *uri;
+  size_t    content_len;
+  void      *user_ctx;
+  int       sockfd;                     // host only
+  struct _httpd_host_resp_t *resp;      // host only, response of the request
+} httpd_req_t;
+
+typedef struct httpd_uri
+{
+  const char *uri;
+  httpd_method_t method;
+  esp_err_t (*handler)( httpd_req_t *r );
+  void      *user_ctx;
+} httpd_uri_t;
+
+// host only, response written by the handler or by the async copy of it
+typedef struct _httpd_host_resp_t
+{
+  char      status[HTTPD_HOST_STATUS_LEN];
+  char      retry_after[HTTPD_HOST_HDR_LEN];
+  char      body[HTTPD_HOST_BODY_LEN];
+  bool      sent;
+} httpd_host_resp_t;
+
+// host only, counters of the server
+typedef struct _httpd_host_stats_t
+{
+  uint32_t  async_begins;
+  uint32_t  async_completes;
+  uint32_t  closes;
+  int       closed_sockfd;
+} httpd_host_stats_t;
+
+esp_err_t httpd_register_uri_handler( httpd_handle_t handle, const httpd_uri_t *uri_handler );
+esp_err_t httpd_req_async_handler_begin( httpd_req_t *r, httpd_req_t **out );
+esp_err_t httpd_req_async_handler_complete( httpd_req_t *r );
+esp_err_t httpd_sess_trigger_close( httpd_handle_t handle, int sockfd );
+int httpd_req_to_sockfd( httpd_req_t *r );
+esp_err_t httpd_resp_set_status( httpd_req_t *r, const char *status );
+esp_err_t httpd_resp_set_hdr( httpd_req_t *r, const char *field, const char *value );
+esp_err_t httpd_resp_sendstr( httpd_req_t *r, const char *str );
+const char * http_method_str( int method );
+
+// host only
+esp_err_t httpd_host_request( httpd_handle_t handle, httpd_method_t method, const char *uri, size_t content_len, \
+                              int sockfd, httpd_host_resp_t *resp );
+void httpd_host_get_stats( httpd_host_stats_t *stats );
+// the next httpd_req_async_handler_begin fails, like without free memory
+extern volatile int httpd_host_async_begin_fail;
+
+#endif /* ESP_HTTP_SERVER_H_ */
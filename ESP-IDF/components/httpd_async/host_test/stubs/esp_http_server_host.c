@@ -0,0 +1,177 @@
+/*
+ * esp_http_server_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * The esp_http_server calls of httpd_async for the host build, without
+ * sockets. httpd_host_request plays the httpd task: it looks up the handler
+ * registered for the server, uri and method and calls it, a new handle is a
+ * restarted server. The response functions write into the httpd_host_resp_t
+ * of the request, which the async copy shares, so a response sent by a
+ * worker is seen by the test. httpd_req_async_handler_begin allocates the
+ * copy like ESP-IDF, the address sanitizer then finds a copy which is never
+ * completed.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "esp_http_server.h"
+
+// Private Macros
+typedef struct _httpd_host_uri_t
+{
+  httpd_handle_t handle;
+  httpd_uri_t uri;
+} httpd_host_uri_t;
+
+// Private Variables
+static pthread_mutex_t httpd_host_lock = PTHREAD_MUTEX_INITIALIZER;
+static httpd_host_uri_t httpd_host_uris[HTTPD_HOST_URIS_MAX];
+static uint8_t httpd_host_uri_count = 0;
+static httpd_host_stats_t httpd_host_stats = { 0 };
+volatile int httpd_host_async_begin_fail = 0;
+
+// Public Function Definition
+
+esp_err_t httpd_register_uri_handler( httpd_handle_t handle, const httpd_uri_t *uri_handler )
+{
+  for( uint8_t idx = 0; idx < httpd_host_uri_count; idx++ )
+  {
+    if( (httpd_host_uris[idx].handle == handle) && (httpd_host_uris[idx].uri.method == uri_handler->method) && \
+        (strcmp(httpd_host_uris[idx].uri.uri, uri_handler->uri) == 0) )
+    {
+      // like ESP-IDF, a handler can't be registered twice
+      return ESP_ERR_HTTPD_HANDLER_EXISTS;
+    }
+  }
+  if( httpd_host_uri_count >= HTTPD_HOST_URIS_MAX )
+  {
+    return ESP_ERR_HTTPD_HANDLERS_FULL;
+  }
+  httpd_host_uris[httpd_host_uri_count].handle = handle;
+  httpd_host_uris[httpd_host_uri_count].uri = *uri_handler;
+  httpd_host_uri_count++;
+  return ESP_OK;
+}
+
+esp_err_t httpd_req_async_handler_begin( httpd_req_t *r, httpd_req_t **out )
+{
+  httpd_req_t *copy;
+
+  if( httpd_host_async_begin_fail )
+  {
+    httpd_host_async_begin_fail = 0;
+    return ESP_ERR_NO_MEM;
+  }
+  copy = malloc( sizeof(httpd_req_t) );
+  if( copy == NULL )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  *copy = *r;
+  pthread_mutex_lock( &httpd_host_lock );
+  httpd_host_stats.async_begins++;
+  pthread_mutex_unlock( &httpd_host_lock );
+  *out = copy;
+  return ESP_OK;
+}
+
+esp_err_t httpd_req_async_handler_complete( httpd_req_t *r )
+{
+  pthread_mutex_lock( &httpd_host_lock );
+  httpd_host_stats.async_completes++;
+  pthread_mutex_unlock( &httpd_host_lock );
+  free( r );
+  return ESP_OK;
+}
+
+esp_err_t httpd_sess_trigger_close( httpd_handle_t handle, int sockfd )
+{
+  (void)handle;
+  pthread_mutex_lock( &httpd_host_lock );
+  httpd_host_stats.closes++;
+  httpd_host_stats.closed_sockfd = sockfd;
+  pthread_mutex_unlock( &httpd_host_lock );
+  return ESP_OK;
+}
+
+int httpd_req_to_sockfd( httpd_req_t *r )
+{
+  return r->sockfd;
+}
+
+esp_err_t httpd_resp_set_status( httpd_req_t *r, const char *status )
+{
+  strncpy( r->resp->status, status, HTTPD_HOST_STATUS_LEN - 1u );
+  return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr( httpd_req_t *r, const char *field, const char *value )
+{
+  if( strcmp(field, "Retry-After") == 0 )
+  {
+    strncpy( r->resp->retry_after, value, HTTPD_HOST_HDR_LEN - 1u );
+  }
+  return ESP_OK;
+}
+
+esp_err_t httpd_resp_sendstr( httpd_req_t *r, const char *str )
+{
+  if( r->resp->status[0] == '\0' )
+  {
+    strcpy( r->resp->status, "200 OK" );
+  }
+  strncpy( r->resp->body, str, HTTPD_HOST_BODY_LEN - 1u );
+  r->resp->sent = true;
+  return ESP_OK;
+}
+
+const char * http_method_str( int method )
+{
+  static const char *names[] = { "DELETE", "GET", "HEAD", "POST", "PUT" };
+
+  return ((method >= 0) && (method < (int)(sizeof(names) / sizeof(names[0])))) ? names[method] : "<unknown>";
+}
+
+/**
+ * @brief Call the handler of a request like the httpd task
+ * @param handle server
+ * @param method request method
+ * @param uri request uri, exact match
+ * @param content_len length of the request body
+ * @param sockfd socket of the session
+ * @param resp output, the response of the handler
+ * @return error of the handler, ESP_ERR_NOT_FOUND without handler
+ */
+esp_err_t httpd_host_request( httpd_handle_t handle, httpd_method_t method, const char *uri, size_t content_len, \
+                              int sockfd, httpd_host_resp_t *resp )
+{
+  httpd_req_t req = { 0 };
+
+  memset( resp, 0x00, sizeof(httpd_host_resp_t) );
+  for( uint8_t idx = 0; idx < httpd_host_uri_count; idx++ )
+  {
+    if( (httpd_host_uris[idx].handle == handle) && (httpd_host_uris[idx].uri.method == method) && \
+        (strcmp(httpd_host_uris[idx].uri.uri, uri) == 0) )
+    {
+      req.handle = handle;
+      req.method = (int)method;
+      req.uri = uri;
+      req.content_len = content_len;
+      req.user_ctx = httpd_host_uris[idx].uri.user_ctx;
+      req.sockfd = sockfd;
+      req.resp = resp;
+      return httpd_host_uris[idx].uri.handler( &req );
+    }
+  }
+  return ESP_ERR_NOT_FOUND;
+}
+
+void httpd_host_get_stats( httpd_host_stats_t *stats )
+{
+  pthread_mutex_lock( &httpd_host_lock );
+  *stats = httpd_host_stats;
+  pthread_mutex_unlock( &httpd_host_lock );
+}
@@ -0,0 +1,370 @@
+/*
+ * httpd_async.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "httpd_async.h"
+
+// Private Macros
+#define HTTPD_ASYNC_ROUTES_MAX          CONFIG_HTTPD_ASYNC_ROUTES_MAX
+#define HTTPD_ASYNC_RETRY_AFTER         "1"       // in seconds, sent with 503
+
+typedef struct _httpd_async_route_t
+{
+  httpd_uri_t uri;                      // handler and user_ctx of the user
+  httpd_async_mode_t mode;
+  bool      used;
+  uint8_t   active;                     // queued or running now
+  uint32_t  requests;
+  uint32_t  failed;
+  uint32_t  rejected;
+  uint32_t  wait_us_max;
+  uint32_t  service_us_max;
+  uint64_t  wait_us_total;
+  uint64_t  service_us_total;
+} httpd_async_route_t;
+
+// request handed over to a worker
+typedef struct _httpd_async_job_t
+{
+  httpd_req_t *req;                     // copy owned by the worker
+  httpd_async_route_t *route;
+  int64_t   queued_us;
+} httpd_async_job_t;
+
+// Private Variables
+static const char *TAG = "HTTPD Async";
+static portMUX_TYPE httpd_async_lock = portMUX_INITIALIZER_UNLOCKED;
+static httpd_async_route_t httpd_async_routes[HTTPD_ASYNC_ROUTES_MAX] = { 0 };
+static QueueHandle_t httpd_async_queue = NULL;
+
+// Private Function Declaration
+static esp_err_t httpd_async_dispatch( httpd_req_t *req );
+static esp_err_t httpd_async_run( httpd_async_route_t *route, httpd_req_t *req, int64_t queued_us );
+static esp_err_t httpd_async_reject( httpd_async_route_t *route, httpd_req_t *req );
+static void httpd_async_worker( void *pvParameter );
+
+// Public Function Definition
+
+/**
+ * @brief Create the request queue and the worker tasks, the pool is kept when
+ *        the server is stopped and used again by the next one
+ * @param config pool configuration
+ * @return ESP_OK, also if already started, ESP_ERR_INVALID_ARG,
+ *         ESP_ERR_NO_MEM if no worker could be created
+ */
+esp_err_t httpd_async_start( const httpd_async_config_t *config )
+{
+  char name[configMAX_TASK_NAME_LEN];
+  uint8_t workers = 0;
+
+  if( httpd_async_queue != NULL )
+  {
+    return ESP_OK;
+  }
+  if( (config->workers == 0) || (config->queue_len == 0) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  httpd_async_queue = xQueueCreate( config->queue_len, sizeof(httpd_async_job_t) );
+  if( httpd_async_queue == NULL )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  for( uint8_t idx = 0; idx < config->workers; idx++ )
+  {
+    snprintf( name, sizeof(name), "httpd_async%u", idx );
+    if( xTaskCreate(&httpd_async_worker, name, config->task_stack, NULL, config->task_priority, NULL) == pdPASS )
+    {
+      workers++;
+    }
+  }
+  if( workers == 0 )
+  {
+    vQueueDelete( httpd_async_queue );
+    httpd_async_queue = NULL;
+    return ESP_ERR_NO_MEM;
+  }
+  if( workers < config->workers )
+  {
+    ESP_LOGW(TAG, "Only %u of %u workers created", workers, config->workers);
+  }
+  ESP_LOGI(TAG, "%u workers, %u queued requests", workers, config->queue_len);
+  return ESP_OK;
+}
+
+/**
+ * @brief Register a URI handler, like httpd_register_uri_handler. The handler
+ *        is called by httpd_async, which runs it in the httpd task or hands
+ *        the request to a worker depending on the mode. Registering the same
+ *        uri and method again (server restarted) keeps its statistics.
+ * @param handle server
+ * @param uri handler, the uri string must stay valid (statistics)
+ * @param mode where the handler runs, WebSocket handlers must be inline
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if the pool is not started for a
+ *         worker route, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM if all the routes
+ *         are used, else the error of httpd_register_uri_handler
+ */
+esp_err_t httpd_async_register_uri_handler( httpd_handle_t handle, const httpd_uri_t *uri, httpd_async_mode_t mode )
+{
+  httpd_async_route_t *route = NULL;
+  httpd_uri_t async_uri;
+
+  if( (uri == NULL) || (uri->uri == NULL) || (uri->handler == NULL) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( mode != HTTPD_ASYNC_INLINE )
+  {
+#ifdef CONFIG_HTTPD_WS_SUPPORT
+    if( uri->is_websocket )
+    {
+      return ESP_ERR_INVALID_ARG;
+    }
+#endif
+    if( httpd_async_queue == NULL )
+    {
+      return ESP_ERR_INVALID_STATE;
+    }
+  }
+
+  taskENTER_CRITICAL( &httpd_async_lock );
+  for( uint8_t idx = 0; idx < HTTPD_ASYNC_ROUTES_MAX; idx++ )
+  {
+    if( httpd_async_routes[idx].used )
+    {
+      if( (httpd_async_routes[idx].uri.method == uri->method) && \
+          (strcmp(httpd_async_routes[idx].uri.uri, uri->uri) == 0) )
+      {
+        route = &httpd_async_routes[idx];
+        break;
+      }
+    }
+    else if( route == NULL )
+    {
+      route = &httpd_async_routes[idx];
+    }
+  }
+  if( route != NULL )
+  {
+    route->uri = *uri;
+    route->mode = mode;
+    route->used = true;
+  }
+  taskEXIT_CRITICAL( &httpd_async_lock );
+
+  if( route == NULL )
+  {
+    ESP_LOGE(TAG, "No route left for %s", uri->uri);
+    return ESP_ERR_NO_MEM;
+  }
+  async_uri = *uri;
+  async_uri.handler = httpd_async_dispatch;
+  async_uri.user_ctx = route;
+  return httpd_register_uri_handler( handle, &async_uri );
+}
+
+/**
+ * @brief Get the statistics of the registered routes
+ * @param stats output, one entry per route
+ * @param max entries in stats
+ * @return number of routes written
+ */
+uint8_t httpd_async_get_stats( httpd_async_stats_t *stats, uint8_t max )
+{
+  httpd_async_route_t *route;
+  uint8_t count = 0;
+
+  taskENTER_CRITICAL( &httpd_async_lock );
+  for( uint8_t idx = 0; (idx < HTTPD_ASYNC_ROUTES_MAX) && (count < max); idx++ )
+  {
+    route = &httpd_async_routes[idx];
+    if( route->used )
+    {
+      stats[count].uri = route->uri.uri;
+      stats[count].method = route->uri.method;
+      stats[count].mode = route->mode;
+      stats[count].requests = route->requests;
+      stats[count].failed = route->failed;
+      stats[count].rejected = route->rejected;
+      stats[count].wait_us_avg = route->requests ? (uint32_t)(route->wait_us_total / route->requests) : 0u;
+      stats[count].wait_us_max = route->wait_us_max;
+      stats[count].service_us_avg = route->requests ? (uint32_t)(route->service_us_total / route->requests) : 0u;
+      stats[count].service_us_max = route->service_us_max;
+      stats[count].active = route->active;
+      count++;
+    }
+  }
+  taskEXIT_CRITICAL( &httpd_async_lock );
+  return count;
+}
+
+/**
+ * @brief Log the statistics of the routes with requests
+ */
+void httpd_async_log_stats( void )
+{
+  httpd_async_stats_t stats[HTTPD_ASYNC_ROUTES_MAX];
+  uint8_t count = httpd_async_get_stats( stats, HTTPD_ASYNC_ROUTES_MAX );
+
+  for( uint8_t idx = 0; idx < count; idx++ )
+  {
+    if( stats[idx].requests || stats[idx].rejected )
+    {
+      ESP_LOGI(TAG, "%s %s: %" PRIu32 " requests, %" PRIu32 " failed, %" PRIu32 " rejected, wait avg %" PRIu32 \
+               " us max %" PRIu32 " us, service avg %" PRIu32 " us max %" PRIu32 " us", \
+               http_method_str(stats[idx].method), stats[idx].uri, stats[idx].requests, stats[idx].failed, \
+               stats[idx].rejected, stats[idx].wait_us_avg, stats[idx].wait_us_max, \
+               stats[idx].service_us_avg, stats[idx].service_us_max);
+    }
+  }
+}
+
+// Private Function Definition
+
+/**
+ * @brief Handler of all the routes, called by the httpd task. Inline routes
+ *        run here, the others are copied for a worker, so the httpd task can
+ *        go on with the next request.
+ * @param req HTTP request, user_ctx is the route
+ * @return ESP_OK, or the error of an inline handler
+ */
+static esp_err_t httpd_async_dispatch( httpd_req_t *req )
+{
+  httpd_async_route_t *route = (httpd_async_route_t*)req->user_ctx;
+  httpd_async_job_t job = { 0 };
+  bool busy;
+
+  if( route->mode == HTTPD_ASYNC_INLINE )
+  {
+    return httpd_async_run( route, req, 0 );
+  }
+
+  taskENTER_CRITICAL( &httpd_async_lock );
+  busy = (route->mode == HTTPD_ASYNC_EXCLUSIVE) && route->active;
+  if( busy == false )
+  {
+    route->active++;
+  }
+  taskEXIT_CRITICAL( &httpd_async_lock );
+
+  if( busy == false )
+  {
+    job.route = route;
+    job.queued_us = esp_timer_get_time();
+    // the copy keeps the socket away from the httpd task until it is completed
+    if( httpd_req_async_handler_begin(req, &job.req) == ESP_OK )
+    {
+      if( xQueueSend(httpd_async_queue, &job, 0) == pdTRUE )
+      {
+        return ESP_OK;
+      }
+      httpd_req_async_handler_complete( job.req );
+    }
+    taskENTER_CRITICAL( &httpd_async_lock );
+    route->active--;
+    taskEXIT_CRITICAL( &httpd_async_lock );
+  }
+  return httpd_async_reject( route, req );
+}
+
+/**
+ * @brief Run the handler of the route and update its statistics
+ * @param route route of the request
+ * @param req HTTP request, the copy in a worker
+ * @param queued_us time the request was queued, 0 for inline routes
+ * @return error of the handler
+ */
+static esp_err_t httpd_async_run( httpd_async_route_t *route, httpd_req_t *req, int64_t queued_us )
+{
+  int64_t start_us = esp_timer_get_time();
+  uint32_t wait_us = queued_us ? (uint32_t)(start_us - queued_us) : 0u;
+  uint32_t service_us;
+  esp_err_t err;
+
+  req->user_ctx = route->uri.user_ctx;
+  err = route->uri.handler( req );
+  service_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+  taskENTER_CRITICAL( &httpd_async_lock );
+  route->requests++;
+  if( err != ESP_OK )
+  {
+    route->failed++;
+  }
+  route->wait_us_total += wait_us;
+  if( wait_us > route->wait_us_max )
+  {
+    route->wait_us_max = wait_us;
+  }
+  route->service_us_total += service_us;
+  if( service_us > route->service_us_max )
+  {
+    route->service_us_max = service_us;
+  }
+  taskEXIT_CRITICAL( &httpd_async_lock );
+  return err;
+}
+
+/**
+ * @brief Answer with 503 Service Unavailable, the client can retry. The body
+ *        of the request isn't read, a request with body closes the connection.
+ * @param route route of the request
+ * @param req HTTP request
+ * @return ESP_OK, ESP_FAIL to close the connection
+ */
+static esp_err_t httpd_async_reject( httpd_async_route_t *route, httpd_req_t *req )
+{
+  taskENTER_CRITICAL( &httpd_async_lock );
+  route->rejected++;
+  taskEXIT_CRITICAL( &httpd_async_lock );
+
+  ESP_LOGW(TAG, "%s busy, request rejected", route->uri.uri);
+  httpd_resp_set_status( req, "503 Service Unavailable" );
+  httpd_resp_set_hdr( req, "Retry-After", HTTPD_ASYNC_RETRY_AFTER );
+  httpd_resp_sendstr( req, "Server busy" );
+  // else httpd would receive and discard the whole body, e.g. a firmware image
+  return req->content_len ? ESP_FAIL : ESP_OK;
+}
+
+/**
+ * @brief Worker task, runs the queued requests one after the other and gives
+ *        the sockets back to the httpd task
+ * @param pvParameter not used
+ */
+static void httpd_async_worker( void *pvParameter )
+{
+  httpd_async_job_t job;
+  esp_err_t err;
+
+  (void)pvParameter;
+  while( true )
+  {
+    if( xQueueReceive(httpd_async_queue, &job, portMAX_DELAY) == pdTRUE )
+    {
+      err = httpd_async_run( job.route, job.req, job.queued_us );
+      if( err != ESP_OK )
+      {
+        // same as a failing handler in the httpd task
+        httpd_sess_trigger_close( job.req->handle, httpd_req_to_sockfd(job.req) );
+      }
+      httpd_req_async_handler_complete( job.req );
+
+      taskENTER_CRITICAL( &httpd_async_lock );
+      job.route->active--;
+      taskEXIT_CRITICAL( &httpd_async_lock );
+    }
+  }
+}
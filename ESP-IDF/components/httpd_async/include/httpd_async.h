@@ -0,0 +1,84 @@
+/*
+ * httpd_async.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Asynchronous request handling for esp_http_server. The httpd task runs all
+ * the handlers one after the other, so a slow handler (firmware upload, a
+ * handler waiting for another task) blocks every other client. Routes
+ * registered as HTTPD_ASYNC_WORKER are handed to a small pool of worker tasks
+ * with httpd_req_async_handler_begin, the httpd task returns at once and keeps
+ * accepting and serving the cheap HTTPD_ASYNC_INLINE routes. The worker
+ * queue is bounded, when it is full (or an HTTPD_ASYNC_EXCLUSIVE route is
+ * already running) the request is answered with 503 and Retry-After.
+ *
+ * The handlers don't need changes, req->user_ctx is the one of the route and
+ * all the httpd_req_* and httpd_resp_* functions work in the worker. Returning
+ * an error from a worker handler closes the connection, like in the httpd task.
+ *
+ * Every route counts its requests, rejects and errors and measures the queue
+ * wait (dispatch until a worker starts the handler) and the service time (run
+ * time of the handler), see httpd_async_get_stats.
+ *
+ * Usage:
+ *   httpd_async_config_t config = HTTPD_ASYNC_CONFIG_DEFAULT();
+ *   httpd_async_start( &config );
+ *   httpd_async_register_uri_handler( server, &ota_update, HTTPD_ASYNC_EXCLUSIVE );
+ *   httpd_async_register_uri_handler( server, &sensor_json, HTTPD_ASYNC_INLINE );
+ */
+
+#ifndef HTTPD_ASYNC_H_
+#define HTTPD_ASYNC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+typedef enum {
+  HTTPD_ASYNC_INLINE = 0,               // cheap handler, runs in the httpd task
+  HTTPD_ASYNC_WORKER,                   // slow handler, runs in a worker task
+  HTTPD_ASYNC_EXCLUSIVE,                // like worker, but one request of the route at a time
+} httpd_async_mode_t;
+
+typedef struct _httpd_async_config_t
+{
+  uint8_t   workers;
+  uint8_t   queue_len;                  // requests waiting for a worker
+  uint32_t  task_stack;                 // of each worker, the handlers run on it
+  UBaseType_t task_priority;            // below the httpd task keeps the inline routes fast
+} httpd_async_config_t;
+
+typedef struct _httpd_async_stats_t
+{
+  const char *uri;
+  httpd_method_t method;
+  httpd_async_mode_t mode;
+  uint32_t  requests;                   // handlers run
+  uint32_t  failed;                     // handler returned an error, connection closed
+  uint32_t  rejected;                   // answered with 503, queue full or route busy
+  uint32_t  wait_us_avg;                // in the queue, 0 for inline routes
+  uint32_t  wait_us_max;
+  uint32_t  service_us_avg;             // handler run time
+  uint32_t  service_us_max;
+  uint8_t   active;                     // queued or running now
+} httpd_async_stats_t;
+
+#define HTTPD_ASYNC_CONFIG_DEFAULT()                  \
+{                                                     \
+  .workers = CONFIG_HTTPD_ASYNC_WORKERS,              \
+  .queue_len = CONFIG_HTTPD_ASYNC_QUEUE_LEN,          \
+  .task_stack = 4096,                                 \
+  .task_priority = 4,                                 \
+}
+
+// Public Function Prototypes
+esp_err_t httpd_async_start( const httpd_async_config_t *config );
+esp_err_t httpd_async_register_uri_handler( httpd_handle_t handle, const httpd_uri_t *uri, httpd_async_mode_t mode );
+uint8_t httpd_async_get_stats( httpd_async_stats_t *stats, uint8_t max );
+void httpd_async_log_stats( void );
+
+#endif /* HTTPD_ASYNC_H_ */
@@ -0,0 +1,166 @@
+/*
+ * influx_writer_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host benchmark of the InfluxDB writer against tools/mock_influxdb.py on the
+ * loopback. The samples are spooled while the link is down, then the link
+ * comes up and the time till the server has all the points is measured, so
+ * the figure is the upload path only: drain, line protocol, gzip, HTTP. The
+ * modes compare the batching and compression options:
+ *  gzip    batches of 100 points, gzip
+ *  plain   batches of 100 points, no compression
+ *  single  one point per request, no compression (the writer before batching)
+ * --delay-ms of the server adds a round trip time, which is what batching
+ * saves on a real network. The mock server is Python, so the absolute rate is
+ * bound by it, the ratios between the modes are the result.
+ *
+ *  make -C components/influx_writer/host_test bench
+ *  build/influx_writer_bench gzip|plain|single [points] [server delay ms]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#include "esp_timer.h"
+#include "http_pool.h"
+#include "influx_writer.h"
+#include "mock_server.h"
+
+// Private Macros
+#define BENCH_MOCK_SCRIPT                   "../tools/mock_influxdb.py"
+#define BENCH_DEVICES                       (10u)
+#define BENCH_BATCH_POINTS                  (100u)
+#define BENCH_WAIT_MS                       (120000u)
+
+// Private Variables
+static const char * const bench_fields[] = { "temperature", "humidity" };
+static atomic_bool bench_link_up = false;
+
+// Private Function Declaration
+static bool bench_link_status( void );
+static bool bench_time_status( void );
+static long long bench_time_ns( void );
+static void bench_sleep_us( uint32_t us );
+
+int main( int argc, char **argv )
+{
+  const char *mode = (argc > 1) ? argv[1] : "gzip";
+  uint32_t points = (argc > 2) ? (uint32_t)strtoul( argv[2], NULL, 0 ) : 5000u;
+  uint32_t delay_ms = (argc > 3) ? (uint32_t)strtoul( argv[3], NULL, 0 ) : 0u;
+  bool single = (strcmp( mode, "single" ) == 0);
+  influx_writer_metrics_t metrics = { 0 };
+  http_pool_stats_t pool;
+  telemetry_stats_t stats;
+  char url[64];
+  char args[64];
+  float values[2];
+  int64_t start_us = 0;
+  double elapsed_s = 0.0;
+  influx_writer_config_t config =
+  {
+    .url = url,
+    .org = "host",
+    .bucket = "bench",
+    .token = "bench",
+    .measurement = "weather",
+    .device_id = "bench",
+    .fields = bench_fields,
+    .field_count = 2,
+    .batch_points = single ? 1u : BENCH_BATCH_POINTS,
+    .batch_bytes = 16384,
+    .batch_age_ms = 1000,
+    .gzip = (strcmp( mode, "gzip" ) == 0),
+    .spool_records = points,
+    .spool_drop = SPOOL_DROP_NEWEST,
+    .drain_batch = single ? 1u : BENCH_BATCH_POINTS,   // one batch per drain, nothing is dropped
+    .drain_interval_ms = 0,
+    .link_up = bench_link_status,
+    .time_synced = bench_time_status,
+    .time_ns = bench_time_ns,
+  };
+
+  snprintf( args, sizeof(args), "--delay-ms %u", (unsigned)delay_ms );
+  if( mock_start( (argc > 4) ? argv[4] : BENCH_MOCK_SCRIPT, args, url, sizeof(url) ) == false )
+  {
+    printf( "unable to start the mock server\n" );
+    return EXIT_FAILURE;
+  }
+  if( influx_writer_start( &config ) != ESP_OK )
+  {
+    mock_stop();
+    return EXIT_FAILURE;
+  }
+
+  // fill the spool, the sink of the writer is only 4 deep
+  for( uint32_t idx = 0; idx < points; idx++ )
+  {
+    values[0] = 15.0f + (float)(idx % 20u) * 0.5f;
+    values[1] = 30.0f + (float)(idx % 50u);
+    telemetry_publish_source( (uint8_t)(idx % BENCH_DEVICES), values, 2 );
+    do
+    {
+      bench_sleep_us( 20 );
+      telemetry_get_stats( influx_writer_get_sink(), &stats );
+    } while( stats.depth > 2u );
+  }
+  bench_sleep_us( 100000 );
+
+  start_us = esp_timer_get_time();
+  atomic_store( &bench_link_up, true );
+  // the writer polls the link only every second while samples wait, wake it now
+  influx_writer_flush();
+  for( uint32_t waited = 0; (metrics.points_sent < points) && (waited < BENCH_WAIT_MS); waited++ )
+  {
+    bench_sleep_us( 1000 );
+    influx_writer_get_metrics( &metrics );
+  }
+  elapsed_s = (double)(esp_timer_get_time() - start_us) / 1e6;
+  http_pool_get_stats( &pool );
+
+  printf( "%-6s %u points, server delay %u ms: %.2f s, %.0f points/s, %u requests, %u connects\n", \
+          mode, (unsigned)metrics.points_sent, (unsigned)delay_ms, elapsed_s, \
+          (double)metrics.points_sent / elapsed_s, (unsigned)metrics.flushes, (unsigned)pool.connects );
+  printf( "       %.1f line bytes/point, %.1f wire bytes/point (%.0f%%), flush avg %.2f ms max %u ms\n", \
+          metrics.points_sent ? (double)metrics.bytes_sent / metrics.points_sent : 0.0, \
+          metrics.points_sent ? (double)metrics.bytes_wire / metrics.points_sent : 0.0, \
+          metrics.bytes_sent ? 100.0 * (double)metrics.bytes_wire / (double)metrics.bytes_sent : 0.0, \
+          metrics.flushes ? (double)metrics.total_flush_ms / metrics.flushes : 0.0, (unsigned)metrics.max_flush_ms );
+  if( (metrics.points_sent != points) || (mock_stat( "points" ) != (long)points) || (mock_stat( "duplicates" ) != 0) )
+  {
+    printf( "not all points arrived once: sent %u, server %ld, duplicates %ld\n", \
+            (unsigned)metrics.points_sent, mock_stat( "points" ), mock_stat( "duplicates" ) );
+    mock_stop();
+    return EXIT_FAILURE;
+  }
+  mock_stop();
+  return EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+static bool bench_link_status( void )
+{
+  return atomic_load( &bench_link_up );
+}
+
+static bool bench_time_status( void )
+{
+  return true;
+}
+
+static long long bench_time_ns( void )
+{
+  struct timespec now;
+  clock_gettime( CLOCK_REALTIME, &now );
+  return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void bench_sleep_us( uint32_t us )
+{
+  struct timespec delay = { .tv_sec = us / 1000000u, .tv_nsec = (long)(us % 1000000u) * 1000L };
+  nanosleep( &delay, NULL );
+}
@@ -0,0 +1,395 @@
+/*
+ * influx_writer_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of the InfluxDB writer against tools/mock_influxdb.py. The writer
+ * runs unchanged with the real HTTP pool, gzip stream, spool, telemetry bus
+ * and serializer, only esp_http_client is a socket implementation. The writer
+ * is a singleton, so every case is its own run:
+ *  normal  samples before time sync and link up are spooled and arrive once,
+ *          the gap before the spool is read from the history, values are
+ *          rounded and clamped, one keep-alive connection, gzip on the wire
+ *  faults  429 and 503 with Retry-After, the batch is retried and arrives once
+ *  nogzip  server answers 415 to gzip, the writer goes on with plain text
+ *  reject  400 for gzip and plain, the batch is dropped, the next one arrives
+ *
+ *  make -C components/influx_writer/host_test
+ *  build/influx_writer_test normal|faults|nogzip|reject [mock_influxdb.py]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <stdatomic.h>
+
+#include "esp_timer.h"
+#include "nvs.h"
+#include "http_pool.h"
+#include "influx_writer.h"
+#include "mock_server.h"
+
+// Private Macros
+#define TEST_MOCK_SCRIPT                    "../tools/mock_influxdb.py"
+#define TEST_TOKEN                          "host-token"
+#define TEST_SPOOLED                        (40u)     // samples before time sync and link up
+#define TEST_DEVICES                        (4u)      // virtual devices besides the local one
+#define TEST_LIVE                           (200u)
+#define TEST_HISTORY                        (30u)     // records in the gap before the spool
+#define TEST_WAIT_MS                        (15000u)
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond );   \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+// Private Variables
+static const char * const test_fields[] = { "temperature", "humidity" };
+static atomic_bool test_link_up = false;
+static atomic_bool test_time_synced = false;
+static uint32_t test_history_start = 0;
+static uint32_t test_history_calls = 0;
+static int test_failed = 0;
+
+// Private Function Declaration
+static void test_normal( influx_writer_config_t *config );
+static void test_faults( influx_writer_config_t *config );
+static void test_nogzip( influx_writer_config_t *config );
+static void test_reject( influx_writer_config_t *config );
+static void test_publish( uint32_t count, uint8_t devices );
+static bool test_wait_sent( uint32_t points );
+static bool test_link_status( void );
+static bool test_time_status( void );
+static long long test_time_ns( void );
+static void test_history( void *ctx, uint32_t after_s, uint32_t before_s, influx_writer_add_t add );
+static int64_t test_now_ms( void );
+static void test_sleep_ms( uint32_t ms );
+
+int main( int argc, char **argv )
+{
+  const char *mode = (argc > 1) ? argv[1] : "normal";
+  const char *script = (argc > 2) ? argv[2] : TEST_MOCK_SCRIPT;
+  char url[64];
+  char args[128];
+  influx_writer_config_t config =
+  {
+    .url = url,
+    .org = "host",
+    .bucket = "test",
+    .token = TEST_TOKEN,
+    .measurement = "weather",
+    .device_id = "host",
+    .fields = test_fields,
+    .field_count = 2,
+    .batch_points = 50,
+    .batch_bytes = 4096,
+    .batch_age_ms = 200,
+    .gzip = true,
+    .spool_records = 512,
+    .spool_drop = SPOOL_DROP_OLDEST,
+    .drain_batch = 100,
+    .drain_interval_ms = 20,
+    .link_up = test_link_status,
+    .time_synced = test_time_status,
+    .time_ns = test_time_ns,
+  };
+
+  snprintf( args, sizeof(args), "--token %s %s", TEST_TOKEN, \
+            (strcmp( mode, "faults" ) == 0) ? "--faults 429,503 --retry-after 1" : \
+            (strcmp( mode, "nogzip" ) == 0) ? "--no-gzip" : \
+            (strcmp( mode, "reject" ) == 0) ? "--faults 400,400" : "" );
+  if( mock_start( script, args, url, sizeof(url) ) == false )
+  {
+    printf( "unable to start %s\n", script );
+    return EXIT_FAILURE;
+  }
+
+  if( strcmp( mode, "normal" ) == 0 )
+  {
+    test_normal( &config );
+  }
+  else if( strcmp( mode, "faults" ) == 0 )
+  {
+    test_faults( &config );
+  }
+  else if( strcmp( mode, "nogzip" ) == 0 )
+  {
+    test_nogzip( &config );
+  }
+  else if( strcmp( mode, "reject" ) == 0 )
+  {
+    test_reject( &config );
+  }
+  else
+  {
+    printf( "unknown mode %s\n", mode );
+    test_failed++;
+  }
+  mock_stop();
+  printf( "influx_writer_test %s: %s\n", mode, test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Spool before time sync, backfill from history, clamping, keep-alive
+ * @param config writer configuration
+ */
+static void test_normal( influx_writer_config_t *config )
+{
+  const float clamp_high[] = { NAN, 1e9f };
+  const float clamp_low[] = { -10.4f, 300.6f };
+  influx_writer_metrics_t metrics;
+  http_pool_stats_t pool;
+  nvs_handle_t nvs;
+  char last[160];
+  uint32_t total = TEST_SPOOLED + TEST_LIVE + TEST_HISTORY;
+
+  // newest point written before the "reboot", the history after it is missing on the server
+  test_history_start = (uint32_t)(test_time_ns() / 1000000000LL) - 600u;
+  nvs_open( "influxdb", NVS_READWRITE, &nvs );
+  nvs_set_u32( nvs, "last_time", test_history_start - 1u );
+  nvs_close( nvs );
+  config->history = test_history;
+
+  CHECK( influx_writer_start( config ) == ESP_OK );
+  CHECK( influx_writer_start( config ) == ESP_ERR_INVALID_STATE );
+  test_publish( TEST_SPOOLED, 0 );
+  test_sleep_ms( 100 );
+  influx_writer_get_metrics( &metrics );
+  CHECK( metrics.spool_depth == TEST_SPOOLED );
+  CHECK( mock_stat( "requests" ) == 0 );
+
+  atomic_store( &test_time_synced, true );
+  atomic_store( &test_link_up, true );
+  test_publish( TEST_LIVE, TEST_DEVICES );
+  CHECK( test_wait_sent( total ) );
+
+  // flush sends a partial batch at once, the newest line is on the server then
+  telemetry_publish( clamp_high, 2 );
+  test_sleep_ms( 50 );
+  influx_writer_flush();
+  CHECK( test_wait_sent( total + 1u ) );
+  CHECK( mock_last( last, sizeof(last) ) && (strstr( last, " temperature=0,humidity=32767 " ) != NULL) );
+  telemetry_publish( clamp_low, 2 );
+  test_sleep_ms( 50 );
+  influx_writer_flush();
+  CHECK( test_wait_sent( total + 2u ) );
+  CHECK( mock_last( last, sizeof(last) ) && (strstr( last, " temperature=-10,humidity=301 " ) != NULL) );
+  total += 2u;
+
+  influx_writer_get_metrics( &metrics );
+  http_pool_get_stats( &pool );
+  printf( "%u points in %u writes, %u line bytes, %u on wire, %u backfilled, flush avg %u ms max %u ms\n", \
+          (unsigned)metrics.points_sent, (unsigned)metrics.flushes, (unsigned)metrics.bytes_sent, \
+          (unsigned)metrics.bytes_wire, (unsigned)metrics.backfilled, \
+          (unsigned)(metrics.flushes ? metrics.total_flush_ms / metrics.flushes : 0u), (unsigned)metrics.max_flush_ms );
+  CHECK( metrics.points_sent == total );
+  CHECK( metrics.points_dropped == 0 );
+  CHECK( metrics.retries == 0 );
+  CHECK( metrics.failures == 0 );
+  CHECK( metrics.backfilled == TEST_HISTORY );
+  CHECK( metrics.spool_depth == 0 );
+  CHECK( metrics.gzip );
+  CHECK( metrics.bytes_wire < metrics.bytes_sent / 2u );
+  CHECK( mock_stat( "points" ) == (long)total );
+  CHECK( mock_stat( "duplicates" ) == 0 );
+  CHECK( mock_stat( "bad_lines" ) == 0 );
+  CHECK( mock_stat( "unauthorized" ) == 0 );
+  CHECK( mock_stat( "plain" ) == 0 );
+  CHECK( mock_stat( "series" ) == (long)(TEST_DEVICES + 1u) );
+  CHECK( mock_stat( "connections" ) == 1 );
+  CHECK( pool.connects == 1 );
+  CHECK( pool.reused == (pool.requests - 1u) );
+  CHECK( test_history_calls >= 1u );
+}
+
+/**
+ * @brief 429 and 503 with Retry-After, the batch is retried after the backoff
+ * @param config writer configuration
+ */
+static void test_faults( influx_writer_config_t *config )
+{
+  influx_writer_metrics_t metrics;
+  int64_t start_ms = 0;
+
+  atomic_store( &test_time_synced, true );
+  atomic_store( &test_link_up, true );
+  CHECK( influx_writer_start( config ) == ESP_OK );
+  start_ms = test_now_ms();
+  test_publish( 20, 0 );
+  influx_writer_flush();
+  CHECK( test_wait_sent( 20 ) );
+  influx_writer_get_metrics( &metrics );
+  printf( "20 points written after %u retries in %u ms\n", (unsigned)metrics.retries, \
+          (unsigned)(test_now_ms() - start_ms) );
+  CHECK( metrics.retries == 2 );
+  CHECK( metrics.failures == 0 );
+  CHECK( metrics.points_dropped == 0 );
+  // Retry-After 1 s is the lower limit of both waits
+  CHECK( (test_now_ms() - start_ms) >= 2000 );
+  CHECK( mock_stat( "faults" ) == 2 );
+  CHECK( mock_stat( "points" ) == 20 );
+  CHECK( mock_stat( "duplicates" ) == 0 );
+}
+
+/**
+ * @brief Server without gzip, the writer falls back to plain text for good
+ * @param config writer configuration
+ */
+static void test_nogzip( influx_writer_config_t *config )
+{
+  influx_writer_metrics_t metrics;
+
+  atomic_store( &test_time_synced, true );
+  atomic_store( &test_link_up, true );
+  CHECK( influx_writer_start( config ) == ESP_OK );
+  test_publish( 20, 0 );
+  influx_writer_flush();
+  CHECK( test_wait_sent( 20 ) );
+  test_publish( 20, 0 );
+  influx_writer_flush();
+  CHECK( test_wait_sent( 40 ) );
+  influx_writer_get_metrics( &metrics );
+  CHECK( metrics.gzip == false );
+  CHECK( metrics.retries == 0 );
+  CHECK( metrics.bytes_wire == metrics.bytes_sent );
+  CHECK( mock_stat( "rejected_gzip" ) == 1 );
+  CHECK( mock_stat( "gzip" ) == 0 );
+  CHECK( mock_stat( "points" ) == 40 );
+  CHECK( mock_stat( "connections" ) == 1 );
+}
+
+/**
+ * @brief 400 for gzip and plain, the batch is dropped and not retried
+ * @param config writer configuration
+ */
+static void test_reject( influx_writer_config_t *config )
+{
+  influx_writer_metrics_t metrics = { 0 };
+
+  atomic_store( &test_time_synced, true );
+  atomic_store( &test_link_up, true );
+  CHECK( influx_writer_start( config ) == ESP_OK );
+  test_publish( 20, 0 );
+  influx_writer_flush();
+  for( uint32_t waited = 0; (waited < TEST_WAIT_MS) && (metrics.failures == 0); waited += 10u )
+  {
+    test_sleep_ms( 10 );
+    influx_writer_get_metrics( &metrics );
+  }
+  CHECK( metrics.failures == 1 );
+  CHECK( metrics.points_dropped == 20 );
+  CHECK( metrics.retries == 0 );
+  // plain text didn't work either, so it's not the gzip
+  CHECK( metrics.gzip );
+
+  test_publish( 10, 0 );
+  influx_writer_flush();
+  CHECK( test_wait_sent( 10 ) );
+  CHECK( mock_stat( "faults" ) == 2 );
+  CHECK( mock_stat( "points" ) == 10 );
+  CHECK( mock_stat( "gzip" ) == 1 );
+}
+
+/**
+ * @brief Publish samples on the telemetry bus, the sink of the writer is only
+ *        4 deep, so the publisher waits for the writer task like a sensor
+ *        loop would
+ * @param count number of samples
+ * @param devices virtual devices, samples go round robin to local and these
+ */
+static void test_publish( uint32_t count, uint8_t devices )
+{
+  telemetry_stats_t stats;
+  float values[2];
+
+  for( uint32_t idx = 0; idx < count; idx++ )
+  {
+    values[0] = 20.0f + (float)(idx % 10u);
+    values[1] = 40.0f + (float)(idx % 30u);
+    telemetry_publish_source( (uint8_t)(idx % (devices + 1u)), values, 2 );
+    do
+    {
+      test_sleep_ms( 1 );
+      telemetry_get_stats( influx_writer_get_sink(), &stats );
+    } while( stats.depth > 2u );
+  }
+}
+
+/**
+ * @brief Wait till the writer has written the points
+ * @param points points written in total
+ * @return false on timeout
+ */
+static bool test_wait_sent( uint32_t points )
+{
+  influx_writer_metrics_t metrics;
+
+  for( uint32_t waited = 0; waited < TEST_WAIT_MS; waited += 10u )
+  {
+    influx_writer_get_metrics( &metrics );
+    if( metrics.points_sent >= points )
+    {
+      return true;
+    }
+    test_sleep_ms( 10 );
+  }
+  return false;
+}
+
+static bool test_link_status( void )
+{
+  return atomic_load( &test_link_up );
+}
+
+static bool test_time_status( void )
+{
+  return atomic_load( &test_time_synced );
+}
+
+static long long test_time_ns( void )
+{
+  struct timespec now;
+  clock_gettime( CLOCK_REALTIME, &now );
+  return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+/**
+ * @brief History of the local sensors, one record every 10 s from
+ *        test_history_start, TEST_HISTORY records
+ */
+static void test_history( void *ctx, uint32_t after_s, uint32_t before_s, influx_writer_add_t add )
+{
+  int32_t values[2] = { 21, 45 };
+  uint32_t t = 0;
+
+  (void)ctx;
+  test_history_calls++;
+  for( uint32_t idx = 0; idx < TEST_HISTORY; idx++ )
+  {
+    t = test_history_start + idx * 10u;
+    if( (t > after_s) && (t < before_s) && (add( t, values, 2 ) == false) )
+    {
+      break;
+    }
+  }
+}
+
+static int64_t test_now_ms( void )
+{
+  return esp_timer_get_time() / 1000;
+}
+
+static void test_sleep_ms( uint32_t ms )
+{
+  struct timespec delay = { .tv_sec = ms / 1000u, .tv_nsec = (long)(ms % 1000u) * 1000000L };
+  nanosleep( &delay, NULL );
+}
@@ -0,0 +1,158 @@
+/*
+ * mock_server.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "mock_server.h"
+
+// Private Macros
+#define MOCK_REPLY_MAX                      (4096u)
+
+// Private Variables
+static FILE *mock_pipe = NULL;
+static uint16_t mock_port = 0;
+
+// Private Function Declaration
+static bool mock_get( const char *path, char *reply, size_t size );
+
+// Public Function Definition
+
+/**
+ * @brief Start the mock server on a free port of the loopback
+ * @param script path of mock_influxdb.py
+ * @param args more arguments of the server, e.g. "--faults 429"
+ * @param url output, server URL for the writer
+ * @param url_size url buffer size
+ * @return true if the server is listening
+ */
+bool mock_start( const char *script, const char *args, char *url, size_t url_size )
+{
+  char command[512];
+  char line[128];
+  unsigned port = 0;
+
+  snprintf( command, sizeof(command), "exec python3 -u %s --port 0 --quiet %s", script, args );
+  mock_pipe = popen( command, "r" );
+  if( (mock_pipe == NULL) || (fgets( line, sizeof(line), mock_pipe ) == NULL) || \
+      (sscanf( line, "listening on 127.0.0.1:%u", &port ) != 1) )
+  {
+    return false;
+  }
+  mock_port = (uint16_t)port;
+  snprintf( url, url_size, "http://127.0.0.1:%u", port );
+  return true;
+}
+
+/**
+ * @brief Get one counter of the server
+ * @param name counter name, see mock_influxdb.py
+ * @return counter value or -1
+ */
+long mock_stat( const char *name )
+{
+  char reply[MOCK_REPLY_MAX];
+  char *line = NULL;
+  size_t len = strlen( name );
+
+  if( mock_get( "/stats", reply, sizeof(reply) ) == false )
+  {
+    return -1;
+  }
+  for( line = reply; line != NULL; line = strchr( line, '\n' ), line = line ? line + 1 : NULL )
+  {
+    if( (strncmp( line, name, len ) == 0) && (line[len] == ' ') )
+    {
+      return strtol( line + len + 1, NULL, 10 );
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Get the newest line protocol line the server has received
+ * @param line output
+ * @param size line buffer size
+ * @return true if successful
+ */
+bool mock_last( char *line, size_t size )
+{
+  char reply[MOCK_REPLY_MAX];
+  char *last = NULL;
+
+  if( (mock_get( "/stats", reply, sizeof(reply) ) == false) || ((last = strstr( reply, "\nlast " )) == NULL) )
+  {
+    return false;
+  }
+  last += 6;
+  snprintf( line, size, "%.*s", (int)strcspn( last, "\n" ), last );
+  return true;
+}
+
+/**
+ * @brief Stop the server and wait for it
+ * @param  none
+ */
+void mock_stop( void )
+{
+  char reply[MOCK_REPLY_MAX];
+
+  if( mock_pipe != NULL )
+  {
+    mock_get( "/quit", reply, sizeof(reply) );
+    pclose( mock_pipe );
+    mock_pipe = NULL;
+  }
+}
+
+// Private Function Definition
+
+/**
+ * @brief GET request on its own connection, the body is returned
+ * @param path request path
+ * @param reply output, response body
+ * @param size reply buffer size
+ * @return true if successful
+ */
+static bool mock_get( const char *path, char *reply, size_t size )
+{
+  struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons( mock_port ) };
+  char request[128];
+  char *body = NULL;
+  size_t len = 0;
+  ssize_t got = 0;
+  int sock = socket( AF_INET, SOCK_STREAM, 0 );
+
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  if( (sock < 0) || (connect( sock, (struct sockaddr *)&addr, sizeof(addr) ) != 0) )
+  {
+    if( sock >= 0 )
+    {
+      close( sock );
+    }
+    return false;
+  }
+  snprintf( request, sizeof(request), "GET %s HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n", path );
+  send( sock, request, strlen( request ), MSG_NOSIGNAL );
+  while( (len < (size - 1u)) && ((got = recv( sock, reply + len, size - 1u - len, 0 )) > 0) )
+  {
+    len += (size_t)got;
+  }
+  close( sock );
+  reply[len] = '\0';
+  body = strstr( reply, "\r\n\r\n" );
+  if( body == NULL )
+  {
+    return false;
+  }
+  memmove( reply, body + 4, strlen( body + 4 ) + 1u );
+  return true;
+}
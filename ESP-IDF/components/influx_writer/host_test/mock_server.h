@@ -0,0 +1,24 @@
+/*
+ * mock_server.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Runs tools/mock_influxdb.py for the host test and benchmark and reads its
+ * counters over GET /stats.
+ */
+
+#ifndef MOCK_SERVER_H_
+#define MOCK_SERVER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Public Function Prototypes
+bool mock_start( const char *script, const char *args, char *url, size_t url_size );
+long mock_stat( const char *name );
+bool mock_last( char *line, size_t size );
+void mock_stop( void );
+
+#endif /* MOCK_SERVER_H_ */
@@ -0,0 +1,24 @@
+/*
+ * esp_err.h
+ *
+ * Host build stub, the error codes used by the writer and the components it
+ * uses, it replaces the one of the udp_uplink stubs
+ */
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+
+typedef int esp_err_t;
+
+#define ESP_OK                              (0)
+#define ESP_FAIL                            (-1)
+#define ESP_ERR_NO_MEM                      (0x101)
+#define ESP_ERR_INVALID_ARG                 (0x102)
+#define ESP_ERR_INVALID_STATE               (0x103)
+#define ESP_ERR_NOT_FOUND                   (0x105)
+#define ESP_ERR_TIMEOUT                     (0x107)
+#define ESP_ERR_NVS_NOT_FOUND               (0x1102)
+#define ESP_ERR_HTTP_CONNECT                (0x7003)
+
+const char * esp_err_to_name( esp_err_t code );
+
+#endif /* ESP_ERR_H_ */
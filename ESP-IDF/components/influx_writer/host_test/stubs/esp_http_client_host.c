@@ -0,0 +1,435 @@
+/*
+ * esp_http_client_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * HTTP/1.1 client for the host build of the InfluxDB writer, on top of POSIX
+ * sockets. It behaves like esp_http_client where the writer and the pool
+ * depend on it: the connection is kept open between requests, the request
+ * headers are a list (perform and open put Content-Length or
+ * Transfer-Encoding into it, like ESP-IDF does), the events ON_CONNECTED,
+ * ON_HEADER and DISCONNECTED are given to the event handler and a failed
+ * request leaves the connection to the caller to close. Only plain http and
+ * responses with Content-Length are supported, that's what the mock server
+ * sends.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "esp_http_client.h"
+
+#define HTTP_HOST_HEADERS                   (12u)
+#define HTTP_HOST_KEY_MAX                   (32u)
+#define HTTP_HOST_VALUE_MAX                 (128u)
+#define HTTP_HOST_URL_MAX                   (256u)
+#define HTTP_HOST_HOST_MAX                  (64u)
+#define HTTP_HOST_RX_SIZE                   (2048u)
+#define HTTP_HOST_LINE_MAX                  (512u)
+
+typedef struct _http_host_header_t
+{
+  char  key[HTTP_HOST_KEY_MAX];
+  char  value[HTTP_HOST_VALUE_MAX];
+} http_host_header_t;
+
+struct esp_http_client
+{
+  char                      host[HTTP_HOST_HOST_MAX];
+  char                      port[8];
+  char                      path[HTTP_HOST_URL_MAX];
+  esp_http_client_method_t  method;
+  int                       timeout_ms;
+  http_event_handle_cb      event_handler;
+  void                      *user_data;
+  http_host_header_t        headers[HTTP_HOST_HEADERS];
+  const char                *post_data;
+  int                       post_len;
+  int                       sock;
+  int                       status;
+  int                       content_length;
+  bool                      close_after;        // server sent Connection: close
+  char                      rx[HTTP_HOST_RX_SIZE];
+  size_t                    rx_len;
+};
+
+static esp_err_t http_host_connect( esp_http_client_handle_t client );
+static esp_err_t http_host_send_head( esp_http_client_handle_t client );
+static bool http_host_send( esp_http_client_handle_t client, const char *data, size_t len );
+static bool http_host_read_line( esp_http_client_handle_t client, char *line, size_t size );
+static void http_host_event( esp_http_client_handle_t client, esp_http_client_event_id_t id, char *key, char *value );
+
+esp_http_client_handle_t esp_http_client_init( const esp_http_client_config_t *config )
+{
+  esp_http_client_handle_t client = calloc( 1, sizeof(struct esp_http_client) );
+
+  if( client == NULL )
+  {
+    return NULL;
+  }
+  client->sock = -1;
+  client->method = config->method;
+  client->timeout_ms = config->timeout_ms ? config->timeout_ms : 5000;
+  client->event_handler = config->event_handler;
+  client->user_data = config->user_data;
+  if( esp_http_client_set_url( client, config->url ) != ESP_OK )
+  {
+    free( client );
+    return NULL;
+  }
+  return client;
+}
+
+esp_err_t esp_http_client_cleanup( esp_http_client_handle_t client )
+{
+  esp_http_client_close( client );
+  free( client );
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_url( esp_http_client_handle_t client, const char *url )
+{
+  char host[HTTP_HOST_HOST_MAX] = { 0 };
+  char port[8] = "80";
+  const char *start = NULL;
+  const char *path = NULL;
+  const char *colon = NULL;
+
+  if( strncmp( url, "http://", 7 ) != 0 )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  start = url + 7;
+  path = start + strcspn( start, "/" );
+  colon = memchr( start, ':', (size_t)(path - start) );
+  if( (size_t)(((colon != NULL) ? colon : path) - start) >= sizeof(host) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memcpy( host, start, (size_t)(((colon != NULL) ? colon : path) - start) );
+  if( colon != NULL )
+  {
+    snprintf( port, sizeof(port), "%.*s", (int)(path - colon - 1), colon + 1 );
+  }
+  if( (strcmp( host, client->host ) != 0) || (strcmp( port, client->port ) != 0) )
+  {
+    // other server, the open connection can't be used
+    esp_http_client_close( client );
+    strcpy( client->host, host );
+    strcpy( client->port, port );
+  }
+  snprintf( client->path, sizeof(client->path), "%s", (*path != '\0') ? path : "/" );
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_method( esp_http_client_handle_t client, esp_http_client_method_t method )
+{
+  client->method = method;
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header( esp_http_client_handle_t client, const char *key, const char *value )
+{
+  http_host_header_t *free_slot = NULL;
+
+  for( uint32_t idx = 0; idx < HTTP_HOST_HEADERS; idx++ )
+  {
+    if( strcasecmp( client->headers[idx].key, key ) == 0 )
+    {
+      snprintf( client->headers[idx].value, HTTP_HOST_VALUE_MAX, "%s", value );
+      return ESP_OK;
+    }
+    if( (free_slot == NULL) && (client->headers[idx].key[0] == '\0') )
+    {
+      free_slot = &client->headers[idx];
+    }
+  }
+  if( (free_slot == NULL) || (strlen( key ) >= HTTP_HOST_KEY_MAX) )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  strcpy( free_slot->key, key );
+  snprintf( free_slot->value, HTTP_HOST_VALUE_MAX, "%s", value );
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_delete_header( esp_http_client_handle_t client, const char *key )
+{
+  for( uint32_t idx = 0; idx < HTTP_HOST_HEADERS; idx++ )
+  {
+    if( strcasecmp( client->headers[idx].key, key ) == 0 )
+    {
+      client->headers[idx].key[0] = '\0';
+    }
+  }
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field( esp_http_client_handle_t client, const char *data, int len )
+{
+  client->post_data = data;
+  client->post_len = len;
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_perform( esp_http_client_handle_t client )
+{
+  esp_err_t err = esp_http_client_open( client, client->post_len );
+
+  if( err != ESP_OK )
+  {
+    return err;
+  }
+  if( (client->post_len > 0) && (esp_http_client_write( client, client->post_data, client->post_len ) != client->post_len) )
+  {
+    return ESP_FAIL;
+  }
+  if( esp_http_client_fetch_headers( client ) < 0 )
+  {
+    return ESP_FAIL;
+  }
+  return esp_http_client_flush_response( client, NULL );
+}
+
+esp_err_t esp_http_client_open( esp_http_client_handle_t client, int write_len )
+{
+  char len[16];
+
+  if( write_len < 0 )
+  {
+    esp_http_client_set_header( client, "Transfer-Encoding", "chunked" );
+  }
+  else if( (write_len > 0) || (client->method == HTTP_METHOD_POST) )
+  {
+    snprintf( len, sizeof(len), "%d", write_len );
+    esp_http_client_set_header( client, "Content-Length", len );
+  }
+  if( (client->sock < 0) && (http_host_connect( client ) != ESP_OK) )
+  {
+    return ESP_ERR_HTTP_CONNECT;
+  }
+  return http_host_send_head( client );
+}
+
+int esp_http_client_write( esp_http_client_handle_t client, const char *buffer, int len )
+{
+  return http_host_send( client, buffer, (size_t)len ) ? len : -1;
+}
+
+int esp_http_client_fetch_headers( esp_http_client_handle_t client )
+{
+  char line[HTTP_HOST_LINE_MAX];
+  char *value = NULL;
+
+  client->status = -1;
+  client->content_length = 0;
+  client->close_after = false;
+  if( (http_host_read_line( client, line, sizeof(line) ) == false) || \
+      (sscanf( line, "HTTP/1.%*d %d", &client->status ) != 1) )
+  {
+    return -1;
+  }
+  while( http_host_read_line( client, line, sizeof(line) ) )
+  {
+    if( line[0] == '\0' )
+    {
+      return client->content_length;
+    }
+    value = strchr( line, ':' );
+    if( value == NULL )
+    {
+      continue;
+    }
+    *value++ = '\0';
+    value += strspn( value, " \t" );
+    if( strcasecmp( line, "Content-Length" ) == 0 )
+    {
+      client->content_length = atoi( value );
+    }
+    else if( (strcasecmp( line, "Connection" ) == 0) && (strcasecmp( value, "close" ) == 0) )
+    {
+      client->close_after = true;
+    }
+    http_host_event( client, HTTP_EVENT_ON_HEADER, line, value );
+  }
+  return -1;
+}
+
+esp_err_t esp_http_client_flush_response( esp_http_client_handle_t client, int *len )
+{
+  size_t left = (size_t)client->content_length;
+  size_t take = 0;
+  ssize_t got = 0;
+
+  while( left > 0 )
+  {
+    if( client->rx_len == 0 )
+    {
+      got = recv( client->sock, client->rx, sizeof(client->rx), 0 );
+      if( got <= 0 )
+      {
+        return ESP_FAIL;
+      }
+      client->rx_len = (size_t)got;
+    }
+    take = (left < client->rx_len) ? left : client->rx_len;
+    memmove( client->rx, client->rx + take, client->rx_len - take );
+    client->rx_len -= take;
+    left -= take;
+  }
+  if( len != NULL )
+  {
+    *len = client->content_length;
+  }
+  if( client->close_after )
+  {
+    esp_http_client_close( client );
+  }
+  return ESP_OK;
+}
+
+int esp_http_client_get_status_code( esp_http_client_handle_t client )
+{
+  return client->status;
+}
+
+esp_err_t esp_http_client_close( esp_http_client_handle_t client )
+{
+  if( client->sock >= 0 )
+  {
+    close( client->sock );
+    client->sock = -1;
+    client->rx_len = 0;
+    http_host_event( client, HTTP_EVENT_DISCONNECTED, NULL, NULL );
+  }
+  return ESP_OK;
+}
+
+static esp_err_t http_host_connect( esp_http_client_handle_t client )
+{
+  struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_STREAM };
+  struct addrinfo *res = NULL;
+  struct timeval timeout = { .tv_sec = client->timeout_ms / 1000, .tv_usec = (client->timeout_ms % 1000) * 1000 };
+  int one = 1;
+
+  if( (getaddrinfo( client->host, client->port, &hints, &res ) != 0) || (res == NULL) )
+  {
+    return ESP_FAIL;
+  }
+  client->sock = socket( res->ai_family, res->ai_socktype, res->ai_protocol );
+  if( (client->sock < 0) || (connect( client->sock, res->ai_addr, res->ai_addrlen ) != 0) )
+  {
+    if( client->sock >= 0 )
+    {
+      close( client->sock );
+    }
+    client->sock = -1;
+    freeaddrinfo( res );
+    return ESP_FAIL;
+  }
+  freeaddrinfo( res );
+  setsockopt( client->sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+  setsockopt( client->sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout) );
+  // lwIP has Nagle too, but the chunks of the gzip body would wait for the ACK here
+  setsockopt( client->sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one) );
+  client->rx_len = 0;
+  http_host_event( client, HTTP_EVENT_ON_CONNECTED, NULL, NULL );
+  return ESP_OK;
+}
+
+static esp_err_t http_host_send_head( esp_http_client_handle_t client )
+{
+  char head[HTTP_HOST_URL_MAX + HTTP_HOST_HEADERS * (HTTP_HOST_KEY_MAX + HTTP_HOST_VALUE_MAX + 4u) + 128u];
+  int len = 0;
+
+  len = snprintf( head, sizeof(head), "%s %s HTTP/1.1\r\nHost: %s:%s\r\nUser-Agent: ESP32 HTTP Client/1.0\r\n", \
+                  (client->method == HTTP_METHOD_POST) ? "POST" : "GET", client->path, client->host, client->port );
+  for( uint32_t idx = 0; idx < HTTP_HOST_HEADERS; idx++ )
+  {
+    if( client->headers[idx].key[0] != '\0' )
+    {
+      len += snprintf( head + len, sizeof(head) - (size_t)len, "%s: %s\r\n", \
+                       client->headers[idx].key, client->headers[idx].value );
+    }
+  }
+  len += snprintf( head + len, sizeof(head) - (size_t)len, "\r\n" );
+  return http_host_send( client, head, (size_t)len ) ? ESP_OK : ESP_FAIL;
+}
+
+static bool http_host_send( esp_http_client_handle_t client, const char *data, size_t len )
+{
+  ssize_t sent = 0;
+
+  while( len > 0 )
+  {
+    sent = send( client->sock, data, len, MSG_NOSIGNAL );
+    if( sent <= 0 )
+    {
+      return false;
+    }
+    data += sent;
+    len -= (size_t)sent;
+  }
+  return true;
+}
+
+static bool http_host_read_line( esp_http_client_handle_t client, char *line, size_t size )
+{
+  char *eol = NULL;
+  size_t len = 0;
+  ssize_t got = 0;
+
+  while( (eol = memchr( client->rx, '\n', client->rx_len )) == NULL )
+  {
+    if( client->rx_len == sizeof(client->rx) )
+    {
+      return false;
+    }
+    got = recv( client->sock, client->rx + client->rx_len, sizeof(client->rx) - client->rx_len, 0 );
+    if( got <= 0 )
+    {
+      return false;
+    }
+    client->rx_len += (size_t)got;
+  }
+  len = (size_t)(eol - client->rx);
+  if( (len > 0) && (client->rx[len - 1u] == '\r') )
+  {
+    len--;
+  }
+  if( len >= size )
+  {
+    len = size - 1u;
+  }
+  memcpy( line, client->rx, len );
+  line[len] = '\0';
+  len = (size_t)(eol - client->rx) + 1u;
+  memmove( client->rx, client->rx + len, client->rx_len - len );
+  client->rx_len -= len;
+  return true;
+}
+
+static void http_host_event( esp_http_client_handle_t client, esp_http_client_event_id_t id, char *key, char *value )
+{
+  esp_http_client_event_t evt =
+  {
+    .event_id = id,
+    .client = client,
+    .user_data = client->user_data,
+    .header_key = key,
+    .header_value = value,
+  };
+
+  if( client->event_handler != NULL )
+  {
+    client->event_handler( &evt );
+  }
+}
@@ -0,0 +1,26 @@
+/*
+ * nvs.h
+ *
+ * Host build stub, a few u32 keys kept in RAM, see nvs_host.c
+ */
+#ifndef NVS_H_
+#define NVS_H_
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum {
+  NVS_READONLY = 0,
+  NVS_READWRITE,
+} nvs_open_mode_t;
+
+esp_err_t nvs_open( const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle );
+esp_err_t nvs_get_u32( nvs_handle_t handle, const char *key, uint32_t *out_value );
+esp_err_t nvs_set_u32( nvs_handle_t handle, const char *key, uint32_t value );
+esp_err_t nvs_commit( nvs_handle_t handle );
+void nvs_close( nvs_handle_t handle );
+
+#endif /* NVS_H_ */
@@ -0,0 +1,100 @@
+/*
+ * nvs_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * NVS and esp_err_to_name for the host build of the InfluxDB writer. The
+ * values live in RAM for the run, the test writes the "saved" time before the
+ * writer starts to simulate a reboot.
+ */
+#include <string.h>
+#include <stdio.h>
+
+#include "esp_err.h"
+#include "nvs.h"
+
+#define NVS_HOST_KEYS                       (8u)
+#define NVS_HOST_KEY_MAX                    (32u)
+
+typedef struct _nvs_host_entry_t
+{
+  char      key[NVS_HOST_KEY_MAX];
+  uint32_t  value;
+} nvs_host_entry_t;
+
+static nvs_host_entry_t nvs_host_entries[NVS_HOST_KEYS];
+static uint32_t nvs_host_count = 0;
+
+esp_err_t nvs_open( const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle )
+{
+  (void)name;
+  (void)open_mode;
+  *out_handle = 1;
+  return ESP_OK;
+}
+
+esp_err_t nvs_get_u32( nvs_handle_t handle, const char *key, uint32_t *out_value )
+{
+  (void)handle;
+  for( uint32_t idx = 0; idx < nvs_host_count; idx++ )
+  {
+    if( strcmp( nvs_host_entries[idx].key, key ) == 0 )
+    {
+      *out_value = nvs_host_entries[idx].value;
+      return ESP_OK;
+    }
+  }
+  return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_set_u32( nvs_handle_t handle, const char *key, uint32_t value )
+{
+  (void)handle;
+  for( uint32_t idx = 0; idx < nvs_host_count; idx++ )
+  {
+    if( strcmp( nvs_host_entries[idx].key, key ) == 0 )
+    {
+      nvs_host_entries[idx].value = value;
+      return ESP_OK;
+    }
+  }
+  if( (nvs_host_count == NVS_HOST_KEYS) || (strlen( key ) >= NVS_HOST_KEY_MAX) )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  strcpy( nvs_host_entries[nvs_host_count].key, key );
+  nvs_host_entries[nvs_host_count].value = value;
+  nvs_host_count++;
+  return ESP_OK;
+}
+
+esp_err_t nvs_commit( nvs_handle_t handle )
+{
+  (void)handle;
+  return ESP_OK;
+}
+
+void nvs_close( nvs_handle_t handle )
+{
+  (void)handle;
+}
+
+const char * esp_err_to_name( esp_err_t code )
+{
+  static __thread char name[16];
+
+  switch( code )
+  {
+    case ESP_OK:                return "ESP_OK";
+    case ESP_FAIL:              return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_HTTP_CONNECT:  return "ESP_ERR_HTTP_CONNECT";
+    default:
+      snprintf( name, sizeof(name), "0x%x", (unsigned)code );
+      return name;
+  }
+}
@@ -0,0 +1,111 @@
+/*
+ * influx_writer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Batched InfluxDB v2 line protocol writer, shared by the InfluxDB projects.
+ * It is a telemetry bus sink, the samples are stored in a spool with the
+ * monotonic time, so nothing is lost before the time synchronization or
+ * while the link is down. When time is known the spool is rebased to UTC and
+ * drained oldest first into a line protocol batch, at most drain_batch
+ * samples every drain_interval_ms, the first drain after reconnect is delayed
+ * by a random time so that devices don't upload their backlog together.
+ * A batch is written over one keep-alive connection of the HTTP pool when it
+ * has batch_points points, batch_bytes bytes or when the oldest point is
+ * batch_age_ms old. On 429, 5xx or a network error the batch is kept and
+ * retried with jittered exponential backoff (Retry-After is respected), when
+ * the buffer limit is reached the oldest points are dropped. Batches are gzip
+ * compressed while sending (chunked transfer), if the server doesn't accept
+ * gzip plain text is used from then on.
+ * Values are written as float fields rounded to whole numbers (clamped to
+ * int16_t). Local samples which never reached the server, because the spool
+ * was full or they were lost with a reset, can be read back from a history
+ * before the spool is drained, the time of the newest written local point is
+ * kept in NVS for this.
+ * tools/mock_influxdb.py is a local server for tests and benchmarks, see
+ * host_test for the host build.
+ */
+
+#ifndef INFLUX_WRITER_H_
+#define INFLUX_WRITER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "spool.h"
+#include "telemetry.h"
+
+/**
+ * @brief Called by the history reader for every record, oldest first
+ * @param time_s UTC seconds of the record
+ * @param values values in the order of the configured fields
+ * @param count number of values
+ * @return false if the batch can't take more records, stop reading then
+ */
+typedef bool (*influx_writer_add_t)( uint32_t time_s, const int32_t *values, uint8_t count );
+
+/**
+ * @brief History reader, gives the local records with after_s < time < before_s
+ *        to add, it is called from the writer task
+ * @param ctx history_ctx of the configuration
+ * @param after_s newest local point already written or in batch
+ * @param before_s oldest sample in spool
+ * @param add function to call for every record
+ */
+typedef void (*influx_writer_history_t)( void *ctx, uint32_t after_s, uint32_t before_s, influx_writer_add_t add );
+
+typedef struct _influx_writer_config_t
+{
+  const char                *url;             // server URL without path
+  const char                *org;
+  const char                *bucket;
+  const char                *token;
+  const char                *measurement;
+  const char                *device_id;       // device_id tag, virtual devices get "-<n>"
+  const char * const        *fields;          // names of the telemetry sample values
+  uint8_t                   field_count;
+  uint32_t                  batch_points;
+  uint32_t                  batch_bytes;      // pending data is limited to 4 times of this
+  uint32_t                  batch_age_ms;
+  bool                      gzip;
+  uint32_t                  spool_records;
+  spool_drop_t              spool_drop;
+  uint32_t                  drain_batch;
+  uint32_t                  drain_interval_ms;
+  bool                      (*link_up)( void );
+  bool                      (*time_synced)( void );
+  long long                 (*time_ns)( void );     // UTC time, used when time_synced
+  influx_writer_history_t   history;          // optional
+  void                      *history_ctx;
+} influx_writer_config_t;
+
+typedef struct _influx_writer_metrics_t
+{
+  uint32_t  points_sent;
+  uint32_t  points_dropped;                   // dropped due to buffer full or rejected by server
+  uint64_t  bytes_sent;                       // line protocol bytes
+  uint64_t  bytes_wire;                       // request body bytes, less than bytes_sent with gzip
+  uint32_t  flushes;                          // number of write requests
+  uint32_t  retries;                          // write requests failed with 429/5xx or network error
+  uint32_t  failures;                         // write requests rejected by server (4xx)
+  uint32_t  last_flush_ms;
+  uint32_t  max_flush_ms;
+  uint64_t  total_flush_ms;
+  float     points_per_s;
+  float     bytes_per_s;
+  uint32_t  spool_depth;                      // samples waiting for time sync or link
+  uint32_t  spool_dropped;                    // samples dropped due to spool full
+  uint32_t  backfilled;                       // points read back from the history
+  bool      gzip;                             // batches are compressed now
+} influx_writer_metrics_t;
+
+// Public Function Prototypes
+esp_err_t influx_writer_start( const influx_writer_config_t *config );
+void influx_writer_flush( void );
+void influx_writer_get_metrics( influx_writer_metrics_t *metrics );
+telemetry_sink_t * influx_writer_get_sink( void );
+
+#endif /* INFLUX_WRITER_H_ */
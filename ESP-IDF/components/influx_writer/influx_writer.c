@@ -0,0 +1,1003 @@
+/*
+ * influx_writer.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "nvs.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "esp_http_client.h"
+#include "http_pool.h"
+#include "serializer.h"
+#include "gzip_stream.h"
+#include "influx_writer.h"
+
+// Private Macros
+#define INFLUX_WRITER_TASK_STACK            (4096*2)
+#define INFLUX_WRITER_TASK_PRIORITY         (6)
+#define INFLUX_WRITER_URL_MAX               (200u)
+#define INFLUX_WRITER_LINE_MAX              (160u)    // maximum size of one point
+#define INFLUX_WRITER_BACKOFF_MIN_MS        (1000u)
+#define INFLUX_WRITER_BACKOFF_MAX_MS        (120000u)
+#define INFLUX_WRITER_HTTP_TIMEOUT_MS       (5000)
+#define INFLUX_WRITER_HTTP_ERROR            (-1)      // status when request couldn't complete
+#define INFLUX_WRITER_CHUNK_HEADER_MAX      (12u)
+#define INFLUX_WRITER_SINK_DEPTH            (4u)      // samples waiting for the task
+#define INFLUX_WRITER_POLL_MS               (1000u)   // link and time check when samples are waiting
+#define INFLUX_WRITER_NVS_NAMESPACE         "influxdb"
+#define INFLUX_WRITER_NVS_LAST_TIME         "last_time"
+#define INFLUX_WRITER_BACKFILL_GUARD_S      (2u)      // history and spool time of one reading differ a bit
+#define INFLUX_WRITER_RECORD_SIZE(fields)   (2u + (fields) * sizeof(int16_t))
+
+typedef enum {
+  INFLUX_WRITER_FLUSH_OK = 0,             // written, batch can be discarded
+  INFLUX_WRITER_FLUSH_RETRY,              // server busy or not reachable, retry later
+  INFLUX_WRITER_FLUSH_REJECT,             // server doesn't accept this data, drop it
+} influx_writer_flush_t;
+
+typedef struct _influx_writer_batch_t
+{
+  char      *buffer;
+  size_t    size;                         // allocated size
+  size_t    len;                          // used size
+  uint32_t  points;
+  int64_t   first_ms;                     // time when the oldest point was added
+  int64_t   retry_ms;                     // no flush before this time (backoff)
+  uint32_t  backoff_ms;
+  uint32_t  retry_after_ms;               // Retry-After received from server
+  uint32_t  last_time;                    // UTC seconds of the newest local point
+} influx_writer_batch_t;
+
+// sample stored in spool, time stamp is kept by the spool, only field_count
+// values are stored
+typedef struct _influx_writer_record_t
+{
+  uint8_t   source;                       // 0 for local sensors, else virtual device
+  uint8_t   count;
+  int16_t   value[TELEMETRY_VALUES_MAX];
+} influx_writer_record_t;
+
+// Private Variables
+static const char *TAG = "InfluxDB";
+static influx_writer_config_t influx_config = { 0 };
+static TaskHandle_t influx_task = NULL;
+static volatile bool influx_force = false;  // write the pending points now
+static portMUX_TYPE influx_metrics_lock = portMUX_INITIALIZER_UNLOCKED;
+static influx_writer_batch_t influx_batch = { 0 };
+static influx_writer_metrics_t influx_metrics = { 0 };
+static int64_t influx_start_ms = 0;
+static gzip_stream_t influx_gzip = { 0 };
+static bool influx_gzip_enabled = false;
+static size_t influx_body_len = 0;          // bytes sent on wire for last request
+static spool_t influx_spool = { 0 };
+static int64_t influx_drain_ms = 0;         // no drain before this time
+static bool influx_link_up = false;
+static telemetry_sink_t influx_sink = { 0 };
+static telemetry_sample_t influx_sink_queue[INFLUX_WRITER_SINK_DEPTH];
+static uint32_t influx_written_time = 0;    // newest local point written, saved in NVS
+static uint32_t influx_queued_time = 0;     // newest local point written or in batch
+static uint32_t influx_drain_count = 0;     // samples added in the current drain
+static char influx_full_url[INFLUX_WRITER_URL_MAX] = { 0 };
+static char influx_auth[INFLUX_WRITER_URL_MAX] = { 0 };
+
+// Private Function Declaration
+static void influx_writer_task( void *pvParameters );
+static void influx_writer_notify( void *ctx );
+static void influx_writer_spool_samples( void );
+static void influx_writer_drain( int64_t now_ms );
+static bool influx_writer_backfill( uint32_t t_before );
+static bool influx_writer_backfill_add( uint32_t time_s, const int32_t *values, uint8_t count );
+static int16_t influx_writer_round( float value );
+static void influx_writer_written_time_load( void );
+static void influx_writer_written_time_save( uint32_t time_s );
+static bool influx_writer_batch_add( const influx_writer_record_t *record, int64_t time_ns );
+static bool influx_writer_batch_reserve( size_t len );
+static void influx_writer_batch_drop_oldest( size_t len );
+static bool influx_writer_flush_due( int64_t now_ms );
+static TickType_t influx_writer_next_wait( int64_t now_ms );
+static TickType_t influx_writer_wait_till( int64_t due_ms, int64_t now_ms );
+static void influx_writer_write( void );
+static influx_writer_flush_t influx_writer_post( const char *data, size_t len );
+static int influx_writer_post_plain( esp_http_client_handle_t client, const char *data, size_t len );
+static int influx_writer_post_gzip( esp_http_client_handle_t client, const char *data, size_t len );
+static esp_err_t influx_writer_gzip_chunk( void *ctx, const uint8_t *data, size_t len );
+static esp_err_t influx_writer_http_event_handler( esp_http_client_event_t *evt );
+static esp_http_client_handle_t influx_writer_client_get( void );
+static void influx_writer_count_dropped( uint32_t points );
+static int64_t influx_writer_now_ms( void );
+
+// Public Function Definition
+
+/**
+ * @brief Start the InfluxDB writer, it registers a sink on telemetry bus
+ * @param config configuration, strings must stay valid
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t influx_writer_start( const influx_writer_config_t *config )
+{
+  size_t record_size = INFLUX_WRITER_RECORD_SIZE( config->field_count );
+  size_t spool_size = 0;
+  void *spool_buffer = NULL;
+  int len = 0;
+
+  if( (config->url == NULL) || (config->measurement == NULL) || (config->fields == NULL) || \
+      (config->field_count == 0) || (config->field_count > TELEMETRY_VALUES_MAX) || \
+      (config->spool_records == 0) || (config->drain_batch == 0) || (config->link_up == NULL) || \
+      (config->time_synced == NULL) || (config->time_ns == NULL) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( influx_task != NULL )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  influx_config = *config;
+  len = snprintf( influx_full_url, sizeof(influx_full_url), "%s/api/v2/write?org=%s&bucket=%s&precision=ns", \
+                  influx_config.url, influx_config.org, influx_config.bucket );
+  if( (len < 0) || ((size_t)len >= sizeof(influx_full_url)) )
+  {
+    ESP_LOGE(TAG, "Write URL is too long");
+    return ESP_ERR_INVALID_ARG;
+  }
+  snprintf( influx_auth, sizeof(influx_auth), "Token %s", influx_config.token ? influx_config.token : "" );
+
+  spool_size = (size_t)influx_config.spool_records * SPOOL_SLOT_SIZE(record_size);
+  spool_buffer = malloc( spool_size );
+  if( spool_buffer == NULL )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  spool_init( &influx_spool, spool_buffer, spool_size, record_size, influx_config.spool_drop );
+  telemetry_sink_init( &influx_sink, "influxdb", influx_sink_queue, INFLUX_WRITER_SINK_DEPTH, \
+                       TELEMETRY_DROP_OLDEST, influx_writer_notify, NULL );
+  influx_start_ms = influx_writer_now_ms();
+  if( influx_config.history != NULL )
+  {
+    influx_writer_written_time_load();
+  }
+  influx_gzip_enabled = influx_config.gzip;
+  if( influx_gzip_enabled )
+  {
+    gzip_stream_config_t gzip_config = GZIP_STREAM_CONFIG_DEFAULT();
+    if( gzip_stream_init( &influx_gzip, &gzip_config ) != ESP_OK )
+    {
+      ESP_LOGW(TAG, "Unable to allocate gzip compressor, data is sent uncompressed");
+      influx_gzip_enabled = false;
+    }
+  }
+  if( xTaskCreate( &influx_writer_task, "InfluxDB Task", INFLUX_WRITER_TASK_STACK, NULL, \
+                   INFLUX_WRITER_TASK_PRIORITY, &influx_task ) != pdPASS )
+  {
+    // sink is not registered yet, undo everything so that start can be retried
+    gzip_stream_deinit( &influx_gzip );
+    memset( &influx_sink, 0x00, sizeof(influx_sink) );
+    memset( &influx_spool, 0x00, sizeof(influx_spool) );
+    free( spool_buffer );
+    influx_task = NULL;
+    return ESP_ERR_NO_MEM;
+  }
+  telemetry_sink_register( &influx_sink );
+  return ESP_OK;
+}
+
+/**
+ * @brief Write the pending points now, without waiting for the batch limits
+ * @param  none
+ */
+void influx_writer_flush( void )
+{
+  if( influx_task != NULL )
+  {
+    influx_force = true;
+    xTaskNotifyGive( influx_task );
+  }
+}
+
+/**
+ * @brief Get the InfluxDB writer metrics, rates are averaged since start
+ * @param metrics metrics output
+ */
+void influx_writer_get_metrics( influx_writer_metrics_t *metrics )
+{
+  float elapsed_s = 0.0;
+
+  taskENTER_CRITICAL( &influx_metrics_lock );
+  *metrics = influx_metrics;
+  taskEXIT_CRITICAL( &influx_metrics_lock );
+  // spool is owned by writer task, 32-bit reads are atomic
+  metrics->spool_depth = spool_count( &influx_spool );
+  metrics->spool_dropped = spool_dropped( &influx_spool );
+  metrics->gzip = influx_gzip_enabled;
+
+  elapsed_s = (float)(influx_writer_now_ms() - influx_start_ms) / 1000.0f;
+  if( elapsed_s > 0.0f )
+  {
+    metrics->points_per_s = (float)metrics->points_sent / elapsed_s;
+    metrics->bytes_per_s = (float)metrics->bytes_sent / elapsed_s;
+  }
+}
+
+/**
+ * @brief Get the telemetry sink of the writer, used for sink statistics
+ * @param  none
+ * @return telemetry sink
+ */
+telemetry_sink_t * influx_writer_get_sink( void )
+{
+  return &influx_sink;
+}
+
+// Private Function Definition
+
+/**
+ * @brief InfluxDB Writer Task
+ * The task is woken up by the telemetry bus, the wait timeout is the time
+ * when the spool can be drained or the pending batch is due, so that old
+ * points are not kept forever
+ * @param pvParameters
+ */
+static void influx_writer_task( void *pvParameters )
+{
+  bool force = false;
+
+  (void)pvParameters;
+  while( 1 )
+  {
+    ulTaskNotifyTake( pdTRUE, influx_writer_next_wait(influx_writer_now_ms()) );
+    force = influx_force;
+    influx_force = false;
+
+    influx_writer_spool_samples();
+    influx_writer_drain( influx_writer_now_ms() );
+    if( influx_batch.points && (force || influx_writer_flush_due(influx_writer_now_ms())) )
+    {
+      influx_writer_write();
+    }
+    // keep-alive connection not used since long is closed to free TLS memory
+    http_pool_sweep();
+  }
+}
+
+/**
+ * @brief Telemetry bus notify callback, called from the sensor loop, it only
+ *        wakes up the writer task
+ * @param ctx not used
+ */
+static void influx_writer_notify( void *ctx )
+{
+  (void)ctx;
+  xTaskNotifyGive( influx_task );
+}
+
+/**
+ * @brief Store the samples received from telemetry bus in spool, they are
+ *        written to InfluxDB when the time is synchronized and the link is up
+ * @param  none
+ */
+static void influx_writer_spool_samples( void )
+{
+  telemetry_sample_t bus_sample;
+  influx_writer_record_t record = { 0 };
+
+  while( telemetry_receive( &influx_sink, &bus_sample ) )
+  {
+    record.source = bus_sample.source;
+    record.count = influx_config.field_count;
+    for( uint8_t idx = 0; idx < influx_config.field_count; idx++ )
+    {
+      record.value[idx] = (idx < bus_sample.count) ? influx_writer_round( bus_sample.value[idx] ) : 0;
+    }
+    // time stamp is from the sensor loop, so the point is correct even if written later
+    if( spool_push( &influx_spool, bus_sample.time_us, &record ) == false )
+    {
+      ESP_LOGW(TAG, "Spool full, sample dropped");
+    }
+  }
+}
+
+/**
+ * @brief Move the samples from spool to the batch, oldest first and at most
+ *        drain_batch samples every drain_interval_ms
+ * @param now_ms current time in milliseconds
+ */
+static void influx_writer_drain( int64_t now_ms )
+{
+  bool link_up = influx_config.link_up();
+  bool synced = spool_is_synced( &influx_spool );
+  influx_writer_record_t record;
+  int64_t time_us = 0;
+
+  // link is back, wait for a random time before uploading the backlog, else
+  // all the devices behind the same router hit the server at the same moment
+  if( link_up && !influx_link_up )
+  {
+    influx_drain_ms = now_ms + (esp_random() % (influx_config.drain_interval_ms + 1));
+  }
+  influx_link_up = link_up;
+
+  // spool offset is updated with every call, so that drift of esp_timer is
+  // corrected, samples taken before first synchronization are rebased to UTC
+  if( influx_config.time_synced() )
+  {
+    spool_set_time( &influx_spool, influx_config.time_ns() / 1000, esp_timer_get_time() );
+    if( !synced )
+    {
+      ESP_LOGI(TAG, "Time synchronized, %" PRIu32 " spooled samples rebased", spool_count(&influx_spool));
+      synced = true;
+    }
+  }
+
+  if( (spool_count(&influx_spool) == 0) || !link_up || !synced || \
+      (now_ms < influx_drain_ms) || (now_ms < influx_batch.retry_ms) )
+  {
+    return;
+  }
+
+  // local samples older than the spool were dropped by the spool or lost with
+  // a reset, they are read back from the history first
+  influx_drain_count = 0;
+  if( spool_peek( &influx_spool, 0, &time_us, &record ) && \
+      (influx_writer_backfill( (uint32_t)(time_us / 1000000) ) == false) )
+  {
+    influx_drain_ms = now_ms + influx_config.drain_interval_ms;
+    return;
+  }
+
+  while( (influx_drain_count < influx_config.drain_batch) && spool_peek( &influx_spool, 0, &time_us, &record ) )
+  {
+    if( influx_writer_batch_add( &record, time_us * 1000 ) == false )
+    {
+      break;
+    }
+    spool_pop( &influx_spool, 1 );
+    influx_drain_count++;
+  }
+  // remaining backlog is drained later, this limits the upload rate
+  if( spool_count(&influx_spool) )
+  {
+    influx_drain_ms = now_ms + influx_config.drain_interval_ms;
+  }
+}
+
+/**
+ * @brief Add the local samples from the history which are newer than the last
+ *        written point and older than the spool to the batch
+ * @param t_before UTC seconds of the oldest spooled sample
+ * @return true if the gap is filled, false if the drain limit was reached or
+ *         the batch has no memory
+ */
+static bool influx_writer_backfill( uint32_t t_before )
+{
+  uint32_t before_s = t_before - INFLUX_WRITER_BACKFILL_GUARD_S;
+  uint32_t count = influx_drain_count;
+
+  if( (influx_config.history == NULL) || ((influx_queued_time + INFLUX_WRITER_BACKFILL_GUARD_S) >= t_before) )
+  {
+    return true;
+  }
+  influx_config.history( influx_config.history_ctx, influx_queued_time, before_s, influx_writer_backfill_add );
+  taskENTER_CRITICAL( &influx_metrics_lock );
+  influx_metrics.backfilled += influx_drain_count - count;
+  taskEXIT_CRITICAL( &influx_metrics_lock );
+  if( influx_drain_count < influx_config.drain_batch )
+  {
+    // nothing left before the spool, also if the history has no older records
+    influx_queued_time = before_s;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief History reader callback, adds one local record to the batch
+ * @param time_s UTC seconds of the record
+ * @param values values in field order
+ * @param count number of values
+ * @return false if the drain limit is reached or the batch has no memory
+ */
+static bool influx_writer_backfill_add( uint32_t time_s, const int32_t *values, uint8_t count )
+{
+  influx_writer_record_t record = { 0 };
+
+  if( influx_drain_count >= influx_config.drain_batch )
+  {
+    return false;
+  }
+  record.count = influx_config.field_count;
+  for( uint8_t idx = 0; (idx < count) && (idx < influx_config.field_count); idx++ )
+  {
+    record.value[idx] = (values[idx] > INT16_MAX) ? INT16_MAX : \
+                        (values[idx] < INT16_MIN) ? INT16_MIN : (int16_t)values[idx];
+  }
+  if( influx_writer_batch_add( &record, (int64_t)time_s * 1000000000LL ) == false )
+  {
+    // drain is retried later, the records of this call are in batch already
+    influx_drain_count = influx_config.drain_batch;
+    return false;
+  }
+  influx_drain_count++;
+  return true;
+}
+
+/**
+ * @brief Round the sample value to a whole number, a float out of range must
+ *        not be cast directly, that is undefined behavior
+ * @param value sample value
+ * @return value clamped to int16_t, 0 for NaN
+ */
+static int16_t influx_writer_round( float value )
+{
+  if( value != value )
+  {
+    return 0;
+  }
+  if( value >= (float)INT16_MAX )
+  {
+    return INT16_MAX;
+  }
+  if( value <= (float)INT16_MIN )
+  {
+    return INT16_MIN;
+  }
+  return (int16_t)((value < 0.0f) ? (value - 0.5f) : (value + 0.5f));
+}
+
+/**
+ * @brief Add the point to the batch
+ * @param record spooled sample
+ * @param time_ns UTC time stamp of sample
+ * @return true if sample is consumed (added or dropped), false if there is no
+ *         memory and it should stay in spool
+ */
+static bool influx_writer_batch_add( const influx_writer_record_t *record, int64_t time_ns )
+{
+  ser_writer_t writer;
+
+  if( influx_writer_batch_reserve( INFLUX_WRITER_LINE_MAX ) == false )
+  {
+    ESP_LOGE(TAG, "Unable to allocate batch buffer");
+    return false;
+  }
+
+  // note: values are written as float fields (no 'i' suffix) as earlier, the
+  // field type can't be changed for existing data in bucket
+  ser_writer_init( &writer, influx_batch.buffer + influx_batch.len, INFLUX_WRITER_LINE_MAX );
+  ser_lp_measurement( &writer, influx_config.measurement );
+  if( influx_config.device_id != NULL )
+  {
+    ser_lp_tag( &writer, "device_id", influx_config.device_id );
+    if( record->source )
+    {
+      // virtual devices of load generator are separate series "<id>-<n>"
+      ser_char( &writer, '-' );
+      ser_uint( &writer, record->source );
+    }
+  }
+  for( uint8_t idx = 0; idx < influx_config.field_count; idx++ )
+  {
+    ser_lp_field_float( &writer, influx_config.fields[idx], record->value[idx], 0 );
+  }
+  ser_lp_end( &writer, time_ns );
+  if( ser_finish( &writer ) == false )
+  {
+    ESP_LOGE(TAG, "Point doesn't fit in line buffer");
+    influx_writer_count_dropped( 1 );
+    return true;
+  }
+
+  if( influx_batch.points == 0 )
+  {
+    influx_batch.first_ms = influx_writer_now_ms();
+  }
+  if( record->source == 0 )
+  {
+    uint32_t time_s = (uint32_t)(time_ns / 1000000000LL);
+    if( time_s > influx_batch.last_time )
+    {
+      influx_batch.last_time = time_s;
+    }
+    if( time_s > influx_queued_time )
+    {
+      influx_queued_time = time_s;
+    }
+  }
+  influx_batch.len += ser_len( &writer );
+  influx_batch.points++;
+  return true;
+}
+
+/**
+ * @brief Make sure that batch buffer has len free bytes, the buffer grows
+ *        till 4 * batch_bytes, after that the oldest points are dropped
+ * @param len required free space
+ * @return true if space is available
+ */
+static bool influx_writer_batch_reserve( size_t len )
+{
+  size_t buffer_max = 4u * influx_config.batch_bytes + INFLUX_WRITER_LINE_MAX;
+  size_t new_size = 0;
+  char *new_buffer = NULL;
+
+  if( (influx_batch.size - influx_batch.len) >= len )
+  {
+    return true;
+  }
+
+  new_size = influx_batch.size ? (influx_batch.size * 2) : influx_config.batch_bytes + INFLUX_WRITER_LINE_MAX;
+  if( new_size > buffer_max )
+  {
+    new_size = buffer_max;
+  }
+  if( new_size > influx_batch.size )
+  {
+    new_buffer = realloc( influx_batch.buffer, new_size );
+    if( new_buffer != NULL )
+    {
+      influx_batch.buffer = new_buffer;
+      influx_batch.size = new_size;
+    }
+  }
+
+  if( (influx_batch.size - influx_batch.len) < len )
+  {
+    // can't grow anymore, server is down for long time
+    influx_writer_batch_drop_oldest( len - (influx_batch.size - influx_batch.len) );
+  }
+  return ( (influx_batch.size - influx_batch.len) >= len );
+}
+
+/**
+ * @brief Drop the oldest points from batch buffer to free at least len bytes
+ * @param len number of bytes to be freed
+ */
+static void influx_writer_batch_drop_oldest( size_t len )
+{
+  size_t cut = 0;
+  uint32_t dropped = 0;
+
+  while( (cut < len) && (cut < influx_batch.len) )
+  {
+    char *eol = memchr( influx_batch.buffer + cut, '\n', influx_batch.len - cut );
+    if( eol == NULL )
+    {
+      cut = influx_batch.len;
+    }
+    else
+    {
+      cut = (size_t)(eol - influx_batch.buffer) + 1;
+    }
+    dropped++;
+  }
+
+  memmove( influx_batch.buffer, influx_batch.buffer + cut, influx_batch.len - cut );
+  influx_batch.len -= cut;
+  influx_batch.points = (dropped < influx_batch.points) ? (influx_batch.points - dropped) : 0;
+  influx_writer_count_dropped( dropped );
+  ESP_LOGW(TAG, "Batch buffer full, %" PRIu32 " oldest points dropped", dropped);
+}
+
+/**
+ * @brief Check if the batch should be written now
+ * @param now_ms current time in milliseconds
+ * @return true if batch should be flushed
+ */
+static bool influx_writer_flush_due( int64_t now_ms )
+{
+  if( (influx_batch.points == 0) || (now_ms < influx_batch.retry_ms) )
+  {
+    return false;
+  }
+  return ( (influx_batch.points >= influx_config.batch_points) || \
+           (influx_batch.len >= influx_config.batch_bytes) || \
+           ((now_ms - influx_batch.first_ms) >= influx_config.batch_age_ms) );
+}
+
+/**
+ * @brief Get the time till the spool can be drained or the pending batch is due
+ * @param now_ms current time in milliseconds
+ * @return ticks to wait for next event
+ */
+static TickType_t influx_writer_next_wait( int64_t now_ms )
+{
+  int64_t due_ms = 0;
+  TickType_t wait = portMAX_DELAY;
+  TickType_t batch_wait = portMAX_DELAY;
+
+  if( spool_count(&influx_spool) )
+  {
+    if( influx_link_up && spool_is_synced(&influx_spool) )
+    {
+      due_ms = (influx_drain_ms > influx_batch.retry_ms) ? influx_drain_ms : influx_batch.retry_ms;
+      wait = influx_writer_wait_till( due_ms, now_ms );
+    }
+    else
+    {
+      // link and time status are polled
+      wait = pdMS_TO_TICKS( INFLUX_WRITER_POLL_MS );
+    }
+  }
+
+  if( influx_batch.points )
+  {
+    if( (influx_batch.points >= influx_config.batch_points) || (influx_batch.len >= influx_config.batch_bytes) )
+    {
+      due_ms = influx_batch.retry_ms;
+    }
+    else
+    {
+      due_ms = influx_batch.first_ms + influx_config.batch_age_ms;
+      if( due_ms < influx_batch.retry_ms )
+      {
+        due_ms = influx_batch.retry_ms;
+      }
+    }
+    batch_wait = influx_writer_wait_till( due_ms, now_ms );
+  }
+  return (batch_wait < wait) ? batch_wait : wait;
+}
+
+/**
+ * @brief Convert the due time to ticks to wait
+ * @param due_ms due time in milliseconds
+ * @param now_ms current time in milliseconds
+ * @return ticks to wait
+ */
+static TickType_t influx_writer_wait_till( int64_t due_ms, int64_t now_ms )
+{
+  if( due_ms <= now_ms )
+  {
+    return 0;
+  }
+  return pdMS_TO_TICKS( due_ms - now_ms );
+}
+
+/**
+ * @brief Write the batch to InfluxDB and update the metrics
+ * @param  none
+ */
+static void influx_writer_write( void )
+{
+  influx_writer_flush_t result = INFLUX_WRITER_FLUSH_OK;
+  int64_t start_ms = influx_writer_now_ms();
+  uint32_t latency_ms = 0;
+  uint32_t delay_ms = 0;
+
+  result = influx_writer_post( influx_batch.buffer, influx_batch.len );
+  latency_ms = (uint32_t)(influx_writer_now_ms() - start_ms);
+
+  taskENTER_CRITICAL( &influx_metrics_lock );
+  influx_metrics.flushes++;
+  influx_metrics.last_flush_ms = latency_ms;
+  influx_metrics.total_flush_ms += latency_ms;
+  if( latency_ms > influx_metrics.max_flush_ms )
+  {
+    influx_metrics.max_flush_ms = latency_ms;
+  }
+  if( result == INFLUX_WRITER_FLUSH_OK )
+  {
+    influx_metrics.points_sent += influx_batch.points;
+    influx_metrics.bytes_sent += influx_batch.len;
+    influx_metrics.bytes_wire += influx_body_len;
+  }
+  else if( result == INFLUX_WRITER_FLUSH_REJECT )
+  {
+    influx_metrics.points_dropped += influx_batch.points;
+    influx_metrics.failures++;
+  }
+  else
+  {
+    influx_metrics.retries++;
+  }
+  taskEXIT_CRITICAL( &influx_metrics_lock );
+
+  if( result == INFLUX_WRITER_FLUSH_RETRY )
+  {
+    // exponential backoff with jitter, so that devices don't retry together
+    influx_batch.backoff_ms = influx_batch.backoff_ms ? (influx_batch.backoff_ms * 2) : INFLUX_WRITER_BACKOFF_MIN_MS;
+    if( influx_batch.backoff_ms > INFLUX_WRITER_BACKOFF_MAX_MS )
+    {
+      influx_batch.backoff_ms = INFLUX_WRITER_BACKOFF_MAX_MS;
+    }
+    delay_ms = influx_batch.backoff_ms / 2 + (esp_random() % (influx_batch.backoff_ms / 2 + 1));
+    if( influx_batch.retry_after_ms > delay_ms )
+    {
+      delay_ms = influx_batch.retry_after_ms;
+    }
+    influx_batch.retry_ms = influx_writer_now_ms() + delay_ms;
+    ESP_LOGW(TAG, "Write failed, %" PRIu32 " points pending, retry in %" PRIu32 " ms", influx_batch.points, delay_ms);
+    return;
+  }
+
+  ESP_LOGI(TAG, "Batch of %" PRIu32 " points (%u bytes, %u on wire) written in %" PRIu32 " ms", \
+           influx_batch.points, (unsigned)influx_batch.len, (unsigned)influx_body_len, latency_ms);
+  // rejected points are not retried either, the history is not read for them again
+  if( influx_config.history != NULL )
+  {
+    influx_writer_written_time_save( influx_batch.last_time );
+  }
+  influx_batch.last_time = 0;
+  influx_batch.len = 0;
+  influx_batch.points = 0;
+  influx_batch.backoff_ms = 0;
+  influx_batch.retry_ms = 0;
+}
+
+/**
+ * @brief Post the line protocol data to InfluxDB write API
+ * @param data line protocol data
+ * @param len data length
+ * @return flush result based on the HTTP status
+ */
+static influx_writer_flush_t influx_writer_post( const char *data, size_t len )
+{
+  esp_http_client_handle_t client = influx_writer_client_get();
+  int status = INFLUX_WRITER_HTTP_ERROR;
+
+  if( client == NULL )
+  {
+    return INFLUX_WRITER_FLUSH_RETRY;
+  }
+
+  influx_batch.retry_after_ms = 0;
+  if( influx_gzip_enabled )
+  {
+    status = influx_writer_post_gzip( client, data, len );
+    if( (status == 415) || (status == 400) )
+    {
+      // server (or a proxy) doesn't understand gzip, or the data is wrong,
+      // plain text tells which one
+      status = influx_writer_post_plain( client, data, len );
+      if( (status >= 200) && (status < 300) )
+      {
+        ESP_LOGW(TAG, "Server doesn't accept gzip, sending uncompressed from now");
+        influx_gzip_enabled = false;
+      }
+    }
+  }
+  else
+  {
+    status = influx_writer_post_plain( client, data, len );
+  }
+  http_pool_release( client );
+
+  if( status == INFLUX_WRITER_HTTP_ERROR )
+  {
+    return INFLUX_WRITER_FLUSH_RETRY;
+  }
+  if( (status >= 200) && (status < 300) )
+  {
+    return INFLUX_WRITER_FLUSH_OK;
+  }
+  ESP_LOGE(TAG, "HTTP POST Status = %d", status);
+  if( (status == 429) || (status >= 500) )
+  {
+    return INFLUX_WRITER_FLUSH_RETRY;
+  }
+  // 400 (bad line protocol), 401 (token), 413 (too large) won't be fixed by a retry
+  return INFLUX_WRITER_FLUSH_REJECT;
+}
+
+/**
+ * @brief Post uncompressed line protocol data
+ * @param client http client
+ * @param data line protocol data
+ * @param len data length
+ * @return HTTP status code or INFLUX_WRITER_HTTP_ERROR
+ */
+static int influx_writer_post_plain( esp_http_client_handle_t client, const char *data, size_t len )
+{
+  esp_err_t err = ESP_OK;
+
+  influx_body_len = len;
+  esp_http_client_set_post_field( client, data, len );
+  err = esp_http_client_perform( client );
+  if( err != ESP_OK )
+  {
+    ESP_LOGE(TAG, "HTTP POST request failed: %s", esp_err_to_name(err));
+    // connection is in unknown state, next perform will reconnect
+    esp_http_client_close( client );
+    return INFLUX_WRITER_HTTP_ERROR;
+  }
+  return esp_http_client_get_status_code( client );
+}
+
+/**
+ * @brief Post line protocol data with gzip compression, the data is sent with
+ *        chunked transfer encoding as it is compressed, so the compressed body
+ *        is never stored completely
+ * @param client http client
+ * @param data line protocol data
+ * @param len data length
+ * @return HTTP status code or INFLUX_WRITER_HTTP_ERROR
+ */
+static int influx_writer_post_gzip( esp_http_client_handle_t client, const char *data, size_t len )
+{
+  esp_err_t err = ESP_OK;
+  int status = INFLUX_WRITER_HTTP_ERROR;
+
+  influx_body_len = 0;
+  // Content-Length from the last plain request must not be sent with chunked
+  esp_http_client_delete_header( client, "Content-Length" );
+  esp_http_client_set_header( client, "Content-Encoding", "gzip" );
+  err = esp_http_client_open( client, -1 );
+  if( err == ESP_OK )
+  {
+    err = gzip_stream_begin( &influx_gzip, influx_writer_gzip_chunk, client );
+  }
+  if( err == ESP_OK )
+  {
+    err = gzip_stream_write( &influx_gzip, data, len );
+  }
+  if( err == ESP_OK )
+  {
+    err = gzip_stream_finish( &influx_gzip );
+  }
+  if( (err == ESP_OK) && (esp_http_client_write( client, "0\r\n\r\n", 5 ) != 5) )
+  {
+    err = ESP_FAIL;
+  }
+  if( (err == ESP_OK) && (esp_http_client_fetch_headers( client ) >= 0) )
+  {
+    status = esp_http_client_get_status_code( client );
+    // read the response body, so that connection can be used again
+    esp_http_client_flush_response( client, NULL );
+  }
+  else
+  {
+    ESP_LOGE(TAG, "HTTP gzip POST request failed: %s", esp_err_to_name(err));
+    esp_http_client_close( client );
+  }
+
+  esp_http_client_delete_header( client, "Content-Encoding" );
+  esp_http_client_delete_header( client, "Transfer-Encoding" );
+  return status;
+}
+
+/**
+ * @brief gzip stream output callback, writes the compressed data as one chunk
+ * @param ctx http client
+ * @param data compressed data
+ * @param len data length
+ * @return ESP_OK if successful else ESP_FAIL
+ */
+static esp_err_t influx_writer_gzip_chunk( void *ctx, const uint8_t *data, size_t len )
+{
+  esp_http_client_handle_t client = (esp_http_client_handle_t)ctx;
+  char header[INFLUX_WRITER_CHUNK_HEADER_MAX];
+  int header_len = snprintf( header, sizeof(header), "%x\r\n", (unsigned)len );
+
+  if( (esp_http_client_write( client, header, header_len ) != header_len) || \
+      (esp_http_client_write( client, (const char *)data, len ) != (int)len) || \
+      (esp_http_client_write( client, "\r\n", 2 ) != 2) )
+  {
+    return ESP_FAIL;
+  }
+  influx_body_len += len;
+  return ESP_OK;
+}
+
+/**
+ * @brief HTTP Client Event Handler, used to get the Retry-After header
+ * @param evt event data
+ * @return ESP_OK
+ */
+static esp_err_t influx_writer_http_event_handler( esp_http_client_event_t *evt )
+{
+  if( (evt->event_id == HTTP_EVENT_ON_HEADER) && (strcasecmp(evt->header_key, "Retry-After") == 0) )
+  {
+    influx_batch.retry_after_ms = (uint32_t)atoi( evt->header_value ) * 1000u;
+    if( influx_batch.retry_after_ms > INFLUX_WRITER_BACKOFF_MAX_MS )
+    {
+      influx_batch.retry_after_ms = INFLUX_WRITER_BACKOFF_MAX_MS;
+    }
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Get the keep-alive HTTP client from the pool, it must be given back
+ *        with http_pool_release after the write
+ * @param  none
+ * @return client handle or NULL
+ */
+static esp_http_client_handle_t influx_writer_client_get( void )
+{
+  esp_http_client_handle_t client = NULL;
+  esp_http_client_config_t config =
+  {
+    .url = influx_full_url,
+    .method = HTTP_METHOD_POST,
+    .timeout_ms = INFLUX_WRITER_HTTP_TIMEOUT_MS,
+    .keep_alive_enable = true,
+    .event_handler = influx_writer_http_event_handler,
+    // for https URL the certificate bundle is attached by the pool
+  };
+
+  client = http_pool_acquire( &config );
+  if( client == NULL )
+  {
+    ESP_LOGE(TAG, "Unable to get HTTP client");
+    return NULL;
+  }
+  // set header, a reused client has them already, setting again is harmless
+  esp_http_client_set_header( client, "Authorization", influx_auth );
+  esp_http_client_set_header( client, "Content-Type", "text/plain; charset=utf-8" );
+  return client;
+}
+
+/**
+ * @brief Add the dropped points to the metrics
+ * @param points number of points dropped
+ */
+static void influx_writer_count_dropped( uint32_t points )
+{
+  taskENTER_CRITICAL( &influx_metrics_lock );
+  influx_metrics.points_dropped += points;
+  taskEXIT_CRITICAL( &influx_metrics_lock );
+}
+
+/**
+ * @brief Load the time of the newest written local point from NVS, the
+ *        history after it is written after a reset
+ * @param  none
+ */
+static void influx_writer_written_time_load( void )
+{
+  nvs_handle_t handle;
+
+  if( nvs_open( INFLUX_WRITER_NVS_NAMESPACE, NVS_READONLY, &handle ) == ESP_OK )
+  {
+    nvs_get_u32( handle, INFLUX_WRITER_NVS_LAST_TIME, &influx_written_time );
+    nvs_close( handle );
+  }
+  influx_queued_time = influx_written_time;
+  ESP_LOGI(TAG, "Newest written sample at %" PRIu32, influx_written_time);
+}
+
+/**
+ * @brief Save the time of the newest written local point in NVS, called once
+ *        per batch
+ * @param time_s UTC seconds, older times are ignored
+ */
+static void influx_writer_written_time_save( uint32_t time_s )
+{
+  nvs_handle_t handle;
+
+  if( time_s <= influx_written_time )
+  {
+    return;
+  }
+  influx_written_time = time_s;
+  if( nvs_open( INFLUX_WRITER_NVS_NAMESPACE, NVS_READWRITE, &handle ) == ESP_OK )
+  {
+    if( (nvs_set_u32( handle, INFLUX_WRITER_NVS_LAST_TIME, time_s ) != ESP_OK) || \
+        (nvs_commit( handle ) != ESP_OK) )
+    {
+      ESP_LOGW(TAG, "Unable to save the newest written sample time");
+    }
+    nvs_close( handle );
+  }
+}
+
+/**
+ * @brief Get the time since boot in milliseconds
+ * @param  none
+ * @return time in milliseconds
+ */
+static int64_t influx_writer_now_ms( void )
+{
+  return esp_timer_get_time() / 1000;
+}
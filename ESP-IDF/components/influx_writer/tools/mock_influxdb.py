@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""
+mock_influxdb.py
+
+ Created on: Oct 19, 2026
+     Author: xpress_embedo
+
+Local InfluxDB v2 write API for tests and benchmarks of the influx_writer
+component, the device (or the host build in host_test) is pointed to it with
+the InfluxDB URL. It accepts /api/v2/write on keep-alive connections, with
+Content-Length or chunked bodies and Content-Encoding: gzip, checks every
+line protocol line and counts the points, duplicate points (same series and
+time stamp, InfluxDB would overwrite them) and bad lines. Faults are injected
+for the first write requests: 429 and 503 with Retry-After, 400, or 415 for
+every gzip request (a server without gzip support).
+
+  python mock_influxdb.py --port 8086
+  python mock_influxdb.py --faults 429,503 --retry-after 1
+  python mock_influxdb.py --no-gzip --token secret
+  python mock_influxdb.py --port 0 --quiet      # any free port, printed at start
+
+GET /stats gives the counters as "name value" lines (connections are the
+ones with write requests), GET /quit stops the server.
+"""
+import argparse
+import gzip
+import http.server
+import re
+import socketserver
+import sys
+import threading
+import time
+import zlib
+
+# measurement,tag=value field=value[,field=value] timestamp
+LINE = re.compile(r'^([^, ]+(?:,[^=, ]+=[^, ]+)*) ([^= ]+=[^, ]+(?:,[^= ]+=[^, ]+)*) (-?\d+)$')
+
+
+class Stats:
+    """ Counters of the server, shared by the connection threads """
+    COUNTERS = ('requests', 'writes', 'points', 'duplicates', 'bad_lines', 'gzip', 'plain',
+                'faults', 'rejected_gzip', 'unauthorized', 'body_bytes', 'line_bytes', 'connections')
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.values = dict.fromkeys(self.COUNTERS, 0)
+        self.series = {}            # series key -> set of time stamps
+        self.last = ''
+
+    def add(self, name, value=1):
+        with self.lock:
+            self.values[name] += value
+
+    def text(self):
+        with self.lock:
+            lines = ['{} {}'.format(name, self.values[name]) for name in self.COUNTERS]
+            lines.append('series {}'.format(len(self.series)))
+            lines.append('last {}'.format(self.last))
+        return '\n'.join(lines) + '\n'
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'      # keep-alive, the writer reuses the connection
+
+    def setup(self):
+        super().setup()
+        self.writer = False             # connection of a writer, not of /stats
+
+    def reply(self, status, body=b'', headers=None):
+        self.send_response(status)
+        for key, value in (headers or {}).items():
+            self.send_header(key, value)
+        self.send_header('Content-Length', str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def read_body(self):
+        if 'chunked' in self.headers.get('Transfer-Encoding', '').lower():
+            body = bytearray()
+            while True:
+                size = int(self.rfile.readline().split(b';')[0].strip(), 16)
+                if size == 0:
+                    # trailer, empty line ends it
+                    while self.rfile.readline() not in (b'\r\n', b'\n', b''):
+                        pass
+                    return bytes(body)
+                body += self.rfile.read(size)
+                self.rfile.readline()
+        return self.rfile.read(int(self.headers.get('Content-Length', 0)))
+
+    def do_GET(self):
+        stats = self.server.stats
+        if self.path == '/stats':
+            self.reply(200, stats.text().encode(), {'Content-Type': 'text/plain'})
+        elif self.path == '/quit':
+            threading.Thread(target=self.server.shutdown, daemon=True).start()
+            self.reply(200)
+        else:
+            self.reply(404)
+
+    def do_POST(self):
+        args, stats = self.server.args, self.server.stats
+        stats.add('requests')
+        if not self.writer:
+            self.writer = True
+            stats.add('connections')
+        body = self.read_body()
+        stats.add('body_bytes', len(body))
+        if not self.path.startswith('/api/v2/write'):
+            self.reply(404)
+            return
+        if args.token and self.headers.get('Authorization') != 'Token ' + args.token:
+            stats.add('unauthorized')
+            self.reply(401, b'{"code":"unauthorized","message":"unauthorized access"}')
+            return
+        gzipped = self.headers.get('Content-Encoding', '').lower() == 'gzip'
+        if gzipped and args.no_gzip:
+            stats.add('rejected_gzip')
+            self.reply(415, b'{"code":"unsupported media type"}')
+            return
+        with self.server.fault_lock:
+            fault = self.server.faults.pop(0) if self.server.faults else None
+        if fault:
+            stats.add('faults')
+            headers = {'Retry-After': str(args.retry_after)} if fault in (429, 503) else {}
+            self.reply(fault, b'{"code":"injected fault"}', headers)
+            return
+        if args.delay_ms:
+            time.sleep(args.delay_ms / 1000.0)
+        try:
+            text = (gzip.decompress(body) if gzipped else body).decode('utf-8')
+        except (OSError, EOFError, zlib.error, UnicodeDecodeError):
+            stats.add('bad_lines')
+            self.reply(400, b'{"code":"invalid","message":"unable to decode body"}')
+            return
+
+        points, duplicates, bad, last = 0, 0, 0, ''
+        with stats.lock:
+            for line in text.splitlines():
+                if not line or line.startswith('#'):
+                    continue
+                match = LINE.match(line)
+                if match is None:
+                    bad += 1
+                    continue
+                times = stats.series.setdefault(match.group(1), set())
+                if match.group(3) in times:
+                    duplicates += 1
+                times.add(match.group(3))
+                points += 1
+                last = line
+            if last:
+                stats.last = last
+        stats.add('writes')
+        stats.add('gzip' if gzipped else 'plain')
+        stats.add('points', points)
+        stats.add('duplicates', duplicates)
+        stats.add('line_bytes', len(text))
+        if bad:
+            # InfluxDB writes the good lines and reports the bad ones with 400
+            stats.add('bad_lines', bad)
+            self.reply(400, '{{"code":"invalid","message":"{} bad lines"}}'.format(bad).encode())
+            return
+        self.reply(204)
+
+    def log_message(self, fmt, *args):
+        if not self.server.args.quiet:
+            print('{} {} {}'.format(self.address_string(), fmt % args,
+                                    self.headers.get('Content-Encoding', '')), flush=True)
+
+
+class Server(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='mock InfluxDB v2 write API')
+    parser.add_argument('--bind', default='127.0.0.1', help='address to listen on')
+    parser.add_argument('--port', type=int, default=8086, help='TCP port, 0 for any free port')
+    parser.add_argument('--token', default='', help='required API token, any token if empty')
+    parser.add_argument('--faults', default='', help='status codes of the first writes, e.g. 429,503')
+    parser.add_argument('--retry-after', type=int, default=1, help='Retry-After seconds for 429 and 503')
+    parser.add_argument('--no-gzip', action='store_true', help='reply 415 to gzip bodies')
+    parser.add_argument('--delay-ms', type=float, default=0, help='processing time of every write')
+    parser.add_argument('--quiet', action='store_true', help="don't print the requests")
+    args = parser.parse_args()
+
+    server = Server((args.bind, args.port), Handler)
+    server.args = args
+    server.stats = Stats()
+    server.faults = [int(code) for code in args.faults.split(',') if code]
+    server.fault_lock = threading.Lock()
+    print('listening on {}:{}'.format(*server.server_address), flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    if not args.quiet:
+        sys.stdout.write(server.stats.text())
+
+
+if __name__ == '__main__':
+    main()
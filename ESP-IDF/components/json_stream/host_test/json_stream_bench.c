@@ -0,0 +1,285 @@
+/*
+ * json_stream_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host benchmark of json_stream against the cJSON parsing it replaced in
+ * OpenWeatherMap. Two documents are built in memory: a group response with
+ * 6 cities (the batch of OpenWeatherMap) and a forecast sized response with
+ * 40 entries (about 16 KB). json_stream is fed in 512 byte chunks like the
+ * HTTP_EVENT_ON_DATA events, cJSON needs the whole response in one buffer
+ * and builds the tree, then the same values are looked up and the tree is
+ * deleted. Reported are the time per parse and the memory: the fixed state
+ * for json_stream, the response buffer plus the peak heap for cJSON.
+ * The cJSON part is built only if BENCH_CJSON is defined, the Makefile does
+ * it when cJSON.c is found in CJSON_DIR (by default the copy in IDF_PATH).
+ *
+ *  make -C components/json_stream/host_test bench
+ *  make -C components/json_stream/host_test bench CJSON_DIR=<path of cJSON.c>
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "json_stream.h"
+#ifdef BENCH_CJSON
+#include "cJSON.h"
+#endif
+
+// Private Macros
+#define BENCH_DOC_MAX                       (32768u)
+#define BENCH_CHUNK                         (512u)
+#define BENCH_ROUNDS                        (20000u)
+#define BENCH_GROUP_CITIES                  (6u)
+#define BENCH_FORECAST_ENTRIES              (40u)
+
+#define BENCH_CITY_FIELD_LIST(n)                                                                      \
+  JSON_STREAM_FIELD( "list." #n ".id",            JSON_STREAM_INT, bench_resp_t, city[n].id ),          \
+  JSON_STREAM_FIELD( "list." #n ".dt",            JSON_STREAM_INT, bench_resp_t, city[n].dt ),          \
+  JSON_STREAM_FIELD( "list." #n ".main.temp",     JSON_STREAM_INT, bench_resp_t, city[n].temperature ), \
+  JSON_STREAM_FIELD( "list." #n ".main.pressure", JSON_STREAM_INT, bench_resp_t, city[n].pressure ),    \
+  JSON_STREAM_FIELD( "list." #n ".main.humidity", JSON_STREAM_INT, bench_resp_t, city[n].humidity )
+
+typedef struct _bench_city_t
+{
+  int id;
+  int dt;
+  int temperature;
+  int pressure;
+  int humidity;
+} bench_city_t;
+
+typedef struct _bench_resp_t
+{
+  bench_city_t city[BENCH_GROUP_CITIES];
+} bench_resp_t;
+
+// Private Variables
+static const json_stream_field_t bench_fields[] =
+{
+  BENCH_CITY_FIELD_LIST(0),
+  BENCH_CITY_FIELD_LIST(1),
+  BENCH_CITY_FIELD_LIST(2),
+  BENCH_CITY_FIELD_LIST(3),
+  BENCH_CITY_FIELD_LIST(4),
+  BENCH_CITY_FIELD_LIST(5),
+};
+
+static const char bench_entry[] =
+  "{\"coord\":{\"lon\":77.2167,\"lat\":28.6667},\"sys\":{\"country\":\"IN\",\"timezone\":19800,"
+  "\"sunrise\":1789955530,\"sunset\":1790000962},\"weather\":[{\"id\":721,\"main\":\"Haze\","
+  "\"description\":\"haze\",\"icon\":\"50d\"}],\"main\":{\"temp\":%d.05,\"feels_like\":33.12,"
+  "\"temp_min\":31.05,\"temp_max\":31.05,\"pressure\":1004,\"humidity\":55},\"visibility\":3000,"
+  "\"wind\":{\"speed\":2.57,\"deg\":90},\"clouds\":{\"all\":0},\"dt\":%u,\"id\":%u,\"name\":\"City %u\"}";
+
+static char bench_doc[BENCH_DOC_MAX];
+static volatile int bench_sink = 0;
+
+#ifdef BENCH_CJSON
+static size_t bench_heap_used = 0;
+static size_t bench_heap_peak = 0;
+static size_t bench_heap_allocs = 0;
+#endif
+
+// Private Function Declaration
+static size_t bench_build( uint32_t entries );
+static double bench_now( void );
+static void bench_json_stream( const char *name, size_t len );
+static bool bench_json_stream_parse( const char *data, size_t len, bench_resp_t *resp );
+#ifdef BENCH_CJSON
+static void bench_cjson( const char *name, size_t len );
+static bool bench_cjson_parse( const char *data, size_t len, bench_resp_t *resp );
+static void * bench_malloc( size_t size );
+static void bench_free( void *ptr );
+#endif
+
+int main( void )
+{
+  size_t len = 0;
+
+  len = bench_build( BENCH_GROUP_CITIES );
+  bench_json_stream( "group, 6 cities", len );
+#ifdef BENCH_CJSON
+  bench_cjson( "group, 6 cities", len );
+#endif
+
+  len = bench_build( BENCH_FORECAST_ENTRIES );
+  bench_json_stream( "forecast, 40 entries", len );
+#ifdef BENCH_CJSON
+  bench_cjson( "forecast, 40 entries", len );
+#else
+  printf( "cJSON: not built, run with CJSON_DIR=<path of cJSON.c> or IDF_PATH set\n" );
+#endif
+  return EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Build a group response with the given number of list entries
+ * @param entries number of entries
+ * @return document length
+ */
+static size_t bench_build( uint32_t entries )
+{
+  size_t len = 0;
+
+  len += (size_t)snprintf( &bench_doc[len], BENCH_DOC_MAX - len, "{\"cnt\":%u,\"list\":[", (unsigned)entries );
+  for( uint32_t idx = 0; idx < entries; idx++ )
+  {
+    if( idx )
+    {
+      bench_doc[len++] = ',';
+    }
+    len += (size_t)snprintf( &bench_doc[len], BENCH_DOC_MAX - len, bench_entry, (int)(20 + idx % 15), \
+                             1790000000u + idx * 60u, 1273294u + idx, (unsigned)idx );
+  }
+  len += (size_t)snprintf( &bench_doc[len], BENCH_DOC_MAX - len, "]}" );
+  return len;
+}
+
+/**
+ * @brief Monotonic time in seconds
+ */
+static double bench_now( void )
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench_json_stream( const char *name, size_t len )
+{
+  bench_resp_t resp;
+  double start = 0.0;
+  double elapsed = 0.0;
+
+  if( !bench_json_stream_parse( bench_doc, len, &resp ) || (resp.city[1].id != 1273295) || (resp.city[5].temperature != 25) )
+  {
+    printf( "json_stream %s: wrong result\n", name );
+    exit( EXIT_FAILURE );
+  }
+  start = bench_now();
+  for( uint32_t round = 0; round < BENCH_ROUNDS; round++ )
+  {
+    bench_json_stream_parse( bench_doc, len, &resp );
+    bench_sink += resp.city[0].temperature;
+  }
+  elapsed = bench_now() - start;
+  printf( "json_stream %-22s %6u bytes: %8.2f us/parse, %6.1f MB/s, state %u bytes, heap 0 bytes\n", \
+          name, (unsigned)len, elapsed * 1e6 / BENCH_ROUNDS, (double)len * BENCH_ROUNDS / elapsed / 1e6, \
+          (unsigned)sizeof(json_stream_t) );
+}
+
+/**
+ * @brief Parse in chunks of BENCH_CHUNK bytes, like the HTTP events
+ */
+static bool bench_json_stream_parse( const char *data, size_t len, bench_resp_t *resp )
+{
+  json_stream_t js;
+  size_t part = 0;
+
+  json_stream_init( &js, bench_fields, sizeof(bench_fields)/sizeof(bench_fields[0]), resp );
+  for( size_t pos = 0; pos < len; pos += part )
+  {
+    part = ((len - pos) < BENCH_CHUNK) ? (len - pos) : BENCH_CHUNK;
+    json_stream_feed( &js, &data[pos], part );
+  }
+  return (json_stream_finish( &js ) == ESP_OK) && json_stream_found_all( &js );
+}
+
+#ifdef BENCH_CJSON
+static void bench_cjson( const char *name, size_t len )
+{
+  cJSON_Hooks hooks = { .malloc_fn = bench_malloc, .free_fn = bench_free };
+  bench_resp_t resp;
+  double start = 0.0;
+  double elapsed = 0.0;
+
+  cJSON_InitHooks( &hooks );
+  bench_heap_used = 0;
+  bench_heap_peak = 0;
+  bench_heap_allocs = 0;
+  if( !bench_cjson_parse( bench_doc, len, &resp ) || (resp.city[1].id != 1273295) || (resp.city[5].temperature != 25) )
+  {
+    printf( "cJSON %s: wrong result\n", name );
+    exit( EXIT_FAILURE );
+  }
+  printf( "cJSON       %-22s %6u bytes: ", name, (unsigned)len );
+  start = bench_now();
+  for( uint32_t round = 0; round < BENCH_ROUNDS; round++ )
+  {
+    bench_cjson_parse( bench_doc, len, &resp );
+    bench_sink += resp.city[0].temperature;
+  }
+  elapsed = bench_now() - start;
+  // the whole response is buffered before cJSON_Parse, like the old response_data
+  printf( "%8.2f us/parse, %6.1f MB/s, buffer %u bytes, heap peak %u bytes in %u allocations\n", \
+          elapsed * 1e6 / BENCH_ROUNDS, (double)len * BENCH_ROUNDS / elapsed / 1e6, (unsigned)(len + 1), \
+          (unsigned)bench_heap_peak, (unsigned)(bench_heap_allocs / (BENCH_ROUNDS + 1u)) );
+}
+
+/**
+ * @brief Parse the whole document and look up the same values as json_stream
+ */
+static bool bench_cjson_parse( const char *data, size_t len, bench_resp_t *resp )
+{
+  cJSON *root = cJSON_ParseWithLength( data, len );
+  cJSON *list = cJSON_GetObjectItemCaseSensitive( root, "list" );
+  cJSON *item = NULL;
+  cJSON *main_obj = NULL;
+  bool status = (list != NULL);
+
+  for( uint32_t idx = 0; status && (idx < BENCH_GROUP_CITIES); idx++ )
+  {
+    item = cJSON_GetArrayItem( list, (int)idx );
+    main_obj = cJSON_GetObjectItemCaseSensitive( item, "main" );
+    status = (main_obj != NULL);
+    if( status )
+    {
+      resp->city[idx].id = cJSON_GetObjectItemCaseSensitive( item, "id" )->valueint;
+      resp->city[idx].dt = cJSON_GetObjectItemCaseSensitive( item, "dt" )->valueint;
+      resp->city[idx].temperature = cJSON_GetObjectItemCaseSensitive( main_obj, "temp" )->valueint;
+      resp->city[idx].pressure = cJSON_GetObjectItemCaseSensitive( main_obj, "pressure" )->valueint;
+      resp->city[idx].humidity = cJSON_GetObjectItemCaseSensitive( main_obj, "humidity" )->valueint;
+    }
+  }
+  cJSON_Delete( root );
+  return status;
+}
+
+/**
+ * @brief malloc which counts the heap in use, the size is stored in front
+ */
+static void * bench_malloc( size_t size )
+{
+  size_t *block = malloc( size + sizeof(max_align_t) );
+
+  if( block == NULL )
+  {
+    return NULL;
+  }
+  *block = size;
+  bench_heap_used += size;
+  bench_heap_allocs++;
+  if( bench_heap_used > bench_heap_peak )
+  {
+    bench_heap_peak = bench_heap_used;
+  }
+  return (uint8_t *)block + sizeof(max_align_t);
+}
+
+static void bench_free( void *ptr )
+{
+  size_t *block = NULL;
+
+  if( ptr != NULL )
+  {
+    block = (size_t *)((uint8_t *)ptr - sizeof(max_align_t));
+    bench_heap_used -= *block;
+    free( block );
+  }
+}
+#endif
@@ -0,0 +1,287 @@
+/*
+ * json_stream_fuzz.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Fuzz target of json_stream. Every input is parsed whole and split in
+ * chunks (size taken from the input), both results must be the same, any
+ * memory error is found by the sanitizers. Built with clang and
+ * -DJSON_STREAM_LIBFUZZER it is a libFuzzer target, else a small mutation
+ * driver is included which runs with gcc: the corpus files are the seeds and
+ * every iteration applies a few random byte flips, inserts, deletes, copies
+ * and truncations.
+ *
+ *  make -C components/json_stream/host_test fuzz FUZZ_RUNS=1000000
+ *  make -C components/json_stream/host_test fuzz-libfuzzer
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <dirent.h>
+
+#include "json_stream.h"
+
+// Private Macros
+#define FUZZ_INPUT_MAX                      (4096u)
+#define FUZZ_SEEDS_MAX                      (64u)
+
+typedef struct _fuzz_out_t
+{
+  int   temperature;
+  float temp_float;
+  bool  flag;
+  char  name[8];
+  char  number[6];
+} fuzz_out_t;
+
+typedef struct _fuzz_result_t
+{
+  esp_err_t   feed;
+  esp_err_t   finish;
+  uint32_t    found;
+  uint32_t    offset;
+  fuzz_out_t  out;
+} fuzz_result_t;
+
+// Private Variables
+static const json_stream_field_t fuzz_fields[] =
+{
+  JSON_STREAM_FIELD( "main.temp",       JSON_STREAM_INT,   fuzz_out_t, temperature ),
+  JSON_STREAM_FIELD( "main.temp",       JSON_STREAM_FLOAT, fuzz_out_t, temp_float ),
+  JSON_STREAM_FIELD( "a.0",             JSON_STREAM_BOOL,  fuzz_out_t, flag ),
+  JSON_STREAM_FIELD( "name",            JSON_STREAM_STR,   fuzz_out_t, name ),
+  JSON_STREAM_FIELD( "list.1.main.temp",JSON_STREAM_STR,   fuzz_out_t, number ),
+};
+
+// Private Function Declaration
+static void fuzz_parse( const uint8_t *data, size_t len, size_t chunk, fuzz_result_t *result );
+int LLVMFuzzerTestOneInput( const uint8_t *data, size_t size );
+
+/**
+ * @brief Fuzz target, parse whole and in chunks
+ * @param data input
+ * @param size input length
+ * @return always 0, a mismatch aborts
+ */
+int LLVMFuzzerTestOneInput( const uint8_t *data, size_t size )
+{
+  fuzz_result_t whole;
+  fuzz_result_t split;
+  size_t chunk = size ? ((data[size - 1] % 17u) + 1u) : 1u;
+
+  fuzz_parse( data, size, size ? size : 1, &whole );
+  fuzz_parse( data, size, chunk, &split );
+  if( memcmp( &whole, &split, sizeof(whole) ) != 0 )
+  {
+    fprintf( stderr, "result differs with %u byte chunks, input: %.*s\n", (unsigned)chunk, (int)size, data );
+    abort();
+  }
+  return 0;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Parse the input fed in chunks
+ * @param data input
+ * @param len input length
+ * @param chunk chunk size
+ * @param result output, zeroed first so that it can be compared with memcmp
+ */
+static void fuzz_parse( const uint8_t *data, size_t len, size_t chunk, fuzz_result_t *result )
+{
+  json_stream_t js;
+  size_t pos = 0;
+  size_t part = 0;
+
+  memset( result, 0x00, sizeof(fuzz_result_t) );
+  json_stream_init( &js, fuzz_fields, sizeof(fuzz_fields)/sizeof(fuzz_fields[0]), &result->out );
+  for( pos = 0; pos < len; pos += part )
+  {
+    part = ((len - pos) < chunk) ? (len - pos) : chunk;
+    result->feed = json_stream_feed( &js, (const char *)&data[pos], part );
+  }
+  result->finish = json_stream_finish( &js );
+  result->found = js.found;
+  result->offset = js.offset;
+}
+
+#ifndef JSON_STREAM_LIBFUZZER
+typedef struct _fuzz_seed_t
+{
+  uint8_t data[FUZZ_INPUT_MAX];
+  size_t  len;
+} fuzz_seed_t;
+
+static fuzz_seed_t fuzz_seeds[FUZZ_SEEDS_MAX];
+static size_t fuzz_seed_count = 0;
+static uint64_t fuzz_rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t fuzz_random( uint32_t max );
+static void fuzz_load_dir( const char *dir );
+static size_t fuzz_mutate( uint8_t *data, size_t len );
+
+int main( int argc, char **argv )
+{
+  static uint8_t input[FUZZ_INPUT_MAX];
+  unsigned long runs = 100000ul;
+  size_t len = 0;
+
+  if( argc < 2 )
+  {
+    printf( "usage: %s <corpus dir>... [-runs=N] [-seed=N]\n", argv[0] );
+    return EXIT_FAILURE;
+  }
+  for( int arg = 1; arg < argc; arg++ )
+  {
+    if( strncmp( argv[arg], "-runs=", 6 ) == 0 )
+    {
+      runs = strtoul( &argv[arg][6], NULL, 0 );
+    }
+    else if( strncmp( argv[arg], "-seed=", 6 ) == 0 )
+    {
+      fuzz_rng = strtoull( &argv[arg][6], NULL, 0 ) | 1u;
+    }
+    else
+    {
+      fuzz_load_dir( argv[arg] );
+    }
+  }
+  if( fuzz_seed_count == 0 )
+  {
+    printf( "no seeds found\n" );
+    return EXIT_FAILURE;
+  }
+
+  for( unsigned long run = 0; run < runs; run++ )
+  {
+    const fuzz_seed_t *seed = &fuzz_seeds[fuzz_random( (uint32_t)fuzz_seed_count )];
+    memcpy( input, seed->data, seed->len );
+    len = seed->len;
+    for( uint32_t count = fuzz_random( 8u ) + 1u; count; count-- )
+    {
+      len = fuzz_mutate( input, len );
+    }
+    LLVMFuzzerTestOneInput( input, len );
+  }
+  printf( "json_stream_fuzz: %lu runs on %u seeds OK\n", runs, (unsigned)fuzz_seed_count );
+  return EXIT_SUCCESS;
+}
+
+/**
+ * @brief xorshift64 random number
+ * @param max upper limit (exclusive), must not be 0
+ * @return random number below max
+ */
+static uint32_t fuzz_random( uint32_t max )
+{
+  fuzz_rng ^= fuzz_rng << 13;
+  fuzz_rng ^= fuzz_rng >> 7;
+  fuzz_rng ^= fuzz_rng << 17;
+  return (uint32_t)(fuzz_rng % max);
+}
+
+/**
+ * @brief Load all the files of the directory as seeds
+ * @param dir corpus directory
+ */
+static void fuzz_load_dir( const char *dir )
+{
+  char path[512];
+  struct dirent *entry;
+  DIR *handle = opendir( dir );
+  FILE *file = NULL;
+
+  if( handle == NULL )
+  {
+    printf( "%s: not found\n", dir );
+    return;
+  }
+  while( ((entry = readdir( handle )) != NULL) && (fuzz_seed_count < FUZZ_SEEDS_MAX) )
+  {
+    if( entry->d_name[0] == '.' )
+    {
+      continue;
+    }
+    snprintf( path, sizeof(path), "%s/%s", dir, entry->d_name );
+    file = fopen( path, "rb" );
+    if( file != NULL )
+    {
+      fuzz_seeds[fuzz_seed_count].len = fread( fuzz_seeds[fuzz_seed_count].data, 1, FUZZ_INPUT_MAX, file );
+      fuzz_seed_count++;
+      fclose( file );
+    }
+  }
+  closedir( handle );
+}
+
+/**
+ * @brief Apply one random mutation, JSON syntax characters are preferred so
+ *        that the inputs stay close to valid documents
+ * @param data input, FUZZ_INPUT_MAX bytes
+ * @param len input length
+ * @return new input length
+ */
+static size_t fuzz_mutate( uint8_t *data, size_t len )
+{
+  static const char dict[] = "{}[]:,\"\\.-+eE0123456789tfnu \t\n";
+  size_t pos = len ? fuzz_random( (uint32_t)len ) : 0;
+  size_t span = 0;
+
+  // truncation is the least likely, else most inputs end after a few bytes
+  switch( fuzz_random( 10u ) )
+  {
+    case 0:
+    case 1:
+    case 2:
+      // replace with a syntax character
+      if( len )
+      {
+        data[pos] = (uint8_t)dict[fuzz_random( sizeof(dict) - 1u )];
+      }
+      break;
+    case 3:
+      // flip a bit
+      if( len )
+      {
+        data[pos] ^= (uint8_t)(1u << fuzz_random( 8u ));
+      }
+      break;
+    case 4:
+    case 5:
+      // insert a syntax character
+      if( len < FUZZ_INPUT_MAX )
+      {
+        memmove( &data[pos + 1], &data[pos], len - pos );
+        data[pos] = (uint8_t)dict[fuzz_random( sizeof(dict) - 1u )];
+        len++;
+      }
+      break;
+    case 6:
+      // delete a range
+      span = fuzz_random( 16u ) + 1u;
+      span = ((pos + span) > len) ? (len - pos) : span;
+      memmove( &data[pos], &data[pos + span], len - pos - span );
+      len -= span;
+      break;
+    case 7:
+    case 8:
+      // duplicate a range, makes deep nesting and long strings
+      span = fuzz_random( 32u ) + 1u;
+      span = ((pos + span) > len) ? (len - pos) : span;
+      if( (len + span) <= FUZZ_INPUT_MAX )
+      {
+        memmove( &data[pos + span], &data[pos], len - pos );
+        len += span;
+      }
+      break;
+    default:
+      // truncate
+      len = pos;
+      break;
+  }
+  return len;
+}
+#endif
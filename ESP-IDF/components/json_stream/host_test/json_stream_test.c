@@ -0,0 +1,212 @@
+/*
+ * json_stream_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of json_stream with the corpus, every file is fed whole and
+ * split in chunks of every size from 1 to 64 bytes, the result (error,
+ * found fields and extracted values) must not depend on the split. The
+ * files in corpus/valid must be accepted, the ones in corpus/invalid must
+ * be rejected. The OpenWeatherMap samples are also checked for the values.
+ * The same corpus is the seed of json_stream_fuzz.
+ *
+ *  make -C components/json_stream/host_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+
+#include "json_stream.h"
+
+// Private Macros
+#define TEST_FILE_MAX                       (16384u)
+#define TEST_CHUNK_MAX                      (64u)
+
+typedef struct _test_out_t
+{
+  int   temperature;
+  int   pressure;
+  int   humidity;
+  float temp_float;
+  char  name[12];
+  char  description[16];
+  int   list_temp[2];
+  bool  nested;
+} test_out_t;
+
+typedef struct _test_result_t
+{
+  esp_err_t   feed;
+  esp_err_t   finish;
+  uint32_t    found;
+  test_out_t  out;
+} test_result_t;
+
+// Private Variables
+static const json_stream_field_t test_fields[] =
+{
+  JSON_STREAM_FIELD( "main.temp",               JSON_STREAM_INT,   test_out_t, temperature ),
+  JSON_STREAM_FIELD( "main.pressure",           JSON_STREAM_INT,   test_out_t, pressure ),
+  JSON_STREAM_FIELD( "main.humidity",           JSON_STREAM_INT,   test_out_t, humidity ),
+  JSON_STREAM_FIELD( "main.temp",               JSON_STREAM_FLOAT, test_out_t, temp_float ),
+  JSON_STREAM_FIELD( "name",                    JSON_STREAM_STR,   test_out_t, name ),
+  JSON_STREAM_FIELD( "weather.0.description",   JSON_STREAM_STR,   test_out_t, description ),
+  JSON_STREAM_FIELD( "list.0.main.temp",        JSON_STREAM_INT,   test_out_t, list_temp[0] ),
+  JSON_STREAM_FIELD( "list.1.main.temp",        JSON_STREAM_INT,   test_out_t, list_temp[1] ),
+  JSON_STREAM_FIELD( "nested.1",                JSON_STREAM_BOOL,  test_out_t, nested ),
+};
+static int test_failed = 0;
+
+// Private Function Declaration
+static size_t test_load( const char *path, char *data );
+static void test_parse( const char *data, size_t len, size_t chunk, test_result_t *result );
+static void test_dir( const char *dir, bool valid );
+static void test_owm_values( const char *dir );
+
+int main( int argc, char **argv )
+{
+  const char *corpus = (argc > 1) ? argv[1] : "corpus";
+  char dir[256];
+
+  snprintf( dir, sizeof(dir), "%s/valid", corpus );
+  test_dir( dir, true );
+  test_owm_values( dir );
+  snprintf( dir, sizeof(dir), "%s/invalid", corpus );
+  test_dir( dir, false );
+  printf( "json_stream_test: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Parse every file of the directory with all the chunk sizes
+ * @param dir corpus directory
+ * @param valid true if the files are valid JSON
+ */
+static void test_dir( const char *dir, bool valid )
+{
+  static char data[TEST_FILE_MAX];
+  char path[512];
+  test_result_t whole;
+  test_result_t split;
+  struct dirent *entry;
+  DIR *handle = opendir( dir );
+  size_t len = 0;
+  int files = 0;
+
+  if( handle == NULL )
+  {
+    printf( "%s: not found\n", dir );
+    test_failed++;
+    return;
+  }
+  while( (entry = readdir( handle )) != NULL )
+  {
+    if( entry->d_name[0] == '.' )
+    {
+      continue;
+    }
+    snprintf( path, sizeof(path), "%s/%s", dir, entry->d_name );
+    len = test_load( path, data );
+    test_parse( data, len, len ? len : 1, &whole );
+    if( valid != (whole.finish == ESP_OK) )
+    {
+      printf( "%s: %s expected, finish returned %d\n", path, valid ? "accept" : "reject", whole.finish );
+      test_failed++;
+    }
+    for( size_t chunk = 1; chunk <= TEST_CHUNK_MAX; chunk++ )
+    {
+      test_parse( data, len, chunk, &split );
+      if( memcmp( &whole, &split, sizeof(whole) ) != 0 )
+      {
+        printf( "%s: result differs with %u byte chunks\n", path, (unsigned)chunk );
+        test_failed++;
+        break;
+      }
+    }
+    files++;
+  }
+  closedir( handle );
+  printf( "%s: %d files\n", dir, files );
+}
+
+/**
+ * @brief Check the values extracted from the OpenWeatherMap responses
+ * @param dir directory with the valid files
+ */
+static void test_owm_values( const char *dir )
+{
+  static char data[TEST_FILE_MAX];
+  char path[512];
+  test_result_t result;
+  size_t len = 0;
+
+  snprintf( path, sizeof(path), "%s/owm_weather.json", dir );
+  len = test_load( path, data );
+  test_parse( data, len, 7, &result );
+  if( (result.out.temperature != 31) || (result.out.pressure != 1004) || (result.out.humidity != 55) || \
+      (strcmp( result.out.name, "Delhi" ) != 0) || (strcmp( result.out.description, "haze" ) != 0) )
+  {
+    printf( "%s: wrong values %d %d %d '%s' '%s'\n", path, result.out.temperature, result.out.pressure, \
+            result.out.humidity, result.out.name, result.out.description );
+    test_failed++;
+  }
+
+  snprintf( path, sizeof(path), "%s/owm_group.json", dir );
+  len = test_load( path, data );
+  test_parse( data, len, 13, &result );
+  if( (result.out.list_temp[0] != 31) || (result.out.list_temp[1] != -3) )
+  {
+    printf( "%s: wrong values %d %d\n", path, result.out.list_temp[0], result.out.list_temp[1] );
+    test_failed++;
+  }
+}
+
+/**
+ * @brief Parse the document fed in chunks
+ * @param data document
+ * @param len document length
+ * @param chunk chunk size
+ * @param result output, zeroed first so that it can be compared with memcmp
+ */
+static void test_parse( const char *data, size_t len, size_t chunk, test_result_t *result )
+{
+  json_stream_t js;
+  size_t pos = 0;
+  size_t part = 0;
+
+  memset( result, 0x00, sizeof(test_result_t) );
+  json_stream_init( &js, test_fields, sizeof(test_fields)/sizeof(test_fields[0]), &result->out );
+  for( pos = 0; pos < len; pos += part )
+  {
+    part = ((len - pos) < chunk) ? (len - pos) : chunk;
+    result->feed = json_stream_feed( &js, &data[pos], part );
+  }
+  result->finish = json_stream_finish( &js );
+  result->found = js.found;
+}
+
+/**
+ * @brief Read a corpus file
+ * @param path file path
+ * @param data buffer of TEST_FILE_MAX bytes
+ * @return file length
+ */
+static size_t test_load( const char *path, char *data )
+{
+  FILE *file = fopen( path, "rb" );
+  size_t len = 0;
+
+  if( file == NULL )
+  {
+    printf( "%s: unable to open\n", path );
+    test_failed++;
+    return 0;
+  }
+  len = fread( data, 1, TEST_FILE_MAX, file );
+  fclose( file );
+  return len;
+}
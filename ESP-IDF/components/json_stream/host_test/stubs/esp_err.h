@@ -0,0 +1,21 @@
+/*
+ * esp_err.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Error codes used by json_stream, for the host build without ESP-IDF
+ */
+
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK                          (0)
+#define ESP_FAIL                        (-1)
+#define ESP_ERR_INVALID_SIZE            (0x104)
+
+#endif /* ESP_ERR_H_ */
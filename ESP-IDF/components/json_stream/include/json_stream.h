@@ -0,0 +1,88 @@
+/*
+ * json_stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Streaming JSON extractor, the response is fed in chunks as they are
+ * received (e.g. from HTTP_EVENT_ON_DATA) and only the declared paths are
+ * written into a user struct. There is no heap allocation and no limit on
+ * the document size, the state is a fixed struct of about 200 bytes.
+ * Paths are the keys joined with '.', array elements use their index, e.g.
+ * "main.temp" or "weather.0.description". Strings longer than the member
+ * are truncated, numbers can be read as int, float or string.
+ *
+ * Usage:
+ *   static const json_stream_field_t fields[] = {
+ *     JSON_STREAM_FIELD( "main.temp", JSON_STREAM_FLOAT, my_t, temp ),
+ *   };
+ *   json_stream_init( &js, fields, 1, &my );
+ *   json_stream_feed( &js, chunk, len );   // for every chunk
+ *   if( (json_stream_finish(&js) == ESP_OK) && json_stream_found(&js, 0) )
+ */
+
+#ifndef JSON_STREAM_H_
+#define JSON_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#define JSON_STREAM_DEPTH_MAX           (16u)     // nesting of objects and arrays
+#define JSON_STREAM_PATH_MAX            (64u)     // longer paths never match
+#define JSON_STREAM_SCALAR_MAX          (32u)     // number and literal length
+#define JSON_STREAM_FIELDS_MAX          (32u)
+
+typedef enum {
+  JSON_STREAM_INT = 0,                  // int, from a number (truncated like cJSON valueint)
+  JSON_STREAM_FLOAT,                    // float, from a number
+  JSON_STREAM_BOOL,                     // bool, from true or false
+  JSON_STREAM_STR,                      // char array, from a string or the text of a number
+} json_stream_type_t;
+
+typedef struct _json_stream_field_t
+{
+  const char          *path;
+  json_stream_type_t  type;
+  uint16_t            offset;           // member offset in output struct
+  uint16_t            size;             // member size
+} json_stream_field_t;
+
+#define JSON_STREAM_FIELD( path, type, struct_type, member )                   \
+  { (path), (type), (uint16_t)offsetof(struct_type, member),                  \
+    (uint16_t)sizeof(((struct_type *)0)->member) }
+
+typedef struct _json_stream_t
+{
+  const json_stream_field_t *fields;
+  void      *out;
+  uint32_t  found;                      // bit n is set if fields[n] is extracted
+  uint32_t  offset;                     // characters consumed, error position
+  uint32_t  array_bits;                 // bit n is set if level n is an array
+  uint16_t  index[JSON_STREAM_DEPTH_MAX];
+  uint8_t   base[JSON_STREAM_DEPTH_MAX];// path length of the container at level n
+  uint16_t  str_len;                    // characters written in string member
+  uint16_t  unicode;                    // \uXXXX code point
+  uint8_t   unicode_len;
+  uint8_t   field_count;
+  uint8_t   state;
+  uint8_t   depth;
+  uint8_t   path_len;
+  uint8_t   scalar_len;
+  uint8_t   number;                     // position in the number grammar
+  int8_t    match;                      // field of the current value, -1 for none
+  bool      in_key;
+  char      path[JSON_STREAM_PATH_MAX];
+  char      scalar[JSON_STREAM_SCALAR_MAX];
+} json_stream_t;
+
+// Public Function Prototypes
+void json_stream_init( json_stream_t *js, const json_stream_field_t *fields, uint8_t field_count, void *out );
+esp_err_t json_stream_feed( json_stream_t *js, const char *data, size_t len );
+esp_err_t json_stream_finish( json_stream_t *js );
+bool json_stream_found( const json_stream_t *js, uint8_t field );
+bool json_stream_found_all( const json_stream_t *js );
+
+#endif /* JSON_STREAM_H_ */
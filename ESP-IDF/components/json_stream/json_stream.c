@@ -0,0 +1,764 @@
+/*
+ * json_stream.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "json_stream.h"
+
+// Private Macros
+#define JSON_PATH_INVALID               (0xFFu)   // path is too long, nothing below matches
+
+typedef enum {
+  JSON_ST_VALUE = 0,                    // expecting a value
+  JSON_ST_OBJ_FIRST,                    // after '{', expecting key or '}'
+  JSON_ST_OBJ_KEY,                      // after ',' in object, expecting key
+  JSON_ST_COLON,                        // after key, expecting ':'
+  JSON_ST_ARR_FIRST,                    // after '[', expecting value or ']'
+  JSON_ST_AFTER_VALUE,                  // expecting ',' or end of container
+  JSON_ST_STRING,
+  JSON_ST_ESCAPE,
+  JSON_ST_UNICODE,
+  JSON_ST_NUMBER,
+  JSON_ST_LITERAL,                      // true, false, null
+  JSON_ST_DONE,
+  JSON_ST_ERROR,
+} json_state_t;
+
+// number grammar of RFC 8259, -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+typedef enum {
+  JSON_NUM_START = 0,
+  JSON_NUM_MINUS,
+  JSON_NUM_ZERO,                        // leading zero, no more digits allowed
+  JSON_NUM_INT,
+  JSON_NUM_DOT,
+  JSON_NUM_FRAC,
+  JSON_NUM_EXP,
+  JSON_NUM_EXP_SIGN,
+  JSON_NUM_EXP_DIGITS,
+  JSON_NUM_INVALID,
+} json_number_t;
+
+// Private Function Declaration
+static bool json_stream_char( json_stream_t *js, char c );
+static bool json_stream_push( json_stream_t *js, bool array );
+static void json_stream_pop( json_stream_t *js );
+static void json_stream_value_begin( json_stream_t *js );
+static void json_stream_value_end( json_stream_t *js );
+static void json_stream_key_begin( json_stream_t *js );
+static bool json_stream_scalar_end( json_stream_t *js );
+static void json_stream_put( json_stream_t *js, char c );
+static void json_stream_put_utf8( json_stream_t *js, uint16_t code );
+static void json_stream_path_append( json_stream_t *js, const char *str, size_t len );
+static bool json_stream_is_ws( char c );
+static json_number_t json_stream_number_next( json_number_t number, char c );
+static bool json_stream_number_end( json_number_t number );
+static int json_stream_hex( char c );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the extractor for a new document
+ * @param js extractor
+ * @param fields paths to extract, must stay valid till finish
+ * @param field_count number of fields, maximum JSON_STREAM_FIELDS_MAX
+ * @param out output struct, members of found fields are written
+ */
+void json_stream_init( json_stream_t *js, const json_stream_field_t *fields, uint8_t field_count, void *out )
+{
+  memset( js, 0x00, sizeof(json_stream_t) );
+  js->fields = fields;
+  js->field_count = (field_count > JSON_STREAM_FIELDS_MAX) ? JSON_STREAM_FIELDS_MAX : field_count;
+  js->out = out;
+  js->state = JSON_ST_VALUE;
+  js->match = -1;
+}
+
+/**
+ * @brief Feed the next chunk of the document
+ * @param js extractor
+ * @param data chunk
+ * @param len chunk length
+ * @return ESP_OK or ESP_FAIL if document is not valid JSON (stays failed)
+ */
+esp_err_t json_stream_feed( json_stream_t *js, const char *data, size_t len )
+{
+  size_t idx = 0;
+
+  while( (idx < len) && (js->state != JSON_ST_ERROR) )
+  {
+    // character ending a number or literal is processed again in new state
+    if( json_stream_char(js, data[idx]) )
+    {
+      idx++;
+      js->offset++;
+    }
+  }
+  return (js->state == JSON_ST_ERROR) ? ESP_FAIL : ESP_OK;
+}
+
+/**
+ * @brief End of document, a number at root level is completed here
+ * @param js extractor
+ * @return ESP_OK if document is complete, ESP_ERR_INVALID_SIZE if truncated,
+ *         ESP_FAIL if not valid JSON
+ */
+esp_err_t json_stream_finish( json_stream_t *js )
+{
+  if( ((js->state == JSON_ST_NUMBER) || (js->state == JSON_ST_LITERAL)) && (js->depth == 0) )
+  {
+    if( json_stream_scalar_end(js) == false )
+    {
+      js->state = JSON_ST_ERROR;
+    }
+  }
+  if( js->state == JSON_ST_ERROR )
+  {
+    return ESP_FAIL;
+  }
+  return (js->state == JSON_ST_DONE) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+/**
+ * @brief Check if the field is extracted
+ * @param js extractor
+ * @param field field index
+ * @return true if the value is written in output struct
+ */
+bool json_stream_found( const json_stream_t *js, uint8_t field )
+{
+  return (field < js->field_count) && (js->found & (1UL << field));
+}
+
+/**
+ * @brief Check if all the fields are extracted
+ * @param js extractor
+ * @return true if all the values are written in output struct
+ */
+bool json_stream_found_all( const json_stream_t *js )
+{
+  uint32_t all = (js->field_count >= 32u) ? UINT32_MAX : ((1UL << js->field_count) - 1u);
+
+  return (js->found & all) == all;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Process one character
+ * @param js extractor
+ * @param c character
+ * @return true if the character is consumed, false if it must be processed
+ *         again in the new state
+ */
+static bool json_stream_char( json_stream_t *js, char c )
+{
+  int hex = 0;
+
+  switch( js->state )
+  {
+    case JSON_ST_VALUE:
+      if( json_stream_is_ws(c) )
+      {
+        break;
+      }
+      json_stream_value_begin( js );
+      if( (c == '{') || (c == '[') )
+      {
+        if( json_stream_push(js, (c == '[')) )
+        {
+          js->state = (c == '[') ? JSON_ST_ARR_FIRST : JSON_ST_OBJ_FIRST;
+        }
+      }
+      else if( c == '"' )
+      {
+        js->in_key = false;
+        js->str_len = 0;
+        js->state = JSON_ST_STRING;
+      }
+      else if( (c == '-') || ((c >= '0') && (c <= '9')) || (c == 't') || (c == 'f') || (c == 'n') )
+      {
+        js->scalar[0] = c;
+        js->scalar_len = 1;
+        js->number = json_stream_number_next( JSON_NUM_START, c );
+        js->state = ((c == 't') || (c == 'f') || (c == 'n')) ? JSON_ST_LITERAL : JSON_ST_NUMBER;
+      }
+      else
+      {
+        js->state = JSON_ST_ERROR;
+      }
+      break;
+
+    case JSON_ST_OBJ_FIRST:
+    case JSON_ST_OBJ_KEY:
+      if( json_stream_is_ws(c) )
+      {
+        break;
+      }
+      if( c == '"' )
+      {
+        json_stream_key_begin( js );
+      }
+      else if( (c == '}') && (js->state == JSON_ST_OBJ_FIRST) )
+      {
+        json_stream_pop( js );
+        json_stream_value_end( js );
+      }
+      else
+      {
+        js->state = JSON_ST_ERROR;
+      }
+      break;
+
+    case JSON_ST_COLON:
+      if( c == ':' )
+      {
+        js->state = JSON_ST_VALUE;
+      }
+      else if( json_stream_is_ws(c) == false )
+      {
+        js->state = JSON_ST_ERROR;
+      }
+      break;
+
+    case JSON_ST_ARR_FIRST:
+      if( json_stream_is_ws(c) )
+      {
+        break;
+      }
+      if( c == ']' )
+      {
+        json_stream_pop( js );
+        json_stream_value_end( js );
+        break;
+      }
+      js->state = JSON_ST_VALUE;
+      return false;
+
+    case JSON_ST_AFTER_VALUE:
+      if( json_stream_is_ws(c) )
+      {
+        break;
+      }
+      if( js->array_bits & (1UL << (js->depth - 1)) )
+      {
+        if( c == ',' )
+        {
+          js->index[js->depth - 1]++;
+          js->state = JSON_ST_VALUE;
+        }
+        else if( c == ']' )
+        {
+          json_stream_pop( js );
+          json_stream_value_end( js );
+        }
+        else
+        {
+          js->state = JSON_ST_ERROR;
+        }
+      }
+      else
+      {
+        if( c == ',' )
+        {
+          js->state = JSON_ST_OBJ_KEY;
+        }
+        else if( c == '}' )
+        {
+          json_stream_pop( js );
+          json_stream_value_end( js );
+        }
+        else
+        {
+          js->state = JSON_ST_ERROR;
+        }
+      }
+      break;
+
+    case JSON_ST_STRING:
+      if( c == '"' )
+      {
+        if( js->in_key )
+        {
+          js->state = JSON_ST_COLON;
+        }
+        else
+        {
+          if( (js->match >= 0) && (js->fields[js->match].type == JSON_STREAM_STR) )
+          {
+            ((char *)js->out + js->fields[js->match].offset)[js->str_len] = '\0';
+            js->found |= (1UL << js->match);
+          }
+          json_stream_value_end( js );
+        }
+      }
+      else if( c == '\\' )
+      {
+        js->state = JSON_ST_ESCAPE;
+      }
+      else if( (uint8_t)c < 0x20u )
+      {
+        // control characters must be escaped
+        js->state = JSON_ST_ERROR;
+      }
+      else
+      {
+        json_stream_put( js, c );
+      }
+      break;
+
+    case JSON_ST_ESCAPE:
+      js->state = JSON_ST_STRING;
+      switch( c )
+      {
+        case '"':
+        case '\\':
+        case '/':
+          json_stream_put( js, c );
+          break;
+        case 'b':
+          json_stream_put( js, '\b' );
+          break;
+        case 'f':
+          json_stream_put( js, '\f' );
+          break;
+        case 'n':
+          json_stream_put( js, '\n' );
+          break;
+        case 'r':
+          json_stream_put( js, '\r' );
+          break;
+        case 't':
+          json_stream_put( js, '\t' );
+          break;
+        case 'u':
+          js->unicode = 0;
+          js->unicode_len = 0;
+          js->state = JSON_ST_UNICODE;
+          break;
+        default:
+          js->state = JSON_ST_ERROR;
+          break;
+      }
+      break;
+
+    case JSON_ST_UNICODE:
+      hex = json_stream_hex( c );
+      if( hex < 0 )
+      {
+        js->state = JSON_ST_ERROR;
+        break;
+      }
+      js->unicode = (uint16_t)((js->unicode << 4) | (uint16_t)hex);
+      js->unicode_len++;
+      if( js->unicode_len == 4 )
+      {
+        json_stream_put_utf8( js, js->unicode );
+        js->state = JSON_ST_STRING;
+      }
+      break;
+
+    case JSON_ST_NUMBER:
+      if( ((c >= '0') && (c <= '9')) || (c == '.') || (c == 'e') || (c == 'E') || (c == '+') || (c == '-') )
+      {
+        // also the numbers which are not extracted are checked
+        js->number = json_stream_number_next( (json_number_t)js->number, c );
+        if( js->number == JSON_NUM_INVALID )
+        {
+          js->state = JSON_ST_ERROR;
+        }
+        else if( js->scalar_len < (JSON_STREAM_SCALAR_MAX - 1) )
+        {
+          js->scalar[js->scalar_len++] = c;
+        }
+        else if( js->match >= 0 )
+        {
+          // wanted number is longer than any valid int or float text
+          js->state = JSON_ST_ERROR;
+        }
+        break;
+      }
+      if( json_stream_scalar_end(js) == false )
+      {
+        js->state = JSON_ST_ERROR;
+        break;
+      }
+      return false;
+
+    case JSON_ST_LITERAL:
+      if( (c >= 'a') && (c <= 'z') )
+      {
+        if( js->scalar_len < 5 )
+        {
+          js->scalar[js->scalar_len++] = c;
+        }
+        else
+        {
+          js->state = JSON_ST_ERROR;
+        }
+        break;
+      }
+      if( json_stream_scalar_end(js) == false )
+      {
+        js->state = JSON_ST_ERROR;
+        break;
+      }
+      return false;
+
+    case JSON_ST_DONE:
+      if( json_stream_is_ws(c) == false )
+      {
+        js->state = JSON_ST_ERROR;
+      }
+      break;
+
+    default:
+      break;
+  }
+  return true;
+}
+
+/**
+ * @brief Enter an object or array
+ * @param js extractor
+ * @param array true for array
+ * @return false if nesting is too deep (state is set to error)
+ */
+static bool json_stream_push( json_stream_t *js, bool array )
+{
+  if( js->depth >= JSON_STREAM_DEPTH_MAX )
+  {
+    js->state = JSON_ST_ERROR;
+    return false;
+  }
+  js->base[js->depth] = js->path_len;
+  js->index[js->depth] = 0;
+  if( array )
+  {
+    js->array_bits |= (1UL << js->depth);
+  }
+  else
+  {
+    js->array_bits &= ~(1UL << js->depth);
+  }
+  js->depth++;
+  js->match = -1;
+  return true;
+}
+
+/**
+ * @brief Leave the current object or array, its path becomes current again
+ * @param js extractor
+ */
+static void json_stream_pop( json_stream_t *js )
+{
+  js->depth--;
+  js->path_len = js->base[js->depth];
+}
+
+/**
+ * @brief Start of a value, for array elements the index is added to the path,
+ *        then the path is compared with the fields
+ * @param js extractor
+ */
+static void json_stream_value_begin( json_stream_t *js )
+{
+  char index[6];
+  uint16_t value = 0;
+  uint8_t len = 0;
+
+  if( (js->depth > 0) && (js->array_bits & (1UL << (js->depth - 1))) )
+  {
+    js->path_len = js->base[js->depth - 1];
+    if( js->path_len )
+    {
+      json_stream_path_append( js, ".", 1 );
+    }
+    value = js->index[js->depth - 1];
+    do
+    {
+      index[sizeof(index) - 1 - len] = (char)('0' + (value % 10));
+      value /= 10;
+      len++;
+    } while( value );
+    json_stream_path_append( js, &index[sizeof(index) - len], len );
+  }
+
+  js->match = -1;
+  if( js->path_len == JSON_PATH_INVALID )
+  {
+    return;
+  }
+  for( uint8_t idx = 0; idx < js->field_count; idx++ )
+  {
+    if( (strncmp(js->fields[idx].path, js->path, js->path_len) == 0) && \
+        (js->fields[idx].path[js->path_len] == '\0') )
+    {
+      js->match = (int8_t)idx;
+      break;
+    }
+  }
+}
+
+/**
+ * @brief End of a value
+ * @param js extractor
+ */
+static void json_stream_value_end( json_stream_t *js )
+{
+  js->match = -1;
+  js->state = (js->depth == 0) ? JSON_ST_DONE : JSON_ST_AFTER_VALUE;
+}
+
+/**
+ * @brief Start of an object key, the key replaces the last path element
+ * @param js extractor
+ */
+static void json_stream_key_begin( json_stream_t *js )
+{
+  js->path_len = js->base[js->depth - 1];
+  if( js->path_len )
+  {
+    json_stream_path_append( js, ".", 1 );
+  }
+  js->in_key = true;
+  js->state = JSON_ST_STRING;
+}
+
+/**
+ * @brief End of a number or literal, the value is converted if it is wanted
+ * @param js extractor
+ * @return false if the literal is not valid
+ */
+static bool json_stream_scalar_end( json_stream_t *js )
+{
+  const json_stream_field_t *field = NULL;
+  uint8_t *member = NULL;
+  bool is_number = (js->state == JSON_ST_NUMBER);
+  bool flag = false;
+  char *end = NULL;
+  double number = 0.0;
+  int value = 0;
+  float value_f = 0.0;
+
+  js->scalar[js->scalar_len] = '\0';
+  if( (is_number == false) && (strcmp(js->scalar, "true") != 0) && \
+      (strcmp(js->scalar, "false") != 0) && (strcmp(js->scalar, "null") != 0) )
+  {
+    return false;
+  }
+  if( is_number && (json_stream_number_end( (json_number_t)js->number ) == false) )
+  {
+    return false;
+  }
+
+  if( js->match >= 0 )
+  {
+    field = &js->fields[js->match];
+    member = (uint8_t *)js->out + field->offset;
+    if( is_number && ((field->type == JSON_STREAM_INT) || (field->type == JSON_STREAM_FLOAT)) )
+    {
+      number = strtod( js->scalar, &end );
+      if( *end != '\0' )
+      {
+        return false;
+      }
+      if( field->type == JSON_STREAM_INT )
+      {
+        // same as cJSON valueint
+        value = (number >= INT_MAX) ? INT_MAX : ((number <= (double)INT_MIN) ? INT_MIN : (int)number);
+        memcpy( member, &value, sizeof(value) );
+      }
+      else
+      {
+        value_f = (float)number;
+        memcpy( member, &value_f, sizeof(value_f) );
+      }
+      js->found |= (1UL << js->match);
+    }
+    else if( is_number && (field->type == JSON_STREAM_STR) && field->size )
+    {
+      strncpy( (char *)member, js->scalar, field->size - 1 );
+      member[field->size - 1] = '\0';
+      js->found |= (1UL << js->match);
+    }
+    else if( (is_number == false) && (field->type == JSON_STREAM_BOOL) && (js->scalar[0] != 'n') )
+    {
+      flag = (js->scalar[0] == 't');
+      memcpy( member, &flag, sizeof(flag) );
+      js->found |= (1UL << js->match);
+    }
+  }
+  json_stream_value_end( js );
+  return true;
+}
+
+/**
+ * @brief Add a string character to the key or to the wanted string member
+ * @param js extractor
+ * @param c character
+ */
+static void json_stream_put( json_stream_t *js, char c )
+{
+  const json_stream_field_t *field = NULL;
+
+  if( js->in_key )
+  {
+    json_stream_path_append( js, &c, 1 );
+    return;
+  }
+  if( js->match < 0 )
+  {
+    return;
+  }
+  field = &js->fields[js->match];
+  if( (field->type == JSON_STREAM_STR) && ((js->str_len + 1u) < field->size) )
+  {
+    ((char *)js->out + field->offset)[js->str_len++] = c;
+  }
+}
+
+/**
+ * @brief Add an escaped character as UTF-8
+ * @param js extractor
+ * @param code code point (surrogate pairs are written as two code points)
+ */
+static void json_stream_put_utf8( json_stream_t *js, uint16_t code )
+{
+  if( code < 0x80u )
+  {
+    json_stream_put( js, (char)code );
+  }
+  else if( code < 0x800u )
+  {
+    json_stream_put( js, (char)(0xC0u | (code >> 6)) );
+    json_stream_put( js, (char)(0x80u | (code & 0x3Fu)) );
+  }
+  else
+  {
+    json_stream_put( js, (char)(0xE0u | (code >> 12)) );
+    json_stream_put( js, (char)(0x80u | ((code >> 6) & 0x3Fu)) );
+    json_stream_put( js, (char)(0x80u | (code & 0x3Fu)) );
+  }
+}
+
+/**
+ * @brief Append to the current path, a path too long becomes invalid
+ * @param js extractor
+ * @param str text
+ * @param len text length
+ */
+static void json_stream_path_append( json_stream_t *js, const char *str, size_t len )
+{
+  if( js->path_len == JSON_PATH_INVALID )
+  {
+    return;
+  }
+  if( (js->path_len + len) >= JSON_STREAM_PATH_MAX )
+  {
+    js->path_len = JSON_PATH_INVALID;
+    return;
+  }
+  memcpy( &js->path[js->path_len], str, len );
+  js->path_len += (uint8_t)len;
+}
+
+/**
+ * @brief Check for JSON white space
+ * @param c character
+ * @return true if white space
+ */
+static bool json_stream_is_ws( char c )
+{
+  return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+}
+
+/**
+ * @brief Convert a hex digit
+ * @param c character
+ * @return value or -1 if not a hex digit
+ */
+static int json_stream_hex( char c )
+{
+  if( (c >= '0') && (c <= '9') )
+  {
+    return c - '0';
+  }
+  if( (c >= 'a') && (c <= 'f') )
+  {
+    return c - 'a' + 10;
+  }
+  if( (c >= 'A') && (c <= 'F') )
+  {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+/**
+ * @brief Next state of the number grammar
+ * @param number current state
+ * @param c next character of the number
+ * @return new state, JSON_NUM_INVALID if the character is not allowed
+ */
+static json_number_t json_stream_number_next( json_number_t number, char c )
+{
+  bool digit = ((c >= '0') && (c <= '9'));
+
+  switch( number )
+  {
+    case JSON_NUM_START:
+      if( c == '-' )
+      {
+        return JSON_NUM_MINUS;
+      }
+      // fall through
+    case JSON_NUM_MINUS:
+      return (c == '0') ? JSON_NUM_ZERO : (digit ? JSON_NUM_INT : JSON_NUM_INVALID);
+    case JSON_NUM_INT:
+      if( digit )
+      {
+        return JSON_NUM_INT;
+      }
+      // fall through
+    case JSON_NUM_ZERO:
+      if( c == '.' )
+      {
+        return JSON_NUM_DOT;
+      }
+      return ((c == 'e') || (c == 'E')) ? JSON_NUM_EXP : JSON_NUM_INVALID;
+    case JSON_NUM_DOT:
+    case JSON_NUM_FRAC:
+      if( digit )
+      {
+        return JSON_NUM_FRAC;
+      }
+      return ((number == JSON_NUM_FRAC) && ((c == 'e') || (c == 'E'))) ? JSON_NUM_EXP : JSON_NUM_INVALID;
+    case JSON_NUM_EXP:
+      if( (c == '+') || (c == '-') )
+      {
+        return JSON_NUM_EXP_SIGN;
+      }
+      // fall through
+    case JSON_NUM_EXP_SIGN:
+    case JSON_NUM_EXP_DIGITS:
+      return digit ? JSON_NUM_EXP_DIGITS : JSON_NUM_INVALID;
+    default:
+      return JSON_NUM_INVALID;
+  }
+}
+
+/**
+ * @brief Check if the number can end in this state
+ * @param number current state
+ * @return true if the number is complete
+ */
+static bool json_stream_number_end( json_number_t number )
+{
+  return (number == JSON_NUM_ZERO) || (number == JSON_NUM_INT) || \
+         (number == JSON_NUM_FRAC) || (number == JSON_NUM_EXP_DIGITS);
+}
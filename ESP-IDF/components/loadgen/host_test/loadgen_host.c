@@ -0,0 +1,235 @@
+/*
+ * loadgen_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Linux host build of the load generator. The component runs unchanged on
+ * the host stubs of udp_uplink (FreeRTOS on POSIX threads) and drives the
+ * real pipeline: telemetry bus -> UDP uplink (line protocol) -> receiver on
+ * the loopback. A second sink with the coalesce policy is read slowly, so the
+ * report shows queue depth and coalesced samples too. Checked are the
+ * sustained rate, that nothing was skipped and that every virtual device
+ * arrived at the receiver as its own series "host-<n>".
+ *
+ *  make -C components/loadgen/host_test
+ *  build/loadgen_host [devices] [rate_hz] [duration_s]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "telemetry.h"
+#include "udp_uplink.h"
+#include "loadgen.h"
+
+// Private Macros
+#define HOST_DEVICES_MAX                    (255u)
+#define HOST_SLOW_DEPTH                     (8u)
+#define HOST_SLOW_PERIOD_MS                 (100u)
+#define HOST_DRAIN_MS                       (2000)
+#define HOST_RATE_TOLERANCE                 (0.02)
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond );   \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+// Private Variables
+static const char * const host_fields[] = { "temperature", "humidity" };
+static telemetry_sample_t host_slow_queue[HOST_SLOW_DEPTH];
+static telemetry_sink_t host_slow_sink;
+static int host_socket = -1;
+static atomic_bool host_stop = false;
+static atomic_uint host_records = 0;
+static bool host_device_seen[HOST_DEVICES_MAX + 1u];
+static int test_failed = 0;
+
+// Private Function Declaration
+static void * host_receiver( void *arg );
+static void * host_slow_reader( void *arg );
+static int host_open_receiver( uint16_t *port );
+static void host_sleep_ms( uint32_t ms );
+
+int main( int argc, char **argv )
+{
+  loadgen_config_t loadgen_cfg = LOADGEN_CONFIG_DEFAULT();
+  udp_uplink_config_t udp_cfg = { 0 };
+  loadgen_report_t report;
+  pthread_t rx_thread;
+  pthread_t slow_thread;
+  uint32_t devices_seen = 0;
+  uint16_t port = 0;
+  double expected = 0.0;
+
+  loadgen_cfg.devices = (uint8_t)((argc > 1) ? strtoul( argv[1], NULL, 0 ) : 50u);
+  loadgen_cfg.rate_hz = (argc > 2) ? (uint32_t)strtoul( argv[2], NULL, 0 ) : 100u;
+  loadgen_cfg.duration_s = (argc > 3) ? (uint32_t)strtoul( argv[3], NULL, 0 ) : 3u;
+  loadgen_cfg.report_ms = 1000;
+  expected = (double)loadgen_cfg.devices * loadgen_cfg.rate_hz * loadgen_cfg.duration_s;
+
+  host_socket = host_open_receiver( &port );
+  if( host_socket < 0 )
+  {
+    printf( "unable to open the receiver socket\n" );
+    return EXIT_FAILURE;
+  }
+  udp_cfg.host = "127.0.0.1";
+  udp_cfg.port = port;
+  udp_cfg.format = UDP_UPLINK_LINE_PROTOCOL;
+  udp_cfg.measurement = "climate";
+  udp_cfg.device_id = "host";
+  udp_cfg.fields = host_fields;
+  udp_cfg.field_count = 2;
+  udp_cfg.decimals = 2;
+  udp_cfg.mtu = UDP_UPLINK_MTU_DEFAULT;
+  udp_cfg.flush_ms = 50;
+  udp_cfg.queue_depth = 1024;
+  udp_cfg.sequence = true;
+  CHECK( udp_uplink_start( &udp_cfg ) == ESP_OK );
+
+  // a sink which keeps only the latest values, like a display
+  telemetry_sink_init( &host_slow_sink, "slow", host_slow_queue, HOST_SLOW_DEPTH, TELEMETRY_COALESCE, NULL, NULL );
+  CHECK( telemetry_sink_register( &host_slow_sink ) == ESP_OK );
+
+  pthread_create( &rx_thread, NULL, host_receiver, NULL );
+  pthread_create( &slow_thread, NULL, host_slow_reader, NULL );
+  CHECK( loadgen_start( &loadgen_cfg ) == ESP_OK );
+  do
+  {
+    host_sleep_ms( 10 );
+    loadgen_get_report( &report );
+  } while( report.running );
+
+  // last datagram is sent after flush_ms
+  for( int waited = 0; (atomic_load( &host_records ) < report.published) && (waited < HOST_DRAIN_MS); waited++ )
+  {
+    host_sleep_ms( 1 );
+  }
+  atomic_store( &host_stop, true );
+  pthread_join( rx_thread, NULL );
+  pthread_join( slow_thread, NULL );
+
+  for( uint32_t idx = 1; idx <= loadgen_cfg.devices; idx++ )
+  {
+    devices_seen += host_device_seen[idx] ? 1u : 0u;
+  }
+  printf( "%u devices x %u Hz for %u s: %u samples published (%.0f/s), %u skipped, %u received, %u devices seen\n", \
+          (unsigned)loadgen_cfg.devices, (unsigned)loadgen_cfg.rate_hz, (unsigned)loadgen_cfg.duration_s, \
+          (unsigned)report.published, (double)report.samples_per_s, (unsigned)report.skipped, \
+          atomic_load( &host_records ), (unsigned)devices_seen );
+
+  CHECK( report.skipped == 0 );
+  CHECK( report.published >= (uint32_t)(expected * (1.0 - HOST_RATE_TOLERANCE)) );
+  CHECK( report.published <= (uint32_t)(expected * (1.0 + HOST_RATE_TOLERANCE)) );
+  CHECK( atomic_load( &host_records ) == report.published );
+  CHECK( devices_seen == loadgen_cfg.devices );
+  printf( "loadgen_host: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Receiver thread, counts the records and the devices they are from
+ * @param arg not used
+ */
+static void * host_receiver( void *arg )
+{
+  static char datagram[UDP_UPLINK_MTU_DEFAULT + 1u];
+  const char *line = NULL;
+  unsigned device = 0;
+  unsigned records = 0;
+  ssize_t len = 0;
+
+  (void)arg;
+  while( !atomic_load( &host_stop ) )
+  {
+    len = recv( host_socket, datagram, sizeof(datagram) - 1u, 0 );
+    if( len <= 0 )
+    {
+      continue;
+    }
+    datagram[len] = '\0';
+    records = 0;
+    for( line = datagram; (line != NULL) && (*line != '\0'); line = strchr( line, '\n' ), line = line ? line + 1 : NULL )
+    {
+      if( sscanf( line, "climate,device_id=host-%u ", &device ) == 1 )
+      {
+        host_device_seen[(device <= HOST_DEVICES_MAX) ? device : 0u] = true;
+        records++;
+      }
+    }
+    atomic_fetch_add( &host_records, records );
+  }
+  return NULL;
+}
+
+/**
+ * @brief Reads the coalescing sink only every HOST_SLOW_PERIOD_MS
+ * @param arg not used
+ */
+static void * host_slow_reader( void *arg )
+{
+  telemetry_sample_t sample;
+
+  (void)arg;
+  while( !atomic_load( &host_stop ) )
+  {
+    host_sleep_ms( HOST_SLOW_PERIOD_MS );
+    while( telemetry_receive( &host_slow_sink, &sample ) )
+    {
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Open the receiver socket on a free loopback port
+ * @param port output, port number
+ * @return socket or -1
+ */
+static int host_open_receiver( uint16_t *port )
+{
+  struct sockaddr_in addr = { 0 };
+  struct timeval timeout = { .tv_sec = 0, .tv_usec = 100000 };
+  socklen_t addr_len = sizeof(addr);
+  int rcvbuf = 4 * 1024 * 1024;
+  int sock = socket( AF_INET, SOCK_DGRAM, 0 );
+
+  if( sock < 0 )
+  {
+    return -1;
+  }
+  setsockopt( sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf) );
+  setsockopt( sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  if( (bind( sock, (struct sockaddr *)&addr, sizeof(addr) ) != 0) || \
+      (getsockname( sock, (struct sockaddr *)&addr, &addr_len ) != 0) )
+  {
+    close( sock );
+    return -1;
+  }
+  *port = ntohs( addr.sin_port );
+  return sock;
+}
+
+static void host_sleep_ms( uint32_t ms )
+{
+  struct timespec delay = { .tv_sec = ms / 1000u, .tv_nsec = (long)(ms % 1000u) * 1000000L };
+  nanosleep( &delay, NULL );
+}
@@ -0,0 +1,40 @@
+/*
+ * esp_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * esp_random and the heap functions for the host build of the load
+ * generator. The random numbers come from a xorshift generator, so a run is
+ * repeatable, and the host has no heap figures, they are reported as 0.
+ */
+#include <pthread.h>
+
+#include "esp_random.h"
+#include "esp_system.h"
+
+static uint32_t host_random = 2463534242u;
+static pthread_mutex_t host_random_lock = PTHREAD_MUTEX_INITIALIZER;
+
+uint32_t esp_random( void )
+{
+  uint32_t value = 0;
+
+  pthread_mutex_lock( &host_random_lock );
+  host_random ^= host_random << 13;
+  host_random ^= host_random >> 17;
+  host_random ^= host_random << 5;
+  value = host_random;
+  pthread_mutex_unlock( &host_random_lock );
+  return value;
+}
+
+uint32_t esp_get_free_heap_size( void )
+{
+  return 0;
+}
+
+uint32_t esp_get_minimum_free_heap_size( void )
+{
+  return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * esp_system.h
+ *
+ * Host build stub, see esp_host.c
+ */
+#ifndef ESP_SYSTEM_H_
+#define ESP_SYSTEM_H_
+
+#include <stdint.h>
+
+uint32_t esp_get_free_heap_size( void );
+uint32_t esp_get_minimum_free_heap_size( void );
+
+#endif /* ESP_SYSTEM_H_ */
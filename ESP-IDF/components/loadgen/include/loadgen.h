@@ -0,0 +1,62 @@
+/*
+ * loadgen.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Synthetic load generator, emulates N devices sending M samples per second
+ * each. The samples are published on the telemetry bus with the device number
+ * as source, so they go through the same sinks (InfluxDB, ThingSpeak, MQTT,
+ * UDP) as the real sensor data. Every device has its own climate, temperature
+ * and humidity follow a slow random walk with sensor noise and humidity goes
+ * down when temperature goes up. Periodically a report with the throughput,
+ * the queue depth and drops of every sink and the heap low-water mark is logged.
+ */
+
+#ifndef LOADGEN_H_
+#define LOADGEN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+
+// value order in the published samples, same as the sensor channels of projects
+#define LOADGEN_CH_TEMPERATURE          (0u)
+#define LOADGEN_CH_HUMIDITY             (1u)
+#define LOADGEN_CH_MAX                  (2u)
+
+typedef struct _loadgen_config_t
+{
+  uint8_t   devices;                    // number of virtual devices (source 1..devices)
+  uint32_t  rate_hz;                    // samples per second per device
+  uint32_t  duration_s;                 // 0 runs forever
+  uint32_t  report_ms;                  // report interval, 0 disables the report
+} loadgen_config_t;
+
+typedef struct _loadgen_report_t
+{
+  uint32_t  elapsed_ms;
+  uint32_t  published;                  // samples published
+  uint32_t  skipped;                    // samples not generated because the task fell behind
+  float     samples_per_s;              // sustained throughput since start
+  uint32_t  heap_free;
+  uint32_t  heap_min_free;              // heap low-water mark since boot
+  bool      running;
+} loadgen_report_t;
+
+#define LOADGEN_CONFIG_DEFAULT()        \
+{                                       \
+  .devices = 10,                        \
+  .rate_hz = 1,                         \
+  .duration_s = 0,                      \
+  .report_ms = 10000,                   \
+}
+
+// Public Function Prototypes
+esp_err_t loadgen_start( const loadgen_config_t *config );
+void loadgen_stop( void );
+void loadgen_get_report( loadgen_report_t *report );
+void loadgen_log_report( void );
+
+#endif /* LOADGEN_H_ */
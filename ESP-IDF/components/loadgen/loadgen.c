@@ -0,0 +1,295 @@
+/*
+ * loadgen.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <inttypes.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_system.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "telemetry.h"
+#include "loadgen.h"
+
+// Private Macros
+#define LOADGEN_TASK_STACK              (4096)
+#define LOADGEN_TASK_PRIORITY           (4)       // below the sink tasks, like a sensor loop
+#define LOADGEN_TICK_MS                 (10u)
+#define LOADGEN_BURST_MAX               (500u)    // samples in one tick, rest are skipped
+#define LOADGEN_PI                      (3.14159265f)
+
+typedef struct _loadgen_device_t
+{
+  float temperature;                    // actual climate of the device
+  float humidity;
+  float base_temperature;               // long term mean of the device location
+  float base_humidity;
+} loadgen_device_t;
+
+// Private Variables
+static const char *TAG = "LoadGen";
+static loadgen_config_t loadgen_config = { 0 };
+static loadgen_device_t *loadgen_devices = NULL;
+static TaskHandle_t loadgen_task_handle = NULL;
+static volatile bool loadgen_running = false;
+static int64_t loadgen_start_us = 0;
+static int64_t loadgen_stop_us = 0;
+static uint32_t loadgen_published = 0;
+static uint32_t loadgen_skipped = 0;
+
+// Private Function Declaration
+static void loadgen_task( void *pvParameters );
+static void loadgen_device_init( loadgen_device_t *device );
+static void loadgen_device_sample( loadgen_device_t *device, float *values );
+static float loadgen_uniform( void );
+static float loadgen_gauss( void );
+static float loadgen_clamp( float value, float min, float max );
+
+// Public Function Definition
+
+/**
+ * @brief Start the load generator task
+ * @param config configuration, use LOADGEN_CONFIG_DEFAULT()
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t loadgen_start( const loadgen_config_t *config )
+{
+  if( (config->devices == 0) || (config->rate_hz == 0) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( loadgen_task_handle != NULL )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  loadgen_config = *config;
+  loadgen_devices = calloc( loadgen_config.devices, sizeof(loadgen_device_t) );
+  if( loadgen_devices == NULL )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  for( uint32_t idx = 0; idx < loadgen_config.devices; idx++ )
+  {
+    loadgen_device_init( &loadgen_devices[idx] );
+  }
+
+  loadgen_published = 0;
+  loadgen_skipped = 0;
+  loadgen_running = true;
+  if( xTaskCreate( &loadgen_task, "LoadGen Task", LOADGEN_TASK_STACK, NULL, \
+                   LOADGEN_TASK_PRIORITY, &loadgen_task_handle ) != pdPASS )
+  {
+    loadgen_running = false;
+    free( loadgen_devices );
+    loadgen_devices = NULL;
+    return ESP_ERR_NO_MEM;
+  }
+  ESP_LOGI(TAG, "%u devices x %" PRIu32 " samples/s started", loadgen_config.devices, loadgen_config.rate_hz);
+  return ESP_OK;
+}
+
+/**
+ * @brief Stop the load generator, task finishes within one tick
+ * @param  none
+ */
+void loadgen_stop( void )
+{
+  loadgen_running = false;
+}
+
+/**
+ * @brief Get the load generator report
+ * @param report report output
+ */
+void loadgen_get_report( loadgen_report_t *report )
+{
+  int64_t end_us = loadgen_running ? esp_timer_get_time() : loadgen_stop_us;
+
+  memset( report, 0x00, sizeof(loadgen_report_t) );
+  report->running = loadgen_running;
+  report->published = loadgen_published;
+  report->skipped = loadgen_skipped;
+  if( loadgen_start_us && (end_us > loadgen_start_us) )
+  {
+    report->elapsed_ms = (uint32_t)((end_us - loadgen_start_us) / 1000);
+    report->samples_per_s = (float)report->published * 1000000.0f / (float)(end_us - loadgen_start_us);
+  }
+  report->heap_free = esp_get_free_heap_size();
+  report->heap_min_free = esp_get_minimum_free_heap_size();
+}
+
+/**
+ * @brief Log the report with the statistics of all the telemetry sinks
+ * @param  none
+ */
+void loadgen_log_report( void )
+{
+  loadgen_report_t report;
+  telemetry_stats_t stats;
+  float drop_pct = 0.0;
+
+  loadgen_get_report( &report );
+  ESP_LOGI(TAG, "%" PRIu32 " ms: %" PRIu32 " samples (%.1f/s), %" PRIu32 " skipped, heap %" PRIu32 " (min %" PRIu32 ")", \
+           report.elapsed_ms, report.published, report.samples_per_s, report.skipped, \
+           report.heap_free, report.heap_min_free);
+
+  for( telemetry_sink_t *sink = telemetry_sink_first(); sink != NULL; sink = sink->next )
+  {
+    telemetry_get_stats( sink, &stats );
+    drop_pct = stats.received ? (100.0f * (float)(stats.dropped + stats.coalesced) / (float)stats.received) : 0.0f;
+    ESP_LOGI(TAG, "  %-10s depth %" PRIu32 "/%u (max %" PRIu32 "), delivered %" PRIu32 ", dropped %" PRIu32 ", coalesced %" PRIu32 \
+             " (%.2f %%), lag %" PRIu32 " ms (max %" PRIu32 ")", \
+             sink->name, stats.depth, sink->size, stats.max_depth, stats.delivered, stats.dropped, \
+             stats.coalesced, drop_pct, stats.lag_ms, stats.max_lag_ms);
+  }
+}
+
+// Private Function Definition
+
+/**
+ * @brief Load Generator Task
+ * Wakes up every LOADGEN_TICK_MS and publishes all the samples due till now,
+ * so rates higher than the tick rate are possible. If the task can't keep up,
+ * the missing samples are skipped (counted), not published in a burst later.
+ * @param pvParameters
+ */
+static void loadgen_task( void *pvParameters )
+{
+  TickType_t wake = xTaskGetTickCount();
+  uint64_t total_rate = (uint64_t)loadgen_config.devices * loadgen_config.rate_hz;
+  uint64_t generated = 0;
+  uint64_t due = 0;
+  int64_t now_us = 0;
+  int64_t report_us = 0;
+  uint32_t device = 0;
+  float values[LOADGEN_CH_MAX];
+
+  (void)pvParameters;
+  loadgen_start_us = esp_timer_get_time();
+  report_us = loadgen_start_us + (int64_t)loadgen_config.report_ms * 1000;
+  while( loadgen_running )
+  {
+    vTaskDelayUntil( &wake, pdMS_TO_TICKS(LOADGEN_TICK_MS) ? pdMS_TO_TICKS(LOADGEN_TICK_MS) : 1 );
+    now_us = esp_timer_get_time();
+
+    due = ((uint64_t)(now_us - loadgen_start_us) * total_rate) / 1000000u - generated;
+    if( due > LOADGEN_BURST_MAX )
+    {
+      loadgen_skipped += (uint32_t)(due - LOADGEN_BURST_MAX);
+      generated += due - LOADGEN_BURST_MAX;
+      due = LOADGEN_BURST_MAX;
+    }
+    for( ; due > 0; due-- )
+    {
+      // devices are interleaved, like independent devices on one server
+      loadgen_device_sample( &loadgen_devices[device], values );
+      telemetry_publish_source( (uint8_t)(device + 1), values, LOADGEN_CH_MAX );
+      device = (device + 1) % loadgen_config.devices;
+      generated++;
+      loadgen_published++;
+    }
+
+    if( loadgen_config.report_ms && (now_us >= report_us) )
+    {
+      loadgen_log_report();
+      report_us += (int64_t)loadgen_config.report_ms * 1000;
+    }
+    if( loadgen_config.duration_s && ((now_us - loadgen_start_us) >= (int64_t)loadgen_config.duration_s * 1000000) )
+    {
+      loadgen_running = false;
+    }
+  }
+
+  loadgen_stop_us = esp_timer_get_time();
+  loadgen_log_report();
+  free( loadgen_devices );
+  loadgen_devices = NULL;
+  loadgen_task_handle = NULL;
+  vTaskDelete( NULL );
+}
+
+/**
+ * @brief Give a random indoor climate to the device
+ * @param device virtual device
+ */
+static void loadgen_device_init( loadgen_device_t *device )
+{
+  device->base_temperature = 18.0f + 12.0f * loadgen_uniform();
+  device->base_humidity = 35.0f + 35.0f * loadgen_uniform();
+  device->temperature = device->base_temperature;
+  device->humidity = device->base_humidity;
+}
+
+/**
+ * @brief Generate the next sample of the device, climate follows a mean
+ *        reverting random walk and the measured value has sensor noise
+ * @param device virtual device
+ * @param values sample output
+ */
+static void loadgen_device_sample( loadgen_device_t *device, float *values )
+{
+  float humidity_target = 0.0;
+
+  device->temperature += 0.05f * loadgen_gauss() + 0.01f * (device->base_temperature - device->temperature);
+  device->temperature = loadgen_clamp( device->temperature, -10.0f, 50.0f );
+  // relative humidity falls when the air gets warmer
+  humidity_target = device->base_humidity - 2.0f * (device->temperature - device->base_temperature);
+  device->humidity += 0.1f * loadgen_gauss() + 0.05f * (humidity_target - device->humidity);
+  device->humidity = loadgen_clamp( device->humidity, 0.0f, 100.0f );
+
+  values[LOADGEN_CH_TEMPERATURE] = device->temperature + 0.1f * loadgen_gauss();
+  values[LOADGEN_CH_HUMIDITY] = loadgen_clamp( device->humidity + 0.5f * loadgen_gauss(), 0.0f, 100.0f );
+}
+
+/**
+ * @brief Uniform random number
+ * @param  none
+ * @return value in [0, 1)
+ */
+static float loadgen_uniform( void )
+{
+  return (float)(esp_random() >> 8) * (1.0f / 16777216.0f);
+}
+
+/**
+ * @brief Normal distributed random number (Box-Muller)
+ * @param  none
+ * @return value with mean 0 and standard deviation 1
+ */
+static float loadgen_gauss( void )
+{
+  float u1 = loadgen_uniform() + (1.0f / 16777216.0f);    // log(0) is not allowed
+  float u2 = loadgen_uniform();
+
+  return sqrtf( -2.0f * logf(u1) ) * cosf( 2.0f * LOADGEN_PI * u2 );
+}
+
+/**
+ * @brief Limit the value in the range
+ * @param value value
+ * @param min minimum value
+ * @param max maximum value
+ * @return limited value
+ */
+static float loadgen_clamp( float value, float min, float max )
+{
+  if( value < min )
+  {
+    return min;
+  }
+  if( value > max )
+  {
+    return max;
+  }
+  return value;
+}
@@ -0,0 +1,575 @@
+/*
+ * multipart_stream_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of multipart_stream. A browser like upload body (preamble, a
+ * "sha256" field and a binary "file" part full of delimiter prefixes) is fed
+ * whole, split in two at every offset, split in three at every pair of
+ * offsets up to 64 bytes apart and in chunks of every size from 1 to 64 bytes, the parts must
+ * always come out byte exact. The file content has partial delimiters which
+ * fail at every position, also across a chunk border, that is the carried
+ * match which is given back as content. Random bodies made of the delimiter
+ * characters only check the same with a short boundary. The error cases are
+ * invalid Content-Type, truncated bodies, garbage after a boundary and a
+ * callback error.
+ *
+ *  make -C components/multipart_stream/host_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "multipart_stream.h"
+
+// Private Macros
+#define TEST_BODY_MAX                       (4096u)
+#define TEST_PARTS_MAX                      (4u)
+#define TEST_CHUNK_MAX                      (64u)
+#define TEST_RANDOM_RUNS                    (20000u)
+#define TEST_BOUNDARY                       "----WebKitFormBoundary7MA4YWxkTrZu0gW"
+#define TEST_CONTENT_TYPE                   "multipart/form-data; boundary=" TEST_BOUNDARY
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond );   \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+typedef struct _test_part_t
+{
+  char      name[MULTIPART_STREAM_NAME_MAX];
+  uint8_t   data[TEST_BODY_MAX];
+  size_t    len;
+  bool      ended;
+} test_part_t;
+
+typedef struct _test_result_t
+{
+  test_part_t parts[TEST_PARTS_MAX];
+  uint32_t    count;
+  esp_err_t   feed;
+  esp_err_t   finish;
+  bool        bad_event;                // data or end without begin
+  esp_err_t   fail_with;                // callback returns this for the first "file" data
+} test_result_t;
+
+typedef struct _test_body_t
+{
+  const char *boundary;
+  bool      padding;                    // transport padding after the boundaries
+  char      body[TEST_BODY_MAX];
+  size_t    len;
+  size_t    end;                        // length up to the closing "--"
+  const char *names[TEST_PARTS_MAX];
+  const uint8_t *content[TEST_PARTS_MAX];
+  size_t    content_len[TEST_PARTS_MAX];
+  uint32_t  count;
+} test_body_t;
+
+// Private Variables
+static uint32_t test_random_state = 2463534242u;
+static int test_failed = 0;
+
+// Private Function Declaration
+static void test_splits( void );
+static void test_carried_match( void );
+static void test_random_bodies( void );
+static void test_content_type( void );
+static void test_truncated( void );
+static void test_garbage( void );
+static void test_callback_error( void );
+static size_t test_file_content( uint8_t *content );
+static void test_begin( test_body_t *tb, const char *boundary, bool padding );
+static void test_add( test_body_t *tb, const char *name, const void *content, size_t len );
+static void test_end( test_body_t *tb );
+static void test_feed( const char *content_type, const char *const *chunks, const size_t *lens, uint32_t count, \
+                       test_result_t *result );
+static bool test_match( const test_body_t *tb, const test_result_t *result );
+static esp_err_t test_cb( void *ctx, multipart_event_t event, const char *name, const uint8_t *data, size_t len );
+static bool test_contains( const uint8_t *data, size_t len, const char *str );
+static uint32_t test_random( void );
+
+int main( void )
+{
+  test_splits();
+  test_carried_match();
+  test_random_bodies();
+  test_content_type();
+  test_truncated();
+  test_garbage();
+  test_callback_error();
+  printf( "multipart_stream_test: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Content of the "file" part, binary with every delimiter prefix, each
+ *        one fails at the next character
+ * @param content output, at least TEST_BODY_MAX bytes
+ * @return content length
+ */
+static size_t test_file_content( uint8_t *content )
+{
+  const char delim[] = "\r\n--" TEST_BOUNDARY;
+  size_t len = 0;
+
+  for( size_t prefix = 1; prefix < (sizeof(delim) - 1u); prefix++ )
+  {
+    memcpy( &content[len], delim, prefix );
+    len += prefix;
+    // a byte which breaks the match, sometimes a restart of the delimiter
+    content[len++] = (prefix % 3u) ? (uint8_t)(0x80u + prefix) : '\r';
+  }
+  // binary bytes, a NUL and a double CR in front of a delimiter prefix
+  for( uint32_t idx = 0; idx < 64u; idx++ )
+  {
+    content[len++] = (uint8_t)(idx * 37u);
+  }
+  memcpy( &content[len], "\r\r\n--", 5u );
+  len += 5u;
+  // content ends with a delimiter prefix, the real delimiter follows it
+  memcpy( &content[len], "\r\n--" TEST_BOUNDARY, 10u );
+  len += 10u;
+  return len;
+}
+
+/**
+ * @brief Upload body split at every offset, every pair of offsets and in
+ *        chunks of every size
+ */
+static void test_splits( void )
+{
+  static test_body_t tb;
+  static test_result_t result;
+  static uint8_t file[TEST_BODY_MAX];
+  const char *chunks[3];
+  size_t lens[3];
+  size_t file_len = test_file_content( file );
+  uint32_t runs = 0;
+  uint32_t failed = 0;
+
+  test_begin( &tb, TEST_BOUNDARY, false );
+  test_add( &tb, "sha256", "9f86d081884c7d659a2feaa0c55ad015a3bf4f1b2b0b822cd15d6c15b0f00a08", 64u );
+  test_add( &tb, "file", file, file_len );
+  test_end( &tb );
+
+  chunks[0] = tb.body;
+  lens[0] = tb.len;
+  test_feed( TEST_CONTENT_TYPE, chunks, lens, 1, &result );
+  CHECK( (result.feed == ESP_OK) && (result.finish == ESP_OK) && test_match( &tb, &result ) );
+
+  // two chunks, border at every offset
+  for( size_t split = 0; split <= tb.len; split++ )
+  {
+    chunks[0] = tb.body;
+    lens[0] = split;
+    chunks[1] = &tb.body[split];
+    lens[1] = tb.len - split;
+    test_feed( TEST_CONTENT_TYPE, chunks, lens, 2, &result );
+    failed += test_match( &tb, &result ) ? 0u : 1u;
+    runs++;
+  }
+  // three chunks, so a match can be carried over a whole chunk, the middle
+  // chunk is up to 64 bytes, longer than the delimiter
+  for( size_t first = 0; first <= tb.len; first++ )
+  {
+    for( size_t second = first; (second <= tb.len) && (second <= (first + TEST_CHUNK_MAX)); second++ )
+    {
+      chunks[0] = tb.body;
+      lens[0] = first;
+      chunks[1] = &tb.body[first];
+      lens[1] = second - first;
+      chunks[2] = &tb.body[second];
+      lens[2] = tb.len - second;
+      test_feed( TEST_CONTENT_TYPE, chunks, lens, 3, &result );
+      failed += test_match( &tb, &result ) ? 0u : 1u;
+      runs++;
+    }
+  }
+  // chunks of the same size, like httpd_req_recv gives them
+  for( size_t chunk = 1; chunk <= TEST_CHUNK_MAX; chunk++ )
+  {
+    static const char *many[TEST_BODY_MAX];
+    static size_t many_lens[TEST_BODY_MAX];
+    uint32_t count = 0;
+
+    for( size_t pos = 0; pos < tb.len; pos += chunk )
+    {
+      many[count] = &tb.body[pos];
+      many_lens[count++] = ((tb.len - pos) < chunk) ? (tb.len - pos) : chunk;
+    }
+    test_feed( TEST_CONTENT_TYPE, many, many_lens, count, &result );
+    failed += test_match( &tb, &result ) ? 0u : 1u;
+    runs++;
+  }
+  printf( "splits: %u byte body, %u runs, %u failed\n", (unsigned)tb.len, (unsigned)runs, (unsigned)failed );
+  CHECK( failed == 0 );
+}
+
+/**
+ * @brief A delimiter prefix at the end of a chunk which fails in the next
+ *        chunk is content, in the right order
+ */
+static void test_carried_match( void )
+{
+  static test_result_t result;
+  const char *chunks[4] =
+  {
+    "--ab\r\nContent-Disposition: form-data; name=\"file\"\r\n\r\nxy\r\n-",
+    "-a",                               // still matching, a whole chunk
+    "Xz\r\n--a",                        // fails at X, "\r\n--aX" is content
+    "b--\r\n",
+  };
+  size_t lens[4];
+
+  for( uint32_t idx = 0; idx < 4u; idx++ )
+  {
+    lens[idx] = strlen( chunks[idx] );
+  }
+  test_feed( "multipart/form-data; boundary=ab", chunks, lens, 4, &result );
+  CHECK( result.feed == ESP_OK );
+  CHECK( result.finish == ESP_OK );
+  CHECK( result.count == 1 );
+  CHECK( (result.parts[0].len == 9u) && (memcmp( result.parts[0].data, "xy\r\n--aXz", 9u ) == 0) );
+  CHECK( result.parts[0].ended );
+}
+
+/**
+ * @brief Random bodies of delimiter characters with a short boundary, so the
+ *        parser sees many partial matches, fed in random chunks
+ */
+static void test_random_bodies( void )
+{
+  static const char alphabet[] = "\r\n-ab";
+  static test_body_t tb;
+  static test_result_t result;
+  static uint8_t content[TEST_PARTS_MAX][256];
+  static const char *chunks[TEST_BODY_MAX];
+  static size_t lens[TEST_BODY_MAX];
+  char name[TEST_PARTS_MAX][8];
+  uint32_t failed = 0;
+  uint32_t parts = 0;
+  uint32_t count = 0;
+  size_t len = 0;
+
+  for( uint32_t run = 0; run < TEST_RANDOM_RUNS; run++ )
+  {
+    test_begin( &tb, "ab", (run % 2u) != 0u );
+    parts = 1u + (test_random() % TEST_PARTS_MAX);
+    for( uint32_t part = 0; part < parts; part++ )
+    {
+      // content must not contain the delimiter itself
+      do
+      {
+        len = test_random() % sizeof(content[part]);
+        for( size_t idx = 0; idx < len; idx++ )
+        {
+          content[part][idx] = (uint8_t)alphabet[test_random() % (sizeof(alphabet) - 1u)];
+        }
+      } while( test_contains( content[part], len, "\r\n--ab" ) );
+      snprintf( name[part], sizeof(name[part]), "p%u", (unsigned)part );
+      test_add( &tb, name[part], content[part], len );
+    }
+    test_end( &tb );
+
+    count = 0;
+    for( size_t pos = 0; pos < tb.len; pos += lens[count++] )
+    {
+      chunks[count] = &tb.body[pos];
+      lens[count] = 1u + (test_random() % 16u);
+      if( lens[count] > (tb.len - pos) )
+      {
+        lens[count] = tb.len - pos;
+      }
+    }
+    test_feed( "multipart/form-data; boundary=ab", chunks, lens, count, &result );
+    if( (result.feed != ESP_OK) || (result.finish != ESP_OK) || !test_match( &tb, &result ) )
+    {
+      failed++;
+    }
+  }
+  printf( "random bodies: %u runs, %u failed\n", (unsigned)TEST_RANDOM_RUNS, (unsigned)failed );
+  CHECK( failed == 0 );
+}
+
+/**
+ * @brief Content-Type without a usable boundary is rejected by init
+ */
+static void test_content_type( void )
+{
+  static multipart_stream_t mp;
+  char too_long[160];
+
+  snprintf( too_long, sizeof(too_long), "multipart/form-data; boundary=%071d", 0 );
+  CHECK( multipart_stream_init( &mp, NULL, test_cb, NULL ) == ESP_ERR_INVALID_ARG );
+  CHECK( multipart_stream_init( &mp, "application/octet-stream", test_cb, NULL ) == ESP_ERR_INVALID_ARG );
+  CHECK( multipart_stream_init( &mp, "multipart/form-data", test_cb, NULL ) == ESP_ERR_INVALID_ARG );
+  CHECK( multipart_stream_init( &mp, "multipart/form-data; boundary=", test_cb, NULL ) == ESP_ERR_INVALID_ARG );
+  CHECK( multipart_stream_init( &mp, too_long, test_cb, NULL ) == ESP_ERR_INVALID_ARG );
+  CHECK( multipart_stream_feed( &mp, "x", 1 ) == ESP_FAIL );
+  CHECK( multipart_stream_init( &mp, "Multipart/Form-Data; charset=utf-8; BOUNDARY=\"a b\"", test_cb, NULL ) == ESP_OK );
+  CHECK( (mp.delim_len == 7u) && (memcmp( mp.delim, "\r\n--a b", 7u ) == 0) );
+}
+
+/**
+ * @brief Every prefix of the body without the closing "--" is truncated
+ */
+static void test_truncated( void )
+{
+  static test_body_t tb;
+  static test_result_t result;
+  const char *chunks[1];
+  size_t lens[1];
+  uint32_t wrong = 0;
+
+  test_begin( &tb, TEST_BOUNDARY, false );
+  test_add( &tb, "file", "\r\n--" TEST_BOUNDARY "-\r\n", 10u );
+  test_end( &tb );
+  chunks[0] = tb.body;
+  for( size_t len = 0; len <= tb.len; len++ )
+  {
+    lens[0] = len;
+    test_feed( TEST_CONTENT_TYPE, chunks, lens, 1, &result );
+    if( (result.feed != ESP_OK) || (result.finish != ((len < tb.end) ? ESP_ERR_INVALID_SIZE : ESP_OK)) )
+    {
+      wrong++;
+    }
+  }
+  CHECK( wrong == 0 );
+}
+
+/**
+ * @brief Garbage after a boundary fails the body, also the later feeds
+ */
+static void test_garbage( void )
+{
+  static test_result_t result;
+  const char *chunks[2] = { "--ab  \t\r\n\r\nok\r\n--ab x\r\n", "\r\n\r\nmore\r\n--ab--" };
+  size_t lens[2] = { strlen( chunks[0] ), strlen( chunks[1] ) };
+
+  test_feed( "multipart/form-data; boundary=ab", chunks, lens, 2, &result );
+  // padding after the first boundary is allowed, "x" is not
+  CHECK( (result.count == 1) && (result.parts[0].len == 2u) && result.parts[0].ended );
+  CHECK( result.feed == ESP_FAIL );
+  CHECK( result.finish == ESP_FAIL );
+
+  chunks[0] = "--ab\r\n\r\nok\r\n--ab-x";
+  lens[0] = strlen( chunks[0] );
+  test_feed( "multipart/form-data; boundary=ab", chunks, lens, 1, &result );
+  CHECK( result.finish == ESP_FAIL );
+  chunks[0] = "--ab\n\r\nok\r\n--ab--";
+  lens[0] = strlen( chunks[0] );
+  test_feed( "multipart/form-data; boundary=ab", chunks, lens, 1, &result );
+  CHECK( result.finish == ESP_FAIL );
+}
+
+/**
+ * @brief Error of the callback aborts the parsing with this error
+ */
+static void test_callback_error( void )
+{
+  static test_result_t result;
+  const char *chunks[2] = { "--ab\r\nContent-Disposition: form-data; name=\"file\"\r\n\r\nimage", "more\r\n--ab--" };
+  size_t lens[2] = { strlen( chunks[0] ), strlen( chunks[1] ) };
+  multipart_stream_t mp;
+
+  memset( &result, 0x00, sizeof(result) );
+  result.fail_with = ESP_ERR_NO_MEM;
+  multipart_stream_init( &mp, "multipart/form-data; boundary=ab", test_cb, &result );
+  CHECK( multipart_stream_feed( &mp, chunks[0], lens[0] ) == ESP_ERR_NO_MEM );
+  CHECK( multipart_stream_feed( &mp, chunks[1], lens[1] ) == ESP_FAIL );
+  CHECK( multipart_stream_finish( &mp ) == ESP_FAIL );
+  CHECK( result.parts[0].len == 0u );
+}
+
+/**
+ * @brief Start a body, the preamble is discarded by the parser, it ends with
+ *        a delimiter prefix
+ * @param tb body
+ * @param boundary boundary
+ * @param padding transport padding after the boundaries
+ */
+static void test_begin( test_body_t *tb, const char *boundary, bool padding )
+{
+  memset( tb, 0x00, sizeof(test_body_t) );
+  tb->boundary = boundary;
+  tb->padding = padding;
+  tb->len = (size_t)sprintf( tb->body, "preamble\r\n-" );
+}
+
+/**
+ * @brief Add a part to the body
+ * @param tb body
+ * @param name form field name
+ * @param content part content
+ * @param len content length
+ */
+static void test_add( test_body_t *tb, const char *name, const void *content, size_t len )
+{
+  tb->len += (size_t)sprintf( &tb->body[tb->len], "\r\n--%s%s\r\nContent-Disposition: form-data; name=\"%s\"%s\r\n" \
+                              "Content-Type: application/octet-stream\r\n\r\n", tb->boundary, tb->padding ? " \t" : "", \
+                              name, (strcmp( name, "file" ) == 0) ? "; filename=\"fw.bin\"" : "" );
+  memcpy( &tb->body[tb->len], content, len );
+  tb->names[tb->count] = name;
+  tb->content[tb->count] = (const uint8_t *)&tb->body[tb->len];
+  tb->content_len[tb->count] = len;
+  tb->len += len;
+  tb->count++;
+}
+
+/**
+ * @brief Close the body, an epilogue follows the closing delimiter
+ * @param tb body
+ */
+static void test_end( test_body_t *tb )
+{
+  tb->len += (size_t)sprintf( &tb->body[tb->len], "\r\n--%s--", tb->boundary );
+  tb->end = tb->len;
+  tb->len += (size_t)sprintf( &tb->body[tb->len], "%s\r\nepilogue\r\n--%s\r\n", tb->padding ? " " : "", tb->boundary );
+}
+
+/**
+ * @brief Parse a body given in chunks
+ * @param content_type Content-Type header
+ * @param chunks chunks of the body
+ * @param lens chunk lengths
+ * @param count number of chunks
+ * @param result output, fail_with is kept
+ */
+static void test_feed( const char *content_type, const char *const *chunks, const size_t *lens, uint32_t count, \
+                       test_result_t *result )
+{
+  multipart_stream_t mp;
+  esp_err_t fail_with = result->fail_with;
+  esp_err_t err = ESP_OK;
+
+  // parts are not cleared, the data is compared only up to len
+  for( uint32_t idx = 0; idx < TEST_PARTS_MAX; idx++ )
+  {
+    result->parts[idx].name[0] = '\0';
+    result->parts[idx].len = 0;
+    result->parts[idx].ended = false;
+  }
+  result->count = 0;
+  result->bad_event = false;
+  result->fail_with = fail_with;
+  result->feed = multipart_stream_init( &mp, content_type, test_cb, result );
+  for( uint32_t idx = 0; idx < count; idx++ )
+  {
+    err = multipart_stream_feed( &mp, chunks[idx], lens[idx] );
+    if( result->feed == ESP_OK )
+    {
+      result->feed = err;
+    }
+  }
+  result->finish = multipart_stream_finish( &mp );
+}
+
+/**
+ * @brief Compare the parsed parts with the parts of the body
+ * @param tb body
+ * @param result parser output
+ * @return true if all the parts are there, complete and byte exact
+ */
+static bool test_match( const test_body_t *tb, const test_result_t *result )
+{
+  if( (result->feed != ESP_OK) || (result->finish != ESP_OK) || result->bad_event || (result->count != tb->count) )
+  {
+    return false;
+  }
+  for( uint32_t idx = 0; idx < tb->count; idx++ )
+  {
+    if( (strcmp( result->parts[idx].name, tb->names[idx] ) != 0) || !result->parts[idx].ended || \
+        (result->parts[idx].len != tb->content_len[idx]) || \
+        (memcmp( result->parts[idx].data, tb->content[idx], tb->content_len[idx] ) != 0) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Part callback, collects the parts in the test result
+ */
+static esp_err_t test_cb( void *ctx, multipart_event_t event, const char *name, const uint8_t *data, size_t len )
+{
+  test_result_t *result = (test_result_t *)ctx;
+  test_part_t *part = NULL;
+
+  if( result == NULL )
+  {
+    return ESP_OK;
+  }
+  if( event == MULTIPART_PART_BEGIN )
+  {
+    if( result->count == TEST_PARTS_MAX )
+    {
+      result->bad_event = true;
+      return ESP_FAIL;
+    }
+    part = &result->parts[result->count++];
+    snprintf( part->name, sizeof(part->name), "%s", name );
+    return ESP_OK;
+  }
+  part = result->count ? &result->parts[result->count - 1u] : NULL;
+  if( (part == NULL) || part->ended || (strcmp( part->name, name ) != 0) )
+  {
+    result->bad_event = true;
+    return ESP_FAIL;
+  }
+  if( event == MULTIPART_PART_END )
+  {
+    part->ended = true;
+    return ESP_OK;
+  }
+  if( (result->fail_with != ESP_OK) && (strcmp( name, "file" ) == 0) )
+  {
+    return result->fail_with;
+  }
+  if( (data == NULL) || (len == 0u) || ((part->len + len) > sizeof(part->data)) )
+  {
+    // empty data calls are not expected either
+    result->bad_event = true;
+    return ESP_FAIL;
+  }
+  memcpy( &part->data[part->len], data, len );
+  part->len += len;
+  return ESP_OK;
+}
+
+/**
+ * @brief Check if the data contains the string
+ */
+static bool test_contains( const uint8_t *data, size_t len, const char *str )
+{
+  size_t str_len = strlen( str );
+
+  for( size_t idx = 0; (idx + str_len) <= len; idx++ )
+  {
+    if( memcmp( &data[idx], str, str_len ) == 0 )
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief xorshift32, the runs are repeatable
+ * @return random number
+ */
+static uint32_t test_random( void )
+{
+  test_random_state ^= test_random_state << 13;
+  test_random_state ^= test_random_state >> 17;
+  test_random_state ^= test_random_state << 5;
+  return test_random_state;
+}
@@ -0,0 +1,68 @@
+/*
+ * multipart_stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Streaming multipart/form-data parser for HTTP uploads. The request body is
+ * fed in chunks as it is received (e.g. from httpd_req_recv) and the content
+ * of every part is given to a callback without the part headers and without
+ * the boundaries, binary content (firmware images) is passed unchanged. The
+ * boundary can be split over chunks, it is matched byte by byte, so there is
+ * no look ahead buffer, the state is a fixed struct of about 250 bytes.
+ *
+ * Usage:
+ *   multipart_stream_init( &mp, content_type_header, on_part, ctx );
+ *   multipart_stream_feed( &mp, chunk, len );  // for every chunk
+ *   if( multipart_stream_finish(&mp) == ESP_OK ) -> closing boundary seen
+ */
+
+#ifndef MULTIPART_STREAM_H_
+#define MULTIPART_STREAM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#define MULTIPART_STREAM_BOUNDARY_MAX   (70u)     // RFC 2046 limit
+#define MULTIPART_STREAM_LINE_MAX       (128u)    // longer header lines are truncated
+#define MULTIPART_STREAM_NAME_MAX       (32u)     // form field name
+
+typedef enum {
+  MULTIPART_PART_BEGIN = 0,             // headers of a part are parsed, name is known
+  MULTIPART_PART_DATA,                  // content of the part, can be called many times
+  MULTIPART_PART_END,                   // boundary after the part is seen
+} multipart_event_t;
+
+/**
+ * @brief Part callback
+ * @param ctx user context given in multipart_stream_init
+ * @param event part event
+ * @param name form field name from Content-Disposition, "" if missing
+ * @param data content for MULTIPART_PART_DATA, else NULL
+ * @param len data length
+ * @return ESP_OK to continue, else parsing is aborted with this error
+ */
+typedef esp_err_t (*multipart_stream_cb_t)( void *ctx, multipart_event_t event, const char *name, const uint8_t *data, size_t len );
+
+typedef struct _multipart_stream_t
+{
+  multipart_stream_cb_t cb;
+  void      *ctx;
+  uint8_t   state;
+  uint8_t   delim_len;
+  uint8_t   match;                      // delimiter characters matched
+  uint8_t   line_len;
+  char      delim[MULTIPART_STREAM_BOUNDARY_MAX + 4u];  // "\r\n--" boundary
+  char      line[MULTIPART_STREAM_LINE_MAX];
+  char      name[MULTIPART_STREAM_NAME_MAX];
+} multipart_stream_t;
+
+// Public Function Prototypes
+esp_err_t multipart_stream_init( multipart_stream_t *mp, const char *content_type, multipart_stream_cb_t cb, void *ctx );
+esp_err_t multipart_stream_feed( multipart_stream_t *mp, const void *data, size_t len );
+esp_err_t multipart_stream_finish( multipart_stream_t *mp );
+
+#endif /* MULTIPART_STREAM_H_ */
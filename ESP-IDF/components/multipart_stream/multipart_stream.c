@@ -0,0 +1,354 @@
+/*
+ * multipart_stream.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <strings.h>
+
+#include "multipart_stream.h"
+
+// Private Macros
+#define MULTIPART_CRLF_LEN              (2u)      // "\r\n" in front of the delimiter
+
+typedef enum {
+  MULTIPART_ST_PREAMBLE = 0,            // before the first boundary, discarded
+  MULTIPART_ST_AFTER_DELIM,             // after boundary, "--" ends the body, CRLF starts a part
+  MULTIPART_ST_CLOSE,                   // after first '-' of the closing "--"
+  MULTIPART_ST_LF,                      // after '\r' of the line following the boundary
+  MULTIPART_ST_HEADERS,
+  MULTIPART_ST_BODY,
+  MULTIPART_ST_DONE,                    // epilogue, discarded
+  MULTIPART_ST_ERROR,
+} multipart_state_t;
+
+// Private Function Declaration
+static size_t multipart_stream_content( multipart_stream_t *mp, const uint8_t *data, size_t len, esp_err_t *err );
+static esp_err_t multipart_stream_header( multipart_stream_t *mp );
+static esp_err_t multipart_stream_emit( multipart_stream_t *mp, const void *data, size_t len );
+static bool multipart_stream_boundary( const char *content_type, const char **boundary, size_t *len );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the parser for a new request body
+ * @param mp parser
+ * @param content_type value of the Content-Type header with the boundary
+ * @param cb part callback
+ * @param ctx user context for the callback
+ * @return ESP_OK, ESP_ERR_INVALID_ARG if not multipart or boundary is invalid
+ */
+esp_err_t multipart_stream_init( multipart_stream_t *mp, const char *content_type, multipart_stream_cb_t cb, void *ctx )
+{
+  const char *boundary = NULL;
+  size_t len = 0;
+
+  memset( mp, 0x00, sizeof(multipart_stream_t) );
+  mp->state = MULTIPART_ST_ERROR;
+  if( (content_type == NULL) || (strncasecmp(content_type, "multipart/", 10u) != 0) || \
+      (multipart_stream_boundary(content_type, &boundary, &len) == false) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  mp->cb = cb;
+  mp->ctx = ctx;
+  memcpy( mp->delim, "\r\n--", 4u );
+  memcpy( &mp->delim[4], boundary, len );
+  mp->delim_len = (uint8_t)(len + 4u);
+  // first boundary has no line break in front, act as if it is already matched
+  mp->match = MULTIPART_CRLF_LEN;
+  mp->state = MULTIPART_ST_PREAMBLE;
+  return ESP_OK;
+}
+
+/**
+ * @brief Feed the next chunk of the request body
+ * @param mp parser
+ * @param data chunk
+ * @param len chunk length
+ * @return ESP_OK, error of the callback or ESP_FAIL if body is not valid
+ *         multipart (stays failed)
+ */
+esp_err_t multipart_stream_feed( multipart_stream_t *mp, const void *data, size_t len )
+{
+  const uint8_t *bytes = (const uint8_t*)data;
+  esp_err_t err = ESP_OK;
+  size_t idx = 0;
+  char c;
+
+  while( (idx < len) && (err == ESP_OK) )
+  {
+    switch( mp->state )
+    {
+    case MULTIPART_ST_PREAMBLE:
+    case MULTIPART_ST_BODY:
+      idx += multipart_stream_content( mp, &bytes[idx], len - idx, &err );
+      continue;
+    case MULTIPART_ST_DONE:
+      return ESP_OK;
+    case MULTIPART_ST_ERROR:
+      return ESP_FAIL;
+    default:
+      break;
+    }
+
+    c = (char)bytes[idx++];
+    switch( mp->state )
+    {
+    case MULTIPART_ST_AFTER_DELIM:
+      if( c == '-' )
+      {
+        mp->state = MULTIPART_ST_CLOSE;
+      }
+      else if( c == '\r' )
+      {
+        mp->state = MULTIPART_ST_LF;
+      }
+      else if( (c != ' ') && (c != '\t') )
+      {
+        // only transport padding is allowed after the boundary
+        err = ESP_FAIL;
+      }
+      break;
+    case MULTIPART_ST_CLOSE:
+      if( c == '-' )
+      {
+        mp->state = MULTIPART_ST_DONE;
+      }
+      else
+      {
+        err = ESP_FAIL;
+      }
+      break;
+    case MULTIPART_ST_LF:
+      if( c == '\n' )
+      {
+        mp->state = MULTIPART_ST_HEADERS;
+        mp->line_len = 0u;
+        mp->name[0] = '\0';
+      }
+      else
+      {
+        err = ESP_FAIL;
+      }
+      break;
+    case MULTIPART_ST_HEADERS:
+      if( c == '\n' )
+      {
+        err = multipart_stream_header( mp );
+        mp->line_len = 0u;
+      }
+      else if( (c != '\r') && (mp->line_len < (MULTIPART_STREAM_LINE_MAX - 1u)) )
+      {
+        mp->line[mp->line_len++] = c;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  if( err != ESP_OK )
+  {
+    mp->state = MULTIPART_ST_ERROR;
+  }
+  return err;
+}
+
+/**
+ * @brief End of request body
+ * @param mp parser
+ * @return ESP_OK if the closing boundary is seen, ESP_ERR_INVALID_SIZE if body
+ *         is truncated, ESP_FAIL if not valid multipart
+ */
+esp_err_t multipart_stream_finish( multipart_stream_t *mp )
+{
+  if( mp->state == MULTIPART_ST_ERROR )
+  {
+    return ESP_FAIL;
+  }
+  return (mp->state == MULTIPART_ST_DONE) ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Matches the delimiter in preamble or part content, the content before
+ *        it is given to the callback. A partly matched delimiter at the end of
+ *        a chunk is kept as match count only, boundary has no CR, so if the
+ *        match fails the matched characters are the delimiter prefix.
+ * @param mp parser
+ * @param data rest of the chunk
+ * @param len rest length
+ * @param err callback error
+ * @return number of bytes consumed
+ */
+static size_t multipart_stream_content( multipart_stream_t *mp, const uint8_t *data, size_t len, esp_err_t *err )
+{
+  bool body = (mp->state == MULTIPART_ST_BODY);
+  bool carried = (mp->match != 0u);     // match started in a previous chunk
+  size_t run = 0;                       // start of content not given to callback
+  size_t match_at = 0;                  // start of the match in this chunk
+  size_t idx;
+
+  for( idx = 0; idx < len; idx++ )
+  {
+    if( data[idx] == (uint8_t)mp->delim[mp->match] )
+    {
+      if( mp->match == 0u )
+      {
+        match_at = idx;
+        carried = false;
+      }
+      mp->match++;
+      if( mp->match == mp->delim_len )
+      {
+        // carried match means the chunk starts with the delimiter
+        if( body && !carried && (match_at > run) )
+        {
+          *err = multipart_stream_emit( mp, &data[run], match_at - run );
+        }
+        if( body && (*err == ESP_OK) )
+        {
+          *err = mp->cb( mp->ctx, MULTIPART_PART_END, mp->name, NULL, 0 );
+        }
+        mp->match = 0u;
+        mp->state = MULTIPART_ST_AFTER_DELIM;
+        return idx + 1u;
+      }
+      continue;
+    }
+
+    if( mp->match != 0u )
+    {
+      // characters matched in previous chunks are content, before this chunk
+      if( body && carried )
+      {
+        *err = multipart_stream_emit( mp, mp->delim, mp->match - idx );
+        if( *err != ESP_OK )
+        {
+          return idx;
+        }
+      }
+      carried = false;
+      mp->match = 0u;
+    }
+    if( data[idx] == (uint8_t)mp->delim[0] )
+    {
+      match_at = idx;
+      mp->match = 1u;
+    }
+  }
+
+  // content up to a started match, the match is carried to the next chunk
+  if( body )
+  {
+    idx = (mp->match == 0u) ? len : (carried ? run : match_at);
+    if( idx > run )
+    {
+      *err = multipart_stream_emit( mp, &data[run], idx - run );
+    }
+  }
+  return len;
+}
+
+/**
+ * @brief Process a part header line, the empty line starts the content
+ * @param mp parser
+ * @return ESP_OK or error of the callback
+ */
+static esp_err_t multipart_stream_header( multipart_stream_t *mp )
+{
+  const char *name;
+  size_t len = 0;
+
+  mp->line[mp->line_len] = '\0';
+  if( mp->line_len == 0u )
+  {
+    mp->state = MULTIPART_ST_BODY;
+    return mp->cb( mp->ctx, MULTIPART_PART_BEGIN, mp->name, NULL, 0 );
+  }
+
+  if( strncasecmp(mp->line, "Content-Disposition:", 20u) == 0 )
+  {
+    // name parameter, filename="..." also contains name=
+    name = mp->line;
+    while( (name = strstr(name + 1, "name=\"")) != NULL )
+    {
+      if( (name[-1] == ' ') || (name[-1] == ';') )
+      {
+        name += 6;
+        while( name[len] && (name[len] != '"') && (len < (MULTIPART_STREAM_NAME_MAX - 1u)) )
+        {
+          len++;
+        }
+        memcpy( mp->name, name, len );
+        mp->name[len] = '\0';
+        break;
+      }
+    }
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Give part content to the callback
+ * @param mp parser
+ * @param data content
+ * @param len content length
+ * @return ESP_OK or error of the callback
+ */
+static esp_err_t multipart_stream_emit( multipart_stream_t *mp, const void *data, size_t len )
+{
+  return mp->cb( mp->ctx, MULTIPART_PART_DATA, mp->name, (const uint8_t*)data, len );
+}
+
+/**
+ * @brief Find the boundary parameter of the Content-Type header
+ * @param content_type header value
+ * @param boundary start of the boundary
+ * @param len boundary length
+ * @return true if the boundary is found and valid
+ */
+static bool multipart_stream_boundary( const char *content_type, const char **boundary, size_t *len )
+{
+  const char *start = content_type;
+  size_t size = 0;
+
+  // parameter names are case insensitive
+  while( *start && (strncasecmp(start, "boundary=", 9u) != 0) )
+  {
+    start++;
+  }
+  if( *start == '\0' )
+  {
+    return false;
+  }
+  start += 9;
+  if( *start == '"' )
+  {
+    start++;
+    while( start[size] && (start[size] != '"') )
+    {
+      size++;
+    }
+  }
+  else
+  {
+    while( start[size] && (start[size] != ';') && (start[size] != ' ') )
+    {
+      size++;
+    }
+  }
+
+  // CR in the boundary would break the delimiter matching
+  if( (size == 0u) || (size > MULTIPART_STREAM_BOUNDARY_MAX) || memchr(start, '\r', size) )
+  {
+    return false;
+  }
+  *boundary = start;
+  *len = size;
+  return true;
+}
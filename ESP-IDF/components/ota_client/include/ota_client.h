@@ -0,0 +1,81 @@
+/*
+ * ota_client.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Pull firmware update from a URL, the image is downloaded with Range requests
+ * of CONFIG_OTA_CLIENT_CHUNK_KB on a keep-alive client of the http_pool (so
+ * https shares its TLS session handling) and written by the ota_writer. After
+ * every request the flash offset written so far is saved to NVS, a lost
+ * connection is retried from the last received byte and after a reset the
+ * download resumes at the last saved sector. If-Range with the ETag (or
+ * Last-Modified) of the first response makes the server send the whole image
+ * again if it has changed meanwhile, the download then starts over.
+ *
+ * A new download first requests only the image header and the application
+ * description, an image with the same ELF SHA-256 as the running firmware
+ * isn't downloaded. Compressed images (<project>.bin.zz of the ota_writer)
+ * are inflated while downloading, the first request then gets 1 KB which
+ * inflates to the header. A lost connection continues such a download at the
+ * last received byte too, but after a reset it starts over, only plain images
+ * (.bin) are resumed from NVS. Servers without Range support work too, but
+ * the download can't be resumed.
+ *
+ * Usage, in a task with enough stack for TLS:
+ *   ota_client_config_t config = OTA_CLIENT_CONFIG_DEFAULT();
+ *   config.url = "https://example.com/firmware.bin";
+ *   if( ota_client_update(&config) == ESP_OK ) esp_restart();
+ */
+
+#ifndef OTA_CLIENT_H_
+#define OTA_CLIENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "ota_writer.h"
+
+#define OTA_CLIENT_URL_MAX              (192u)
+#define OTA_CLIENT_VALIDATOR_MAX        (64u)     // ETag or Last-Modified
+
+typedef struct _ota_client_config_t
+{
+  const char *url;                      // image URL, http or https
+  const char *sha256;                   // expected SHA-256 of the image as hex, NULL if not known
+  bool      force;                      // download even if it is the running firmware
+  ota_writer_progress_t progress_cb;    // can be NULL, written includes resumed bytes
+  void      *ctx;
+  uint32_t  task_stack;                 // OTA writer task
+  UBaseType_t task_priority;
+} ota_client_config_t;
+
+typedef struct _ota_client_stats_t
+{
+  uint32_t  requests;                   // Range requests of the last update
+  uint32_t  retries;                    // requests repeated after a lost connection
+  uint32_t  restarts;                   // downloads started over, image changed on server
+  size_t    resumed_at;                 // image offset the download continued at
+  size_t    downloaded;                 // image bytes received
+  bool      compressed;                 // image is compressed, not resumed after a reset
+} ota_client_stats_t;
+
+#define OTA_CLIENT_CONFIG_DEFAULT()     \
+{                                       \
+  .url = NULL,                          \
+  .sha256 = NULL,                       \
+  .force = false,                       \
+  .progress_cb = NULL,                  \
+  .ctx = NULL,                          \
+  .task_stack = 4096,                   \
+  .task_priority = 5,                   \
+}
+
+// Public Function Prototypes
+esp_err_t ota_client_update( const ota_client_config_t *config );
+bool ota_client_is_pending( void );
+void ota_client_clear( void );
+void ota_client_get_stats( ota_client_stats_t *stats );
+
+#endif /* OTA_CLIENT_H_ */
@@ -0,0 +1,599 @@
+/*
+ * ota_client.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <sys/param.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_http_client.h"
+#include "nvs.h"
+
+#include "http_pool.h"
+#include "ota_client.h"
+
+// Private Macros
+#define OTA_CLIENT_NVS_NAMESPACE        "ota_client"
+#define OTA_CLIENT_NVS_STATE            "state"
+#define OTA_CLIENT_STATE_VERSION        (1u)
+#define OTA_CLIENT_CHUNK_SIZE           ((CONFIG_OTA_CLIENT_CHUNK_KB * 1024u) & ~(OTA_WRITER_SECTOR_SIZE - 1u))
+#define OTA_CLIENT_RECV_SIZE            (2048u)
+#define OTA_CLIENT_RANGE_MAX            (32u)     // "bytes=<start>-<end>"
+// connection lost or timed out, the request can be repeated
+#define OTA_CLIENT_ERR_TRANSPORT        ESP_ERR_TIMEOUT
+// image on the server is not the one of the saved progress
+#define OTA_CLIENT_ERR_CHANGED          ESP_ERR_INVALID_STATE
+
+// download progress, saved in NVS
+typedef struct _ota_client_state_t
+{
+  uint8_t   version;
+  uint32_t  partition;                  // address of the update partition
+  uint32_t  image_size;                 // 0 until the first response
+  uint32_t  offset;                     // image bytes in flash, sector aligned
+  char      url[OTA_CLIENT_URL_MAX];
+  char      validator[OTA_CLIENT_VALIDATOR_MAX];  // for If-Range
+} ota_client_state_t;
+
+typedef struct _ota_client_t
+{
+  ota_client_state_t state;
+  const ota_client_config_t *config;
+  const esp_partition_t *partition;
+  ota_writer_t  writer;
+  bool      writing;                    // writer is begun
+  bool      resumable;                  // server answers Range requests
+  bool      compressed;                 // image is a zlib stream, not resumed after a reset
+  size_t    received;                   // image offset of the next byte from the server
+  // headers of the current response
+  bool      range_valid;
+  size_t    range_start;
+  size_t    range_total;
+  char      etag[OTA_CLIENT_VALIDATOR_MAX];
+  char      last_modified[OTA_CLIENT_VALIDATOR_MAX];
+} ota_client_t;
+
+// Private Variables
+static const char *TAG = "OTA Client";
+static ota_client_stats_t ota_client_stats = { 0 };
+
+// Private Function Declaration
+static esp_err_t ota_client_request( ota_client_t *dl, esp_http_client_handle_t client, char *buffer );
+static esp_err_t ota_client_response( ota_client_t *dl, esp_http_client_handle_t client, int64_t content_len );
+static esp_err_t ota_client_start( ota_client_t *dl, const uint8_t *data, size_t len );
+static esp_err_t ota_client_event_handler( esp_http_client_event_t *evt );
+static void ota_client_restart( ota_client_t *dl );
+static void ota_client_save( ota_client_t *dl );
+static bool ota_client_load( ota_client_state_t *state );
+static void ota_client_store( const ota_client_state_t *state );
+
+// Public Function Definition
+
+/**
+ * @brief Download the image from the URL and set it as boot partition, a
+ *        download of the same URL interrupted before is resumed. Blocks until
+ *        the download ends, call it from a task with enough stack for TLS.
+ * @param config client configuration
+ * @return ESP_OK if the image becomes active after restart,
+ *         ESP_ERR_INVALID_VERSION if the server image is the running one,
+ *         ESP_ERR_TIMEOUT if the connection failed CONFIG_OTA_CLIENT_RETRIES
+ *         times in a row (progress is kept), ESP_ERR_NOT_SUPPORTED if not an
+ *         application image, ESP_ERR_INVALID_RESPONSE for HTTP errors, else
+ *         the error of the ota_writer
+ */
+esp_err_t ota_client_update( const ota_client_config_t *config )
+{
+  esp_http_client_config_t http_config = { 0 };
+  esp_http_client_handle_t client = NULL;
+  ota_client_t *dl = NULL;
+  uint8_t sha256[OTA_WRITER_SHA256_LEN];
+  char *buffer = NULL;
+  size_t progress;
+  uint8_t retries = 0;
+  esp_err_t err = ESP_OK;
+
+  memset( &ota_client_stats, 0x00, sizeof(ota_client_stats) );
+  if( (config->url == NULL) || (strlen(config->url) >= OTA_CLIENT_URL_MAX) || \
+      (config->sha256 && (ota_writer_sha256_parse(config->sha256, sha256) != ESP_OK)) )
+  {
+    ESP_LOGE(TAG, "Invalid URL or SHA-256");
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  dl = calloc( 1, sizeof(ota_client_t) );
+  buffer = malloc( OTA_CLIENT_RECV_SIZE );
+  if( (dl == NULL) || (buffer == NULL) )
+  {
+    free( dl );
+    free( buffer );
+    return ESP_ERR_NO_MEM;
+  }
+  dl->config = config;
+  dl->partition = esp_ota_get_next_update_partition( NULL );
+  if( dl->partition == NULL )
+  {
+    ESP_LOGE(TAG, "No update partition");
+    err = ESP_ERR_NOT_FOUND;
+  }
+
+  // progress of another URL or partition is of no use, a complete image
+  // which wasn't finished is downloaded again
+  if( (err == ESP_OK) && ota_client_load(&dl->state) && dl->state.offset && \
+      (dl->state.offset < dl->state.image_size) && (dl->state.partition == dl->partition->address) && \
+      (strcmp(dl->state.url, config->url) == 0) )
+  {
+    dl->received = dl->state.offset;
+    ota_client_stats.resumed_at = dl->received;
+    ESP_LOGI(TAG, "Resuming download at %u of %" PRIu32 " bytes", (unsigned)dl->received, dl->state.image_size);
+  }
+  else if( err == ESP_OK )
+  {
+    memset( &dl->state, 0x00, sizeof(ota_client_state_t) );
+    dl->state.version = OTA_CLIENT_STATE_VERSION;
+    dl->state.partition = dl->partition->address;
+    strlcpy( dl->state.url, config->url, sizeof(dl->state.url) );
+  }
+
+  if( err == ESP_OK )
+  {
+    http_config.url = config->url;
+    http_config.method = HTTP_METHOD_GET;
+    http_config.timeout_ms = CONFIG_OTA_CLIENT_TIMEOUT_MS;
+    http_config.event_handler = ota_client_event_handler;
+    http_config.user_data = dl;
+    client = http_pool_acquire( &http_config );
+    err = (client != NULL) ? ESP_OK : ESP_ERR_NO_MEM;
+  }
+
+  while( (err == ESP_OK) && ((dl->state.image_size == 0u) || (dl->received < dl->state.image_size)) )
+  {
+    progress = dl->received;
+    err = ota_client_request( dl, client, buffer );
+    if( err == ESP_OK )
+    {
+      retries = 0;
+      ota_client_save( dl );
+    }
+    else if( err == OTA_CLIENT_ERR_TRANSPORT )
+    {
+      // continue at the last received byte on a new connection
+      esp_http_client_close( client );
+      ota_client_save( dl );
+      retries = (dl->received != progress) ? 1u : (retries + 1u);
+      if( retries <= CONFIG_OTA_CLIENT_RETRIES )
+      {
+        ESP_LOGW(TAG, "Connection lost at %u, retry %u", (unsigned)dl->received, retries);
+        ota_client_stats.retries++;
+        vTaskDelay( pdMS_TO_TICKS(CONFIG_OTA_CLIENT_RETRY_MS * retries) );
+        err = ESP_OK;
+      }
+    }
+    else if( (err == OTA_CLIENT_ERR_CHANGED) && (ota_client_stats.restarts == 0u) )
+    {
+      // response body is not read, so the connection can't be reused
+      esp_http_client_close( client );
+      ota_client_restart( dl );
+      err = ESP_OK;
+    }
+  }
+  if( client != NULL )
+  {
+    // body of a failed request may be unread, the connection is not reused
+    if( err != ESP_OK )
+    {
+      esp_http_client_close( client );
+    }
+    http_pool_release( client );
+  }
+  free( buffer );
+
+  if( dl->writing )
+  {
+    if( err == ESP_OK )
+    {
+      err = ota_writer_finish( &dl->writer, config->sha256 ? sha256 : NULL );
+    }
+    else
+    {
+      ota_writer_abort( &dl->writer );
+    }
+  }
+
+  // a wrong image is downloaded again from the begin, else the flash
+  // written so far is kept for the next update
+  if( (err == ESP_OK) || (err == ESP_ERR_INVALID_VERSION) || (err == ESP_ERR_INVALID_CRC) || \
+      (err == ESP_ERR_OTA_VALIDATE_FAILED) || (err == ESP_ERR_NOT_SUPPORTED) )
+  {
+    ota_client_clear();
+  }
+  else if( dl->writing )
+  {
+    ota_client_save( dl );
+  }
+
+  if( err == ESP_OK )
+  {
+    ESP_LOGI(TAG, "Update downloaded, %" PRIu32 " requests, %" PRIu32 " retries", ota_client_stats.requests, \
+             ota_client_stats.retries);
+  }
+  else if( err == ESP_ERR_INVALID_VERSION )
+  {
+    ESP_LOGI(TAG, "Firmware is up to date");
+  }
+  else
+  {
+    ESP_LOGE(TAG, "Update failed at %u bytes, %s", (unsigned)dl->received, esp_err_to_name(err));
+  }
+  free( dl );
+  return err;
+}
+
+/**
+ * @brief Tells if an interrupted download is saved, it is resumed by the next
+ *        ota_client_update with the same URL
+ * @param  none
+ * @return true if a download is pending
+ */
+bool ota_client_is_pending( void )
+{
+  ota_client_state_t state;
+
+  return ota_client_load( &state ) && (state.offset != 0u);
+}
+
+/**
+ * @brief Forget the saved download, call it when the update partition is
+ *        written by something else (e.g. the web page upload)
+ * @param  none
+ */
+void ota_client_clear( void )
+{
+  ota_client_state_t state = { 0 };
+
+  // periodic checks of an up to date firmware don't write the flash
+  if( ota_client_load(&state) && (state.image_size == 0u) )
+  {
+    return;
+  }
+  memset( &state, 0x00, sizeof(state) );
+  state.version = OTA_CLIENT_STATE_VERSION;
+  ota_client_store( &state );
+}
+
+/**
+ * @brief Get the statistics of the last update
+ * @param stats statistics output
+ */
+void ota_client_get_stats( ota_client_stats_t *stats )
+{
+  *stats = ota_client_stats;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Request the next range of the image and give it to the writer. The
+ *        first request of a new download gets only the image header (or the
+ *        start of a compressed image, which inflates to it), it is checked
+ *        before the writer begins, the others end at a chunk border.
+ * @param dl download
+ * @param client pooled HTTP client
+ * @param buffer receive buffer, OTA_CLIENT_RECV_SIZE
+ * @return ESP_OK, OTA_CLIENT_ERR_TRANSPORT, OTA_CLIENT_ERR_CHANGED, else error
+ *         of the response check, start or writer
+ */
+static esp_err_t ota_client_request( ota_client_t *dl, esp_http_client_handle_t client, char *buffer )
+{
+  char range[OTA_CLIENT_RANGE_MAX];
+  size_t end = ((dl->received / OTA_CLIENT_CHUNK_SIZE) + 1u) * OTA_CLIENT_CHUNK_SIZE;
+  size_t have = 0;
+  int64_t remaining;
+  int len;
+  esp_err_t err = ESP_OK;
+
+  if( dl->received == 0u )
+  {
+    end = OTA_WRITER_COMPRESSED_CHECK_LEN;
+  }
+  if( dl->state.image_size && (end > dl->state.image_size) )
+  {
+    end = dl->state.image_size;
+  }
+  snprintf( range, sizeof(range), "bytes=%u-%u", (unsigned)dl->received, (unsigned)(end - 1u) );
+  esp_http_client_set_header( client, "Range", range );
+  // server sends the whole image (200) if it is not the one of the first response
+  if( dl->received && dl->state.validator[0] )
+  {
+    esp_http_client_set_header( client, "If-Range", dl->state.validator );
+  }
+  else
+  {
+    esp_http_client_delete_header( client, "If-Range" );
+  }
+
+  dl->range_valid = false;
+  dl->etag[0] = '\0';
+  dl->last_modified[0] = '\0';
+  ota_client_stats.requests++;
+  if( esp_http_client_open(client, 0) != ESP_OK )
+  {
+    return OTA_CLIENT_ERR_TRANSPORT;
+  }
+  remaining = esp_http_client_fetch_headers( client );
+  if( remaining < 0 )
+  {
+    return OTA_CLIENT_ERR_TRANSPORT;
+  }
+  err = ota_client_response( dl, client, remaining );
+
+  while( (err == ESP_OK) && (remaining > 0) )
+  {
+    len = esp_http_client_read( client, &buffer[have], (int)MIN(remaining, (int64_t)(OTA_CLIENT_RECV_SIZE - have)) );
+    if( len <= 0 )
+    {
+      // data of the incomplete image header is requested again
+      return OTA_CLIENT_ERR_TRANSPORT;
+    }
+    have += (size_t)len;
+    remaining -= len;
+    if( dl->writing == false )
+    {
+      if( (dl->received == 0u) && (have < OTA_WRITER_COMPRESSED_CHECK_LEN) && remaining )
+      {
+        continue;
+      }
+      err = ota_client_start( dl, (const uint8_t*)buffer, have );
+    }
+    if( err == ESP_OK )
+    {
+      err = ota_writer_write( &dl->writer, buffer, have );
+    }
+    if( err == ESP_OK )
+    {
+      dl->received += have;
+      ota_client_stats.downloaded += have;
+    }
+    have = 0;
+  }
+  return err;
+}
+
+/**
+ * @brief Check the response headers, the first response gives the image size
+ *        and the validator of the image
+ * @param dl download
+ * @param client pooled HTTP client
+ * @param content_len body length
+ * @return ESP_OK, OTA_CLIENT_ERR_CHANGED if the image on the server has
+ *         changed, ESP_ERR_INVALID_SIZE if it doesn't fit in the partition,
+ *         ESP_ERR_INVALID_RESPONSE for an unexpected status or range
+ */
+static esp_err_t ota_client_response( ota_client_t *dl, esp_http_client_handle_t client, int64_t content_len )
+{
+  int status = esp_http_client_get_status_code( client );
+
+  if( status == 200 )
+  {
+    // no range support, or If-Range didn't match
+    if( dl->received )
+    {
+      ESP_LOGW(TAG, "Image on server has changed, download starts over");
+      return OTA_CLIENT_ERR_CHANGED;
+    }
+    dl->resumable = false;
+    dl->range_valid = (content_len > 0);
+    dl->range_start = 0;
+    dl->range_total = (size_t)content_len;
+    ESP_LOGW(TAG, "Server doesn't support Range requests, download can't be resumed");
+  }
+  else if( status != 206 )
+  {
+    ESP_LOGE(TAG, "HTTP status %d", status);
+    return (status == 416) ? OTA_CLIENT_ERR_CHANGED : ESP_ERR_INVALID_RESPONSE;
+  }
+
+  else
+  {
+    dl->resumable = true;
+  }
+
+  if( (dl->range_valid == false) || (dl->range_start != dl->received) || (dl->range_total == 0u) )
+  {
+    ESP_LOGE(TAG, "Unexpected range %u of %u, requested %u", (unsigned)dl->range_start, (unsigned)dl->range_total, \
+             (unsigned)dl->received);
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  if( dl->state.image_size == 0u )
+  {
+    if( dl->range_total > dl->partition->size )
+    {
+      ESP_LOGE(TAG, "Image of %u bytes doesn't fit in partition %s", (unsigned)dl->range_total, dl->partition->label);
+      return ESP_ERR_INVALID_SIZE;
+    }
+    dl->state.image_size = dl->range_total;
+    strlcpy( dl->state.validator, dl->etag[0] ? dl->etag : dl->last_modified, sizeof(dl->state.validator) );
+    ESP_LOGI(TAG, "Image of %u bytes, validator %s", (unsigned)dl->range_total, dl->state.validator);
+  }
+  else if( dl->range_total != dl->state.image_size )
+  {
+    ESP_LOGW(TAG, "Image size on server has changed, download starts over");
+    return OTA_CLIENT_ERR_CHANGED;
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Begin the writer with the first received data, a new download is
+ *        checked to be an application image other than the running one. A
+ *        compressed image is inflated by the writer, its flash offset isn't
+ *        one of the download, so its progress is not saved.
+ * @param dl download
+ * @param data first data, the image header for a new download
+ * @param len data length
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED if not an application image,
+ *         ESP_ERR_INVALID_VERSION if it is the running one, else the error of
+ *         ota_writer_begin
+ */
+static esp_err_t ota_client_start( ota_client_t *dl, const uint8_t *data, size_t len )
+{
+  ota_writer_config_t config = OTA_WRITER_CONFIG_DEFAULT();
+  esp_err_t err;
+
+  if( dl->received == 0u )
+  {
+    err = ota_writer_check_image( data, len, dl->config->force );
+    if( err != ESP_OK )
+    {
+      return err;
+    }
+    dl->compressed = ota_writer_is_compressed( data, len );
+    ota_client_stats.compressed = dl->compressed;
+    if( dl->compressed )
+    {
+      ESP_LOGI(TAG, "Compressed image, the download starts over after a reset");
+    }
+  }
+
+  config.partition = dl->partition;
+  config.image_size = dl->state.image_size;
+  config.offset = dl->received;
+  config.progress_cb = dl->config->progress_cb;
+  config.ctx = dl->config->ctx;
+  config.task_stack = dl->config->task_stack;
+  config.task_priority = dl->config->task_priority;
+  err = ota_writer_begin( &dl->writer, &config );
+  if( err == ESP_OK )
+  {
+    dl->writing = true;
+  }
+  return err;
+}
+
+/**
+ * @brief HTTP Client Event Handler, gets the range and validator of the
+ *        response
+ * @param evt event data
+ * @return ESP_OK
+ */
+static esp_err_t ota_client_event_handler( esp_http_client_event_t *evt )
+{
+  ota_client_t *dl = (ota_client_t*)evt->user_data;
+  unsigned int start, end, total;
+
+  if( evt->event_id != HTTP_EVENT_ON_HEADER )
+  {
+    return ESP_OK;
+  }
+  if( strcasecmp(evt->header_key, "Content-Range") == 0 )
+  {
+    // bytes <start>-<end>/<total>, the total is needed
+    if( sscanf(evt->header_value, "bytes %u-%u/%u", &start, &end, &total) == 3 )
+    {
+      dl->range_valid = true;
+      dl->range_start = start;
+      dl->range_total = total;
+    }
+  }
+  else if( strcasecmp(evt->header_key, "ETag") == 0 )
+  {
+    strlcpy( dl->etag, evt->header_value, sizeof(dl->etag) );
+  }
+  else if( strcasecmp(evt->header_key, "Last-Modified") == 0 )
+  {
+    strlcpy( dl->last_modified, evt->header_value, sizeof(dl->last_modified) );
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Start the download over, the image on the server has changed
+ * @param dl download
+ */
+static void ota_client_restart( ota_client_t *dl )
+{
+  if( dl->writing )
+  {
+    ota_writer_abort( &dl->writer );
+    dl->writing = false;
+  }
+  dl->received = 0;
+  dl->state.image_size = 0;
+  dl->state.offset = 0;
+  dl->state.validator[0] = '\0';
+  ota_client_store( &dl->state );
+  ota_client_stats.restarts++;
+}
+
+/**
+ * @brief Save the progress, the image offset in flash aligned down to a
+ *        sector, the writer may still hold the last received data. Nothing
+ *        is saved if the server doesn't support Range requests or the image
+ *        is compressed (the inflate state is lost with a reset).
+ * @param dl download
+ */
+static void ota_client_save( ota_client_t *dl )
+{
+  uint32_t offset;
+
+  if( (dl->writing == false) || (dl->resumable == false) || dl->compressed )
+  {
+    return;
+  }
+  offset = (uint32_t)(dl->writer.written & ~(OTA_WRITER_SECTOR_SIZE - 1u));
+  if( offset != dl->state.offset )
+  {
+    dl->state.offset = offset;
+    ota_client_store( &dl->state );
+  }
+}
+
+/**
+ * @brief Load the saved download
+ * @param state state output
+ * @return true if a valid state is saved
+ */
+static bool ota_client_load( ota_client_state_t *state )
+{
+  nvs_handle_t nvs;
+  size_t size = sizeof(ota_client_state_t);
+  esp_err_t err = nvs_open( OTA_CLIENT_NVS_NAMESPACE, NVS_READONLY, &nvs );
+
+  if( err == ESP_OK )
+  {
+    err = nvs_get_blob( nvs, OTA_CLIENT_NVS_STATE, state, &size );
+    nvs_close( nvs );
+  }
+  return (err == ESP_OK) && (size == sizeof(ota_client_state_t)) && (state->version == OTA_CLIENT_STATE_VERSION);
+}
+
+/**
+ * @brief Save the download state
+ * @param state state to save
+ */
+static void ota_client_store( const ota_client_state_t *state )
+{
+  nvs_handle_t nvs;
+  esp_err_t err = nvs_open( OTA_CLIENT_NVS_NAMESPACE, NVS_READWRITE, &nvs );
+
+  if( err == ESP_OK )
+  {
+    err = nvs_set_blob( nvs, OTA_CLIENT_NVS_STATE, state, sizeof(ota_client_state_t) );
+    if( err == ESP_OK )
+    {
+      err = nvs_commit( nvs );
+    }
+    nvs_close( nvs );
+  }
+  if( err != ESP_OK )
+  {
+    ESP_LOGW(TAG, "Saving progress failed, %s", esp_err_to_name(err));
+  }
+}
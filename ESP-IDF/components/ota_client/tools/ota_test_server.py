@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""
+ota_test_server.py
+
+ Created on: Oct 19, 2026
+     Author: xpress_embedo
+
+Host side image server for the ota_client component. It serves one firmware
+image with Range, If-Range and ETag support on keep-alive connections and
+injects faults, so the resume of the client can be watched on the device log:
+connections are dropped in the middle of a response, responses are stalled
+until the client times out, and the image can be "changed" (new ETag) while
+the download runs. The SHA-256 to configure on the device is printed at start.
+
+  python ota_test_server.py build/WeatherStationServer.bin --port 8070
+  python ota_test_server.py app.bin --drop 0.2 --stall 0.05     # flaky network
+  python ota_test_server.py app.bin --change-after 300000       # new ETag after 300 kB
+  python ota_test_server.py app.bin --no-range                 # server without Range support
+"""
+import argparse
+import hashlib
+import http.server
+import random
+import re
+import socketserver
+import time
+
+RANGE = re.compile(r'^bytes=(\d+)-(\d*)$')
+
+
+class Image:
+    """ Served image and the fault statistics """
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        self.version = 1
+        self.sent = 0
+        self.requests = 0
+        self.dropped = 0
+        self.stalled = 0
+
+    @property
+    def etag(self):
+        return '"{}-{}"'.format(hashlib.sha256(self.data).hexdigest()[:16], self.version)
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'      # keep-alive, the client reuses the connection
+
+    def do_GET(self):
+        args, image = self.server.args, self.server.image
+        image.requests += 1
+        if args.change_after and image.sent >= args.change_after and image.version == 1:
+            image.version = 2
+            print('image changed, new ETag {}'.format(image.etag))
+
+        size = len(image.data)
+        start, end, status = 0, size - 1, 200
+        match = RANGE.match(self.headers.get('Range', ''))
+        if_range = self.headers.get('If-Range')
+        if match and not args.no_range and (if_range is None or if_range == image.etag):
+            start = int(match.group(1))
+            end = min(int(match.group(2)) if match.group(2) else size - 1, size - 1)
+            if start >= size or start > end:
+                self.send_response(416)
+                self.send_header('Content-Range', 'bytes */{}'.format(size))
+                self.send_header('Content-Length', '0')
+                self.end_headers()
+                return
+            status = 206
+
+        body = image.data[start:end + 1]
+        self.send_response(status)
+        self.send_header('Content-Type', 'application/octet-stream')
+        self.send_header('Content-Length', str(len(body)))
+        self.send_header('ETag', image.etag)
+        if status == 206:
+            self.send_header('Content-Range', 'bytes {}-{}/{}'.format(start, end, size))
+        if not args.no_range:
+            self.send_header('Accept-Ranges', 'bytes')
+        self.end_headers()
+
+        # fault is injected somewhere in the body
+        cut = len(body)
+        fault = None
+        if random.random() < args.drop:
+            fault, cut = 'drop', random.randrange(len(body) + 1)
+        elif random.random() < args.stall:
+            fault, cut = 'stall', random.randrange(len(body) + 1)
+        for pos in range(0, cut, 1024):
+            self.wfile.write(body[pos:min(pos + 1024, cut)])
+            if args.rate:
+                time.sleep(1024 / args.rate)
+        image.sent += cut
+        if fault == 'stall':
+            image.stalled += 1
+            print('  stalled at {}'.format(start + cut))
+            time.sleep(args.stall_s)
+            self.close_connection = True
+        elif fault == 'drop':
+            image.dropped += 1
+            print('  dropped at {}'.format(start + cut))
+            self.close_connection = True
+
+    def log_message(self, fmt, *args):
+        if not self.server.args.quiet:
+            print('{} {} Range: {} If-Range: {}'.format(self.address_string(), fmt % args,
+                                                      self.headers.get('Range'), self.headers.get('If-Range')))
+
+
+class Server(socketserver.ThreadingMixIn, http.server.HTTPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description='ota_client test server')
+    parser.add_argument('image', help='application image (.bin)')
+    parser.add_argument('--bind', default='0.0.0.0', help='address to listen on')
+    parser.add_argument('--port', type=int, default=8070, help='TCP port')
+    parser.add_argument('--drop', type=float, default=0.1, help='probability to drop a response')
+    parser.add_argument('--stall', type=float, default=0.0, help='probability to stall a response')
+    parser.add_argument('--stall-s', type=float, default=30.0, help='stall time, above the client timeout')
+    parser.add_argument('--rate', type=float, default=0, help='limit each response to bytes/s')
+    parser.add_argument('--change-after', type=int, default=0, help='change the ETag after this many bytes')
+    parser.add_argument('--no-range', action='store_true', help='ignore Range, always send the whole image')
+    parser.add_argument('--quiet', action='store_true', help="don't print the requests")
+    args = parser.parse_args()
+
+    server = Server((args.bind, args.port), Handler)
+    server.args = args
+    server.image = Image(args.image)
+    print('serving {} ({} bytes) on {}:{}'.format(args.image, len(server.image.data), args.bind, args.port))
+    print('SHA-256 {}'.format(hashlib.sha256(server.image.data).hexdigest()))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    image = server.image
+    print('{} requests, {} bytes sent, {} dropped, {} stalled'.format(
+        image.requests, image.sent, image.dropped, image.stalled))
+
+
+if __name__ == '__main__':
+    main()
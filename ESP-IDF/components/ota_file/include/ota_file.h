@@ -0,0 +1,88 @@
+/*
+ * ota_file.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Firmware update from a file, e.g. update.bin on a mounted SD card, for
+ * devices without network access. The file is read directly into the buffers
+ * of the ota_writer (no copy), so the card reads the next buffer while the
+ * writer task programs the flash from the other one. The buffers are in
+ * internal DMA memory and every read is a multiple of the 512 byte sector at
+ * a sector aligned file offset, FATFS and the SD driver then transfer it with
+ * one multi-block DMA read.
+ *
+ * The image is verified before the boot partition is changed: the SHA-256 of
+ * the written image must match the expected one, given in the configuration
+ * or read from a hash file (sha256sum format, the first 64 characters are the
+ * hex digest). Without an expected hash the update is refused, unless
+ * CONFIG_OTA_FILE_REQUIRE_SHA256 is disabled. With secure boot or signed app
+ * images enabled the signature is verified too (esp_ota_end).
+ *
+ * An image with the ELF SHA-256 of the running firmware isn't written, so an
+ * update.bin left on the card is installed only once. Only plain application
+ * images are accepted.
+ *
+ * Usage, card is mounted:
+ *   ota_file_config_t config = OTA_FILE_CONFIG_DEFAULT();
+ *   config.path = "/sdcard/update.bin";
+ *   config.sha256_path = "/sdcard/update.sha";
+ *   if( ota_file_update(&config) == ESP_OK ) esp_restart();
+ */
+
+#ifndef OTA_FILE_H_
+#define OTA_FILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "ota_writer.h"
+
+/**
+ * @brief Progress callback, called in the OTA writer task
+ * @param ctx user context given in the configuration
+ * @param written image bytes in flash
+ * @param total image size
+ */
+typedef void (*ota_file_progress_t)( void *ctx, size_t written, size_t total );
+
+typedef struct _ota_file_config_t
+{
+  const char *path;                     // image file
+  const char *sha256;                   // expected SHA-256 of the image as hex, NULL to read sha256_path
+  const char *sha256_path;              // file with the expected SHA-256, NULL if none
+  bool      force;                      // write even if it is the running firmware
+  size_t    buffer_size;                // each of the two read buffers, multiple of 512
+  ota_file_progress_t progress_cb;      // can be NULL
+  void      *ctx;
+  uint32_t  task_stack;                 // OTA writer task
+  UBaseType_t task_priority;
+} ota_file_config_t;
+
+typedef struct _ota_file_stats_t
+{
+  size_t    image_size;
+  uint32_t  total_ms;                   // update including the flash erase
+  uint32_t  read_ms;                    // time spent reading the file
+  uint32_t  wait_ms;                    // time the reader waited for the flash
+} ota_file_stats_t;
+
+#define OTA_FILE_CONFIG_DEFAULT()                     \
+{                                                     \
+  .path = NULL,                                       \
+  .sha256 = NULL,                                     \
+  .sha256_path = NULL,                                \
+  .force = false,                                     \
+  .buffer_size = CONFIG_OTA_FILE_BUFFER_KB * 1024u,   \
+  .progress_cb = NULL,                                \
+  .ctx = NULL,                                        \
+  .task_stack = 4096,                                 \
+  .task_priority = 5,                                 \
+}
+
+// Public Function Prototypes
+esp_err_t ota_file_update( const ota_file_config_t *config );
+void ota_file_get_stats( ota_file_stats_t *stats );
+
+#endif /* OTA_FILE_H_ */
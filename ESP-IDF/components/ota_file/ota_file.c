@@ -0,0 +1,282 @@
+/*
+ * ota_file.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "ota_file.h"
+
+// Private Macros
+#define OTA_FILE_SECTOR_SIZE            (512u)    // FATFS sector, reads are aligned to it
+#define OTA_FILE_SHA256_HEX_LEN         (OTA_WRITER_SHA256_LEN * 2u)
+
+typedef struct _ota_file_t
+{
+  const ota_file_config_t *config;
+  ota_writer_t  writer;
+  size_t        image_size;
+} ota_file_t;
+
+// Private Variables
+static const char *TAG = "OTA File";
+static ota_file_stats_t ota_file_stats = { 0 };
+
+// Private Function Declaration
+static esp_err_t ota_file_expected_sha256( const ota_file_config_t *config, uint8_t *sha256 );
+static esp_err_t ota_file_check( int fd, bool force );
+static esp_err_t ota_file_copy( ota_file_t *file, int fd );
+static void ota_file_progress( void *ctx, size_t processed, size_t written );
+
+// Public Function Definition
+
+/**
+ * @brief Update the firmware from an image file, the file is checked to be an
+ *        application image other than the running one, written to the next
+ *        update partition and verified with the expected SHA-256 before the
+ *        boot partition is changed. Blocks until the update is done.
+ * @param config update configuration, used until the function returns
+ * @return ESP_OK if the image becomes active after restart, ESP_ERR_NOT_FOUND
+ *         if there is no image file, ESP_ERR_INVALID_ARG if there is no valid
+ *         expected SHA-256, ESP_ERR_INVALID_VERSION if it is the running
+ *         firmware, ESP_ERR_NOT_SUPPORTED if not an application image,
+ *         ESP_ERR_INVALID_CRC on SHA-256 mismatch, ESP_FAIL if reading the
+ *         file failed, else the error of the ota_writer
+ */
+esp_err_t ota_file_update( const ota_file_config_t *config )
+{
+  ota_writer_config_t writer_config = OTA_WRITER_CONFIG_DEFAULT();
+  uint8_t sha256[OTA_WRITER_SHA256_LEN];
+  const uint8_t *expected = sha256;
+  ota_file_t *file = NULL;
+  struct stat st;
+  int64_t start_us = esp_timer_get_time();
+  int fd;
+  esp_err_t err;
+
+  memset( &ota_file_stats, 0x00, sizeof(ota_file_stats) );
+  if( (config->path == NULL) || (config->buffer_size < OTA_FILE_SECTOR_SIZE) || \
+      (config->buffer_size % OTA_FILE_SECTOR_SIZE) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( (stat(config->path, &st) != 0) || (st.st_size <= 0) )
+  {
+    ESP_LOGI(TAG, "No image %s", config->path);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  err = ota_file_expected_sha256( config, sha256 );
+  if( err == ESP_ERR_NOT_FOUND )
+  {
+#ifdef CONFIG_OTA_FILE_REQUIRE_SHA256
+    ESP_LOGE(TAG, "No SHA-256 for %s, update refused", config->path);
+    return ESP_ERR_INVALID_ARG;
+#else
+    ESP_LOGW(TAG, "No SHA-256 for %s, image is only validated", config->path);
+    expected = NULL;
+#endif
+  }
+  else if( err != ESP_OK )
+  {
+    ESP_LOGE(TAG, "Invalid SHA-256 for %s", config->path);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  fd = open( config->path, O_RDONLY );
+  if( fd < 0 )
+  {
+    ESP_LOGE(TAG, "Can't open %s", config->path);
+    return ESP_FAIL;
+  }
+  err = ota_file_check( fd, config->force );
+  if( err != ESP_OK )
+  {
+    close( fd );
+    return err;
+  }
+
+  file = calloc( 1, sizeof(ota_file_t) );
+  if( file == NULL )
+  {
+    close( fd );
+    return ESP_ERR_NO_MEM;
+  }
+  file->config = config;
+  file->image_size = (size_t)st.st_size;
+  ota_file_stats.image_size = file->image_size;
+
+  // the whole image is erased at begin, the card reads the second buffer meanwhile
+  writer_config.image_size = file->image_size;
+  writer_config.buffer_size = config->buffer_size;
+  writer_config.buffer_caps = MALLOC_CAP_DMA;
+  writer_config.progress_ms = 250;
+  writer_config.progress_cb = ota_file_progress;
+  writer_config.ctx = file;
+  writer_config.task_stack = config->task_stack;
+  writer_config.task_priority = config->task_priority;
+  ESP_LOGI(TAG, "Updating from %s, %u bytes", config->path, file->image_size);
+  err = ota_writer_begin( &file->writer, &writer_config );
+  if( err == ESP_OK )
+  {
+    err = ota_file_copy( file, fd );
+    if( err == ESP_OK )
+    {
+      err = ota_writer_finish( &file->writer, expected );
+    }
+    else
+    {
+      ota_writer_abort( &file->writer );
+    }
+  }
+  close( fd );
+  free( file );
+
+  ota_file_stats.total_ms = (uint32_t)((esp_timer_get_time() - start_us) / 1000);
+  ESP_LOGI(TAG, "Update %s after %lu ms, file read %lu ms, waited for flash %lu ms", esp_err_to_name(err), \
+           ota_file_stats.total_ms, ota_file_stats.read_ms, ota_file_stats.wait_ms);
+  return err;
+}
+
+/**
+ * @brief Get the statistics of the last update
+ * @param stats output
+ */
+void ota_file_get_stats( ota_file_stats_t *stats )
+{
+  memcpy( stats, &ota_file_stats, sizeof(ota_file_stats_t) );
+}
+
+// Private Function Definition
+
+/**
+ * @brief Get the expected SHA-256 from the configuration or the hash file
+ * @param config update configuration
+ * @param sha256 output, OTA_WRITER_SHA256_LEN bytes
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if none is given, ESP_ERR_INVALID_ARG if
+ *         it is not a valid hex digest
+ */
+static esp_err_t ota_file_expected_sha256( const ota_file_config_t *config, uint8_t *sha256 )
+{
+  char hex[OTA_FILE_SHA256_HEX_LEN + 1u] = { 0 };
+  FILE *f;
+
+  if( config->sha256 )
+  {
+    return ota_writer_sha256_parse( config->sha256, sha256 );
+  }
+  if( (config->sha256_path == NULL) || ((f = fopen(config->sha256_path, "r")) == NULL) )
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+  // sha256sum format, "<hex digest>  <file name>"
+  if( fread(hex, 1, OTA_FILE_SHA256_HEX_LEN, f) != OTA_FILE_SHA256_HEX_LEN )
+  {
+    hex[0] = '\0';
+  }
+  fclose( f );
+  return ota_writer_sha256_parse( hex, sha256 );
+}
+
+/**
+ * @brief Check the start of the image file, the file position is at its
+ *        start again afterwards
+ * @param fd image file
+ * @param force accept the running firmware
+ * @return ESP_OK, ESP_FAIL if reading failed, else the error of
+ *         ota_writer_check_image
+ */
+static esp_err_t ota_file_check( int fd, bool force )
+{
+  uint8_t header[OTA_WRITER_IMAGE_CHECK_LEN];
+  ssize_t len;
+
+  len = read( fd, header, sizeof(header) );
+  if( (len < 0) || (lseek(fd, 0, SEEK_SET) != 0) )
+  {
+    ESP_LOGE(TAG, "Reading image failed");
+    return ESP_FAIL;
+  }
+  return ota_writer_check_image( header, (size_t)len, force );
+}
+
+/**
+ * @brief Read the image file into the writer buffers, the reads are always
+ *        the free part of the fill buffer, i.e. whole buffers at sector
+ *        aligned file offsets
+ * @param file update
+ * @param fd image file
+ * @return ESP_OK, ESP_FAIL if reading failed, ESP_ERR_INVALID_SIZE if the file
+ *         size has changed, else the error of the writer
+ */
+static esp_err_t ota_file_copy( ota_file_t *file, int fd )
+{
+  size_t total = 0;
+  size_t size;
+  uint8_t *data;
+  ssize_t len = 1;
+  int64_t read_us = 0;
+  int64_t wait_us = 0;
+  int64_t now_us;
+  esp_err_t err = ESP_OK;
+
+  while( (err == ESP_OK) && (len > 0) )
+  {
+    err = ota_writer_get_buffer( &file->writer, &data, &size );
+    if( err != ESP_OK )
+    {
+      break;
+    }
+    now_us = esp_timer_get_time();
+    len = read( fd, data, size );
+    read_us += esp_timer_get_time() - now_us;
+    if( len < 0 )
+    {
+      ESP_LOGE(TAG, "Reading image failed at %u", total);
+      err = ESP_FAIL;
+    }
+    else if( len > 0 )
+    {
+      total += (size_t)len;
+      // blocks while the writer task is busy with the other buffer
+      now_us = esp_timer_get_time();
+      err = ota_writer_commit( &file->writer, (size_t)len );
+      wait_us += esp_timer_get_time() - now_us;
+    }
+  }
+
+  if( (err == ESP_OK) && (total != file->image_size) )
+  {
+    ESP_LOGE(TAG, "Read %u bytes of %u", total, file->image_size);
+    err = ESP_ERR_INVALID_SIZE;
+  }
+  ota_file_stats.read_ms = (uint32_t)(read_us / 1000);
+  ota_file_stats.wait_ms = (uint32_t)(wait_us / 1000);
+  return err;
+}
+
+/**
+ * @brief Progress of the ota_writer, passed on with the image size
+ * @param ctx update
+ * @param processed bytes handled by the writer task
+ * @param written image bytes in flash
+ */
+static void ota_file_progress( void *ctx, size_t processed, size_t written )
+{
+  ota_file_t *file = (ota_file_t*)ctx;
+
+  (void)processed;
+  if( file->config->progress_cb )
+  {
+    file->config->progress_cb( file->config->ctx, written, file->image_size );
+  }
+}
@@ -0,0 +1,19 @@
+# ota_file_sdcard_image()
+# Creates build/sdcard/update.bin and update.sha (its SHA-256) at every build,
+# both files are copied to the root of the SD card for the ota_file update.
+# Call it in the project CMakeLists after project().
+function(ota_file_sdcard_image)
+    idf_build_get_property(python PYTHON)
+    idf_build_get_property(build_dir BUILD_DIR)
+    idf_build_get_property(project_bin PROJECT_BIN)
+    idf_component_get_property(ota_file_dir ota_file COMPONENT_DIR)
+    set(image_script ${ota_file_dir}/tools/ota_file_image.py)
+    set(sdcard_dir ${build_dir}/sdcard)
+
+    add_custom_target(ota_file_sdcard_image ALL
+        COMMAND ${python} ${image_script} ${build_dir}/${project_bin} ${sdcard_dir}
+        BYPRODUCTS ${sdcard_dir}/update.bin ${sdcard_dir}/update.sha
+        COMMENT "Creating SD card update image from ${project_bin}"
+        VERBATIM)
+    add_dependencies(ota_file_sdcard_image app)
+endfunction()
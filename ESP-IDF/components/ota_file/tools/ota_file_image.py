@@ -0,0 +1,43 @@
+#!/usr/bin/env python
+#
+# ota_file_image.py
+#
+#  Created on: Oct 19, 2026
+#      Author: xpress_embedo
+#
+# Create the files of an SD card update for the ota_file component: the
+# application image as update.bin and its SHA-256 as update.sha, in sha256sum
+# format. Both are copied to the root of the card, the names are 8.3 so they
+# work without long file name support in FATFS.
+
+import argparse
+import hashlib
+import os
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Create an SD card update image')
+    parser.add_argument('input', help='application image (.bin)')
+    parser.add_argument('output_dir', help='directory for update.bin and update.sha, e.g. the SD card')
+    parser.add_argument('--name', default='update', help='file name without extension (default update)')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        image = f.read()
+    if not image or image[0] != 0xE9:
+        parser.error('{} is not an application image'.format(args.input))
+
+    if not os.path.isdir(args.output_dir):
+        os.makedirs(args.output_dir)
+    image_name = args.name + '.bin'
+    digest = hashlib.sha256(image).hexdigest()
+    with open(os.path.join(args.output_dir, image_name), 'wb') as f:
+        f.write(image)
+    with open(os.path.join(args.output_dir, args.name + '.sha'), 'w') as f:
+        f.write('{}  {}\n'.format(digest, image_name))
+
+    print('{}: {} bytes, SHA-256 {}'.format(os.path.join(args.output_dir, image_name), len(image), digest))
+
+
+if __name__ == '__main__':
+    main()
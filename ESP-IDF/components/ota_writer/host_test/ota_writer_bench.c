@@ -0,0 +1,204 @@
+/*
+ * ota_writer_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host benchmark of plain vs compressed updates. The receiver gives the image
+ * to the writer at the rate of the link, in TCP segments, while the flash
+ * stub is busy for the typical times of a 4 MB SPI NOR flash (W25Q32JV data
+ * sheet: 4 KB sector erase 45 ms, 64 KB block erase 150 ms, 256 byte page
+ * program 0.4 ms). The plain image has a known size (Content-Length), so
+ * esp_ota_begin erases it at once, the compressed one is erased while
+ * writing. Both the link time (bytes on the wire / rate) and the update time
+ * (ota_writer_begin till ota_writer_finish) are given, the update time
+ * includes the flash. All times are run SCALE times faster and scaled back.
+ * The inflate runs at host speed, an ESP32 inflates at a few MB/s, which is
+ * still faster than the flash.
+ *
+ *  make -C components/ota_writer/host_test bench
+ *  build/ota_writer_bench <image.bin> <image.bin.zz> [scale] [link KB/s ...]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_timer.h"
+#include "ota_writer.h"
+
+// Private Macros
+#define BENCH_SEGMENT                       (1436u)   // TCP payload of one segment
+#define BENCH_SECTOR_ERASE_US               (45000u)
+#define BENCH_BLOCK_ERASE_US                (150000u)
+#define BENCH_PAGE_US                       (400u)
+#define BENCH_SCALE                         (10u)
+
+typedef struct _bench_file_t
+{
+  uint8_t   *data;
+  size_t    len;
+} bench_file_t;
+
+typedef struct _bench_result_t
+{
+  double    update_s;                   // begin till finish
+  double    link_s;                     // bytes on the wire at the link rate
+  uint32_t  erases;
+  uint32_t  block_erases;
+} bench_result_t;
+
+// Private Variables
+static uint32_t bench_scale = BENCH_SCALE;
+
+// Private Function Declaration
+static bool bench_update( const bench_file_t *file, bool known_size, double rate_kbs, const uint8_t *sha256, \
+                          bench_result_t *result );
+static bool bench_load( const char *path, bench_file_t *file );
+static void bench_sleep_until( int64_t until_us );
+
+int main( int argc, char **argv )
+{
+  static const double default_rates[] = { 25.0, 50.0, 100.0, 200.0, 500.0, 1000.0 };
+  bench_file_t image = { 0 }, compressed = { 0 };
+  bench_result_t plain, zz;
+  uint8_t sha256[OTA_WRITER_SHA256_LEN];
+  mbedtls_sha256_context sha;
+  double rate;
+  int rates = (argc > 4) ? (argc - 4) : (int)(sizeof(default_rates) / sizeof(default_rates[0]));
+
+  if( (argc < 3) || !bench_load(argv[1], &image) || !bench_load(argv[2], &compressed) )
+  {
+    printf( "usage: %s <image.bin> <image.bin.zz> [scale] [link KB/s ...]\n", argv[0] );
+    return EXIT_FAILURE;
+  }
+  if( argc > 3 )
+  {
+    bench_scale = (uint32_t)strtoul( argv[3], NULL, 0 );
+    bench_scale = bench_scale ? bench_scale : 1u;
+  }
+  mbedtls_sha256_init( &sha );
+  mbedtls_sha256_starts( &sha, 0 );
+  mbedtls_sha256_update( &sha, image.data, image.len );
+  mbedtls_sha256_finish( &sha, sha256 );
+  mbedtls_sha256_free( &sha );
+
+  // inflate and hash alone, no flash time and no link limit
+  esp_ota_host_set_timing( 0, 0, 0 );
+  if( !bench_update(&compressed, false, 0.0, sha256, &zz) )
+  {
+    return EXIT_FAILURE;
+  }
+  printf( "image %u bytes, compressed %u bytes (%.1f%%), host inflate %.1f MB/s\n", (unsigned)image.len, \
+          (unsigned)compressed.len, 100.0 * (double)compressed.len / (double)image.len, \
+          (double)image.len / zz.update_s / 1e6 * bench_scale );
+  printf( "flash: sector erase %u ms, block erase %u ms, page program %.1f ms, time scale 1/%u\n", \
+          BENCH_SECTOR_ERASE_US / 1000u, BENCH_BLOCK_ERASE_US / 1000u, BENCH_PAGE_US / 1000.0, \
+          (unsigned)bench_scale );
+  printf( "%9s | %8s %8s %9s | %8s %8s %9s | %6s %6s\n", "link KB/s", "plain", "link", "erases", \
+          "zz", "link", "erases", "update", "link" );
+
+  esp_ota_host_set_timing( BENCH_SECTOR_ERASE_US / bench_scale, BENCH_BLOCK_ERASE_US / bench_scale, \
+                           BENCH_PAGE_US / bench_scale );
+  for( int idx = 0; idx < rates; idx++ )
+  {
+    rate = (argc > 4) ? strtod( argv[4 + idx], NULL ) : default_rates[idx];
+    if( !bench_update(&image, true, rate, sha256, &plain) || !bench_update(&compressed, false, rate, sha256, &zz) )
+    {
+      return EXIT_FAILURE;
+    }
+    printf( "%9.0f | %7.2fs %7.2fs %4u/%-4u | %7.2fs %7.2fs %4u/%-4u | %5.0f%% %5.0f%%\n", rate, \
+            plain.update_s, plain.link_s, (unsigned)plain.block_erases, (unsigned)plain.erases, \
+            zz.update_s, zz.link_s, (unsigned)zz.block_erases, (unsigned)zz.erases, \
+            100.0 * zz.update_s / plain.update_s, 100.0 * zz.link_s / plain.link_s );
+  }
+  printf( "erases: 64 KB blocks / 4 KB sectors erased, update and link: compressed in %% of plain\n" );
+  free( image.data );
+  free( compressed.data );
+  return EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Run one update with the receiver paced at the link rate
+ * @param file image to send
+ * @param known_size the size is given to the writer, like a Content-Length
+ * @param rate_kbs link rate in KB/s, 0 for no limit
+ * @param sha256 expected SHA-256 of the image in flash
+ * @param result output, times scaled back
+ * @return true if the update succeeded
+ */
+static bool bench_update( const bench_file_t *file, bool known_size, double rate_kbs, const uint8_t *sha256, \
+                          bench_result_t *result )
+{
+  ota_writer_config_t config = OTA_WRITER_CONFIG_DEFAULT();
+  esp_ota_host_stats_t stats;
+  ota_writer_t ota;
+  size_t offset = 0, len;
+  double us_per_byte = (rate_kbs > 0.0) ? (1e6 / (rate_kbs * 1024.0 * bench_scale)) : 0.0;
+  int64_t start_us;
+  esp_err_t err;
+
+  esp_ota_host_reset();
+  config.image_size = known_size ? file->len : 0u;
+  start_us = esp_timer_get_time();
+  err = ota_writer_begin( &ota, &config );
+  while( (err == ESP_OK) && (offset < file->len) )
+  {
+    len = ((file->len - offset) < BENCH_SEGMENT) ? (file->len - offset) : BENCH_SEGMENT;
+    // the segment has arrived when the link has sent it
+    bench_sleep_until( start_us + (int64_t)((double)(offset + len) * us_per_byte) );
+    err = ota_writer_write( &ota, &file->data[offset], len );
+    offset += len;
+  }
+  if( err == ESP_OK )
+  {
+    err = ota_writer_finish( &ota, sha256 );
+  }
+  else
+  {
+    ota_writer_abort( &ota );
+  }
+  esp_ota_host_get_stats( &stats );
+  result->update_s = (double)(esp_timer_get_time() - start_us) * bench_scale / 1e6;
+  result->link_s = (rate_kbs > 0.0) ? ((double)file->len / (rate_kbs * 1024.0)) : 0.0;
+  result->erases = stats.erases;
+  result->block_erases = stats.block_erases;
+  if( err != ESP_OK )
+  {
+    printf( "update failed, %s\n", esp_err_to_name(err) );
+  }
+  return err == ESP_OK;
+}
+
+static bool bench_load( const char *path, bench_file_t *file )
+{
+  FILE *f = fopen( path, "rb" );
+  long len;
+
+  if( f == NULL )
+  {
+    return false;
+  }
+  fseek( f, 0, SEEK_END );
+  len = ftell( f );
+  fseek( f, 0, SEEK_SET );
+  file->data = malloc( (size_t)len );
+  file->len = fread( file->data, 1, (size_t)len, f );
+  fclose( f );
+  return (len > 0) && (file->len == (size_t)len);
+}
+
+static void bench_sleep_until( int64_t until_us )
+{
+  int64_t now_us = esp_timer_get_time();
+  struct timespec delay;
+
+  if( until_us > now_us )
+  {
+    delay.tv_sec = (time_t)((until_us - now_us) / 1000000);
+    delay.tv_nsec = (long)((until_us - now_us) % 1000000) * 1000L;
+    nanosleep( &delay, NULL );
+  }
+}
@@ -0,0 +1,562 @@
+/*
+ * ota_writer_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of the OTA writer on a RAM partition with NOR flash behaviour
+ * (stubs/esp_ota_host.c). A test image is compressed with
+ * tools/ota_compress.py and given to the writer in chunks of random size,
+ * the flash must then hold the original image with its SHA-256. The cases:
+ *  plain       image in chunks, erased once with the known size, and without
+ *              a size, erased in blocks while writing
+ *  compressed  zlib image in chunks, inflated while writing, the heap in use
+ *              during the update is sampled at every flash write and must
+ *              stay below the two buffers, the inflate output, the window and
+ *              the inflate state, independent of the image size (leaks are
+ *              found by the sanitizer at exit)
+ *  zero_copy   compressed image read into ota_writer_get_buffer
+ *  window      an image compressed with a bigger window is rejected
+ *  broken      truncated, trailing data, corrupt data, wrong SHA-256, not an
+ *              image, compressed but not an image: no boot partition is set
+ *              and the next update can begin
+ *  resume      plain image interrupted and resumed at a sector offset
+ *  check       ota_writer_check_image for plain and compressed image starts
+ *
+ *  make -C components/ota_writer/host_test
+ *  build/ota_writer_test ../tools/ota_compress.py
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+
+#include "ota_writer.h"
+
+#if defined(__SANITIZE_ADDRESS__)
+// sanitizer/allocator_interface.h, not installed with every compiler
+size_t __sanitizer_get_current_allocated_bytes( void );
+#endif
+
+// Private Macros
+#define CHECK( cond )                                                         \
+  do {                                                                        \
+    if( !(cond) )                                                             \
+    {                                                                         \
+      printf( "  %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond );     \
+      test_failed++;                                                          \
+    }                                                                         \
+  } while( 0 )
+
+#define TEST_IMAGE_SIZE                     (400u * 1024u + 123u)
+#define TEST_BUFFER_SIZE                    (4096u)
+#define TEST_WBITS                          (13)
+#define TEST_IMAGE                          "build/test_image.bin"
+#define TEST_COMPRESSED                     "build/test_image.bin.zz"
+#define TEST_COMPRESSED_W15                 "build/test_image.bin.w15.zz"
+// inflate_state of zlib is about 7 KB
+#define TEST_INFLATE_STATE                  (7u * 1024u)
+// queues and task of the stubs, the thread of the writer task (the loader allocates for it)
+#define TEST_STUB_HEAP                      (4u * 1024u)
+#define TEST_HEAP_LIMIT                     ((3u * TEST_BUFFER_SIZE) + (1u << TEST_WBITS) + TEST_INFLATE_STATE + \
+                                             TEST_STUB_HEAP)
+
+typedef struct _test_file_t
+{
+  uint8_t   *data;
+  size_t    len;
+} test_file_t;
+
+typedef struct _test_progress_t
+{
+  size_t    processed;
+  size_t    written;
+  uint32_t  calls;
+} test_progress_t;
+
+// Private Variables
+static int test_failed = 0;
+static uint32_t test_seed = 1;
+static uint8_t *test_image = NULL;
+static uint8_t test_sha256[OTA_WRITER_SHA256_LEN];
+static test_file_t test_zz = { 0 };
+static test_file_t test_zz_w15 = { 0 };
+static size_t test_heap_base = 0;
+static size_t test_heap_peak = 0;
+
+// Private Function Declaration
+static void test_plain( void );
+static void test_compressed( void );
+static void test_zero_copy( void );
+static void test_window( void );
+static void test_broken( void );
+static void test_resume( void );
+static void test_check( void );
+static esp_err_t test_update( const uint8_t *data, size_t len, size_t image_size, const uint8_t *sha256, \
+                              test_progress_t *progress );
+static bool test_flash_is_image( size_t len );
+static void test_make_image( void );
+static bool test_compress( const char *tool, int wbits, const char *output, test_file_t *file );
+static void test_progress( void *ctx, size_t processed, size_t written );
+static size_t test_heap_in_use( void );
+static void test_heap_sample( void );
+static uint32_t test_random( void );
+static bool test_sha256_known( void );
+static size_t test_deflate( const uint8_t *data, size_t len, uint8_t *out );
+
+int main( int argc, char **argv )
+{
+  const char *tool = (argc > 1) ? argv[1] : "../tools/ota_compress.py";
+  int total = 0;
+
+  // the SHA-256 of the stubs against a known one, "abc" of FIPS 180-2
+  if( !test_sha256_known() )
+  {
+    printf( "SHA-256 of the stubs is wrong\n" );
+    return EXIT_FAILURE;
+  }
+  test_make_image();
+  if( !test_compress(tool, TEST_WBITS, TEST_COMPRESSED, &test_zz) || \
+      !test_compress(tool, 15, TEST_COMPRESSED_W15, &test_zz_w15) )
+  {
+    printf( "unable to compress the test image with %s\n", tool );
+    return EXIT_FAILURE;
+  }
+  printf( "test image %u bytes, compressed %u bytes (%.1f%%)\n", (unsigned)TEST_IMAGE_SIZE, \
+          (unsigned)test_zz.len, 100.0 * (double)test_zz.len / TEST_IMAGE_SIZE );
+
+  void (*tests[])( void ) = { test_plain, test_compressed, test_zero_copy, test_window, test_broken, \
+                              test_resume, test_check };
+  const char *names[] = { "plain", "compressed", "zero_copy", "window", "broken", "resume", "check" };
+  for( size_t idx = 0; idx < (sizeof(tests) / sizeof(tests[0])); idx++ )
+  {
+    int before = test_failed;
+    esp_ota_host_reset();
+    tests[idx]();
+    printf( "%s: %s\n", names[idx], (test_failed == before) ? "OK" : "FAILED" );
+    total += (test_failed != before);
+  }
+
+  free( test_image );
+  free( test_zz.data );
+  free( test_zz_w15.data );
+  printf( "ota_writer_test: %s\n", total ? "FAILED" : "OK" );
+  return total ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+static void test_plain( void )
+{
+  test_progress_t progress = { 0 };
+  esp_ota_host_stats_t stats;
+
+  CHECK( test_update(test_image, TEST_IMAGE_SIZE, TEST_IMAGE_SIZE, test_sha256, &progress) == ESP_OK );
+  esp_ota_host_get_stats( &stats );
+  CHECK( test_flash_is_image(TEST_IMAGE_SIZE) );
+  CHECK( stats.erases == (TEST_IMAGE_SIZE + 4095u) / 4096u );
+  CHECK( stats.dirty_writes == 0u );
+  CHECK( stats.boot_sets == 1u );
+  CHECK( (progress.processed == TEST_IMAGE_SIZE) && (progress.written == TEST_IMAGE_SIZE) );
+
+  // size not known, erased in blocks while writing like a compressed image
+  esp_ota_host_reset();
+  CHECK( test_update(test_image, TEST_IMAGE_SIZE, 0, test_sha256, NULL) == ESP_OK );
+  esp_ota_host_get_stats( &stats );
+  CHECK( test_flash_is_image(TEST_IMAGE_SIZE) );
+  CHECK( stats.block_erases == (TEST_IMAGE_SIZE + 65535u) / 65536u );
+  CHECK( stats.dirty_writes == 0u );
+  CHECK( stats.boot_sets == 1u );
+}
+
+static void test_compressed( void )
+{
+  test_progress_t progress = { 0 };
+  esp_ota_host_stats_t stats;
+
+  test_heap_base = test_heap_in_use();
+  test_heap_peak = test_heap_base;
+  esp_ota_host_write_hook = test_heap_sample;
+  // the image size given is the compressed one, like the HTTP upload does
+  CHECK( test_update(test_zz.data, test_zz.len, test_zz.len, test_sha256, &progress) == ESP_OK );
+  esp_ota_host_write_hook = NULL;
+  esp_ota_host_get_stats( &stats );
+  CHECK( test_flash_is_image(TEST_IMAGE_SIZE) );
+  // erased in 64 KB blocks while writing, only what the image needs
+  CHECK( stats.erases == ((TEST_IMAGE_SIZE + 65535u) / 65536u) * 16u );
+  CHECK( stats.block_erases == (TEST_IMAGE_SIZE + 65535u) / 65536u );
+  CHECK( stats.dirty_writes == 0u );
+  CHECK( stats.boot_sets == 1u );
+  CHECK( (progress.processed == test_zz.len) && (progress.written == TEST_IMAGE_SIZE) );
+  printf( "  heap in use during the update %u bytes (limit %u), image %u bytes\n", \
+          (unsigned)(test_heap_peak - test_heap_base), (unsigned)TEST_HEAP_LIMIT, (unsigned)TEST_IMAGE_SIZE );
+  CHECK( test_heap_peak > test_heap_base );
+  CHECK( (test_heap_peak - test_heap_base) <= TEST_HEAP_LIMIT );
+}
+
+static void test_zero_copy( void )
+{
+  ota_writer_config_t config = OTA_WRITER_CONFIG_DEFAULT();
+  ota_writer_t ota;
+  uint8_t *data;
+  size_t size, len, offset = 0;
+  esp_err_t err;
+
+  config.buffer_caps = MALLOC_CAP_DMA;
+  CHECK( ota_writer_begin(&ota, &config) == ESP_OK );
+  err = ESP_OK;
+  while( (err == ESP_OK) && (offset < test_zz.len) )
+  {
+    err = ota_writer_get_buffer( &ota, &data, &size );
+    CHECK( size > 0u );
+    // reads of random length, like a file read returning less
+    len = 1u + (test_random() % size);
+    len = (len < (test_zz.len - offset)) ? len : (test_zz.len - offset);
+    memcpy( data, &test_zz.data[offset], len );
+    offset += len;
+    if( err == ESP_OK )
+    {
+      err = ota_writer_commit( &ota, len );
+    }
+  }
+  CHECK( err == ESP_OK );
+  CHECK( ota_writer_commit(&ota, TEST_BUFFER_SIZE + 1u) == ESP_ERR_INVALID_SIZE );
+  CHECK( ota_writer_finish(&ota, test_sha256) == ESP_OK );
+  CHECK( test_flash_is_image(TEST_IMAGE_SIZE) );
+}
+
+static void test_window( void )
+{
+  esp_ota_host_stats_t stats;
+
+  // inflate refuses the window, the writer task fails the update
+  CHECK( test_update(test_zz_w15.data, test_zz_w15.len, 0, NULL, NULL) == ESP_FAIL );
+  esp_ota_host_get_stats( &stats );
+  CHECK( stats.boot_sets == 0u );
+  CHECK( stats.bytes == 0u );
+  CHECK( ota_writer_check_image(test_zz_w15.data, OTA_WRITER_COMPRESSED_CHECK_LEN, false) == ESP_ERR_NOT_SUPPORTED );
+}
+
+static void test_broken( void )
+{
+  uint8_t *data = malloc( test_zz.len + 16u );
+  uint8_t wrong[OTA_WRITER_SHA256_LEN];
+  size_t len;
+  esp_ota_host_stats_t stats;
+
+  // truncated stream, it only ends after the last byte
+  CHECK( test_update(test_zz.data, test_zz.len - 100u, 0, NULL, NULL) == ESP_ERR_INVALID_SIZE );
+  // data behind the end of the stream
+  memcpy( data, test_zz.data, test_zz.len );
+  memset( &data[test_zz.len], 0x5A, 16u );
+  CHECK( test_update(data, test_zz.len + 16u, 0, NULL, NULL) == ESP_ERR_INVALID_SIZE );
+  // corrupt byte in the middle, inflate or its Adler-32 check fails
+  memcpy( data, test_zz.data, test_zz.len );
+  data[test_zz.len / 2u] ^= 0x10u;
+  CHECK( test_update(data, test_zz.len, 0, NULL, NULL) != ESP_OK );
+  // wrong SHA-256, plain and compressed
+  memcpy( wrong, test_sha256, sizeof(wrong) );
+  wrong[7] ^= 0x01u;
+  CHECK( test_update(test_zz.data, test_zz.len, 0, wrong, NULL) == ESP_ERR_INVALID_CRC );
+  CHECK( test_update(test_image, TEST_IMAGE_SIZE, TEST_IMAGE_SIZE, wrong, NULL) == ESP_ERR_INVALID_CRC );
+  // neither an image nor a zlib stream
+  memset( data, 0x42, 4096u );
+  CHECK( test_update(data, 4096u, 0, NULL, NULL) == ESP_ERR_NOT_SUPPORTED );
+  // a zlib stream, but not of an application image
+  len = test_deflate( data, 4096u, &data[4096] );
+  CHECK( test_update(&data[4096], len, 0, NULL, NULL) == ESP_ERR_OTA_VALIDATE_FAILED );
+  // bigger than the given size
+  CHECK( test_update(test_image, TEST_IMAGE_SIZE, TEST_IMAGE_SIZE - 1u, NULL, NULL) == ESP_ERR_INVALID_SIZE );
+  esp_ota_host_get_stats( &stats );
+  CHECK( stats.boot_sets == 0u );
+  CHECK( stats.dirty_writes == 0u );
+  // and the next update works
+  CHECK( test_update(test_zz.data, test_zz.len, 0, test_sha256, NULL) == ESP_OK );
+  CHECK( test_flash_is_image(TEST_IMAGE_SIZE) );
+  free( data );
+}
+
+static void test_resume( void )
+{
+  ota_writer_config_t config = OTA_WRITER_CONFIG_DEFAULT();
+  esp_ota_host_stats_t stats;
+  ota_writer_t ota, other;
+  size_t cut = (10u * 4096u) + 1000u;
+  size_t offset = 10u * 4096u;
+
+  config.image_size = TEST_IMAGE_SIZE;
+  CHECK( ota_writer_begin(&ota, &config) == ESP_OK );
+  // only one update at a time
+  CHECK( ota_writer_begin(&other, &config) == ESP_ERR_INVALID_STATE );
+  CHECK( ota_writer_write(&ota, test_image, cut) == ESP_OK );
+  ota_writer_abort( &ota );
+
+  esp_ota_host_reset();
+  // a wrongly restored image in front of the offset must fail the hash
+  config.offset = offset;
+  CHECK( ota_writer_begin(&ota, &config) == ESP_OK );
+  CHECK( ota_writer_write(&ota, &test_image[offset], TEST_IMAGE_SIZE - offset) == ESP_OK );
+  CHECK( ota_writer_finish(&ota, test_sha256) != ESP_OK );
+
+  // interrupted again, then resumed on the flash left by it
+  config.offset = 0;
+  CHECK( ota_writer_begin(&ota, &config) == ESP_OK );
+  CHECK( ota_writer_write(&ota, test_image, cut) == ESP_OK );
+  ota_writer_abort( &ota );
+  esp_ota_host_get_stats( &stats );
+  CHECK( stats.aborts == 1u );
+  CHECK( stats.bytes >= offset );
+
+  config.offset = offset;
+  CHECK( ota_writer_begin(&ota, &config) == ESP_OK );
+  CHECK( ota_writer_write(&ota, &test_image[offset], TEST_IMAGE_SIZE - offset) == ESP_OK );
+  CHECK( ota_writer_finish(&ota, test_sha256) == ESP_OK );
+  CHECK( test_flash_is_image(TEST_IMAGE_SIZE) );
+  esp_ota_host_get_stats( &stats );
+  CHECK( stats.dirty_writes == 0u );
+  CHECK( stats.boot_sets == 1u );
+
+  // offset must be sector aligned and inside the image
+  config.offset = offset + 1u;
+  CHECK( ota_writer_begin(&ota, &config) == ESP_ERR_INVALID_ARG );
+  config.offset = TEST_IMAGE_SIZE + 4096u;
+  CHECK( ota_writer_begin(&ota, &config) == ESP_ERR_INVALID_ARG );
+}
+
+static void test_check( void )
+{
+  esp_app_desc_t running = *esp_app_get_description();
+  const esp_app_desc_t *desc = (const esp_app_desc_t *)&test_image[sizeof(esp_image_header_t) + \
+                                                                    sizeof(esp_image_segment_header_t)];
+  uint8_t noise[OTA_WRITER_COMPRESSED_CHECK_LEN];
+
+  CHECK( ota_writer_check_image(test_image, OTA_WRITER_IMAGE_CHECK_LEN, false) == ESP_OK );
+  CHECK( ota_writer_check_image(test_image, OTA_WRITER_IMAGE_CHECK_LEN - 1u, false) == ESP_ERR_NOT_SUPPORTED );
+  CHECK( ota_writer_check_image(test_zz.data, OTA_WRITER_COMPRESSED_CHECK_LEN, false) == ESP_OK );
+  // too short to inflate the application description
+  CHECK( ota_writer_check_image(test_zz.data, 40u, false) == ESP_ERR_NOT_SUPPORTED );
+  for( size_t idx = 0; idx < sizeof(noise); idx++ )
+  {
+    noise[idx] = (uint8_t)test_random();
+  }
+  noise[0] = 0x12;
+  CHECK( ota_writer_check_image(noise, sizeof(noise), false) == ESP_ERR_NOT_SUPPORTED );
+
+  // the image is the running firmware, also seen in the compressed one
+  memcpy( running.app_elf_sha256, desc->app_elf_sha256, sizeof(running.app_elf_sha256) );
+  esp_ota_host_set_running( &running );
+  CHECK( ota_writer_check_image(test_image, OTA_WRITER_IMAGE_CHECK_LEN, false) == ESP_ERR_INVALID_VERSION );
+  CHECK( ota_writer_check_image(test_zz.data, OTA_WRITER_COMPRESSED_CHECK_LEN, false) == ESP_ERR_INVALID_VERSION );
+  CHECK( ota_writer_check_image(test_zz.data, OTA_WRITER_COMPRESSED_CHECK_LEN, true) == ESP_OK );
+  memset( running.app_elf_sha256, 0x00, sizeof(running.app_elf_sha256) );
+  esp_ota_host_set_running( &running );
+}
+
+/**
+ * @brief Run an update with the data in chunks of random size
+ * @return the result of ota_writer_finish, or the first error of a write
+ */
+static esp_err_t test_update( const uint8_t *data, size_t len, size_t image_size, const uint8_t *sha256, \
+                              test_progress_t *progress )
+{
+  ota_writer_config_t config = OTA_WRITER_CONFIG_DEFAULT();
+  ota_writer_t ota;
+  size_t offset = 0, chunk;
+  esp_err_t err;
+
+  config.image_size = image_size;
+  config.buffer_size = TEST_BUFFER_SIZE;
+  config.progress_ms = 0;
+  config.progress_cb = progress ? test_progress : NULL;
+  config.ctx = progress;
+  err = ota_writer_begin( &ota, &config );
+  if( err != ESP_OK )
+  {
+    return err;
+  }
+  while( (err == ESP_OK) && (offset < len) )
+  {
+    chunk = 1u + (test_random() % 6000u);
+    chunk = (chunk < (len - offset)) ? chunk : (len - offset);
+    err = ota_writer_write( &ota, &data[offset], chunk );
+    offset += chunk;
+  }
+  if( err != ESP_OK )
+  {
+    ota_writer_abort( &ota );
+    return err;
+  }
+  return ota_writer_finish( &ota, sha256 );
+}
+
+static bool test_flash_is_image( size_t len )
+{
+  return memcmp( esp_ota_host_flash(), test_image, len ) == 0;
+}
+
+/**
+ * @brief Test image: image header, segment header, application description
+ *        and a body of repeated sequences with random bytes between them,
+ *        which compresses to about half like code does
+ */
+static void test_make_image( void )
+{
+  esp_image_header_t header = { .magic = ESP_IMAGE_HEADER_MAGIC, .segment_count = 1, .entry_addr = 0x40080000 };
+  esp_image_segment_header_t segment = { .load_addr = 0x3F400020, .data_len = 0 };
+  esp_app_desc_t desc = { .magic_word = ESP_APP_DESC_MAGIC_WORD, .version = "v2.0-test", \
+                          .project_name = "WeatherStationServer", .time = "12:00:00", .date = "Oct 19 2026", \
+                          .idf_ver = "v5.1.2" };
+  uint8_t dictionary[512];
+  size_t offset = 0, run;
+  mbedtls_sha256_context sha;
+  FILE *f;
+
+  test_image = malloc( TEST_IMAGE_SIZE );
+  for( size_t idx = 0; idx < sizeof(desc.app_elf_sha256); idx++ )
+  {
+    desc.app_elf_sha256[idx] = (uint8_t)(0xA0u + idx);
+  }
+  segment.data_len = TEST_IMAGE_SIZE - sizeof(header) - sizeof(segment);
+  memcpy( &test_image[offset], &header, sizeof(header) );
+  offset += sizeof(header);
+  memcpy( &test_image[offset], &segment, sizeof(segment) );
+  offset += sizeof(segment);
+  memcpy( &test_image[offset], &desc, sizeof(desc) );
+  offset += sizeof(desc);
+
+  for( size_t idx = 0; idx < sizeof(dictionary); idx++ )
+  {
+    dictionary[idx] = (uint8_t)test_random();
+  }
+  while( offset < TEST_IMAGE_SIZE )
+  {
+    if( test_random() % 2u )
+    {
+      run = 3u + (test_random() % 12u);
+      run = (run < (TEST_IMAGE_SIZE - offset)) ? run : (TEST_IMAGE_SIZE - offset);
+      memcpy( &test_image[offset], &dictionary[test_random() % (sizeof(dictionary) - 16u)], run );
+      offset += run;
+    }
+    else
+    {
+      test_image[offset++] = (uint8_t)test_random();
+    }
+  }
+
+  mbedtls_sha256_init( &sha );
+  mbedtls_sha256_starts( &sha, 0 );
+  mbedtls_sha256_update( &sha, test_image, TEST_IMAGE_SIZE );
+  mbedtls_sha256_finish( &sha, test_sha256 );
+  mbedtls_sha256_free( &sha );
+
+  f = fopen( TEST_IMAGE, "wb" );
+  if( f != NULL )
+  {
+    fwrite( test_image, 1, TEST_IMAGE_SIZE, f );
+    fclose( f );
+  }
+}
+
+/**
+ * @brief Compress the test image with tools/ota_compress.py and load it
+ */
+static bool test_compress( const char *tool, int wbits, const char *output, test_file_t *file )
+{
+  char command[512];
+  FILE *f;
+  long len;
+
+  snprintf( command, sizeof(command), "python3 %s %s %s --wbits %d > /dev/null", tool, TEST_IMAGE, output, wbits );
+  if( system(command) != 0 )
+  {
+    return false;
+  }
+  f = fopen( output, "rb" );
+  if( f == NULL )
+  {
+    return false;
+  }
+  fseek( f, 0, SEEK_END );
+  len = ftell( f );
+  fseek( f, 0, SEEK_SET );
+  file->data = malloc( (size_t)len );
+  file->len = fread( file->data, 1, (size_t)len, f );
+  fclose( f );
+  return file->len == (size_t)len;
+}
+
+static void test_progress( void *ctx, size_t processed, size_t written )
+{
+  test_progress_t *progress = (test_progress_t *)ctx;
+
+  progress->processed = processed;
+  progress->written = written;
+  progress->calls++;
+}
+
+/**
+ * @brief Heap in use of the whole process, zlib allocates with malloc too
+ */
+static size_t test_heap_in_use( void )
+{
+#if defined(__SANITIZE_ADDRESS__)
+  return __sanitizer_get_current_allocated_bytes();
+#else
+  return mallinfo2().uordblks;
+#endif
+}
+
+// called in the writer task at every flash write, the inflate state and
+// window are allocated then
+static void test_heap_sample( void )
+{
+  size_t used = test_heap_in_use();
+
+  if( used > test_heap_peak )
+  {
+    test_heap_peak = used;
+  }
+}
+
+static uint32_t test_random( void )
+{
+  test_seed = (test_seed * 1103515245u) + 12345u;
+  return test_seed >> 8;
+}
+
+static bool test_sha256_known( void )
+{
+  static const uint8_t expected[OTA_WRITER_SHA256_LEN] =
+  {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+  };
+  uint8_t sha256[OTA_WRITER_SHA256_LEN];
+  mbedtls_sha256_context sha;
+
+  mbedtls_sha256_init( &sha );
+  mbedtls_sha256_starts( &sha, 0 );
+  mbedtls_sha256_update( &sha, (const unsigned char *)"abc", 3 );
+  mbedtls_sha256_finish( &sha, sha256 );
+  mbedtls_sha256_free( &sha );
+  return memcmp( sha256, expected, sizeof(sha256) ) == 0;
+}
+
+/**
+ * @brief zlib stream with the window of the writer, out has room for len
+ * @return stream length
+ */
+static size_t test_deflate( const uint8_t *data, size_t len, uint8_t *out )
+{
+  z_stream zs;
+
+  memset( &zs, 0x00, sizeof(zs) );
+  deflateInit2( &zs, 9, Z_DEFLATED, TEST_WBITS, 8, Z_DEFAULT_STRATEGY );
+  zs.next_in = (Bytef *)data;
+  zs.avail_in = len;
+  zs.next_out = out;
+  zs.avail_out = len;
+  deflate( &zs, Z_FINISH );
+  deflateEnd( &zs );
+  return len - zs.avail_out;
+}
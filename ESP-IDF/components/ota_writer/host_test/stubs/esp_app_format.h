@@ -0,0 +1,55 @@
+/*
+ * esp_app_format.h
+ *
+ * Host build stub, the layout of the image header and the application
+ * description of ESP-IDF
+ */
+#ifndef ESP_APP_FORMAT_H_
+#define ESP_APP_FORMAT_H_
+
+#include <stdint.h>
+
+#define ESP_IMAGE_HEADER_MAGIC              (0xE9)
+#define ESP_APP_DESC_MAGIC_WORD             (0xABCD5432u)
+
+typedef struct __attribute__((packed))
+{
+  uint8_t   magic;
+  uint8_t   segment_count;
+  uint8_t   spi_mode;
+  uint8_t   spi_speed_size;
+  uint32_t  entry_addr;
+  uint8_t   wp_pin;
+  uint8_t   spi_pin_drv[3];
+  uint16_t  chip_id;
+  uint8_t   min_chip_rev;
+  uint16_t  min_chip_rev_full;
+  uint16_t  max_chip_rev_full;
+  uint8_t   reserved[4];
+  uint8_t   hash_appended;
+} esp_image_header_t;
+
+typedef struct
+{
+  uint32_t  load_addr;
+  uint32_t  data_len;
+} esp_image_segment_header_t;
+
+typedef struct
+{
+  uint32_t  magic_word;
+  uint32_t  secure_version;
+  uint32_t  reserv1[2];
+  char      version[32];
+  char      project_name[32];
+  char      time[16];
+  char      date[16];
+  char      idf_ver[32];
+  uint8_t   app_elf_sha256[32];
+  uint32_t  reserv2[20];
+} esp_app_desc_t;
+
+_Static_assert( sizeof(esp_image_header_t) == 24, "image header is 24 bytes" );
+_Static_assert( sizeof(esp_app_desc_t) == 256, "application description is 256 bytes" );
+
+#endif /* ESP_APP_FORMAT_H_ */
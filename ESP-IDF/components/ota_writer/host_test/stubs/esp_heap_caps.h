@@ -0,0 +1,16 @@
+/*
+ * esp_heap_caps.h
+ *
+ * Host build stub, the capabilities are ignored
+ */
+#ifndef ESP_HEAP_CAPS_H_
+#define ESP_HEAP_CAPS_H_
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_DEFAULT                  (1u << 12)
+#define MALLOC_CAP_DMA                      (1u << 3)
+
+#define heap_caps_aligned_alloc( align, size, caps )  aligned_alloc( (align), (size) )
+
+#endif /* ESP_HEAP_CAPS_H_ */
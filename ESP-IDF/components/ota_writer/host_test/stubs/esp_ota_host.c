@@ -0,0 +1,457 @@
+/*
+ * esp_ota_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * The OTA and partition calls of ESP-IDF for the host build of the OTA
+ * components. The update partition is a RAM array with the behaviour of NOR
+ * flash: erase sets a 4 KB sector to 0xFF, programming only clears bits, so a
+ * write over flash that wasn't erased is counted (and would corrupt the image
+ * on a device). esp_ota_begin erases like ESP-IDF: the image size if known,
+ * else the whole partition, or sector by sector while writing with
+ * OTA_WITH_SEQUENTIAL_WRITES. esp_ota_write rejects an image which doesn't
+ * start with the image magic, the validation at the end checks only the
+ * magic. The benchmark sets a time per sector erase, per 64 KB block erase
+ * and per 256 byte page, the calls then sleep like the flash chip is busy.
+ * Like esp_flash_erase_region, a range is erased in blocks where it is block
+ * aligned. The SHA-256 of mbedtls is a plain C one (SHA-224 is not
+ * supported), it doesn't allocate, so the heap the test sees is the one of
+ * the writer.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "esp_ota_ops.h"
+#include "mbedtls/sha256.h"
+
+#define OTA_HOST_SECTOR                     (4096u)
+#define OTA_HOST_BLOCK                      (65536u)
+#define OTA_HOST_PAGE                       (256u)
+#define OTA_HOST_HANDLE                     (0x55u)
+
+static const esp_partition_t ota_host_partition =
+{
+  .address = 0x210000,
+  .size = 0x200000,
+  .label = "ota_1",
+};
+
+static pthread_mutex_t ota_host_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint8_t *ota_host_data = NULL;
+static esp_ota_host_stats_t ota_host_stats = { 0 };
+static esp_app_desc_t ota_host_running = { .magic_word = ESP_APP_DESC_MAGIC_WORD, .version = "host" };
+static uint32_t ota_host_sector_us = 0;
+static uint32_t ota_host_block_us = 0;
+static uint32_t ota_host_page_us = 0;
+// the one OTA handle
+static bool ota_host_open = false;
+static bool ota_host_sequential = false;
+static size_t ota_host_wrote = 0;
+static size_t ota_host_erased = 0;            // erased from the partition begin, sequential writes
+
+void (*esp_ota_host_write_hook)( void ) = NULL;
+
+static uint8_t * ota_host_flash( void );
+static void ota_host_erase( size_t offset, size_t size );
+static void ota_host_program( size_t offset, const uint8_t *data, size_t size );
+static void ota_host_sleep( uint64_t us );
+static void ota_host_sha256_block( mbedtls_sha256_context *ctx );
+
+const esp_partition_t * esp_ota_get_next_update_partition( const esp_partition_t *start )
+{
+  (void)start;
+  return &ota_host_partition;
+}
+
+esp_err_t esp_ota_begin( const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle )
+{
+  if( partition != &ota_host_partition )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( (image_size != OTA_SIZE_UNKNOWN) && (image_size != OTA_WITH_SEQUENTIAL_WRITES) && \
+      (image_size > partition->size) )
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  pthread_mutex_lock( &ota_host_lock );
+  if( ota_host_open )
+  {
+    pthread_mutex_unlock( &ota_host_lock );
+    return ESP_ERR_INVALID_STATE;
+  }
+  ota_host_open = true;
+  ota_host_sequential = (image_size == OTA_WITH_SEQUENTIAL_WRITES);
+  ota_host_wrote = 0;
+  ota_host_erased = 0;
+  ota_host_stats.begins++;
+  pthread_mutex_unlock( &ota_host_lock );
+
+  if( image_size == OTA_SIZE_UNKNOWN )
+  {
+    ota_host_erase( 0, partition->size );
+  }
+  else if( ota_host_sequential == false )
+  {
+    ota_host_erase( 0, (image_size + OTA_HOST_SECTOR - 1u) & ~(OTA_HOST_SECTOR - 1u) );
+  }
+  *out_handle = OTA_HOST_HANDLE;
+  return ESP_OK;
+}
+
+esp_err_t esp_ota_write( esp_ota_handle_t handle, const void *data, size_t size )
+{
+  const uint8_t *bytes = (const uint8_t *)data;
+  size_t end = ota_host_wrote + size;
+
+  if( (handle != OTA_HOST_HANDLE) || !ota_host_open )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( end > ota_host_partition.size )
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if( (ota_host_wrote == 0u) && size && (bytes[0] != ESP_IMAGE_HEADER_MAGIC) )
+  {
+    return ESP_ERR_OTA_VALIDATE_FAILED;
+  }
+  if( ota_host_sequential && (end > ota_host_erased) )
+  {
+    end = (end + OTA_HOST_SECTOR - 1u) & ~(OTA_HOST_SECTOR - 1u);
+    ota_host_erase( ota_host_erased, end - ota_host_erased );
+    ota_host_erased = end;
+  }
+  ota_host_program( ota_host_wrote, bytes, size );
+  ota_host_wrote += size;
+  return ESP_OK;
+}
+
+esp_err_t esp_ota_end( esp_ota_handle_t handle )
+{
+  esp_err_t err = ESP_OK;
+
+  if( (handle != OTA_HOST_HANDLE) || !ota_host_open )
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if( (ota_host_wrote < sizeof(esp_image_header_t)) || (ota_host_flash()[0] != ESP_IMAGE_HEADER_MAGIC) )
+  {
+    err = ESP_ERR_OTA_VALIDATE_FAILED;
+  }
+  ota_host_open = false;
+  return err;
+}
+
+esp_err_t esp_ota_abort( esp_ota_handle_t handle )
+{
+  if( (handle != OTA_HOST_HANDLE) || !ota_host_open )
+  {
+    return ESP_ERR_NOT_FOUND;
+  }
+  ota_host_open = false;
+  ota_host_stats.aborts++;
+  return ESP_OK;
+}
+
+esp_err_t esp_ota_set_boot_partition( const esp_partition_t *partition )
+{
+  if( partition != &ota_host_partition )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( ota_host_flash()[0] != ESP_IMAGE_HEADER_MAGIC )
+  {
+    return ESP_ERR_OTA_VALIDATE_FAILED;
+  }
+  ota_host_stats.boot_sets++;
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_read( const esp_partition_t *partition, size_t offset, void *dst, size_t size )
+{
+  if( (partition != &ota_host_partition) || ((offset + size) > partition->size) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memcpy( dst, &ota_host_flash()[offset], size );
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write( const esp_partition_t *partition, size_t offset, const void *src, size_t size )
+{
+  if( (partition != &ota_host_partition) || ((offset + size) > partition->size) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  ota_host_program( offset, (const uint8_t *)src, size );
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range( const esp_partition_t *partition, size_t offset, size_t size )
+{
+  if( (partition != &ota_host_partition) || ((offset + size) > partition->size) || \
+      (offset % OTA_HOST_SECTOR) || (size % OTA_HOST_SECTOR) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  ota_host_erase( offset, size );
+  return ESP_OK;
+}
+
+const esp_app_desc_t * esp_app_get_description( void )
+{
+  return &ota_host_running;
+}
+
+const uint8_t * esp_ota_host_flash( void )
+{
+  return ota_host_flash();
+}
+
+void esp_ota_host_get_stats( esp_ota_host_stats_t *stats )
+{
+  pthread_mutex_lock( &ota_host_lock );
+  *stats = ota_host_stats;
+  pthread_mutex_unlock( &ota_host_lock );
+}
+
+void esp_ota_host_reset( void )
+{
+  pthread_mutex_lock( &ota_host_lock );
+  memset( &ota_host_stats, 0x00, sizeof(ota_host_stats) );
+  ota_host_open = false;
+  pthread_mutex_unlock( &ota_host_lock );
+  // an old image must not pass for the new one
+  memset( ota_host_flash(), 0x00, ota_host_partition.size );
+}
+
+void esp_ota_host_set_timing( uint32_t sector_us, uint32_t block_us, uint32_t page_us )
+{
+  ota_host_sector_us = sector_us;
+  ota_host_block_us = block_us;
+  ota_host_page_us = page_us;
+}
+
+void esp_ota_host_set_running( const esp_app_desc_t *desc )
+{
+  ota_host_running = *desc;
+}
+
+const char * esp_err_to_name( esp_err_t code )
+{
+  static __thread char name[16];
+
+  switch( code )
+  {
+    case ESP_OK:                      return "ESP_OK";
+    case ESP_FAIL:                    return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:              return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:         return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:       return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:           return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:       return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:             return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:    return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC:         return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION:     return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_NVS_NOT_FOUND:       return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_OTA_VALIDATE_FAILED: return "ESP_ERR_OTA_VALIDATE_FAILED";
+    case ESP_ERR_HTTP_CONNECT:        return "ESP_ERR_HTTP_CONNECT";
+    default:
+      snprintf( name, sizeof(name), "0x%x", (unsigned)code );
+      return name;
+  }
+}
+
+void mbedtls_sha256_init( mbedtls_sha256_context *ctx )
+{
+  memset( ctx, 0x00, sizeof(mbedtls_sha256_context) );
+}
+
+int mbedtls_sha256_starts( mbedtls_sha256_context *ctx, int is224 )
+{
+  static const uint32_t init[8] =
+  {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+
+  if( is224 )
+  {
+    return -1;
+  }
+  ctx->total = 0;
+  memcpy( ctx->state, init, sizeof(init) );
+  return 0;
+}
+
+int mbedtls_sha256_update( mbedtls_sha256_context *ctx, const unsigned char *input, size_t len )
+{
+  size_t fill;
+
+  while( len )
+  {
+    fill = 64u - (size_t)(ctx->total % 64u);
+    fill = (len < fill) ? len : fill;
+    memcpy( &ctx->buffer[ctx->total % 64u], input, fill );
+    ctx->total += fill;
+    input += fill;
+    len -= fill;
+    if( (ctx->total % 64u) == 0u )
+    {
+      ota_host_sha256_block( ctx );
+    }
+  }
+  return 0;
+}
+
+int mbedtls_sha256_finish( mbedtls_sha256_context *ctx, unsigned char output[32] )
+{
+  uint64_t bits = ctx->total * 8u;
+  uint8_t pad[72] = { 0x80 };
+  size_t pad_len = ((ctx->total % 64u) < 56u) ? (56u - (ctx->total % 64u)) : (120u - (ctx->total % 64u));
+
+  for( uint8_t idx = 0; idx < 8u; idx++ )
+  {
+    pad[pad_len + idx] = (uint8_t)(bits >> (56u - (idx * 8u)));
+  }
+  mbedtls_sha256_update( ctx, pad, pad_len + 8u );
+  for( uint8_t idx = 0; idx < 32u; idx++ )
+  {
+    output[idx] = (uint8_t)(ctx->state[idx / 4u] >> (24u - ((idx % 4u) * 8u)));
+  }
+  return 0;
+}
+
+void mbedtls_sha256_free( mbedtls_sha256_context *ctx )
+{
+  memset( ctx, 0x00, sizeof(mbedtls_sha256_context) );
+}
+
+static uint8_t * ota_host_flash( void )
+{
+  pthread_mutex_lock( &ota_host_lock );
+  if( ota_host_data == NULL )
+  {
+    ota_host_data = calloc( 1, ota_host_partition.size );
+  }
+  pthread_mutex_unlock( &ota_host_lock );
+  return ota_host_data;
+}
+
+static void ota_host_erase( size_t offset, size_t size )
+{
+  uint64_t busy_us = 0;
+  uint32_t blocks = 0;
+  size_t end = offset + size;
+
+  memset( &ota_host_flash()[offset], 0xFF, size );
+  while( offset < end )
+  {
+    if( ((offset % OTA_HOST_BLOCK) == 0u) && ((end - offset) >= OTA_HOST_BLOCK) )
+    {
+      busy_us += ota_host_block_us;
+      blocks++;
+      offset += OTA_HOST_BLOCK;
+    }
+    else
+    {
+      busy_us += ota_host_sector_us;
+      offset += OTA_HOST_SECTOR;
+    }
+  }
+  pthread_mutex_lock( &ota_host_lock );
+  ota_host_stats.erases += (uint32_t)(size / OTA_HOST_SECTOR);
+  ota_host_stats.block_erases += blocks;
+  ota_host_stats.erase_calls++;
+  pthread_mutex_unlock( &ota_host_lock );
+  ota_host_sleep( busy_us );
+}
+
+static void ota_host_program( size_t offset, const uint8_t *data, size_t size )
+{
+  uint8_t *flash = ota_host_flash();
+  uint32_t dirty = 0;
+
+  for( size_t idx = 0; idx < size; idx++ )
+  {
+    // NOR flash: programming clears bits only
+    if( (data[idx] & ~flash[offset + idx]) != 0u )
+    {
+      dirty++;
+    }
+    flash[offset + idx] &= data[idx];
+  }
+  if( esp_ota_host_write_hook )
+  {
+    esp_ota_host_write_hook();
+  }
+  pthread_mutex_lock( &ota_host_lock );
+  ota_host_stats.writes++;
+  ota_host_stats.bytes += size;
+  ota_host_stats.dirty_writes += dirty;
+  pthread_mutex_unlock( &ota_host_lock );
+  ota_host_sleep( (uint64_t)ota_host_page_us * ((size + OTA_HOST_PAGE - 1u) / OTA_HOST_PAGE) );
+}
+
+static void ota_host_sleep( uint64_t us )
+{
+  struct timespec delay = { .tv_sec = (time_t)(us / 1000000u), .tv_nsec = (long)(us % 1000000u) * 1000L };
+
+  if( us )
+  {
+    nanosleep( &delay, NULL );
+  }
+}
+
+#define OTA_HOST_ROTR( x, n )               (((x) >> (n)) | ((x) << (32u - (n))))
+
+static void ota_host_sha256_block( mbedtls_sha256_context *ctx )
+{
+  static const uint32_t k[64] =
+  {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+  };
+  uint32_t w[64];
+  uint32_t v[8];
+  uint32_t t1, t2;
+
+  for( uint8_t idx = 0; idx < 16u; idx++ )
+  {
+    w[idx] = ((uint32_t)ctx->buffer[idx * 4u] << 24) | ((uint32_t)ctx->buffer[(idx * 4u) + 1u] << 16) | \
+             ((uint32_t)ctx->buffer[(idx * 4u) + 2u] << 8) | ctx->buffer[(idx * 4u) + 3u];
+  }
+  for( uint8_t idx = 16; idx < 64u; idx++ )
+  {
+    t1 = OTA_HOST_ROTR( w[idx - 2u], 17u ) ^ OTA_HOST_ROTR( w[idx - 2u], 19u ) ^ (w[idx - 2u] >> 10);
+    t2 = OTA_HOST_ROTR( w[idx - 15u], 7u ) ^ OTA_HOST_ROTR( w[idx - 15u], 18u ) ^ (w[idx - 15u] >> 3);
+    w[idx] = t1 + w[idx - 7u] + t2 + w[idx - 16u];
+  }
+  memcpy( v, ctx->state, sizeof(v) );
+  for( uint8_t idx = 0; idx < 64u; idx++ )
+  {
+    t1 = v[7] + (OTA_HOST_ROTR( v[4], 6u ) ^ OTA_HOST_ROTR( v[4], 11u ) ^ OTA_HOST_ROTR( v[4], 25u )) + \
+         ((v[4] & v[5]) ^ (~v[4] & v[6])) + k[idx] + w[idx];
+    t2 = (OTA_HOST_ROTR( v[0], 2u ) ^ OTA_HOST_ROTR( v[0], 13u ) ^ OTA_HOST_ROTR( v[0], 22u )) + \
+         ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+    memmove( &v[1], &v[0], 7u * sizeof(uint32_t) );
+    v[4] += t1;
+    v[0] = t1 + t2;
+  }
+  for( uint8_t idx = 0; idx < 8u; idx++ )
+  {
+    ctx->state[idx] += v[idx];
+  }
+}
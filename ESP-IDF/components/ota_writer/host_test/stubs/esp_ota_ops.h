@@ -0,0 +1,63 @@
+/*
+ * esp_ota_ops.h
+ *
+ * Host build stub, one update partition in RAM with the behaviour of NOR
+ * flash, see esp_ota_host.c
+ */
+#ifndef ESP_OTA_OPS_H_
+#define ESP_OTA_OPS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "esp_app_format.h"
+
+#define OTA_SIZE_UNKNOWN                    (0xFFFFFFFFu)
+#define OTA_WITH_SEQUENTIAL_WRITES          (0xFFFFFFFEu)
+
+typedef uint32_t esp_ota_handle_t;
+
+typedef struct
+{
+  uint32_t  address;
+  uint32_t  size;
+  char      label[17];
+} esp_partition_t;
+
+// flash statistics of the update partition
+typedef struct
+{
+  uint32_t  erases;                     // sectors erased
+  uint32_t  block_erases;               // 64 KB block erases, 16 of the sectors each
+  uint32_t  erase_calls;
+  uint32_t  writes;                     // write calls
+  size_t    bytes;                      // bytes programmed
+  uint32_t  dirty_writes;               // bytes programmed over not erased flash
+  uint32_t  begins;
+  uint32_t  aborts;
+  uint32_t  boot_sets;                  // esp_ota_set_boot_partition succeeded
+} esp_ota_host_stats_t;
+
+const esp_partition_t * esp_ota_get_next_update_partition( const esp_partition_t *start );
+esp_err_t esp_ota_begin( const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle );
+esp_err_t esp_ota_write( esp_ota_handle_t handle, const void *data, size_t size );
+esp_err_t esp_ota_end( esp_ota_handle_t handle );
+esp_err_t esp_ota_abort( esp_ota_handle_t handle );
+esp_err_t esp_ota_set_boot_partition( const esp_partition_t *partition );
+esp_err_t esp_partition_read( const esp_partition_t *partition, size_t offset, void *dst, size_t size );
+esp_err_t esp_partition_write( const esp_partition_t *partition, size_t offset, const void *src, size_t size );
+esp_err_t esp_partition_erase_range( const esp_partition_t *partition, size_t offset, size_t size );
+const esp_app_desc_t * esp_app_get_description( void );
+
+// host side, the partition content, statistics and flash timing
+const uint8_t * esp_ota_host_flash( void );
+void esp_ota_host_get_stats( esp_ota_host_stats_t *stats );
+void esp_ota_host_reset( void );
+void esp_ota_host_set_timing( uint32_t sector_us, uint32_t block_us, uint32_t page_us );
+void esp_ota_host_set_running( const esp_app_desc_t *desc );
+// called with every flash write, e.g. to sample the heap in use
+extern void (*esp_ota_host_write_hook)( void );
+
+#endif /* ESP_OTA_OPS_H_ */
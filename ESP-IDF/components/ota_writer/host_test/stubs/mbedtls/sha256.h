@@ -0,0 +1,25 @@
+/*
+ * sha256.h
+ *
+ * Host build stub, the SHA-256 of mbedtls, see esp_ota_host.c
+ */
+#ifndef MBEDTLS_SHA256_H_
+#define MBEDTLS_SHA256_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+  uint64_t  total;                      // bytes hashed
+  uint32_t  state[8];
+  uint8_t   buffer[64];
+} mbedtls_sha256_context;
+
+void mbedtls_sha256_init( mbedtls_sha256_context *ctx );
+int mbedtls_sha256_starts( mbedtls_sha256_context *ctx, int is224 );
+int mbedtls_sha256_update( mbedtls_sha256_context *ctx, const unsigned char *input, size_t len );
+int mbedtls_sha256_finish( mbedtls_sha256_context *ctx, unsigned char output[32] );
+void mbedtls_sha256_free( mbedtls_sha256_context *ctx );
+
+#endif /* MBEDTLS_SHA256_H_ */
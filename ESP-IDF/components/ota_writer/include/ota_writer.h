@@ -0,0 +1,169 @@
+/*
+ * ota_writer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Pipelined firmware writer for all the OTA sources (web page upload, HTTP
+ * download, SD card). The receiver copies the image into one of two buffers
+ * while a writer task erases and programs the flash from the other one, so
+ * receiving continues during the flash erase and the update takes as long as
+ * the slower of both instead of their sum. The writer task also computes the
+ * SHA-256 of the image, it is checked against the expected one in finish.
+ * Progress is given to a callback in the writer task, at most every
+ * progress_ms. Memory: 2 * buffer_size plus the task stack.
+ *
+ * Compressed images: a zlib stream of the application image (made by
+ * tools/ota_compress.py) is detected by its header and inflated by the writer
+ * task, with one more buffer_size for the output and the inflate window
+ * (2^CONFIG_OTA_WRITER_WINDOW_BITS + ~7 KB). As the image size isn't known,
+ * the partition is erased in 64 KB blocks ahead of writing, a block erase
+ * takes about as long as 3 of the 16 sector erases esp_ota_write would do.
+ * The image is then written with esp_partition_write and validated by
+ * esp_ota_set_boot_partition, the same for a plain image without image_size.
+ * The SHA-256 is the one of the uncompressed image, as it is in flash.
+ * ota_writer_check_image inflates the start of a compressed image to check
+ * it.
+ *
+ * Resume: an interrupted download (ota_client) continues with the offset of
+ * the image already in the partition. The writer hashes this part from flash,
+ * erases the rest of the image and writes with esp_partition_write, as
+ * esp_ota_write always starts at the partition begin. The image is validated
+ * by esp_ota_set_boot_partition. Only plain images can be resumed.
+ *
+ * Only one update can run at a time, ota_writer_begin fails for a second one.
+ *
+ * Zero copy: a receiver which reads into memory (file, SD card) gets the free
+ * part of the fill buffer with ota_writer_get_buffer and reads directly into
+ * it. The buffers are allocated with buffer_caps, MALLOC_CAP_DMA keeps them
+ * in internal RAM so the SD driver transfers multi-sector reads by DMA
+ * instead of one sector at a time through its bounce buffer.
+ *
+ * Usage:
+ *   ota_writer_begin( &ota, &config );
+ *   ota_writer_write( &ota, data, len );   // for every chunk, blocks while both buffers are full
+ *   ota_writer_finish( &ota, sha256 );     // or ota_writer_abort( &ota ) if receiving failed
+ *
+ *   ota_writer_get_buffer( &ota, &data, &size );   // zero copy instead of ota_writer_write
+ *   len = read( fd, data, size );
+ *   ota_writer_commit( &ota, len );
+ */
+
+#ifndef OTA_WRITER_H_
+#define OTA_WRITER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_app_format.h"
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "esp_ota_ops.h"
+#include "mbedtls/sha256.h"
+#include "zlib.h"
+
+#define OTA_WRITER_SHA256_LEN           (32u)
+#define OTA_WRITER_SECTOR_SIZE          (4096u)   // flash erase unit, resume offsets are aligned to it
+#define OTA_WRITER_BUFFER_ALIGN         (32u)     // buffers are DMA aligned, also for cached memory
+// image header, first segment header and application description, ota_writer_check_image
+#define OTA_WRITER_IMAGE_CHECK_LEN      (sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + \
+                                         sizeof(esp_app_desc_t))
+// start of a compressed image, it inflates to more than OTA_WRITER_IMAGE_CHECK_LEN
+#define OTA_WRITER_COMPRESSED_CHECK_LEN (1024u)
+
+/**
+ * @brief Progress callback, called in the writer task
+ * @param ctx user context given in the configuration
+ * @param processed bytes of ota_writer_write data handled, compressed size
+ *                  for a compressed image
+ * @param written image bytes in flash, including the resume offset
+ */
+typedef void (*ota_writer_progress_t)( void *ctx, size_t processed, size_t written );
+
+typedef struct _ota_writer_config_t
+{
+  const esp_partition_t *partition;     // NULL for the next update partition
+  size_t    image_size;                 // 0 if not known, else only this size is erased,
+                                        // for a compressed image it is the compressed size
+  size_t    offset;                     // image bytes already in the partition (resume), sector
+                                        // aligned, needs image_size, 0 for a new update
+  size_t    buffer_size;                // each of the two buffers
+  uint32_t  buffer_caps;                // heap capabilities of the buffers, MALLOC_CAP_DMA for SD reads
+  uint32_t  progress_ms;                // minimum time between progress callbacks
+  ota_writer_progress_t progress_cb;    // can be NULL
+  void      *ctx;
+  uint32_t  task_stack;
+  UBaseType_t task_priority;            // above the receiver, so a full buffer is written at once
+} ota_writer_config_t;
+
+typedef struct _ota_writer_buf_t
+{
+  uint8_t   *data;
+  size_t    len;
+} ota_writer_buf_t;
+
+typedef struct _ota_writer_t
+{
+  const esp_partition_t *partition;
+  esp_ota_handle_t  handle;
+  TaskHandle_t      task;
+  QueueHandle_t     full_q;             // buffers to be written, NULL ends the task
+  QueueHandle_t     free_q;             // written buffers, back to the receiver
+  SemaphoreHandle_t done;               // writer task has ended
+  ota_writer_buf_t  buffers[2];
+  ota_writer_buf_t  *fill;              // buffer filled by the receiver
+  size_t            buffer_size;
+  size_t            image_size;
+  size_t            offset;             // resumed at this image offset, 0 if not resumed
+  size_t            received;           // bytes given by the receiver
+  size_t            processed;          // received bytes handled by the writer task
+  size_t            written;            // image bytes in flash, including the resume offset
+  volatile esp_err_t error;             // first error of the writer task
+  bool              begun;              // esp_ota_begin is done
+  bool              erase_ahead;        // written with esp_partition_write, erased in blocks
+  size_t            erased;             // partition bytes erased ahead
+  bool              compressed;         // image is a zlib stream
+  bool              inflate_end;        // end of zlib stream is reached
+  z_stream          zs;
+  uint8_t           *out;               // inflate output, buffer_size
+  mbedtls_sha256_context sha;
+  uint8_t           sha256[OTA_WRITER_SHA256_LEN];  // image hash, valid after finish
+  ota_writer_progress_t progress_cb;
+  void              *ctx;
+  int64_t           progress_us;        // time of the last progress callback
+  int64_t           progress_period_us;
+  int64_t           start_us;
+} ota_writer_t;
+
+// a 4 KB buffer is one flash sector
+#define OTA_WRITER_CONFIG_DEFAULT()     \
+{                                       \
+  .partition = NULL,                    \
+  .image_size = 0,                      \
+  .offset = 0,                          \
+  .buffer_size = 4096,                  \
+  .buffer_caps = MALLOC_CAP_DEFAULT,    \
+  .progress_ms = 1000,                  \
+  .progress_cb = NULL,                  \
+  .ctx = NULL,                          \
+  .task_stack = 4096,                   \
+  .task_priority = 5,                   \
+}
+
+// Public Function Prototypes
+esp_err_t ota_writer_begin( ota_writer_t *ota, const ota_writer_config_t *config );
+esp_err_t ota_writer_write( ota_writer_t *ota, const void *data, size_t len );
+esp_err_t ota_writer_get_buffer( ota_writer_t *ota, uint8_t **data, size_t *size );
+esp_err_t ota_writer_commit( ota_writer_t *ota, size_t len );
+esp_err_t ota_writer_finish( ota_writer_t *ota, const uint8_t *sha256 );
+void ota_writer_abort( ota_writer_t *ota );
+esp_err_t ota_writer_sha256_parse( const char *hex, uint8_t *sha256 );
+esp_err_t ota_writer_check_image( const uint8_t *data, size_t len, bool force );
+bool ota_writer_is_compressed( const uint8_t *data, size_t len );
+
+#endif /* OTA_WRITER_H_ */
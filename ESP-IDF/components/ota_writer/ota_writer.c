@@ -0,0 +1,845 @@
+/*
+ * ota_writer.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <sys/param.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "ota_writer.h"
+
+// Private Macros
+#define OTA_WRITER_QUEUE_LEN            (3u)      // both buffers and the end marker
+#define OTA_WRITER_BLOCK_SIZE           (65536u)  // flash block erase, erase ahead of writing
+
+// Private Variables
+static const char *TAG = "OTA Writer";
+static portMUX_TYPE ota_writer_lock = portMUX_INITIALIZER_UNLOCKED;
+static bool ota_writer_busy = false;          // an update is running
+
+// Private Function Declaration
+static void ota_writer_task( void *arg );
+static esp_err_t ota_writer_start( ota_writer_t *ota, const ota_writer_buf_t *buf );
+static esp_err_t ota_writer_inflate( ota_writer_t *ota, const ota_writer_buf_t *buf );
+static esp_err_t ota_writer_flash( ota_writer_t *ota, const uint8_t *data, size_t len );
+static esp_err_t ota_writer_erase_ahead( ota_writer_t *ota, size_t len );
+static esp_err_t ota_writer_rehash( ota_writer_t *ota );
+static esp_err_t ota_writer_inflate_head( const uint8_t *data, size_t len, uint8_t *head );
+static esp_err_t ota_writer_check_size( ota_writer_t *ota, size_t len );
+static void ota_writer_submit( ota_writer_t *ota );
+static void ota_writer_stop( ota_writer_t *ota );
+static void ota_writer_free( ota_writer_t *ota );
+static int ota_writer_hex( char c );
+
+// Public Function Definition
+
+/**
+ * @brief Start an update, the writer task is started and erases the partition
+ *        with the first buffer (only image_size if known and the image is not
+ *        compressed, else block by block ahead of writing). A resumed update
+ *        hashes the image part already in flash first.
+ * @param ota writer
+ * @param config writer configuration
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if there is no update partition,
+ *         ESP_ERR_INVALID_SIZE if image doesn't fit, ESP_ERR_INVALID_ARG for
+ *         an invalid resume offset, ESP_ERR_INVALID_STATE if another update
+ *         is running, ESP_ERR_NO_MEM or error of reading the partition
+ */
+esp_err_t ota_writer_begin( ota_writer_t *ota, const ota_writer_config_t *config )
+{
+  ota_writer_buf_t *buf = NULL;
+  esp_err_t err;
+
+  memset( ota, 0x00, sizeof(ota_writer_t) );
+  ota->partition = config->partition ? config->partition : esp_ota_get_next_update_partition(NULL);
+  if( ota->partition == NULL )
+  {
+    ESP_LOGE(TAG, "No update partition");
+    return ESP_ERR_NOT_FOUND;
+  }
+  if( config->image_size > ota->partition->size )
+  {
+    ESP_LOGE(TAG, "Image of %u bytes doesn't fit in partition %s", (unsigned)config->image_size, ota->partition->label);
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if( config->offset && ((config->offset % OTA_WRITER_SECTOR_SIZE) || (config->offset >= config->image_size)) )
+  {
+    ESP_LOGE(TAG, "Invalid resume offset %u", (unsigned)config->offset);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  taskENTER_CRITICAL( &ota_writer_lock );
+  err = ota_writer_busy ? ESP_ERR_INVALID_STATE : ESP_OK;
+  ota_writer_busy = true;
+  taskEXIT_CRITICAL( &ota_writer_lock );
+  if( err != ESP_OK )
+  {
+    ESP_LOGE(TAG, "Another update is running");
+    return err;
+  }
+
+  ota->buffer_size = config->buffer_size;
+  ota->image_size = config->image_size;
+  ota->offset = config->offset;
+  ota->written = config->offset;
+  ota->progress_cb = config->progress_cb;
+  ota->ctx = config->ctx;
+  ota->progress_period_us = (int64_t)config->progress_ms * 1000;
+  ota->buffers[0].data = heap_caps_aligned_alloc( OTA_WRITER_BUFFER_ALIGN, ota->buffer_size, config->buffer_caps );
+  ota->buffers[1].data = heap_caps_aligned_alloc( OTA_WRITER_BUFFER_ALIGN, ota->buffer_size, config->buffer_caps );
+  ota->full_q = xQueueCreate( OTA_WRITER_QUEUE_LEN, sizeof(ota_writer_buf_t*) );
+  ota->free_q = xQueueCreate( OTA_WRITER_QUEUE_LEN, sizeof(ota_writer_buf_t*) );
+  ota->done = xSemaphoreCreateBinary();
+  if( (ota->buffers[0].data == NULL) || (ota->buffers[1].data == NULL) || \
+      (ota->full_q == NULL) || (ota->free_q == NULL) || (ota->done == NULL) )
+  {
+    ota_writer_free( ota );
+    return ESP_ERR_NO_MEM;
+  }
+
+  mbedtls_sha256_init( &ota->sha );
+  mbedtls_sha256_starts( &ota->sha, 0 );
+  if( ota->offset )
+  {
+    err = ota_writer_rehash( ota );
+    if( err != ESP_OK )
+    {
+      mbedtls_sha256_free( &ota->sha );
+      ota_writer_free( ota );
+      return err;
+    }
+  }
+  // receiver fills the first buffer, the second one is free
+  ota->fill = &ota->buffers[0];
+  buf = &ota->buffers[1];
+  xQueueSend( ota->free_q, &buf, 0 );
+
+  ota->start_us = esp_timer_get_time();
+  ota->progress_us = ota->start_us;
+  if( xTaskCreate(&ota_writer_task, "ota_writer", config->task_stack, ota, \
+                  config->task_priority, &ota->task) != pdPASS )
+  {
+    ota->task = NULL;
+    mbedtls_sha256_free( &ota->sha );
+    ota_writer_free( ota );
+    return ESP_ERR_NO_MEM;
+  }
+  ESP_LOGI(TAG, "Writing to partition %s at offset 0x%" PRIx32 ", image offset %u", ota->partition->label, \
+           ota->partition->address, (unsigned)ota->offset);
+  return ESP_OK;
+}
+
+/**
+ * @brief Write the next chunk of the image, it is copied to the fill buffer,
+ *        a full buffer is given to the writer task. Blocks only if the writer
+ *        task is still busy with the other buffer.
+ * @param ota writer
+ * @param data image data
+ * @param len data length
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if the image is too big, else the
+ *         error of the writer task (esp_ota_begin/esp_ota_write/inflate)
+ */
+esp_err_t ota_writer_write( ota_writer_t *ota, const void *data, size_t len )
+{
+  const uint8_t *bytes = (const uint8_t*)data;
+  size_t size;
+  esp_err_t err;
+
+  err = ota_writer_check_size( ota, len );
+  if( err != ESP_OK )
+  {
+    return err;
+  }
+
+  while( len )
+  {
+    size = ota->buffer_size - ota->fill->len;
+    size = (len < size) ? len : size;
+    memcpy( &ota->fill->data[ota->fill->len], bytes, size );
+    ota->fill->len += size;
+    ota->received += size;
+    bytes += size;
+    len -= size;
+    if( ota->fill->len == ota->buffer_size )
+    {
+      ota_writer_submit( ota );
+    }
+  }
+  return ota->error;
+}
+
+/**
+ * @brief Get the free part of the fill buffer, the receiver reads the next
+ *        chunk directly into it and passes its length to ota_writer_commit
+ * @param ota writer
+ * @param data output, free part of the fill buffer
+ * @param size output, bytes free in the fill buffer, never 0
+ * @return ESP_OK or the error of the writer task
+ */
+esp_err_t ota_writer_get_buffer( ota_writer_t *ota, uint8_t **data, size_t *size )
+{
+  *data = &ota->fill->data[ota->fill->len];
+  *size = ota->buffer_size - ota->fill->len;
+  return ota->error;
+}
+
+/**
+ * @brief Add the data read into the buffer of ota_writer_get_buffer to the
+ *        image, a full buffer is given to the writer task. Blocks only if the
+ *        writer task is still busy with the other buffer.
+ * @param ota writer
+ * @param len bytes read into the buffer, at most its size
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if the image is too big or len is more
+ *         than the buffer, else the error of the writer task
+ */
+esp_err_t ota_writer_commit( ota_writer_t *ota, size_t len )
+{
+  esp_err_t err;
+
+  if( len > (ota->buffer_size - ota->fill->len) )
+  {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  err = ota_writer_check_size( ota, len );
+  if( err != ESP_OK )
+  {
+    return err;
+  }
+
+  ota->fill->len += len;
+  ota->received += len;
+  if( ota->fill->len == ota->buffer_size )
+  {
+    ota_writer_submit( ota );
+  }
+  return ota->error;
+}
+
+/**
+ * @brief Write the rest of the image and wait for the writer task, check the
+ *        SHA-256, validate the image (esp_ota_end) and set it as boot partition
+ * @param ota writer, its resources are freed in any case
+ * @param sha256 expected SHA-256 of the image, NULL if not known
+ * @return ESP_OK if the image becomes active after restart, ESP_ERR_INVALID_CRC
+ *         on SHA-256 mismatch, ESP_ERR_OTA_VALIDATE_FAILED if image is invalid,
+ *         ESP_ERR_INVALID_SIZE if a compressed image is truncated, else the
+ *         error of the writer task
+ */
+esp_err_t ota_writer_finish( ota_writer_t *ota, const uint8_t *sha256 )
+{
+  char hex[(OTA_WRITER_SHA256_LEN * 2u) + 1u];
+  uint32_t duration_ms;
+  esp_err_t err;
+
+  if( ota->fill->len )
+  {
+    ota_writer_submit( ota );
+  }
+  ota_writer_stop( ota );
+  mbedtls_sha256_finish( &ota->sha, ota->sha256 );
+  mbedtls_sha256_free( &ota->sha );
+  for( uint8_t idx = 0; idx < OTA_WRITER_SHA256_LEN; idx++ )
+  {
+    sprintf( &hex[idx * 2u], "%02x", ota->sha256[idx] );
+  }
+  duration_ms = (uint32_t)((esp_timer_get_time() - ota->start_us) / 1000);
+  ESP_LOGI(TAG, "%u bytes written in %" PRIu32 " ms (%" PRIu32 " KB/s), SHA-256 %s", (unsigned)(ota->written - ota->offset), \
+           duration_ms, duration_ms ? (uint32_t)((ota->written - ota->offset) / duration_ms) : 0u, hex);
+  if( ota->compressed )
+  {
+    ESP_LOGI(TAG, "Compressed image of %u bytes (%" PRIu32 "%%)", (unsigned)ota->received, \
+             ota->written ? (uint32_t)((ota->received * 100u) / ota->written) : 0u);
+  }
+
+  err = ota->error;
+  if( (err == ESP_OK) && ota->compressed && !ota->inflate_end )
+  {
+    ESP_LOGE(TAG, "Compressed image is truncated");
+    err = ESP_ERR_INVALID_SIZE;
+  }
+  if( (err == ESP_OK) && (sha256 != NULL) && memcmp(sha256, ota->sha256, OTA_WRITER_SHA256_LEN) )
+  {
+    ESP_LOGE(TAG, "SHA-256 mismatch");
+    err = ESP_ERR_INVALID_CRC;
+  }
+
+  if( (err == ESP_OK) && ota->begun )
+  {
+    // esp_ota_end releases the handle also on error
+    ota->begun = false;
+    err = esp_ota_end( ota->handle );
+  }
+  if( err == ESP_OK )
+  {
+    // validates the image, the only check of a resumed one
+    err = esp_ota_set_boot_partition( ota->partition );
+  }
+  if( err == ESP_OK )
+  {
+    ESP_LOGI(TAG, "Next boot partition %s", ota->partition->label);
+  }
+  else
+  {
+    ESP_LOGE(TAG, "Update failed, %s", esp_err_to_name(err));
+  }
+  ota_writer_free( ota );
+  return err;
+}
+
+/**
+ * @brief Cancel the update, waits for the writer task and frees the resources
+ * @param ota writer
+ */
+void ota_writer_abort( ota_writer_t *ota )
+{
+  ota_writer_stop( ota );
+  mbedtls_sha256_free( &ota->sha );
+  ESP_LOGI(TAG, "Update aborted after %u bytes, %u bytes of the image in flash", (unsigned)ota->received, \
+           (unsigned)ota->written);
+  ota_writer_free( ota );
+}
+
+/**
+ * @brief Convert the hex string of a SHA-256 to binary
+ * @param hex 64 hex characters, upper or lower case
+ * @param sha256 output, OTA_WRITER_SHA256_LEN bytes
+ * @return ESP_OK or ESP_ERR_INVALID_ARG
+ */
+esp_err_t ota_writer_sha256_parse( const char *hex, uint8_t *sha256 )
+{
+  int high, low;
+
+  if( strlen(hex) != (OTA_WRITER_SHA256_LEN * 2u) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  for( uint8_t idx = 0; idx < OTA_WRITER_SHA256_LEN; idx++ )
+  {
+    high = ota_writer_hex( hex[idx * 2u] );
+    low = ota_writer_hex( hex[(idx * 2u) + 1u] );
+    if( (high < 0) || (low < 0) )
+    {
+      return ESP_ERR_INVALID_ARG;
+    }
+    sha256[idx] = (uint8_t)((high << 4) | low);
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Check the start of an image before updating, it must be an
+ *        application image and (unless forced) not the running firmware. The
+ *        start of a compressed image is inflated for the check.
+ * @param data start of the image, at least OTA_WRITER_IMAGE_CHECK_LEN bytes,
+ *             OTA_WRITER_COMPRESSED_CHECK_LEN for a compressed image
+ * @param len data length
+ * @param force accept the running firmware
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED if not an application image (or the
+ *         compressed data is too short or its window too big),
+ *         ESP_ERR_INVALID_VERSION if it has the ELF SHA-256 of the running
+ *         firmware, ESP_ERR_NO_MEM
+ */
+esp_err_t ota_writer_check_image( const uint8_t *data, size_t len, bool force )
+{
+  const esp_image_header_t *header = (const esp_image_header_t*)data;
+  const esp_app_desc_t *running = esp_app_get_description();
+  uint8_t head[OTA_WRITER_IMAGE_CHECK_LEN];
+  esp_app_desc_t desc;
+  esp_err_t err;
+
+  if( ota_writer_is_compressed(data, len) )
+  {
+    err = ota_writer_inflate_head( data, len, head );
+    if( err != ESP_OK )
+    {
+      return err;
+    }
+    header = (const esp_image_header_t*)head;
+    data = head;
+    len = sizeof(head);
+  }
+  if( (len < OTA_WRITER_IMAGE_CHECK_LEN) || (header->magic != ESP_IMAGE_HEADER_MAGIC) )
+  {
+    ESP_LOGE(TAG, "Not an application image");
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+  memcpy( &desc, &data[sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t)], sizeof(desc) );
+  // strings come from outside
+  desc.version[sizeof(desc.version) - 1u] = '\0';
+  desc.date[sizeof(desc.date) - 1u] = '\0';
+  desc.time[sizeof(desc.time) - 1u] = '\0';
+  ESP_LOGI(TAG, "Image firmware %s (%s %s), running %s (%s %s)", desc.version, desc.date, desc.time, \
+           running->version, running->date, running->time);
+  if( (force == false) && \
+      (memcmp(desc.app_elf_sha256, running->app_elf_sha256, sizeof(desc.app_elf_sha256)) == 0) )
+  {
+    ESP_LOGI(TAG, "Image is the running firmware");
+    return ESP_ERR_INVALID_VERSION;
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Tells if the image data is a zlib stream (tools/ota_compress.py)
+ * @param data start of the image
+ * @param len data length
+ * @return true for a zlib header
+ */
+bool ota_writer_is_compressed( const uint8_t *data, size_t len )
+{
+  // zlib header: deflate method, header check is a multiple of 31
+  return (len >= 2u) && ((data[0] & 0x0Fu) == Z_DEFLATED) && \
+         ((((uint16_t)data[0] << 8) | data[1]) % 31u == 0u);
+}
+
+// Private Function Definition
+
+/**
+ * @brief Writer task, erases the partition and writes (or inflates) the
+ *        buffers it gets from the receiver. After an error the buffers are only
+ *        given back, so the receiver never blocks, it gets the error with the
+ *        next write.
+ * @param arg writer
+ */
+static void ota_writer_task( void *arg )
+{
+  ota_writer_t *ota = (ota_writer_t*)arg;
+  ota_writer_buf_t *buf = NULL;
+  int64_t now_us;
+  esp_err_t err = ESP_OK;
+
+  while( (xQueueReceive(ota->full_q, &buf, portMAX_DELAY) == pdTRUE) && (buf != NULL) )
+  {
+    if( ota->error == ESP_OK )
+    {
+      // first buffer tells if the image is compressed, the receiver fills the
+      // other buffer during the erase
+      if( ota->processed == 0u )
+      {
+        err = ota_writer_start( ota, buf );
+      }
+      if( err == ESP_OK )
+      {
+        err = ota->compressed ? ota_writer_inflate( ota, buf ) : ota_writer_flash( ota, buf->data, buf->len );
+      }
+      if( err != ESP_OK )
+      {
+        ota->error = err;
+      }
+    }
+    ota->processed += buf->len;
+    buf->len = 0;
+    xQueueSend( ota->free_q, &buf, portMAX_DELAY );
+
+    now_us = esp_timer_get_time();
+    if( ota->progress_cb && ((now_us - ota->progress_us) >= ota->progress_period_us) )
+    {
+      ota->progress_us = now_us;
+      ota->progress_cb( ota->ctx, ota->processed, ota->written );
+    }
+  }
+
+  // last progress is always reported
+  if( ota->progress_cb )
+  {
+    ota->progress_cb( ota->ctx, ota->processed, ota->written );
+  }
+  xSemaphoreGive( ota->done );
+  vTaskDelete( NULL );
+}
+
+/**
+ * @brief Detect the image type from its first bytes and begin the update.
+ *        The size of a compressed image in flash is not known, like a plain
+ *        one without image_size it is written to the partition and erased in
+ *        blocks while writing, esp_ota_write would erase sector by sector.
+ *        A resumed image starts in the middle, the rest of it is erased.
+ * @param ota writer
+ * @param buf first buffer of the image
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED if neither an application image nor a
+ *         zlib stream, ESP_ERR_NO_MEM or error of esp_ota_begin/erase
+ */
+static esp_err_t ota_writer_start( ota_writer_t *ota, const ota_writer_buf_t *buf )
+{
+  size_t image_size;
+  esp_err_t err;
+
+  if( ota->offset )
+  {
+    image_size = (ota->image_size + OTA_WRITER_SECTOR_SIZE - 1u) & ~(OTA_WRITER_SECTOR_SIZE - 1u);
+    err = esp_partition_erase_range( ota->partition, ota->offset, image_size - ota->offset );
+    if( err != ESP_OK )
+    {
+      ESP_LOGE(TAG, "Erase failed, %s", esp_err_to_name(err));
+    }
+    return err;
+  }
+
+  if( ota_writer_is_compressed(buf->data, buf->len) )
+  {
+    ota->out = malloc( ota->buffer_size );
+    if( ota->out == NULL )
+    {
+      return ESP_ERR_NO_MEM;
+    }
+    // window of the stream is checked against the configured one
+    if( inflateInit2(&ota->zs, CONFIG_OTA_WRITER_WINDOW_BITS) != Z_OK )
+    {
+      free( ota->out );
+      ota->out = NULL;
+      return ESP_ERR_NO_MEM;
+    }
+    ota->compressed = true;
+    ota->zs.next_out = ota->out;
+    ota->zs.avail_out = ota->buffer_size;
+    ESP_LOGI(TAG, "Compressed image");
+  }
+  else if( buf->data[0] != ESP_IMAGE_HEADER_MAGIC )
+  {
+    ESP_LOGE(TAG, "Unknown image format 0x%02x", buf->data[0]);
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+
+  // validated by esp_ota_set_boot_partition, like a resumed image
+  if( ota->compressed || (ota->image_size == 0u) )
+  {
+    ota->erase_ahead = true;
+    return ESP_OK;
+  }
+  err = esp_ota_begin( ota->partition, ota->image_size, &ota->handle );
+  if( err == ESP_OK )
+  {
+    ota->begun = true;
+  }
+  else
+  {
+    ESP_LOGE(TAG, "esp_ota_begin failed, %s", esp_err_to_name(err));
+  }
+  return err;
+}
+
+/**
+ * @brief Inflate a buffer of the compressed image, every full output buffer
+ *        and the rest at the end of the stream are written to flash
+ * @param ota writer
+ * @param buf compressed data
+ * @return ESP_OK, ESP_FAIL if the stream is corrupt or its window is bigger
+ *         than configured, ESP_ERR_INVALID_SIZE for data behind the stream end,
+ *         else error of esp_ota_write
+ */
+static esp_err_t ota_writer_inflate( ota_writer_t *ota, const ota_writer_buf_t *buf )
+{
+  esp_err_t err = ESP_OK;
+  bool full = false;
+  int ret;
+
+  if( ota->inflate_end )
+  {
+    ESP_LOGE(TAG, "Data behind the end of the compressed image");
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  ota->zs.next_in = buf->data;
+  ota->zs.avail_in = buf->len;
+  // also runs with no input left if the output was full, inflate may have more
+  while( (err == ESP_OK) && !ota->inflate_end && (ota->zs.avail_in || full) )
+  {
+    ret = inflate( &ota->zs, Z_NO_FLUSH );
+    if( ret == Z_STREAM_END )
+    {
+      ota->inflate_end = true;
+    }
+    else if( ret == Z_BUF_ERROR )
+    {
+      // no progress possible, needs the next buffer
+      break;
+    }
+    else if( ret != Z_OK )
+    {
+      ESP_LOGE(TAG, "Inflate failed at %u, %s", (unsigned)ota->processed, ota->zs.msg ? ota->zs.msg : "");
+      return ESP_FAIL;
+    }
+
+    full = (ota->zs.avail_out == 0u);
+    if( full || ota->inflate_end )
+    {
+      err = ota_writer_flash( ota, ota->out, ota->buffer_size - ota->zs.avail_out );
+      ota->zs.next_out = ota->out;
+      ota->zs.avail_out = ota->buffer_size;
+    }
+  }
+
+  if( (err == ESP_OK) && ota->inflate_end && ota->zs.avail_in )
+  {
+    ESP_LOGE(TAG, "Data behind the end of the compressed image");
+    err = ESP_ERR_INVALID_SIZE;
+  }
+  return err;
+}
+
+/**
+ * @brief Write image data to flash and add it to the SHA-256
+ * @param ota writer
+ * @param data image data
+ * @param len data length
+ * @return ESP_OK, ESP_ERR_OTA_VALIDATE_FAILED if a compressed image doesn't
+ *         inflate to an application image, else error of esp_ota_write,
+ *         esp_partition_write or the erase
+ */
+static esp_err_t ota_writer_flash( ota_writer_t *ota, const uint8_t *data, size_t len )
+{
+  esp_err_t err;
+
+  if( (ota->written == 0u) && len && (data[0] != ESP_IMAGE_HEADER_MAGIC) )
+  {
+    ESP_LOGE(TAG, "Not an application image");
+    return ESP_ERR_OTA_VALIDATE_FAILED;
+  }
+  if( ota->erase_ahead )
+  {
+    err = ota_writer_erase_ahead( ota, len );
+    if( err != ESP_OK )
+    {
+      return err;
+    }
+  }
+
+  if( ota->offset || ota->erase_ahead )
+  {
+    err = esp_partition_write( ota->partition, ota->written, data, len );
+  }
+  else
+  {
+    err = esp_ota_write( ota->handle, data, len );
+  }
+
+  if( err == ESP_OK )
+  {
+    mbedtls_sha256_update( &ota->sha, data, len );
+    ota->written += len;
+  }
+  else
+  {
+    ESP_LOGE(TAG, "esp_ota_write failed at %u, %s", (unsigned)ota->written, esp_err_to_name(err));
+  }
+  return err;
+}
+
+/**
+ * @brief Erase the partition in blocks ahead of the image data to be written,
+ *        the last block is cut at the partition end
+ * @param ota writer
+ * @param len bytes to be written at ota->written
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if the image doesn't fit in the
+ *         partition, else error of esp_partition_erase_range
+ */
+static esp_err_t ota_writer_erase_ahead( ota_writer_t *ota, size_t len )
+{
+  size_t end = ota->written + len;
+  size_t size;
+  esp_err_t err;
+
+  if( end <= ota->erased )
+  {
+    return ESP_OK;
+  }
+  if( end > ota->partition->size )
+  {
+    ESP_LOGE(TAG, "Image is bigger than partition %s", ota->partition->label);
+    return ESP_ERR_INVALID_SIZE;
+  }
+  size = ((end - ota->erased + OTA_WRITER_BLOCK_SIZE - 1u) / OTA_WRITER_BLOCK_SIZE) * OTA_WRITER_BLOCK_SIZE;
+  size = MIN( size, ota->partition->size - ota->erased );
+  err = esp_partition_erase_range( ota->partition, ota->erased, size );
+  if( err == ESP_OK )
+  {
+    ota->erased += size;
+  }
+  else
+  {
+    ESP_LOGE(TAG, "Erase failed at %u, %s", (unsigned)ota->erased, esp_err_to_name(err));
+  }
+  return err;
+}
+
+/**
+ * @brief Give the fill buffer to the writer task and take the other one,
+ *        waits if the writer task is still writing it
+ * @param ota writer
+ */
+static void ota_writer_submit( ota_writer_t *ota )
+{
+  xQueueSend( ota->full_q, &ota->fill, portMAX_DELAY );
+  xQueueReceive( ota->free_q, &ota->fill, portMAX_DELAY );
+}
+
+/**
+ * @brief Stop the writer task after the queued buffers are written
+ * @param ota writer
+ */
+static void ota_writer_stop( ota_writer_t *ota )
+{
+  ota_writer_buf_t *end = NULL;
+
+  if( ota->task != NULL )
+  {
+    xQueueSend( ota->full_q, &end, portMAX_DELAY );
+    xSemaphoreTake( ota->done, portMAX_DELAY );
+    ota->task = NULL;
+  }
+}
+
+/**
+ * @brief Hash the image part already in the partition of a resumed update,
+ *        the free buffer is used for reading
+ * @param ota writer
+ * @return ESP_OK or error of esp_partition_read
+ */
+static esp_err_t ota_writer_rehash( ota_writer_t *ota )
+{
+  esp_err_t err = ESP_OK;
+  size_t offset = 0;
+  size_t size;
+
+  while( (err == ESP_OK) && (offset < ota->offset) )
+  {
+    size = MIN( ota->buffer_size, ota->offset - offset );
+    err = esp_partition_read( ota->partition, offset, ota->buffers[1].data, size );
+    mbedtls_sha256_update( &ota->sha, ota->buffers[1].data, size );
+    offset += size;
+  }
+  if( err != ESP_OK )
+  {
+    ESP_LOGE(TAG, "Reading image from partition failed, %s", esp_err_to_name(err));
+  }
+  return err;
+}
+
+/**
+ * @brief Inflate the image header and application description from the start
+ *        of a compressed image, the inflate state and window are only
+ *        allocated during the call
+ * @param data start of the compressed image
+ * @param len data length
+ * @param head output, OTA_WRITER_IMAGE_CHECK_LEN bytes
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED if the data is corrupt, too short or
+ *         its window is bigger than configured, ESP_ERR_NO_MEM
+ */
+static esp_err_t ota_writer_inflate_head( const uint8_t *data, size_t len, uint8_t *head )
+{
+  z_stream zs;
+  esp_err_t err = ESP_OK;
+  int ret;
+
+  memset( &zs, 0x00, sizeof(zs) );
+  if( inflateInit2(&zs, CONFIG_OTA_WRITER_WINDOW_BITS) != Z_OK )
+  {
+    return ESP_ERR_NO_MEM;
+  }
+  zs.next_in = (Bytef*)data;
+  zs.avail_in = len;
+  zs.next_out = head;
+  zs.avail_out = OTA_WRITER_IMAGE_CHECK_LEN;
+  ret = inflate( &zs, Z_SYNC_FLUSH );
+  if( ((ret != Z_OK) && (ret != Z_STREAM_END) && (ret != Z_BUF_ERROR)) || zs.avail_out )
+  {
+    ESP_LOGE(TAG, "Compressed image can't be checked, %s", zs.msg ? zs.msg : "too short");
+    err = ESP_ERR_NOT_SUPPORTED;
+  }
+  inflateEnd( &zs );
+  return err;
+}
+
+/**
+ * @brief Check that len more bytes fit in the image
+ * @param ota writer
+ * @param len bytes to be added
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if the image is too big, else the
+ *         error of the writer task
+ */
+static esp_err_t ota_writer_check_size( ota_writer_t *ota, size_t len )
+{
+  size_t limit = ota->image_size ? ota->image_size : ota->partition->size;
+
+  if( ota->error != ESP_OK )
+  {
+    return ota->error;
+  }
+  // only image_size is erased, nothing may be written behind it
+  if( (ota->offset + ota->received + len) > limit )
+  {
+    ESP_LOGE(TAG, "Image is bigger than %u bytes", (unsigned)limit);
+    return ESP_ERR_INVALID_SIZE;
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Free the buffers and queues, abort the OTA handle if still open,
+ *        another update can begin afterwards
+ * @param ota writer
+ */
+static void ota_writer_free( ota_writer_t *ota )
+{
+  if( ota->begun )
+  {
+    esp_ota_abort( ota->handle );
+    ota->begun = false;
+  }
+  if( ota->out )
+  {
+    inflateEnd( &ota->zs );
+    free( ota->out );
+    ota->out = NULL;
+  }
+  free( ota->buffers[0].data );
+  free( ota->buffers[1].data );
+  ota->buffers[0].data = NULL;
+  ota->buffers[1].data = NULL;
+  if( ota->full_q )
+  {
+    vQueueDelete( ota->full_q );
+    ota->full_q = NULL;
+  }
+  if( ota->free_q )
+  {
+    vQueueDelete( ota->free_q );
+    ota->free_q = NULL;
+  }
+  if( ota->done )
+  {
+    vSemaphoreDelete( ota->done );
+    ota->done = NULL;
+  }
+  taskENTER_CRITICAL( &ota_writer_lock );
+  ota_writer_busy = false;
+  taskEXIT_CRITICAL( &ota_writer_lock );
+}
+
+/**
+ * @brief Value of a hex digit
+ * @param c character
+ * @return 0..15 or -1 if not a hex digit
+ */
+static int ota_writer_hex( char c )
+{
+  if( (c >= '0') && (c <= '9') )
+  {
+    return c - '0';
+  }
+  if( (c >= 'a') && (c <= 'f') )
+  {
+    return c - 'a' + 10;
+  }
+  if( (c >= 'A') && (c <= 'F') )
+  {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
@@ -0,0 +1,19 @@
+# ota_writer_compress_app()
+# Creates <project>.bin.zz next to the application image at every build, a zlib
+# compressed image the ota_writer inflates while flashing. Call it in the
+# project CMakeLists after project().
+function(ota_writer_compress_app)
+    idf_build_get_property(python PYTHON)
+    idf_build_get_property(build_dir BUILD_DIR)
+    idf_build_get_property(project_bin PROJECT_BIN)
+    idf_component_get_property(ota_writer_dir ota_writer COMPONENT_DIR)
+    set(compress_script ${ota_writer_dir}/tools/ota_compress.py)
+    set(app_bin ${build_dir}/${project_bin})
+
+    add_custom_target(ota_compressed_app ALL
+        COMMAND ${python} ${compress_script} ${app_bin} ${app_bin}.zz
+        BYPRODUCTS ${app_bin}.zz
+        COMMENT "Compressing application image ${project_bin}"
+        VERBATIM)
+    add_dependencies(ota_compressed_app app)
+endfunction()
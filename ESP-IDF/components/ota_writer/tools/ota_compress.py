@@ -0,0 +1,45 @@
+#!/usr/bin/env python
+#
+# ota_compress.py
+#
+#  Created on: Oct 19, 2026
+#      Author: xpress_embedo
+#
+# Compress an application image for the ota_writer component. The output is a
+# zlib stream, the window must not be bigger than CONFIG_OTA_WRITER_WINDOW_BITS
+# of the running firmware. The printed SHA-256 is the one of the uncompressed
+# image, it is the expected hash for the X-Firmware-SHA256 header.
+
+import argparse
+import hashlib
+import zlib
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compress an application image for OTA')
+    parser.add_argument('input', help='application image (.bin)')
+    parser.add_argument('output', nargs='?', help='compressed image, default <input>.zz')
+    parser.add_argument('--wbits', type=int, default=13, choices=range(9, 16),
+                        help='window bits, max CONFIG_OTA_WRITER_WINDOW_BITS (default 13)')
+    parser.add_argument('--level', type=int, default=9, choices=range(1, 10),
+                        help='compression level (default 9)')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        image = f.read()
+    if not image or image[0] != 0xE9:
+        parser.error('{} is not an application image'.format(args.input))
+
+    compressor = zlib.compressobj(args.level, zlib.DEFLATED, args.wbits)
+    data = compressor.compress(image) + compressor.flush()
+    output = args.output or args.input + '.zz'
+    with open(output, 'wb') as f:
+        f.write(data)
+
+    print('{}: {} bytes -> {} bytes ({:.1f}%)'.format(output, len(image), len(data),
+                                                     100.0 * len(data) / len(image)))
+    print('SHA-256 {}'.format(hashlib.sha256(image).hexdigest()))
+
+
+if __name__ == '__main__':
+    main()
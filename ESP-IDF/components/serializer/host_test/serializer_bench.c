@@ -0,0 +1,334 @@
+/*
+ * serializer_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host microbenchmark of the serializer, the time per field for every writer
+ * and value type. A record of BENCH_FIELDS fields is written again and again
+ * into a 1 KB buffer (a chain of 64 byte buffers for the chain case), the
+ * record start and end are part of the time. The snprintf cases write the
+ * same line protocol record like the uplinks did before, without escaping
+ * and without truncation check, as a reference. The strings of the escape
+ * cases contain a character to escape.
+ *
+ *  make -C components/serializer/host_test bench
+ *  build/serializer_bench [rounds]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "serializer.h"
+
+// Private Macros
+#define BENCH_FIELDS                        (10u)
+#define BENCH_ROUNDS                        (200000u)
+#define BENCH_BUF_SIZE                      (1024u)
+#define BENCH_CHAIN_SIZE                    (64u)
+#define BENCH_CHAIN_LEN                     (BENCH_BUF_SIZE / BENCH_CHAIN_SIZE)
+
+typedef size_t (*bench_record_t)( char *buffer, size_t size );
+
+typedef struct _bench_case_t
+{
+  const char      *name;
+  bench_record_t  record;
+} bench_case_t;
+
+// Private Variables
+static const char *bench_keys[BENCH_FIELDS] =
+{
+  "temperature", "humidity", "pressure", "wind_speed", "wind_dir",
+  "rain", "uv_index", "battery", "rssi", "uptime"
+};
+static const double bench_values[BENCH_FIELDS] =
+{
+  21.53, 40.2, 1013.25, 3.4, 270.0, 0.25, 5.1, 3.71, -67.0, 86400.0
+};
+static const char *bench_strings[BENCH_FIELDS] =
+{
+  "sensor-01", "living room", "ok", "north,east", "v2.1.0",
+  "s3", "say \"hi\"", "idle", "wifi", "main"
+};
+static char bench_buf[BENCH_BUF_SIZE];
+static volatile size_t bench_sink;            // keeps the compiler from dropping the work
+
+// Private Function Declaration
+static double bench_now( void );
+static void bench_run( const bench_case_t *bench, unsigned rounds );
+static size_t bench_finish( ser_writer_t *w );
+static size_t bench_lp_int( char *buffer, size_t size );
+static size_t bench_lp_float( char *buffer, size_t size );
+static size_t bench_lp_tag( char *buffer, size_t size );
+static size_t bench_lp_str( char *buffer, size_t size );
+static size_t bench_lp_float_chain( char *buffer, size_t size );
+static size_t bench_json_int( char *buffer, size_t size );
+static size_t bench_json_float( char *buffer, size_t size );
+static size_t bench_json_str( char *buffer, size_t size );
+static size_t bench_csv_float( char *buffer, size_t size );
+static size_t bench_csv_str( char *buffer, size_t size );
+static size_t bench_url_str( char *buffer, size_t size );
+static size_t bench_snprintf_int( char *buffer, size_t size );
+static size_t bench_snprintf_float( char *buffer, size_t size );
+
+int main( int argc, char **argv )
+{
+  static const bench_case_t cases[] =
+  {
+    { "lp int",               bench_lp_int },
+    { "lp float 2 decimals",  bench_lp_float },
+    { "lp tag escaped",       bench_lp_tag },
+    { "lp string escaped",    bench_lp_str },
+    { "lp float chain 64 B",  bench_lp_float_chain },
+    { "json int",             bench_json_int },
+    { "json float",           bench_json_float },
+    { "json string escaped",  bench_json_str },
+    { "csv float",            bench_csv_float },
+    { "csv string quoted",    bench_csv_str },
+    { "url string encoded",   bench_url_str },
+    { "snprintf lp int",      bench_snprintf_int },
+    { "snprintf lp float",    bench_snprintf_float },
+  };
+  unsigned rounds = (argc > 1) ? (unsigned)strtoul( argv[1], NULL, 0 ) : BENCH_ROUNDS;
+
+  rounds = rounds ? rounds : 1u;
+  printf( "%u records of %u fields per case\n", rounds, BENCH_FIELDS );
+  for( size_t idx = 0; idx < sizeof(cases) / sizeof(cases[0]); idx++ )
+  {
+    bench_run( &cases[idx], rounds );
+  }
+  return EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Monotonic time in seconds
+ */
+static double bench_now( void )
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void bench_run( const bench_case_t *bench, unsigned rounds )
+{
+  size_t len = 0;
+  double start = 0.0;
+  double elapsed = 0.0;
+
+  // warm up and check the record fits
+  len = bench->record( bench_buf, sizeof(bench_buf) );
+  if( len == 0u )
+  {
+    printf( "%-22s truncated\n", bench->name );
+    return;
+  }
+  start = bench_now();
+  for( unsigned idx = 0; idx < rounds; idx++ )
+  {
+    bench_sink += bench->record( bench_buf, sizeof(bench_buf) );
+  }
+  elapsed = bench_now() - start;
+  printf( "%-22s %7.1f ns/field, %4u bytes/record, %7.1f MB/s\n", bench->name, \
+          elapsed * 1e9 / ((double)rounds * BENCH_FIELDS), (unsigned)len, \
+          (double)len * rounds / elapsed / 1e6 );
+}
+
+/**
+ * @brief Finish the record, the length or 0 if it didn't fit
+ */
+static size_t bench_finish( ser_writer_t *w )
+{
+  return ser_finish( w ) ? ser_len( w ) : 0u;
+}
+
+static size_t bench_lp_int( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  ser_lp_measurement( &w, "weather" );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_lp_field_int( &w, bench_keys[idx], (int64_t)(bench_values[idx] * 100.0) );
+  }
+  ser_lp_end( &w, 1790000000 );
+  return bench_finish( &w );
+}
+
+static size_t bench_lp_float( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  ser_lp_measurement( &w, "weather" );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_lp_field_float( &w, bench_keys[idx], bench_values[idx], 2 );
+  }
+  ser_lp_end( &w, 1790000000 );
+  return bench_finish( &w );
+}
+
+static size_t bench_lp_tag( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  ser_lp_measurement( &w, "weather" );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_lp_tag( &w, bench_keys[idx], bench_strings[idx] );
+  }
+  ser_lp_field_int( &w, "n", 1 );
+  ser_lp_end( &w, 1790000000 );
+  return bench_finish( &w );
+}
+
+static size_t bench_lp_str( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  ser_lp_measurement( &w, "weather" );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_lp_field_str( &w, bench_keys[idx], bench_strings[idx] );
+  }
+  ser_lp_end( &w, 1790000000 );
+  return bench_finish( &w );
+}
+
+static size_t bench_lp_float_chain( char *buffer, size_t size )
+{
+  ser_buf_t chain[BENCH_CHAIN_LEN];
+  ser_writer_t w;
+
+  (void)size;
+  for( unsigned idx = BENCH_CHAIN_LEN; idx > 0u; idx-- )
+  {
+    ser_buf_init( &chain[idx - 1u], &buffer[(idx - 1u) * BENCH_CHAIN_SIZE], BENCH_CHAIN_SIZE, \
+                  (idx < BENCH_CHAIN_LEN) ? &chain[idx] : NULL );
+  }
+  ser_writer_init_chain( &w, &chain[0] );
+  ser_lp_measurement( &w, "weather" );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_lp_field_float( &w, bench_keys[idx], bench_values[idx], 2 );
+  }
+  ser_lp_end( &w, 1790000000 );
+  return bench_finish( &w );
+}
+
+static size_t bench_json_int( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  ser_json_obj_begin( &w );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_json_key( &w, bench_keys[idx] );
+    ser_json_int( &w, (int64_t)(bench_values[idx] * 100.0) );
+  }
+  ser_json_obj_end( &w );
+  return bench_finish( &w );
+}
+
+static size_t bench_json_float( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  ser_json_obj_begin( &w );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_json_key( &w, bench_keys[idx] );
+    ser_json_float( &w, bench_values[idx], 2 );
+  }
+  ser_json_obj_end( &w );
+  return bench_finish( &w );
+}
+
+static size_t bench_json_str( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  ser_json_obj_begin( &w );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_json_key( &w, bench_keys[idx] );
+    ser_json_str( &w, bench_strings[idx] );
+  }
+  ser_json_obj_end( &w );
+  return bench_finish( &w );
+}
+
+static size_t bench_csv_float( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_csv_float( &w, bench_values[idx], 2 );
+  }
+  ser_csv_end( &w );
+  return bench_finish( &w );
+}
+
+static size_t bench_csv_str( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_csv_str( &w, bench_strings[idx] );
+  }
+  ser_csv_end( &w );
+  return bench_finish( &w );
+}
+
+static size_t bench_url_str( char *buffer, size_t size )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, buffer, size );
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    ser_url_str( &w, bench_keys[idx], bench_strings[idx] );
+  }
+  return bench_finish( &w );
+}
+
+static size_t bench_snprintf_int( char *buffer, size_t size )
+{
+  int len = snprintf( buffer, size, "weather " );
+
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    len += snprintf( &buffer[len], size - (size_t)len, "%s%s=%di", idx ? "," : "", bench_keys[idx], \
+                     (int)(bench_values[idx] * 100.0) );
+  }
+  len += snprintf( &buffer[len], size - (size_t)len, " %d\n", 1790000000 );
+  return (size_t)len;
+}
+
+static size_t bench_snprintf_float( char *buffer, size_t size )
+{
+  int len = snprintf( buffer, size, "weather " );
+
+  for( unsigned idx = 0; idx < BENCH_FIELDS; idx++ )
+  {
+    len += snprintf( &buffer[len], size - (size_t)len, "%s%s=%.2f", idx ? "," : "", bench_keys[idx], \
+                     bench_values[idx] );
+  }
+  len += snprintf( &buffer[len], size - (size_t)len, " %d\n", 1790000000 );
+  return (size_t)len;
+}
@@ -0,0 +1,120 @@
+/*
+ * serializer_test.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host test of the serializer output, mainly the escaping of the line
+ * protocol names and values, which InfluxDB rejects or silently misreads if
+ * a special character is not escaped.
+ *
+ *  make -C components/serializer/host_test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "serializer.h"
+
+// Private Macros
+#define TEST_BUF_SIZE                       (256u)
+
+#define CHECK_OUTPUT(w, expected)                                         \
+  do {                                                                    \
+    ser_finish( w );                                                      \
+    if( strcmp( test_buf, expected ) != 0 )                               \
+    {                                                                     \
+      printf( "%s:%d: got '%s' expected '%s'\n", __FILE__, __LINE__,      \
+              test_buf, expected );                                       \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+// Private Variables
+static char test_buf[TEST_BUF_SIZE];
+static int test_failed = 0;
+
+// Private Function Declaration
+static void test_lp_plain( void );
+static void test_lp_backslash( void );
+static void test_lp_special( void );
+static void test_lp_line_break( void );
+
+int main( void )
+{
+  test_lp_plain();
+  test_lp_backslash();
+  test_lp_special();
+  test_lp_line_break();
+  printf( "serializer_test: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+static void test_lp_plain( void )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, test_buf, sizeof(test_buf) );
+  ser_lp_measurement( &w, "weather" );
+  ser_lp_tag( &w, "device", "s3" );
+  ser_lp_field_float( &w, "temperature", 21.5, 1 );
+  ser_lp_field_int( &w, "humidity", 40 );
+  ser_lp_end( &w, 1790000000 );
+  CHECK_OUTPUT( &w, "weather,device=s3 temperature=21.5,humidity=40i 1790000000\n" );
+}
+
+/**
+ * @brief A trailing backslash must not escape the separator after it
+ */
+static void test_lp_backslash( void )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, test_buf, sizeof(test_buf) );
+  ser_lp_measurement( &w, "m" );
+  ser_lp_tag( &w, "t", "d\\" );
+  ser_lp_field_float( &w, "f", 0.0, 1 );
+  ser_lp_end( &w, 0 );
+  CHECK_OUTPUT( &w, "m,t=d\\\\ f=0.0\n" );
+
+  ser_writer_init( &w, test_buf, sizeof(test_buf) );
+  ser_lp_measurement( &w, "m\\" );
+  ser_lp_tag( &w, "k\\", "v" );
+  ser_lp_field_str( &w, "s\\", "a\\" );
+  ser_lp_end( &w, 0 );
+  CHECK_OUTPUT( &w, "m\\\\,k\\\\=v s\\\\=\"a\\\\\"\n" );
+}
+
+static void test_lp_special( void )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, test_buf, sizeof(test_buf) );
+  ser_lp_measurement( &w, "my meas,1" );
+  ser_lp_tag( &w, "a b", "c=d,e" );
+  ser_lp_field_str( &w, "x=y", "say \"hi\", ok" );
+  ser_lp_end( &w, 0 );
+  CHECK_OUTPUT( &w, "my\\ meas\\,1,a\\ b=c\\=d\\,e x\\=y=\"say \\\"hi\\\", ok\"\n" );
+
+  // characters above 127 (UTF-8) are written as they are
+  ser_writer_init( &w, test_buf, sizeof(test_buf) );
+  ser_lp_measurement( &w, "m" );
+  ser_lp_tag( &w, "city", "K\xC3\xB6ln" );
+  ser_lp_field_int( &w, "v", -1 );
+  ser_lp_end( &w, 0 );
+  CHECK_OUTPUT( &w, "m,city=K\xC3\xB6ln v=-1i\n" );
+}
+
+static void test_lp_line_break( void )
+{
+  ser_writer_t w;
+
+  ser_writer_init( &w, test_buf, sizeof(test_buf) );
+  ser_lp_measurement( &w, "m\n" );
+  ser_lp_tag( &w, "t", "a\r\nb" );
+  ser_lp_field_str( &w, "s", "x\ny" );
+  ser_lp_end( &w, 0 );
+  CHECK_OUTPUT( &w, "m,t=ab s=\"xy\"\n" );
+}
@@ -0,0 +1,108 @@
+/*
+ * serializer.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Payload serializers for the uplinks (InfluxDB line protocol, JSON, CSV and
+ * URL query/form encoding). All writers write into caller supplied buffers
+ * (a single buffer or a chain of buffers), nothing is allocated. If the data
+ * doesn't fit, the writer stops at the buffer end and sets the truncated flag
+ * instead of silently cutting the payload, use marks to drop partial records.
+ */
+
+#ifndef SERIALIZER_H_
+#define SERIALIZER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// macros
+#define SER_JSON_MAX_DEPTH              (32u)   // maximum nesting of objects/arrays
+
+typedef struct _ser_buf_t
+{
+  char                *data;
+  size_t              size;
+  size_t              len;
+  struct _ser_buf_t   *next;                    // next buffer in chain, NULL if last
+} ser_buf_t;
+
+typedef struct _ser_writer_t
+{
+  ser_buf_t   *head;
+  ser_buf_t   *cur;                             // buffer being written
+  ser_buf_t   single;                           // used by ser_writer_init
+  size_t      len;                              // total bytes written in all buffers
+  bool        truncated;
+  bool        first;                            // first field of line/row/query
+  bool        after_key;                        // json key written, value expected
+  uint8_t     depth;                            // json nesting level
+  uint32_t    json_first;                       // json first element bit per level
+} ser_writer_t;
+
+typedef struct _ser_mark_t
+{
+  ser_buf_t   *cur;
+  size_t      cur_len;
+  size_t      len;
+  bool        first;
+  bool        after_key;
+  uint8_t     depth;
+  uint32_t    json_first;
+} ser_mark_t;
+
+// Public Function Prototypes
+// writer
+void ser_writer_init( ser_writer_t *w, char *buffer, size_t size );
+void ser_writer_init_chain( ser_writer_t *w, ser_buf_t *head );
+void ser_buf_init( ser_buf_t *buf, char *data, size_t size, ser_buf_t *next );
+bool ser_finish( ser_writer_t *w );
+size_t ser_len( const ser_writer_t *w );
+bool ser_truncated( const ser_writer_t *w );
+ser_mark_t ser_mark( const ser_writer_t *w );
+void ser_rollback( ser_writer_t *w, const ser_mark_t *mark );
+void ser_raw( ser_writer_t *w, const char *data, size_t len );
+void ser_str( ser_writer_t *w, const char *str );
+void ser_char( ser_writer_t *w, char c );
+void ser_int( ser_writer_t *w, int64_t value );
+void ser_uint( ser_writer_t *w, uint64_t value );
+void ser_float( ser_writer_t *w, double value, uint8_t decimals );
+
+// InfluxDB line protocol
+void ser_lp_measurement( ser_writer_t *w, const char *name );
+void ser_lp_tag( ser_writer_t *w, const char *key, const char *value );
+void ser_lp_field_int( ser_writer_t *w, const char *key, int64_t value );
+void ser_lp_field_uint( ser_writer_t *w, const char *key, uint64_t value );
+void ser_lp_field_float( ser_writer_t *w, const char *key, double value, uint8_t decimals );
+void ser_lp_field_bool( ser_writer_t *w, const char *key, bool value );
+void ser_lp_field_str( ser_writer_t *w, const char *key, const char *value );
+void ser_lp_end( ser_writer_t *w, int64_t timestamp );
+
+// JSON
+void ser_json_obj_begin( ser_writer_t *w );
+void ser_json_obj_end( ser_writer_t *w );
+void ser_json_arr_begin( ser_writer_t *w );
+void ser_json_arr_end( ser_writer_t *w );
+void ser_json_key( ser_writer_t *w, const char *key );
+void ser_json_str( ser_writer_t *w, const char *value );
+void ser_json_int( ser_writer_t *w, int64_t value );
+void ser_json_uint( ser_writer_t *w, uint64_t value );
+void ser_json_float( ser_writer_t *w, double value, uint8_t decimals );
+void ser_json_bool( ser_writer_t *w, bool value );
+void ser_json_null( ser_writer_t *w );
+
+// CSV (RFC 4180)
+void ser_csv_str( ser_writer_t *w, const char *value );
+void ser_csv_int( ser_writer_t *w, int64_t value );
+void ser_csv_uint( ser_writer_t *w, uint64_t value );
+void ser_csv_float( ser_writer_t *w, double value, uint8_t decimals );
+void ser_csv_end( ser_writer_t *w );
+
+// URL query and application/x-www-form-urlencoded
+void ser_url_str( ser_writer_t *w, const char *key, const char *value );
+void ser_url_int( ser_writer_t *w, const char *key, int64_t value );
+void ser_url_uint( ser_writer_t *w, const char *key, uint64_t value );
+
+#endif /* SERIALIZER_H_ */
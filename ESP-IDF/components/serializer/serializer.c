@@ -0,0 +1,915 @@
+/*
+ * serializer.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "serializer.h"
+
+// Private Macros
+#define SER_FLOAT_MAX_DECIMALS          (9u)
+// line protocol character classes, one bit per element of the line, see
+// ser_lp_special; a table lookup is much faster than strchr for every character
+#define SER_LP_MEASUREMENT              (0x01u)
+#define SER_LP_KEY                      (0x02u)   // tag keys, tag values and field keys
+#define SER_LP_STRING                   (0x04u)   // string field values
+#define SER_LP_LINE_BREAK               (0x80u)   // not allowed anywhere, removed
+#define SER_FLOAT_MAX_FIXED             (1e18)  // above this exponent format is used
+
+// Private Variables
+static const char ser_hex[] = "0123456789ABCDEF";
+// characters which need a backslash in the line protocol, a backslash is
+// escaped everywhere, else a trailing one would escape the following separator
+static const uint8_t ser_lp_special[256] =
+{
+  ['\n'] = SER_LP_LINE_BREAK,
+  ['\r'] = SER_LP_LINE_BREAK,
+  [' ']  = SER_LP_MEASUREMENT | SER_LP_KEY,
+  [',']  = SER_LP_MEASUREMENT | SER_LP_KEY,
+  ['=']  = SER_LP_KEY,
+  ['"']  = SER_LP_STRING,
+  ['\\'] = SER_LP_MEASUREMENT | SER_LP_KEY | SER_LP_STRING,
+};
+static const uint32_t ser_pow10[SER_FLOAT_MAX_DECIMALS + 1] =
+{
+  1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+// Private Function Declaration
+static void ser_escaped( ser_writer_t *w, const char *str, uint8_t special );
+static void ser_json_prefix( ser_writer_t *w );
+static void ser_json_escaped( ser_writer_t *w, const char *str );
+static void ser_lp_field_key( ser_writer_t *w, const char *key );
+static void ser_url_key( ser_writer_t *w, const char *key );
+static void ser_url_escaped( ser_writer_t *w, const char *str );
+static void ser_csv_prefix( ser_writer_t *w );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the writer with a single buffer, one byte is kept for the
+ *        null character, so that the buffer is a valid string after ser_finish
+ * @param w writer
+ * @param buffer output buffer
+ * @param size buffer size
+ */
+void ser_writer_init( ser_writer_t *w, char *buffer, size_t size )
+{
+  if( size == 0 )
+  {
+    buffer = NULL;
+    size = 1;
+  }
+  ser_buf_init( &w->single, buffer, size - 1, NULL );
+  ser_writer_init_chain( w, &w->single );
+}
+
+/**
+ * @brief Initialize the writer with a chain of buffers, when a buffer is full
+ *        writing continues in the next buffer, records can be split between
+ *        the buffers
+ * @param w writer
+ * @param head first buffer of the chain
+ */
+void ser_writer_init_chain( ser_writer_t *w, ser_buf_t *head )
+{
+  w->head = head;
+  w->cur = head;
+  w->len = 0;
+  w->truncated = false;
+  w->first = true;
+  w->after_key = false;
+  w->depth = 0;
+  w->json_first = 0;
+  for( ser_buf_t *buf = head; buf != NULL; buf = buf->next )
+  {
+    buf->len = 0;
+  }
+}
+
+/**
+ * @brief Initialize a buffer for the chain
+ * @param buf buffer descriptor
+ * @param data buffer memory
+ * @param size buffer size
+ * @param next next buffer in chain or NULL
+ */
+void ser_buf_init( ser_buf_t *buf, char *data, size_t size, ser_buf_t *next )
+{
+  buf->data = data;
+  buf->size = size;
+  buf->len = 0;
+  buf->next = next;
+}
+
+/**
+ * @brief Finish writing, add a null character after the data if there is
+ *        space (always the case for ser_writer_init buffers)
+ * @param w writer
+ * @return true if all the data is written, false if truncated
+ */
+bool ser_finish( ser_writer_t *w )
+{
+  if( (w->cur == &w->single) && (w->single.data != NULL) )
+  {
+    w->single.data[w->single.len] = '\0';
+  }
+  else if( (w->cur != NULL) && (w->cur->len < w->cur->size) )
+  {
+    w->cur->data[w->cur->len] = '\0';
+  }
+  return !w->truncated;
+}
+
+/**
+ * @brief Get the number of bytes written
+ * @param w writer
+ * @return bytes written in all buffers
+ */
+size_t ser_len( const ser_writer_t *w )
+{
+  return w->len;
+}
+
+/**
+ * @brief Check if data didn't fit in the buffers
+ * @param w writer
+ * @return true if truncated
+ */
+bool ser_truncated( const ser_writer_t *w )
+{
+  return w->truncated;
+}
+
+/**
+ * @brief Get the current position of the writer, used with ser_rollback to
+ *        remove a record which didn't fit completely
+ * @param w writer
+ * @return position
+ */
+ser_mark_t ser_mark( const ser_writer_t *w )
+{
+  ser_mark_t mark =
+  {
+    .cur = w->cur,
+    .cur_len = (w->cur != NULL) ? w->cur->len : 0,
+    .len = w->len,
+    .first = w->first,
+    .after_key = w->after_key,
+    .depth = w->depth,
+    .json_first = w->json_first,
+  };
+  return mark;
+}
+
+/**
+ * @brief Remove all the data written after the mark and clear the truncated
+ *        flag
+ * @param w writer
+ * @param mark position from ser_mark
+ */
+void ser_rollback( ser_writer_t *w, const ser_mark_t *mark )
+{
+  w->cur = mark->cur;
+  if( w->cur != NULL )
+  {
+    w->cur->len = mark->cur_len;
+    for( ser_buf_t *buf = w->cur->next; buf != NULL; buf = buf->next )
+    {
+      buf->len = 0;
+    }
+  }
+  w->len = mark->len;
+  w->first = mark->first;
+  w->after_key = mark->after_key;
+  w->depth = mark->depth;
+  w->json_first = mark->json_first;
+  w->truncated = false;
+}
+
+/**
+ * @brief Write raw data, nothing is escaped
+ * @param w writer
+ * @param data data to write
+ * @param len data length
+ */
+void ser_raw( ser_writer_t *w, const char *data, size_t len )
+{
+  size_t avail = 0;
+
+  if( w->truncated )
+  {
+    return;
+  }
+  while( len )
+  {
+    if( w->cur == NULL )
+    {
+      w->truncated = true;
+      return;
+    }
+    avail = w->cur->size - w->cur->len;
+    if( avail == 0 )
+    {
+      if( w->cur->next == NULL )
+      {
+        w->truncated = true;
+        return;
+      }
+      w->cur = w->cur->next;
+      continue;
+    }
+    if( avail > len )
+    {
+      avail = len;
+    }
+    memcpy( w->cur->data + w->cur->len, data, avail );
+    w->cur->len += avail;
+    w->len += avail;
+    data += avail;
+    len -= avail;
+  }
+}
+
+/**
+ * @brief Write a string, nothing is escaped
+ * @param w writer
+ * @param str null terminated string
+ */
+void ser_str( ser_writer_t *w, const char *str )
+{
+  ser_raw( w, str, strlen(str) );
+}
+
+/**
+ * @brief Write a single character
+ * @param w writer
+ * @param c character
+ */
+void ser_char( ser_writer_t *w, char c )
+{
+  // fast path, avoids the loop in ser_raw
+  if( !w->truncated && (w->cur != NULL) && (w->cur->len < w->cur->size) )
+  {
+    w->cur->data[w->cur->len++] = c;
+    w->len++;
+  }
+  else
+  {
+    ser_raw( w, &c, 1 );
+  }
+}
+
+/**
+ * @brief Write a signed integer in decimal
+ * @param w writer
+ * @param value value
+ */
+void ser_int( ser_writer_t *w, int64_t value )
+{
+  if( value < 0 )
+  {
+    ser_char( w, '-' );
+    ser_uint( w, (uint64_t)0 - (uint64_t)value );
+  }
+  else
+  {
+    ser_uint( w, (uint64_t)value );
+  }
+}
+
+/**
+ * @brief Write an unsigned integer in decimal
+ * @param w writer
+ * @param value value
+ */
+void ser_uint( ser_writer_t *w, uint64_t value )
+{
+  char digits[20];
+  uint8_t idx = sizeof(digits);
+
+  // 32-bit division is much faster on ESP32, use it when possible
+  while( value > UINT32_MAX )
+  {
+    digits[--idx] = (char)('0' + (value % 10u));
+    value /= 10u;
+  }
+  uint32_t small = (uint32_t)value;
+  do
+  {
+    digits[--idx] = (char)('0' + (small % 10u));
+    small /= 10u;
+  } while( small );
+  ser_raw( w, digits + idx, sizeof(digits) - idx );
+}
+
+/**
+ * @brief Write a floating point number with fixed decimals, very large values
+ *        are written in exponent format, the value must be finite
+ * @param w writer
+ * @param value value
+ * @param decimals number of digits after decimal point (max. 9)
+ */
+void ser_float( ser_writer_t *w, double value, uint8_t decimals )
+{
+  double scaled = 0.0;
+  uint64_t fixed = 0;
+  uint32_t frac = 0;
+  char digits[SER_FLOAT_MAX_DECIMALS];
+
+  if( decimals > SER_FLOAT_MAX_DECIMALS )
+  {
+    decimals = SER_FLOAT_MAX_DECIMALS;
+  }
+  scaled = fabs( value ) * ser_pow10[decimals] + 0.5;
+  if( scaled >= SER_FLOAT_MAX_FIXED )
+  {
+    char big[32];
+    int len = snprintf( big, sizeof(big), "%.17g", value );
+    ser_raw( w, big, (size_t)len );
+    return;
+  }
+
+  fixed = (uint64_t)scaled;
+  if( (value < 0.0) && (fixed != 0) )
+  {
+    ser_char( w, '-' );
+  }
+  ser_uint( w, fixed / ser_pow10[decimals] );
+  if( decimals )
+  {
+    frac = (uint32_t)(fixed % ser_pow10[decimals]);
+    for( uint8_t idx = decimals; idx > 0; idx-- )
+    {
+      digits[idx - 1] = (char)('0' + (frac % 10u));
+      frac /= 10u;
+    }
+    ser_char( w, '.' );
+    ser_raw( w, digits, decimals );
+  }
+}
+
+/**
+ * @brief Write the measurement name, this starts a new line
+ * @param w writer
+ * @param name measurement name
+ */
+void ser_lp_measurement( ser_writer_t *w, const char *name )
+{
+  ser_escaped( w, name, SER_LP_MEASUREMENT );
+  w->first = true;
+}
+
+/**
+ * @brief Write a tag, must be called before the fields
+ * @param w writer
+ * @param key tag key
+ * @param value tag value, tags with empty value are skipped (not allowed)
+ */
+void ser_lp_tag( ser_writer_t *w, const char *key, const char *value )
+{
+  if( (value == NULL) || (value[0] == '\0') )
+  {
+    return;
+  }
+  ser_char( w, ',' );
+  ser_escaped( w, key, SER_LP_KEY );
+  ser_char( w, '=' );
+  ser_escaped( w, value, SER_LP_KEY );
+}
+
+/**
+ * @brief Write an integer field
+ * @param w writer
+ * @param key field key
+ * @param value value
+ */
+void ser_lp_field_int( ser_writer_t *w, const char *key, int64_t value )
+{
+  ser_lp_field_key( w, key );
+  ser_int( w, value );
+  ser_char( w, 'i' );
+}
+
+/**
+ * @brief Write an unsigned integer field
+ * @param w writer
+ * @param key field key
+ * @param value value
+ */
+void ser_lp_field_uint( ser_writer_t *w, const char *key, uint64_t value )
+{
+  ser_lp_field_key( w, key );
+  ser_uint( w, value );
+  ser_char( w, 'u' );
+}
+
+/**
+ * @brief Write a float field, NaN and infinity are not supported by InfluxDB
+ *        so such fields are skipped
+ * @param w writer
+ * @param key field key
+ * @param value value
+ * @param decimals number of digits after decimal point
+ */
+void ser_lp_field_float( ser_writer_t *w, const char *key, double value, uint8_t decimals )
+{
+  if( !isfinite(value) )
+  {
+    return;
+  }
+  ser_lp_field_key( w, key );
+  ser_float( w, value, decimals );
+}
+
+/**
+ * @brief Write a boolean field
+ * @param w writer
+ * @param key field key
+ * @param value value
+ */
+void ser_lp_field_bool( ser_writer_t *w, const char *key, bool value )
+{
+  ser_lp_field_key( w, key );
+  ser_char( w, value ? 't' : 'f' );
+}
+
+/**
+ * @brief Write a string field
+ * @param w writer
+ * @param key field key
+ * @param value value
+ */
+void ser_lp_field_str( ser_writer_t *w, const char *key, const char *value )
+{
+  ser_lp_field_key( w, key );
+  ser_char( w, '"' );
+  ser_escaped( w, value, SER_LP_STRING );
+  ser_char( w, '"' );
+}
+
+/**
+ * @brief End the line with the time stamp
+ * @param w writer
+ * @param timestamp time stamp in write precision, 0 to use server time
+ */
+void ser_lp_end( ser_writer_t *w, int64_t timestamp )
+{
+  if( timestamp )
+  {
+    ser_char( w, ' ' );
+    ser_int( w, timestamp );
+  }
+  ser_char( w, '\n' );
+  w->first = true;
+}
+
+/**
+ * @brief Start a JSON object
+ * @param w writer
+ */
+void ser_json_obj_begin( ser_writer_t *w )
+{
+  ser_json_prefix( w );
+  ser_char( w, '{' );
+  if( w->depth >= SER_JSON_MAX_DEPTH )
+  {
+    w->truncated = true;
+    return;
+  }
+  w->json_first |= (1u << w->depth);
+  w->depth++;
+}
+
+/**
+ * @brief End a JSON object
+ * @param w writer
+ */
+void ser_json_obj_end( ser_writer_t *w )
+{
+  if( w->depth )
+  {
+    w->depth--;
+  }
+  ser_char( w, '}' );
+}
+
+/**
+ * @brief Start a JSON array
+ * @param w writer
+ */
+void ser_json_arr_begin( ser_writer_t *w )
+{
+  ser_json_prefix( w );
+  ser_char( w, '[' );
+  if( w->depth >= SER_JSON_MAX_DEPTH )
+  {
+    w->truncated = true;
+    return;
+  }
+  w->json_first |= (1u << w->depth);
+  w->depth++;
+}
+
+/**
+ * @brief End a JSON array
+ * @param w writer
+ */
+void ser_json_arr_end( ser_writer_t *w )
+{
+  if( w->depth )
+  {
+    w->depth--;
+  }
+  ser_char( w, ']' );
+}
+
+/**
+ * @brief Write an object key, must be followed by a value
+ * @param w writer
+ * @param key key
+ */
+void ser_json_key( ser_writer_t *w, const char *key )
+{
+  ser_json_prefix( w );
+  ser_char( w, '"' );
+  ser_json_escaped( w, key );
+  ser_char( w, '"' );
+  ser_char( w, ':' );
+  w->after_key = true;
+}
+
+/**
+ * @brief Write a string value
+ * @param w writer
+ * @param value string, NULL is written as null
+ */
+void ser_json_str( ser_writer_t *w, const char *value )
+{
+  if( value == NULL )
+  {
+    ser_json_null( w );
+    return;
+  }
+  ser_json_prefix( w );
+  ser_char( w, '"' );
+  ser_json_escaped( w, value );
+  ser_char( w, '"' );
+}
+
+/**
+ * @brief Write a signed integer value
+ * @param w writer
+ * @param value value
+ */
+void ser_json_int( ser_writer_t *w, int64_t value )
+{
+  ser_json_prefix( w );
+  ser_int( w, value );
+}
+
+/**
+ * @brief Write an unsigned integer value
+ * @param w writer
+ * @param value value
+ */
+void ser_json_uint( ser_writer_t *w, uint64_t value )
+{
+  ser_json_prefix( w );
+  ser_uint( w, value );
+}
+
+/**
+ * @brief Write a float value, NaN and infinity are written as null
+ * @param w writer
+ * @param value value
+ * @param decimals number of digits after decimal point
+ */
+void ser_json_float( ser_writer_t *w, double value, uint8_t decimals )
+{
+  if( !isfinite(value) )
+  {
+    ser_json_null( w );
+    return;
+  }
+  ser_json_prefix( w );
+  ser_float( w, value, decimals );
+}
+
+/**
+ * @brief Write a boolean value
+ * @param w writer
+ * @param value value
+ */
+void ser_json_bool( ser_writer_t *w, bool value )
+{
+  ser_json_prefix( w );
+  if( value )
+  {
+    ser_raw( w, "true", 4 );
+  }
+  else
+  {
+    ser_raw( w, "false", 5 );
+  }
+}
+
+/**
+ * @brief Write a null value
+ * @param w writer
+ */
+void ser_json_null( ser_writer_t *w )
+{
+  ser_json_prefix( w );
+  ser_raw( w, "null", 4 );
+}
+
+/**
+ * @brief Write a string column, quoted only if required
+ * @param w writer
+ * @param value string
+ */
+void ser_csv_str( ser_writer_t *w, const char *value )
+{
+  ser_csv_prefix( w );
+  if( strpbrk(value, ",\"\r\n") == NULL )
+  {
+    ser_str( w, value );
+    return;
+  }
+  ser_char( w, '"' );
+  for( const char *quote = strchr(value, '"'); quote != NULL; quote = strchr(value, '"') )
+  {
+    // quotes are escaped by doubling them
+    ser_raw( w, value, (size_t)(quote - value) + 1 );
+    ser_char( w, '"' );
+    value = quote + 1;
+  }
+  ser_str( w, value );
+  ser_char( w, '"' );
+}
+
+/**
+ * @brief Write a signed integer column
+ * @param w writer
+ * @param value value
+ */
+void ser_csv_int( ser_writer_t *w, int64_t value )
+{
+  ser_csv_prefix( w );
+  ser_int( w, value );
+}
+
+/**
+ * @brief Write an unsigned integer column
+ * @param w writer
+ * @param value value
+ */
+void ser_csv_uint( ser_writer_t *w, uint64_t value )
+{
+  ser_csv_prefix( w );
+  ser_uint( w, value );
+}
+
+/**
+ * @brief Write a float column, NaN and infinity are written as empty column
+ * @param w writer
+ * @param value value
+ * @param decimals number of digits after decimal point
+ */
+void ser_csv_float( ser_writer_t *w, double value, uint8_t decimals )
+{
+  ser_csv_prefix( w );
+  if( isfinite(value) )
+  {
+    ser_float( w, value, decimals );
+  }
+}
+
+/**
+ * @brief End the CSV row
+ * @param w writer
+ */
+void ser_csv_end( ser_writer_t *w )
+{
+  ser_char( w, '\n' );
+  w->first = true;
+}
+
+/**
+ * @brief Write a URL query or form parameter with string value, the '?' of
+ *        the query must be written by the caller
+ * @param w writer
+ * @param key parameter name
+ * @param value parameter value
+ */
+void ser_url_str( ser_writer_t *w, const char *key, const char *value )
+{
+  ser_url_key( w, key );
+  ser_url_escaped( w, value );
+}
+
+/**
+ * @brief Write a URL query or form parameter with signed integer value
+ * @param w writer
+ * @param key parameter name
+ * @param value parameter value
+ */
+void ser_url_int( ser_writer_t *w, const char *key, int64_t value )
+{
+  ser_url_key( w, key );
+  ser_int( w, value );
+}
+
+/**
+ * @brief Write a URL query or form parameter with unsigned integer value
+ * @param w writer
+ * @param key parameter name
+ * @param value parameter value
+ */
+void ser_url_uint( ser_writer_t *w, const char *key, uint64_t value )
+{
+  ser_url_key( w, key );
+  ser_uint( w, value );
+}
+
+// Private Function Definition
+
+/**
+ * @brief Write string with a backslash before the special characters, line
+ *        breaks are not allowed in line protocol and are removed
+ * @param w writer
+ * @param str string
+ * @param special character class of the element, SER_LP_MEASUREMENT,
+ *        SER_LP_KEY or SER_LP_STRING
+ */
+static void ser_escaped( ser_writer_t *w, const char *str, uint8_t special )
+{
+  size_t run = 0;
+  uint8_t check = special | SER_LP_LINE_BREAK;
+
+  while( str[run] != '\0' )
+  {
+    uint8_t c = (uint8_t)str[run];
+    if( ser_lp_special[c] & check )
+    {
+      ser_raw( w, str, run );
+      if( ser_lp_special[c] & special )
+      {
+        ser_char( w, '\\' );
+        ser_char( w, (char)c );
+      }
+      str += run + 1;
+      run = 0;
+    }
+    else
+    {
+      run++;
+    }
+  }
+  ser_raw( w, str, run );
+}
+
+/**
+ * @brief Write the comma between JSON elements if required
+ * @param w writer
+ */
+static void ser_json_prefix( ser_writer_t *w )
+{
+  uint32_t bit = 0;
+
+  if( w->after_key )
+  {
+    w->after_key = false;
+    return;
+  }
+  if( w->depth == 0 )
+  {
+    return;
+  }
+  bit = 1u << (w->depth - 1);
+  if( w->json_first & bit )
+  {
+    w->json_first &= ~bit;
+  }
+  else
+  {
+    ser_char( w, ',' );
+  }
+}
+
+/**
+ * @brief Write a JSON string content with escaping
+ * @param w writer
+ * @param str string
+ */
+static void ser_json_escaped( ser_writer_t *w, const char *str )
+{
+  size_t run = 0;
+  char esc[6] = { '\\', 'u', '0', '0', 0, 0 };
+
+  while( str[run] != '\0' )
+  {
+    unsigned char c = (unsigned char)str[run];
+    if( (c >= 0x20) && (c != '"') && (c != '\\') )
+    {
+      run++;
+      continue;
+    }
+    ser_raw( w, str, run );
+    switch( c )
+    {
+      case '"':   ser_raw( w, "\\\"", 2 ); break;
+      case '\\':  ser_raw( w, "\\\\", 2 ); break;
+      case '\n':  ser_raw( w, "\\n", 2 );  break;
+      case '\r':  ser_raw( w, "\\r", 2 );  break;
+      case '\t':  ser_raw( w, "\\t", 2 );  break;
+      case '\b':  ser_raw( w, "\\b", 2 );  break;
+      case '\f':  ser_raw( w, "\\f", 2 );  break;
+      default:
+        esc[4] = ser_hex[c >> 4];
+        esc[5] = ser_hex[c & 0x0F];
+        ser_raw( w, esc, sizeof(esc) );
+        break;
+    }
+    str += run + 1;
+    run = 0;
+  }
+  ser_raw( w, str, run );
+}
+
+/**
+ * @brief Write the separator and the field key
+ * @param w writer
+ * @param key field key
+ */
+static void ser_lp_field_key( ser_writer_t *w, const char *key )
+{
+  ser_char( w, w->first ? ' ' : ',' );
+  w->first = false;
+  ser_escaped( w, key, SER_LP_KEY );
+  ser_char( w, '=' );
+}
+
+/**
+ * @brief Write the separator and the parameter name
+ * @param w writer
+ * @param key parameter name
+ */
+static void ser_url_key( ser_writer_t *w, const char *key )
+{
+  if( !w->first )
+  {
+    ser_char( w, '&' );
+  }
+  w->first = false;
+  ser_url_escaped( w, key );
+  ser_char( w, '=' );
+}
+
+/**
+ * @brief Write string with percent encoding, only unreserved characters
+ *        (RFC 3986) are written as it is
+ * @param w writer
+ * @param str string
+ */
+static void ser_url_escaped( ser_writer_t *w, const char *str )
+{
+  size_t run = 0;
+  char esc[3] = { '%', 0, 0 };
+
+  while( str[run] != '\0' )
+  {
+    unsigned char c = (unsigned char)str[run];
+    if( ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) || \
+        ((c >= '0') && (c <= '9')) || (c == '-') || (c == '.') || (c == '_') || (c == '~') )
+    {
+      run++;
+      continue;
+    }
+    ser_raw( w, str, run );
+    esc[1] = ser_hex[c >> 4];
+    esc[2] = ser_hex[c & 0x0F];
+    ser_raw( w, esc, sizeof(esc) );
+    str += run + 1;
+    run = 0;
+  }
+  ser_raw( w, str, run );
+}
+
+/**
+ * @brief Write the column separator if required
+ * @param w writer
+ */
+static void ser_csv_prefix( ser_writer_t *w )
+{
+  if( !w->first )
+  {
+    ser_char( w, ',' );
+  }
+  w->first = false;
+}
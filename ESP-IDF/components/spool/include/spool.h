@@ -0,0 +1,63 @@
+/*
+ * spool.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Store and forward spool for the uplinks. Samples are stored in a RAM ring
+ * with the monotonic time (esp_timer) as time stamp, so that samples taken
+ * before the time synchronization or during network outages are not lost.
+ * When the wall clock is known (spool_set_time) all the stored samples are
+ * rebased to UTC, samples added after that are stamped with UTC directly.
+ * The uplink drains the spool oldest first with spool_peek and spool_pop.
+ */
+
+#ifndef SPOOL_H_
+#define SPOOL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum {
+  SPOOL_DROP_OLDEST = 0,                // oldest sample is overwritten
+  SPOOL_DROP_NEWEST,                    // new sample is rejected
+  SPOOL_DROP_THIN,                      // every 2nd sample of the older half is removed,
+                                        // full time range is kept with less resolution
+} spool_drop_t;
+
+typedef struct _spool_hdr_t
+{
+  int64_t   time_us;                    // monotonic or UTC time in microseconds
+  uint32_t  utc;                        // true if time_us is UTC
+  uint32_t  reserved;
+} spool_hdr_t;
+
+typedef struct _spool_t
+{
+  uint8_t       *buffer;
+  size_t        record_size;            // user record size
+  size_t        slot_size;              // header + record, 8 byte aligned
+  uint32_t      capacity;               // number of slots
+  uint32_t      head;                   // oldest slot
+  uint32_t      count;
+  spool_drop_t  policy;
+  bool          synced;                 // wall clock is known
+  int64_t       offset_us;              // UTC - monotonic time
+  uint32_t      dropped;
+} spool_t;
+
+// slot size for a record, use it to size the spool buffer
+#define SPOOL_SLOT_SIZE(record_size)    ((sizeof(spool_hdr_t) + (record_size) + 7u) & ~7u)
+
+// Public Function Prototypes
+void spool_init( spool_t *spool, void *buffer, size_t buffer_size, size_t record_size, spool_drop_t policy );
+bool spool_push( spool_t *spool, int64_t mono_us, const void *record );
+void spool_set_time( spool_t *spool, int64_t utc_us, int64_t mono_us );
+bool spool_peek( const spool_t *spool, uint32_t idx, int64_t *time_us, void *record );
+void spool_pop( spool_t *spool, uint32_t count );
+uint32_t spool_count( const spool_t *spool );
+bool spool_is_synced( const spool_t *spool );
+uint32_t spool_dropped( const spool_t *spool );
+
+#endif /* SPOOL_H_ */
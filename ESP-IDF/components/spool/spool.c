@@ -0,0 +1,224 @@
+/*
+ * spool.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+
+#include "spool.h"
+
+// Private Function Declaration
+static uint8_t * spool_slot( const spool_t *spool, uint32_t idx );
+static void spool_thin( spool_t *spool );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the spool
+ * @param spool spool
+ * @param buffer memory for the samples
+ * @param buffer_size buffer size, capacity is buffer_size / SPOOL_SLOT_SIZE(record_size)
+ * @param record_size size of one sample
+ * @param policy what to do when spool is full
+ */
+void spool_init( spool_t *spool, void *buffer, size_t buffer_size, size_t record_size, spool_drop_t policy )
+{
+  memset( spool, 0x00, sizeof(spool_t) );
+  spool->buffer = buffer;
+  spool->record_size = record_size;
+  spool->slot_size = SPOOL_SLOT_SIZE( record_size );
+  spool->capacity = buffer_size / spool->slot_size;
+  spool->policy = policy;
+}
+
+/**
+ * @brief Add a sample to the spool, it is stamped with UTC if the time is
+ *        synchronized else with the monotonic time
+ * @param spool spool
+ * @param mono_us monotonic time of the sample (esp_timer_get_time)
+ * @param record sample data of record_size
+ * @return true if stored, false if rejected (SPOOL_DROP_NEWEST)
+ */
+bool spool_push( spool_t *spool, int64_t mono_us, const void *record )
+{
+  spool_hdr_t hdr = { 0 };
+
+  if( spool->capacity == 0 )
+  {
+    spool->dropped++;
+    return false;
+  }
+
+  if( spool->count == spool->capacity )
+  {
+    if( (spool->policy == SPOOL_DROP_NEWEST) )
+    {
+      spool->dropped++;
+      return false;
+    }
+    else if( (spool->policy == SPOOL_DROP_THIN) && (spool->capacity >= 4) )
+    {
+      spool_thin( spool );
+    }
+    else
+    {
+      spool->dropped++;
+      spool->head = (spool->head + 1) % spool->capacity;
+      spool->count--;
+    }
+  }
+
+  hdr.utc = spool->synced;
+  hdr.time_us = spool->synced ? (mono_us + spool->offset_us) : mono_us;
+  uint8_t *slot = spool_slot( spool, spool->count );
+  memcpy( slot, &hdr, sizeof(hdr) );
+  memcpy( slot + sizeof(hdr), record, spool->record_size );
+  spool->count++;
+  return true;
+}
+
+/**
+ * @brief Set the wall clock, all the samples with monotonic time stamp are
+ *        rebased to UTC, call it again after every time synchronization to
+ *        correct the drift for the new samples
+ * @param spool spool
+ * @param utc_us current UTC time in microseconds
+ * @param mono_us current monotonic time in microseconds
+ */
+void spool_set_time( spool_t *spool, int64_t utc_us, int64_t mono_us )
+{
+  spool_hdr_t hdr;
+  bool rebase = !spool->synced;
+
+  spool->offset_us = utc_us - mono_us;
+  spool->synced = true;
+  // samples added after the first synchronization are UTC already
+  if( !rebase )
+  {
+    return;
+  }
+  for( uint32_t idx = 0; idx < spool->count; idx++ )
+  {
+    uint8_t *slot = spool_slot( spool, idx );
+    memcpy( &hdr, slot, sizeof(hdr) );
+    if( !hdr.utc )
+    {
+      hdr.time_us += spool->offset_us;
+      hdr.utc = true;
+      memcpy( slot, &hdr, sizeof(hdr) );
+    }
+  }
+}
+
+/**
+ * @brief Read a sample without removing it
+ * @param spool spool
+ * @param idx sample index, 0 is the oldest
+ * @param time_us time stamp output (UTC if spool is synchronized)
+ * @param record sample data output
+ * @return true if sample is available
+ */
+bool spool_peek( const spool_t *spool, uint32_t idx, int64_t *time_us, void *record )
+{
+  spool_hdr_t hdr;
+  const uint8_t *slot = NULL;
+
+  if( idx >= spool->count )
+  {
+    return false;
+  }
+  slot = spool_slot( spool, idx );
+  memcpy( &hdr, slot, sizeof(hdr) );
+  *time_us = hdr.time_us;
+  memcpy( record, slot + sizeof(hdr), spool->record_size );
+  return true;
+}
+
+/**
+ * @brief Remove the oldest samples, call it after the samples are sent
+ * @param spool spool
+ * @param count number of samples to remove
+ */
+void spool_pop( spool_t *spool, uint32_t count )
+{
+  if( count > spool->count )
+  {
+    count = spool->count;
+  }
+  if( spool->capacity )
+  {
+    spool->head = (spool->head + count) % spool->capacity;
+  }
+  spool->count -= count;
+}
+
+/**
+ * @brief Get the number of samples in spool
+ * @param spool spool
+ * @return number of samples
+ */
+uint32_t spool_count( const spool_t *spool )
+{
+  return spool->count;
+}
+
+/**
+ * @brief Check if the spool time stamps are UTC
+ * @param spool spool
+ * @return true if spool_set_time is called
+ */
+bool spool_is_synced( const spool_t *spool )
+{
+  return spool->synced;
+}
+
+/**
+ * @brief Get the number of samples dropped (or thinned) since init
+ * @param spool spool
+ * @return dropped samples
+ */
+uint32_t spool_dropped( const spool_t *spool )
+{
+  return spool->dropped;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Get the slot address
+ * @param spool spool
+ * @param idx index from the oldest sample
+ * @return slot address
+ */
+static uint8_t * spool_slot( const spool_t *spool, uint32_t idx )
+{
+  return spool->buffer + (size_t)((spool->head + idx) % spool->capacity) * spool->slot_size;
+}
+
+/**
+ * @brief Remove every second sample from the older half of the spool, this
+ *        frees a quarter of the spool
+ * @param spool spool
+ */
+static void spool_thin( spool_t *spool )
+{
+  uint32_t half = spool->count / 2;
+  uint32_t out = 1;
+
+  // samples 0, 2, 4.. of the older half are kept, newer half is kept fully
+  for( uint32_t idx = 1; idx < spool->count; idx++ )
+  {
+    if( (idx < half) && (idx & 1u) )
+    {
+      continue;
+    }
+    if( out != idx )
+    {
+      memcpy( spool_slot(spool, out), spool_slot(spool, idx), spool->slot_size );
+    }
+    out++;
+  }
+  spool->dropped += spool->count - out;
+  spool->count = out;
+}
@@ -0,0 +1,86 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Telemetry bus, the sensor loop publishes a sample once and it is copied to
+ * every registered sink (InfluxDB, ThingSpeak, MQTT...). Each sink has its own
+ * small bounded queue with a policy for the full case, so a slow sink only
+ * loses its own samples and never blocks the sensor loop or the other sinks.
+ * The bus has no task, publishing only copies the sample and calls the notify
+ * callback of the sink, the sink reads the samples with telemetry_receive
+ * from its own context. A sink costs its struct plus depth * 32 bytes.
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+
+#define TELEMETRY_VALUES_MAX            (4u)
+
+typedef struct _telemetry_sample_t
+{
+  int64_t   time_us;                    // esp_timer time when sample was taken
+  uint32_t  seq;                        // sample number, gaps are dropped samples
+  uint8_t   count;                      // number of values used
+  uint8_t   source;                     // 0 for local sensors, else virtual device (load generator)
+  float     value[TELEMETRY_VALUES_MAX];
+} telemetry_sample_t;
+
+typedef enum {
+  TELEMETRY_DROP_OLDEST = 0,            // oldest sample is removed for the new one
+  TELEMETRY_DROP_NEWEST,                // new sample is dropped
+  TELEMETRY_COALESCE,                   // newest queued sample is replaced, sink gets latest values
+} telemetry_policy_t;
+
+/**
+ * @brief Sink notify callback, called from the publisher context after a
+ *        sample is queued, it must not block (e.g. xQueueSend with 0 timeout)
+ * @param ctx user context given in telemetry_sink_init
+ */
+typedef void (*telemetry_notify_t)( void *ctx );
+
+typedef struct _telemetry_stats_t
+{
+  uint32_t  received;                   // samples published to this sink
+  uint32_t  delivered;                  // samples read by the sink
+  uint32_t  dropped;                    // samples lost due to queue full
+  uint32_t  coalesced;                  // samples replaced by newer ones
+  uint32_t  depth;                      // samples waiting now
+  uint32_t  max_depth;
+  uint32_t  lag_ms;                     // sample age when it was read last time
+  uint32_t  max_lag_ms;
+} telemetry_stats_t;
+
+typedef struct _telemetry_sink_t
+{
+  const char                *name;
+  telemetry_sample_t        *queue;
+  uint16_t                  size;
+  uint16_t                  head;
+  uint16_t                  count;
+  telemetry_policy_t        policy;
+  telemetry_notify_t        notify;
+  void                      *ctx;
+  telemetry_stats_t         stats;
+  struct _telemetry_sink_t  *next;
+} telemetry_sink_t;
+
+// Public Function Prototypes
+void telemetry_sink_init( telemetry_sink_t *sink, const char *name, telemetry_sample_t *queue, uint16_t size, \
+                          telemetry_policy_t policy, telemetry_notify_t notify, void *ctx );
+esp_err_t telemetry_sink_register( telemetry_sink_t *sink );
+uint32_t telemetry_publish( const float *values, uint8_t count );
+uint32_t telemetry_publish_source( uint8_t source, const float *values, uint8_t count );
+bool telemetry_receive( telemetry_sink_t *sink, telemetry_sample_t *sample );
+void telemetry_get_stats( telemetry_sink_t *sink, telemetry_stats_t *stats );
+telemetry_sink_t * telemetry_sink_first( void );
+uint8_t telemetry_value_u8( const telemetry_sample_t *sample, uint8_t idx );
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,240 @@
+/*
+ * telemetry.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "telemetry.h"
+
+// Private Variables
+static portMUX_TYPE telemetry_lock = portMUX_INITIALIZER_UNLOCKED;
+static telemetry_sink_t *telemetry_sinks = NULL;
+static uint32_t telemetry_seq = 0;
+
+// Private Function Declaration
+static void telemetry_sink_push( telemetry_sink_t *sink, const telemetry_sample_t *sample );
+
+// Public Function Definition
+
+/**
+ * @brief Initialize the sink, the queue memory is given by the caller
+ * @param sink sink
+ * @param name sink name, used for the statistics
+ * @param queue memory for size samples
+ * @param size queue length
+ * @param policy what to do when queue is full
+ * @param notify callback called after a sample is queued, can be NULL
+ * @param ctx user context for the callback
+ */
+void telemetry_sink_init( telemetry_sink_t *sink, const char *name, telemetry_sample_t *queue, uint16_t size, \
+                          telemetry_policy_t policy, telemetry_notify_t notify, void *ctx )
+{
+  memset( sink, 0x00, sizeof(telemetry_sink_t) );
+  sink->name = name;
+  sink->queue = queue;
+  sink->size = size;
+  sink->policy = policy;
+  sink->notify = notify;
+  sink->ctx = ctx;
+}
+
+/**
+ * @brief Add the sink to the bus, it gets all the samples published after this
+ * @param sink initialized sink, must stay valid forever
+ * @return ESP_OK if successful else ESP_ERR_INVALID_ARG
+ */
+esp_err_t telemetry_sink_register( telemetry_sink_t *sink )
+{
+  telemetry_sink_t **last = &telemetry_sinks;
+
+  if( (sink->queue == NULL) || (sink->size == 0) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  sink->next = NULL;
+  taskENTER_CRITICAL( &telemetry_lock );
+  while( *last != NULL )
+  {
+    last = &(*last)->next;
+  }
+  // sinks are only added at the end, publisher can walk the list without lock
+  *last = sink;
+  taskEXIT_CRITICAL( &telemetry_lock );
+  return ESP_OK;
+}
+
+/**
+ * @brief Publish a sample of local sensors to all the sinks, this never blocks
+ * @param values sample values
+ * @param count number of values, maximum TELEMETRY_VALUES_MAX
+ * @return sequence number of the sample
+ */
+uint32_t telemetry_publish( const float *values, uint8_t count )
+{
+  return telemetry_publish_source( 0, values, count );
+}
+
+/**
+ * @brief Publish a sample of a given source to all the sinks, this never blocks
+ * @param source sample source, 0 for local sensors
+ * @param values sample values
+ * @param count number of values, maximum TELEMETRY_VALUES_MAX
+ * @return sequence number of the sample
+ */
+uint32_t telemetry_publish_source( uint8_t source, const float *values, uint8_t count )
+{
+  telemetry_sample_t sample = { 0 };
+  telemetry_sink_t *sink = NULL;
+
+  if( count > TELEMETRY_VALUES_MAX )
+  {
+    count = TELEMETRY_VALUES_MAX;
+  }
+  sample.time_us = esp_timer_get_time();
+  sample.count = count;
+  sample.source = source;
+  memcpy( sample.value, values, count * sizeof(float) );
+
+  taskENTER_CRITICAL( &telemetry_lock );
+  sample.seq = telemetry_seq++;
+  sink = telemetry_sinks;
+  taskEXIT_CRITICAL( &telemetry_lock );
+
+  while( sink != NULL )
+  {
+    taskENTER_CRITICAL( &telemetry_lock );
+    telemetry_sink_push( sink, &sample );
+    taskEXIT_CRITICAL( &telemetry_lock );
+    if( sink->notify )
+    {
+      sink->notify( sink->ctx );
+    }
+    sink = sink->next;
+  }
+  return sample.seq;
+}
+
+/**
+ * @brief Read the oldest sample of the sink
+ * @param sink sink
+ * @param sample sample output
+ * @return true if a sample is available
+ */
+bool telemetry_receive( telemetry_sink_t *sink, telemetry_sample_t *sample )
+{
+  bool status = false;
+  uint32_t lag_ms = 0;
+
+  taskENTER_CRITICAL( &telemetry_lock );
+  if( sink->count )
+  {
+    *sample = sink->queue[sink->head];
+    sink->head = (sink->head + 1) % sink->size;
+    sink->count--;
+    sink->stats.delivered++;
+    status = true;
+  }
+  taskEXIT_CRITICAL( &telemetry_lock );
+
+  if( status )
+  {
+    lag_ms = (uint32_t)((esp_timer_get_time() - sample->time_us) / 1000);
+    taskENTER_CRITICAL( &telemetry_lock );
+    sink->stats.lag_ms = lag_ms;
+    if( lag_ms > sink->stats.max_lag_ms )
+    {
+      sink->stats.max_lag_ms = lag_ms;
+    }
+    taskEXIT_CRITICAL( &telemetry_lock );
+  }
+  return status;
+}
+
+/**
+ * @brief Get the statistics of the sink
+ * @param sink sink
+ * @param stats statistics output
+ */
+void telemetry_get_stats( telemetry_sink_t *sink, telemetry_stats_t *stats )
+{
+  taskENTER_CRITICAL( &telemetry_lock );
+  *stats = sink->stats;
+  stats->depth = sink->count;
+  taskEXIT_CRITICAL( &telemetry_lock );
+}
+
+/**
+ * @brief Get the first registered sink, use sink->next for the others
+ * @param  none
+ * @return first sink or NULL
+ */
+telemetry_sink_t * telemetry_sink_first( void )
+{
+  return telemetry_sinks;
+}
+
+/**
+ * @brief Get a sample value rounded and clamped to 0..255, for the uplinks
+ *        which send whole numbers (a float out of range must not be cast to
+ *        uint8_t directly, that is undefined behavior)
+ * @param sample telemetry sample
+ * @param idx value index
+ * @return value in range 0..255, 0 for NaN or not used index
+ */
+uint8_t telemetry_value_u8( const telemetry_sample_t *sample, uint8_t idx )
+{
+  float value = (idx < sample->count) ? sample->value[idx] : 0.0f;
+
+  if( !(value > 0.0f) )
+  {
+    // also NaN
+    return 0u;
+  }
+  if( value >= 255.0f )
+  {
+    return UINT8_MAX;
+  }
+  return (uint8_t)(value + 0.5f);
+}
+
+// Private Function Definition
+
+/**
+ * @brief Add the sample to the sink queue, called with lock taken
+ * @param sink sink
+ * @param sample sample to add
+ */
+static void telemetry_sink_push( telemetry_sink_t *sink, const telemetry_sample_t *sample )
+{
+  sink->stats.received++;
+  if( sink->count == sink->size )
+  {
+    if( sink->policy == TELEMETRY_DROP_NEWEST )
+    {
+      sink->stats.dropped++;
+      return;
+    }
+    else if( sink->policy == TELEMETRY_COALESCE )
+    {
+      sink->queue[(sink->head + sink->count - 1) % sink->size] = *sample;
+      sink->stats.coalesced++;
+      return;
+    }
+    sink->head = (sink->head + 1) % sink->size;
+    sink->count--;
+    sink->stats.dropped++;
+  }
+  sink->queue[(sink->head + sink->count) % sink->size] = *sample;
+  sink->count++;
+  if( sink->count > sink->stats.max_depth )
+  {
+    sink->stats.max_depth = sink->count;
+  }
+}
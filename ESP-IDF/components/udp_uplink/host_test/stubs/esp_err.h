@@ -0,0 +1,17 @@
+/*
+ * esp_err.h
+ *
+ * Host build stub, only the error codes used by the component
+ */
+#ifndef ESP_ERR_H_
+#define ESP_ERR_H_
+
+typedef int esp_err_t;
+
+#define ESP_OK                              (0)
+#define ESP_FAIL                            (-1)
+#define ESP_ERR_NO_MEM                      (0x101)
+#define ESP_ERR_INVALID_ARG                 (0x102)
+#define ESP_ERR_INVALID_STATE               (0x103)
+
+#endif /* ESP_ERR_H_ */
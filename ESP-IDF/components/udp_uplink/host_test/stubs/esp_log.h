@@ -0,0 +1,15 @@
+/*
+ * esp_log.h
+ *
+ * Host build stub, the logs go to stderr
+ */
+#ifndef ESP_LOG_H_
+#define ESP_LOG_H_
+
+#include <stdio.h>
+
+#define ESP_LOGE( tag, fmt, ... )           fprintf( stderr, "E %s: " fmt "\n", tag, ##__VA_ARGS__ )
+#define ESP_LOGW( tag, fmt, ... )           fprintf( stderr, "W %s: " fmt "\n", tag, ##__VA_ARGS__ )
+#define ESP_LOGI( tag, fmt, ... )           fprintf( stderr, "I %s: " fmt "\n", tag, ##__VA_ARGS__ )
+
+#endif /* ESP_LOG_H_ */
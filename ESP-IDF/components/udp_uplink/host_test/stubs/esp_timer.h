@@ -0,0 +1,13 @@
+/*
+ * esp_timer.h
+ *
+ * Host build stub, monotonic time in microseconds
+ */
+#ifndef ESP_TIMER_H_
+#define ESP_TIMER_H_
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time( void );
+
+#endif /* ESP_TIMER_H_ */
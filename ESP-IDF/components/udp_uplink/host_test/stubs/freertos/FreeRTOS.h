@@ -0,0 +1,31 @@
+/*
+ * FreeRTOS.h
+ *
+ * Host build stub, tasks are threads and the critical sections are mutexes,
+ * see freertos_host.c. The tick is 1 ms.
+ */
+#ifndef FREERTOS_H_
+#define FREERTOS_H_
+
+#include <stdint.h>
+#include <pthread.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef pthread_mutex_t portMUX_TYPE;
+
+#define pdTRUE                              (1)
+#define pdFALSE                             (0)
+#define pdPASS                              (1)
+#define pdFAIL                              (0)
+#define portMAX_DELAY                       (0xFFFFFFFFu)
+#define pdMS_TO_TICKS( ms )                 ((TickType_t)(ms))
+#define portTICK_PERIOD_MS                  (1u)
+#define portMUX_INITIALIZER_UNLOCKED        PTHREAD_MUTEX_INITIALIZER
+#define configMAX_TASK_NAME_LEN             (16)
+
+#define taskENTER_CRITICAL( mux )           pthread_mutex_lock( mux )
+#define taskEXIT_CRITICAL( mux )            pthread_mutex_unlock( mux )
+
+#endif /* FREERTOS_H_ */
@@ -0,0 +1,18 @@
+/*
+ * queue.h
+ *
+ * Host build stub, a queue of fixed size items, see freertos_host.c
+ */
+#ifndef QUEUE_H_
+#define QUEUE_H_
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct _host_queue_t *QueueHandle_t;
+
+QueueHandle_t xQueueCreate( UBaseType_t length, UBaseType_t item_size );
+BaseType_t xQueueSend( QueueHandle_t queue, const void *item, TickType_t ticks );
+BaseType_t xQueueReceive( QueueHandle_t queue, void *item, TickType_t ticks );
+void vQueueDelete( QueueHandle_t queue );
+
+#endif /* QUEUE_H_ */
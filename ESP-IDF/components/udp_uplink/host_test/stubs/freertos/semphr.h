@@ -0,0 +1,19 @@
+/*
+ * semphr.h
+ *
+ * Host build stub, the mutex and the binary semaphore, see freertos_host.c
+ */
+#ifndef SEMPHR_H_
+#define SEMPHR_H_
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct _host_semaphore_t *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex( void );
+SemaphoreHandle_t xSemaphoreCreateBinary( void );
+BaseType_t xSemaphoreTake( SemaphoreHandle_t semaphore, TickType_t ticks );
+BaseType_t xSemaphoreGive( SemaphoreHandle_t semaphore );
+void vSemaphoreDelete( SemaphoreHandle_t semaphore );
+
+#endif /* SEMPHR_H_ */
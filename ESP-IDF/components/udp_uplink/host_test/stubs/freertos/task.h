@@ -0,0 +1,26 @@
+/*
+ * task.h
+ *
+ * Host build stub, see freertos_host.c
+ */
+#ifndef TASK_H_
+#define TASK_H_
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct _host_task_t *TaskHandle_t;
+typedef void (*TaskFunction_t)( void *pvParameters );
+
+BaseType_t xTaskCreate( TaskFunction_t task, const char *name, uint32_t stack, void *param, \
+                        UBaseType_t priority, TaskHandle_t *handle );
+uint32_t ulTaskNotifyTake( BaseType_t clear, TickType_t ticks );
+BaseType_t xTaskNotifyGive( TaskHandle_t handle );
+TickType_t xTaskGetTickCount( void );
+void vTaskDelay( TickType_t ticks );
+void vTaskDelayUntil( TickType_t *previous, TickType_t ticks );
+void vTaskDelete( TaskHandle_t handle );
+
+// the next xTaskCreate fails, to test the error paths
+extern volatile int host_task_create_fail;
+
+#endif /* TASK_H_ */
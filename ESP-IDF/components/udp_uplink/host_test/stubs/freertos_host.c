@@ -0,0 +1,379 @@
+/*
+ * freertos_host.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * The few FreeRTOS and esp_timer functions used by the uplink, the
+ * telemetry bus and the load generator (its host build uses these stubs
+ * too), on top of POSIX threads. A task is a thread, its notify value is a
+ * counter protected by a mutex and a condition variable. A task deleted by
+ * another one ends at its next blocking call, which polls the deleted flag,
+ * and vTaskDelete waits for it. The semaphores and queues are a mutex and
+ * a condition variable too.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+
+struct _host_task_t
+{
+  pthread_t       thread;
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  uint32_t        notify;
+  int             deleted;
+  int             exited;
+  TaskFunction_t  function;
+  void            *param;
+};
+
+volatile int host_task_create_fail = 0;
+static __thread struct _host_task_t *host_task_self = NULL;
+
+struct _host_semaphore_t
+{
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  int             taken;
+};
+
+struct _host_queue_t
+{
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  uint8_t         *items;
+  UBaseType_t     length;
+  UBaseType_t     item_size;
+  UBaseType_t     head;
+  UBaseType_t     count;
+};
+
+#define HOST_POLL_MS                        (10u)
+
+static void host_task_exit_if_deleted( void )
+{
+  struct _host_task_t *self = host_task_self;
+
+  if( (self != NULL) && self->deleted )
+  {
+    pthread_mutex_lock( &self->lock );
+    self->exited = 1;
+    pthread_cond_broadcast( &self->cond );
+    pthread_mutex_unlock( &self->lock );
+    pthread_exit( NULL );
+  }
+}
+
+/**
+ * Wait one poll slice on the condition, a task deleted while it waits ends
+ * here (the lock is released first).
+ */
+static void host_wait_slice( pthread_cond_t *cond, pthread_mutex_t *lock )
+{
+  struct timespec until;
+
+  if( (host_task_self != NULL) && host_task_self->deleted )
+  {
+    pthread_mutex_unlock( lock );
+    host_task_exit_if_deleted();
+  }
+  clock_gettime( CLOCK_REALTIME, &until );
+  until.tv_nsec += (long)HOST_POLL_MS * 1000000L;
+  if( until.tv_nsec >= 1000000000L )
+  {
+    until.tv_sec++;
+    until.tv_nsec -= 1000000000L;
+  }
+  pthread_cond_timedwait( cond, lock, &until );
+}
+
+static void * host_task_entry( void *arg )
+{
+  host_task_self = (struct _host_task_t *)arg;
+  host_task_self->function( host_task_self->param );
+  return NULL;
+}
+
+BaseType_t xTaskCreate( TaskFunction_t task, const char *name, uint32_t stack, void *param, \
+                        UBaseType_t priority, TaskHandle_t *handle )
+{
+  struct _host_task_t *host_task = NULL;
+
+  (void)name;
+  (void)stack;
+  (void)priority;
+  if( host_task_create_fail )
+  {
+    host_task_create_fail = 0;
+    return pdFAIL;
+  }
+  host_task = calloc( 1, sizeof(struct _host_task_t) );
+  if( host_task == NULL )
+  {
+    return pdFAIL;
+  }
+  pthread_mutex_init( &host_task->lock, NULL );
+  pthread_cond_init( &host_task->cond, NULL );
+  host_task->function = task;
+  host_task->param = param;
+  // the handle is optional, like in FreeRTOS
+  if( handle != NULL )
+  {
+    *handle = host_task;
+  }
+  if( pthread_create( &host_task->thread, NULL, host_task_entry, host_task ) != 0 )
+  {
+    free( host_task );
+    if( handle != NULL )
+    {
+      *handle = NULL;
+    }
+    return pdFAIL;
+  }
+  pthread_detach( host_task->thread );
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake( BaseType_t clear, TickType_t ticks )
+{
+  struct _host_task_t *self = host_task_self;
+  struct timespec until;
+  uint32_t value = 0;
+  int status = 0;
+
+  clock_gettime( CLOCK_REALTIME, &until );
+  if( ticks != portMAX_DELAY )
+  {
+    until.tv_sec += ticks / 1000u;
+    until.tv_nsec += (long)(ticks % 1000u) * 1000000L;
+    if( until.tv_nsec >= 1000000000L )
+    {
+      until.tv_sec++;
+      until.tv_nsec -= 1000000000L;
+    }
+  }
+  pthread_mutex_lock( &self->lock );
+  while( (self->notify == 0) && (status != ETIMEDOUT) && !self->deleted )
+  {
+    if( ticks == portMAX_DELAY )
+    {
+      status = pthread_cond_wait( &self->cond, &self->lock );
+    }
+    else
+    {
+      status = pthread_cond_timedwait( &self->cond, &self->lock, &until );
+    }
+  }
+  value = self->notify;
+  if( value )
+  {
+    self->notify = clear ? 0 : (value - 1u);
+  }
+  pthread_mutex_unlock( &self->lock );
+  host_task_exit_if_deleted();
+  return value;
+}
+
+BaseType_t xTaskNotifyGive( TaskHandle_t handle )
+{
+  pthread_mutex_lock( &handle->lock );
+  handle->notify++;
+  pthread_cond_signal( &handle->cond );
+  pthread_mutex_unlock( &handle->lock );
+  return pdPASS;
+}
+
+TickType_t xTaskGetTickCount( void )
+{
+  return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+void vTaskDelay( TickType_t ticks )
+{
+  struct timespec slice = { .tv_sec = 0, .tv_nsec = 0 };
+  TickType_t step = 0;
+
+  do
+  {
+    host_task_exit_if_deleted();
+    step = (ticks < HOST_POLL_MS) ? ticks : HOST_POLL_MS;
+    slice.tv_nsec = (long)step * 1000000L;
+    nanosleep( &slice, NULL );
+    ticks -= step;
+  } while( ticks );
+  host_task_exit_if_deleted();
+}
+
+void vTaskDelayUntil( TickType_t *previous, TickType_t ticks )
+{
+  struct timespec delay = { 0 };
+  TickType_t now = xTaskGetTickCount();
+
+  *previous += ticks;
+  // like FreeRTOS, no delay if the wake time has already passed
+  if( (int32_t)(*previous - now) > 0 )
+  {
+    delay.tv_sec = (*previous - now) / 1000u;
+    delay.tv_nsec = (long)((*previous - now) % 1000u) * 1000000L;
+    nanosleep( &delay, NULL );
+  }
+}
+
+void vTaskDelete( TaskHandle_t handle )
+{
+  if( (handle == NULL) || (handle == host_task_self) )
+  {
+    free( host_task_self );
+    pthread_exit( NULL );
+  }
+  pthread_mutex_lock( &handle->lock );
+  handle->deleted = 1;
+  pthread_cond_broadcast( &handle->cond );
+  while( !handle->exited )
+  {
+    pthread_cond_wait( &handle->cond, &handle->lock );
+  }
+  pthread_mutex_unlock( &handle->lock );
+  free( handle );
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex( void )
+{
+  struct _host_semaphore_t *semaphore = calloc( 1, sizeof(struct _host_semaphore_t) );
+
+  if( semaphore != NULL )
+  {
+    pthread_mutex_init( &semaphore->lock, NULL );
+    pthread_cond_init( &semaphore->cond, NULL );
+  }
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary( void )
+{
+  SemaphoreHandle_t semaphore = xSemaphoreCreateMutex();
+
+  // a binary semaphore is created empty
+  if( semaphore != NULL )
+  {
+    semaphore->taken = 1;
+  }
+  return semaphore;
+}
+
+BaseType_t xSemaphoreTake( SemaphoreHandle_t semaphore, TickType_t ticks )
+{
+  (void)ticks;
+  pthread_mutex_lock( &semaphore->lock );
+  while( semaphore->taken )
+  {
+    host_wait_slice( &semaphore->cond, &semaphore->lock );
+  }
+  semaphore->taken = 1;
+  pthread_mutex_unlock( &semaphore->lock );
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive( SemaphoreHandle_t semaphore )
+{
+  pthread_mutex_lock( &semaphore->lock );
+  semaphore->taken = 0;
+  pthread_cond_signal( &semaphore->cond );
+  pthread_mutex_unlock( &semaphore->lock );
+  return pdTRUE;
+}
+
+void vSemaphoreDelete( SemaphoreHandle_t semaphore )
+{
+  pthread_mutex_destroy( &semaphore->lock );
+  pthread_cond_destroy( &semaphore->cond );
+  free( semaphore );
+}
+
+QueueHandle_t xQueueCreate( UBaseType_t length, UBaseType_t item_size )
+{
+  struct _host_queue_t *queue = calloc( 1, sizeof(struct _host_queue_t) );
+
+  if( queue != NULL )
+  {
+    queue->items = malloc( (size_t)length * item_size );
+    if( queue->items == NULL )
+    {
+      free( queue );
+      return NULL;
+    }
+    queue->length = length;
+    queue->item_size = item_size;
+    pthread_mutex_init( &queue->lock, NULL );
+    pthread_cond_init( &queue->cond, NULL );
+  }
+  return queue;
+}
+
+BaseType_t xQueueSend( QueueHandle_t queue, const void *item, TickType_t ticks )
+{
+  int64_t until_us = esp_timer_get_time() + (int64_t)ticks * 1000;
+  UBaseType_t tail;
+
+  pthread_mutex_lock( &queue->lock );
+  while( queue->count == queue->length )
+  {
+    if( (ticks != portMAX_DELAY) && (esp_timer_get_time() >= until_us) )
+    {
+      pthread_mutex_unlock( &queue->lock );
+      return pdFALSE;
+    }
+    host_wait_slice( &queue->cond, &queue->lock );
+  }
+  tail = (queue->head + queue->count) % queue->length;
+  memcpy( &queue->items[tail * queue->item_size], item, queue->item_size );
+  queue->count++;
+  pthread_cond_broadcast( &queue->cond );
+  pthread_mutex_unlock( &queue->lock );
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive( QueueHandle_t queue, void *item, TickType_t ticks )
+{
+  int64_t until_us = esp_timer_get_time() + (int64_t)ticks * 1000;
+
+  pthread_mutex_lock( &queue->lock );
+  while( queue->count == 0u )
+  {
+    if( (ticks != portMAX_DELAY) && (esp_timer_get_time() >= until_us) )
+    {
+      pthread_mutex_unlock( &queue->lock );
+      return pdFALSE;
+    }
+    host_wait_slice( &queue->cond, &queue->lock );
+  }
+  memcpy( item, &queue->items[queue->head * queue->item_size], queue->item_size );
+  queue->head = (queue->head + 1u) % queue->length;
+  queue->count--;
+  pthread_cond_broadcast( &queue->cond );
+  pthread_mutex_unlock( &queue->lock );
+  return pdTRUE;
+}
+
+void vQueueDelete( QueueHandle_t queue )
+{
+  pthread_mutex_destroy( &queue->lock );
+  pthread_cond_destroy( &queue->cond );
+  free( queue->items );
+  free( queue );
+}
+
+int64_t esp_timer_get_time( void )
+{
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC, &now );
+  return (int64_t)now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+}
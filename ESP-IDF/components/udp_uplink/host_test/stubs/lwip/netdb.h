@@ -0,0 +1,11 @@
+/*
+ * netdb.h
+ *
+ * Host build stub, lwIP has the BSD resolver API
+ */
+#ifndef LWIP_NETDB_H_
+#define LWIP_NETDB_H_
+
+#include <netdb.h>
+
+#endif /* LWIP_NETDB_H_ */
@@ -0,0 +1,15 @@
+/*
+ * sockets.h
+ *
+ * Host build stub, lwIP has the BSD socket API
+ */
+#ifndef LWIP_SOCKETS_H_
+#define LWIP_SOCKETS_H_
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#endif /* LWIP_SOCKETS_H_ */
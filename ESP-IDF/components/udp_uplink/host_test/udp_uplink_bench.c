@@ -0,0 +1,258 @@
+/*
+ * udp_uplink_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Host benchmark of the UDP uplink. The component, the telemetry bus and the
+ * serializer are built unchanged against the stubs (FreeRTOS on POSIX
+ * threads, lwIP on host sockets) and send to a receiver on the loopback.
+ * The samples are published as fast as the uplink takes them (the publisher
+ * waits while the sink queue is half full, so no sample is dropped), the
+ * receiver checks the sequence records like tools/udp_receiver.py.
+ * Before that the task creation is made to fail once, the start must return
+ * ESP_ERR_NO_MEM and the retry must work, LeakSanitizer reports the memory
+ * of the failed start if it is not freed.
+ *
+ *  make -C components/udp_uplink/host_test bench
+ *  build/udp_uplink_bench [lp|statsd] [samples]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "udp_uplink.h"
+
+// Private Macros
+#define BENCH_SAMPLES_DEFAULT               (200000u)
+#define BENCH_QUEUE_DEPTH                   (256u)
+#define BENCH_FLUSH_MS                      (20u)
+#define BENCH_RCVBUF                        (8u * 1024u * 1024u)
+#define BENCH_DRAIN_MS                      (2000)
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if( !(cond) )                                                         \
+    {                                                                     \
+      printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond );   \
+      test_failed++;                                                      \
+    }                                                                     \
+  } while( 0 )
+
+typedef struct _bench_rx_t
+{
+  int           sock;
+  bool          statsd;
+  atomic_bool   stop;
+  atomic_uint   datagrams;
+  atomic_uint   records;              // data records, without the sequence records
+  atomic_ullong bytes;
+  uint32_t      next_seq;
+  uint32_t      lost;
+} bench_rx_t;
+
+// Private Variables
+static const char * const bench_fields[] = { "temperature", "humidity", "pressure" };
+static bench_rx_t bench_rx;
+static int test_failed = 0;
+
+// Private Function Declaration
+static void * bench_receiver( void *arg );
+static int bench_open_receiver( uint16_t *port );
+static void bench_sleep_ms( uint32_t ms );
+
+int main( int argc, char **argv )
+{
+  udp_uplink_config_t config = { 0 };
+  udp_uplink_stats_t stats;
+  telemetry_stats_t sink_stats;
+  pthread_t rx_thread;
+  uint32_t samples = (argc > 2) ? (uint32_t)strtoul( argv[2], NULL, 0 ) : BENCH_SAMPLES_DEFAULT;
+  uint16_t port = 0;
+  int64_t start_us = 0;
+  int64_t elapsed_us = 0;
+  float values[3];
+
+  bench_rx.statsd = (argc > 1) && (strcmp( argv[1], "statsd" ) == 0);
+  bench_rx.sock = bench_open_receiver( &port );
+  if( bench_rx.sock < 0 )
+  {
+    printf( "unable to open the receiver socket\n" );
+    return EXIT_FAILURE;
+  }
+
+  config.host = "127.0.0.1";
+  config.port = port;
+  config.format = bench_rx.statsd ? UDP_UPLINK_STATSD : UDP_UPLINK_LINE_PROTOCOL;
+  config.measurement = "bench";
+  config.device_id = "s3";
+  config.fields = bench_fields;
+  config.field_count = 3;
+  config.decimals = 2;
+  config.mtu = UDP_UPLINK_MTU_DEFAULT;
+  config.flush_ms = BENCH_FLUSH_MS;
+  config.queue_depth = BENCH_QUEUE_DEPTH;
+  config.sequence = true;
+
+  // start fails once, everything allocated must be released for the retry
+  host_task_create_fail = 1;
+  CHECK( udp_uplink_start( &config ) == ESP_ERR_NO_MEM );
+  CHECK( udp_uplink_start( &config ) == ESP_OK );
+  if( test_failed )
+  {
+    return EXIT_FAILURE;
+  }
+
+  pthread_create( &rx_thread, NULL, bench_receiver, &bench_rx );
+  start_us = esp_timer_get_time();
+  for( uint32_t idx = 0; idx < samples; idx++ )
+  {
+    // keep the queue below half, the benchmark measures the uplink and not
+    // the drop policy
+    do
+    {
+      telemetry_get_stats( udp_uplink_get_sink(), &sink_stats );
+      if( sink_stats.depth >= (BENCH_QUEUE_DEPTH / 2u) )
+      {
+        sched_yield();
+      }
+    } while( sink_stats.depth >= (BENCH_QUEUE_DEPTH / 2u) );
+    values[0] = 20.0f + (float)(idx % 100u) * 0.01f;
+    values[1] = 40.0f + (float)(idx % 37u);
+    values[2] = 1000.0f + (float)(idx % 13u);
+    telemetry_publish( values, 3 );
+  }
+  // the last datagram is sent after flush_ms
+  for( int waited = 0; (atomic_load( &bench_rx.records ) < samples) && (waited < BENCH_DRAIN_MS); waited++ )
+  {
+    bench_sleep_ms( 1 );
+  }
+  elapsed_us = esp_timer_get_time() - start_us;
+  atomic_store( &bench_rx.stop, true );
+  pthread_join( rx_thread, NULL );
+
+  udp_uplink_get_stats( &stats );
+  telemetry_get_stats( udp_uplink_get_sink(), &sink_stats );
+  printf( "%s: %u samples in %.3f s, %.0f samples/s, %.2f us/sample\n", bench_rx.statsd ? "StatsD" : "line protocol", \
+          (unsigned)samples, (double)elapsed_us / 1e6, (double)samples * 1e6 / (double)elapsed_us, \
+          (double)elapsed_us / (double)samples );
+  printf( "  %u datagrams, %.1f samples/datagram, %.0f bytes/datagram, %.1f MB/s\n", \
+          atomic_load( &bench_rx.datagrams ), (double)samples / (double)atomic_load( &bench_rx.datagrams ), \
+          (double)atomic_load( &bench_rx.bytes ) / (double)atomic_load( &bench_rx.datagrams ), \
+          (double)atomic_load( &bench_rx.bytes ) / (double)elapsed_us );
+  printf( "  received %u samples, %u datagrams lost, %u send errors, %u samples dropped at sink\n", \
+          atomic_load( &bench_rx.records ), (unsigned)bench_rx.lost, (unsigned)stats.send_errors, \
+          (unsigned)sink_stats.dropped );
+
+  CHECK( stats.records == samples );
+  CHECK( stats.send_errors == 0 );
+  CHECK( sink_stats.dropped == 0 );
+  CHECK( atomic_load( &bench_rx.records ) == samples );
+  CHECK( bench_rx.lost == 0 );
+  CHECK( stats.datagrams == atomic_load( &bench_rx.datagrams ) );
+  printf( "udp_uplink_bench: %s\n", test_failed ? "FAILED" : "OK" );
+  return test_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+// Private Function Definition
+
+/**
+ * @brief Receiver thread, counts the datagrams and records and checks the
+ *        sequence record at the start of every datagram
+ * @param arg receiver state
+ */
+static void * bench_receiver( void *arg )
+{
+  static char datagram[UDP_UPLINK_MTU_DEFAULT + 1u];
+  bench_rx_t *rx = (bench_rx_t *)arg;
+  unsigned seq = 0;
+  unsigned lines = 0;
+  ssize_t len = 0;
+  bool seq_found = false;
+
+  while( !atomic_load( &rx->stop ) )
+  {
+    len = recv( rx->sock, datagram, sizeof(datagram) - 1u, 0 );
+    if( len <= 0 )
+    {
+      continue;
+    }
+    datagram[len] = '\0';
+    lines = 0;
+    for( ssize_t idx = 0; idx < len; idx++ )
+    {
+      lines += (datagram[idx] == '\n') ? 1u : 0u;
+    }
+    if( rx->statsd )
+    {
+      // every sample is one record per field
+      seq_found = (sscanf( datagram, "bench.seq:%u|g", &seq ) == 1);
+      lines = (lines - (seq_found ? 1u : 0u)) / 3u;
+    }
+    else
+    {
+      seq_found = (sscanf( datagram, "udp_uplink,device_id=s3 seq=%ui", &seq ) == 1);
+      lines -= seq_found ? 1u : 0u;
+    }
+    if( seq_found )
+    {
+      if( seq > rx->next_seq )
+      {
+        rx->lost += seq - rx->next_seq;
+      }
+      rx->next_seq = seq + 1u;
+    }
+    atomic_fetch_add( &rx->datagrams, 1u );
+    atomic_fetch_add( &rx->records, lines );
+    atomic_fetch_add( &rx->bytes, (unsigned long long)len );
+  }
+  return NULL;
+}
+
+/**
+ * @brief Open the receiver socket on a free loopback port
+ * @param port output, port number
+ * @return socket or -1
+ */
+static int bench_open_receiver( uint16_t *port )
+{
+  struct sockaddr_in addr = { 0 };
+  struct timeval timeout = { .tv_sec = 0, .tv_usec = 100000 };
+  socklen_t addr_len = sizeof(addr);
+  int rcvbuf = (int)BENCH_RCVBUF;
+  int sock = socket( AF_INET, SOCK_DGRAM, 0 );
+
+  if( sock < 0 )
+  {
+    return -1;
+  }
+  setsockopt( sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf) );
+  setsockopt( sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout) );
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+  if( (bind( sock, (struct sockaddr *)&addr, sizeof(addr) ) != 0) || \
+      (getsockname( sock, (struct sockaddr *)&addr, &addr_len ) != 0) )
+  {
+    close( sock );
+    return -1;
+  }
+  *port = ntohs( addr.sin_port );
+  return sock;
+}
+
+static void bench_sleep_ms( uint32_t ms )
+{
+  struct timespec delay = { .tv_sec = ms / 1000u, .tv_nsec = (long)(ms % 1000u) * 1000000L };
+  nanosleep( &delay, NULL );
+}
@@ -0,0 +1,62 @@
+/*
+ * udp_uplink.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * UDP uplink for high rate metrics, it is a telemetry bus sink which packs
+ * the samples as InfluxDB line protocol or StatsD records into datagrams of
+ * up to one MTU. A datagram is sent when the next record doesn't fit or when
+ * the oldest record is flush_ms old. With sequence numbers enabled every
+ * datagram starts with a sequence record, the receiver can count the lost
+ * datagrams from the gaps (see tools/udp_receiver.py).
+ */
+
+#ifndef UDP_UPLINK_H_
+#define UDP_UPLINK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "telemetry.h"
+
+#define UDP_UPLINK_MTU_DEFAULT          (1472u)   // 1500 - IP header - UDP header
+
+typedef enum {
+  UDP_UPLINK_LINE_PROTOCOL = 0,         // measurement,device_id=x field=1.5 <ns>
+  UDP_UPLINK_STATSD,                    // prefix.field:1.5|g
+} udp_uplink_format_t;
+
+typedef struct _udp_uplink_config_t
+{
+  const char            *host;          // receiver host name or IP address
+  uint16_t              port;           // 8089 for InfluxDB UDP, 8125 for StatsD
+  udp_uplink_format_t   format;
+  const char            *measurement;   // line protocol measurement or StatsD prefix
+  const char            *device_id;     // line protocol tag, can be NULL
+  const char * const    *fields;        // names of the telemetry sample values
+  uint8_t               field_count;
+  uint8_t               decimals;       // decimals of the values
+  uint16_t              mtu;            // maximum datagram payload
+  uint32_t              flush_ms;       // maximum time a record waits in datagram
+  uint16_t              queue_depth;    // telemetry sink queue length
+  bool                  sequence;       // add sequence record to every datagram
+} udp_uplink_config_t;
+
+typedef struct _udp_uplink_stats_t
+{
+  uint32_t  datagrams;
+  uint32_t  records;
+  uint64_t  bytes;
+  uint32_t  send_errors;                // datagrams which couldn't be sent (lost)
+  uint32_t  seq;                        // next sequence number
+} udp_uplink_stats_t;
+
+// Public Function Prototypes
+esp_err_t udp_uplink_start( const udp_uplink_config_t *config );
+void udp_uplink_get_stats( udp_uplink_stats_t *stats );
+telemetry_sink_t * udp_uplink_get_sink( void );
+
+#endif /* UDP_UPLINK_H_ */
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+udp_receiver.py
+
+ Created on: Oct 19, 2026
+     Author: xpress_embedo
+
+Host side receiver for the udp_uplink component. It prints the records (or
+only the statistics with --quiet), the receive rate and the lost datagrams
+counted from the sequence records, per device.
+
+  python udp_receiver.py --port 8089            # line protocol
+  python udp_receiver.py --port 8125 --quiet    # StatsD, statistics only
+"""
+import argparse
+import re
+import socket
+import time
+
+SEQ_LP = re.compile(rb'^udp_uplink(?:,device_id=(\S+))? seq=(\d+)i$')
+SEQ_STATSD = re.compile(rb'^(\S+)\.seq:(\d+)\|g$')
+
+
+class Stream:
+    """ Sequence tracking of one sender """
+    def __init__(self):
+        self.next_seq = None
+        self.received = 0
+        self.lost = 0
+        self.reordered = 0
+
+    def update(self, seq):
+        self.received += 1
+        if self.next_seq is not None:
+            if seq > self.next_seq:
+                self.lost += seq - self.next_seq
+            elif seq < self.next_seq:
+                # late datagram (or sender restarted), count it back
+                self.reordered += 1
+                self.lost = max(self.lost - 1, 0)
+                return
+        self.next_seq = seq + 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description='udp_uplink receiver')
+    parser.add_argument('--bind', default='0.0.0.0', help='address to listen on')
+    parser.add_argument('--port', type=int, default=8089, help='UDP port')
+    parser.add_argument('--interval', type=float, default=5.0, help='statistics interval in seconds')
+    parser.add_argument('--quiet', action='store_true', help="don't print the records")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1 << 20)
+    sock.bind((args.bind, args.port))
+    sock.settimeout(args.interval)
+    print('listening on {}:{}'.format(args.bind, args.port))
+
+    streams = {}
+    datagrams = records = total_bytes = 0
+    start = last = time.monotonic()
+    while True:
+        try:
+            data, sender = sock.recvfrom(65535)
+        except socket.timeout:
+            data = None
+        if data:
+            datagrams += 1
+            total_bytes += len(data)
+            for line in data.splitlines():
+                match = SEQ_LP.match(line) or SEQ_STATSD.match(line)
+                if match:
+                    key = (sender[0], match.group(1))
+                    streams.setdefault(key, Stream()).update(int(match.group(2)))
+                    continue
+                records += 1
+                if not args.quiet:
+                    print(line.decode(errors='replace'))
+        now = time.monotonic()
+        if (now - last) >= args.interval:
+            elapsed = now - start
+            print('{:.0f} s: {} datagrams, {} records ({:.1f}/s), {:.1f} kB/s'.format(
+                elapsed, datagrams, records, records / elapsed, total_bytes / elapsed / 1024))
+            for (host, device), stream in streams.items():
+                expected = stream.received + stream.lost
+                loss = (100.0 * stream.lost / expected) if expected else 0.0
+                print('  {} {}: lost {} of {} ({:.2f} %), reordered {}'.format(
+                    host, (device or b'-').decode(), stream.lost, expected, loss, stream.reordered))
+            last = now
+
+
+if __name__ == '__main__':
+    main()
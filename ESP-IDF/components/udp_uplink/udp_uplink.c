@@ -0,0 +1,403 @@
+/*
+ * udp_uplink.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+
+#include "serializer.h"
+#include "udp_uplink.h"
+
+// Private Macros
+#define UDP_UPLINK_TASK_STACK           (4096)
+#define UDP_UPLINK_TASK_PRIORITY        (5)
+#define UDP_UPLINK_RESOLVE_MS           (10000)   // retry time of host name resolution
+#define UDP_UPLINK_TIME_VALID_S         (1577836800)  // 01.01.2020, wall clock before this is not set
+#define UDP_UPLINK_SEQ_MEASUREMENT      "udp_uplink"
+
+// Private Variables
+static const char *TAG = "UDP Uplink";
+static udp_uplink_config_t udp_config = { 0 };
+static TaskHandle_t udp_task = NULL;
+static telemetry_sink_t udp_sink = { 0 };
+static char *udp_datagram = NULL;
+static ser_writer_t udp_writer;
+static bool udp_open = false;               // datagram is started
+static uint32_t udp_records = 0;            // records in current datagram
+static int64_t udp_first_ms = 0;            // time when first record was added
+static bool udp_time_valid = false;
+static int64_t udp_utc_offset_us = 0;       // UTC - esp_timer time
+static int udp_socket = -1;
+static struct sockaddr_in udp_addr;
+static bool udp_addr_valid = false;
+static int64_t udp_resolve_ms = 0;
+static udp_uplink_stats_t udp_stats = { 0 };
+static portMUX_TYPE udp_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Private Function Declaration
+static void udp_uplink_task( void *pvParameters );
+static void udp_uplink_notify( void *ctx );
+static void udp_uplink_add( const telemetry_sample_t *sample );
+static void udp_uplink_begin( void );
+static void udp_uplink_format( const telemetry_sample_t *sample );
+static void udp_uplink_send( void );
+static bool udp_uplink_connect( void );
+static TickType_t udp_uplink_next_wait( int64_t now_ms );
+static int64_t udp_uplink_now_ms( void );
+
+// Public Function Definition
+
+/**
+ * @brief Start the UDP uplink, it registers a sink on telemetry bus
+ * @param config configuration, strings must stay valid
+ * @return ESP_OK if successful else the error code
+ */
+esp_err_t udp_uplink_start( const udp_uplink_config_t *config )
+{
+  telemetry_sample_t *queue = NULL;
+
+  if( (config->host == NULL) || (config->measurement == NULL) || (config->fields == NULL) || \
+      (config->mtu == 0) || (config->queue_depth == 0) )
+  {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if( udp_task != NULL )
+  {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  udp_config = *config;
+  queue = calloc( udp_config.queue_depth, sizeof(telemetry_sample_t) );
+  udp_datagram = malloc( udp_config.mtu + 1u );     // +1 for null character of writer
+  if( (queue == NULL) || (udp_datagram == NULL) )
+  {
+    free( queue );
+    free( udp_datagram );
+    udp_datagram = NULL;
+    return ESP_ERR_NO_MEM;
+  }
+
+  // high rate data, drop the oldest samples if network is slower
+  telemetry_sink_init( &udp_sink, "udp", queue, udp_config.queue_depth, TELEMETRY_DROP_OLDEST, \
+                       udp_uplink_notify, NULL );
+  if( xTaskCreate( &udp_uplink_task, "UDP Uplink Task", UDP_UPLINK_TASK_STACK, NULL, \
+                   UDP_UPLINK_TASK_PRIORITY, &udp_task ) != pdPASS )
+  {
+    // sink is not registered yet, undo everything so that start can be retried
+    memset( &udp_sink, 0x00, sizeof(udp_sink) );
+    free( queue );
+    free( udp_datagram );
+    udp_datagram = NULL;
+    udp_task = NULL;
+    return ESP_ERR_NO_MEM;
+  }
+  telemetry_sink_register( &udp_sink );
+  ESP_LOGI(TAG, "Sending to %s:%u", udp_config.host, udp_config.port);
+  return ESP_OK;
+}
+
+/**
+ * @brief Get the UDP uplink statistics
+ * @param stats statistics output
+ */
+void udp_uplink_get_stats( udp_uplink_stats_t *stats )
+{
+  taskENTER_CRITICAL( &udp_stats_lock );
+  *stats = udp_stats;
+  taskEXIT_CRITICAL( &udp_stats_lock );
+}
+
+/**
+ * @brief Get the telemetry sink of the uplink, used for sink statistics
+ * @param  none
+ * @return telemetry sink
+ */
+telemetry_sink_t * udp_uplink_get_sink( void )
+{
+  return &udp_sink;
+}
+
+// Private Function Definition
+
+/**
+ * @brief UDP Uplink Task
+ * Waits for the samples from telemetry bus, the wait timeout is the time when
+ * the pending datagram has to be sent
+ * @param pvParameters
+ */
+static void udp_uplink_task( void *pvParameters )
+{
+  telemetry_sample_t sample;
+
+  (void)pvParameters;
+  while( 1 )
+  {
+    ulTaskNotifyTake( pdTRUE, udp_uplink_next_wait(udp_uplink_now_ms()) );
+
+    while( telemetry_receive( &udp_sink, &sample ) )
+    {
+      udp_uplink_add( &sample );
+    }
+
+    if( udp_open && ((udp_uplink_now_ms() - udp_first_ms) >= udp_config.flush_ms) )
+    {
+      udp_uplink_send();
+    }
+  }
+}
+
+/**
+ * @brief Telemetry bus notify callback, wakes up the uplink task
+ * @param ctx not used
+ */
+static void udp_uplink_notify( void *ctx )
+{
+  (void)ctx;
+  xTaskNotifyGive( udp_task );
+}
+
+/**
+ * @brief Add the sample to the datagram, if it doesn't fit the datagram is
+ *        sent and sample is added to a new one
+ * @param sample telemetry sample
+ */
+static void udp_uplink_add( const telemetry_sample_t *sample )
+{
+  ser_mark_t mark;
+
+  if( !udp_open )
+  {
+    udp_uplink_begin();
+  }
+  mark = ser_mark( &udp_writer );
+  udp_uplink_format( sample );
+  if( ser_truncated( &udp_writer ) )
+  {
+    ser_rollback( &udp_writer, &mark );
+    udp_uplink_send();
+    udp_uplink_begin();
+    mark = ser_mark( &udp_writer );
+    udp_uplink_format( sample );
+    if( ser_truncated( &udp_writer ) )
+    {
+      // record is bigger than mtu, it will never fit
+      ESP_LOGE(TAG, "Record doesn't fit in datagram");
+      ser_rollback( &udp_writer, &mark );
+      return;
+    }
+  }
+  udp_records++;
+}
+
+/**
+ * @brief Start a new datagram, with the sequence record if enabled
+ * @param  none
+ */
+static void udp_uplink_begin( void )
+{
+  struct timeval now;
+
+  ser_writer_init( &udp_writer, udp_datagram, udp_config.mtu + 1u );
+  udp_open = true;
+  udp_records = 0;
+  udp_first_ms = udp_uplink_now_ms();
+
+  // time stamps are only added when wall clock is set (SNTP), else the
+  // receiver uses its own time
+  gettimeofday( &now, NULL );
+  udp_time_valid = (now.tv_sec >= UDP_UPLINK_TIME_VALID_S);
+  if( udp_time_valid )
+  {
+    udp_utc_offset_us = (int64_t)now.tv_sec * 1000000LL + now.tv_usec - esp_timer_get_time();
+  }
+
+  if( udp_config.sequence )
+  {
+    if( udp_config.format == UDP_UPLINK_STATSD )
+    {
+      ser_str( &udp_writer, udp_config.measurement );
+      ser_str( &udp_writer, ".seq:" );
+      ser_uint( &udp_writer, udp_stats.seq );
+      ser_str( &udp_writer, "|g\n" );
+    }
+    else
+    {
+      ser_lp_measurement( &udp_writer, UDP_UPLINK_SEQ_MEASUREMENT );
+      if( udp_config.device_id )
+      {
+        ser_lp_tag( &udp_writer, "device_id", udp_config.device_id );
+      }
+      ser_lp_field_int( &udp_writer, "seq", udp_stats.seq );
+      ser_lp_end( &udp_writer, 0 );
+    }
+  }
+}
+
+/**
+ * @brief Write the sample as line protocol or StatsD records
+ * @param sample telemetry sample
+ */
+static void udp_uplink_format( const telemetry_sample_t *sample )
+{
+  uint8_t count = (sample->count < udp_config.field_count) ? sample->count : udp_config.field_count;
+
+  if( udp_config.format == UDP_UPLINK_STATSD )
+  {
+    // StatsD has no time stamp, the receiver aggregates by arrival time
+    for( uint8_t idx = 0; idx < count; idx++ )
+    {
+      ser_str( &udp_writer, udp_config.measurement );
+      ser_char( &udp_writer, '.' );
+      ser_str( &udp_writer, udp_config.fields[idx] );
+      ser_char( &udp_writer, ':' );
+      ser_float( &udp_writer, sample->value[idx], udp_config.decimals );
+      ser_str( &udp_writer, "|g\n" );
+    }
+  }
+  else
+  {
+    ser_lp_measurement( &udp_writer, udp_config.measurement );
+    if( udp_config.device_id )
+    {
+      ser_lp_tag( &udp_writer, "device_id", udp_config.device_id );
+      if( sample->source )
+      {
+        // virtual devices of load generator are separate series "<id>-<n>"
+        ser_char( &udp_writer, '-' );
+        ser_uint( &udp_writer, sample->source );
+      }
+    }
+    for( uint8_t idx = 0; idx < count; idx++ )
+    {
+      ser_lp_field_float( &udp_writer, udp_config.fields[idx], sample->value[idx], udp_config.decimals );
+    }
+    ser_lp_end( &udp_writer, udp_time_valid ? (sample->time_us + udp_utc_offset_us) * 1000LL : 0 );
+  }
+}
+
+/**
+ * @brief Send the current datagram, the sequence number is incremented even if
+ *        sending fails, so the receiver sees it as lost
+ * @param  none
+ */
+static void udp_uplink_send( void )
+{
+  size_t len = ser_len( &udp_writer );
+  bool sent = false;
+
+  if( !udp_open )
+  {
+    return;
+  }
+  udp_open = false;
+  if( udp_records == 0 )
+  {
+    return;
+  }
+
+  if( udp_uplink_connect() )
+  {
+    sent = ( sendto( udp_socket, udp_datagram, len, 0, (struct sockaddr *)&udp_addr, sizeof(udp_addr) ) == (int)len );
+  }
+
+  taskENTER_CRITICAL( &udp_stats_lock );
+  udp_stats.seq++;
+  if( sent )
+  {
+    udp_stats.datagrams++;
+    udp_stats.records += udp_records;
+    udp_stats.bytes += len;
+  }
+  else
+  {
+    udp_stats.send_errors++;
+  }
+  taskEXIT_CRITICAL( &udp_stats_lock );
+}
+
+/**
+ * @brief Create the socket and resolve the receiver address, resolution is
+ *        retried every UDP_UPLINK_RESOLVE_MS if it fails
+ * @param  none
+ * @return true if datagram can be sent
+ */
+static bool udp_uplink_connect( void )
+{
+  struct addrinfo hints = { 0 };
+  struct addrinfo *result = NULL;
+  int64_t now_ms = udp_uplink_now_ms();
+
+  if( udp_socket < 0 )
+  {
+    udp_socket = socket( AF_INET, SOCK_DGRAM, IPPROTO_IP );
+    if( udp_socket < 0 )
+    {
+      ESP_LOGE(TAG, "Unable to create socket: errno %d", errno);
+      return false;
+    }
+  }
+
+  if( !udp_addr_valid && (now_ms >= udp_resolve_ms) )
+  {
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if( (getaddrinfo( udp_config.host, NULL, &hints, &result ) == 0) && (result != NULL) )
+    {
+      memcpy( &udp_addr, result->ai_addr, sizeof(udp_addr) );
+      udp_addr.sin_port = htons( udp_config.port );
+      udp_addr_valid = true;
+    }
+    else
+    {
+      ESP_LOGW(TAG, "Unable to resolve %s", udp_config.host);
+      udp_resolve_ms = now_ms + UDP_UPLINK_RESOLVE_MS;
+    }
+    if( result != NULL )
+    {
+      freeaddrinfo( result );
+    }
+  }
+  return udp_addr_valid;
+}
+
+/**
+ * @brief Get the time till the pending datagram has to be sent
+ * @param now_ms current time in milliseconds
+ * @return ticks to wait
+ */
+static TickType_t udp_uplink_next_wait( int64_t now_ms )
+{
+  int64_t due_ms = udp_first_ms + udp_config.flush_ms;
+
+  if( !udp_open )
+  {
+    return portMAX_DELAY;
+  }
+  if( due_ms <= now_ms )
+  {
+    return 0;
+  }
+  return pdMS_TO_TICKS( due_ms - now_ms );
+}
+
+/**
+ * @brief Get the time since boot in milliseconds
+ * @param  none
+ * @return time in milliseconds
+ */
+static int64_t udp_uplink_now_ms( void )
+{
+  return esp_timer_get_time() / 1000;
+}
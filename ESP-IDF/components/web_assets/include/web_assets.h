@@ -0,0 +1,45 @@
+/*
+ * web_assets.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ *
+ * Static files of the web page, gzip compressed at build time by
+ * web_assets_embed (project_include.cmake) and sent as they are with
+ * Content-Encoding: gzip. The ETag is the CRC-32 and size of the original
+ * file (from the gzip trailer), If-None-Match is answered with 304 and no
+ * body. Files with a versioned name (e.g. jquery-3.3.1.min.js) are cached by
+ * the browser for a year without asking again, others are revalidated with
+ * the ETag on every page load, so a firmware update is seen at once.
+ *
+ * Usage:
+ *   extern const uint8_t app_js_gz_start[] asm("_binary_app_js_gz_start");
+ *   extern const uint8_t app_js_gz_end[]   asm("_binary_app_js_gz_end");
+ *   static const web_asset_t app_js = WEB_ASSET( app_js_gz, "application/javascript", false );
+ *   return web_assets_send( req, &app_js );
+ */
+
+#ifndef WEB_ASSETS_H_
+#define WEB_ASSETS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+typedef struct _web_asset_t
+{
+  const uint8_t *start;                 // gzip data
+  const uint8_t *end;
+  const char    *content_type;
+  bool          immutable;              // name changes with content, cached for a year
+} web_asset_t;
+
+#define WEB_ASSET( symbol, type, is_immutable )                                \
+  { symbol##_start, symbol##_end, (type), (is_immutable) }
+
+// Public Function Prototypes
+esp_err_t web_assets_send( httpd_req_t *req, const web_asset_t *asset );
+
+#endif /* WEB_ASSETS_H_ */
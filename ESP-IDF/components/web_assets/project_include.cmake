@@ -0,0 +1,26 @@
+# web_assets_embed(<file>...)
+# Compresses the web page files with gzip at build time and embeds the
+# compressed data in the component calling it (after idf_component_register),
+# instead of EMBED_FILES. The data symbols get a _gz suffix, e.g. app.js is
+# _binary_app_js_gz_start/_binary_app_js_gz_end, serve it with web_assets_send.
+function(web_assets_embed)
+    idf_build_get_property(python PYTHON)
+    idf_component_get_property(web_assets_dir web_assets COMPONENT_DIR)
+    set(gzip_script ${web_assets_dir}/tools/gzip_asset.py)
+
+    foreach(asset ${ARGN})
+        get_filename_component(asset_name ${asset} NAME)
+        get_filename_component(asset_path ${asset} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_SOURCE_DIR})
+        set(asset_gz ${CMAKE_CURRENT_BINARY_DIR}/${asset_name}.gz)
+        string(MAKE_C_IDENTIFIER ${asset_name} asset_id)
+
+        add_custom_command(OUTPUT ${asset_gz}
+            COMMAND ${python} ${gzip_script} ${asset_path} ${asset_gz}
+            DEPENDS ${asset_path} ${gzip_script}
+            COMMENT "Compressing web asset ${asset_name}"
+            VERBATIM)
+        add_custom_target(${COMPONENT_NAME}_${asset_id}_gz DEPENDS ${asset_gz})
+        add_dependencies(${COMPONENT_LIB} ${COMPONENT_NAME}_${asset_id}_gz)
+        target_add_binary_data(${COMPONENT_LIB} ${asset_gz} BINARY)
+    endforeach()
+endfunction()
@@ -0,0 +1,22 @@
+#!/usr/bin/env python
+# Compress a web page file for web_assets_embed, the output is reproducible
+# (no file name and time in the gzip header), so the ETag (CRC-32 and size in
+# the gzip trailer) changes only if the file content changes.
+#
+# usage: gzip_asset.py <input> <output.gz>
+
+import gzip
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit('usage: gzip_asset.py <input> <output.gz>')
+    with open(sys.argv[1], 'rb') as src:
+        data = src.read()
+    with open(sys.argv[2], 'wb') as dst:
+        dst.write(gzip.compress(data, compresslevel=9, mtime=0))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,106 @@
+/*
+ * web_assets.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: xpress_embedo
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+#include "web_assets.h"
+
+// Private Macros
+#define WEB_ASSETS_GZIP_TRAILER         (8u)      // CRC-32 and size of the original data
+#define WEB_ASSETS_ETAG_LEN             (20u)     // "crc32size" in quotes
+#define WEB_ASSETS_IF_NONE_MATCH_LEN    (128u)
+#define WEB_ASSETS_CACHE_IMMUTABLE      "public, max-age=31536000, immutable"
+#define WEB_ASSETS_CACHE_REVALIDATE     "no-cache"
+
+// Private Variables
+static const char *TAG = "Web Assets";
+
+// Private Function Declaration
+static bool web_assets_etag( const web_asset_t *asset, char *etag, size_t size );
+static bool web_assets_not_modified( httpd_req_t *req, const char *etag );
+
+// Public Function Definition
+
+/**
+ * @brief Send the compressed file, or 304 if the browser has the same version
+ * @param req HTTP request
+ * @param asset file to send
+ * @return result of httpd_resp_send
+ */
+esp_err_t web_assets_send( httpd_req_t *req, const web_asset_t *asset )
+{
+  // header values are only referenced by httpd, must be valid till the response is sent
+  char etag[WEB_ASSETS_ETAG_LEN];
+
+  if( web_assets_etag(asset, etag, sizeof(etag)) == false )
+  {
+    ESP_LOGE(TAG, "%s is not gzip data", req->uri);
+    return httpd_resp_send_500( req );
+  }
+
+  httpd_resp_set_hdr( req, "ETag", etag );
+  httpd_resp_set_hdr( req, "Cache-Control", asset->immutable ? WEB_ASSETS_CACHE_IMMUTABLE : WEB_ASSETS_CACHE_REVALIDATE );
+  httpd_resp_set_hdr( req, "Vary", "Accept-Encoding" );
+  if( web_assets_not_modified(req, etag) )
+  {
+    httpd_resp_set_status( req, "304 Not Modified" );
+    return httpd_resp_send( req, NULL, 0 );
+  }
+
+  // every browser accepts gzip, there is no uncompressed copy to fall back to
+  httpd_resp_set_type( req, asset->content_type );
+  httpd_resp_set_hdr( req, "Content-Encoding", "gzip" );
+  return httpd_resp_send( req, (const char *)asset->start, asset->end - asset->start );
+}
+
+// Private Function Definition
+
+/**
+ * @brief Make the ETag from the gzip trailer, it is the CRC-32 and size of the
+ *        original file, so it changes with the content only
+ * @param asset compressed file
+ * @param etag ETag output, with quotes
+ * @param size output buffer size
+ * @return true if the data is gzip
+ */
+static bool web_assets_etag( const web_asset_t *asset, char *etag, size_t size )
+{
+  const uint8_t *trailer = asset->end - WEB_ASSETS_GZIP_TRAILER;
+  uint32_t crc = 0;
+  uint32_t len = 0;
+
+  if( ((asset->end - asset->start) < 18) || (asset->start[0] != 0x1F) || (asset->start[1] != 0x8B) )
+  {
+    return false;
+  }
+  // both little endian
+  crc = (uint32_t)trailer[0] | ((uint32_t)trailer[1] << 8) | ((uint32_t)trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+  len = (uint32_t)trailer[4] | ((uint32_t)trailer[5] << 8) | ((uint32_t)trailer[6] << 16) | ((uint32_t)trailer[7] << 24);
+  snprintf( etag, size, "\"%08lx%lx\"", (unsigned long)crc, (unsigned long)len );
+  return true;
+}
+
+/**
+ * @brief Check if the If-None-Match header of the request has the ETag
+ * @param req HTTP request
+ * @param etag current ETag, with quotes
+ * @return true if the browser copy is up to date
+ */
+static bool web_assets_not_modified( httpd_req_t *req, const char *etag )
+{
+  char if_none_match[WEB_ASSETS_IF_NONE_MATCH_LEN];
+
+  // a too long header is reported as error, the file is sent then
+  if( httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) != ESP_OK )
+  {
+    return false;
+  }
+  // list of tags, weak tags (W/"...") match too
+  return (strcmp(if_none_match, "*") == 0) || (strstr(if_none_match, etag) != NULL);
+}